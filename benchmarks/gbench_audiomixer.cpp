@@ -0,0 +1,114 @@
+#include "benchmark/benchmark.h"
+#include <ncine/AudioMixer.h>
+#include <nctl/Array.h>
+
+const int Frequency = 44100;
+const unsigned int FramesPerMix = 1024;
+const unsigned long int VoiceFrames = Frequency;
+
+static nctl::Array<int16_t> monoSamples;
+static nctl::Array<int16_t> stereoSamples;
+
+static void initSamples()
+{
+	if (monoSamples.isEmpty() == false)
+		return;
+
+	monoSamples.setSize(VoiceFrames);
+	stereoSamples.setSize(VoiceFrames * 2);
+	for (unsigned int i = 0; i < VoiceFrames; i++)
+	{
+		// A sawtooth wave, the content does not change the performance
+		const int16_t sample = static_cast<int16_t>((i * 64) % 65536 - 32768);
+		monoSamples[i] = sample;
+		stereoSamples[i * 2] = sample;
+		stereoSamples[i * 2 + 1] = -sample;
+	}
+}
+
+static void addVoices(ncine::AudioMixer &mixer, unsigned int numVoices, int frequency, float pitch)
+{
+	for (unsigned int i = 0; i < numVoices; i++)
+	{
+		const bool isMono = (i % 2 == 0);
+		const int handle = isMono ? mixer.addVoice(monoSamples.data(), VoiceFrames, 1, frequency)
+		                          : mixer.addVoice(stereoSamples.data(), VoiceFrames, 2, frequency);
+		ncine::AudioMixer::Voice *voice = mixer.voice(handle);
+		voice->gain = 1.0f / numVoices;
+		voice->pan = (i % 3) * 0.5f - 0.5f;
+		voice->pitch = pitch;
+		voice->isLooping = true;
+		voice->isPlaying = true;
+	}
+}
+
+static void BM_MixVoices(benchmark::State &state)
+{
+	initSamples();
+	ncine::AudioMixer mixer(Frequency, FramesPerMix);
+	addVoices(mixer, state.range(0), Frequency, 1.0f);
+	nctl::Array<float> output(FramesPerMix * 2, nctl::ArrayMode::FIXED_CAPACITY);
+	output.setSize(FramesPerMix * 2);
+
+	for (auto _ : state)
+	{
+		mixer.mix(output.data(), FramesPerMix);
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(state.iterations() * FramesPerMix * state.range(0));
+}
+BENCHMARK(BM_MixVoices)->RangeMultiplier(2)->Range(1, 256);
+
+static void BM_MixResampledVoices(benchmark::State &state)
+{
+	initSamples();
+	ncine::AudioMixer mixer(Frequency, FramesPerMix);
+	addVoices(mixer, state.range(0), 22050, 1.1f);
+	nctl::Array<float> output(FramesPerMix * 2, nctl::ArrayMode::FIXED_CAPACITY);
+	output.setSize(FramesPerMix * 2);
+
+	for (auto _ : state)
+	{
+		mixer.mix(output.data(), FramesPerMix);
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(state.iterations() * FramesPerMix * state.range(0));
+}
+BENCHMARK(BM_MixResampledVoices)->RangeMultiplier(2)->Range(1, 256);
+
+static void BM_RenderNullSink(benchmark::State &state)
+{
+	initSamples();
+	ncine::AudioMixer mixer(Frequency, FramesPerMix);
+	addVoices(mixer, state.range(0), Frequency, 1.0f);
+	ncine::NullAudioSink sink;
+
+	for (auto _ : state)
+		mixer.render(sink, FramesPerMix);
+
+	state.SetItemsProcessed(state.iterations() * FramesPerMix * state.range(0));
+}
+BENCHMARK(BM_RenderNullSink)->RangeMultiplier(4)->Range(1, 256);
+
+static void BM_ConvertToInt16(benchmark::State &state)
+{
+	nctl::Array<float> input(FramesPerMix * 2, nctl::ArrayMode::FIXED_CAPACITY);
+	nctl::Array<int16_t> output(FramesPerMix * 2, nctl::ArrayMode::FIXED_CAPACITY);
+	input.setSize(FramesPerMix * 2);
+	output.setSize(FramesPerMix * 2);
+	for (unsigned int i = 0; i < input.size(); i++)
+		input[i] = (i % 200) * 0.01f - 1.0f;
+
+	for (auto _ : state)
+	{
+		ncine::AudioMixer::convertToInt16(input.data(), output.data(), input.size());
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(state.iterations() * input.size());
+}
+BENCHMARK(BM_ConvertToInt16);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,162 @@
+#include "benchmark/benchmark.h"
+#include <nctl/FlatHashMap.h>
+#define TEST_WITH_NCTL
+#include "test_movable.h"
+
+const unsigned int Capacity = 1024;
+const int KeyValueDifference = 10;
+
+using SaxFlatHashMap = nctl::FlatHashMap<unsigned int, Movable, nctl::SaxHashFunc<unsigned int>>;
+using JenkinsFlatHashMap = nctl::FlatHashMap<unsigned int, Movable, nctl::JenkinsHashFunc<unsigned int>>;
+using FNV1aFlatHashMap = nctl::FlatHashMap<unsigned int, Movable, nctl::FNV1aHashFunc<unsigned int>>;
+using FlatHashMapTestType = FNV1aFlatHashMap;
+
+static void BM_BigFlatHashMapCreation(benchmark::State &state)
+{
+	state.counters["Capacity"] = Capacity;
+	for (auto _ : state)
+	{
+		FlatHashMapTestType map(Capacity);
+		benchmark::DoNotOptimize(map);
+	}
+}
+BENCHMARK(BM_BigFlatHashMapCreation);
+
+static void BM_BigFlatHashMapCopy(benchmark::State &state)
+{
+	state.counters["Capacity"] = Capacity;
+	FlatHashMapTestType initMap(Capacity);
+	for (unsigned int i = 0; i < state.range(0); i++)
+		initMap[i] = nctl::move(Movable(Movable::Construction::INITIALIZED));
+	FlatHashMapTestType map(Capacity);
+
+	for (auto _ : state)
+	{
+		map = initMap;
+		benchmark::DoNotOptimize(map);
+
+		state.PauseTiming();
+		map.clear();
+		state.ResumeTiming();
+	}
+}
+BENCHMARK(BM_BigFlatHashMapCopy)->Arg(Capacity / 4)->Arg(Capacity / 2)->Arg(Capacity / 4 * 3);
+
+static void BM_BigFlatHashMapMove(benchmark::State &state)
+{
+	state.counters["Capacity"] = Capacity;
+	FlatHashMapTestType initMap(Capacity);
+	for (unsigned int i = 0; i < state.range(0); i++)
+		initMap[i] = nctl::move(Movable(Movable::Construction::INITIALIZED));
+	FlatHashMapTestType map(Capacity);
+
+	for (auto _ : state)
+	{
+		map = nctl::move(initMap);
+		benchmark::DoNotOptimize(map);
+
+		state.PauseTiming();
+		map.clear();
+		state.ResumeTiming();
+	}
+}
+BENCHMARK(BM_BigFlatHashMapMove)->Arg(Capacity / 4)->Arg(Capacity / 2)->Arg(Capacity / 4 * 3);
+
+static void BM_BigFlatHashMapOperatorInsert(benchmark::State &state)
+{
+	state.counters["Capacity"] = Capacity;
+	FlatHashMapTestType map(Capacity);
+
+	for (auto _ : state)
+	{
+		for (unsigned int i = 0; i < state.range(0); i++)
+		{
+			Movable movable(Movable::Construction::INITIALIZED);
+			map[i] = movable;
+		}
+
+		state.PauseTiming();
+		map.clear();
+		state.ResumeTiming();
+	}
+}
+BENCHMARK(BM_BigFlatHashMapOperatorInsert)->Arg(Capacity / 4)->Arg(Capacity / 2)->Arg(Capacity / 4 * 3);
+
+static void BM_BigFlatHashMapOperatorMoveInsert(benchmark::State &state)
+{
+	state.counters["Capacity"] = Capacity;
+	FlatHashMapTestType map(Capacity);
+
+	for (auto _ : state)
+	{
+		for (unsigned int i = 0; i < state.range(0); i++)
+		{
+			Movable movable(Movable::Construction::INITIALIZED);
+			map[i] = nctl::move(movable);
+		}
+
+		state.PauseTiming();
+		map.clear();
+		state.ResumeTiming();
+	}
+}
+BENCHMARK(BM_BigFlatHashMapOperatorMoveInsert)->Arg(Capacity / 4)->Arg(Capacity / 2)->Arg(Capacity / 4 * 3);
+
+static void BM_BigFlatHashMapInsert(benchmark::State &state)
+{
+	state.counters["Capacity"] = Capacity;
+	FlatHashMapTestType map(Capacity);
+
+	for (auto _ : state)
+	{
+		for (unsigned int i = 0; i < state.range(0); i++)
+		{
+			Movable movable(Movable::Construction::INITIALIZED);
+			map.insert(i, movable);
+		}
+
+		state.PauseTiming();
+		map.clear();
+		state.ResumeTiming();
+	}
+}
+BENCHMARK(BM_BigFlatHashMapInsert)->Arg(Capacity / 4)->Arg(Capacity / 2)->Arg(Capacity / 4 * 3);
+
+static void BM_BigFlatHashMapMoveInsert(benchmark::State &state)
+{
+	state.counters["Capacity"] = Capacity;
+	FlatHashMapTestType map(Capacity);
+
+	for (auto _ : state)
+	{
+		for (unsigned int i = 0; i < state.range(0); i++)
+		{
+			Movable movable(Movable::Construction::INITIALIZED);
+			map.insert(i, nctl::move(movable));
+		}
+
+		state.PauseTiming();
+		map.clear();
+		state.ResumeTiming();
+	}
+}
+BENCHMARK(BM_BigFlatHashMapMoveInsert)->Arg(Capacity / 4)->Arg(Capacity / 2)->Arg(Capacity / 4 * 3);
+
+static void BM_BigFlatHashMapEmplace(benchmark::State &state)
+{
+	state.counters["Capacity"] = Capacity;
+	FlatHashMapTestType map(Capacity);
+
+	for (auto _ : state)
+	{
+		for (unsigned int i = 0; i < state.range(0); i++)
+			map.emplace(i, Movable::Construction::INITIALIZED);
+
+		state.PauseTiming();
+		map.clear();
+		state.ResumeTiming();
+	}
+}
+BENCHMARK(BM_BigFlatHashMapEmplace)->Arg(Capacity / 4)->Arg(Capacity / 2)->Arg(Capacity / 4 * 3);
+
+BENCHMARK_MAIN();
@@ -73,6 +73,22 @@ static void BM_HashMapRetrieve(benchmark::State &state)
 }
 BENCHMARK(BM_HashMapRetrieve)->Arg(Capacity / 4)->Arg(Capacity / 2)->Arg(Capacity / 4 * 3);
 
+static void BM_HashMapFindMissing(benchmark::State &state)
+{
+	state.counters["Capacity"] = Capacity;
+	HashMapTestType map(Capacity);
+	for (unsigned int i = 0; i < state.range(0); i++)
+		map[i] = i * 2;
+
+	unsigned int key = 0;
+	for (auto _ : state)
+	{
+		key = (key + 19) % state.range(0);
+		benchmark::DoNotOptimize(map.find(key + Capacity));
+	}
+}
+BENCHMARK(BM_HashMapFindMissing)->Arg(Capacity / 4)->Arg(Capacity / 2)->Arg(Capacity / 4 * 3);
+
 static void BM_HashMapClear(benchmark::State &state)
 {
 	state.counters["Capacity"] = Capacity;
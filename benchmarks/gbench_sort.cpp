@@ -0,0 +1,105 @@
+#include "benchmark/benchmark.h"
+#include <nctl/Array.h>
+#include <nctl/algorithms.h>
+
+const unsigned int Capacity = 16384;
+const unsigned int FewUniqueValues = 8;
+
+enum class Pattern
+{
+	RANDOM,
+	SORTED,
+	REVERSED,
+	FEW_UNIQUE
+};
+
+void initArray(nctl::Array<int> &array, unsigned int size, Pattern pattern)
+{
+	// Linear congruential generator to fill the same values in every benchmark
+	unsigned int seed = 12345;
+	for (unsigned int i = 0; i < size; i++)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		switch (pattern)
+		{
+			case Pattern::RANDOM: array.pushBack(static_cast<int>(seed >> 1)); break;
+			case Pattern::SORTED: array.pushBack(i); break;
+			case Pattern::REVERSED: array.pushBack(size - i); break;
+			case Pattern::FEW_UNIQUE: array.pushBack((seed >> 16) % FewUniqueValues); break;
+		}
+	}
+}
+
+template <void (*SortFunc)(nctl::Array<int>::Iterator, nctl::Array<int>::Iterator)>
+void benchmarkSort(benchmark::State &state, Pattern pattern)
+{
+	nctl::Array<int> initArrayValues(state.range(0));
+	initArray(initArrayValues, state.range(0), pattern);
+	nctl::Array<int> array(state.range(0));
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		array = initArrayValues;
+		state.ResumeTiming();
+
+		SortFunc(array.begin(), array.end());
+		benchmark::DoNotOptimize(array);
+	}
+}
+
+static void BM_SortRandom(benchmark::State &state)
+{
+	benchmarkSort<nctl::sort>(state, Pattern::RANDOM);
+}
+BENCHMARK(BM_SortRandom)->Arg(Capacity / 16)->Arg(Capacity);
+
+static void BM_SortSorted(benchmark::State &state)
+{
+	benchmarkSort<nctl::sort>(state, Pattern::SORTED);
+}
+BENCHMARK(BM_SortSorted)->Arg(Capacity / 16)->Arg(Capacity);
+
+static void BM_SortReversed(benchmark::State &state)
+{
+	benchmarkSort<nctl::sort>(state, Pattern::REVERSED);
+}
+BENCHMARK(BM_SortReversed)->Arg(Capacity / 16)->Arg(Capacity);
+
+static void BM_SortFewUnique(benchmark::State &state)
+{
+	benchmarkSort<nctl::sort>(state, Pattern::FEW_UNIQUE);
+}
+BENCHMARK(BM_SortFewUnique)->Arg(Capacity / 16)->Arg(Capacity);
+
+static void BM_QuickSortRandom(benchmark::State &state)
+{
+	benchmarkSort<nctl::quicksort>(state, Pattern::RANDOM);
+}
+BENCHMARK(BM_QuickSortRandom)->Arg(Capacity / 16)->Arg(Capacity);
+
+static void BM_StableSortRandom(benchmark::State &state)
+{
+	benchmarkSort<nctl::stableSort>(state, Pattern::RANDOM);
+}
+BENCHMARK(BM_StableSortRandom)->Arg(Capacity / 16)->Arg(Capacity);
+
+static void BM_StableSortSorted(benchmark::State &state)
+{
+	benchmarkSort<nctl::stableSort>(state, Pattern::SORTED);
+}
+BENCHMARK(BM_StableSortSorted)->Arg(Capacity / 16)->Arg(Capacity);
+
+static void BM_RadixSortRandom(benchmark::State &state)
+{
+	benchmarkSort<nctl::radixSort>(state, Pattern::RANDOM);
+}
+BENCHMARK(BM_RadixSortRandom)->Arg(Capacity / 16)->Arg(Capacity);
+
+static void BM_RadixSortFewUnique(benchmark::State &state)
+{
+	benchmarkSort<nctl::radixSort>(state, Pattern::FEW_UNIQUE);
+}
+BENCHMARK(BM_RadixSortFewUnique)->Arg(Capacity / 16)->Arg(Capacity);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,89 @@
+#include "benchmark/benchmark.h"
+#include <vector>
+#include <algorithm>
+
+const unsigned int Capacity = 16384;
+const unsigned int FewUniqueValues = 8;
+
+enum class Pattern
+{
+	RANDOM,
+	SORTED,
+	REVERSED,
+	FEW_UNIQUE
+};
+
+void initVector(std::vector<int> &vector, unsigned int size, Pattern pattern)
+{
+	// Linear congruential generator to fill the same values in every benchmark
+	unsigned int seed = 12345;
+	for (unsigned int i = 0; i < size; i++)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		switch (pattern)
+		{
+			case Pattern::RANDOM: vector.push_back(static_cast<int>(seed >> 1)); break;
+			case Pattern::SORTED: vector.push_back(i); break;
+			case Pattern::REVERSED: vector.push_back(size - i); break;
+			case Pattern::FEW_UNIQUE: vector.push_back((seed >> 16) % FewUniqueValues); break;
+		}
+	}
+}
+
+template <void (*SortFunc)(std::vector<int>::iterator, std::vector<int>::iterator)>
+void benchmarkSort(benchmark::State &state, Pattern pattern)
+{
+	std::vector<int> initVectorValues;
+	initVectorValues.reserve(state.range(0));
+	initVector(initVectorValues, state.range(0), pattern);
+	std::vector<int> vector;
+	vector.reserve(state.range(0));
+
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		vector = initVectorValues;
+		state.ResumeTiming();
+
+		SortFunc(vector.begin(), vector.end());
+		benchmark::DoNotOptimize(vector);
+	}
+}
+
+static void BM_StdSortRandom(benchmark::State &state)
+{
+	benchmarkSort<std::sort>(state, Pattern::RANDOM);
+}
+BENCHMARK(BM_StdSortRandom)->Arg(Capacity / 16)->Arg(Capacity);
+
+static void BM_StdSortSorted(benchmark::State &state)
+{
+	benchmarkSort<std::sort>(state, Pattern::SORTED);
+}
+BENCHMARK(BM_StdSortSorted)->Arg(Capacity / 16)->Arg(Capacity);
+
+static void BM_StdSortReversed(benchmark::State &state)
+{
+	benchmarkSort<std::sort>(state, Pattern::REVERSED);
+}
+BENCHMARK(BM_StdSortReversed)->Arg(Capacity / 16)->Arg(Capacity);
+
+static void BM_StdSortFewUnique(benchmark::State &state)
+{
+	benchmarkSort<std::sort>(state, Pattern::FEW_UNIQUE);
+}
+BENCHMARK(BM_StdSortFewUnique)->Arg(Capacity / 16)->Arg(Capacity);
+
+static void BM_StdStableSortRandom(benchmark::State &state)
+{
+	benchmarkSort<std::stable_sort>(state, Pattern::RANDOM);
+}
+BENCHMARK(BM_StdStableSortRandom)->Arg(Capacity / 16)->Arg(Capacity);
+
+static void BM_StdStableSortSorted(benchmark::State &state)
+{
+	benchmarkSort<std::stable_sort>(state, Pattern::SORTED);
+}
+BENCHMARK(BM_StdStableSortSorted)->Arg(Capacity / 16)->Arg(Capacity);
+
+BENCHMARK_MAIN();
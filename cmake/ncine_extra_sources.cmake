@@ -105,6 +105,7 @@ if(OPENAL_FOUND)
 		${NCINE_ROOT}/include/ncine/IAudioPlayer.h
 		${NCINE_ROOT}/include/ncine/AudioBufferPlayer.h
 		${NCINE_ROOT}/include/ncine/AudioStreamPlayer.h
+		${NCINE_ROOT}/include/ncine/SoftwareAudioDevice.h
 	)
 
 	list(APPEND PRIVATE_HEADERS
@@ -113,6 +114,7 @@ if(OPENAL_FOUND)
 		${NCINE_ROOT}/src/include/AudioLoaderWav.h
 		${NCINE_ROOT}/src/include/AudioReaderWav.h
 		${NCINE_ROOT}/src/include/IAudioReader.h
+		${NCINE_ROOT}/src/include/AudioBufferCache.h
 	)
 
 	list(APPEND SOURCES
@@ -121,10 +123,12 @@ if(OPENAL_FOUND)
 		${NCINE_ROOT}/src/audio/AudioLoaderWav.cpp
 		${NCINE_ROOT}/src/audio/AudioReaderWav.cpp
 		${NCINE_ROOT}/src/audio/AudioBuffer.cpp
+		${NCINE_ROOT}/src/audio/AudioBufferCache.cpp
 		${NCINE_ROOT}/src/audio/AudioStream.cpp
 		${NCINE_ROOT}/src/audio/IAudioPlayer.cpp
 		${NCINE_ROOT}/src/audio/AudioBufferPlayer.cpp
 		${NCINE_ROOT}/src/audio/AudioStreamPlayer.cpp
+		${NCINE_ROOT}/src/audio/SoftwareAudioDevice.cpp
 	)
 
 	if(NCINE_WITH_OPENAL_EXT)
@@ -207,6 +211,8 @@ if(Threads_FOUND)
 
 	list(APPEND PRIVATE_HEADERS ${NCINE_ROOT}/src/include/ThreadPool.h)
 	list(APPEND SOURCES ${NCINE_ROOT}/src/threading/ThreadPool.cpp)
+	list(APPEND PRIVATE_HEADERS ${NCINE_ROOT}/src/include/FileReadQueue.h)
+	list(APPEND SOURCES ${NCINE_ROOT}/src/threading/FileReadQueue.cpp)
 	list(APPEND PRIVATE_HEADERS ${NCINE_ROOT}/src/include/ThreadCommands.h)
 endif()
 
@@ -285,6 +291,7 @@ if(LUA_FOUND)
 			${NCINE_ROOT}/src/include/LuaCamera.h
 			${NCINE_ROOT}/src/include/LuaShader.h
 			${NCINE_ROOT}/src/include/LuaShaderState.h
+			${NCINE_ROOT}/src/include/LuaAssetPreloader.h
 		)
 
 		list(APPEND SOURCES
@@ -321,6 +328,7 @@ if(LUA_FOUND)
 			${NCINE_ROOT}/src/scripting/LuaCamera.cpp
 			${NCINE_ROOT}/src/scripting/LuaShader.cpp
 			${NCINE_ROOT}/src/scripting/LuaShaderState.cpp
+			${NCINE_ROOT}/src/scripting/LuaAssetPreloader.cpp
 		)
 
 		if(OPENAL_FOUND)
@@ -23,8 +23,10 @@ set(HEADERS
 	${NCINE_ROOT}/include/ncine/IIndexer.h
 	${NCINE_ROOT}/include/ncine/ILogger.h
 	${NCINE_ROOT}/include/ncine/IAudioDevice.h
+	${NCINE_ROOT}/include/ncine/AudioMixer.h
 	${NCINE_ROOT}/include/ncine/IThreadPool.h
 	${NCINE_ROOT}/include/ncine/IThreadCommand.h
+	${NCINE_ROOT}/include/ncine/ParallelAlgorithms.h
 	${NCINE_ROOT}/include/ncine/IGfxCapabilities.h
 	${NCINE_ROOT}/include/ncine/ServiceLocator.h
 	${NCINE_ROOT}/include/ncine/DisplayMode.h
@@ -34,11 +36,16 @@ set(HEADERS
 	${NCINE_ROOT}/include/ncine/Font.h
 	${NCINE_ROOT}/include/ncine/FileSystem.h
 	${NCINE_ROOT}/include/ncine/IFile.h
+	${NCINE_ROOT}/include/ncine/FileReadRequest.h
+	${NCINE_ROOT}/include/ncine/AssetArchive.h
+	${NCINE_ROOT}/include/ncine/BinaryLog.h
+	${NCINE_ROOT}/include/ncine/AssetPreloader.h
 	${NCINE_ROOT}/include/ncine/IGfxDevice.h
 	${NCINE_ROOT}/include/ncine/Texture.h
 	${NCINE_ROOT}/include/ncine/ITextureSaver.h
 	${NCINE_ROOT}/include/ncine/Shader.h
 	${NCINE_ROOT}/include/ncine/ShaderState.h
+	${NCINE_ROOT}/include/ncine/ShaderVariants.h
 	${NCINE_ROOT}/include/ncine/SceneNode.h
 	${NCINE_ROOT}/include/ncine/BaseSprite.h
 	${NCINE_ROOT}/include/ncine/Sprite.h
@@ -55,6 +62,7 @@ set(HEADERS
 	${NCINE_ROOT}/include/ncine/RectAnimation.h
 	${NCINE_ROOT}/include/ncine/AnimatedSprite.h
 	${NCINE_ROOT}/include/ncine/Viewport.h
+	${NCINE_ROOT}/include/ncine/FrameCapture.h
 	${NCINE_ROOT}/include/ncine/Camera.h
 )
 
@@ -67,6 +75,7 @@ set(NCTL_HEADERS
 	${NCINE_ROOT}/include/nctl/Array.h
 	${NCINE_ROOT}/include/nctl/ArrayIterator.h
 	${NCINE_ROOT}/include/nctl/StaticArray.h
+	${NCINE_ROOT}/include/nctl/SmallArray.h
 	${NCINE_ROOT}/include/nctl/List.h
 	${NCINE_ROOT}/include/nctl/ListIterator.h
 	${NCINE_ROOT}/include/nctl/CString.h
@@ -77,6 +86,8 @@ set(NCTL_HEADERS
 	${NCINE_ROOT}/include/nctl/HashFunctions.h
 	${NCINE_ROOT}/include/nctl/HashMap.h
 	${NCINE_ROOT}/include/nctl/HashMapIterator.h
+	${NCINE_ROOT}/include/nctl/FlatHashMap.h
+	${NCINE_ROOT}/include/nctl/FlatHashMapIterator.h
 	${NCINE_ROOT}/include/nctl/StaticHashMap.h
 	${NCINE_ROOT}/include/nctl/StaticHashMapIterator.h
 	${NCINE_ROOT}/include/nctl/HashMapList.h
@@ -1,6 +1,7 @@
 option(NCINE_BUILD_TESTS "Build the engine test programs" ON)
 option(NCINE_BUILD_UNIT_TESTS "Build the engine unit tests" OFF)
 option(NCINE_BUILD_BENCHMARKS "Build the engine micro benchmarks" OFF)
+option(NCINE_BUILD_TOOLS "Build the engine command line tools" OFF)
 option(NCINE_INSTALL_DEV_SUPPORT "Install files to support development" ON)
 option(NCINE_LINKTIME_OPTIMIZATION "Compile the engine with link time optimization when in release" OFF)
 option(NCINE_AUTOVECTORIZATION_REPORT "Enable report generation from compiler auto-vectorization" OFF)
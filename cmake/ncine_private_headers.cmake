@@ -6,6 +6,7 @@ set(PRIVATE_HEADERS
 	${NCINE_ROOT}/src/include/FrameTimer.h
 	${NCINE_ROOT}/src/include/MemoryFile.h
 	${NCINE_ROOT}/src/include/StandardFile.h
+	${NCINE_ROOT}/src/include/ArchivedFile.h
 	${NCINE_ROOT}/src/include/FileLogger.h
 	${NCINE_ROOT}/src/include/JoyMapping.h
 	${NCINE_ROOT}/src/input/JoyMappingDb.h
@@ -20,6 +21,7 @@ set(PRIVATE_HEADERS
 	${NCINE_ROOT}/src/include/TextureFormat.h
 	${NCINE_ROOT}/src/include/ITextureLoader.h
 	${NCINE_ROOT}/src/include/TextureLoaderRaw.h
+	${NCINE_ROOT}/src/include/TextureStreamer.h
 	${NCINE_ROOT}/src/include/TextureLoaderDds.h
 	${NCINE_ROOT}/src/include/TextureLoaderPvr.h
 	${NCINE_ROOT}/src/include/TextureLoaderKtx.h
@@ -18,8 +18,15 @@ set(SOURCES
 	${NCINE_ROOT}/src/FontGlyph.cpp
 	${NCINE_ROOT}/src/FileSystem.cpp
 	${NCINE_ROOT}/src/IFile.cpp
+	${NCINE_ROOT}/src/FileReadRequest.cpp
 	${NCINE_ROOT}/src/MemoryFile.cpp
 	${NCINE_ROOT}/src/StandardFile.cpp
+	${NCINE_ROOT}/src/ArchivedFile.cpp
+	${NCINE_ROOT}/src/AssetArchive.cpp
+	${NCINE_ROOT}/src/BinaryLog.cpp
+	${NCINE_ROOT}/src/AssetPreloader.cpp
+	${NCINE_ROOT}/src/ParallelAlgorithms.cpp
+	${NCINE_ROOT}/src/audio/AudioMixer.cpp
 	${NCINE_ROOT}/src/input/IInputManager.cpp
 	${NCINE_ROOT}/src/input/JoyMapping.cpp
 	${NCINE_ROOT}/src/graphics/Color.cpp
@@ -35,6 +42,7 @@ set(SOURCES
 	${NCINE_ROOT}/src/graphics/TextureFormat.cpp
 	${NCINE_ROOT}/src/graphics/ITextureLoader.cpp
 	${NCINE_ROOT}/src/graphics/TextureLoaderRaw.cpp
+	${NCINE_ROOT}/src/graphics/TextureStreamer.cpp
 	${NCINE_ROOT}/src/graphics/TextureLoaderDds.cpp
 	${NCINE_ROOT}/src/graphics/TextureLoaderPvr.cpp
 	${NCINE_ROOT}/src/graphics/TextureLoaderKtx.cpp
@@ -42,6 +50,7 @@ set(SOURCES
 	${NCINE_ROOT}/src/graphics/Texture.cpp
 	${NCINE_ROOT}/src/graphics/Shader.cpp
 	${NCINE_ROOT}/src/graphics/ShaderState.cpp
+	${NCINE_ROOT}/src/graphics/ShaderVariants.cpp
 	${NCINE_ROOT}/src/graphics/DrawableNode.cpp
 	${NCINE_ROOT}/src/graphics/SceneNode.cpp
 	${NCINE_ROOT}/src/graphics/BaseSprite.cpp
@@ -85,6 +94,7 @@ set(SOURCES
 	${NCINE_ROOT}/src/graphics/RenderCommandPool.cpp
 	${NCINE_ROOT}/src/graphics/Viewport.cpp
 	${NCINE_ROOT}/src/graphics/ScreenViewport.cpp
+	${NCINE_ROOT}/src/graphics/FrameCapture.cpp
 	${NCINE_ROOT}/src/graphics/Camera.cpp
 	${NCINE_ROOT}/src/graphics/BinaryShaderCache.cpp
 )
@@ -88,11 +88,20 @@ class DLL_PUBLIC AppConfiguration
 	/// The number of stereo audio sources
 	/*! \note Set this value to zero to request the default number of stereo audio sources. */
 	unsigned int stereoAudioSources;
+	/// The number of OpenAL buffers queued by each audio stream
+	unsigned int numStreamBuffers;
+	/// The size in bytes of each audio stream buffer
+	unsigned long streamBufferSize;
+	/// The flag is `true` if audio streams add a buffer to their queue after every underrun
+	bool adaptiveStreamBuffers;
 
 	/// The flag is `true` if the debug overlay is enabled
 	bool withDebugOverlay;
 	/// The flag is `true` if the audio subsystem is enabled
 	bool withAudio;
+	/// The flag is `true` if audio players are mixed in software instead of being played by an OpenAL device
+	/*! \note Audio is also mixed in software when no OpenAL device can be opened. */
+	bool withSoftwareAudio;
 	/// The flag is `true` if the threading subsystem is enabled
 	bool withThreads;
 	/// The flag is `true` if the scenegraph based rendering is enabled
@@ -103,6 +112,10 @@ class DLL_PUBLIC AppConfiguration
 	bool withGlDebugContext;
 	/// The flag is `true` if console log messages should use colors
 	bool withConsoleColors;
+	/// The flag is `true` if log entries are written by a dedicated thread
+	bool withAsyncLogging;
+	/// The flag is `true` if the log file is written in the binary format, to be decoded by the `ncine_logdecode` tool
+	bool withBinaryLogging;
 
 	/// \returns The path for the application to load data from
 	const nctl::String &dataPath() const;
@@ -14,6 +14,7 @@ class FrameTimer;
 class SceneNode;
 class Viewport;
 class ScreenViewport;
+class FrameCapture;
 class IInputManager;
 class IAppEventHandler;
 class ImGuiDrawing;
@@ -103,6 +104,8 @@ class DLL_PUBLIC Application
 	Viewport &screenViewport();
 	/// Returns the input manager instance
 	inline IInputManager &inputManager() { return *inputManager_; }
+	/// Returns the asynchronous frame capture instance
+	inline FrameCapture &frameCapture() { return *frameCapture_; }
 
 	/// Returns the total number of frames already rendered
 	unsigned long int numFrames() const;
@@ -164,6 +167,7 @@ class DLL_PUBLIC Application
 	nctl::UniquePtr<IDebugOverlay> debugOverlay_;
 	nctl::UniquePtr<IInputManager> inputManager_;
 	nctl::UniquePtr<IAppEventHandler> appEventHandler_;
+	nctl::UniquePtr<FrameCapture> frameCapture_;
 #ifdef WITH_IMGUI
 	nctl::UniquePtr<ImGuiDrawing> imguiDrawing_;
 #endif
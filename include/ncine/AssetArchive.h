@@ -0,0 +1,111 @@
+#ifndef CLASS_NCINE_ASSETARCHIVE
+#define CLASS_NCINE_ASSETARCHIVE
+
+#include <cstdint>
+#include "common_defines.h"
+#include <nctl/Array.h>
+#include <nctl/String.h>
+#include <nctl/UniquePtr.h>
+
+namespace ncine {
+
+class IFile;
+
+/// A read-only archive of asset files indexed by the hash of their paths
+/*! The archive starts with a header, followed by the entry data, the index sorted by path hash and the path names.
+ *  All numbers are stored in little endian. Entry data can be stored as it is or compressed as a single LZ4 block. */
+class DLL_PUBLIC AssetArchive
+{
+  public:
+	/// Archive format version
+	static const uint32_t Version = 1;
+	/// Alignment in bytes of the data of each entry inside the archive
+	static const unsigned int DataAlignment = 16;
+
+	/// The archive header at the start of the file
+	struct Header
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t numEntries;
+		uint32_t flags;
+		uint64_t indexOffset;
+		uint64_t namesOffset;
+		uint64_t namesSize;
+	};
+
+	/// An entry of the archive index
+	struct Entry
+	{
+		uint64_t pathHash;
+		uint64_t dataOffset;
+		/// Size in bytes of the uncompressed data
+		uint64_t size;
+		/// Size in bytes of the compressed data, or zero if the data is stored
+		uint64_t compressedSize;
+		/// Offset of the path inside the names block
+		uint32_t nameOffset;
+		uint32_t nameLength;
+	};
+
+	/// The four bytes at the start of every archive
+	static const char Magic[4];
+
+	/// Opens the archive and loads its index
+	explicit AssetArchive(const char *filename);
+	~AssetArchive();
+
+	/// Returns true if the archive has been opened and its index is valid
+	inline bool isOpened() const { return isOpened_; }
+	/// Returns the archive file name with path
+	inline const char *filename() const { return filename_.data(); }
+	/// Returns true if the archive content is mapped in memory
+	bool isMapped() const;
+
+	/// Returns the number of entries in the archive
+	inline unsigned int numEntries() const { return entries_.size(); }
+	/// Returns the index of the entry with the specified path relative to the archive root, or -1
+	int findEntry(const char *path) const;
+	/// Returns the index entry at the specified position
+	inline const Entry &entry(unsigned int index) const { return entries_[index]; }
+	/// Returns the path of the entry at the specified position, which is not null terminated
+	const char *entryPath(unsigned int index) const;
+
+	/// Returns a pointer to the stored data of an entry, or `nullptr` if the archive is not mapped or the entry is compressed
+	const unsigned char *entryData(unsigned int index) const;
+	/// Reads and decompresses the data of an entry into a buffer of the uncompressed size
+	bool readEntry(unsigned int index, unsigned char *buffer) const;
+
+	/// Returns the hash of a path, with back slashes treated as forward slashes
+	static uint64_t hashPath(const char *path, unsigned int length);
+
+	/// Returns the maximum size in bytes of a compressed block for a source of the specified size
+	static unsigned long int compressBound(unsigned long int srcSize);
+	/// Compresses a buffer as an LZ4 block and returns its size, or zero if it does not fit the destination
+	static unsigned long int compressBlock(const unsigned char *src, unsigned long int srcSize, unsigned char *dest, unsigned long int destCapacity);
+	/// Decompresses an LZ4 block and returns the number of bytes written, or zero if the block is malformed
+	static unsigned long int decompressBlock(const unsigned char *src, unsigned long int srcSize, unsigned char *dest, unsigned long int destSize);
+
+  private:
+	nctl::String filename_;
+	bool isOpened_;
+	/// The archive file, kept opened only if its content is mapped in memory
+	nctl::UniquePtr<IFile> fileHandle_;
+	nctl::Array<Entry> entries_;
+	nctl::UniquePtr<char[]> names_;
+	unsigned long int namesSize_;
+
+	/// Loads and validates the header and the index
+	bool loadIndex(IFile &fileHandle);
+	/// Reads bytes from the archive without the mapping, using a new file handle for thread safety
+	bool readRaw(unsigned long int offset, unsigned char *buffer, unsigned long int size) const;
+
+	/// Deleted copy constructor
+	AssetArchive(const AssetArchive &) = delete;
+	/// Deleted assignment operator
+	AssetArchive &operator=(const AssetArchive &) = delete;
+};
+
+}
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef CLASS_NCINE_ASSETPRELOADER
+#define CLASS_NCINE_ASSETPRELOADER
+
+#include "common_defines.h"
+#include "Shader.h"
+#include <nctl/Array.h>
+#include <nctl/UniquePtr.h>
+#include <nctl/Atomic.h>
+
+namespace ncine {
+
+class Texture;
+class AudioBuffer;
+class Font;
+
+/// A manifest of assets that are loaded in stages without stalling the main thread
+/*! Files are read by the I/O thread, decoded by the worker threads and uploaded to the GPU or to the audio device
+ *  by the main thread, in the `update()` call and within a time budget. Loaded assets are moved out with the `retrieve` methods. */
+class DLL_PUBLIC AssetPreloader
+{
+  public:
+	/// The types of assets that can be preloaded
+	enum class AssetType
+	{
+		TEXTURE,
+		AUDIOBUFFER,
+		FONT,
+		SHADER
+	};
+
+	/// The states of the whole manifest
+	enum class State
+	{
+		/// Assets can be added
+		IDLE,
+		LOADING,
+		/// Every asset has either been loaded or has failed
+		COMPLETED,
+		CANCELED
+	};
+
+	/// The states of a single asset
+	enum class AssetState
+	{
+		PENDING,
+		LOADED,
+		FAILED,
+		/// The asset has been moved out of the manifest
+		RETRIEVED
+	};
+
+	/// Default time budget in milliseconds for the main thread work of each update
+	static const float DefaultUpdateBudget;
+	/// Maximum number of assets whose files are being read at the same time
+	static const unsigned int MaxReadsInFlight = 8;
+
+	AssetPreloader();
+	~AssetPreloader();
+
+	/// Adds a texture file to the manifest and returns its index
+	int addTexture(const char *filename);
+	/// Adds an audio file to the manifest and returns its index
+	int addAudioBuffer(const char *filename);
+	/// Adds an AngelCode's `FNT` file and the texture it references to the manifest and returns its index
+	int addFont(const char *fntFilename);
+	/// Adds a vertex and a fragment shader file to the manifest and returns its index
+	int addShader(const char *shaderName, Shader::Introspection introspection, const char *vertexFilename, const char *fragmentFilename);
+	/// Adds a vertex and a fragment shader file to the manifest and returns its index
+	inline int addShader(const char *shaderName, const char *vertexFilename, const char *fragmentFilename)
+	{
+		return addShader(shaderName, Shader::Introspection::ENABLED, vertexFilename, fragmentFilename);
+	}
+
+	/// Starts loading the assets of the manifest
+	bool start();
+	/// Advances the loading and performs the main thread work within the budget, returns true when there is nothing left to do
+	bool update();
+	/// Stops loading the assets that have not been loaded yet
+	void cancel();
+
+	inline State state() const { return state_; }
+	/// Returns the loading progress, from zero to one
+	float progress() const;
+
+	/// Returns the time budget in milliseconds for the main thread work of each update
+	inline float updateBudget() const { return updateBudget_; }
+	/// Sets the time budget in milliseconds for the main thread work of each update
+	inline void setUpdateBudget(float milliseconds) { updateBudget_ = milliseconds; }
+
+	/// Returns the number of assets in the manifest
+	inline unsigned int numAssets() const { return assets_.size(); }
+	/// Returns the number of assets that have been loaded
+	inline unsigned int numLoaded() const { return numLoaded_; }
+	/// Returns the number of assets that have failed to load
+	inline unsigned int numFailed() const { return numFailed_; }
+
+	/// Returns the type of the asset at the specified index
+	AssetType assetType(unsigned int index) const;
+	/// Returns the file name, or the shader name, of the asset at the specified index
+	const char *assetName(unsigned int index) const;
+	/// Returns the state of the asset at the specified index
+	AssetState assetState(unsigned int index) const;
+
+	/// Moves a loaded texture out of the manifest, returns `nullptr` if it is not a loaded texture
+	nctl::UniquePtr<Texture> retrieveTexture(unsigned int index);
+	/// Moves a loaded audio buffer out of the manifest, returns `nullptr` if it is not a loaded audio buffer
+	nctl::UniquePtr<AudioBuffer> retrieveAudioBuffer(unsigned int index);
+	/// Moves a loaded font out of the manifest, returns `nullptr` if it is not a loaded font
+	nctl::UniquePtr<Font> retrieveFont(unsigned int index);
+	/// Moves a loaded shader out of the manifest, returns `nullptr` if it is not a loaded shader
+	nctl::UniquePtr<Shader> retrieveShader(unsigned int index);
+
+  private:
+	struct Asset;
+	class DecodeCommand;
+
+	State state_;
+	nctl::Array<nctl::UniquePtr<Asset>> assets_;
+	float updateBudget_;
+
+	unsigned int numLoaded_;
+	unsigned int numFailed_;
+	unsigned int numReadsInFlight_;
+	/// Maximum number of decoding jobs in flight, zero if assets are decoded on the main thread
+	unsigned int maxDecodeJobs_;
+
+	/// Number of decoding jobs in flight on the worker threads
+	nctl::Atomic32 numDecodeJobs_;
+	/// Set when loading is canceled, checked by the decoding jobs before they start
+	nctl::Atomic32 isCanceled_;
+
+	/// Adds a new asset in the idle state and returns its index, or -1
+	int addAsset(AssetType type, const char *name);
+	/// Opens the files of the queued assets and starts reading them
+	void issueReads();
+	/// Opens a file of an asset and starts reading it if it is not already in memory
+	bool issueRead(Asset &asset, unsigned int fileIndex);
+	/// Checks if the reads of an asset have finished, returns false while they are still in flight
+	bool checkReads(Asset &asset);
+	/// Decodes the files of an asset, on a worker thread or on the main thread
+	static void decode(Asset &asset);
+	/// Uploads a decoded asset on the main thread
+	void upload(Asset &asset);
+	/// Marks an asset as failed and releases its resources
+	void fail(Asset &asset);
+	/// Releases the file buffers and the intermediate decoding data of an asset
+	static void releaseData(Asset &asset);
+	/// Blocks until the reads and the decoding jobs in flight have finished
+	void waitForJobs();
+
+	/// Deleted copy constructor
+	AssetPreloader(const AssetPreloader &) = delete;
+	/// Deleted assignment operator
+	AssetPreloader &operator=(const AssetPreloader &) = delete;
+};
+
+}
+
+#endif
@@ -1,7 +1,9 @@
 #ifndef CLASS_NCINE_AUDIOBUFFER
 #define CLASS_NCINE_AUDIOBUFFER
 
+#include <cstdint>
 #include "Object.h"
+#include <nctl/UniquePtr.h>
 
 namespace ncine {
 
@@ -9,7 +11,8 @@ class IAudioLoader;
 
 /// A class representing an OpenAL buffer
 /*! It inherits from `Object` because a buffer can be
- *  shared by more than one `AudioBufferPlayer` object. */
+ *  shared by more than one `AudioBufferPlayer` object.
+ *  Buffers loaded from the same content also share the decoded samples and the OpenAL buffer through a cache. */
 class DLL_PUBLIC AudioBuffer : public Object
 {
   public:
@@ -44,6 +47,8 @@ class DLL_PUBLIC AudioBuffer : public Object
 
 	/// Returns the OpenAL buffer id
 	inline unsigned int bufferId() const { return bufferId_; }
+	/// Returns true if the OpenAL buffer is shared through the cache with other buffers loaded from the same content
+	inline bool isShared() const { return contentHash_ != 0; }
 
 	/// Returns the number of bytes per sample
 	inline int bytesPerSample() const { return bytesPerSample_; }
@@ -60,11 +65,24 @@ class DLL_PUBLIC AudioBuffer : public Object
 	/// Returns the size of the buffer in bytes
 	inline unsigned long bufferSize() const { return numSamples_ * numChannels_ * bytesPerSample_; }
 
+	/// Returns true if buffers loaded from the same content share their decoded samples
+	static bool isCacheEnabled();
+	/// Enables or disables the sharing of decoded samples between buffers loaded from the same content
+	static void setCacheEnabled(bool enabled);
+	/// Returns true if decoded samples of compressed sources are saved on disk
+	static bool isDiskCacheEnabled();
+	/// Enables or disables saving decoded samples of compressed sources on disk
+	static void setDiskCacheEnabled(bool enabled);
+	/// Deletes all the decoded samples saved on disk and returns their number
+	static unsigned int clearDiskCache();
+
 	inline static ObjectType sType() { return ObjectType::AUDIOBUFFER; }
 
   private:
 	/// The OpenAL buffer id
 	unsigned int bufferId_;
+	/// The hash of the loaded content if the OpenAL buffer is in the cache, zero otherwise
+	uint64_t contentHash_;
 
 	/// Number of bytes per sample
 	int bytesPerSample_;
@@ -80,11 +98,25 @@ class DLL_PUBLIC AudioBuffer : public Object
 
 	/// Loads audio samples based on information from the audio loader and reader
 	bool load(IAudioLoader &audioLoader);
+	/// Decodes all audio samples from the audio loader
+	bool decode(IAudioLoader &audioLoader, nctl::UniquePtr<unsigned char[]> &samples, unsigned long int &samplesSize);
+	/// Loads audio samples from the cache or decodes and adds them to it
+	bool loadCached(const char *bufferName, const unsigned char *bufferPtr, unsigned long int bufferSize);
+	/// Shares the OpenAL buffer of the cached samples with the specified content hash, returns false if they are not cached
+	bool acquireCached(uint64_t hash);
+	/// Loads decoded samples and adds them to the cache if the content hash is not zero
+	bool loadDecoded(uint64_t hash, const unsigned char *samples, unsigned long int samplesSize);
+	/// Stops sharing the OpenAL buffer through the cache before its samples are modified
+	void detachFromCache();
+	/// Deletes the OpenAL buffer if it is not shared with other buffers
+	void releaseBuffer();
 
 	/// Deleted copy constructor
 	AudioBuffer(const AudioBuffer &) = delete;
 	/// Deleted assignment operator
 	AudioBuffer &operator=(const AudioBuffer &) = delete;
+
+	friend class AssetPreloader;
 };
 
 }
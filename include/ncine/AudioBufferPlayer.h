@@ -49,6 +49,11 @@ class DLL_PUBLIC AudioBufferPlayer : public IAudioPlayer
 	/// Updates the player state
 	void updateState() override;
 
+	bool isVirtualizable() const override;
+	void virtualize() override;
+	void devirtualize() override;
+	void updateVirtualState(float interval) override;
+
   private:
 	AudioBuffer *audioBuffer_;
 
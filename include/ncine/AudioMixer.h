@@ -0,0 +1,145 @@
+#ifndef CLASS_NCINE_AUDIOMIXER
+#define CLASS_NCINE_AUDIOMIXER
+
+#include <cstdint>
+#include "common_defines.h"
+#include <nctl/Array.h>
+#include <nctl/UniquePtr.h>
+
+namespace ncine {
+
+class IFile;
+
+/// The interface for a destination of mixed 16 bits stereo frames
+class DLL_PUBLIC IAudioSink
+{
+  public:
+	virtual ~IAudioSink() {}
+	/// Writes interleaved stereo frames, returns false if they cannot be written
+	virtual bool write(const int16_t *frames, unsigned int numFrames) = 0;
+	/// Returns the number of frames written so far
+	virtual unsigned long int numFrames() const = 0;
+};
+
+/// A sink that discards all frames, useful for headless tests and benchmarks
+class DLL_PUBLIC NullAudioSink : public IAudioSink
+{
+  public:
+	NullAudioSink()
+	    : numFrames_(0) {}
+
+	inline bool write(const int16_t *frames, unsigned int numFrames) override
+	{
+		numFrames_ += numFrames;
+		return true;
+	}
+	inline unsigned long int numFrames() const override { return numFrames_; }
+
+  private:
+	unsigned long int numFrames_;
+};
+
+/// A sink that writes frames to a 16 bits stereo WAV file
+class DLL_PUBLIC WavAudioSink : public IAudioSink
+{
+  public:
+	WavAudioSink(const char *filename, int frequency);
+	~WavAudioSink() override;
+
+	inline bool isOpened() const { return fileHandle_ != nullptr; }
+	bool write(const int16_t *frames, unsigned int numFrames) override;
+	inline unsigned long int numFrames() const override { return numFrames_; }
+	/// Writes the final data size in the header and closes the file
+	void close();
+
+  private:
+	nctl::UniquePtr<IFile> fileHandle_;
+	int frequency_;
+	unsigned long int numFrames_;
+
+	void writeHeader();
+
+	/// Deleted copy constructor
+	WavAudioSink(const WavAudioSink &) = delete;
+	/// Deleted assignment operator
+	WavAudioSink &operator=(const WavAudioSink &) = delete;
+};
+
+/// A software mixer of 16 bits PCM voices into an interleaved stereo output
+/*! It does not need an audio device and can mix any number of voices on headless machines.
+ *  The samples of a voice are not copied and must stay valid while the voice exists.
+ *  \note The `SoftwareAudioDevice` uses it to mix the audio players when they cannot be played by OpenAL. */
+class DLL_PUBLIC AudioMixer
+{
+  public:
+	/// The state of a voice mixed in the output
+	struct Voice
+	{
+		Voice()
+		    : samples(nullptr), numFrames(0), numChannels(0), frequency(0),
+		      gain(1.0f), pan(0.0f), pitch(1.0f), position(0.0), isLooping(false), isPlaying(false), isUsed(false) {}
+
+		/// Interleaved 16 bits samples
+		const int16_t *samples;
+		unsigned long int numFrames;
+		int numChannels;
+		int frequency;
+
+		float gain;
+		/// Stereo panning from -1 (left) to 1 (right)
+		float pan;
+		float pitch;
+		/// Playback position in source frames
+		double position;
+		bool isLooping;
+		bool isPlaying;
+		bool isUsed;
+	};
+
+	AudioMixer(int outputFrequency, unsigned int maxFramesPerMix);
+
+	inline int outputFrequency() const { return outputFrequency_; }
+	inline unsigned int maxFramesPerMix() const { return maxFramesPerMix_; }
+
+	/// Adds a mono or stereo voice and returns its handle, or -1 if the format is not supported
+	int addVoice(const int16_t *samples, unsigned long int numFrames, int numChannels, int frequency);
+	/// Removes a voice and frees its handle
+	void removeVoice(int handle);
+	/// Returns the voice with the specified handle or `nullptr`
+	Voice *voice(int handle);
+	/// Returns the number of voices that are currently playing
+	unsigned int numPlayingVoices() const;
+
+	/// Mixes all the playing voices in interleaved stereo float frames and returns their number
+	unsigned int mix(float *output, unsigned int numFrames);
+	/// Mixes the playing voices and writes the frames to the sink in chunks of the maximum size
+	unsigned long int render(IAudioSink &sink, unsigned long int numFrames);
+
+	/// Converts a mono or stereo voice chunk to float samples, resampling with a linear interpolation
+	static double resample(const Voice &voice, double step, float *output, unsigned int numFrames, unsigned int &numOutputFrames);
+	/// Adds mono samples to the stereo output with a different gain for each channel
+	static void mixMono(const float *input, float *output, unsigned int numFrames, float gainLeft, float gainRight);
+	/// Adds stereo samples to the stereo output with a different gain for each channel
+	static void mixStereo(const float *input, float *output, unsigned int numFrames, float gainLeft, float gainRight);
+	/// Converts float samples to 16 bits integers, clipping them to the valid range
+	static void convertToInt16(const float *input, int16_t *output, unsigned int numSamples);
+
+  private:
+	int outputFrequency_;
+	unsigned int maxFramesPerMix_;
+	nctl::Array<Voice> voices_;
+	/// Scratch buffer for the resampled frames of a single voice
+	nctl::UniquePtr<float[]> voiceBuffer_;
+	/// Scratch buffers for the rendered frames
+	nctl::UniquePtr<float[]> mixBuffer_;
+	nctl::UniquePtr<int16_t[]> renderBuffer_;
+
+	/// Deleted copy constructor
+	AudioMixer(const AudioMixer &) = delete;
+	/// Deleted assignment operator
+	AudioMixer &operator=(const AudioMixer &) = delete;
+};
+
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define CLASS_NCINE_AUDIOSTREAM
 
 #include <nctl/StaticArray.h>
+#include <nctl/UniquePtr.h>
 
 namespace ncine {
 
@@ -32,37 +33,90 @@ class DLL_PUBLIC AudioStream
 	/// Returns the size of the loaded buffer in bytes
 	inline unsigned long bufferSize() const { return numSamples_ * numChannels_ * bytesPerSample_; }
 
+	/// Maximum number of OpenAL buffers in the streaming queue
+	static const unsigned int MaxNumBuffers = 8;
+	/// Minimum size in bytes of each streaming buffer
+	static const unsigned long int MinBufferSize = 1024;
+
 	/// Returns the number of samples in the streaming buffer
 	unsigned long int numSamplesInStreamBuffer() const;
 	/// Returns the size of the streaming buffer in bytes
-	inline int streamBufferSize() const { return BufferSize; }
+	inline int streamBufferSize() const { return static_cast<int>(bufferSize_); }
+	/// Returns the number of OpenAL buffers in the streaming queue
+	inline unsigned int numStreamBuffers() const { return numBuffers_; }
+	/// Sets the number and the size of the streaming buffers
+	/*! \note It fails if some buffers are still queued to a source */
+	bool setStreamBuffers(unsigned int numBuffers, unsigned long int bufferSize);
+
+	/// Returns true if a new buffer is added to the queue after every underrun
+	inline bool isAdaptiveBuffering() const { return adaptiveBuffering_; }
+	/// Sets the flag to add a new buffer to the queue after every underrun, up to `MaxNumBuffers`
+	inline void setAdaptiveBuffering(bool adaptiveBuffering) { adaptiveBuffering_ = adaptiveBuffering; }
+	/// Returns the number of times the source ran out of queued buffers and had to be restarted
+	inline unsigned int numUnderruns() const { return numUnderruns_; }
 	/// Returns the number of processed buffers since first enqueue
 	inline unsigned int totalProcessedBuffers() const { return totalProcessedBuffers_; }
 
+	/// Returns the number of decoded blocks waiting in the ring to be queued
+	unsigned int numReadyBlocks() const;
+	/// Returns the time in milliseconds spent decoding the last block
+	float lastDecodeTime() const;
+	/// Returns the maximum time in milliseconds spent decoding a block
+	float maxDecodeTime() const;
+	/// Returns true if decoding happens on a worker thread
+	bool isDecodingInBackground() const;
+
+	/// Returns the sample from which the stream has been playing since the last seek or loop
+	inline unsigned long int startSampleOffset() const { return startSampleOffset_; }
+	/// Moves the decoding position to the specified sample
+	/*! \note It fails if some buffers are still queued to a source */
+	bool seek(unsigned long int sampleOffset);
+
+	/// Returns the sample from which a looping stream starts again
+	unsigned long int loopStart() const;
+	/// Returns the sample at which a looping stream starts again, or zero for the end of the stream
+	unsigned long int loopEnd() const;
+	/// Sets the samples between which a looping stream plays, an end of zero means the end of the stream
+	bool setLoopPoints(unsigned long int loopStart, unsigned long int loopEnd);
+
 	/// Enqueues new buffers and unqueues processed ones
 	bool enqueue(unsigned int source, bool looping);
 	/// Unqueues any left buffer and rewinds the loader
 	void stop(unsigned int source);
+	/// Copies decoded data for a stream that is mixed in software, returns the number of bytes copied
+	unsigned long int read(char *buffer, unsigned long int bufferSize, bool looping);
 
   private:
 	/// Number of buffers for streaming
-	static const int NumBuffers = 3;
+	unsigned int numBuffers_;
 	/// OpenAL buffer queue for streaming
-	nctl::StaticArray<unsigned int, NumBuffers> buffersIds_;
+	nctl::StaticArray<unsigned int, MaxNumBuffers> buffersIds_;
 	/// Index of the next available OpenAL buffer
-	int nextAvailableBufferIndex_;
+	unsigned int nextAvailableBufferIndex_;
 
 	/// Size in bytes of each streaming buffer
-	static const int BufferSize = 16 * 1024;
-	/// Memory buffer to feed OpenAL ones
-	nctl::UniquePtr<char[]> memBuffer_;
+	unsigned long int bufferSize_;
+	/// Flag to add a buffer to the queue after every underrun
+	bool adaptiveBuffering_;
+	/// Number of underruns since the stream creation
+	unsigned int numUnderruns_;
+	/// Flag to ignore the restart at the beginning of the playback, when nothing has been queued yet
+	bool hasStartedPlaying_;
+
+	struct Decoder;
+	/// The ring of decoded blocks filled ahead of playback, allocated on the heap to keep its address stable on moves
+	nctl::UniquePtr<Decoder> decoder_;
 
 	/// OpenAL id of the currently playing buffer, or 0 if not
 	unsigned int currentBufferId_;
+	/// Number of bytes of the first decoded block that have already been read by `read()`
+	unsigned long int readBlockOffset_;
 
 	/// Number of processed buffers since first enqueue
 	/*! \note Used to know the sample offset inside the whole stream */
 	unsigned int totalProcessedBuffers_;
+	/// The sample from which the processed buffers are counted
+	unsigned long int startSampleOffset_;
 
 	/// Number of bytes per sample
 	int bytesPerSample_;
@@ -97,6 +151,13 @@ class DLL_PUBLIC AudioStream
 	bool loadFromFile(const char *filename);
 
 	void createReader(IAudioLoader &audioLoader);
+	/// Schedules a decoding job on a worker thread, or decodes immediately if there are none
+	void requestDecoding(bool looping);
+	/// Generates new OpenAL buffers and adds them to the available ones
+	void generateBuffers(unsigned int count);
+
+	static unsigned int clampNumBuffers(unsigned int numBuffers);
+	static unsigned long int clampBufferSize(unsigned long int bufferSize);
 
 	/// Deleted copy constructor
 	AudioStream(const AudioStream &) = delete;
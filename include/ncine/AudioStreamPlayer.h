@@ -1,6 +1,7 @@
 #ifndef CLASS_NCINE_AUDIOSTREAMPLAYER
 #define CLASS_NCINE_AUDIOSTREAMPLAYER
 
+#include <cstdint>
 #include "common_defines.h"
 #include "IAudioPlayer.h"
 #include "AudioStream.h"
@@ -44,6 +45,34 @@ class DLL_PUBLIC AudioStreamPlayer : public IAudioPlayer
 	inline int streamBufferSize() const { return audioStream_.streamBufferSize(); }
 	/// Returns the sample offset relative to the whole stream
 	unsigned long int sampleOffsetInStream() const;
+	/// Moves the playback position to the specified sample of the whole stream
+	/*! \note A playing stream discards the queued buffers and continues from the new position */
+	bool setSampleOffsetInStream(unsigned long int sampleOffset);
+
+	/// Returns the sample from which a looping stream starts again
+	inline unsigned long int loopStart() const { return audioStream_.loopStart(); }
+	/// Returns the sample at which a looping stream starts again, or zero for the end of the stream
+	inline unsigned long int loopEnd() const { return audioStream_.loopEnd(); }
+	/// Sets the samples between which a looping stream plays, an end of zero means the end of the stream
+	inline bool setLoopPoints(unsigned long int loopStart, unsigned long int loopEnd) { return audioStream_.setLoopPoints(loopStart, loopEnd); }
+
+	/// Returns the number of OpenAL buffers in the streaming queue
+	inline unsigned int numStreamBuffers() const { return audioStream_.numStreamBuffers(); }
+	/// Sets the number and the size of the streaming buffers, the player should be stopped
+	bool setStreamBuffers(unsigned int numBuffers, unsigned long int bufferSize);
+	/// Returns true if a new buffer is added to the queue after every underrun
+	inline bool isAdaptiveBuffering() const { return audioStream_.isAdaptiveBuffering(); }
+	/// Sets the flag to add a new buffer to the queue after every underrun
+	inline void setAdaptiveBuffering(bool adaptiveBuffering) { audioStream_.setAdaptiveBuffering(adaptiveBuffering); }
+	/// Returns the number of times the stream ran out of queued buffers
+	inline unsigned int numUnderruns() const { return audioStream_.numUnderruns(); }
+
+	/// Returns the number of decoded blocks waiting to be queued
+	inline unsigned int numReadyBlocks() const { return audioStream_.numReadyBlocks(); }
+	/// Returns the time in milliseconds spent decoding the last block
+	inline float lastDecodeTime() const { return audioStream_.lastDecodeTime(); }
+	/// Returns the maximum time in milliseconds spent decoding a block
+	inline float maxDecodeTime() const { return audioStream_.maxDecodeTime(); }
 
 	void play() override;
 	void pause() override;
@@ -57,10 +86,15 @@ class DLL_PUBLIC AudioStreamPlayer : public IAudioPlayer
   private:
 	AudioStream audioStream_;
 
+	/// Reads decoded frames to be mixed by the software audio device, returns their number
+	unsigned long int readFrames(int16_t *frames, unsigned long int numFrames);
+
 	/// Deleted copy constructor
 	AudioStreamPlayer(const AudioStreamPlayer &) = delete;
 	/// Deleted assignment operator
 	AudioStreamPlayer &operator=(const AudioStreamPlayer &) = delete;
+
+	friend class SoftwareAudioDevice;
 };
 
 }
@@ -0,0 +1,103 @@
+#ifndef CLASS_NCINE_BINARYLOG
+#define CLASS_NCINE_BINARYLOG
+
+#include <cstdint>
+#include <cstdarg>
+#include <ctime>
+#include "common_defines.h"
+
+namespace ncine {
+
+/// Encoding and decoding of the binary log records, whose formatting is deferred
+/*! A binary log starts with a header, followed by records of two types.
+ *  A format record defines the format string of an identifier and is written before the first entry using it.
+ *  An entry record stores the level, the time and the format identifier, followed by the raw arguments.
+ *  Every argument is stored as a type byte and its value, strings are stored with a 16 bits length and without a terminator.
+ *  All numbers are stored in little endian, regardless of the byte order of the host. */
+class DLL_PUBLIC BinaryLog
+{
+  public:
+	/// Binary log format version
+	static const uint32_t Version = 1;
+	/// Maximum number of arguments of a format string that can be stored in a record
+	static const unsigned int MaxFormatArgs = 16;
+	/// Maximum number of distinct format identifiers in a binary log
+	static const unsigned int MaxFormats = 1024;
+	/// Size in bytes of the header
+	static const unsigned int HeaderSize = 16;
+	/// Size in bytes of the fixed part of a format record
+	static const unsigned int FormatRecordSize = 7;
+	/// Size in bytes of the fixed part of an entry record
+	static const unsigned int EntryRecordSize = 16;
+
+	/// The header at the start of every binary log
+	struct Header
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t flags;
+	};
+
+	/// The eight bytes at the start of every binary log
+	static const char Magic[8];
+
+	/// Record types
+	enum class RecordType : uint8_t
+	{
+		FORMAT = 1,
+		ENTRY = 2
+	};
+
+	/// The types that are fetched from a variable argument list, as specified by a format string
+	enum class ArgType : uint8_t
+	{
+		INT,
+		LONG,
+		LONG_LONG,
+		INTMAX,
+		SIZE,
+		PTRDIFF,
+		DOUBLE,
+		LONG_DOUBLE,
+		STRING,
+		POINTER,
+		/// The `%n` specifier, whose argument is skipped
+		WRITE_BACK
+	};
+
+	/// The fixed part of an entry record, as decoded from a binary log
+	struct Entry
+	{
+		uint8_t level;
+		uint32_t formatId;
+		int64_t time;
+		uint16_t argsSize;
+	};
+
+	/// Parses the argument types of a format string, returns their number or -1 if the format is not supported
+	static int parseFormat(const char *format, ArgType *argTypes, unsigned int maxArgs);
+	/// Copies the arguments of a variable argument list into a buffer, returns the number of bytes written
+	/*! \note Strings that do not fit into the buffer are truncated */
+	static unsigned int encodeArgs(unsigned char *buffer, unsigned int size, const ArgType *argTypes, unsigned int numArgs, va_list args);
+	/// Copies a string as a single argument into a buffer, returns the number of bytes written
+	static unsigned int encodeString(unsigned char *buffer, unsigned int size, const char *string);
+	/// Formats the stored arguments with their format string, returns the length of the null terminated result
+	static unsigned int formatArgs(char *buffer, unsigned int size, const char *format, const unsigned char *args, unsigned int argsSize);
+
+	/// Writes the header, returns the number of bytes written
+	static unsigned int writeHeader(unsigned char *buffer, uint32_t flags);
+	/// Reads the header
+	static void readHeader(const unsigned char *buffer, Header &header);
+	/// Writes the fixed part of a format record, returns the number of bytes written
+	static unsigned int writeFormatRecord(unsigned char *buffer, uint32_t formatId, uint16_t formatLength);
+	/// Writes the fixed part of an entry record, returns the number of bytes written
+	static unsigned int writeEntryRecord(unsigned char *buffer, uint8_t level, uint32_t formatId, time_t time, uint16_t argsSize);
+	/// Reads the fixed part of a format record, excluding the type byte
+	static void readFormatRecord(const unsigned char *buffer, uint32_t &formatId, uint16_t &formatLength);
+	/// Reads the fixed part of an entry record, excluding the type byte
+	static void readEntryRecord(const unsigned char *buffer, Entry &entry);
+};
+
+}
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef CLASS_NCINE_FILEREADREQUEST
+#define CLASS_NCINE_FILEREADREQUEST
+
+#include "IFile.h"
+#include <nctl/Atomic.h>
+
+namespace ncine {
+
+/// A handle to an asynchronous read of a file range
+/*! Requests are serviced by a dedicated I/O thread, that sorts the pending ones by file and offset.
+ *  The file and the destination buffer must stay valid until the request is done. */
+class DLL_PUBLIC FileReadRequest
+{
+  public:
+	/// The states of a request
+	enum class State
+	{
+		PENDING = 0,
+		READING,
+		COMPLETED,
+		FAILED,
+		CANCELED
+	};
+
+	/// Returns the current state of the request
+	inline State state() const { return static_cast<State>(state_.load(nctl::Atomic32::MemoryModel::ACQUIRE)); }
+	/// Returns true if the request has been completed, has failed or has been canceled
+	inline bool isDone() const { return state() >= State::COMPLETED; }
+
+	inline IFile &file() const { return file_; }
+	inline unsigned long int offset() const { return offset_; }
+	inline void *buffer() const { return buffer_; }
+	inline unsigned long int bytes() const { return bytes_; }
+	/// Returns the number of bytes read, valid only when the request has been completed
+	inline unsigned long int bytesRead() const { return bytesRead_; }
+
+	/// Cancels the request if the I/O thread has not started reading it, returns true on success
+	bool cancel();
+	/// Blocks the calling thread until the request is done
+	void wait() const;
+
+  private:
+	IFile &file_;
+	unsigned long int offset_;
+	void *buffer_;
+	unsigned long int bytes_;
+	unsigned long int bytesRead_;
+	IFile::ReadCallback callback_;
+	void *userData_;
+	mutable nctl::Atomic32 state_;
+
+	FileReadRequest(IFile &file, unsigned long int offset, void *buffer, unsigned long int bytes, IFile::ReadCallback callback, void *userData);
+
+	/// Reads the range and invokes the callback, returns false if the request has been canceled
+	bool execute();
+	/// Changes the state of a pending request to canceled without waking up the waiting threads, returns true on success
+	bool setCanceled();
+
+	/// Deleted copy constructor
+	FileReadRequest(const FileReadRequest &) = delete;
+	/// Deleted assignment operator
+	FileReadRequest &operator=(const FileReadRequest &) = delete;
+
+	friend class IFile;
+	friend class FileReadQueue;
+};
+
+}
+
+#endif
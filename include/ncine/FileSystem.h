@@ -18,6 +18,8 @@ using DIR = struct __dirstream;
 
 namespace ncine {
 
+class AssetArchive;
+
 /// File system related methods
 class DLL_PUBLIC FileSystem
 {
@@ -143,6 +145,7 @@ class DLL_PUBLIC FileSystem
 	/// Returns the file size in bytes
 	static long int fileSize(const char *path);
 	/// Returns the last time the file or directory was modified
+	/*! \note The modification time of an archived file is the one of its archive, so hashes of its stats change when the archive is rebuilt */
 	static FileDate lastModificationTime(const char *path);
 	/// Returns the last time the file or directory was accessed
 	static FileDate lastAccessTime(const char *path);
@@ -165,6 +168,20 @@ class DLL_PUBLIC FileSystem
 	/// Returns the writable directory for saving cache data
 	static const nctl::String &cachePath();
 
+	/// Mounts an asset archive in front of the data path, its files are found before the ones on disk
+	/*! \note Archives mounted later are searched first. Mounting and searching are synchronized, files can be loaded by other threads meanwhile. */
+	static bool mountArchive(const char *path);
+	/// Unmounts a previously mounted asset archive
+	/*! \note Files opened from the archive, including the ones still loading asynchronously, should be destroyed before unmounting it */
+	static bool unmountArchive(const char *path);
+	/// Unmounts all the asset archives
+	static void unmountArchives();
+	/// Returns the number of mounted asset archives
+	static unsigned int numMountedArchives();
+	/// Returns the mounted archive containing the file and sets its entry index, or returns `nullptr`
+	/*! \note The path can be relative to the archive root or start with the data path */
+	static const AssetArchive *findArchivedFile(const char *path, unsigned int &entryIndex);
+
   private:
 	/// The path for the application to load files from
 	static nctl::String dataPath_;
@@ -4,6 +4,7 @@
 #include "Object.h"
 #include "Vector2.h"
 #include <nctl/HashMap.h>
+#include <nctl/String.h>
 
 namespace ncine {
 
@@ -121,6 +122,10 @@ class DLL_PUBLIC Font : public Object
 
 	bool loadTextureFromMemory(const char *texBufferName, const unsigned char *texBufferPtr, unsigned long int texBufferSize);
 	bool loadTextureFromFile(const char *texFilename);
+	/// Loads the font from a parsed FNT file and takes ownership of an already loaded texture
+	bool loadFromParser(const char *fntName, const FntParser &fntParser, nctl::UniquePtr<Texture> texture);
+	/// Returns the name of the texture file referenced by an FNT file
+	static nctl::String textureFilename(const char *fntFilename, const FntParser &fntParser);
 
 	/// Checks whether the FNT information are compatible with rendering or not
 	bool checkFntInformation(const FntParser &fntParser);
@@ -129,6 +134,8 @@ class DLL_PUBLIC Font : public Object
 	void determineRenderMode(const FntParser &fntParser);
 	/// Retrieves font information from the FNT parser
 	void retrieveInfoFromFnt(const FntParser &fntParser);
+
+	friend class AssetPreloader;
 };
 
 }
@@ -0,0 +1,113 @@
+#ifndef CLASS_NCINE_FRAMECAPTURE
+#define CLASS_NCINE_FRAMECAPTURE
+
+#include "common_defines.h"
+#include <nctl/UniquePtr.h>
+#include <nctl/Array.h>
+#include <nctl/String.h>
+#include <nctl/Atomic.h>
+
+namespace ncine {
+
+class Viewport;
+
+/// A class to capture the screen or viewport textures without stalling the rendering pipeline
+/*! Pixels are read back in a ring of pixel buffer objects and mapped some frames later,
+ *  then they are encoded to PNG or WebP, depending on the file extension, by a worker thread. */
+class DLL_PUBLIC FrameCapture
+{
+  public:
+	/// Default number of pixel buffer objects in the ring
+	static const unsigned int DefaultNumBuffers = 3;
+	/// Maximum number of pixel buffer objects in the ring
+	static const unsigned int MaxNumBuffers = 8;
+
+	FrameCapture();
+	~FrameCapture();
+
+	/// Requests a capture of the screen at the end of the current frame
+	bool captureScreen(const char *filename);
+	/// Requests a capture of the first texture of a viewport at the end of the current frame
+	/*! \note The viewport should stay alive until the end of the frame. */
+	bool captureViewport(Viewport &viewport, const char *filename);
+
+	/// Starts capturing every frame of the screen to numbered files
+	/*! \note The filename should contain a `printf` integer conversion for the frame number, like `frame_%05u.png`. */
+	bool startRecording(const char *filenameFormat);
+	/// Stops capturing every frame of the screen
+	void stopRecording();
+	/// Returns true if every frame of the screen is being captured
+	inline bool isRecording() const { return isRecording_; }
+
+	/// Returns the number of pixel buffer objects in the ring
+	inline unsigned int numBuffers() const { return numBuffers_; }
+	/// Sets the number of pixel buffer objects in the ring, waiting for pending read backs to complete
+	void setNumBuffers(unsigned int numBuffers);
+
+	/// Returns the maximum number of frames waiting to be encoded before new recorded frames are dropped
+	inline unsigned int maxPendingEncodings() const { return maxPendingEncodings_; }
+	/// Sets the maximum number of frames waiting to be encoded before new recorded frames are dropped
+	inline void setMaxPendingEncodings(unsigned int maxPendingEncodings) { maxPendingEncodings_ = maxPendingEncodings; }
+
+	/// Returns the number of read backs that have not been mapped yet
+	inline unsigned int numPendingReadbacks() const { return numInFlight_; }
+	/// Returns the number of frames that are waiting to be encoded or are being encoded
+	unsigned int numPendingEncodings() const;
+	/// Returns the number of frames that have been successfully saved
+	unsigned int numSavedFrames() const;
+	/// Returns the number of recorded frames that have been dropped because the encoding could not keep up
+	inline unsigned int numDroppedFrames() const { return numDroppedFrames_; }
+
+  private:
+	struct Request
+	{
+		Request()
+		    : viewport(nullptr) {}
+
+		/// The viewport to read from, or `nullptr` for the screen
+		Viewport *viewport;
+		nctl::String filename;
+	};
+
+	struct Slot;
+
+	nctl::UniquePtr<Slot[]> slots_;
+	unsigned int numBuffers_;
+	/// Index of the slot that will be used by the next read back
+	unsigned int nextSlot_;
+	/// Index of the oldest slot with a read back in flight
+	unsigned int oldestSlot_;
+	unsigned int numInFlight_;
+
+	nctl::Array<Request> requests_;
+	bool isRecording_;
+	nctl::String recordingFormat_;
+	unsigned int recordingFrame_;
+
+	unsigned int maxPendingEncodings_;
+	unsigned int numDroppedFrames_;
+	/// Mutable to allow constant getters, it is modified by the worker threads
+	mutable nctl::Atomic32 numPendingEncodings_;
+	mutable nctl::Atomic32 numSavedFrames_;
+
+	/// Deleted copy constructor
+	FrameCapture(const FrameCapture &) = delete;
+	/// Deleted assignment operator
+	FrameCapture &operator=(const FrameCapture &) = delete;
+
+	/// Issues the read backs requested during the frame and retires the completed ones
+	void onFrameEnd();
+	void issueReadback(const Request &request);
+	/// Maps the oldest slot and sends its pixels to be encoded, returns false if the read back is not completed yet
+	bool retireOldestSlot(bool waitForCompletion);
+	void retireAllSlots();
+	void waitForEncodings();
+
+	static bool isSupportedFile(const char *filename);
+
+	friend class Application;
+};
+
+}
+
+#endif
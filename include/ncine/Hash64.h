@@ -6,7 +6,7 @@
 
 namespace ncine {
 
-/// Utility methods to calculate a uint64_t hash from strings or files
+/// Utility methods to calculate a uint64_t hash from strings, memory buffers or files
 class DLL_PUBLIC Hash64
 {
   public:
@@ -16,6 +16,7 @@ class DLL_PUBLIC Hash64
 		mutable unsigned int HashStringCalls = 0;
 		mutable unsigned int HashedStrings = 0;
 		mutable unsigned int HashedCharacters = 0;
+		mutable unsigned int HashedBuffers = 0;
 		mutable unsigned int HashedFiles = 0;
 		mutable unsigned int ScannedHashStrings = 0;
 	};
@@ -24,6 +25,8 @@ class DLL_PUBLIC Hash64
 	uint64_t hashStrings(unsigned int count, const char **strings, const int *lengths) const;
 	/// Returns a hash number by hashing all characters of the given string
 	uint64_t hashString(const char *string, int length) const;
+	/// Returns a hash number by hashing all bytes of the given memory buffer
+	uint64_t hashBuffer(const void *bufferPtr, unsigned long int bufferSize) const;
 	/// Returns a hash number by hashing the date, size, and name of the given file
 	uint64_t hashFileStat(const char *filename) const;
 	/// Returns a hash number by scanning a hash string of the given length
@@ -92,6 +92,13 @@ class DLL_PUBLIC IAudioDevice
 	/// Returns the specified active player object
 	virtual IAudioPlayer *player(unsigned int index) = 0;
 
+	/// Returns the number of players that are playing or paused without a source
+	virtual unsigned int numVirtualPlayers() const = 0;
+	/// Returns the specified virtual player object (const version)
+	virtual const IAudioPlayer *virtualPlayer(unsigned int index) const = 0;
+	/// Returns the specified virtual player object
+	virtual IAudioPlayer *virtualPlayer(unsigned int index) = 0;
+
 	/// Pauses every player currently playing
 	/*! \note Paused players can be resumed with `resumePlayers()`. */
 	virtual void pausePlayers() = 0;
@@ -112,11 +119,17 @@ class DLL_PUBLIC IAudioDevice
 	virtual void resumeDevice() = 0;
 
 	/// Registers a new stream player for buffer update
+	/*! \note When no source is available, one is taken from a less audible player or the player becomes virtual, if it supports it. */
 	virtual void registerPlayer(IAudioPlayer *player) = 0;
 	/// Remove a stream player from the array of active players
 	virtual void unregisterPlayer(IAudioPlayer *player) = 0;
 	/// Updates players state (and buffer queue in the case of stream players)
 	virtual void updatePlayers() = 0;
+
+	/// Returns the number of times a stream player ran out of queued buffers
+	virtual unsigned int numStreamUnderruns() const = 0;
+	/// Resets the counter of stream player underruns
+	virtual void resetStreamUnderruns() = 0;
 };
 
 inline IAudioDevice::~IAudioDevice() {}
@@ -147,6 +160,10 @@ class DLL_PUBLIC NullAudioDevice : public IAudioDevice
 	const IAudioPlayer *player(unsigned int index) const override { return nullptr; }
 	IAudioPlayer *player(unsigned int index) override { return nullptr; }
 
+	unsigned int numVirtualPlayers() const override { return 0; }
+	const IAudioPlayer *virtualPlayer(unsigned int index) const override { return nullptr; }
+	IAudioPlayer *virtualPlayer(unsigned int index) override { return nullptr; }
+
 	void pausePlayers() override {}
 	void stopPlayers() override {}
 	void pausePlayers(PlayerType playerType) override {}
@@ -160,6 +177,9 @@ class DLL_PUBLIC NullAudioDevice : public IAudioDevice
 	void unregisterPlayer(IAudioPlayer *player) override {}
 	void updatePlayers() override {}
 
+	unsigned int numStreamUnderruns() const override { return 0; }
+	void resetStreamUnderruns() override {}
+
   private:
 	Attributes properties_;
 };
@@ -87,6 +87,17 @@ class DLL_PUBLIC IAudioPlayer : public Object
 	/// Sets the playback position expressed in samples
 	void setSampleOffset(int offset);
 
+	/// Returns true if the player is playing or paused without an OpenAL source, only keeping track of its playback position
+	/*! \note A virtual player gets a source back when it becomes one of the most audible players.
+	 *  With a `SoftwareAudioDevice` every player is virtual, as it is mixed without a source. */
+	inline bool isVirtual() const { return isVirtual_; }
+	/// Returns the priority used to choose which players keep a source when there are not enough of them
+	inline unsigned int priority() const { return priority_; }
+	/// Sets the priority used to choose which players keep a source when there are not enough of them
+	inline void setPriority(unsigned int priority) { priority_ = priority; }
+	/// Returns the score used to assign sources, the priority plus the gain attenuated by the distance from the listener
+	float audibility(const Vector3f &listenerPosition) const;
+
 	/// Returns true if the OpenAL source is locked
 	inline bool isSourceLocked() const { return sourceLocked_; }
 	/// Locks an OpenAL source so it is not released to the pool when the player stops
@@ -122,6 +133,11 @@ class DLL_PUBLIC IAudioPlayer : public Object
 	/// Sets the player pitch value
 	void setPitch(float pitch);
 
+	/// Returns true if the player position, velocity and direction are relative to the listener
+	inline bool isSourceRelative() const { return isSourceRelative_; }
+	/// Sets the player position, velocity and direction as relative to the listener or in world space
+	void setSourceRelative(bool sourceRelative);
+
 	/// Returns the player position vector
 	inline Vector3f position() const { return position_; }
 	/// Sets the player position vector
@@ -200,12 +216,20 @@ class DLL_PUBLIC IAudioPlayer : public Object
 	PlayerState state_;
 	/// Looping status flag
 	bool isLooping_;
+	/// The flag indicating if the player is playing or paused without a source
+	bool isVirtual_;
+	/// The priority used to assign sources, it always wins over gain and distance
+	unsigned int priority_;
+	/// The playback position in seconds tracked while the player is virtual
+	float virtualPosition_;
 
 	/// Player gain value
 	float gain_;
 	/// Player pitch value
 	float pitch_;
 
+	/// The flag indicating if the player position is relative to the listener
+	bool isSourceRelative_;
 	/// Player position in space
 	Vector3f position_;
 	/// Player velocity in space
@@ -245,7 +269,17 @@ class DLL_PUBLIC IAudioPlayer : public Object
 	/// Applies source properties after registering a player
 	void applySourceProperties();
 
+	/// Returns true if the player can give up its source while playing and get it back later
+	virtual bool isVirtualizable() const { return false; }
+	/// Releases the source of the player, keeping track of its playback position
+	virtual void virtualize() {}
+	/// Resumes the playback from the tracked position, after a new source has been assigned
+	virtual void devirtualize() {}
+	/// Advances the tracked playback position of a virtual player by the specified interval in seconds
+	virtual void updateVirtualState(float interval) {}
+
 	friend class ALAudioDevice;
+	friend class SoftwareAudioDevice;
 };
 
 }
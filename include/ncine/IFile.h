@@ -5,9 +5,12 @@
 #include <cstdint> // for endianness conversions
 #include <nctl/String.h>
 #include <nctl/UniquePtr.h>
+#include <nctl/SharedPtr.h>
 
 namespace ncine {
 
+class FileReadRequest;
+
 /// The interface class dealing with file operations
 class DLL_PUBLIC IFile
 {
@@ -35,6 +38,9 @@ class DLL_PUBLIC IFile
 		};
 	};
 
+	/// The function invoked when an asynchronous read has been serviced, before the request is marked as done
+	using ReadCallback = void (*)(const FileReadRequest &request, bool succeeded, void *userData);
+
 	/// Constructs a base file object
 	/*! \param filename File name including its path */
 	explicit IFile(const char *filename);
@@ -58,6 +64,12 @@ class DLL_PUBLIC IFile
 	/*! \return Number of bytes written */
 	virtual unsigned long int write(const void *buffer, unsigned long int bytes) = 0;
 
+	/// Reads a range of an opened file into a buffer without blocking the calling thread
+	/*! The callback is invoked on the I/O thread, or on the calling thread if the file content is already in memory.
+	 *  \note The file should not be read or closed by other threads until the request is done */
+	nctl::SharedPtr<FileReadRequest> readAsync(unsigned long int offset, void *buffer, unsigned long int bytes,
+	                                           ReadCallback callback = nullptr, void *userData = nullptr);
+
 	/// Sets the close on destruction flag
 	/*! If the flag is true the file is closed upon object destruction. */
 	inline void setCloseOnDestruction(bool shouldCloseOnDestruction) { shouldCloseOnDestruction_ = shouldCloseOnDestruction; }
@@ -5,6 +5,8 @@
 	#undef ERROR
 #endif
 
+#include <cstdarg>
+#include <cstdio>
 #include "common_defines.h"
 
 namespace ncine {
@@ -28,8 +30,15 @@ class DLL_PUBLIC ILogger
 
 	virtual ~ILogger() = 0;
 
+	/// Returns true if a message with the specified level of severity would be recorded
+	/*! \note The logging macros check it before evaluating the arguments of a message.
+	 *  The default implementation records every level, so that existing loggers keep working without overriding it. */
+	virtual bool isEnabled(LogLevel level) const { return true; }
 	/// Logs a message with a specified level of severity
 	virtual unsigned int write(LogLevel level, const char *fmt, ...) = 0;
+	/// Logs a message whose format string has static storage duration, like the literals of the logging macros
+	/*! A logger can keep the address of the format string and format the message later, the default implementation formats it immediately. */
+	virtual unsigned int writeStatic(LogLevel level, const char *fmt, ...);
 
 	/// Returns the log string with all the recorded log entries
 	virtual const char *logString() const = 0;
@@ -43,10 +52,21 @@ class DLL_PUBLIC ILogger
 
 inline ILogger::~ILogger() {}
 
+inline unsigned int ILogger::writeStatic(LogLevel level, const char *fmt, ...)
+{
+	char message[1024];
+	va_list args;
+	va_start(args, fmt);
+	vsnprintf(message, sizeof(message), fmt, args);
+	va_end(args);
+	return write(level, "%s", message);
+}
+
 /// A fake logger which doesn't log anything
 class DLL_PUBLIC NullLogger : public ILogger
 {
   public:
+	inline bool isEnabled(LogLevel level) const override { return false; }
 	inline unsigned int write(LogLevel level, const char *fmt, ...) override { return 0; }
 	inline const char *logString() const override { return nullptr; }
 	inline void clearLogString() override {}
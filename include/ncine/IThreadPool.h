@@ -15,6 +15,9 @@ class DLL_PUBLIC IThreadPool
 
 	/// Enqueues a command request for a worker thread
 	virtual void enqueueCommand(nctl::UniquePtr<IThreadCommand> threadCommand) = 0;
+	/// Returns the number of worker threads
+	/*! \note The default implementation assumes a single worker, so that existing pools keep working without overriding it */
+	virtual unsigned int numThreads() const { return 1; }
 };
 
 inline IThreadPool::~IThreadPool() {}
@@ -24,6 +27,7 @@ class DLL_PUBLIC NullThreadPool : public IThreadPool
 {
   public:
 	void enqueueCommand(nctl::UniquePtr<IThreadCommand> threadCommand) override {}
+	unsigned int numThreads() const override { return 0; }
 };
 
 }
@@ -40,6 +40,8 @@ class AudioEffectProperties;
 class ParticleSystem;
 class ParticleAffector;
 
+class AssetPreloader;
+
 /// The userdata types wrapped by Lua
 namespace LuaTypes {
 	enum UserDataType
@@ -76,6 +78,8 @@ namespace LuaTypes {
 		PARTICLE_SYSTEM,
 		PARTICLE_AFFECTOR,
 
+		ASSET_PRELOADER,
+
 		UNKNOWN
 	};
 
@@ -113,6 +117,8 @@ namespace LuaTypes {
 	template <> inline LuaTypes::UserDataType classToUserDataType<ParticleSystem>(ParticleSystem *) { return LuaTypes::UserDataType::PARTICLE_SYSTEM; }
 	template <> inline LuaTypes::UserDataType classToUserDataType<ParticleAffector>(ParticleAffector *) { return LuaTypes::UserDataType::PARTICLE_AFFECTOR; }
 
+	template <> inline LuaTypes::UserDataType classToUserDataType<AssetPreloader>(AssetPreloader *) { return LuaTypes::UserDataType::ASSET_PRELOADER; }
+
 	template <class T> inline const char *classToName(T *) { return "unknown"; }
 
 	template <> inline const char *classToName<MouseState>(MouseState *) { return "MouseState"; }
@@ -147,6 +153,8 @@ namespace LuaTypes {
 	template <> inline const char *classToName<ParticleSystem>(ParticleSystem *) { return "ParticleSystem"; }
 	template <> inline const char *classToName<ParticleAffector>(ParticleAffector *) { return "ParticleAffector"; }
 
+	template <> inline const char *classToName<AssetPreloader>(AssetPreloader *) { return "AssetPreloader"; }
+
 	inline const char *userDataTypeToName(LuaTypes::UserDataType type)
 	{
 		switch (type)
@@ -184,6 +192,8 @@ namespace LuaTypes {
 
 			case LuaTypes::UserDataType::PARTICLE_SYSTEM: return "ParticleSystem";
 			case LuaTypes::UserDataType::PARTICLE_AFFECTOR: return "ParticleAffector";
+
+			case LuaTypes::UserDataType::ASSET_PRELOADER: return "AssetPreloader";
 		}
 
 		return "unknown";
@@ -0,0 +1,199 @@
+#ifndef NCINE_PARALLELALGORITHMS
+#define NCINE_PARALLELALGORITHMS
+
+#include <new>
+#include "common_defines.h"
+#include <nctl/Array.h>
+#include <nctl/algorithms.h>
+
+namespace ncine {
+
+/// The function executed by `parallelFor()` on a chunk of a range of indices
+using ParallelChunkFunction = void (*)(unsigned int firstIndex, unsigned int lastIndex, unsigned int chunkIndex, void *userData);
+
+/// Default number of elements processed as a single chunk by the parallel algorithms
+const unsigned int DefaultGrainSize = 1024;
+/// Default number of elements sorted as a single chunk by `parallelSort()` before merging
+const unsigned int DefaultSortGrainSize = 4096;
+
+/// Returns the number of chunks a range is split into by `parallelFor()`
+inline unsigned int parallelNumChunks(unsigned int numElements, unsigned int grainSize)
+{
+	const unsigned int chunkSize = (grainSize > 0) ? grainSize : 1;
+	return (numElements + chunkSize - 1) / chunkSize;
+}
+
+/// Returns the number of threads of the thread pool, the ones that can help the calling thread
+DLL_PUBLIC unsigned int parallelNumThreads();
+
+/// Splits a range of indices in chunks of `grainSize` elements and executes the function on each of them
+/*! The chunks are shared between the thread pool workers and the calling thread, which only returns when all of them have been processed.
+ *  Chunks are processed serially by the calling thread when the pool has no threads or when the range fits in a single chunk. */
+DLL_PUBLIC void parallelFor(unsigned int numElements, unsigned int grainSize, ParallelChunkFunction func, void *userData);
+
+namespace detail {
+
+	template <class Iterator, class Function>
+	struct ParallelForEachData
+	{
+		Iterator first;
+		Function &func;
+	};
+
+	template <class Iterator, class Function>
+	void parallelForEachChunk(unsigned int firstIndex, unsigned int lastIndex, unsigned int chunkIndex, void *userData)
+	{
+		ParallelForEachData<Iterator, Function> &data = *static_cast<ParallelForEachData<Iterator, Function> *>(userData);
+		for (unsigned int i = firstIndex; i < lastIndex; i++)
+			data.func(*(data.first + i));
+	}
+
+	template <class IteratorIn, class IteratorOut, class UnaryOperation>
+	struct ParallelTransformData
+	{
+		IteratorIn first;
+		IteratorOut result;
+		UnaryOperation &op;
+	};
+
+	template <class IteratorIn, class IteratorOut, class UnaryOperation>
+	void parallelTransformChunk(unsigned int firstIndex, unsigned int lastIndex, unsigned int chunkIndex, void *userData)
+	{
+		ParallelTransformData<IteratorIn, IteratorOut, UnaryOperation> &data = *static_cast<ParallelTransformData<IteratorIn, IteratorOut, UnaryOperation> *>(userData);
+		for (unsigned int i = firstIndex; i < lastIndex; i++)
+			*(data.result + i) = data.op(*(data.first + i));
+	}
+
+	template <class Iterator, class T, class BinaryOperation>
+	struct ParallelReduceData
+	{
+		Iterator first;
+		nctl::Array<T> &partials;
+		BinaryOperation &op;
+	};
+
+	template <class Iterator, class T, class BinaryOperation>
+	void parallelReduceChunk(unsigned int firstIndex, unsigned int lastIndex, unsigned int chunkIndex, void *userData)
+	{
+		ParallelReduceData<Iterator, T, BinaryOperation> &data = *static_cast<ParallelReduceData<Iterator, T, BinaryOperation> *>(userData);
+		// Starting from the first element, and not from the initial value, avoids combining it once per chunk
+		T partial = static_cast<T>(*(data.first + firstIndex));
+		for (unsigned int i = firstIndex + 1; i < lastIndex; i++)
+			partial = data.op(partial, *(data.first + i));
+		data.partials[chunkIndex] = nctl::move(partial);
+	}
+
+	template <class Iterator, class T, class Compare>
+	struct ParallelSortData
+	{
+		Iterator first;
+		T *buffer;
+		unsigned int numElements;
+		unsigned int runSize;
+		Compare &comp;
+	};
+
+	template <class Iterator, class T, class Compare>
+	void parallelSortChunk(unsigned int firstIndex, unsigned int lastIndex, unsigned int chunkIndex, void *userData)
+	{
+		ParallelSortData<Iterator, T, Compare> &data = *static_cast<ParallelSortData<Iterator, T, Compare> *>(userData);
+		nctl::sort(data.first + firstIndex, data.first + lastIndex, data.comp);
+	}
+
+	/// Merges a pair of consecutive sorted runs, each merge uses the part of the buffer at the same offset of its runs
+	template <class Iterator, class T, class Compare>
+	void parallelMergeChunk(unsigned int firstIndex, unsigned int lastIndex, unsigned int chunkIndex, void *userData)
+	{
+		ParallelSortData<Iterator, T, Compare> &data = *static_cast<ParallelSortData<Iterator, T, Compare> *>(userData);
+		for (unsigned int i = firstIndex; i < lastIndex; i++)
+		{
+			const unsigned int first = i * data.runSize * 2;
+			const unsigned int middle = first + data.runSize;
+			const unsigned int last = nctl::min(middle + data.runSize, data.numElements);
+			if (middle < last && data.comp(*(data.first + middle), *(data.first + middle - 1)))
+				nctl::detail::mergeWithBuffer(data.first + first, data.first + middle, data.first + last, data.buffer + first, data.comp);
+		}
+	}
+
+}
+
+/// Applies a function to every element of a random access range, splitting it across the thread pool
+template <class Iterator, class Function>
+inline void parallelForEach(Iterator first, const Iterator last, Function func, unsigned int grainSize = DefaultGrainSize)
+{
+	detail::ParallelForEachData<Iterator, Function> data = { first, func };
+	parallelFor(nctl::distance(first, last), grainSize, detail::parallelForEachChunk<Iterator, Function>, &data);
+}
+
+/// Applies an operation to the elements of a random access range, splitting it across the thread pool and storing the results at the result iterator
+template <class IteratorIn, class IteratorOut, class UnaryOperation>
+inline IteratorOut parallelTransform(IteratorIn first, const IteratorIn last, IteratorOut result, UnaryOperation op, unsigned int grainSize = DefaultGrainSize)
+{
+	const unsigned int numElements = nctl::distance(first, last);
+	detail::ParallelTransformData<IteratorIn, IteratorOut, UnaryOperation> data = { first, result, op };
+	parallelFor(numElements, grainSize, detail::parallelTransformChunk<IteratorIn, IteratorOut, UnaryOperation>, &data);
+	return result + numElements;
+}
+
+/// Reduces a random access range with a binary operation, splitting it across the thread pool and combining the partial results with the initial value
+/*! The initial value is combined only once, so it does not need to be the identity of the operation.
+ *  \note The operation should be associative, as elements are reduced in chunks, but the chunks are combined in order.
+ *  \note Every chunk starts from its first element, so the element type should be convertible to `T`. */
+template <class Iterator, class T, class BinaryOperation>
+inline T parallelReduce(Iterator first, const Iterator last, T init, BinaryOperation op, unsigned int grainSize = DefaultGrainSize)
+{
+	const unsigned int numElements = nctl::distance(first, last);
+	const unsigned int numChunks = parallelNumChunks(numElements, grainSize);
+
+	nctl::Array<T> partials(numChunks, nctl::ArrayMode::FIXED_CAPACITY);
+	for (unsigned int i = 0; i < numChunks; i++)
+		partials.pushBack(init);
+
+	detail::ParallelReduceData<Iterator, T, BinaryOperation> data = { first, partials, op };
+	parallelFor(numElements, grainSize, detail::parallelReduceChunk<Iterator, T, BinaryOperation>, &data);
+
+	for (unsigned int i = 0; i < numChunks; i++)
+		init = op(init, partials[i]);
+	return init;
+}
+
+/// Sorts a random access range by sorting chunks of it on the thread pool and then merging them in parallel, with a custom compare function
+/*! \note The sort is not stable and it allocates a temporary buffer as large as the range. */
+template <class Iterator, class Compare>
+inline void parallelSort(Iterator first, const Iterator last, Compare comp, unsigned int grainSize = DefaultSortGrainSize)
+{
+	using T = typename nctl::IteratorTraits<Iterator>::ValueType;
+
+	const unsigned int numElements = nctl::distance(first, last);
+	if (grainSize == 0)
+		grainSize = 1;
+	if (parallelNumThreads() == 0 || parallelNumChunks(numElements, grainSize) <= 1)
+	{
+		nctl::sort(first, last, comp);
+		return;
+	}
+
+	detail::ParallelSortData<Iterator, T, Compare> data = { first, nullptr, numElements, grainSize, comp };
+	parallelFor(numElements, grainSize, detail::parallelSortChunk<Iterator, T, Compare>, &data);
+
+	data.buffer = static_cast<T *>(::operator new(numElements * sizeof(T)));
+	// Every round merges pairs of sorted runs, doubling their size
+	while (data.runSize < numElements)
+	{
+		const unsigned int numMerges = parallelNumChunks(numElements, data.runSize * 2);
+		parallelFor(numMerges, 1, detail::parallelMergeChunk<Iterator, T, Compare>, &data);
+		data.runSize *= 2;
+	}
+	::operator delete(data.buffer);
+}
+
+/// Sorts a random access range by sorting chunks of it on the thread pool and then merging them in parallel, ascending order
+template <class Iterator>
+inline void parallelSort(Iterator first, const Iterator last)
+{
+	parallelSort(first, last, nctl::IsLess<typename nctl::IteratorTraits<Iterator>::ValueType>);
+}
+
+}
+
+#endif
@@ -131,8 +131,10 @@ class DLL_PUBLIC Shader : public Object
 	nctl::UniquePtr<GLShaderProgram> glShaderProgram_;
 
 	/// The method that all wrappers use to load a shader. It supports all arguments and combinations.
+	/*! \note The optional `defines` string is prepended to both shader sources by `ShaderVariants` */
 	bool load(LoadMode loadMode, const char *shaderName, Introspection introspection, const char *vertex, const char *fragment,
-	          DefaultVertex defaultVertex, DefaultFragment defaultFragment, uint64_t vertexHash, uint64_t fragmentHash);
+	          DefaultVertex defaultVertex, DefaultFragment defaultFragment, uint64_t vertexHash, uint64_t fragmentHash,
+	          const char *defines = nullptr);
 
 	/// Deleted copy constructor
 	Shader(const Shader &) = delete;
@@ -140,6 +142,7 @@ class DLL_PUBLIC Shader : public Object
 	Shader &operator=(const Shader &) = delete;
 
 	friend class ShaderState;
+	friend class ShaderVariants;
 };
 
 }
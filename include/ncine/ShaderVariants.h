@@ -0,0 +1,85 @@
+#ifndef CLASS_NCINE_SHADERVARIANTS
+#define CLASS_NCINE_SHADERVARIANTS
+
+#include "Shader.h"
+#include <nctl/UniquePtr.h>
+#include <nctl/Array.h>
+#include <nctl/HashMap.h>
+#include <nctl/String.h>
+
+namespace ncine {
+
+/// A class that compiles permutations of a base shader with different feature keywords defined
+/*! Each variant is compiled on demand by prepending a `#define` directive for every enabled keyword.
+ *  The hash of the directives is added to the one of the sources, so every variant has its own entry in the binary shader cache. */
+class DLL_PUBLIC ShaderVariants
+{
+  public:
+	/// Maximum number of feature keywords, one for each bit of a variant mask
+	static const unsigned int MaxKeywords = 32;
+
+	ShaderVariants(const char *shaderName, Shader::LoadMode loadMode, Shader::Introspection introspection, const char *vertex, const char *fragment);
+	ShaderVariants(const char *shaderName, Shader::LoadMode loadMode, const char *vertex, const char *fragment);
+	ShaderVariants(const char *shaderName, Shader::LoadMode loadMode, Shader::Introspection introspection, Shader::DefaultVertex defaultVertex, const char *fragment);
+	ShaderVariants(const char *shaderName, Shader::LoadMode loadMode, Shader::DefaultVertex defaultVertex, const char *fragment);
+	~ShaderVariants();
+
+	inline const char *name() const { return name_.data(); }
+
+	/// Declares a feature keyword and returns its bit in a variant mask, or -1 if it cannot be added
+	int addKeyword(const char *keyword);
+	/// Returns the bit of a declared keyword in a variant mask, or -1 if it has not been declared
+	int keywordIndex(const char *keyword) const;
+	/// Returns the keyword at the specified bit of a variant mask
+	const char *keyword(unsigned int index) const;
+	/// Returns the number of declared keywords
+	inline unsigned int numKeywords() const { return keywords_.size(); }
+
+	/// Returns the mask of a list of keywords separated by spaces or commas
+	uint32_t keywordMask(const char *keywords) const;
+
+	/// Returns the variant with the keywords of the mask defined, compiling it if needed
+	/*! \return A `nullptr` if the variant fails to compile, the failure is logged and it is not cached */
+	Shader *variant(uint32_t keywordMask);
+	/// Returns the variant with the listed keywords defined, compiling it if needed
+	inline Shader *variant(const char *keywords) { return variant(keywordMask(keywords)); }
+	/// Returns true if the variant for the mask has already been compiled
+	bool hasVariant(uint32_t keywordMask) const;
+	/// Returns the number of compiled variants
+	inline unsigned int numVariants() const { return variants_.size(); }
+	/// Destroys all the compiled variants
+	void clear();
+
+	/// Compiles all the variants listed in a manifest file and returns their number
+	/*! \note Every line of the manifest lists the keywords of a variant, a single `-` stands for the base one and `#` starts a comment. */
+	unsigned int prewarm(const char *manifestFilename);
+	/// Saves a manifest file listing the keywords of all the compiled variants
+	bool saveManifest(const char *manifestFilename) const;
+
+  private:
+	nctl::String name_;
+	Shader::LoadMode loadMode_;
+	Shader::Introspection introspection_;
+	/// The vertex shader source or file path, empty when using a default vertex shader
+	nctl::String vertex_;
+	Shader::DefaultVertex defaultVertex_;
+	/// The fragment shader source or file path
+	nctl::String fragment_;
+
+	nctl::Array<nctl::String> keywords_;
+	nctl::HashMap<uint32_t, nctl::UniquePtr<Shader>> variants_;
+
+	/// Deleted copy constructor
+	ShaderVariants(const ShaderVariants &) = delete;
+	/// Deleted assignment operator
+	ShaderVariants &operator=(const ShaderVariants &) = delete;
+
+	/// Returns the bit of a keyword that is not null terminated, or -1 if it has not been declared
+	int keywordIndex(const char *keyword, unsigned int length) const;
+	/// Writes the keywords of a mask in a string, separated by the specified character
+	void appendKeywords(nctl::String &string, uint32_t keywordMask, char separator) const;
+};
+
+}
+
+#endif
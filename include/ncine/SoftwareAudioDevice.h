@@ -0,0 +1,167 @@
+#ifndef CLASS_NCINE_SOFTWAREAUDIODEVICE
+#define CLASS_NCINE_SOFTWAREAUDIODEVICE
+
+#include <cstdint>
+#include "IAudioDevice.h"
+#include "AudioMixer.h"
+#include "TimeStamp.h"
+#include <nctl/Array.h>
+#include <nctl/HashSet.h>
+#include <nctl/UniquePtr.h>
+
+namespace ncine {
+
+class AppConfiguration;
+
+/// An audio device that mixes the players in software, without OpenAL
+/*! It is used when no OpenAL device can be opened, or when `AppConfiguration::withSoftwareAudio` is set.
+ *  Audio buffers keep their samples in the device and every player is mixed by an `AudioMixer` at each update.
+ *  The mixed frames are written to a sink, which discards them unless another one is set.
+ *  \note Distance attenuation and horizontal panning are applied, while cones, velocities and effects are ignored. */
+class DLL_PUBLIC SoftwareAudioDevice : public IAudioDevice
+{
+  public:
+	explicit SoftwareAudioDevice(const AppConfiguration &appCfg);
+	~SoftwareAudioDevice() override;
+
+	/// Returns the software device if one exists, or `nullptr` when players use OpenAL
+	static SoftwareAudioDevice *instance() { return instance_; }
+
+	inline const Attributes &attributes() const override { return attributes_; }
+	inline const char *name() const override { return attributes_.deviceName; }
+	bool hasExtension(ALExtensions::Enum extensionName) const override { return false; }
+
+	float gain() const override { return gain_; }
+	void setGain(float gain) override { gain_ = gain; }
+
+	Vector3f position() const override { return position_; }
+	void setPosition(const Vector3f &position) override { position_ = position; }
+	void setPosition(float x, float y, float z) override { position_.set(x, y, z); }
+
+	Vector3f velocity() const override { return velocity_; }
+	void setVelocity(const Vector3f &velocity) override { velocity_ = velocity; }
+	void setVelocity(float x, float y, float z) override { velocity_.set(x, y, z); }
+
+	/// Players are mixed without OpenAL sources
+	inline unsigned int maxNumSources() const override { return 0; }
+	inline unsigned int numAvailableSources() const override { return 0; }
+
+	inline unsigned int numPlayers() const override { return players_.size(); }
+	const IAudioPlayer *player(unsigned int index) const override;
+	IAudioPlayer *player(unsigned int index) override;
+
+	inline unsigned int numVirtualPlayers() const override { return 0; }
+	const IAudioPlayer *virtualPlayer(unsigned int index) const override { return nullptr; }
+	IAudioPlayer *virtualPlayer(unsigned int index) override { return nullptr; }
+
+	void pausePlayers() override;
+	void stopPlayers() override;
+	void pausePlayers(PlayerType playerType) override;
+	void stopPlayers(PlayerType playerType) override;
+	void resumePlayers() override;
+
+	void pauseDevice() override;
+	void resumeDevice() override;
+
+	void registerPlayer(IAudioPlayer *player) override;
+	void unregisterPlayer(IAudioPlayer *player) override;
+	void updatePlayers() override;
+
+	inline unsigned int numStreamUnderruns() const override { return numStreamUnderruns_; }
+	inline void resetStreamUnderruns() override { numStreamUnderruns_ = 0; }
+
+	/// Returns the sink that receives the mixed frames
+	inline IAudioSink &sink() { return *sink_; }
+	/// Sets the sink that receives the mixed frames, or a sink that discards them if `nullptr`
+	void setSink(nctl::UniquePtr<IAudioSink> sink);
+	/// Returns the number of frames mixed since the device creation
+	inline unsigned long int numMixedFrames() const { return numMixedFrames_; }
+
+	/// Creates an empty buffer and returns its id, used by `AudioBuffer` instead of an OpenAL buffer
+	unsigned int createBuffer();
+	/// Copies 8 or 16 bits samples in the specified buffer, converting them to 16 bits
+	bool setBufferData(unsigned int bufferId, const unsigned char *bufferPtr, unsigned long int bufferSize,
+	                   int bytesPerSample, int numChannels, int frequency);
+	/// Deletes the specified buffer and frees its id
+	void deleteBuffer(unsigned int bufferId);
+
+  private:
+	/// The maximum time mixed at each update, longer frames are not caught up with
+	static const float MaxUpdateInterval;
+	/// The maximum number of frames mixed in a single pass by the mixer
+	static const unsigned int MaxFramesPerMix = 1024;
+
+	/// The samples of a buffer, converted to 16 bits
+	struct Buffer
+	{
+		Buffer()
+		    : numFrames(0), numChannels(0), frequency(0), isUsed(false) {}
+
+		nctl::UniquePtr<int16_t[]> samples;
+		unsigned long int numFrames;
+		int numChannels;
+		int frequency;
+		bool isUsed;
+	};
+
+	/// A player mixed in the current update, with the samples it is mixed from
+	struct MixedPlayer
+	{
+		IAudioPlayer *player;
+		/// The buffer of a buffer player, or `nullptr` for a stream player
+		const Buffer *buffer;
+		/// The offset of the frames read from a stream in the array of stream samples
+		unsigned int streamOffset;
+		unsigned long int numStreamFrames;
+		/// The handle of the mixer voice, or -1 if there is nothing to mix
+		int voiceHandle;
+	};
+
+	static SoftwareAudioDevice *instance_;
+
+	Attributes attributes_;
+	/// The listener gain value (master volume)
+	float gain_;
+	/// Listener position in space
+	Vector3f position_;
+	/// Listener velocity in space
+	Vector3f velocity_;
+
+	AudioMixer mixer_;
+	nctl::UniquePtr<IAudioSink> sink_;
+	/// The array of buffers, their ids are the indices plus one
+	nctl::Array<Buffer> buffers_;
+
+	/// The array of currently active audio players
+	nctl::Array<IAudioPlayer *> players_;
+	/// The array of audio players that have been paused by `pausePlayers()`
+	nctl::HashSet<IAudioPlayer *> pausedPlayers_;
+	/// The players mixed in the current update
+	nctl::Array<MixedPlayer> mixedPlayers_;
+	/// The frames read from all the playing streams in the current update
+	nctl::Array<int16_t> streamSamples_;
+
+	/// The time of the last update, to know how many frames to mix
+	TimeStamp lastUpdateTime_;
+	/// The fraction of a frame that was not mixed by the last update
+	double frameRemainder_;
+	unsigned long int numMixedFrames_;
+	/// The number of underruns of all stream players since the last reset
+	unsigned int numStreamUnderruns_;
+
+	/// Returns the buffer with the specified id, or `nullptr`
+	const Buffer *findBuffer(unsigned int bufferId) const;
+	/// Reads the frames of a stream player that cover the specified number of output frames
+	void readStream(MixedPlayer &mixedPlayer, unsigned int numFrames);
+	/// Adds a voice to the mixer for a player, with its gain attenuated by the distance and panned from the listener
+	void addVoice(MixedPlayer &mixedPlayer);
+
+	/// Deleted copy constructor
+	SoftwareAudioDevice(const SoftwareAudioDevice &) = delete;
+	/// Deleted assignment operator
+	SoftwareAudioDevice &operator=(const SoftwareAudioDevice &) = delete;
+};
+
+}
+
+#endif
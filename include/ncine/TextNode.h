@@ -4,6 +4,7 @@
 #include "DrawableNode.h"
 #include "Font.h"
 #include <nctl/Array.h>
+#include <nctl/SmallArray.h>
 #include <nctl/String.h>
 
 namespace ncine {
@@ -151,7 +152,7 @@ class DLL_PUBLIC TextNode : public DrawableNode
 	/// Advance on the Y-axis for the next processed glyph
 	mutable float yAdvance_;
 	/// Text width for each line of text
-	mutable nctl::Array<float> lineLengths_;
+	mutable nctl::SmallArray<float, 4> lineLengths_;
 	/// Horizontal text alignment of multiple lines
 	Alignment alignment_;
 	/// The line height for the text node
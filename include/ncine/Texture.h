@@ -10,6 +10,7 @@ namespace ncine {
 
 class ITextureLoader;
 class GLTexture;
+class TextureStreamer;
 
 /// Texture class
 class DLL_PUBLIC Texture : public Object
@@ -25,6 +26,16 @@ class DLL_PUBLIC Texture : public Object
 		UNKNOWN
 	};
 
+	/// Smaller pixel formats that uncompressed textures can be converted to when loading
+	enum class LoadConversion
+	{
+		NONE,
+		RGB565,
+		RGBA4444,
+		RGB5_A1,
+		R8
+	};
+
 	/// Texture filtering modes
 	enum class Filtering
 	{
@@ -91,6 +102,23 @@ class DLL_PUBLIC Texture : public Object
 	/// Loads texels in raw format from a memory buffer to a specific texture mip level and sub-region with a rectangle
 	bool loadFromTexels(const unsigned char *bufferPtr, unsigned int level, Recti region);
 
+	/// Returns true if the texture owns a ring of pixel buffers to stream texel updates
+	bool isStreamingEnabled() const;
+	/// Creates a ring of pixel buffers to stream texel updates to the first mip level
+	bool enableStreaming(unsigned int numBuffers);
+	/// Destroys the ring of pixel buffers used to stream texel updates
+	void disableStreaming();
+	/// Maps the next streaming buffer and returns a pointer where the texels of the first mip level can be written
+	unsigned char *mapStreamingBuffer();
+	/// Returns the number of bytes between two rows of the mapped streaming buffer
+	unsigned int streamingBufferPitch() const;
+	/// Marks a region of the mapped streaming buffer to be uploaded
+	void addStreamingRegion(unsigned int x, unsigned int y, unsigned int width, unsigned int height);
+	/// Marks a region of the mapped streaming buffer to be uploaded using a rectangle
+	void addStreamingRegion(Recti region);
+	/// Unmaps the streaming buffer and asynchronously uploads the marked regions
+	bool uploadStreamingBuffer();
+
 	/// Saves all texture texels in the first mip level in raw format to a memory buffer
 	bool saveToMemory(unsigned char *bufferPtr);
 	/// Saves all texture texels in the specified texture mip level in raw format to a memory buffer
@@ -141,6 +169,33 @@ class DLL_PUBLIC Texture : public Object
 	/// Sets the color to be treated as transparent when loading a texture, using a `Colorf`
 	inline void setChromaKeyColor(const Colorf &chromaKeyColor) { chromaKeyColor_ = chromaKeyColor; }
 
+	/// Returns true if a MIP map chain will be generated on the CPU when loading a texture without one
+	inline bool isMipMapGenerationEnabled() const { return isMipMapGenerationEnabled_; }
+	/// Sets the CPU MIP map generation state to use when loading
+	inline void setMipMapGenerationEnabled(bool mipMapGenerationEnabled) { isMipMapGenerationEnabled_ = mipMapGenerationEnabled; }
+
+	/// Returns the pixel format conversion that will be performed when loading
+	inline LoadConversion loadConversion() const { return loadConversion_; }
+	/// Returns true if ordered dithering will be used when converting pixels at load time
+	inline bool isLoadDitheringEnabled() const { return isLoadDitheringEnabled_; }
+	/// Sets the pixel format conversion to perform when loading
+	inline void setLoadConversion(LoadConversion loadConversion) { loadConversion_ = loadConversion; }
+	/// Sets the ordered dithering state to use when converting pixels at load time
+	inline void setLoadDitheringEnabled(bool loadDitheringEnabled) { isLoadDitheringEnabled_ = loadDitheringEnabled; }
+
+	/// Returns the CPU MIP map generation state assigned to every newly created texture
+	static bool isDefaultMipMapGenerationEnabled();
+	/// Sets the CPU MIP map generation state assigned to every newly created texture
+	static void setDefaultMipMapGenerationEnabled(bool mipMapGenerationEnabled);
+	/// Returns the pixel format conversion assigned to every newly created texture
+	static LoadConversion defaultLoadConversion();
+	/// Returns the ordered dithering state assigned to every newly created texture
+	static bool isDefaultLoadDitheringEnabled();
+	/// Sets the pixel format conversion assigned to every newly created texture
+	static void setDefaultLoadConversion(LoadConversion loadConversion);
+	/// Sets the ordered dithering state assigned to every newly created texture
+	static void setDefaultLoadDitheringEnabled(bool loadDitheringEnabled);
+
 	/// Sets the OpenGL object label for the texture
 	void setGLTextureLabel(const char *label);
 
@@ -151,6 +206,7 @@ class DLL_PUBLIC Texture : public Object
 
   private:
 	nctl::UniquePtr<GLTexture> glTexture_;
+	nctl::UniquePtr<TextureStreamer> streamer_;
 	int width_;
 	int height_;
 	int mipMapLevels_;
@@ -165,6 +221,14 @@ class DLL_PUBLIC Texture : public Object
 	bool isChromaKeyEnabled_;
 	Color chromaKeyColor_;
 
+	bool isMipMapGenerationEnabled_;
+	LoadConversion loadConversion_;
+	bool isLoadDitheringEnabled_;
+
+	static bool defaultMipMapGenerationEnabled_;
+	static LoadConversion defaultLoadConversion_;
+	static bool defaultLoadDitheringEnabled_;
+
 	/// Deleted copy constructor
 	Texture(const Texture &) = delete;
 	/// Deleted assignment operator
@@ -174,9 +238,15 @@ class DLL_PUBLIC Texture : public Object
 	void initialize(const ITextureLoader &texLoader);
 	/// Loads the data in a previously initialized texture
 	void load(const ITextureLoader &texLoader);
+	/// Names the texture and uploads the pixels of a loader to the GPU
+	void upload(const char *name, const ITextureLoader &texLoader);
+	/// Generates MIP maps and converts the loaded pixels according to the load options of the texture
+	/*! \note It only reads the load options and can be called from a worker thread */
+	void processPixels(ITextureLoader &texLoader) const;
 
 	friend class Material;
 	friend class Viewport;
+	friend class AssetPreloader;
 };
 
 }
@@ -224,6 +224,7 @@ class DLL_PUBLIC Viewport
 
 	friend class Application;
 	friend class ScreenViewport;
+	friend class FrameCapture;
 };
 
 }
@@ -23,6 +23,8 @@ class ArrayIterator
 	/// Copy constructor to implicitly convert a non constant iterator to a constant one
 	ArrayIterator(const ArrayIterator<T, false> &it)
 	    : elementPtr_(it.elementPtr_) {}
+	/// Default copy assignment operator, declared as the constructor above is user-provided
+	ArrayIterator &operator=(const ArrayIterator &) = default;
 
 	/// Deferencing operator
 	Reference operator*() const;
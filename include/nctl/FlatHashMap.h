@@ -0,0 +1,783 @@
+#ifndef CLASS_NCTL_FLATHASHMAP
+#define CLASS_NCTL_FLATHASHMAP
+
+#include <new>
+#include <cstdint>
+#include <ncine/common_macros.h>
+#include "HashFunctions.h"
+#include "ReverseIterator.h"
+#include <cstring> // for memcpy() and memset()
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define NCTL_FLATHASHMAP_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define NCTL_FLATHASHMAP_NEON 1
+#endif
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+#include <ncine/config.h>
+#if NCINE_WITH_ALLOCATORS
+	#include "AllocManager.h"
+	#include "IAllocator.h"
+#endif
+
+namespace nctl {
+
+template <class K, class T, class HashFunc, bool IsConst> class FlatHashMapIterator;
+template <class K, class T, class HashFunc, bool IsConst> struct FlatHashMapHelperTraits;
+
+/// A group of control bytes of a flat hashmap that are matched together
+/*! Every control byte is either empty, deleted, or it stores the highest seven bits of the hash of a full bucket.
+ *  A match returns a bit mask with one bit set for every matching byte, that is iterated with `lowestIndex()` and `clearLowest()`. */
+class FlatHashMapGroup
+{
+  public:
+	/// Number of control bytes in a group
+	static const unsigned int Size = 16;
+	/// The control byte of an empty bucket
+	static const int8_t Empty = -128;
+	/// The control byte of a bucket whose element has been removed
+	static const int8_t Deleted = -2;
+
+	/// Bit mask type returned by the match functions
+	using BitMask = uint64_t;
+
+	explicit FlatHashMapGroup(const int8_t *ctrl)
+#if NCTL_FLATHASHMAP_SSE2
+	    : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl))) {}
+#elif NCTL_FLATHASHMAP_NEON
+	    : ctrl_(vld1q_s8(ctrl)) {}
+#else
+	    : ctrl_(ctrl) {}
+#endif
+
+	/// Returns the control byte stored for a hash
+	/*! The highest seven bits are used, to keep the fragment as independent as possible from the bits selecting the group */
+	static inline int8_t hashFragment(hash_t hash) { return static_cast<int8_t>(hash >> (sizeof(hash_t) * 8 - 7)); }
+	/// Returns true if the control byte belongs to a full bucket
+	static inline bool isFull(int8_t ctrl) { return ctrl >= 0; }
+
+	/// Returns the index in the group of the lowest bit set in a mask
+	static inline unsigned int lowestIndex(BitMask mask) { return countTrailingZeros(mask) >> MaskShift; }
+	/// Returns the mask without its lowest bit set
+	static inline BitMask clearLowest(BitMask mask) { return mask & (mask - 1); }
+
+#if NCTL_FLATHASHMAP_SSE2
+	/// Matches the control bytes equal to the given hash fragment
+	inline BitMask match(int8_t fragment) const
+	{
+		return static_cast<BitMask>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl_, _mm_set1_epi8(fragment))));
+	}
+
+	/// Matches the control bytes of empty buckets
+	inline BitMask matchEmpty() const { return match(Empty); }
+
+	/// Matches the control bytes of empty or deleted buckets
+	inline BitMask matchEmptyOrDeleted() const
+	{
+		return static_cast<BitMask>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrl_)));
+	}
+#elif NCTL_FLATHASHMAP_NEON
+	/// Matches the control bytes equal to the given hash fragment
+	inline BitMask match(int8_t fragment) const { return toBitMask(vceqq_s8(ctrl_, vdupq_n_s8(fragment))); }
+	/// Matches the control bytes of empty buckets
+	inline BitMask matchEmpty() const { return match(Empty); }
+	/// Matches the control bytes of empty or deleted buckets
+	inline BitMask matchEmptyOrDeleted() const { return toBitMask(vcltq_s8(ctrl_, vdupq_n_s8(-1))); }
+#else
+	/// Matches the control bytes equal to the given hash fragment
+	inline BitMask match(int8_t fragment) const
+	{
+		BitMask mask = 0;
+		for (unsigned int i = 0; i < Size; i++)
+			mask |= static_cast<BitMask>(ctrl_[i] == fragment) << i;
+		return mask;
+	}
+
+	/// Matches the control bytes of empty buckets
+	inline BitMask matchEmpty() const { return match(Empty); }
+
+	/// Matches the control bytes of empty or deleted buckets
+	inline BitMask matchEmptyOrDeleted() const
+	{
+		BitMask mask = 0;
+		for (unsigned int i = 0; i < Size; i++)
+			mask |= static_cast<BitMask>(ctrl_[i] < -1) << i;
+		return mask;
+	}
+#endif
+
+  private:
+#if NCTL_FLATHASHMAP_SSE2
+	/// One bit per control byte in the mask
+	static const unsigned int MaskShift = 0;
+	__m128i ctrl_;
+#elif NCTL_FLATHASHMAP_NEON
+	/// Four bits per control byte in the mask, only the highest one is kept
+	static const unsigned int MaskShift = 2;
+	int8x16_t ctrl_;
+
+	/// Narrows a byte comparison result to a nibble per byte, as there is no move mask instruction
+	static inline BitMask toBitMask(uint8x16_t result)
+	{
+		const uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(result), 4);
+		return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) & 0x8888888888888888ULL;
+	}
+#else
+	/// One bit per control byte in the mask
+	static const unsigned int MaskShift = 0;
+	const int8_t *ctrl_;
+#endif
+
+	/// Returns the number of trailing zero bits of a non zero mask
+	static inline unsigned int countTrailingZeros(BitMask mask)
+	{
+#if defined(_MSC_VER)
+		unsigned long index = 0;
+	#if defined(_M_X64) || defined(_M_ARM64)
+		_BitScanForward64(&index, mask);
+	#else
+		if (static_cast<uint32_t>(mask) != 0)
+			_BitScanForward(&index, static_cast<uint32_t>(mask));
+		else
+		{
+			_BitScanForward(&index, static_cast<uint32_t>(mask >> 32));
+			index += 32;
+		}
+	#endif
+		return static_cast<unsigned int>(index);
+#else
+		return static_cast<unsigned int>(__builtin_ctzll(mask));
+#endif
+	}
+};
+
+/// A template based hashmap implementation with open addressing and SIMD probing of groups of control bytes
+/*! Every bucket has a control byte and the buckets are probed a group at a time, matching sixteen control bytes
+ *  with a single SSE2 or NEON comparison before comparing any key. Hashes are not stored, they are computed again on rehash.
+ *  \note The capacity is rounded up to a multiple of the group size */
+template <class K, class T, class HashFunc = FNV1aHashFunc<K>>
+class FlatHashMap
+{
+  public:
+	/// Iterator type
+	using Iterator = FlatHashMapIterator<K, T, HashFunc, false>;
+	/// Constant iterator type
+	using ConstIterator = FlatHashMapIterator<K, T, HashFunc, true>;
+	/// Reverse iterator type
+	using ReverseIterator = nctl::ReverseIterator<Iterator>;
+	/// Reverse constant iterator type
+	using ConstReverseIterator = nctl::ReverseIterator<ConstIterator>;
+
+	explicit FlatHashMap(unsigned int capacity);
+#if NCINE_WITH_ALLOCATORS
+	FlatHashMap(unsigned int capacity, IAllocator &alloc);
+#endif
+	~FlatHashMap();
+
+	/// Copy constructor
+	FlatHashMap(const FlatHashMap &other);
+	/// Move constructor
+	FlatHashMap(FlatHashMap &&other);
+	/// Assignment operator
+	FlatHashMap &operator=(const FlatHashMap &other);
+	/// Move assignment operator
+	FlatHashMap &operator=(FlatHashMap &&other);
+
+	/// Swaps two hashmaps without copying their data
+	inline void swap(FlatHashMap &first, FlatHashMap &second)
+	{
+#if NCINE_WITH_ALLOCATORS
+		nctl::swap(first.alloc_, second.alloc_);
+#endif
+		nctl::swap(first.size_, second.size_);
+		nctl::swap(first.capacity_, second.capacity_);
+		nctl::swap(first.numGroups_, second.numGroups_);
+		nctl::swap(first.numDeleted_, second.numDeleted_);
+		nctl::swap(first.ctrl_, second.ctrl_);
+		nctl::swap(first.nodes_, second.nodes_);
+	}
+
+	/// Returns an iterator to the first element
+	Iterator begin();
+	/// Returns a reverse iterator to the last element
+	ReverseIterator rBegin();
+	/// Returns an iterator to past the last element
+	Iterator end();
+	/// Returns a reverse iterator to prior the first element
+	ReverseIterator rEnd();
+
+	/// Returns a constant iterator to the first element
+	ConstIterator begin() const;
+	/// Returns a constant reverse iterator to the last element
+	ConstReverseIterator rBegin() const;
+	/// Returns a constant iterator to past the last lement
+	ConstIterator end() const;
+	/// Returns a constant reverse iterator to prior the first element
+	ConstReverseIterator rEnd() const;
+
+	/// Returns a constant iterator to the first element
+	inline ConstIterator cBegin() const { return begin(); }
+	/// Returns a constant reverse iterator to the last element
+	inline ConstReverseIterator crBegin() const { return rBegin(); }
+	/// Returns a constant iterator to past the last lement
+	inline ConstIterator cEnd() const { return end(); }
+	/// Returns a constant reverse iterator to prior the first element
+	inline ConstReverseIterator crEnd() const { return rEnd(); }
+
+	/// Subscript operator
+	T &operator[](const K &key);
+	/// Inserts an element if no other has the same key
+	bool insert(const K &key, const T &value);
+	/// Moves an element if no other has the same key
+	bool insert(const K &key, T &&value);
+	/// Constructs an element if no other has the same key
+	template <typename... Args> bool emplace(const K &key, Args &&... args);
+
+	/// Returns the capacity of the hashmap
+	inline unsigned int capacity() const { return capacity_; }
+	/// Returns true if the hashmap is empty
+	inline bool isEmpty() const { return size_ == 0; }
+	/// Returns the number of elements in the hashmap
+	inline unsigned int size() const { return size_; }
+	/// Returns the ratio between used and total buckets
+	inline float loadFactor() const { return size_ / static_cast<float>(capacity_); }
+	/// Returns the hash of a given key
+	inline hash_t hash(const K &key) const { return hashFunc_(key); }
+
+	/// Clears the hashmap
+	void clear();
+	/// Checks whether an element is in the hashmap or not
+	bool contains(const K &key, T &returnedValue) const;
+	/// Checks whether an element is in the hashmap or not
+	T *find(const K &key);
+	/// Checks whether an element is in the hashmap or not (read-only)
+	const T *find(const K &key) const;
+	/// Removes a key from the hashmap, if it exists
+	bool remove(const K &key);
+
+	/// Sets the number of buckets to the new specified size and rehashes the container
+	void rehash(unsigned int count);
+
+  private:
+	using Group = FlatHashMapGroup;
+
+	/// The template class for the node stored inside the hashmap
+	class Node
+	{
+	  public:
+		K key;
+		T value;
+
+		Node() {}
+		explicit Node(K kk)
+		    : key(kk) {}
+		Node(K kk, const T &vv)
+		    : key(kk), value(vv) {}
+		Node(K kk, T &&vv)
+		    : key(kk), value(nctl::move(vv)) {}
+		template <typename... Args>
+		Node(K kk, Args &&... args)
+		    : key(kk), value(nctl::forward<Args>(args)...) {}
+	};
+
+#if NCINE_WITH_ALLOCATORS
+	/// The custom memory allocator for the hashmap
+	IAllocator &alloc_;
+#endif
+	unsigned int size_;
+	unsigned int capacity_;
+	unsigned int numGroups_;
+	/// Number of buckets marked as deleted, they are reused by insertions and purged by a rehash
+	unsigned int numDeleted_;
+	/// One control byte per bucket
+	int8_t *ctrl_;
+	Node *nodes_;
+	HashFunc hashFunc_;
+
+	static unsigned int roundCapacity(unsigned int capacity);
+	void allocate();
+	void initValues();
+	void destructNodes();
+	void deallocate();
+	unsigned int groupIndex(hash_t hash) const;
+	inline unsigned int nextGroup(unsigned int group) const { return (group + 1 < numGroups_) ? group + 1 : 0; }
+	bool findBucketIndex(const K &key, hash_t hash, unsigned int &foundIndex) const;
+	inline bool findBucketIndex(const K &key, unsigned int &foundIndex) const;
+	unsigned int prepareInsert(hash_t hash);
+
+	friend class FlatHashMapIterator<K, T, HashFunc, false>;
+	friend class FlatHashMapIterator<K, T, HashFunc, true>;
+	friend struct FlatHashMapHelperTraits<K, T, HashFunc, false>;
+	friend struct FlatHashMapHelperTraits<K, T, HashFunc, true>;
+};
+
+template <class K, class T, class HashFunc>
+inline typename FlatHashMap<K, T, HashFunc>::Iterator FlatHashMap<K, T, HashFunc>::begin()
+{
+	Iterator iterator(this, Iterator::SentinelTagInit::BEGINNING);
+	return ++iterator;
+}
+
+template <class K, class T, class HashFunc>
+typename FlatHashMap<K, T, HashFunc>::ReverseIterator FlatHashMap<K, T, HashFunc>::rBegin()
+{
+	Iterator iterator(this, Iterator::SentinelTagInit::END);
+	return ReverseIterator(--iterator);
+}
+
+template <class K, class T, class HashFunc>
+typename FlatHashMap<K, T, HashFunc>::Iterator FlatHashMap<K, T, HashFunc>::end()
+{
+	return Iterator(this, Iterator::SentinelTagInit::END);
+}
+
+template <class K, class T, class HashFunc>
+typename FlatHashMap<K, T, HashFunc>::ReverseIterator FlatHashMap<K, T, HashFunc>::rEnd()
+{
+	Iterator iterator(this, Iterator::SentinelTagInit::BEGINNING);
+	return ReverseIterator(iterator);
+}
+
+template <class K, class T, class HashFunc>
+typename FlatHashMap<K, T, HashFunc>::ConstIterator FlatHashMap<K, T, HashFunc>::begin() const
+{
+	ConstIterator iterator(this, ConstIterator::SentinelTagInit::BEGINNING);
+	return ++iterator;
+}
+
+template <class K, class T, class HashFunc>
+typename FlatHashMap<K, T, HashFunc>::ConstReverseIterator FlatHashMap<K, T, HashFunc>::rBegin() const
+{
+	ConstIterator iterator(this, ConstIterator::SentinelTagInit::END);
+	return ConstReverseIterator(--iterator);
+}
+
+template <class K, class T, class HashFunc>
+typename FlatHashMap<K, T, HashFunc>::ConstIterator FlatHashMap<K, T, HashFunc>::end() const
+{
+	return ConstIterator(this, ConstIterator::SentinelTagInit::END);
+}
+
+template <class K, class T, class HashFunc>
+typename FlatHashMap<K, T, HashFunc>::ConstReverseIterator FlatHashMap<K, T, HashFunc>::rEnd() const
+{
+	ConstIterator iterator(this, ConstIterator::SentinelTagInit::BEGINNING);
+	return ConstReverseIterator(iterator);
+}
+
+template <class K, class T, class HashFunc>
+FlatHashMap<K, T, HashFunc>::FlatHashMap(unsigned int capacity)
+    :
+#if NCINE_WITH_ALLOCATORS
+      alloc_(theDefaultAllocator()),
+#endif
+      size_(0), capacity_(roundCapacity(capacity)), numGroups_(capacity_ / Group::Size),
+      numDeleted_(0), ctrl_(nullptr), nodes_(nullptr)
+{
+	FATAL_ASSERT_MSG(capacity > 0, "Zero is not a valid capacity");
+
+	allocate();
+	initValues();
+}
+
+#if NCINE_WITH_ALLOCATORS
+template <class K, class T, class HashFunc>
+FlatHashMap<K, T, HashFunc>::FlatHashMap(unsigned int capacity, IAllocator &alloc)
+    : alloc_(alloc), size_(0), capacity_(roundCapacity(capacity)), numGroups_(capacity_ / Group::Size),
+      numDeleted_(0), ctrl_(nullptr), nodes_(nullptr)
+{
+	FATAL_ASSERT_MSG(capacity > 0, "Zero is not a valid capacity");
+
+	allocate();
+	initValues();
+}
+#endif
+
+template <class K, class T, class HashFunc>
+FlatHashMap<K, T, HashFunc>::~FlatHashMap()
+{
+	destructNodes();
+	deallocate();
+}
+
+template <class K, class T, class HashFunc>
+FlatHashMap<K, T, HashFunc>::FlatHashMap(const FlatHashMap<K, T, HashFunc> &other)
+    :
+#if NCINE_WITH_ALLOCATORS
+      alloc_(other.alloc_),
+#endif
+      size_(other.size_), capacity_(other.capacity_), numGroups_(other.numGroups_),
+      numDeleted_(other.numDeleted_), ctrl_(nullptr), nodes_(nullptr)
+{
+	FATAL_ASSERT_MSG(capacity_ > 0, "Zero is not a valid capacity");
+
+	allocate();
+	memcpy(ctrl_, other.ctrl_, capacity_);
+	for (unsigned int i = 0; i < capacity_; i++)
+	{
+		if (Group::isFull(ctrl_[i]))
+			new (nodes_ + i) Node(other.nodes_[i]);
+	}
+}
+
+template <class K, class T, class HashFunc>
+FlatHashMap<K, T, HashFunc>::FlatHashMap(FlatHashMap<K, T, HashFunc> &&other)
+    :
+#if NCINE_WITH_ALLOCATORS
+      alloc_(other.alloc_),
+#endif
+      size_(other.size_), capacity_(other.capacity_), numGroups_(other.numGroups_),
+      numDeleted_(other.numDeleted_), ctrl_(other.ctrl_), nodes_(other.nodes_)
+{
+	other.size_ = 0;
+	other.capacity_ = 0;
+	other.numGroups_ = 0;
+	other.numDeleted_ = 0;
+	other.ctrl_ = nullptr;
+	other.nodes_ = nullptr;
+}
+
+template <class K, class T, class HashFunc>
+FlatHashMap<K, T, HashFunc> &FlatHashMap<K, T, HashFunc>::operator=(const FlatHashMap<K, T, HashFunc> &other)
+{
+	if (this == &other)
+		return *this;
+
+	// The bucket of an element depends on the number of groups
+	if (capacity_ != other.capacity_)
+	{
+		destructNodes();
+		deallocate();
+
+		capacity_ = other.capacity_;
+		numGroups_ = other.numGroups_;
+		allocate();
+		initValues();
+	}
+
+	for (unsigned int i = 0; i < capacity_; i++)
+	{
+		if (Group::isFull(other.ctrl_[i]))
+		{
+			if (Group::isFull(ctrl_[i]))
+				nodes_[i] = other.nodes_[i];
+			else
+				new (nodes_ + i) Node(other.nodes_[i]);
+		}
+		else if (Group::isFull(ctrl_[i]))
+			destructObject(nodes_ + i);
+	}
+	if (capacity_ > 0)
+		memcpy(ctrl_, other.ctrl_, capacity_);
+	size_ = other.size_;
+	numDeleted_ = other.numDeleted_;
+
+	return *this;
+}
+
+template <class K, class T, class HashFunc>
+FlatHashMap<K, T, HashFunc> &FlatHashMap<K, T, HashFunc>::operator=(FlatHashMap<K, T, HashFunc> &&other)
+{
+	if (this != &other)
+	{
+		swap(*this, other);
+		other.clear();
+	}
+	return *this;
+}
+
+template <class K, class T, class HashFunc>
+T &FlatHashMap<K, T, HashFunc>::operator[](const K &key)
+{
+	const hash_t hash = hashFunc_(key);
+	unsigned int bucketIndex = 0;
+	if (findBucketIndex(key, hash, bucketIndex))
+		return nodes_[bucketIndex].value;
+
+	bucketIndex = prepareInsert(hash);
+	new (nodes_ + bucketIndex) Node(key);
+	return nodes_[bucketIndex].value;
+}
+
+/*! \return True if the element has been inserted */
+template <class K, class T, class HashFunc>
+bool FlatHashMap<K, T, HashFunc>::insert(const K &key, const T &value)
+{
+	const hash_t hash = hashFunc_(key);
+	unsigned int bucketIndex = 0;
+	if (findBucketIndex(key, hash, bucketIndex))
+		return false;
+
+	bucketIndex = prepareInsert(hash);
+	new (nodes_ + bucketIndex) Node(key, value);
+	return true;
+}
+
+/*! \return True if the element has been inserted */
+template <class K, class T, class HashFunc>
+bool FlatHashMap<K, T, HashFunc>::insert(const K &key, T &&value)
+{
+	const hash_t hash = hashFunc_(key);
+	unsigned int bucketIndex = 0;
+	if (findBucketIndex(key, hash, bucketIndex))
+		return false;
+
+	bucketIndex = prepareInsert(hash);
+	new (nodes_ + bucketIndex) Node(key, nctl::move(value));
+	return true;
+}
+
+/*! \return True if the element has been emplaced */
+template <class K, class T, class HashFunc>
+template <typename... Args>
+bool FlatHashMap<K, T, HashFunc>::emplace(const K &key, Args &&... args)
+{
+	const hash_t hash = hashFunc_(key);
+	unsigned int bucketIndex = 0;
+	if (findBucketIndex(key, hash, bucketIndex))
+		return false;
+
+	bucketIndex = prepareInsert(hash);
+	new (nodes_ + bucketIndex) Node(key, nctl::forward<Args>(args)...);
+	return true;
+}
+
+template <class K, class T, class HashFunc>
+void FlatHashMap<K, T, HashFunc>::clear()
+{
+	destructNodes();
+	initValues();
+}
+
+template <class K, class T, class HashFunc>
+bool FlatHashMap<K, T, HashFunc>::contains(const K &key, T &returnedValue) const
+{
+	unsigned int bucketIndex = 0;
+	const bool found = findBucketIndex(key, bucketIndex);
+
+	if (found)
+		returnedValue = nodes_[bucketIndex].value;
+
+	return found;
+}
+
+/*! \note Prefer this method if copying `T` is expensive, but always check the validity of returned pointer. */
+template <class K, class T, class HashFunc>
+T *FlatHashMap<K, T, HashFunc>::find(const K &key)
+{
+	unsigned int bucketIndex = 0;
+	const bool found = findBucketIndex(key, bucketIndex);
+
+	T *returnedPtr = nullptr;
+	if (found)
+		returnedPtr = &nodes_[bucketIndex].value;
+
+	return returnedPtr;
+}
+
+/*! \note Prefer this method if copying `T` is expensive, but always check the validity of returned pointer. */
+template <class K, class T, class HashFunc>
+const T *FlatHashMap<K, T, HashFunc>::find(const K &key) const
+{
+	unsigned int bucketIndex = 0;
+	const bool found = findBucketIndex(key, bucketIndex);
+
+	const T *returnedPtr = nullptr;
+	if (found)
+		returnedPtr = &nodes_[bucketIndex].value;
+
+	return returnedPtr;
+}
+
+/*! \return True if the element has been found and removed */
+template <class K, class T, class HashFunc>
+bool FlatHashMap<K, T, HashFunc>::remove(const K &key)
+{
+	unsigned int bucketIndex = 0;
+	const bool found = findBucketIndex(key, bucketIndex);
+
+	if (found)
+	{
+		destructObject(nodes_ + bucketIndex);
+		size_--;
+
+		// A probe sequence stops at a group with an empty bucket, so the bucket can only be emptied if its group already has one
+		const unsigned int group = bucketIndex / Group::Size;
+		if (Group(ctrl_ + group * Group::Size).matchEmpty() != 0)
+			ctrl_[bucketIndex] = Group::Empty;
+		else
+		{
+			ctrl_[bucketIndex] = Group::Deleted;
+			numDeleted_++;
+		}
+	}
+
+	return found;
+}
+
+template <class K, class T, class HashFunc>
+void FlatHashMap<K, T, HashFunc>::rehash(unsigned int count)
+{
+	if (count < size_)
+		return;
+	else if (size_ == 0)
+	{
+		// There are no nodes to move, but the deleted buckets still need to be purged
+		initValues();
+		return;
+	}
+
+	FlatHashMap<K, T, HashFunc> hashMap(count);
+
+	unsigned int rehashedNodes = 0;
+	for (unsigned int i = 0; i < capacity_; i++)
+	{
+		if (Group::isFull(ctrl_[i]))
+		{
+			Node &node = nodes_[i];
+			hashMap.insert(node.key, nctl::move(node.value));
+
+			rehashedNodes++;
+			if (rehashedNodes == size_)
+				break;
+		}
+	}
+
+	*this = nctl::move(hashMap);
+}
+
+template <class K, class T, class HashFunc>
+unsigned int FlatHashMap<K, T, HashFunc>::roundCapacity(unsigned int capacity)
+{
+	return ((capacity + Group::Size - 1) / Group::Size) * Group::Size;
+}
+
+template <class K, class T, class HashFunc>
+void FlatHashMap<K, T, HashFunc>::allocate()
+{
+#if !NCINE_WITH_ALLOCATORS
+	ctrl_ = static_cast<int8_t *>(::operator new(sizeof(int8_t) * capacity_));
+	nodes_ = static_cast<Node *>(::operator new(sizeof(Node) * capacity_));
+#else
+	ctrl_ = static_cast<int8_t *>(alloc_.allocate(sizeof(int8_t) * capacity_));
+	nodes_ = static_cast<Node *>(alloc_.allocate(sizeof(Node) * capacity_));
+#endif
+}
+
+template <class K, class T, class HashFunc>
+void FlatHashMap<K, T, HashFunc>::initValues()
+{
+	if (capacity_ > 0)
+		memset(ctrl_, Group::Empty, capacity_);
+	numDeleted_ = 0;
+}
+
+template <class K, class T, class HashFunc>
+void FlatHashMap<K, T, HashFunc>::destructNodes()
+{
+	for (unsigned int i = 0; i < capacity_; i++)
+	{
+		if (Group::isFull(ctrl_[i]))
+		{
+			destructObject(nodes_ + i);
+			ctrl_[i] = Group::Empty;
+		}
+	}
+	size_ = 0;
+}
+
+template <class K, class T, class HashFunc>
+void FlatHashMap<K, T, HashFunc>::deallocate()
+{
+#if !NCINE_WITH_ALLOCATORS
+	::operator delete(ctrl_);
+	::operator delete(nodes_);
+#else
+	alloc_.deallocate(ctrl_);
+	alloc_.deallocate(nodes_);
+#endif
+}
+
+/*! The hash is scrambled with a Fibonacci multiplication and mapped to a group without a division */
+template <class K, class T, class HashFunc>
+unsigned int FlatHashMap<K, T, HashFunc>::groupIndex(hash_t hash) const
+{
+	const uint32_t scrambled = static_cast<uint32_t>(hash) * 2654435769U;
+	return static_cast<unsigned int>((static_cast<uint64_t>(scrambled) * numGroups_) >> 32);
+}
+
+template <class K, class T, class HashFunc>
+bool FlatHashMap<K, T, HashFunc>::findBucketIndex(const K &key, hash_t hash, unsigned int &foundIndex) const
+{
+	if (size_ == 0)
+		return false;
+
+	const int8_t fragment = Group::hashFragment(hash);
+	unsigned int group = groupIndex(hash);
+	for (unsigned int i = 0; i < numGroups_; i++)
+	{
+		const Group ctrlGroup(ctrl_ + group * Group::Size);
+		for (Group::BitMask mask = ctrlGroup.match(fragment); mask != 0; mask = Group::clearLowest(mask))
+		{
+			const unsigned int index = group * Group::Size + Group::lowestIndex(mask);
+			if (equalTo(nodes_[index].key, key))
+			{
+				foundIndex = index;
+				return true;
+			}
+		}
+
+		// An element is never placed after a group with an empty bucket
+		if (ctrlGroup.matchEmpty() != 0)
+			return false;
+		group = nextGroup(group);
+	}
+
+	return false;
+}
+
+template <class K, class T, class HashFunc>
+bool FlatHashMap<K, T, HashFunc>::findBucketIndex(const K &key, unsigned int &foundIndex) const
+{
+	return findBucketIndex(key, hashFunc_(key), foundIndex);
+}
+
+/*! \return The index of the first empty or deleted bucket of the probe sequence, marked as full */
+template <class K, class T, class HashFunc>
+unsigned int FlatHashMap<K, T, HashFunc>::prepareInsert(hash_t hash)
+{
+	FATAL_ASSERT(size_ < capacity_);
+
+	// Deleted buckets make probe sequences longer, purge them when they are too many
+	if (numDeleted_ > capacity_ / 8 && size_ + numDeleted_ >= capacity_ - capacity_ / 8)
+		rehash(capacity_);
+
+	unsigned int group = groupIndex(hash);
+	for (unsigned int i = 0; i < numGroups_; i++)
+	{
+		const Group::BitMask mask = Group(ctrl_ + group * Group::Size).matchEmptyOrDeleted();
+		if (mask != 0)
+		{
+			const unsigned int index = group * Group::Size + Group::lowestIndex(mask);
+			if (ctrl_[index] == Group::Deleted)
+				numDeleted_--;
+			ctrl_[index] = Group::hashFragment(hash);
+			size_++;
+			return index;
+		}
+		group = nextGroup(group);
+	}
+
+	FATAL_MSG("No free bucket has been found");
+	return 0;
+}
+
+}
+
+#endif
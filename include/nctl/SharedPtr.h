@@ -177,8 +177,7 @@ SharedPtr<T>::~SharedPtr()
 {
 	if (ctrlBlock_)
 	{
-		ctrlBlock_->counter_--;
-		if (ctrlBlock_->counter_ <= 0)
+		if (--ctrlBlock_->counter_ <= 0)
 #if !NCINE_WITH_ALLOCATORS
 			delete ctrlBlock_;
 #else
@@ -222,8 +221,7 @@ void SharedPtr<T>::reset(T *newPtr)
 	// check for self reset
 	if (ptr_ != newPtr)
 	{
-		ctrlBlock_->counter_--;
-		if (ctrlBlock_->counter_ <= 0)
+		if (--ctrlBlock_->counter_ <= 0)
 			ctrlBlock_->dispose();
 
 		ptr_ = newPtr;
@@ -235,8 +233,7 @@ void SharedPtr<T>::reset(T *newPtr)
 template <class T>
 void SharedPtr<T>::reset(nullptr_t)
 {
-	ctrlBlock_->counter_--;
-	if (ctrlBlock_->counter_ <= 0)
+	if (--ctrlBlock_->counter_ <= 0)
 		ctrlBlock_->dispose();
 
 	ptr_ = nullptr;
@@ -0,0 +1,779 @@
+#ifndef CLASS_NCTL_SMALLARRAY
+#define CLASS_NCTL_SMALLARRAY
+
+#include <new>
+#include <ncine/common_macros.h>
+#include "Array.h"
+#include "ArrayIterator.h"
+#include "ReverseIterator.h"
+#include "utility.h"
+
+#include <ncine/config.h>
+#if NCINE_WITH_ALLOCATORS
+	#include "AllocManager.h"
+	#include "IAllocator.h"
+#endif
+
+namespace nctl {
+
+/// A dynamic array based on templates that stores up to `N` elements inside the object and the others in the heap
+/*! The array does not allocate memory until its size grows beyond `N`, then it behaves like an `Array`.
+ *  \note The capacity is never smaller than `N`, and moving an array with inline elements moves every element */
+template <class T, unsigned int N>
+class SmallArray
+{
+	static_assert(N > 0, "The inline capacity of a small array cannot be zero");
+
+  public:
+	/// Iterator type
+	using Iterator = ArrayIterator<T, false>;
+	/// Constant iterator type
+	using ConstIterator = ArrayIterator<T, true>;
+	/// Reverse iterator type
+	using ReverseIterator = nctl::ReverseIterator<Iterator>;
+	/// Reverse constant iterator type
+	using ConstReverseIterator = nctl::ReverseIterator<ConstIterator>;
+
+	/// Number of elements that are stored inside the object
+	static const unsigned int InlineCapacity = N;
+
+	/// Constructs an array without allocating memory
+	SmallArray()
+	    : SmallArray(N, ArrayMode::GROWING_CAPACITY) {}
+	/// Constructs an array with explicit capacity
+	explicit SmallArray(unsigned int capacity)
+	    : SmallArray(capacity, ArrayMode::GROWING_CAPACITY) {}
+#if !NCINE_WITH_ALLOCATORS
+	/// Constructs an array with explicit capacity and the option for it to be fixed
+	SmallArray(unsigned int capacity, ArrayMode mode);
+#else
+	/// Constructs an array with explicit capacity and the option for it to be fixed
+	SmallArray(unsigned int capacity, ArrayMode mode)
+	    : SmallArray(capacity, mode, theDefaultAllocator()) {}
+	/// Constructs an array with explicit capacity and a custom allocator
+	SmallArray(unsigned int capacity, IAllocator &alloc)
+	    : SmallArray(capacity, ArrayMode::GROWING_CAPACITY, alloc) {}
+	/// Constructs an array with explicit capacity, the option for it to be fixed, and a custom allocator
+	SmallArray(unsigned int capacity, ArrayMode mode, IAllocator &alloc);
+#endif
+	~SmallArray();
+
+	/// Copy constructor
+	SmallArray(const SmallArray &other);
+	/// Move constructor
+	SmallArray(SmallArray &&other);
+	/// Assignment operator
+	SmallArray &operator=(const SmallArray &other);
+	/// Move assignment operator
+	SmallArray &operator=(SmallArray &&other);
+
+	/// Swaps two arrays, without copying their data if both are stored in the heap
+	void swap(SmallArray &first, SmallArray &second);
+
+	/// Returns an iterator to the first element
+	inline Iterator begin() { return Iterator(array_); }
+	/// Returns a reverse iterator to the last element
+	inline ReverseIterator rBegin() { return ReverseIterator(Iterator(array_ + size_ - 1)); }
+	/// Returns an iterator to past the last element
+	inline Iterator end() { return Iterator(array_ + size_); }
+	/// Returns a reverse iterator to prior the first element
+	inline ReverseIterator rEnd() { return ReverseIterator(Iterator(array_ - 1)); }
+
+	/// Returns a constant iterator to the first element
+	inline ConstIterator begin() const { return ConstIterator(array_); }
+	/// Returns a constant reverse iterator to the last element
+	inline ConstReverseIterator rBegin() const { return ConstReverseIterator(ConstIterator(array_ + size_ - 1)); }
+	/// Returns a constant iterator to past the last lement
+	inline ConstIterator end() const { return ConstIterator(array_ + size_); }
+	/// Returns a constant reverse iterator to prior the first element
+	inline ConstReverseIterator rEnd() const { return ConstReverseIterator(ConstIterator(array_ - 1)); }
+
+	/// Returns a constant iterator to the first element
+	inline ConstIterator cBegin() const { return ConstIterator(array_); }
+	/// Returns a constant reverse iterator to the last element
+	inline ConstReverseIterator crBegin() const { return ConstReverseIterator(ConstIterator(array_ + size_ - 1)); }
+	/// Returns a constant iterator to past the last lement
+	inline ConstIterator cEnd() const { return ConstIterator(array_ + size_); }
+	/// Returns a constant reverse iterator to prior the first element
+	inline ConstReverseIterator crEnd() const { return ConstReverseIterator(ConstIterator(array_ - 1)); }
+
+	/// Returns true if the array is empty
+	inline bool isEmpty() const { return size_ == 0; }
+	/// Returns the array size
+	/*! The array is filled without gaps until the `Size()`-1 element. */
+	inline unsigned int size() const { return size_; }
+	/// Returns the array capacity
+	/*! The array has memory allocated to store until the `Capacity()`-1 element. */
+	inline unsigned int capacity() const { return capacity_; }
+	/// Returns true if the elements are stored inside the object
+	inline bool isInline() const { return array_ == inlineArray(); }
+	/// Sets a new size for the array (allowing for "holes")
+	void setSize(unsigned int newSize);
+	/// Sets a new capacity for the array (can be bigger or smaller than the current one)
+	/*! \note A capacity smaller than `N` moves the elements back inside the object */
+	void setCapacity(unsigned int newCapacity);
+	/// Decreases the capacity to match the current size of the array
+	void shrinkToFit();
+
+	/// Clears the array
+	void clear();
+	/// Returns a constant reference to the first element in constant time
+	const T &front() const;
+	/// Returns a reference to the first element in constant time
+	T &front();
+	/// Returns a constant reference to the last element in constant time
+	const T &back() const;
+	/// Returns a reference to the last element in constant time
+	T &back();
+	/// Appends a new element in constant time, the element is copied into the array
+	inline void pushBack(const T &element) { new (extendOne()) T(element); }
+	/// Appends a new element in constant time, the element is moved into the array
+	inline void pushBack(T &&element) { new (extendOne()) T(nctl::move(element)); }
+	/// Constructs a new element at the end of the array
+	template <typename... Args> void emplaceBack(Args &&... args);
+	/// Removes the last element in constant time
+	void popBack();
+	/// Inserts new elements at the specified position from a source range, last not included (shifting elements around)
+	T *insertRange(unsigned int index, const T *firstPtr, const T *lastPtr);
+	/// Inserts a new element at a specified position (shifting elements around)
+	T *insertAt(unsigned int index, const T &element);
+	/// Move inserts a new element at a specified position (shifting elements around)
+	T *insertAt(unsigned int index, T &&element);
+	/// Constructs a new element at the position specified by the index
+	template <typename... Args> T *emplaceAt(unsigned int index, Args &&... args);
+	/// Inserts a new element at the position specified by the iterator (shifting elements around)
+	Iterator insert(Iterator position, const T &value);
+	/// Move inserts a new element at the position specified by the iterator (shifting elements around)
+	Iterator insert(Iterator position, T &&value);
+	/// Inserts new elements from a source at the position specified by the iterator (shifting elements around)
+	Iterator insert(Iterator position, Iterator first, Iterator last);
+	/// Constructs a new element at the position specified by the iterator
+	template <typename... Args> Iterator emplace(Iterator position, Args &&... args);
+
+	/// Removes the specified range of elements, last not included (shifting elements around)
+	T *removeRange(unsigned int firstIndex, unsigned int lastIndex);
+	/// Removes an element at a specified position (shifting elements around)
+	inline Iterator removeAt(unsigned int index) { return Iterator(removeRange(index, index + 1)); }
+	/// Removes the element pointed by the iterator (shifting elements around)
+	Iterator erase(Iterator position);
+	/// Removes the elements in the range, last not included (shifting elements around)
+	Iterator erase(Iterator first, const Iterator last);
+
+	/// Removes the specified range of elements, last not included (moving tail elements in place)
+	T *unorderedRemoveRange(unsigned int firstIndex, unsigned int lastIndex);
+	/// Removes an element at a specified position (moving the last element in place)
+	inline Iterator unorderedRemoveAt(unsigned int index) { return Iterator(unorderedRemoveRange(index, index + 1)); }
+	/// Removes the element pointed by the iterator (moving the last element in place)
+	Iterator unorderedErase(Iterator position);
+	/// Removes the elements in the range, last not included (moving tail elements in place)
+	Iterator unorderedErase(Iterator first, const Iterator last);
+
+	/// Read-only access to the specified element (with bounds checking)
+	const T &at(unsigned int index) const;
+	/// Access to the specified element (with bounds checking)
+	T &at(unsigned int index);
+	/// Read-only subscript operator
+	const T &operator[](unsigned int index) const;
+	/// Subscript operator
+	T &operator[](unsigned int index);
+
+	/// Returns a constant pointer to the memory holding the elements
+	inline const T *data() const { return array_; }
+	/// Returns a pointer to the memory holding the elements
+	/*! When adding new elements through a pointer the size field is not updated, like with `std::vector`. */
+	inline T *data() { return array_; }
+
+  private:
+#if NCINE_WITH_ALLOCATORS
+	/// The custom memory allocator for the array
+	IAllocator &alloc_;
+#endif
+	T *array_;
+	unsigned int size_;
+	unsigned int capacity_;
+	bool fixedCapacity_;
+	alignas(T) unsigned char inlineBuffer_[N * sizeof(T)];
+
+	inline T *inlineArray() { return reinterpret_cast<T *>(inlineBuffer_); }
+	inline const T *inlineArray() const { return reinterpret_cast<const T *>(inlineBuffer_); }
+	/// Allocates heap memory for the specified number of elements
+	T *allocate(unsigned int capacity);
+	/// Releases the heap memory, if the elements are not stored inside the object
+	void deallocate();
+	/// Grows the array size by one and returns a pointer to the new element
+	T *extendOne();
+};
+
+#if !NCINE_WITH_ALLOCATORS
+template <class T, unsigned int N>
+SmallArray<T, N>::SmallArray(unsigned int capacity, ArrayMode mode)
+    : array_(inlineArray()), size_(0), capacity_(N), fixedCapacity_(mode == ArrayMode::FIXED_CAPACITY)
+{
+	if (capacity > N)
+	{
+		array_ = allocate(capacity);
+		capacity_ = capacity;
+	}
+}
+#else
+template <class T, unsigned int N>
+SmallArray<T, N>::SmallArray(unsigned int capacity, ArrayMode mode, IAllocator &alloc)
+    : alloc_(alloc), array_(inlineArray()), size_(0), capacity_(N),
+      fixedCapacity_(mode == ArrayMode::FIXED_CAPACITY)
+{
+	if (capacity > N)
+	{
+		array_ = allocate(capacity);
+		capacity_ = capacity;
+	}
+}
+#endif
+
+template <class T, unsigned int N>
+SmallArray<T, N>::~SmallArray()
+{
+	destructArray(array_, size_);
+	deallocate();
+}
+
+template <class T, unsigned int N>
+SmallArray<T, N>::SmallArray(const SmallArray<T, N> &other)
+    :
+#if NCINE_WITH_ALLOCATORS
+      alloc_(other.alloc_),
+#endif
+      array_(inlineArray()), size_(other.size_), capacity_(N), fixedCapacity_(other.fixedCapacity_)
+{
+	if (other.capacity_ > N)
+	{
+		array_ = allocate(other.capacity_);
+		capacity_ = other.capacity_;
+	}
+	copyConstructArray(array_, other.array_, size_);
+}
+
+template <class T, unsigned int N>
+SmallArray<T, N>::SmallArray(SmallArray<T, N> &&other)
+    :
+#if NCINE_WITH_ALLOCATORS
+      alloc_(other.alloc_),
+#endif
+      array_(inlineArray()), size_(other.size_), capacity_(N), fixedCapacity_(other.fixedCapacity_)
+{
+	if (other.isInline())
+	{
+		moveConstructArray(array_, other.array_, size_);
+		other.clear();
+	}
+	else
+	{
+		// Stealing the heap memory, the other array is left with its inline storage
+		array_ = other.array_;
+		capacity_ = other.capacity_;
+		other.array_ = other.inlineArray();
+		other.size_ = 0;
+		other.capacity_ = N;
+	}
+}
+
+template <class T, unsigned int N>
+SmallArray<T, N> &SmallArray<T, N>::operator=(const SmallArray<T, N> &other)
+{
+	if (this == &other)
+		return *this;
+
+	if (other.size_ > capacity_)
+		setCapacity(other.size_);
+
+	if (other.size_ > 0 && other.size_ >= size_)
+	{
+		copyAssignArray(array_, other.array_, size_);
+		copyConstructArray(array_ + size_, other.array_ + size_, other.size_ - size_);
+	}
+	else if (size_ > 0 && size_ >= other.size_)
+	{
+		copyAssignArray(array_, other.array_, other.size_);
+		destructArray(array_ + other.size_, size_ - other.size_);
+	}
+
+	size_ = other.size_;
+	return *this;
+}
+
+template <class T, unsigned int N>
+SmallArray<T, N> &SmallArray<T, N>::operator=(SmallArray<T, N> &&other)
+{
+	if (this == &other)
+		return *this;
+
+#if NCINE_WITH_ALLOCATORS
+	const bool canStealMemory = (other.isInline() == false && &alloc_ == &other.alloc_);
+#else
+	const bool canStealMemory = (other.isInline() == false);
+#endif
+	if (canStealMemory)
+	{
+		destructArray(array_, size_);
+		deallocate();
+
+		array_ = other.array_;
+		size_ = other.size_;
+		capacity_ = other.capacity_;
+		other.array_ = other.inlineArray();
+		other.size_ = 0;
+		other.capacity_ = N;
+		return *this;
+	}
+
+	if (other.size_ > capacity_)
+		setCapacity(other.size_);
+
+	if (other.size_ > 0 && other.size_ >= size_)
+	{
+		moveAssignArray(array_, other.array_, size_);
+		moveConstructArray(array_ + size_, other.array_ + size_, other.size_ - size_);
+	}
+	else if (size_ > 0 && size_ >= other.size_)
+	{
+		moveAssignArray(array_, other.array_, other.size_);
+		destructArray(array_ + other.size_, size_ - other.size_);
+	}
+
+	size_ = other.size_;
+	other.clear();
+	return *this;
+}
+
+template <class T, unsigned int N>
+void SmallArray<T, N>::swap(SmallArray<T, N> &first, SmallArray<T, N> &second)
+{
+	if (&first == &second)
+		return;
+
+#if NCINE_WITH_ALLOCATORS
+	const bool canSwapMemory = (first.isInline() == false && second.isInline() == false && &first.alloc_ == &second.alloc_);
+#else
+	const bool canSwapMemory = (first.isInline() == false && second.isInline() == false);
+#endif
+	if (canSwapMemory)
+	{
+		nctl::swap(first.array_, second.array_);
+		nctl::swap(first.size_, second.size_);
+		nctl::swap(first.capacity_, second.capacity_);
+		nctl::swap(first.fixedCapacity_, second.fixedCapacity_);
+	}
+	else
+	{
+		// Inline elements have to be moved one by one, with both capacities free to grow meanwhile
+		const bool firstFixedCapacity = first.fixedCapacity_;
+		const bool secondFixedCapacity = second.fixedCapacity_;
+		first.fixedCapacity_ = false;
+		second.fixedCapacity_ = false;
+
+		SmallArray<T, N> temp(nctl::move(first));
+		first = nctl::move(second);
+		second = nctl::move(temp);
+
+		first.fixedCapacity_ = secondFixedCapacity;
+		second.fixedCapacity_ = firstFixedCapacity;
+	}
+}
+
+template <class T, unsigned int N>
+void SmallArray<T, N>::setSize(unsigned int newSize)
+{
+	const int newElements = newSize - size_;
+
+	if (newSize > capacity_)
+	{
+		setCapacity(newSize);
+		// Modifying size only if the capacity is not fixed
+		if (capacity_ < newSize)
+			return;
+	}
+
+	if (newElements > 0)
+		constructArray(array_ + size_, newElements);
+	else if (newElements < 0)
+		destructArray(array_ + size_ + newElements, -newElements);
+	size_ += newElements;
+}
+
+template <class T, unsigned int N>
+void SmallArray<T, N>::setCapacity(unsigned int newCapacity)
+{
+	// Setting a new capacity is disabled if the array is fixed
+	if (fixedCapacity_)
+	{
+		LOGW_X("Trying to change the capacity of a fixed array, from from %u to %u", capacity_, newCapacity);
+		return;
+	}
+
+	// The inline storage is used for every capacity up to `N`
+	const bool toInline = (newCapacity <= N);
+	if (toInline)
+		newCapacity = N;
+
+	if (newCapacity == capacity_)
+	{
+		LOGW_X("Array capacity already equal to %u", capacity_);
+		return;
+	}
+	else if (newCapacity < capacity_)
+		LOGI_X("Array capacity shrinking from %u to %u", capacity_, newCapacity);
+	else if (newCapacity > capacity_)
+		LOGD_X("Array capacity growing from %u to %u", capacity_, newCapacity);
+
+	T *newArray = toInline ? inlineArray() : allocate(newCapacity);
+
+	if (size_ > 0)
+	{
+		const unsigned int oldSize = size_;
+		if (newCapacity < size_) // shrinking
+			size_ = newCapacity; // cropping last elements
+
+		moveConstructArray(newArray, array_, size_);
+		destructArray(array_, oldSize);
+	}
+
+	deallocate();
+	array_ = newArray;
+	capacity_ = newCapacity;
+}
+
+template <class T, unsigned int N>
+void SmallArray<T, N>::shrinkToFit()
+{
+	if (size_ < capacity_ && capacity_ > N)
+		setCapacity(size_);
+}
+
+/*! \note Size will be set to zero but capacity remains unmodified. */
+template <class T, unsigned int N>
+void SmallArray<T, N>::clear()
+{
+	destructArray(array_, size_);
+	size_ = 0;
+}
+
+template <class T, unsigned int N>
+const T &SmallArray<T, N>::front() const
+{
+	FATAL_ASSERT_MSG(size_ > 0, "Cannot retrieve an element from an empty array");
+	return array_[0];
+}
+
+template <class T, unsigned int N>
+T &SmallArray<T, N>::front()
+{
+	FATAL_ASSERT_MSG(size_ > 0, "Cannot retrieve an element from an empty array");
+	return array_[0];
+}
+
+template <class T, unsigned int N>
+const T &SmallArray<T, N>::back() const
+{
+	FATAL_ASSERT_MSG(size_ > 0, "Cannot retrieve an element from an empty array");
+	return array_[size_ - 1];
+}
+
+template <class T, unsigned int N>
+T &SmallArray<T, N>::back()
+{
+	FATAL_ASSERT_MSG(size_ > 0, "Cannot retrieve an element from an empty array");
+	return array_[size_ - 1];
+}
+
+template <class T, unsigned int N>
+template <typename... Args>
+void SmallArray<T, N>::emplaceBack(Args &&... args)
+{
+	new (extendOne()) T(nctl::forward<Args>(args)...);
+}
+
+template <class T, unsigned int N>
+void SmallArray<T, N>::popBack()
+{
+	FATAL_ASSERT_MSG(size_ > 0, "Cannot pop an element from an empty array");
+	destructObject(array_ + size_ - 1);
+	size_--;
+}
+
+template <class T, unsigned int N>
+T *SmallArray<T, N>::insertRange(unsigned int index, const T *firstPtr, const T *lastPtr)
+{
+	// Cannot insert at more than one position after the last element
+	FATAL_ASSERT_MSG_X(index <= size_, "Index %u is out of bounds (size: %u)", index, size_);
+	FATAL_ASSERT_MSG_X(firstPtr <= lastPtr, "First pointer %p should precede or be equal to the last one %p", firstPtr, lastPtr);
+
+	const unsigned int numElements = static_cast<unsigned int>(lastPtr - firstPtr);
+
+	if (size_ + numElements > capacity_)
+		setCapacity((size_ + numElements) * 2);
+
+	// Backwards loop to account for overlapping areas
+	for (unsigned int i = size_ - index; i > 0; i--)
+		array_[index + numElements + i - 1] = nctl::move(array_[index + i - 1]);
+	copyConstructArray(array_ + index, firstPtr, numElements);
+	size_ += numElements;
+
+	return (array_ + index + numElements);
+}
+
+template <class T, unsigned int N>
+T *SmallArray<T, N>::insertAt(unsigned int index, const T &element)
+{
+	// Cannot insert at more than one position after the last element
+	FATAL_ASSERT_MSG_X(index <= size_, "Index %u is out of bounds (size: %u)", index, size_);
+
+	if (size_ + 1 > capacity_)
+		setCapacity(size_ * 2);
+
+	if (index < size_)
+	{
+		// Constructing a new element by moving the last one
+		new (array_ + size_) T(nctl::move(array_[size_ - 1]));
+		// Backwards loop to account for overlapping areas
+		for (unsigned int i = size_ - index - 1; i > 0; i--)
+			array_[index + i] = nctl::move(array_[index + i - 1]);
+		array_[index] = element;
+	}
+	else
+		new (array_ + size_) T(element);
+	size_++;
+
+	return (array_ + index + 1);
+}
+
+template <class T, unsigned int N>
+T *SmallArray<T, N>::insertAt(unsigned int index, T &&element)
+{
+	// Cannot insert at more than one position after the last element
+	FATAL_ASSERT_MSG_X(index <= size_, "Index %u is out of bounds (size: %u)", index, size_);
+
+	if (size_ + 1 > capacity_)
+		setCapacity(size_ * 2);
+
+	if (index < size_)
+	{
+		// Constructing a new element by moving the last one
+		new (array_ + size_) T(nctl::move(array_[size_ - 1]));
+		// Backwards loop to account for overlapping areas
+		for (unsigned int i = size_ - index - 1; i > 0; i--)
+			array_[index + i] = nctl::move(array_[index + i - 1]);
+		array_[index] = nctl::move(element);
+	}
+	else
+		new (array_ + size_) T(nctl::move(element));
+	size_++;
+
+	return (array_ + index + 1);
+}
+
+template <class T, unsigned int N>
+template <typename... Args>
+T *SmallArray<T, N>::emplaceAt(unsigned int index, Args &&... args)
+{
+	// Cannot emplace at more than one position after the last element
+	FATAL_ASSERT_MSG_X(index <= size_, "Index %u is out of bounds (size: %u)", index, size_);
+
+	if (size_ + 1 > capacity_)
+		setCapacity(size_ * 2);
+
+	if (index < size_)
+	{
+		// Constructing a new element by moving the last one
+		new (array_ + size_) T(nctl::move(array_[size_ - 1]));
+		// Backwards loop to account for overlapping areas
+		for (unsigned int i = size_ - index - 1; i > 0; i--)
+			array_[index + i] = nctl::move(array_[index + i - 1]);
+		destructObject(array_ + index);
+	}
+	new (array_ + index) T(nctl::forward<Args>(args)...);
+	size_++;
+
+	return (array_ + index + 1);
+}
+
+template <class T, unsigned int N>
+typename SmallArray<T, N>::Iterator SmallArray<T, N>::insert(Iterator position, const T &value)
+{
+	const unsigned int index = &(*position) - array_;
+	T *nextElement = insertAt(index, value);
+
+	return Iterator(nextElement);
+}
+
+template <class T, unsigned int N>
+typename SmallArray<T, N>::Iterator SmallArray<T, N>::insert(Iterator position, T &&value)
+{
+	const unsigned int index = &(*position) - array_;
+	T *nextElement = insertAt(index, nctl::move(value));
+
+	return Iterator(nextElement);
+}
+
+template <class T, unsigned int N>
+typename SmallArray<T, N>::Iterator SmallArray<T, N>::insert(Iterator position, Iterator first, Iterator last)
+{
+	const unsigned int index = static_cast<unsigned int>(&(*position) - array_);
+	const T *firstPtr = &(*first);
+	const T *lastPtr = &(*last);
+	T *nextElement = insertRange(index, firstPtr, lastPtr);
+
+	return Iterator(nextElement);
+}
+
+template <class T, unsigned int N>
+template <typename... Args>
+typename SmallArray<T, N>::Iterator SmallArray<T, N>::emplace(Iterator position, Args &&... args)
+{
+	const unsigned int index = &(*position) - array_;
+	T *nextElement = emplaceAt(index, nctl::forward<Args>(args)...);
+
+	return Iterator(nextElement);
+}
+
+template <class T, unsigned int N>
+T *SmallArray<T, N>::removeRange(unsigned int firstIndex, unsigned int lastIndex)
+{
+	// Cannot remove past the last element
+	FATAL_ASSERT_MSG_X(firstIndex < size_, "First index %u out of size range", firstIndex);
+	FATAL_ASSERT_MSG_X(lastIndex <= size_, "Last index %u out of size range", lastIndex);
+	FATAL_ASSERT_MSG_X(firstIndex <= lastIndex, "First index %u should precede or be equal to the last one %u", firstIndex, lastIndex);
+
+	const unsigned int numElements = lastIndex - firstIndex;
+	moveAssignArray(array_ + firstIndex, array_ + lastIndex, size_ - lastIndex);
+	destructArray(array_ + size_ - numElements, numElements);
+	size_ -= numElements;
+
+	return (array_ + firstIndex);
+}
+
+template <class T, unsigned int N>
+typename SmallArray<T, N>::Iterator SmallArray<T, N>::erase(Iterator position)
+{
+	const unsigned int index = static_cast<unsigned int>(&(*position) - array_);
+	return removeAt(index);
+}
+
+template <class T, unsigned int N>
+typename SmallArray<T, N>::Iterator SmallArray<T, N>::erase(Iterator first, const Iterator last)
+{
+	const unsigned int firstIndex = static_cast<unsigned int>(&(*first) - array_);
+	const unsigned int lastIndex = static_cast<unsigned int>(&(*last) - array_);
+	T *nextElement = removeRange(firstIndex, lastIndex);
+
+	return Iterator(nextElement);
+}
+
+/*! \note This method is faster than `removeRange()` but it will not preserve the array order */
+template <class T, unsigned int N>
+T *SmallArray<T, N>::unorderedRemoveRange(unsigned int firstIndex, unsigned int lastIndex)
+{
+	// Cannot remove past the last element
+	FATAL_ASSERT_MSG_X(firstIndex < size_, "First index %u out of size range", firstIndex);
+	FATAL_ASSERT_MSG_X(lastIndex <= size_, "Last index %u out of size range", lastIndex);
+	FATAL_ASSERT_MSG_X(firstIndex <= lastIndex, "First index %u should precede or be equal to the last one %u", firstIndex, lastIndex);
+
+	const unsigned int numElements = lastIndex - firstIndex;
+	for (unsigned int i = 0; i < numElements; i++)
+		array_[firstIndex + i] = nctl::move(array_[size_ - i - 1]);
+	destructArray(array_ + size_ - numElements, numElements);
+	size_ -= numElements;
+
+	return (array_ + firstIndex + 1);
+}
+
+/*! \note This method is faster than `erase()` but it will not preserve the array order */
+template <class T, unsigned int N>
+typename SmallArray<T, N>::Iterator SmallArray<T, N>::unorderedErase(Iterator position)
+{
+	const unsigned int index = static_cast<unsigned int>(&(*position) - array_);
+	return unorderedRemoveAt(index);
+}
+
+/*! \note This method is faster than `erase()` but it will not preserve the array order */
+template <class T, unsigned int N>
+typename SmallArray<T, N>::Iterator SmallArray<T, N>::unorderedErase(Iterator first, const Iterator last)
+{
+	const unsigned int firstIndex = static_cast<unsigned int>(&(*first) - array_);
+	const unsigned int lastIndex = static_cast<unsigned int>(&(*last) - array_);
+	T *nextElement = unorderedRemoveRange(firstIndex, lastIndex);
+
+	return Iterator(nextElement);
+}
+
+template <class T, unsigned int N>
+const T &SmallArray<T, N>::at(unsigned int index) const
+{
+	FATAL_ASSERT_MSG_X(index < size_, "Index %u is out of bounds (size: %u)", index, size_);
+	return operator[](index);
+}
+
+template <class T, unsigned int N>
+T &SmallArray<T, N>::at(unsigned int index)
+{
+	FATAL_ASSERT_MSG_X(index < size_, "Index %u is out of bounds (size: %u)", index, size_);
+	return operator[](index);
+}
+
+template <class T, unsigned int N>
+const T &SmallArray<T, N>::operator[](unsigned int index) const
+{
+	ASSERT_MSG_X(index < size_, "Index %u is out of bounds (size: %u)", index, size_);
+	return array_[index];
+}
+
+template <class T, unsigned int N>
+T &SmallArray<T, N>::operator[](unsigned int index)
+{
+	ASSERT_MSG_X(index < size_, "Index %u is out of bounds (size: %u)", index, size_);
+	return array_[index];
+}
+
+template <class T, unsigned int N>
+T *SmallArray<T, N>::allocate(unsigned int capacity)
+{
+#if !NCINE_WITH_ALLOCATORS
+	return static_cast<T *>(::operator new(capacity * sizeof(T)));
+#else
+	return static_cast<T *>(alloc_.allocate(capacity * sizeof(T)));
+#endif
+}
+
+template <class T, unsigned int N>
+void SmallArray<T, N>::deallocate()
+{
+	if (isInline())
+		return;
+
+#if !NCINE_WITH_ALLOCATORS
+	::operator delete(array_);
+#else
+	alloc_.deallocate(array_);
+#endif
+}
+
+template <class T, unsigned int N>
+T *SmallArray<T, N>::extendOne()
+{
+	// Need growing
+	if (size_ == capacity_)
+	{
+		const unsigned int newCapacity = capacity_ * 2;
+		setCapacity(newCapacity);
+		// Extending size only if the capacity is not fixed
+		FATAL_ASSERT_MSG_X(capacity_ == newCapacity, "Cannot extend array capacity to %u elements", newCapacity);
+		if (capacity_ == newCapacity)
+			size_++;
+	}
+	else
+		size_++;
+
+	return array_ + size_ - 1;
+}
+
+}
+
+#endif
@@ -1,8 +1,10 @@
 #ifndef NCTL_ALGORITHMS
 #define NCTL_ALGORITHMS
 
+#include <new>
 #include <cmath>
 #include "iterator.h"
+#include "type_traits.h"
 #include "utility.h"
 
 namespace nctl {
@@ -710,8 +712,86 @@ inline const Iterator isSortedUntil(Iterator first, const Iterator last, Compare
 	return last;
 }
 
+/// Insertion sort implementation with iterators and custom compare function
+/*! \note The sort is stable if the compare function is a strict ordering, like `IsLess` or `IsGreater` */
+template <class Iterator, class Compare>
+inline void insertionsort(Iterator first, Iterator last, Compare comp)
+{
+	const int size = distance(first, last);
+
+	int i = 1;
+	while (i < size)
+	{
+		if (comp(*(first + i), *(first + i - 1)))
+		{
+			typename IteratorTraits<Iterator>::ValueType x = nctl::move(*(first + i));
+			int j = i;
+			do
+			{
+				*(first + j) = nctl::move(*(first + j - 1));
+				j--;
+			} while (j > 0 && comp(x, *(first + j - 1)));
+			*(first + j) = nctl::move(x);
+		}
+		i++;
+	}
+}
+
+/// Insertion sort implementation with iterators, ascending order
+template <class Iterator>
+inline void insertionsort(Iterator first, Iterator last)
+{
+	insertionsort(first, last, IsLess<typename IteratorTraits<Iterator>::ValueType>);
+}
+
+/// Insertion sort implementation with iterators, descending order
+template <class Iterator>
+inline void insertionsortDesc(Iterator first, Iterator last)
+{
+	insertionsort(first, last, IsGreater<typename IteratorTraits<Iterator>::ValueType>);
+}
+
 namespace {
 
+	/// Number of elements under which the sorting algorithms switch to insertion sort
+	const int InsertionSortThreshold = 16;
+	/// Number of elements over which the quicksort pivot is the median of three medians of three
+	const int NintherThreshold = 128;
+	/// Maximum number of elements moved by the partial insertion sort before giving up
+	const int PartialInsertionSortLimit = 8;
+
+	/// Sorts three elements in place, leaving the median in the second one
+	template <class Iterator, class Compare>
+	inline void sort3(Iterator a, Iterator b, Iterator c, Compare comp)
+	{
+		if (comp(*b, *a))
+			swap(*a, *b);
+		if (comp(*c, *b))
+		{
+			swap(*b, *c);
+			if (comp(*b, *a))
+				swap(*a, *b);
+		}
+	}
+
+	/// Moves the chosen pivot to the first position of a random access range with at least three elements
+	template <class Iterator, class Compare>
+	inline void selectPivot(Iterator first, Iterator last, Compare comp)
+	{
+		const int size = distance(first, last);
+		Iterator middle = first + size / 2;
+		if (size > NintherThreshold)
+		{
+			sort3(first, middle, last - 1, comp);
+			sort3(first + 1, middle - 1, last - 2, comp);
+			sort3(first + 2, middle + 1, last - 3, comp);
+			sort3(middle - 1, middle, middle + 1, comp);
+			swap(*first, *middle);
+		}
+		else
+			sort3(middle, first, last - 1, comp);
+	}
+
 	/// Partition function for quicksort with iterators and custom compare function
 	template <class Iterator, class Compare>
 	inline Iterator partition(Iterator first, Iterator last, Compare comp)
@@ -741,20 +821,94 @@ namespace {
 		return first;
 	}
 
+	/// Partitions a random access range around the pivot in its first position, returning the final pivot position
+	/*! Both scans stop on elements equal to the pivot, so that repeated values are split evenly between the two sides.
+	 *  The `alreadyPartitioned` flag is set to true if no element had to be swapped. */
+	template <class Iterator, class Compare>
+	inline Iterator partitionRight(Iterator first, Iterator last, Compare comp, bool &alreadyPartitioned)
+	{
+		Iterator left = first;
+		Iterator right = last;
+		alreadyPartitioned = true;
+
+		while (true)
+		{
+			do
+			{
+				++left;
+			} while (left != last && comp(*left, *first));
+
+			do
+			{
+				--right;
+			} while (right != first && comp(*first, *right));
+
+			if (!(left < right))
+				break;
+
+			swap(*left, *right);
+			alreadyPartitioned = false;
+		}
+
+		swap(*first, *right);
+		return right;
+	}
+
+	/// Partitions a random access range putting the elements equal to the pivot in its first position on the left side
+	/*! It is used when the pivot is equal to the element preceding the range, so that all the left side is made of equal elements. */
+	template <class Iterator, class Compare>
+	inline Iterator partitionLeft(Iterator first, Iterator last, Compare comp)
+	{
+		Iterator left = first;
+		Iterator right = last;
+
+		while (true)
+		{
+			do
+			{
+				--right;
+			} while (right != first && comp(*first, *right));
+
+			do
+			{
+				++left;
+			} while (left < right && !comp(*first, *left));
+
+			if (!(left < right))
+				break;
+
+			swap(*left, *right);
+		}
+
+		swap(*first, *right);
+		return right;
+	}
+
 	/// Quicksort implementation with random access iterators and custom compare function
+	/*! The pivot is a median of three and the recursion only happens on the smaller side to bound the stack depth.
+	 *  Small partitions are left to insertion sort. */
 	template <class Iterator, class Compare>
 	inline void quicksort(Iterator first, Iterator last, RandomAccessIteratorTag, Compare comp)
 	{
-		const int size = distance(first, last);
-		if (size > 1)
+		bool alreadyPartitioned = false;
+		while (distance(first, last) >= InsertionSortThreshold)
 		{
-			Iterator p = prev(last);
-			swap(*next(first, size / 2), *p);
-			Iterator q = partition(first, p, comp);
-			swap(*q, *p);
-			quicksort(first, q, RandomAccessIteratorTag(), comp);
-			quicksort(next(q), last, RandomAccessIteratorTag(), comp);
+			selectPivot(first, last, comp);
+			Iterator pivot = partitionRight(first, last, comp, alreadyPartitioned);
+
+			if (distance(first, pivot) < distance(pivot, last))
+			{
+				quicksort(first, pivot, RandomAccessIteratorTag(), comp);
+				first = next(pivot);
+			}
+			else
+			{
+				quicksort(next(pivot), last, RandomAccessIteratorTag(), comp);
+				last = pivot;
+			}
 		}
+
+		insertionsort(first, last, comp);
 	}
 
 	/// Quicksort implementation with bidirectional iterators and custom compare function
@@ -792,7 +946,7 @@ inline void quicksort(Iterator first, Iterator last)
 template <class Iterator>
 inline void quicksortDesc(Iterator first, Iterator last)
 {
-	quicksort(first, last, IteratorTraits<Iterator>::IteratorCategory(), IsNotLess<typename IteratorTraits<Iterator>::ValueType>);
+	quicksort(first, last, IteratorTraits<Iterator>::IteratorCategory(), IsGreater<typename IteratorTraits<Iterator>::ValueType>);
 }
 
 namespace {
@@ -852,90 +1006,363 @@ inline void heapsort(Iterator first, Iterator last)
 template <class Iterator>
 inline void heapsortDesc(Iterator first, Iterator last)
 {
-	heapsort(first, last, IsNotLess<typename IteratorTraits<Iterator>::ValueType>);
+	heapsort(first, last, IsGreater<typename IteratorTraits<Iterator>::ValueType>);
 }
 
-/// Insertion sort implementation with iterators and custom compare function
-template <class Iterator, class Compare>
-inline void insertionsort(Iterator first, Iterator last, Compare comp)
-{
-	const int size = distance(first, last);
+namespace {
 
-	int i = 1;
-	while (i < size)
+	/// Insertion sort that gives up after moving too many elements, returns true if the range has been sorted
+	template <class Iterator, class Compare>
+	inline bool partialInsertionsort(Iterator first, Iterator last, Compare comp)
 	{
-		auto x = *(first + i);
-		int j = i;
-		while (j > 0 && comp(x, *(first + j - 1)))
+		const int size = distance(first, last);
+
+		int numMoves = 0;
+		for (int i = 1; i < size; i++)
 		{
-			*(first + j) = *(first + j - 1);
-			j--;
+			if (comp(*(first + i), *(first + i - 1)))
+			{
+				typename IteratorTraits<Iterator>::ValueType x = nctl::move(*(first + i));
+				int j = i;
+				do
+				{
+					*(first + j) = nctl::move(*(first + j - 1));
+					j--;
+				} while (j > 0 && comp(x, *(first + j - 1)));
+				*(first + j) = nctl::move(x);
+
+				numMoves += i - j;
+				if (numMoves > PartialInsertionSortLimit)
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	/// Swaps some elements of a random access range to break the patterns that made its partition highly unbalanced
+	template <class Iterator>
+	inline void breakPatterns(Iterator first, Iterator last)
+	{
+		const int size = distance(first, last);
+		if (size < InsertionSortThreshold)
+			return;
+
+		const int quarter = size / 4;
+		swap(*first, *(first + quarter));
+		swap(*(last - 1), *(last - quarter));
+		if (size > NintherThreshold)
+		{
+			swap(*(first + 1), *(first + quarter + 1));
+			swap(*(first + 2), *(first + quarter + 2));
+			swap(*(last - 2), *(last - quarter - 1));
+			swap(*(last - 3), *(last - quarter - 2));
+		}
+	}
+
+	/// Returns the maximum recursion depth of introsort before switching to heapsort
+	inline unsigned int introsortMaxDepth(int size)
+	{
+		unsigned int log2Size = 0;
+		while (size > 1)
+		{
+			size >>= 1;
+			log2Size++;
+		}
+		return log2Size * 2;
+	}
+
+	/// Introspective sort implementation with iterators and custom compare function
+	/*! It is a pattern-defeating quicksort: the pivot is a median of three, elements equal to the pivot are
+	 *  partitioned evenly or skipped altogether, and already sorted partitions are detected with a partial insertion sort.
+	 *  When a partition is highly unbalanced some elements of both sides are swapped, so that the next pivots do not repeat it.
+	 *  The `leftmost` flag is false when the element preceding the range is not greater than any element in it. */
+	template <class Iterator, class Compare>
+	inline void introsort(Iterator first, Iterator last, Compare comp, unsigned int maxDepth, bool leftmost)
+	{
+		while (true)
+		{
+			const int size = distance(first, last);
+			if (size < InsertionSortThreshold)
+			{
+				insertionsort(first, last, comp);
+				return;
+			}
+			else if (maxDepth == 0)
+			{
+				heapsort(first, last, comp);
+				return;
+			}
+			maxDepth--;
+
+			selectPivot(first, last, comp);
+
+			// A pivot equal to the preceding element is the smallest value in the range, no need to sort the elements equal to it
+			if (leftmost == false && comp(*prev(first), *first) == false)
+			{
+				first = next(partitionLeft(first, last, comp));
+				continue;
+			}
+
+			bool alreadyPartitioned = false;
+			Iterator pivot = partitionRight(first, last, comp, alreadyPartitioned);
+			const int leftSize = distance(first, pivot);
+			const int rightSize = size - leftSize - 1;
+			if (leftSize < size / 8 || rightSize < size / 8)
+			{
+				breakPatterns(first, pivot);
+				breakPatterns(next(pivot), last);
+			}
+			else if (alreadyPartitioned && partialInsertionsort(first, pivot, comp) && partialInsertionsort(next(pivot), last, comp))
+				return;
+
+			introsort(first, pivot, comp, maxDepth, leftmost);
+			first = next(pivot);
+			leftmost = false;
 		}
-		*(first + j) = x;
-		i++;
 	}
+
 }
 
-/// Insertion sort implementation with iterators, ascending order
+/// Default sort implementation using introsort, with iterators and custom compare function
+template <class Iterator, class Compare>
+inline void sort(Iterator first, Iterator last, Compare comp)
+{
+	introsort(first, last, comp, introsortMaxDepth(distance(first, last)), true);
+}
+
+/// Default sort implementation using introsort with iterators, ascending order
 template <class Iterator>
-inline void insertionsort(Iterator first, Iterator last)
+inline void sort(Iterator first, Iterator last)
 {
-	insertionsort(first, last, IsLess<typename IteratorTraits<Iterator>::ValueType>);
+	introsort(first, last, IsLess<typename IteratorTraits<Iterator>::ValueType>, introsortMaxDepth(distance(first, last)), true);
 }
 
-/// Insertion sort implementation with iterators, descending order
+/// Default sort implementation using introsort with iterators, descending order
 template <class Iterator>
-inline void insertionsortDesc(Iterator first, Iterator last)
+inline void sortDesc(Iterator first, Iterator last)
 {
-	insertionsort(first, last, IsNotLess<typename IteratorTraits<Iterator>::ValueType>);
+	introsort(first, last, IsGreater<typename IteratorTraits<Iterator>::ValueType>, introsortMaxDepth(distance(first, last)), true);
+}
+
+namespace detail {
+
+	/// Merges two consecutive sorted ranges by moving the first one in a temporary buffer
+	/*! \note It is shared with the merge passes of the parallel sort, so it cannot have internal linkage */
+	template <class Iterator, class T, class Compare>
+	inline void mergeWithBuffer(Iterator first, Iterator middle, Iterator last, T *buffer, Compare comp)
+	{
+		T *bufferEnd = buffer;
+		for (Iterator it = first; it != middle; ++it, ++bufferEnd)
+			new (bufferEnd) T(nctl::move(*it));
+
+		T *left = buffer;
+		Iterator right = middle;
+		Iterator result = first;
+		while (left != bufferEnd && right != last)
+		{
+			// Elements from the left range come first when equal, to preserve their relative order
+			if (comp(*right, *left))
+			{
+				*result = nctl::move(*right);
+				++right;
+			}
+			else
+			{
+				*result = nctl::move(*left);
+				++left;
+			}
+			++result;
+		}
+
+		for (; left != bufferEnd; ++left, ++result)
+			*result = nctl::move(*left);
+
+		for (T *element = buffer; element != bufferEnd; ++element)
+			element->~T();
+	}
+
 }
 
 namespace {
 
-	/// Introspective sort implementation with iterators and custom compare function
-	template <class Iterator, class Compare>
-	inline void introsort(Iterator first, Iterator last, Compare comp, unsigned int maxDepth)
+	/// Merge sort implementation with random access iterators, custom compare function and a buffer of half the range size
+	template <class Iterator, class T, class Compare>
+	inline void mergesort(Iterator first, Iterator last, T *buffer, Compare comp)
 	{
 		const int size = distance(first, last);
-		if (size < 16)
-			insertionsort(first, last, comp);
-		else if (maxDepth == 0)
-			heapsort(first, last, comp);
-		else
+		if (size <= InsertionSortThreshold)
 		{
-			Iterator p = prev(last);
-			swap(*next(first, size / 2), *p);
-			Iterator q = partition(first, p, comp);
-			swap(*q, *p);
-			introsort(first, q, comp, maxDepth - 1);
-			introsort(next(q), last, comp, maxDepth - 1);
+			insertionsort(first, last, comp);
+			return;
 		}
+
+		Iterator middle = first + size / 2;
+		mergesort(first, middle, buffer, comp);
+		mergesort(middle, last, buffer, comp);
+
+		// The two halves do not need to be merged if they are already in order
+		if (comp(*middle, *prev(middle)))
+			detail::mergeWithBuffer(first, middle, last, buffer, comp);
 	}
 
 }
 
-/// Default sort implementation using introsort, with iterators and custom compare function
+/// Stable sort implementation using merge sort, with iterators and custom compare function
+/*! \note The compare function should be a strict ordering, like `IsLess` or `IsGreater`, for the sort to be stable */
 template <class Iterator, class Compare>
-inline void sort(Iterator first, Iterator last, Compare comp)
+inline void stableSort(Iterator first, Iterator last, Compare comp)
 {
-	const unsigned int maxDepth = log(distance(first, last)) * 2;
-	introsort(first, last, comp, maxDepth);
+	using T = typename IteratorTraits<Iterator>::ValueType;
+
+	const int size = distance(first, last);
+	if (size <= InsertionSortThreshold)
+	{
+		insertionsort(first, last, comp);
+		return;
+	}
+
+	T *buffer = static_cast<T *>(::operator new((size / 2) * sizeof(T)));
+	mergesort(first, last, buffer, comp);
+	::operator delete(buffer);
 }
 
-/// Default sort implementation using introsort with iterators, ascending order
+/// Stable sort implementation using merge sort with iterators, ascending order
 template <class Iterator>
-inline void sort(Iterator first, Iterator last)
+inline void stableSort(Iterator first, Iterator last)
 {
-	const unsigned int maxDepth = log(distance(first, last)) * 2;
-	introsort(first, last, IsLess<typename IteratorTraits<Iterator>::ValueType>, maxDepth);
+	stableSort(first, last, IsLess<typename IteratorTraits<Iterator>::ValueType>);
 }
 
-/// Default sort implementation using introsort with iterators, descending order
+/// Stable sort implementation using merge sort with iterators, descending order
 template <class Iterator>
-inline void sortDesc(Iterator first, Iterator last)
+inline void stableSortDesc(Iterator first, Iterator last)
+{
+	stableSort(first, last, IsGreater<typename IteratorTraits<Iterator>::ValueType>);
+}
+
+namespace {
+
+	/// Number of key bits sorted by each radix sort pass
+	const unsigned int RadixBits = 8;
+	/// Number of buckets for each radix sort pass
+	const unsigned int RadixBuckets = 1 << RadixBits;
+
+	/// Radix sort key function returning the element itself
+	template <class T>
+	inline T IdentityKey(const T &value)
+	{
+		return value;
+	}
+
+	/// Returns the key as an unsigned value where signed keys are ordered after flipping their sign bit
+	template <class Key>
+	inline unsigned long long radixKey(Key key)
+	{
+		const bool isSigned = static_cast<Key>(-1) < static_cast<Key>(1);
+		const unsigned long long signBit = isSigned ? (1ULL << (sizeof(Key) * 8 - 1)) : 0ULL;
+		return static_cast<unsigned long long>(key) ^ signBit;
+	}
+
+	/// Returns the bucket of a key for the specified radix sort pass
+	inline unsigned int radixBucket(unsigned long long key, unsigned int pass)
+	{
+		return static_cast<unsigned int>(key >> (pass * RadixBits)) & (RadixBuckets - 1);
+	}
+
+}
+
+/// Radix sort implementation with random access iterators and a function returning the integral key of an element
+/*! The sort is stable and it allocates a temporary buffer as large as the range.
+ *  Passes on key digits shared by all elements are skipped, so small keys in wide integer types are sorted faster. */
+template <class Iterator, class KeyFunction>
+inline void radixSort(Iterator first, Iterator last, KeyFunction keyFunc)
+{
+	using T = typename IteratorTraits<Iterator>::ValueType;
+	using Key = decltype(keyFunc(*first));
+	static_assert(isIntegral<Key>::value, "Radix sort keys should be integral types returned by value");
+	const unsigned int NumPasses = sizeof(Key) * 8 / RadixBits;
+
+	const int size = distance(first, last);
+	if (size < 2)
+		return;
+
+	unsigned int counts[NumPasses][RadixBuckets] = {};
+	for (Iterator it = first; it != last; ++it)
+	{
+		const unsigned long long key = radixKey(keyFunc(*it));
+		for (unsigned int pass = 0; pass < NumPasses; pass++)
+			counts[pass][radixBucket(key, pass)]++;
+	}
+
+	const unsigned long long firstKey = radixKey(keyFunc(*first));
+	bool skipPass[NumPasses];
+	unsigned int numActivePasses = 0;
+	for (unsigned int pass = 0; pass < NumPasses; pass++)
+	{
+		skipPass[pass] = (counts[pass][radixBucket(firstKey, pass)] == static_cast<unsigned int>(size));
+		if (skipPass[pass] == false)
+			numActivePasses++;
+	}
+	if (numActivePasses == 0)
+		return;
+
+	T *buffer = static_cast<T *>(::operator new(size * sizeof(T)));
+	bool bufferConstructed = false;
+	bool sortedInBuffer = false;
+
+	unsigned int offsets[RadixBuckets];
+	for (unsigned int pass = 0; pass < NumPasses; pass++)
+	{
+		if (skipPass[pass])
+			continue;
+
+		unsigned int offset = 0;
+		for (unsigned int i = 0; i < RadixBuckets; i++)
+		{
+			offsets[i] = offset;
+			offset += counts[pass][i];
+		}
+
+		if (sortedInBuffer == false)
+		{
+			for (Iterator it = first; it != last; ++it)
+			{
+				const unsigned int index = offsets[radixBucket(radixKey(keyFunc(*it)), pass)]++;
+				if (bufferConstructed)
+					buffer[index] = nctl::move(*it);
+				else
+					new (buffer + index) T(nctl::move(*it));
+			}
+			bufferConstructed = true;
+		}
+		else
+		{
+			for (int i = 0; i < size; i++)
+			{
+				const unsigned int index = offsets[radixBucket(radixKey(keyFunc(buffer[i])), pass)]++;
+				*(first + index) = nctl::move(buffer[i]);
+			}
+		}
+		sortedInBuffer = !sortedInBuffer;
+	}
+
+	if (sortedInBuffer)
+	{
+		for (int i = 0; i < size; i++)
+			*(first + i) = nctl::move(buffer[i]);
+	}
+
+	for (int i = 0; i < size; i++)
+		buffer[i].~T();
+	::operator delete(buffer);
+}
+
+/// Radix sort implementation with random access iterators over integral elements, ascending order
+template <class Iterator>
+inline void radixSort(Iterator first, Iterator last)
 {
-	const unsigned int maxDepth = log(distance(first, last)) * 2;
-	introsort(first, last, IsNotLess<typename IteratorTraits<Iterator>::ValueType>, maxDepth);
+	radixSort(first, last, IdentityKey<typename IteratorTraits<Iterator>::ValueType>);
 }
 
 }
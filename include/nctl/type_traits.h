@@ -160,6 +160,11 @@ struct isIntegral<char>
 	static constexpr bool value = true;
 };
 template <>
+struct isIntegral<signed char>
+{
+	static constexpr bool value = true;
+};
+template <>
 struct isIntegral<unsigned char>
 {
 	static constexpr bool value = true;
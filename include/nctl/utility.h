@@ -1,7 +1,7 @@
 #ifndef NCTL_UTILITY
 #define NCTL_UTILITY
 
-#include <cstring> // for `memcpy()`
+#include <cstring> // for `memcpy()` and `memmove()`
 #include "type_traits.h"
 
 namespace nctl {
@@ -139,7 +139,8 @@ namespace detail {
 		template <class T>
 		inline static void moveAssignArray(T *dest, T *src, unsigned int numElements)
 		{
-			memcpy(dest, src, numElements * sizeof(T));
+			// Source and destination overlap when elements are removed from an array
+			memmove(dest, src, numElements * sizeof(T));
 		}
 	};
 
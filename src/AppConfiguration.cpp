@@ -58,13 +58,19 @@ AppConfiguration::AppConfiguration()
       outputAudioFrequency(0),
       monoAudioSources(31),
       stereoAudioSources(1),
+      numStreamBuffers(3),
+      streamBufferSize(16 * 1024),
+      adaptiveStreamBuffers(false),
       withDebugOverlay(false),
       withAudio(true),
+      withSoftwareAudio(false),
       withThreads(false),
       withScenegraph(true),
       withVSync(true),
       withGlDebugContext(false),
       withConsoleColors(true),
+      withAsyncLogging(false),
+      withBinaryLogging(false),
 
       // Compile-time variables
       glCoreProfile_(true),
@@ -7,6 +7,7 @@
 #include "RenderResources.h"
 #include "RenderQueue.h"
 #include "ScreenViewport.h"
+#include "FrameCapture.h"
 #include "GLDebug.h"
 #include "Timer.h" // for `sleep()`
 #include "FrameTimer.h"
@@ -16,6 +17,7 @@
 
 #ifdef WITH_AUDIO
 	#include "ALAudioDevice.h"
+	#include "SoftwareAudioDevice.h"
 #endif
 
 #ifdef WITH_THREADS
@@ -117,7 +119,16 @@ void Application::initCommon()
 	theServiceLocator().registerIndexer(nctl::makeUnique<ArrayIndexer>());
 #ifdef WITH_AUDIO
 	if (appCfg_.withAudio)
-		theServiceLocator().registerAudioDevice(nctl::makeUnique<ALAudioDevice>(appCfg_));
+	{
+		if (appCfg_.withSoftwareAudio == false && ALAudioDevice::isAvailable())
+			theServiceLocator().registerAudioDevice(nctl::makeUnique<ALAudioDevice>(appCfg_));
+		else
+		{
+			if (appCfg_.withSoftwareAudio == false)
+				LOGW("No OpenAL device can be opened, audio is mixed in software");
+			theServiceLocator().registerAudioDevice(nctl::makeUnique<SoftwareAudioDevice>(appCfg_));
+		}
+	}
 #endif
 #ifdef WITH_THREADS
 	if (appCfg_.withThreads)
@@ -140,6 +151,7 @@ void Application::initCommon()
 	TracyGpuCollect;
 
 	frameTimer_ = nctl::makeUnique<FrameTimer>(appCfg_.profileTextUpdateTime(), appCfg_.frameTimerLogInterval);
+	frameCapture_ = nctl::makeUnique<FrameCapture>();
 
 	// Create a minimal set of render resources before compiling the first shader
 	RenderResources::createMinimal(); // they are required for rendering even without a scenegraph
@@ -332,6 +344,9 @@ void Application::step()
 	if (debugOverlay_)
 		debugOverlay_->updateFrameTimings();
 
+	// Captures are issued after the frame end callback, where they are usually requested
+	frameCapture_->onFrameEnd();
+
 	gfxDevice_->update();
 	FrameMark;
 	TracyGpuCollect;
@@ -365,6 +380,8 @@ void Application::shutdownCommon()
 	RenderDocCapture::removeHooks();
 #endif
 
+	// Waits for pending read backs and encodings while the OpenGL context and the thread pool still exist
+	frameCapture_.reset(nullptr);
 	debugOverlay_.reset(nullptr);
 	rootNode_.reset(nullptr);
 	RenderResources::dispose();
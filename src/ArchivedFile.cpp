@@ -0,0 +1,131 @@
+#include <cstring> // for memcpy()
+#include "common_macros.h"
+#include "ArchivedFile.h"
+#include "AssetArchive.h"
+
+namespace ncine {
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+ArchivedFile::ArchivedFile(const char *filename, const AssetArchive &archive, unsigned int entryIndex)
+    : IFile(filename), archive_(archive), entryIndex_(entryIndex), bufferPtr_(nullptr), seekOffset_(0)
+{
+	ASSERT(entryIndex < archive.numEntries());
+	type_ = FileType::MEMORY;
+	fileSize_ = static_cast<unsigned long int>(archive.entry(entryIndex).size);
+}
+
+ArchivedFile::~ArchivedFile()
+{
+	if (shouldCloseOnDestruction_)
+		close();
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void ArchivedFile::open(unsigned char mode)
+{
+	// Checking if the file is already opened
+	if (fileDescriptor_ >= 0)
+	{
+		LOGW_X("File \"%s\" is already opened", filename_.data());
+		return;
+	}
+
+	if (mode & OpenMode::WRITE)
+	{
+		LOGE_X("Cannot open the archived file \"%s\" for writing", filename_.data());
+		return;
+	}
+
+	bufferPtr_ = archive_.entryData(entryIndex_);
+	if (bufferPtr_ == nullptr)
+	{
+		ownedBuffer_ = nctl::makeUnique<unsigned char[]>(fileSize_);
+		if (archive_.readEntry(entryIndex_, ownedBuffer_.get()) == false)
+		{
+			LOGE_X("Cannot read the archived file \"%s\" from \"%s\"", filename_.data(), archive_.filename());
+			ownedBuffer_.reset(nullptr);
+			return;
+		}
+		bufferPtr_ = ownedBuffer_.get();
+	}
+
+	fileDescriptor_ = 0;
+	seekOffset_ = 0;
+	LOGI_X("File \"%s\" opened from archive \"%s\"", filename_.data(), archive_.filename());
+}
+
+void ArchivedFile::close()
+{
+	fileDescriptor_ = -1;
+	seekOffset_ = 0;
+	bufferPtr_ = nullptr;
+	ownedBuffer_.reset(nullptr);
+}
+
+long int ArchivedFile::seek(long int offset, int whence) const
+{
+	long int seekValue = -1;
+
+	if (fileDescriptor_ >= 0)
+	{
+		switch (whence)
+		{
+			case SEEK_SET:
+				seekValue = offset;
+				break;
+			case SEEK_CUR:
+				seekValue = seekOffset_ + offset;
+				break;
+			case SEEK_END:
+				seekValue = fileSize_ + offset;
+				break;
+		}
+	}
+
+	if (seekValue < 0 || seekValue > static_cast<long int>(fileSize_))
+		seekValue = -1;
+	else
+		seekOffset_ = seekValue;
+
+	return seekValue;
+}
+
+long int ArchivedFile::tell() const
+{
+	long int tellValue = -1;
+
+	if (fileDescriptor_ >= 0)
+		tellValue = seekOffset_;
+
+	return tellValue;
+}
+
+unsigned long int ArchivedFile::read(void *buffer, unsigned long int bytes) const
+{
+	ASSERT(buffer);
+
+	unsigned long int bytesRead = 0;
+
+	if (fileDescriptor_ >= 0)
+	{
+		bytesRead = (seekOffset_ + bytes > fileSize_) ? fileSize_ - seekOffset_ : bytes;
+		memcpy(buffer, bufferPtr_ + seekOffset_, bytesRead);
+		seekOffset_ += bytesRead;
+	}
+
+	return bytesRead;
+}
+
+unsigned long int ArchivedFile::write(const void *buffer, unsigned long int bytes)
+{
+	LOGW_X("Cannot write to the archived file \"%s\"", filename_.data());
+	return 0;
+}
+
+}
@@ -0,0 +1,443 @@
+#include <cstring> // for memcpy()
+#include "common_macros.h"
+#include "AssetArchive.h"
+#include "IFile.h"
+
+namespace ncine {
+
+namespace {
+
+	/// Number of bits of the match finder hash table
+	const unsigned int HashBits = 12;
+	/// Minimum length of a match
+	const unsigned long int MinMatch = 4;
+	/// The last bytes of a block are always literals
+	const unsigned long int LastLiterals = 5;
+	/// The last match must start at least this number of bytes before the end of a block
+	const unsigned long int MatchStartLimit = 12;
+	/// Maximum distance of a match from the current position
+	const unsigned long int MaxOffset = 65535;
+
+	inline uint32_t read32(const unsigned char *ptr)
+	{
+		uint32_t value;
+		memcpy(&value, ptr, sizeof(uint32_t));
+		return value;
+	}
+
+	inline unsigned int hashSequence(uint32_t sequence)
+	{
+		return (sequence * 2654435761U) >> (32 - HashBits);
+	}
+
+	/// Writes the extra bytes of a length that does not fit the token nibble
+	bool writeLength(unsigned char *&dest, const unsigned char *destEnd, unsigned long int length)
+	{
+		while (length >= 255)
+		{
+			if (dest >= destEnd)
+				return false;
+			*dest++ = 255;
+			length -= 255;
+		}
+		if (dest >= destEnd)
+			return false;
+		*dest++ = static_cast<unsigned char>(length);
+		return true;
+	}
+
+	/// Writes a sequence made of literals and an optional match
+	bool writeSequence(unsigned char *&dest, const unsigned char *destEnd, const unsigned char *literals, unsigned long int numLiterals,
+	                   unsigned long int offset, unsigned long int matchLength)
+	{
+		if (dest >= destEnd)
+			return false;
+
+		unsigned char *token = dest++;
+		*token = static_cast<unsigned char>((numLiterals < 15 ? numLiterals : 15) << 4);
+		if (numLiterals >= 15 && writeLength(dest, destEnd, numLiterals - 15) == false)
+			return false;
+
+		if (static_cast<unsigned long int>(destEnd - dest) < numLiterals)
+			return false;
+		memcpy(dest, literals, numLiterals);
+		dest += numLiterals;
+
+		// The last sequence of a block has no match
+		if (matchLength == 0)
+			return true;
+
+		if (destEnd - dest < 2)
+			return false;
+		*dest++ = static_cast<unsigned char>(offset & 0xFF);
+		*dest++ = static_cast<unsigned char>(offset >> 8);
+
+		const unsigned long int length = matchLength - MinMatch;
+		*token |= static_cast<unsigned char>(length < 15 ? length : 15);
+		if (length >= 15 && writeLength(dest, destEnd, length - 15) == false)
+			return false;
+
+		return true;
+	}
+
+	/// Reads the extra bytes of a length that does not fit the token nibble
+	bool readLength(const unsigned char *&src, const unsigned char *srcEnd, unsigned long int &length)
+	{
+		unsigned char value = 255;
+		while (value == 255)
+		{
+			if (src >= srcEnd)
+				return false;
+			value = *src++;
+			length += value;
+		}
+		return true;
+	}
+
+	/// Returns true if a range is inside the file, without overflowing on values read from it
+	inline bool isInsideFile(uint64_t offset, uint64_t size, uint64_t fileSize)
+	{
+		return (size <= fileSize && offset <= fileSize - size);
+	}
+
+	const unsigned int HeaderSize = 40;
+	const unsigned int EntrySize = 40;
+
+}
+
+const char AssetArchive::Magic[4] = { 'N', 'P', 'A', 'K' };
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+AssetArchive::AssetArchive(const char *filename)
+    : filename_(filename), isOpened_(false), namesSize_(0)
+{
+	static_assert(sizeof(Header) == HeaderSize, "The archive header has padding");
+	static_assert(sizeof(Entry) == EntrySize, "The archive entry has padding");
+
+	nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(filename);
+	fileHandle->open(IFile::OpenMode::READ | IFile::OpenMode::BINARY);
+	if (fileHandle->isOpened() == false)
+		return;
+
+	isOpened_ = loadIndex(*fileHandle);
+	if (isOpened_ == false)
+		return;
+
+	// The handle of a mapped archive is kept to access the entry data without copies
+	if (fileHandle->bufferPtr() != nullptr)
+		fileHandle_ = nctl::move(fileHandle);
+	else
+		fileHandle->close();
+
+	LOGI_X("Archive \"%s\" opened with %u entries%s", filename, entries_.size(), isMapped() ? " (mapped)" : "");
+}
+
+AssetArchive::~AssetArchive() = default;
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool AssetArchive::isMapped() const
+{
+	return (fileHandle_ != nullptr);
+}
+
+int AssetArchive::findEntry(const char *path) const
+{
+	ASSERT(path);
+	const unsigned int length = static_cast<unsigned int>(strlen(path));
+	const uint64_t pathHash = hashPath(path, length);
+
+	// Binary search for the first entry with the hash
+	unsigned int first = 0;
+	unsigned int last = entries_.size();
+	while (first < last)
+	{
+		const unsigned int middle = first + (last - first) / 2;
+		if (entries_[middle].pathHash < pathHash)
+			first = middle + 1;
+		else
+			last = middle;
+	}
+
+	// Paths are compared to resolve hash collisions
+	for (unsigned int i = first; i < entries_.size() && entries_[i].pathHash == pathHash; i++)
+	{
+		if (entries_[i].nameLength != length)
+			continue;
+
+		const char *name = entryPath(i);
+		unsigned int j = 0;
+		for (; j < length; j++)
+		{
+			const char pathChar = (path[j] == '\\') ? '/' : path[j];
+			if (pathChar != name[j])
+				break;
+		}
+		if (j == length)
+			return static_cast<int>(i);
+	}
+
+	return -1;
+}
+
+const char *AssetArchive::entryPath(unsigned int index) const
+{
+	return names_.get() + entries_[index].nameOffset;
+}
+
+const unsigned char *AssetArchive::entryData(unsigned int index) const
+{
+	const Entry &e = entries_[index];
+	if (fileHandle_ == nullptr || e.compressedSize > 0)
+		return nullptr;
+
+	return static_cast<const unsigned char *>(fileHandle_->bufferPtr()) + e.dataOffset;
+}
+
+bool AssetArchive::readEntry(unsigned int index, unsigned char *buffer) const
+{
+	ASSERT(buffer);
+	const Entry &e = entries_[index];
+	const unsigned long int size = static_cast<unsigned long int>(e.size);
+	const unsigned long int compressedSize = static_cast<unsigned long int>(e.compressedSize);
+
+	if (compressedSize == 0)
+	{
+		if (fileHandle_ != nullptr)
+		{
+			memcpy(buffer, entryData(index), size);
+			return true;
+		}
+		return readRaw(static_cast<unsigned long int>(e.dataOffset), buffer, size);
+	}
+
+	const unsigned char *compressedData = nullptr;
+	nctl::UniquePtr<unsigned char[]> compressedBuffer;
+	if (fileHandle_ != nullptr)
+		compressedData = static_cast<const unsigned char *>(fileHandle_->bufferPtr()) + e.dataOffset;
+	else
+	{
+		compressedBuffer = nctl::makeUnique<unsigned char[]>(compressedSize);
+		if (readRaw(static_cast<unsigned long int>(e.dataOffset), compressedBuffer.get(), compressedSize) == false)
+			return false;
+		compressedData = compressedBuffer.get();
+	}
+
+	const unsigned long int decompressedSize = decompressBlock(compressedData, compressedSize, buffer, size);
+	if (decompressedSize != size)
+	{
+		LOGW_X("Cannot decompress entry \"%.*s\" of archive \"%s\"", static_cast<int>(e.nameLength), entryPath(index), filename_.data());
+		return false;
+	}
+
+	return true;
+}
+
+/*! \note The hash is a 64 bits FNV-1a */
+uint64_t AssetArchive::hashPath(const char *path, unsigned int length)
+{
+	uint64_t hash = 0xCBF29CE484222325ULL;
+	for (unsigned int i = 0; i < length; i++)
+	{
+		const char pathChar = (path[i] == '\\') ? '/' : path[i];
+		hash ^= static_cast<unsigned char>(pathChar);
+		hash *= 0x100000001B3ULL;
+	}
+	return hash;
+}
+
+unsigned long int AssetArchive::compressBound(unsigned long int srcSize)
+{
+	return srcSize + srcSize / 255 + 16;
+}
+
+/*! \note The compressor is a greedy single pass with a small hash table, it favors speed over ratio */
+unsigned long int AssetArchive::compressBlock(const unsigned char *src, unsigned long int srcSize, unsigned char *dest, unsigned long int destCapacity)
+{
+	ASSERT(src);
+	ASSERT(dest);
+
+	uint32_t hashTable[1 << HashBits];
+	memset(hashTable, 0, sizeof(hashTable));
+
+	unsigned char *destPtr = dest;
+	const unsigned char *destEnd = dest + destCapacity;
+	unsigned long int anchor = 0;
+	unsigned long int position = 0;
+
+	if (srcSize > MatchStartLimit)
+	{
+		const unsigned long int matchStartEnd = srcSize - MatchStartLimit;
+		const unsigned long int matchEnd = srcSize - LastLiterals;
+		while (position < matchStartEnd)
+		{
+			const uint32_t sequence = read32(src + position);
+			const unsigned int hash = hashSequence(sequence);
+			const unsigned long int candidate = hashTable[hash];
+			hashTable[hash] = static_cast<uint32_t>(position);
+
+			if (candidate >= position || position - candidate > MaxOffset || read32(src + candidate) != sequence)
+			{
+				position++;
+				continue;
+			}
+
+			unsigned long int matchLength = MinMatch;
+			while (position + matchLength < matchEnd && src[candidate + matchLength] == src[position + matchLength])
+				matchLength++;
+
+			if (writeSequence(destPtr, destEnd, src + anchor, position - anchor, position - candidate, matchLength) == false)
+				return 0;
+
+			position += matchLength;
+			anchor = position;
+		}
+	}
+
+	if (writeSequence(destPtr, destEnd, src + anchor, srcSize - anchor, 0, 0) == false)
+		return 0;
+
+	return static_cast<unsigned long int>(destPtr - dest);
+}
+
+/*! \note Every read and write is checked against the buffer bounds, a malformed block cannot overflow them */
+unsigned long int AssetArchive::decompressBlock(const unsigned char *src, unsigned long int srcSize, unsigned char *dest, unsigned long int destSize)
+{
+	ASSERT(src);
+	ASSERT(dest);
+
+	const unsigned char *srcPtr = src;
+	const unsigned char *srcEnd = src + srcSize;
+	unsigned char *destPtr = dest;
+	const unsigned char *destEnd = dest + destSize;
+
+	while (srcPtr < srcEnd)
+	{
+		const unsigned char token = *srcPtr++;
+
+		unsigned long int numLiterals = token >> 4;
+		if (numLiterals == 15 && readLength(srcPtr, srcEnd, numLiterals) == false)
+			return 0;
+		if (static_cast<unsigned long int>(srcEnd - srcPtr) < numLiterals ||
+		    static_cast<unsigned long int>(destEnd - destPtr) < numLiterals)
+			return 0;
+		memcpy(destPtr, srcPtr, numLiterals);
+		srcPtr += numLiterals;
+		destPtr += numLiterals;
+
+		// The last sequence has only literals
+		if (srcPtr == srcEnd)
+			break;
+
+		if (srcEnd - srcPtr < 2)
+			return 0;
+		const unsigned long int offset = srcPtr[0] | (srcPtr[1] << 8);
+		srcPtr += 2;
+		if (offset == 0 || offset > static_cast<unsigned long int>(destPtr - dest))
+			return 0;
+
+		unsigned long int matchLength = token & 0x0F;
+		if (matchLength == 15 && readLength(srcPtr, srcEnd, matchLength) == false)
+			return 0;
+		matchLength += MinMatch;
+		if (static_cast<unsigned long int>(destEnd - destPtr) < matchLength)
+			return 0;
+
+		// The match can overlap the bytes being written
+		const unsigned char *matchPtr = destPtr - offset;
+		for (unsigned long int i = 0; i < matchLength; i++)
+			destPtr[i] = matchPtr[i];
+		destPtr += matchLength;
+	}
+
+	return static_cast<unsigned long int>(destPtr - dest);
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool AssetArchive::loadIndex(IFile &fileHandle)
+{
+	const unsigned long int fileSize = fileHandle.size();
+
+	Header header;
+	if (fileHandle.read(&header, HeaderSize) != HeaderSize || memcmp(header.magic, Magic, sizeof(Magic)) != 0)
+	{
+		LOGE_X("File \"%s\" is not an asset archive", filename_.data());
+		return false;
+	}
+
+	header.version = IFile::int32FromLE(header.version);
+	header.numEntries = IFile::int32FromLE(header.numEntries);
+	header.indexOffset = IFile::int64FromLE(header.indexOffset);
+	header.namesOffset = IFile::int64FromLE(header.namesOffset);
+	header.namesSize = IFile::int64FromLE(header.namesSize);
+
+	if (header.version != Version)
+	{
+		LOGE_X("Archive \"%s\" has an unsupported version: %u", filename_.data(), header.version);
+		return false;
+	}
+
+	const uint64_t indexSize = static_cast<uint64_t>(header.numEntries) * EntrySize;
+	if (isInsideFile(header.indexOffset, indexSize, fileSize) == false || isInsideFile(header.namesOffset, header.namesSize, fileSize) == false)
+	{
+		LOGE_X("Archive \"%s\" is truncated", filename_.data());
+		return false;
+	}
+
+	entries_.setSize(header.numEntries);
+	fileHandle.seek(static_cast<long int>(header.indexOffset), SEEK_SET);
+	if (header.numEntries > 0 && fileHandle.read(entries_.data(), static_cast<unsigned long int>(indexSize)) != indexSize)
+		return false;
+
+	namesSize_ = static_cast<unsigned long int>(header.namesSize);
+	names_ = nctl::makeUnique<char[]>(namesSize_ + 1);
+	fileHandle.seek(static_cast<long int>(header.namesOffset), SEEK_SET);
+	if (fileHandle.read(names_.get(), namesSize_) != namesSize_)
+		return false;
+	names_[namesSize_] = '\0';
+
+	for (unsigned int i = 0; i < entries_.size(); i++)
+	{
+		Entry &e = entries_[i];
+		e.pathHash = IFile::int64FromLE(e.pathHash);
+		e.dataOffset = IFile::int64FromLE(e.dataOffset);
+		e.size = IFile::int64FromLE(e.size);
+		e.compressedSize = IFile::int64FromLE(e.compressedSize);
+		e.nameOffset = IFile::int32FromLE(e.nameOffset);
+		e.nameLength = IFile::int32FromLE(e.nameLength);
+
+		const uint64_t storedSize = (e.compressedSize > 0) ? e.compressedSize : e.size;
+		const bool isSorted = (i == 0 || entries_[i - 1].pathHash <= e.pathHash);
+		if (isSorted == false || e.size == 0 || isInsideFile(e.dataOffset, storedSize, fileSize) == false ||
+		    static_cast<uint64_t>(e.nameOffset) + e.nameLength > namesSize_)
+		{
+			LOGE_X("Archive \"%s\" has an invalid entry at index %u", filename_.data(), i);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool AssetArchive::readRaw(unsigned long int offset, unsigned char *buffer, unsigned long int size) const
+{
+	nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(filename_.data());
+	fileHandle->open(IFile::OpenMode::READ | IFile::OpenMode::BINARY);
+	if (fileHandle->isOpened() == false)
+		return false;
+
+	if (fileHandle->seek(static_cast<long int>(offset), SEEK_SET) < 0)
+		return false;
+
+	return (fileHandle->read(buffer, size) == size);
+}
+
+}
@@ -0,0 +1,672 @@
+#include "common_macros.h"
+#include <nctl/SharedPtr.h>
+#include "AssetPreloader.h"
+#include "IFile.h"
+#include "FileReadRequest.h"
+#include "ITextureLoader.h"
+#include "Texture.h"
+#include "Font.h"
+#include "FntParser.h"
+#include "AudioBuffer.h"
+#include "ServiceLocator.h"
+#include "IThreadPool.h"
+#include "TimeStamp.h"
+#include "Timer.h" // for `sleep()`
+#include "tracy.h"
+
+#ifdef WITH_AUDIO
+	#include "IAudioLoader.h"
+	#include "Hash64.h"
+#endif
+
+namespace ncine {
+
+/// An asset of the manifest with its intermediate loading data
+struct AssetPreloader::Asset
+{
+	/// The loading stages, in order
+	enum Stage
+	{
+		QUEUED = 0,
+		READING,
+		READ,
+		DECODING,
+		DECODED,
+		LOADED,
+		FAILED,
+		RETRIEVED
+	};
+
+	/// A file of the asset and its content
+	struct FileData
+	{
+		FileData()
+		    : data(nullptr), size(0) {}
+
+		nctl::String filename;
+		nctl::UniquePtr<IFile> fileHandle;
+		/// The buffer for the content of files that are not already in memory
+		nctl::UniquePtr<unsigned char[]> buffer;
+		/// Points either to the buffer or to the memory of the file
+		const unsigned char *data;
+		unsigned long int size;
+		nctl::SharedPtr<FileReadRequest> request;
+	};
+
+	Asset(AssetType assetType, const char *assetName)
+	    : type(assetType), name(assetName), numFiles(1), hasDecoded(false),
+	      introspection(Shader::Introspection::ENABLED), contentHash(0), samplesSize(0) {}
+
+	AssetType type;
+	nctl::String name;
+	/// The second file is a shader fragment source or the texture referenced by a font
+	FileData files[2];
+	/// Number of files read by the I/O stage
+	unsigned int numFiles;
+	/// Written by the decoding jobs and read by the main thread
+	mutable nctl::Atomic32 stage;
+	/// Only valid when the asset has reached the decoded stage
+	bool hasDecoded;
+
+	nctl::UniquePtr<Texture> texture;
+	nctl::UniquePtr<ITextureLoader> texLoader;
+	nctl::UniquePtr<Font> font;
+	nctl::UniquePtr<FntParser> fntParser;
+	nctl::UniquePtr<Shader> shader;
+	Shader::Introspection introspection;
+#ifdef WITH_AUDIO
+	nctl::UniquePtr<AudioBuffer> audioBuffer;
+#endif
+	/// Content hash of an audio file, zero if the audio buffer cache is disabled
+	uint64_t contentHash;
+	nctl::UniquePtr<unsigned char[]> samples;
+	unsigned long int samplesSize;
+
+	inline Stage currentStage() const { return static_cast<Stage>(stage.load(nctl::Atomic32::MemoryModel::ACQUIRE)); }
+	inline void setStage(Stage newStage) { stage.store(newStage, nctl::Atomic32::MemoryModel::RELEASE); }
+};
+
+/// A command to decode an asset on a worker thread
+/*! The job counter is decremented on destruction, also when the thread pool drops the command without executing it. */
+class AssetPreloader::DecodeCommand : public IThreadCommand
+{
+  public:
+	DecodeCommand(AssetPreloader &preloader, Asset &asset)
+	    : preloader_(preloader), asset_(asset) {}
+
+	// Decremented last, as the main thread waits for it before releasing the assets
+	~DecodeCommand() override { preloader_.numDecodeJobs_.fetchSub(1); }
+
+	void execute() override
+	{
+		// A canceled asset is left as it was, to be released by the main thread
+		if (preloader_.isCanceled_.load(nctl::Atomic32::MemoryModel::ACQUIRE) == 0)
+			decode(asset_);
+	}
+
+  private:
+	AssetPreloader &preloader_;
+	Asset &asset_;
+};
+
+namespace {
+
+	/// Reads a whole file on the calling thread, without copying it if it is already in memory
+	bool readWholeFile(const char *filename, nctl::UniquePtr<IFile> &fileHandle, nctl::UniquePtr<unsigned char[]> &buffer,
+	                   const unsigned char *&data, unsigned long int &size)
+	{
+		fileHandle = IFile::createFileHandle(filename);
+		fileHandle->open(IFile::OpenMode::READ);
+		if (fileHandle->isOpened() == false)
+			return false;
+
+		size = fileHandle->size();
+		data = static_cast<const unsigned char *>(fileHandle->bufferPtr());
+		if (data == nullptr)
+		{
+			buffer = nctl::makeUnique<unsigned char[]>(size);
+			if (fileHandle->read(buffer.get(), size) != size)
+				return false;
+			data = buffer.get();
+		}
+		return true;
+	}
+
+	/// Fraction of the loading of an asset that is completed when it reaches a stage
+	const float StageProgress[] = { 0.0f, 0.05f, 0.25f, 0.25f, 0.75f, 1.0f, 1.0f, 1.0f };
+
+}
+
+const float AssetPreloader::DefaultUpdateBudget = 4.0f;
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+AssetPreloader::AssetPreloader()
+    : state_(State::IDLE), updateBudget_(DefaultUpdateBudget), numLoaded_(0),
+      numFailed_(0), numReadsInFlight_(0), maxDecodeJobs_(0)
+{
+}
+
+AssetPreloader::~AssetPreloader()
+{
+	cancel();
+	waitForJobs();
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+/*! \note The texture object is created immediately, with the default load options */
+int AssetPreloader::addTexture(const char *filename)
+{
+	const int index = addAsset(AssetType::TEXTURE, filename);
+	if (index >= 0)
+	{
+		Asset &asset = *assets_[index];
+		asset.files[0].filename = filename;
+		asset.texture = nctl::makeUnique<Texture>();
+	}
+	return index;
+}
+
+int AssetPreloader::addAudioBuffer(const char *filename)
+{
+#ifdef WITH_AUDIO
+	const int index = addAsset(AssetType::AUDIOBUFFER, filename);
+	if (index >= 0)
+	{
+		Asset &asset = *assets_[index];
+		asset.files[0].filename = filename;
+		asset.audioBuffer = nctl::makeUnique<AudioBuffer>();
+	}
+	return index;
+#else
+	LOGW_X("Audio is disabled, \"%s\" cannot be added", filename);
+	return -1;
+#endif
+}
+
+/*! \note The texture file name is read from the `FNT` file when it is decoded */
+int AssetPreloader::addFont(const char *fntFilename)
+{
+	const int index = addAsset(AssetType::FONT, fntFilename);
+	if (index >= 0)
+	{
+		Asset &asset = *assets_[index];
+		asset.files[0].filename = fntFilename;
+		asset.font = nctl::makeUnique<Font>();
+		asset.texture = nctl::makeUnique<Texture>();
+	}
+	return index;
+}
+
+int AssetPreloader::addShader(const char *shaderName, Shader::Introspection introspection, const char *vertexFilename, const char *fragmentFilename)
+{
+	const int index = addAsset(AssetType::SHADER, shaderName);
+	if (index >= 0)
+	{
+		Asset &asset = *assets_[index];
+		asset.files[0].filename = vertexFilename;
+		asset.files[1].filename = fragmentFilename;
+		asset.numFiles = 2;
+		asset.introspection = introspection;
+		asset.shader = nctl::makeUnique<Shader>();
+	}
+	return index;
+}
+
+/*! \note Decoding jobs are limited to the number of worker threads. Texture loaders can split their own work with
+ *  `parallelFor()`, where the calling thread takes part, so no worker needs to be held back for them.
+ *  Without workers the assets are decoded by `update()`. */
+bool AssetPreloader::start()
+{
+	if (state_ != State::IDLE)
+		return false;
+
+	const unsigned int numThreads = theServiceLocator().threadPool().numThreads();
+	maxDecodeJobs_ = numThreads;
+	state_ = (assets_.isEmpty() == false) ? State::LOADING : State::COMPLETED;
+	return true;
+}
+
+bool AssetPreloader::update()
+{
+	if (state_ != State::LOADING)
+		return true;
+
+	ZoneScoped;
+	const TimeStamp startTime = TimeStamp::now();
+	issueReads();
+
+	// At least one asset is decoded or uploaded at each update, whatever the budget
+	bool hasSpentBudget = false;
+	for (unsigned int i = 0; i < assets_.size(); i++)
+	{
+		Asset &asset = *assets_[i];
+		// An asset can advance through more than one stage in the same update
+		if (asset.currentStage() == Asset::READING && checkReads(asset))
+		{
+			numReadsInFlight_--;
+#ifdef WITH_AUDIO
+			// Cached samples are shared without being decoded again
+			if (asset.currentStage() == Asset::READING && asset.type == AssetType::AUDIOBUFFER && AudioBuffer::isCacheEnabled())
+			{
+				asset.contentHash = hash64().hashBuffer(asset.files[0].data, asset.files[0].size);
+				if (asset.audioBuffer->acquireCached(asset.contentHash))
+				{
+					asset.audioBuffer->setName(asset.name.data());
+					releaseData(asset);
+					asset.setStage(Asset::LOADED);
+					numLoaded_++;
+				}
+			}
+#endif
+			if (asset.currentStage() == Asset::READING)
+				asset.setStage(Asset::READ);
+		}
+
+		if (asset.currentStage() == Asset::READ)
+		{
+			if (maxDecodeJobs_ > 0)
+			{
+				if (static_cast<unsigned int>(numDecodeJobs_.load()) < maxDecodeJobs_)
+				{
+					asset.setStage(Asset::DECODING);
+					numDecodeJobs_.fetchAdd(1);
+					theServiceLocator().threadPool().enqueueCommand(nctl::makeUnique<DecodeCommand>(*this, asset));
+				}
+			}
+			else if (hasSpentBudget == false)
+			{
+				decode(asset);
+				hasSpentBudget = (startTime.millisecondsSince() >= updateBudget_);
+			}
+		}
+
+		if (asset.currentStage() == Asset::DECODED)
+		{
+			if (asset.hasDecoded == false)
+				fail(asset);
+			else if (hasSpentBudget == false)
+			{
+				upload(asset);
+				hasSpentBudget = (startTime.millisecondsSince() >= updateBudget_);
+			}
+		}
+	}
+
+	if (numLoaded_ + numFailed_ == assets_.size())
+		state_ = State::COMPLETED;
+
+	return (state_ != State::LOADING);
+}
+
+/*! \note The assets that have already been loaded can still be retrieved */
+void AssetPreloader::cancel()
+{
+	if (state_ != State::LOADING)
+		return;
+
+	state_ = State::CANCELED;
+	isCanceled_.store(1, nctl::Atomic32::MemoryModel::RELEASE);
+
+	for (unsigned int i = 0; i < assets_.size(); i++)
+	{
+		Asset &asset = *assets_[i];
+		for (unsigned int j = 0; j < asset.numFiles; j++)
+		{
+			if (asset.files[j].request != nullptr)
+				asset.files[j].request->cancel();
+		}
+	}
+}
+
+float AssetPreloader::progress() const
+{
+	if (assets_.isEmpty())
+		return (state_ == State::IDLE) ? 0.0f : 1.0f;
+
+	float progress = 0.0f;
+	for (unsigned int i = 0; i < assets_.size(); i++)
+		progress += StageProgress[assets_[i]->currentStage()];
+	return progress / assets_.size();
+}
+
+AssetPreloader::AssetType AssetPreloader::assetType(unsigned int index) const
+{
+	ASSERT(index < assets_.size());
+	return assets_[index]->type;
+}
+
+const char *AssetPreloader::assetName(unsigned int index) const
+{
+	ASSERT(index < assets_.size());
+	return assets_[index]->name.data();
+}
+
+AssetPreloader::AssetState AssetPreloader::assetState(unsigned int index) const
+{
+	ASSERT(index < assets_.size());
+	switch (assets_[index]->currentStage())
+	{
+		case Asset::LOADED: return AssetState::LOADED;
+		case Asset::FAILED: return AssetState::FAILED;
+		case Asset::RETRIEVED: return AssetState::RETRIEVED;
+		default: return AssetState::PENDING;
+	}
+}
+
+nctl::UniquePtr<Texture> AssetPreloader::retrieveTexture(unsigned int index)
+{
+	if (index >= assets_.size() || assets_[index]->type != AssetType::TEXTURE || assets_[index]->currentStage() != Asset::LOADED)
+		return nctl::UniquePtr<Texture>(nullptr);
+
+	assets_[index]->setStage(Asset::RETRIEVED);
+	return nctl::move(assets_[index]->texture);
+}
+
+nctl::UniquePtr<AudioBuffer> AssetPreloader::retrieveAudioBuffer(unsigned int index)
+{
+#ifdef WITH_AUDIO
+	if (index >= assets_.size() || assets_[index]->type != AssetType::AUDIOBUFFER || assets_[index]->currentStage() != Asset::LOADED)
+		return nctl::UniquePtr<AudioBuffer>(nullptr);
+
+	assets_[index]->setStage(Asset::RETRIEVED);
+	return nctl::move(assets_[index]->audioBuffer);
+#else
+	return nctl::UniquePtr<AudioBuffer>(nullptr);
+#endif
+}
+
+nctl::UniquePtr<Font> AssetPreloader::retrieveFont(unsigned int index)
+{
+	if (index >= assets_.size() || assets_[index]->type != AssetType::FONT || assets_[index]->currentStage() != Asset::LOADED)
+		return nctl::UniquePtr<Font>(nullptr);
+
+	assets_[index]->setStage(Asset::RETRIEVED);
+	return nctl::move(assets_[index]->font);
+}
+
+nctl::UniquePtr<Shader> AssetPreloader::retrieveShader(unsigned int index)
+{
+	if (index >= assets_.size() || assets_[index]->type != AssetType::SHADER || assets_[index]->currentStage() != Asset::LOADED)
+		return nctl::UniquePtr<Shader>(nullptr);
+
+	assets_[index]->setStage(Asset::RETRIEVED);
+	return nctl::move(assets_[index]->shader);
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+int AssetPreloader::addAsset(AssetType type, const char *name)
+{
+	ASSERT(name);
+	if (state_ != State::IDLE)
+	{
+		LOGW_X("Cannot add \"%s\" to a manifest that has already been started", name);
+		return -1;
+	}
+
+	assets_.pushBack(nctl::makeUnique<Asset>(type, name));
+	return static_cast<int>(assets_.size() - 1);
+}
+
+void AssetPreloader::issueReads()
+{
+	for (unsigned int i = 0; i < assets_.size() && numReadsInFlight_ < MaxReadsInFlight; i++)
+	{
+		Asset &asset = *assets_[i];
+		if (asset.currentStage() != Asset::QUEUED)
+			continue;
+
+		bool readsIssued = true;
+		for (unsigned int j = 0; j < asset.numFiles && readsIssued; j++)
+			readsIssued = issueRead(asset, j);
+
+		asset.setStage(Asset::READING);
+		numReadsInFlight_++;
+		if (readsIssued == false)
+		{
+			// The asset fails when its reads are checked, after the ones that could not be canceled have finished
+			for (unsigned int j = 0; j < asset.numFiles; j++)
+			{
+				if (asset.files[j].request != nullptr)
+					asset.files[j].request->cancel();
+			}
+		}
+	}
+}
+
+/*! \note Shader sources are always copied, as they need a null terminator */
+bool AssetPreloader::issueRead(Asset &asset, unsigned int fileIndex)
+{
+	Asset::FileData &file = asset.files[fileIndex];
+	file.fileHandle = IFile::createFileHandle(file.filename.data());
+	file.fileHandle->open(IFile::OpenMode::READ);
+	if (file.fileHandle->isOpened() == false)
+	{
+		LOGW_X("Cannot open \"%s\" for preloading", file.filename.data());
+		return false;
+	}
+
+	file.size = file.fileHandle->size();
+	file.data = static_cast<const unsigned char *>(file.fileHandle->bufferPtr());
+	const bool needsTerminator = (asset.type == AssetType::SHADER);
+	if (file.data == nullptr || needsTerminator)
+	{
+		file.buffer = nctl::makeUnique<unsigned char[]>(needsTerminator ? file.size + 1 : file.size);
+		if (needsTerminator)
+			file.buffer[file.size] = '\0';
+		file.data = file.buffer.get();
+		file.request = file.fileHandle->readAsync(0, file.buffer.get(), file.size);
+	}
+
+	return true;
+}
+
+bool AssetPreloader::checkReads(Asset &asset)
+{
+	for (unsigned int i = 0; i < asset.numFiles; i++)
+	{
+		const Asset::FileData &file = asset.files[i];
+		if (file.request != nullptr && file.request->isDone() == false)
+			return false;
+	}
+
+	bool succeeded = true;
+	for (unsigned int i = 0; i < asset.numFiles; i++)
+	{
+		Asset::FileData &file = asset.files[i];
+		if (file.data == nullptr)
+			succeeded = false;
+		else if (file.request != nullptr)
+		{
+			if (file.request->state() != FileReadRequest::State::COMPLETED || file.request->bytesRead() != file.size)
+			{
+				LOGW_X("Cannot read all the %lu bytes of \"%s\"", file.size, file.filename.data());
+				succeeded = false;
+			}
+			file.request.reset(nullptr);
+		}
+	}
+
+	if (succeeded == false)
+		fail(asset);
+
+	return true;
+}
+
+void AssetPreloader::decode(Asset &asset)
+{
+	ZoneScoped;
+	ZoneText(asset.name.data(), asset.name.length());
+
+	bool succeeded = false;
+	switch (asset.type)
+	{
+		case AssetType::TEXTURE:
+		{
+			const Asset::FileData &file = asset.files[0];
+			asset.texLoader = ITextureLoader::createFromMemory(file.filename.data(), file.data, file.size);
+			if (asset.texLoader->hasLoaded())
+			{
+				asset.texture->processPixels(*asset.texLoader);
+				succeeded = true;
+			}
+			break;
+		}
+		case AssetType::AUDIOBUFFER:
+		{
+#ifdef WITH_AUDIO
+			const Asset::FileData &file = asset.files[0];
+			nctl::UniquePtr<IAudioLoader> audioLoader = IAudioLoader::createFromMemory(file.filename.data(), file.data, file.size);
+			if (audioLoader->hasLoaded())
+				succeeded = asset.audioBuffer->decode(*audioLoader, asset.samples, asset.samplesSize);
+#endif
+			break;
+		}
+		case AssetType::FONT:
+		{
+			const Asset::FileData &fntFile = asset.files[0];
+			asset.fntParser = nctl::makeUnique<FntParser>(reinterpret_cast<const char *>(fntFile.data), fntFile.size);
+			if (asset.fntParser->numCharTags() == 0)
+				break;
+
+			// The texture file name is only known after parsing, it is read by the decoding job itself
+			Asset::FileData &texFile = asset.files[1];
+			texFile.filename = Font::textureFilename(fntFile.filename.data(), *asset.fntParser);
+			if (readWholeFile(texFile.filename.data(), texFile.fileHandle, texFile.buffer, texFile.data, texFile.size) == false)
+			{
+				LOGW_X("Cannot read the font texture \"%s\"", texFile.filename.data());
+				break;
+			}
+
+			asset.texLoader = ITextureLoader::createFromMemory(texFile.filename.data(), texFile.data, texFile.size);
+			if (asset.texLoader->hasLoaded())
+			{
+				asset.texture->processPixels(*asset.texLoader);
+				succeeded = true;
+			}
+			break;
+		}
+		case AssetType::SHADER:
+			// Shader sources are compiled by the driver on the main thread
+			succeeded = true;
+			break;
+	}
+
+	asset.hasDecoded = succeeded;
+	asset.setStage(Asset::DECODED);
+}
+
+void AssetPreloader::upload(Asset &asset)
+{
+	ZoneScoped;
+	ZoneText(asset.name.data(), asset.name.length());
+
+	bool succeeded = false;
+	switch (asset.type)
+	{
+		case AssetType::TEXTURE:
+		{
+			asset.texture->upload(asset.name.data(), *asset.texLoader);
+			succeeded = true;
+			break;
+		}
+		case AssetType::AUDIOBUFFER:
+		{
+#ifdef WITH_AUDIO
+			// Another asset of the manifest with the same content might have been cached in the meantime
+			if (asset.contentHash != 0 && asset.audioBuffer->acquireCached(asset.contentHash))
+				succeeded = true;
+			else
+				succeeded = asset.audioBuffer->loadDecoded(asset.contentHash, asset.samples.get(), asset.samplesSize);
+			if (succeeded)
+				asset.audioBuffer->setName(asset.name.data());
+#endif
+			break;
+		}
+		case AssetType::FONT:
+		{
+			asset.texture->upload(asset.files[1].filename.data(), *asset.texLoader);
+			succeeded = asset.font->loadFromParser(asset.name.data(), *asset.fntParser, nctl::move(asset.texture));
+			break;
+		}
+		case AssetType::SHADER:
+		{
+			const char *vertex = reinterpret_cast<const char *>(asset.files[0].data);
+			const char *fragment = reinterpret_cast<const char *>(asset.files[1].data);
+			succeeded = asset.shader->loadFromMemory(asset.name.data(), asset.introspection, vertex, fragment);
+			break;
+		}
+	}
+
+	if (succeeded == false)
+	{
+		fail(asset);
+		return;
+	}
+
+	releaseData(asset);
+	asset.setStage(Asset::LOADED);
+	numLoaded_++;
+}
+
+void AssetPreloader::fail(Asset &asset)
+{
+	LOGW_X("Asset \"%s\" cannot be preloaded", asset.name.data());
+	releaseData(asset);
+
+	asset.texture.reset(nullptr);
+	asset.font.reset(nullptr);
+	asset.shader.reset(nullptr);
+#ifdef WITH_AUDIO
+	asset.audioBuffer.reset(nullptr);
+#endif
+
+	asset.setStage(Asset::FAILED);
+	numFailed_++;
+}
+
+void AssetPreloader::releaseData(Asset &asset)
+{
+	for (unsigned int i = 0; i < 2; i++)
+	{
+		Asset::FileData &file = asset.files[i];
+		file.request.reset(nullptr);
+		file.buffer.reset(nullptr);
+		file.fileHandle.reset(nullptr);
+		file.data = nullptr;
+		file.size = 0;
+	}
+
+	asset.texLoader.reset(nullptr);
+	asset.fntParser.reset(nullptr);
+	asset.samples.reset(nullptr);
+	asset.samplesSize = 0;
+}
+
+void AssetPreloader::waitForJobs()
+{
+	// The requests that could not be canceled are being read by the I/O thread
+	for (unsigned int i = 0; i < assets_.size(); i++)
+	{
+		Asset &asset = *assets_[i];
+		for (unsigned int j = 0; j < asset.numFiles; j++)
+		{
+			if (asset.files[j].request != nullptr)
+				asset.files[j].request->wait();
+		}
+	}
+
+	// Every decoding job decrements the counter when its command is destroyed, after executing or when dropped by the pool
+	while (numDecodeJobs_.load() != 0)
+		Timer::sleep(1);
+}
+
+}
@@ -0,0 +1,552 @@
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+#include "BinaryLog.h"
+
+namespace ncine {
+
+namespace {
+
+	/// The types of the values stored in a record
+	enum class ValueType : uint8_t
+	{
+		INT32 = 1,
+		INT64,
+		DOUBLE,
+		STRING,
+		POINTER
+	};
+
+	/// Maximum length of a stored string argument when it is formatted
+	const unsigned int MaxStringLength = 1024;
+	/// The text appended when the stored arguments do not match the format string
+	const char InvalidArgsText[] = "<invalid arguments>";
+
+	/// A conversion specification of a format string
+	struct Spec
+	{
+		/// Position of the `%` character
+		unsigned int start;
+		/// Position of the length modifier, which can be empty
+		unsigned int modifierStart;
+		unsigned int modifierLength;
+		/// Number of `*` width and precision arguments preceding the value
+		unsigned int numStars;
+		char conversion;
+		bool hasValue;
+		BinaryLog::ArgType argType;
+	};
+
+	void storeLE16(unsigned char *buffer, uint16_t value)
+	{
+		buffer[0] = static_cast<unsigned char>(value);
+		buffer[1] = static_cast<unsigned char>(value >> 8);
+	}
+
+	void storeLE32(unsigned char *buffer, uint32_t value)
+	{
+		for (unsigned int i = 0; i < 4; i++)
+			buffer[i] = static_cast<unsigned char>(value >> (i * 8));
+	}
+
+	void storeLE64(unsigned char *buffer, uint64_t value)
+	{
+		for (unsigned int i = 0; i < 8; i++)
+			buffer[i] = static_cast<unsigned char>(value >> (i * 8));
+	}
+
+	uint16_t loadLE16(const unsigned char *buffer)
+	{
+		return static_cast<uint16_t>(buffer[0] | (buffer[1] << 8));
+	}
+
+	uint32_t loadLE32(const unsigned char *buffer)
+	{
+		uint32_t value = 0;
+		for (unsigned int i = 0; i < 4; i++)
+			value |= static_cast<uint32_t>(buffer[i]) << (i * 8);
+		return value;
+	}
+
+	uint64_t loadLE64(const unsigned char *buffer)
+	{
+		uint64_t value = 0;
+		for (unsigned int i = 0; i < 8; i++)
+			value |= static_cast<uint64_t>(buffer[i]) << (i * 8);
+		return value;
+	}
+
+	bool isIntegerConversion(char conversion)
+	{
+		return (conversion != '\0' && strchr("diouxXc", conversion) != nullptr);
+	}
+
+	bool isFloatConversion(char conversion)
+	{
+		return (conversion != '\0' && strchr("fFeEgGaA", conversion) != nullptr);
+	}
+
+	BinaryLog::ArgType integerArgType(const char *modifier, unsigned int modifierLength)
+	{
+		if (modifierLength == 2 && modifier[0] == 'l')
+			return BinaryLog::ArgType::LONG_LONG;
+		else if (modifierLength == 1)
+		{
+			switch (modifier[0])
+			{
+				case 'l': return BinaryLog::ArgType::LONG;
+				case 'q': return BinaryLog::ArgType::LONG_LONG;
+				case 'j': return BinaryLog::ArgType::INTMAX;
+				case 'z': return BinaryLog::ArgType::SIZE;
+				case 't': return BinaryLog::ArgType::PTRDIFF;
+				default: break;
+			}
+		}
+		// Character and short arguments are promoted to `int`
+		return BinaryLog::ArgType::INT;
+	}
+
+	/// Parses the conversion specification at the specified position, returns false if it is not supported
+	bool parseSpec(const char *format, unsigned int &pos, Spec &spec)
+	{
+		spec.start = pos++;
+		spec.numStars = 0;
+
+		while (format[pos] != '\0' && strchr("-+ #0'", format[pos]) != nullptr)
+			pos++;
+
+		if (format[pos] == '*')
+		{
+			spec.numStars++;
+			pos++;
+		}
+		else
+		{
+			while (format[pos] >= '0' && format[pos] <= '9')
+				pos++;
+		}
+
+		if (format[pos] == '.')
+		{
+			pos++;
+			if (format[pos] == '*')
+			{
+				spec.numStars++;
+				pos++;
+			}
+			else
+			{
+				while (format[pos] >= '0' && format[pos] <= '9')
+					pos++;
+			}
+		}
+
+		spec.modifierStart = pos;
+		while (format[pos] != '\0' && strchr("hlqjztL", format[pos]) != nullptr)
+			pos++;
+		spec.modifierLength = pos - spec.modifierStart;
+		if (spec.modifierLength > 2)
+			return false;
+
+		spec.conversion = format[pos];
+		if (spec.conversion == '\0')
+			return false;
+		pos++;
+
+		const char *modifier = format + spec.modifierStart;
+		spec.hasValue = true;
+		if (spec.conversion == 'c')
+			spec.argType = BinaryLog::ArgType::INT;
+		else if (isIntegerConversion(spec.conversion))
+			spec.argType = integerArgType(modifier, spec.modifierLength);
+		else if (isFloatConversion(spec.conversion))
+			spec.argType = (spec.modifierLength == 1 && modifier[0] == 'L') ? BinaryLog::ArgType::LONG_DOUBLE : BinaryLog::ArgType::DOUBLE;
+		else if (spec.conversion == 's' && spec.modifierLength == 0)
+			spec.argType = BinaryLog::ArgType::STRING;
+		else if (spec.conversion == 'p')
+			spec.argType = BinaryLog::ArgType::POINTER;
+		else if (spec.conversion == 'n')
+		{
+			spec.argType = BinaryLog::ArgType::WRITE_BACK;
+			spec.hasValue = false;
+		}
+		else
+			return false; // wide strings and positional arguments are not supported
+
+		return true;
+	}
+
+	/// Writes a type byte followed by a 32 or 64 bits little endian value
+	bool writeValue(unsigned char *buffer, unsigned int size, unsigned int &offset, ValueType type, uint64_t value, unsigned int valueSize)
+	{
+		if (offset + 1 + valueSize > size)
+			return false;
+
+		buffer[offset] = static_cast<uint8_t>(type);
+		if (valueSize == sizeof(uint32_t))
+			storeLE32(buffer + offset + 1, static_cast<uint32_t>(value));
+		else
+			storeLE64(buffer + offset + 1, value);
+		offset += 1 + valueSize;
+		return true;
+	}
+
+	bool writeDouble(unsigned char *buffer, unsigned int size, unsigned int &offset, double value)
+	{
+		uint64_t bits = 0;
+		memcpy(&bits, &value, sizeof(double));
+		return writeValue(buffer, size, offset, ValueType::DOUBLE, bits, sizeof(uint64_t));
+	}
+
+	template <class T>
+	bool writeInteger(unsigned char *buffer, unsigned int size, unsigned int &offset, T value)
+	{
+		if (sizeof(T) <= sizeof(int32_t))
+		{
+			const uint32_t value32 = static_cast<uint32_t>(static_cast<int32_t>(value));
+			return writeValue(buffer, size, offset, ValueType::INT32, value32, sizeof(int32_t));
+		}
+		const uint64_t value64 = static_cast<uint64_t>(static_cast<int64_t>(value));
+		return writeValue(buffer, size, offset, ValueType::INT64, value64, sizeof(int64_t));
+	}
+
+	bool writeString(unsigned char *buffer, unsigned int size, unsigned int &offset, const char *string)
+	{
+		if (string == nullptr)
+			string = "(null)";
+
+		if (offset + 1 + sizeof(uint16_t) > size)
+			return false;
+
+		const unsigned int maxLength = size - offset - 1 - sizeof(uint16_t);
+		const size_t stringLength = strlen(string);
+		const uint16_t length = static_cast<uint16_t>(stringLength < maxLength ? stringLength : maxLength);
+		buffer[offset] = static_cast<uint8_t>(ValueType::STRING);
+		storeLE16(buffer + offset + 1, length);
+		memcpy(buffer + offset + 1 + sizeof(uint16_t), string, length);
+		offset += 1 + sizeof(uint16_t) + length;
+		return true;
+	}
+
+	/// A value read back from a record
+	struct Value
+	{
+		ValueType type;
+		union
+		{
+			int32_t int32;
+			int64_t int64;
+			double float64;
+			uint64_t pointer;
+		};
+		const char *string;
+		uint16_t stringLength;
+	};
+
+	bool readValue(const unsigned char *args, unsigned int argsSize, unsigned int &offset, Value &value)
+	{
+		if (offset >= argsSize)
+			return false;
+
+		value.type = static_cast<ValueType>(args[offset]);
+		unsigned int valueSize = 0;
+		switch (value.type)
+		{
+			case ValueType::INT32: valueSize = sizeof(int32_t); break;
+			case ValueType::INT64: valueSize = sizeof(int64_t); break;
+			case ValueType::DOUBLE: valueSize = sizeof(double); break;
+			case ValueType::POINTER: valueSize = sizeof(uint64_t); break;
+			case ValueType::STRING: valueSize = sizeof(uint16_t); break;
+			default: return false;
+		}
+		if (offset + 1 + valueSize > argsSize)
+			return false;
+
+		const unsigned char *data = args + offset + 1;
+		offset += 1 + valueSize;
+		switch (value.type)
+		{
+			case ValueType::INT32: value.int32 = static_cast<int32_t>(loadLE32(data)); break;
+			case ValueType::INT64: value.int64 = static_cast<int64_t>(loadLE64(data)); break;
+			case ValueType::DOUBLE:
+			{
+				const uint64_t bits = loadLE64(data);
+				memcpy(&value.float64, &bits, sizeof(double));
+				break;
+			}
+			case ValueType::POINTER: value.pointer = loadLE64(data); break;
+			case ValueType::STRING:
+				value.stringLength = loadLE16(data);
+				if (offset + value.stringLength > argsSize)
+					return false;
+				value.string = reinterpret_cast<const char *>(args + offset);
+				offset += value.stringLength;
+				break;
+		}
+		return true;
+	}
+
+	template <class T>
+	int formatValue(char *buffer, unsigned int size, const char *spec, const int *stars, unsigned int numStars, T value)
+	{
+		if (numStars == 0)
+			return snprintf(buffer, size, spec, value);
+		else if (numStars == 1)
+			return snprintf(buffer, size, spec, stars[0], value);
+		else
+			return snprintf(buffer, size, spec, stars[0], stars[1], value);
+	}
+
+	/// Returns true if the type of a stored value can be formatted with the conversion of the specification
+	bool isCompatible(const Spec &spec, ValueType type)
+	{
+		switch (type)
+		{
+			case ValueType::INT32:
+			case ValueType::INT64: return isIntegerConversion(spec.conversion);
+			case ValueType::DOUBLE: return isFloatConversion(spec.conversion);
+			case ValueType::STRING: return (spec.conversion == 's');
+			case ValueType::POINTER: return (spec.conversion == 'p');
+		}
+		return false;
+	}
+
+	void appendText(char *buffer, unsigned int size, unsigned int &length, const char *text, unsigned int textLength)
+	{
+		const unsigned int maxLength = size - length - 1;
+		if (textLength > maxLength)
+			textLength = maxLength;
+		memcpy(buffer + length, text, textLength);
+		length += textLength;
+		buffer[length] = '\0';
+	}
+
+}
+
+///////////////////////////////////////////////////////////
+// STATIC DEFINITIONS
+///////////////////////////////////////////////////////////
+
+const char BinaryLog::Magic[8] = { 'N', 'C', 'B', 'I', 'N', 'L', 'O', 'G' };
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+int BinaryLog::parseFormat(const char *format, ArgType *argTypes, unsigned int maxArgs)
+{
+	unsigned int numArgs = 0;
+	unsigned int pos = 0;
+	while (format[pos] != '\0')
+	{
+		if (format[pos] != '%')
+		{
+			pos++;
+			continue;
+		}
+		if (format[pos + 1] == '%')
+		{
+			pos += 2;
+			continue;
+		}
+
+		Spec spec;
+		if (parseSpec(format, pos, spec) == false || numArgs + spec.numStars + 1 > maxArgs)
+			return -1;
+
+		for (unsigned int i = 0; i < spec.numStars; i++)
+			argTypes[numArgs++] = ArgType::INT;
+		argTypes[numArgs++] = spec.argType;
+	}
+
+	return static_cast<int>(numArgs);
+}
+
+unsigned int BinaryLog::encodeArgs(unsigned char *buffer, unsigned int size, const ArgType *argTypes, unsigned int numArgs, va_list args)
+{
+	unsigned int offset = 0;
+	bool hasSpace = true;
+	for (unsigned int i = 0; i < numArgs && hasSpace; i++)
+	{
+		switch (argTypes[i])
+		{
+			case ArgType::INT: hasSpace = writeInteger(buffer, size, offset, va_arg(args, int)); break;
+			case ArgType::LONG: hasSpace = writeInteger(buffer, size, offset, va_arg(args, long)); break;
+			case ArgType::LONG_LONG: hasSpace = writeInteger(buffer, size, offset, va_arg(args, long long)); break;
+			case ArgType::INTMAX: hasSpace = writeInteger(buffer, size, offset, va_arg(args, intmax_t)); break;
+			case ArgType::SIZE: hasSpace = writeInteger(buffer, size, offset, va_arg(args, size_t)); break;
+			case ArgType::PTRDIFF: hasSpace = writeInteger(buffer, size, offset, va_arg(args, ptrdiff_t)); break;
+			case ArgType::DOUBLE:
+			{
+				hasSpace = writeDouble(buffer, size, offset, va_arg(args, double));
+				break;
+			}
+			case ArgType::LONG_DOUBLE:
+			{
+				hasSpace = writeDouble(buffer, size, offset, static_cast<double>(va_arg(args, long double)));
+				break;
+			}
+			case ArgType::STRING: hasSpace = writeString(buffer, size, offset, va_arg(args, const char *)); break;
+			case ArgType::POINTER:
+			{
+				const uint64_t value = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(va_arg(args, void *)));
+				hasSpace = writeValue(buffer, size, offset, ValueType::POINTER, value, sizeof(uint64_t));
+				break;
+			}
+			case ArgType::WRITE_BACK: va_arg(args, void *); break;
+		}
+	}
+
+	return offset;
+}
+
+unsigned int BinaryLog::encodeString(unsigned char *buffer, unsigned int size, const char *string)
+{
+	unsigned int offset = 0;
+	writeString(buffer, size, offset, string);
+	return offset;
+}
+
+unsigned int BinaryLog::formatArgs(char *buffer, unsigned int size, const char *format, const unsigned char *args, unsigned int argsSize)
+{
+	if (size == 0)
+		return 0;
+
+	buffer[0] = '\0';
+	unsigned int length = 0;
+	unsigned int offset = 0;
+	unsigned int pos = 0;
+	while (format[pos] != '\0' && length < size - 1)
+	{
+		// Copying the text up to the next conversion specification
+		const char *percent = strchr(format + pos, '%');
+		const unsigned int textEnd = percent ? static_cast<unsigned int>(percent - format) : pos + static_cast<unsigned int>(strlen(format + pos));
+		appendText(buffer, size, length, format + pos, textEnd - pos);
+		pos = textEnd;
+		if (format[pos] == '\0')
+			break;
+
+		if (format[pos + 1] == '%')
+		{
+			appendText(buffer, size, length, "%", 1);
+			pos += 2;
+			continue;
+		}
+
+		Spec spec;
+		int stars[2] = { 0, 0 };
+		Value value;
+		bool isValid = parseSpec(format, pos, spec);
+		for (unsigned int i = 0; i < spec.numStars && isValid; i++)
+		{
+			isValid = readValue(args, argsSize, offset, value) && value.type == ValueType::INT32;
+			stars[i] = value.int32;
+		}
+		if (isValid && spec.hasValue)
+			isValid = readValue(args, argsSize, offset, value) && isCompatible(spec, value.type);
+
+		if (isValid == false)
+		{
+			appendText(buffer, size, length, InvalidArgsText, sizeof(InvalidArgsText) - 1);
+			break;
+		}
+		if (spec.hasValue == false)
+			continue;
+
+		// Rebuilding the specification with a length modifier that matches the stored value
+		char specString[32];
+		unsigned int specLength = spec.modifierStart - spec.start;
+		if (specLength > sizeof(specString) - 4)
+			specLength = sizeof(specString) - 4;
+		memcpy(specString, format + spec.start, specLength);
+		if (value.type == ValueType::INT64)
+		{
+			specString[specLength++] = 'l';
+			specString[specLength++] = 'l';
+		}
+		else if (value.type == ValueType::INT32 && format[spec.modifierStart] == 'h')
+		{
+			// Keeping the `h` and `hh` modifiers, as they change how a promoted value is printed
+			for (unsigned int i = 0; i < spec.modifierLength; i++)
+				specString[specLength++] = 'h';
+		}
+		specString[specLength++] = spec.conversion;
+		specString[specLength] = '\0';
+
+		int result = 0;
+		char *dest = buffer + length;
+		const unsigned int destSize = size - length;
+		switch (value.type)
+		{
+			case ValueType::INT32: result = formatValue(dest, destSize, specString, stars, spec.numStars, value.int32); break;
+			case ValueType::INT64: result = formatValue(dest, destSize, specString, stars, spec.numStars, static_cast<long long>(value.int64)); break;
+			case ValueType::DOUBLE: result = formatValue(dest, destSize, specString, stars, spec.numStars, value.float64); break;
+			case ValueType::POINTER:
+				result = formatValue(dest, destSize, specString, stars, spec.numStars, reinterpret_cast<void *>(static_cast<uintptr_t>(value.pointer)));
+				break;
+			case ValueType::STRING:
+			{
+				char string[MaxStringLength];
+				const unsigned int stringLength = (value.stringLength < MaxStringLength) ? value.stringLength : MaxStringLength - 1;
+				memcpy(string, value.string, stringLength);
+				string[stringLength] = '\0';
+				result = formatValue(dest, destSize, specString, stars, spec.numStars, static_cast<const char *>(string));
+				break;
+			}
+		}
+
+		if (result > 0)
+			length += (static_cast<unsigned int>(result) < destSize) ? static_cast<unsigned int>(result) : destSize - 1;
+	}
+
+	return length;
+}
+
+unsigned int BinaryLog::writeHeader(unsigned char *buffer, uint32_t flags)
+{
+	memcpy(buffer, Magic, sizeof(Magic));
+	storeLE32(buffer + 8, Version);
+	storeLE32(buffer + 12, flags);
+	return HeaderSize;
+}
+
+void BinaryLog::readHeader(const unsigned char *buffer, Header &header)
+{
+	memcpy(header.magic, buffer, sizeof(header.magic));
+	header.version = loadLE32(buffer + 8);
+	header.flags = loadLE32(buffer + 12);
+}
+
+unsigned int BinaryLog::writeFormatRecord(unsigned char *buffer, uint32_t formatId, uint16_t formatLength)
+{
+	buffer[0] = static_cast<uint8_t>(RecordType::FORMAT);
+	storeLE32(buffer + 1, formatId);
+	storeLE16(buffer + 5, formatLength);
+	return FormatRecordSize;
+}
+
+unsigned int BinaryLog::writeEntryRecord(unsigned char *buffer, uint8_t level, uint32_t formatId, time_t time, uint16_t argsSize)
+{
+	buffer[0] = static_cast<uint8_t>(RecordType::ENTRY);
+	buffer[1] = level;
+	storeLE32(buffer + 2, formatId);
+	storeLE64(buffer + 6, static_cast<uint64_t>(static_cast<int64_t>(time)));
+	storeLE16(buffer + 14, argsSize);
+	return EntryRecordSize;
+}
+
+void BinaryLog::readFormatRecord(const unsigned char *buffer, uint32_t &formatId, uint16_t &formatLength)
+{
+	formatId = loadLE32(buffer);
+	formatLength = loadLE16(buffer + 4);
+}
+
+void BinaryLog::readEntryRecord(const unsigned char *buffer, Entry &entry)
+{
+	entry.level = buffer[0];
+	entry.formatId = loadLE32(buffer + 1);
+	entry.time = static_cast<int64_t>(loadLE64(buffer + 5));
+	entry.argsSize = loadLE16(buffer + 13);
+}
+
+}
@@ -6,11 +6,13 @@
 #endif
 
 #include <ctime>
+#include <cstring> // for `memcpy()`
 #include "FileLogger.h"
 #include "common_macros.h"
 #include <nctl/algorithms.h>
 #include <nctl/CString.h>
 #include "Application.h"
+#include "TimeStamp.h"
 #include "tracy.h"
 
 namespace {
@@ -24,6 +26,9 @@ const char *BrightGreen = "\033[92m";
 const char *BrightYellow = "\033[93m";
 const char *BrightRedBg = "\033[101m";
 
+/// The format of the messages that could not be deferred and have been formatted by the caller
+const char *FallbackFormat = "%s";
+
 }
 
 namespace ncine {
@@ -45,11 +50,17 @@ FileLogger::FileLogger(LogLevel consoleLevel)
 }
 
 FileLogger::FileLogger(LogLevel consoleLevel, LogLevel fileLevel, const char *filename)
-    : consoleLevel_(LogLevel::OFF), fileLevel_(fileLevel), canUseColors_(true)
+    : consoleLevel_(LogLevel::OFF), fileLevel_(fileLevel), canUseColors_(true), isBinary_(false)
 #ifdef WITH_IMGUI
       ,
       logString_(LogStringCapacity)
+	#ifdef WITH_THREADS
+      ,
+      pendingLogString_(LogStringCapacity)
+	#endif
 #endif
+      ,
+      fallbackFormatId_(-1)
 {
 	// The setter will create the console on Windows, if needed
 	setConsoleLevel(consoleLevel);
@@ -63,6 +74,7 @@ FileLogger::FileLogger(LogLevel consoleLevel, LogLevel fileLevel, const char *fi
 FileLogger::~FileLogger()
 {
 	write(LogLevel::VERBOSE, "FileLogger::~FileLogger -> End of the log");
+	setAsync(false);
 
 	// The setter will destroy the console on Windows, if needed
 	setConsoleLevel(LogLevel::OFF);
@@ -103,8 +115,15 @@ bool FileLogger::openLogFile(const char *filename)
 	if (fileLevel_ == LogLevel::OFF || filename == nullptr)
 		return false;
 
+	// The writer thread should not use the file handle while it is replaced
+	const bool wasAsync = isAsync();
+	setAsync(false);
+
 	fileHandle_ = IFile::createFileHandle(filename);
-	fileHandle_->open(IFile::OpenMode::WRITE);
+	fileHandle_->open(isBinary_ ? (IFile::OpenMode::WRITE | IFile::OpenMode::BINARY) : IFile::OpenMode::WRITE);
+	if (isBinary_ && fileHandle_->isOpened())
+		writeBinaryHeader();
+	setAsync(wasAsync);
 
 	if (fileHandle_->isOpened() == false)
 	{
@@ -123,7 +142,167 @@ bool FileLogger::openLogFile(const char *filename)
 	return true;
 }
 
+bool FileLogger::isEnabled(LogLevel level) const
+{
+	if (consoleLevel_ == LogLevel::OFF && fileLevel_ == LogLevel::OFF)
+		return false;
+
+	const int levelInt = static_cast<int>(level);
+#if defined(WITH_IMGUI) || defined(WITH_TRACY)
+	// Entries are also recorded in the log string or sent to the profiler
+	return (levelInt >= static_cast<int>(consoleLevel_) || levelInt >= static_cast<int>(fileLevel_));
+#else
+	return ((consoleLevel_ != LogLevel::OFF && levelInt >= static_cast<int>(consoleLevel_)) ||
+	        (fileLevel_ != LogLevel::OFF && levelInt >= static_cast<int>(fileLevel_)));
+#endif
+}
+
 unsigned int FileLogger::write(LogLevel level, const char *fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	const unsigned int length = writeArgs(level, false, fmt, args);
+	va_end(args);
+	return length;
+}
+
+unsigned int FileLogger::writeStatic(LogLevel level, const char *fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	const unsigned int length = writeArgs(level, true, fmt, args);
+	va_end(args);
+	return length;
+}
+
+bool FileLogger::isAsync() const
+{
+#ifdef WITH_THREADS
+	return (isAsync_.load() != 0);
+#else
+	return false;
+#endif
+}
+
+/*! \note The ring is never freed, as other threads might still be pushing entries when the mode is disabled */
+bool FileLogger::setAsync(bool enabled)
+{
+#ifdef WITH_THREADS
+	if (enabled == isAsync())
+		return true;
+
+	if (enabled)
+	{
+		if (asyncQueue_ == nullptr)
+		{
+			createFormats();
+			asyncQueue_ = nctl::makeUnique<AsyncEntry[]>(AsyncQueueSize);
+			for (unsigned int i = 0; i < AsyncQueueSize; i++)
+				asyncQueue_[i].sequence.store(static_cast<int32_t>(i), nctl::Atomic32::MemoryModel::RELAXED);
+			enqueuePos_.store(0);
+			dequeuePos_.store(0);
+		}
+		shouldQuit_.store(0);
+
+		writerThread_.run(writerFunction, this);
+		writerThread_.setName("Logger");
+		isAsync_.store(1, nctl::Atomic32::MemoryModel::RELEASE);
+	}
+	else
+	{
+		isAsync_.store(0);
+		// The writer thread writes all the remaining entries before exiting
+		shouldQuit_.store(1);
+		wakeWriter();
+		writerThread_.join();
+		// Entries pushed by callers that checked the mode just before it changed are written by this thread
+		processEntries();
+	}
+
+	return true;
+#else
+	return (enabled == false);
+#endif
+}
+
+/*! \note It should be called before opening the log file */
+bool FileLogger::setBinary(bool enabled)
+{
+	if (fileHandle_ != nullptr && fileHandle_->isOpened())
+		return (enabled == isBinary_);
+
+	if (enabled)
+		createFormats();
+	isBinary_ = enabled;
+	return true;
+}
+
+void FileLogger::flush()
+{
+#ifdef WITH_THREADS
+	if (isAsync())
+	{
+		const int32_t lastPos = enqueuePos_.load();
+		wakeWriter();
+		while (static_cast<int32_t>(static_cast<uint32_t>(dequeuePos_.load()) - static_cast<uint32_t>(lastPos)) < 0)
+			Thread::yieldExecution();
+	}
+#endif
+
+	if (fileHandle_ != nullptr && fileHandle_->isOpened())
+		fflush(fileHandle_->ptr());
+}
+
+#ifdef WITH_IMGUI
+const char *FileLogger::logString() const
+{
+	#ifdef WITH_THREADS
+	logStringMutex_.lock();
+	if (pendingLogString_.isEmpty() == false)
+	{
+		if (pendingLogString_.length() > logString_.capacity() - logString_.length() - 1)
+			logString_.clear();
+		logString_.append(pendingLogString_);
+		pendingLogString_.clear();
+	}
+	logStringMutex_.unlock();
+	#endif
+
+	return logString_.data();
+}
+
+void FileLogger::clearLogString()
+{
+	#ifdef WITH_THREADS
+	logStringMutex_.lock();
+	pendingLogString_.clear();
+	logStringMutex_.unlock();
+	#endif
+	logString_.clear();
+}
+
+unsigned int FileLogger::logStringLength() const
+{
+	// Moving the pending entries to the log string before measuring it
+	logString();
+	return logString_.length();
+}
+#endif
+
+unsigned int FileLogger::numDroppedEntries() const
+{
+#ifdef WITH_THREADS
+	return static_cast<unsigned int>(numDropped_.load());
+#else
+	return 0;
+#endif
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+unsigned int FileLogger::writeArgs(LogLevel level, bool isStaticFormat, const char *fmt, va_list args)
 {
 	// Early-out if logging is completely disabled
 	if (consoleLevel_ == LogLevel::OFF && fileLevel_ == LogLevel::OFF)
@@ -132,31 +311,192 @@ unsigned int FileLogger::write(LogLevel level, const char *fmt, ...)
 	ASSERT(fmt);
 
 	const int levelInt = static_cast<int>(level);
-	const int consoleLevelInt = static_cast<int>(consoleLevel_);
-	const int fileLevelInt = static_cast<int>(fileLevel_);
+	const bool toConsole = (consoleLevel_ != LogLevel::OFF && levelInt >= static_cast<int>(consoleLevel_));
+	const bool toFile = (fileLevel_ != LogLevel::OFF && levelInt >= static_cast<int>(fileLevel_) &&
+	                     fileHandle_ != nullptr && fileHandle_->isOpened());
 
-	time_t now;
-	struct tm *ts;
-	now = time(nullptr);
-	ts = localtime(&now);
+#ifdef WITH_THREADS
+	if (isAsync_.load(nctl::Atomic32::MemoryModel::ACQUIRE) != 0)
+		return pushEntry(level, toConsole, toFile, isStaticFormat, fmt, args);
+#endif
+
+	if (isBinary_)
+	{
+		unsigned char argsBuffer[MaxEntryLength];
+		unsigned int argsSize = 0;
+		const int formatId = encodeArgs(isStaticFormat, fmt, argsBuffer, argsSize, args);
+
+		writeRecord(level, time(nullptr), toConsole, toFile, formatId, argsBuffer, argsSize);
+		// Binary entries are flushed only when they might be the last ones
+		if (toFile && (level == LogLevel::ERROR || level == LogLevel::FATAL))
+			fflush(fileHandle_->ptr());
+
+		return argsSize;
+	}
 
 	logEntry_[0] = '\0';
 	logEntry_[MaxEntryLength - 1] = '\0';
-	unsigned int length = 0;
 
-	const unsigned int timeMsgStart = length;
-	const unsigned int timeMsgLength = strftime(logEntry_ + length, MaxEntryLength - length - 1, "- %H:%M:%S ", ts);
-	length += timeMsgLength;
-
-	length += snprintf(logEntry_ + length, MaxEntryLength - length - 1, "[L%d] - ", levelInt);
+	unsigned int timeMsgLength = 0;
+	unsigned int length = writePrefix(level, time(nullptr), timeMsgLength);
 
 	const unsigned int logMsgStart = length;
-	va_list args;
-	va_start(args, fmt);
 	const unsigned int logMsgLength = vsnprintf(logEntry_ + length, MaxEntryLength - length - 1, fmt, args);
-	va_end(args);
 	length += logMsgLength;
 
+	output(level, toConsole, toFile, length, timeMsgLength, logMsgStart, logMsgLength);
+	if (toFile)
+		fflush(fileHandle_->ptr());
+
+	return length;
+}
+
+bool FileLogger::needsText(bool toConsole, bool toFile) const
+{
+#if defined(WITH_IMGUI) || defined(WITH_TRACY)
+	return true;
+#else
+	return (toConsole || (toFile && isBinary_ == false));
+#endif
+}
+
+void FileLogger::createFormats()
+{
+	if (formats_ != nullptr)
+		return;
+
+	formats_ = nctl::makeUnique<InternedFormat[]>(MaxInternedFormats);
+	fallbackFormatId_ = internFormat(FallbackFormat);
+}
+
+int FileLogger::internFormat(const char *fmt)
+{
+	const int64_t key = static_cast<int64_t>(reinterpret_cast<uintptr_t>(fmt));
+	// Fibonacci hashing of the address, without the low bits that are often the same
+	const uint32_t hash = static_cast<uint32_t>((static_cast<uint64_t>(key) >> 2) * 0x9E3779B97F4A7C15ULL >> 32);
+
+	for (unsigned int i = 0; i < MaxInternedFormats; i++)
+	{
+		const unsigned int index = (hash + i) & (MaxInternedFormats - 1);
+		InternedFormat &format = formats_[index];
+		int64_t slotKey = format.key.load(nctl::Atomic64::MemoryModel::ACQUIRE);
+
+		if (slotKey == 0)
+		{
+			if (format.key.cmpExchange(key, 0))
+			{
+				// The first thread to use a format string parses it, the others wait for the result
+				const int numArgs = BinaryLog::parseFormat(fmt, format.argTypes, BinaryLog::MaxFormatArgs);
+				format.format = fmt;
+				format.numArgs = (numArgs >= 0) ? static_cast<unsigned int>(numArgs) : 0;
+				format.state.store(numArgs >= 0 ? FORMAT_READY : FORMAT_UNSUPPORTED, nctl::Atomic32::MemoryModel::RELEASE);
+				return (numArgs >= 0) ? static_cast<int>(index) : -1;
+			}
+			slotKey = format.key.load(nctl::Atomic64::MemoryModel::ACQUIRE);
+		}
+
+		if (slotKey == key)
+		{
+			int32_t state = format.state.load(nctl::Atomic32::MemoryModel::ACQUIRE);
+			while (state == FORMAT_PARSING)
+			{
+#ifdef WITH_THREADS
+				Thread::yieldExecution();
+#endif
+				state = format.state.load(nctl::Atomic32::MemoryModel::ACQUIRE);
+			}
+			return (state == FORMAT_READY) ? static_cast<int>(index) : -1;
+		}
+	}
+
+	return -1;
+}
+
+int FileLogger::encodeArgs(bool isStaticFormat, const char *fmt, unsigned char *buffer, unsigned int &argsSize, va_list args)
+{
+	const int formatId = isStaticFormat ? internFormat(fmt) : -1;
+	if (formatId >= 0)
+	{
+		const InternedFormat &format = formats_[formatId];
+		argsSize = BinaryLog::encodeArgs(buffer, MaxEntryLength, format.argTypes, format.numArgs, args);
+		return formatId;
+	}
+
+	// A message whose format cannot be interned is formatted right away and stored as a single string
+	char message[MaxEntryLength];
+	vsnprintf(message, MaxEntryLength, fmt, args);
+	argsSize = BinaryLog::encodeString(buffer, MaxEntryLength, message);
+	return fallbackFormatId_;
+}
+
+void FileLogger::writeRecord(LogLevel level, time_t time, bool toConsole, bool toFile, int formatId, const unsigned char *args, unsigned int argsSize)
+{
+	if (toFile && isBinary_)
+		writeBinaryEntry(level, time, formatId, args, argsSize);
+
+	if (needsText(toConsole, toFile))
+	{
+		logEntry_[0] = '\0';
+		logEntry_[MaxEntryLength - 1] = '\0';
+
+		unsigned int timeMsgLength = 0;
+		unsigned int length = writePrefix(level, time, timeMsgLength);
+		const unsigned int logMsgStart = length;
+		const unsigned int logMsgLength = BinaryLog::formatArgs(logEntry_ + length, MaxEntryLength - length - 1, formats_[formatId].format, args, argsSize);
+		length += logMsgLength;
+
+		output(level, toConsole, toFile && isBinary_ == false, length, timeMsgLength, logMsgStart, logMsgLength);
+	}
+}
+
+void FileLogger::writeBinaryEntry(LogLevel level, time_t time, int formatId, const unsigned char *args, unsigned int argsSize)
+{
+	InternedFormat &format = formats_[formatId];
+	unsigned char record[BinaryLog::EntryRecordSize + MaxEntryLength];
+
+	if (format.isWritten.load(nctl::Atomic32::MemoryModel::RELAXED) == 0 && format.isWritten.cmpExchange(1, 0))
+	{
+		const size_t formatLength = nctl::min(strlen(format.format), size_t(MaxEntryLength));
+		const unsigned int recordSize = BinaryLog::writeFormatRecord(record, static_cast<uint32_t>(formatId), static_cast<uint16_t>(formatLength));
+		memcpy(record + recordSize, format.format, formatLength);
+		fwrite(record, 1, recordSize + formatLength, fileHandle_->ptr());
+	}
+
+	const unsigned int recordSize = BinaryLog::writeEntryRecord(record, static_cast<uint8_t>(level), static_cast<uint32_t>(formatId), time, static_cast<uint16_t>(argsSize));
+	memcpy(record + recordSize, args, argsSize);
+	// Records are written with a single call, to keep them whole when more threads are logging
+	fwrite(record, 1, recordSize + argsSize, fileHandle_->ptr());
+}
+
+void FileLogger::writeBinaryHeader()
+{
+	unsigned char header[BinaryLog::HeaderSize];
+	BinaryLog::writeHeader(header, 0);
+	fwrite(header, 1, BinaryLog::HeaderSize, fileHandle_->ptr());
+
+	for (unsigned int i = 0; i < MaxInternedFormats; i++)
+		formats_[i].isWritten.store(0, nctl::Atomic32::MemoryModel::RELAXED);
+}
+
+unsigned int FileLogger::writePrefix(LogLevel level, time_t now, unsigned int &timeMsgLength)
+{
+	const struct tm *ts = localtime(&now);
+
+	unsigned int length = strftime(logEntry_, MaxEntryLength - 1, "- %H:%M:%S ", ts);
+	timeMsgLength = length;
+	length += snprintf(logEntry_ + length, MaxEntryLength - length - 1, "[L%d] - ", static_cast<int>(level));
+
+	return length;
+}
+
+void FileLogger::output(LogLevel level, bool toConsole, bool toFile, unsigned int length, unsigned int timeMsgLength, unsigned int logMsgStart, unsigned int logMsgLength)
+{
+#if defined(WITH_IMGUI) || defined(WITH_TRACY)
+	const int levelInt = static_cast<int>(level);
+	const int consoleLevelInt = static_cast<int>(consoleLevel_);
+	const int fileLevelInt = static_cast<int>(fileLevel_);
+#endif
+
 	if (length < MaxEntryLength - 2)
 	{
 		logEntry_[length++] = '\n';
@@ -166,11 +506,11 @@ unsigned int FileLogger::write(LogLevel level, const char *fmt, ...)
 	const char *consoleLogEntry = logEntry_;
 	if (canUseColors_)
 	{
-		writeWithColors(level, logEntry_ + timeMsgStart, timeMsgLength, logEntry_ + logMsgStart, logMsgLength);
+		writeWithColors(level, logEntry_, timeMsgLength, logEntry_ + logMsgStart, logMsgLength);
 		consoleLogEntry = logEntryWithColors_;
 	}
 
-	if (consoleLevel_ != LogLevel::OFF && levelInt >= consoleLevelInt)
+	if (toConsole)
 	{
 #ifndef __ANDROID__
 		if (level == LogLevel::ERROR || level == LogLevel::FATAL)
@@ -203,20 +543,25 @@ unsigned int FileLogger::write(LogLevel level, const char *fmt, ...)
 #endif
 	}
 
-	if (fileLevel_ != LogLevel::OFF && levelInt >= fileLevelInt &&
-	    fileHandle_ != nullptr && fileHandle_->isOpened())
-	{
-		fprintf(fileHandle_->ptr(), "%s", logEntry_);
-		fflush(fileHandle_->ptr());
-	}
+	if (toFile)
+		fputs(logEntry_, fileHandle_->ptr());
 
 #ifdef WITH_IMGUI
 	if (levelInt >= consoleLevelInt || levelInt >= fileLevelInt)
 	{
+	#ifdef WITH_THREADS
+		// Entries can be written by the writer thread while the log string is read by another one
+		logStringMutex_.lock();
+		if (length > pendingLogString_.capacity() - pendingLogString_.length() - 1)
+			pendingLogString_.clear();
+		pendingLogString_.append(logEntry_);
+		logStringMutex_.unlock();
+	#else
 		if (length > logString_.capacity() - logString_.length() - 1)
 			logString_.clear();
 
 		logString_.append(logEntry_);
+	#endif
 	}
 #endif
 
@@ -241,14 +586,8 @@ unsigned int FileLogger::write(LogLevel level, const char *fmt, ...)
 		TracyMessageC(logEntry_, length, color);
 	}
 #endif
-
-	return length;
 }
 
-///////////////////////////////////////////////////////////
-// PRIVATE FUNCTIONS
-///////////////////////////////////////////////////////////
-
 unsigned int FileLogger::writeWithColors(LogLevel level, const char *timeMsg, unsigned int timeMsgLength, const char *logMsg, unsigned int logMsgLength)
 {
 	const int levelInt = static_cast<int>(level);
@@ -315,4 +654,134 @@ unsigned int FileLogger::writeWithColors(LogLevel level, const char *timeMsg, un
 
 	return length;
 }
+
+#ifdef WITH_THREADS
+unsigned int FileLogger::pushEntry(LogLevel level, bool toConsole, bool toFile, bool isStaticFormat, const char *fmt, va_list args)
+{
+	AsyncEntry *entry = nullptr;
+	int32_t pos = enqueuePos_.load(nctl::Atomic32::MemoryModel::RELAXED);
+	for (;;)
+	{
+		entry = &asyncQueue_[static_cast<uint32_t>(pos) % AsyncQueueSize];
+		const int32_t sequence = entry->sequence.load(nctl::Atomic32::MemoryModel::ACQUIRE);
+		const int32_t diff = static_cast<int32_t>(static_cast<uint32_t>(sequence) - static_cast<uint32_t>(pos));
+
+		if (diff == 0)
+		{
+			if (enqueuePos_.cmpExchange(pos + 1, pos))
+				break;
+		}
+		else if (diff < 0)
+		{
+			// The ring is full, only errors wait for the writer thread to free an entry
+			if (level != LogLevel::ERROR && level != LogLevel::FATAL)
+			{
+				numDropped_.fetchAdd(1);
+				return 0;
+			}
+			wakeWriter();
+			Thread::yieldExecution();
+		}
+		pos = enqueuePos_.load(nctl::Atomic32::MemoryModel::RELAXED);
+	}
+
+	entry->level = level;
+	entry->time = time(nullptr);
+	entry->toConsole = toConsole;
+	entry->toFile = toFile;
+	entry->formatId = encodeArgs(isStaticFormat, fmt, entry->args, entry->argsSize, args);
+	// Publishing the entry and checking for a waiting writer are sequentially consistent, to never miss a wake up
+	entry->sequence.store(pos + 1);
+
+	if (isWriterWaiting_.load() != 0)
+		wakeWriter();
+
+	// A fatal error is usually followed by the termination of the application
+	if (level == LogLevel::FATAL)
+		flush();
+
+	return entry->argsSize;
+}
+
+void FileLogger::wakeWriter()
+{
+	writerMutex_.lock();
+	writerCondition_.signal();
+	writerMutex_.unlock();
+}
+
+void FileLogger::processEntries()
+{
+	TimeStamp lastFlushTime = TimeStamp::now();
+	bool hasUnflushedEntries = false;
+	unsigned int numReportedDropped = numDroppedEntries();
+
+	for (;;)
+	{
+		const int32_t pos = dequeuePos_.load(nctl::Atomic32::MemoryModel::RELAXED);
+		AsyncEntry &entry = asyncQueue_[static_cast<uint32_t>(pos) % AsyncQueueSize];
+		if (entry.sequence.load(nctl::Atomic32::MemoryModel::ACQUIRE) == pos + 1)
+		{
+			writeRecord(entry.level, entry.time, entry.toConsole, entry.toFile, entry.formatId, entry.args, entry.argsSize);
+			hasUnflushedEntries |= entry.toFile;
+			const bool isError = (entry.level == LogLevel::ERROR || entry.level == LogLevel::FATAL);
+
+			// The entry can be reused by producers one lap later
+			entry.sequence.store(pos + static_cast<int32_t>(AsyncQueueSize), nctl::Atomic32::MemoryModel::RELEASE);
+			dequeuePos_.store(pos + 1, nctl::Atomic32::MemoryModel::RELEASE);
+
+			if (hasUnflushedEntries && (isError || lastFlushTime.millisecondsSince() >= AsyncFlushInterval))
+			{
+				fflush(fileHandle_->ptr());
+				hasUnflushedEntries = false;
+				lastFlushTime = TimeStamp::now();
+			}
+			continue;
+		}
+
+		// The ring is empty, the dropped entries are reported and the batch of entries is flushed before waiting
+		const unsigned int numDropped = numDroppedEntries();
+		if (numDropped != numReportedDropped && isEnabled(LogLevel::WARN))
+		{
+			char message[64];
+			snprintf(message, sizeof(message), "FileLogger -> %u log entries have been dropped", numDropped - numReportedDropped);
+			unsigned char argsBuffer[MaxEntryLength];
+			const unsigned int argsSize = BinaryLog::encodeString(argsBuffer, MaxEntryLength, message);
+
+			const int levelInt = static_cast<int>(LogLevel::WARN);
+			const bool toConsole = (consoleLevel_ != LogLevel::OFF && levelInt >= static_cast<int>(consoleLevel_));
+			const bool toFile = (fileLevel_ != LogLevel::OFF && levelInt >= static_cast<int>(fileLevel_) && fileHandle_ != nullptr && fileHandle_->isOpened());
+			writeRecord(LogLevel::WARN, time(nullptr), toConsole, toFile, fallbackFormatId_, argsBuffer, argsSize);
+			hasUnflushedEntries |= toFile;
+		}
+		numReportedDropped = numDropped;
+
+		if (hasUnflushedEntries)
+		{
+			fflush(fileHandle_->ptr());
+			hasUnflushedEntries = false;
+			lastFlushTime = TimeStamp::now();
+		}
+
+		if (shouldQuit_.load() != 0)
+			break;
+
+		writerMutex_.lock();
+		isWriterWaiting_.store(1);
+		// An entry published before the flag was set would not wake the writer up
+		const bool hasNewEntries = (entry.sequence.load() == pos + 1);
+		if (hasNewEntries == false && shouldQuit_.load() == 0)
+			writerCondition_.wait(writerMutex_);
+		isWriterWaiting_.store(0);
+		writerMutex_.unlock();
+	}
+}
+
+void FileLogger::writerFunction(void *arg)
+{
+	FileLogger *fileLogger = static_cast<FileLogger *>(arg);
+	fileLogger->processEntries();
+}
+#endif
+
 }
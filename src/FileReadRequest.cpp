@@ -0,0 +1,86 @@
+#include <cstring> // for memcpy()
+#include "common_macros.h"
+#include "FileReadRequest.h"
+
+#ifdef WITH_THREADS
+	#include "FileReadQueue.h"
+#endif
+
+namespace ncine {
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+FileReadRequest::FileReadRequest(IFile &file, unsigned long int offset, void *buffer, unsigned long int bytes, IFile::ReadCallback callback, void *userData)
+    : file_(file), offset_(offset), buffer_(buffer), bytes_(bytes), bytesRead_(0),
+      callback_(callback), userData_(userData), state_(static_cast<int32_t>(State::PENDING))
+{
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool FileReadRequest::cancel()
+{
+	const bool canceled = setCanceled();
+#ifdef WITH_THREADS
+	if (canceled)
+		theFileReadQueue().notifyDone();
+#endif
+	return canceled;
+}
+
+/*! \note Without threads a request is always done when it is returned */
+void FileReadRequest::wait() const
+{
+#ifdef WITH_THREADS
+	if (isDone() == false)
+		theFileReadQueue().wait(*this);
+#endif
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool FileReadRequest::execute()
+{
+	if (state_.cmpExchange(static_cast<int32_t>(State::READING), static_cast<int32_t>(State::PENDING)) == false)
+		return false;
+
+	bool succeeded = false;
+	const IFile &constFile = file_;
+	const unsigned char *fileBuffer = static_cast<const unsigned char *>(constFile.bufferPtr());
+	if (file_.isOpened() == false)
+		LOGW_X("Cannot read from the closed file \"%s\"", file_.filename());
+	else if (fileBuffer != nullptr)
+	{
+		// Memory and mapped files are copied without seeking
+		if (offset_ <= file_.size())
+		{
+			bytesRead_ = (offset_ + bytes_ > file_.size()) ? file_.size() - offset_ : bytes_;
+			memcpy(buffer_, fileBuffer + offset_, bytesRead_);
+			succeeded = true;
+		}
+	}
+	else if (file_.seek(static_cast<long int>(offset_), SEEK_SET) >= 0)
+	{
+		bytesRead_ = file_.read(buffer_, bytes_);
+		succeeded = true;
+	}
+
+	if (callback_)
+		callback_(*this, succeeded, userData_);
+
+	state_.store(static_cast<int32_t>(succeeded ? State::COMPLETED : State::FAILED), nctl::Atomic32::MemoryModel::RELEASE);
+	return true;
+}
+
+bool FileReadRequest::setCanceled()
+{
+	return state_.cmpExchange(static_cast<int32_t>(State::CANCELED), static_cast<int32_t>(State::PENDING));
+}
+
+}
@@ -1,5 +1,12 @@
+#include <cstring> // for strncmp()
 #include "FileSystem.h"
+#include "AssetArchive.h"
 #include <nctl/CString.h>
+#include <nctl/Array.h>
+#include <nctl/UniquePtr.h>
+#ifdef WITH_THREADS
+	#include "ThreadSync.h"
+#endif
 
 #ifdef _WIN32
 	#include "common_windefines.h"
@@ -44,6 +51,61 @@ namespace {
 
 	char buffer[fs::MaxPathLength];
 
+	/// Returns the asset archives in mount order
+	nctl::Array<nctl::UniquePtr<AssetArchive>> &mountedArchives()
+	{
+		static nctl::Array<nctl::UniquePtr<AssetArchive>> archives;
+		return archives;
+	}
+
+#ifdef WITH_THREADS
+	/// Returns the mutex that protects the array of mounted archives, searched by the I/O and worker threads too
+	Mutex &archivesMutex()
+	{
+		static Mutex mutex;
+		return mutex;
+	}
+#endif
+
+	bool isSeparator(char c)
+	{
+		return (c == '/' || c == '\\');
+	}
+
+	/// Returns true if the path starts with the data path, matching whole directory names only
+	bool startsWithDataPath(const char *path, const nctl::String &dataPath)
+	{
+		if (dataPath.isEmpty() || strncmp(path, dataPath.data(), dataPath.length()) != 0)
+			return false;
+
+		const char nextChar = path[dataPath.length()];
+		return (isSeparator(dataPath[dataPath.length() - 1]) || isSeparator(nextChar) || nextChar == '\0');
+	}
+
+	/// Returns the path relative to the archive root, or `nullptr` if it is an absolute path outside of the data path
+	const char *archiveRelativePath(const char *path)
+	{
+		const nctl::String &dataPath = fs::dataPath();
+		const bool hasDataPath = startsWithDataPath(path, dataPath);
+		if (hasDataPath)
+		{
+			path += dataPath.length();
+			while (isSeparator(*path))
+				path++;
+		}
+		else if (isSeparator(*path))
+			return nullptr;
+
+		return path;
+	}
+
+	/// Returns true if the path refers to a file inside one of the mounted archives
+	bool isArchivedFile(const char *path)
+	{
+		unsigned int entryIndex = 0;
+		return (fs::findArchivedFile(path, entryIndex) != nullptr);
+	}
+
 #ifndef _WIN32
 	bool callStat(const char *path, struct stat &sb)
 	{
@@ -520,6 +582,8 @@ bool FileSystem::isFile(const char *path)
 {
 	if (path == nullptr)
 		return false;
+	if (isArchivedFile(path))
+		return true;
 
 #ifdef _WIN32
 	const DWORD attrs = GetFileAttributesA(path);
@@ -542,6 +606,8 @@ bool FileSystem::exists(const char *path)
 {
 	if (path == nullptr)
 		return false;
+	if (isArchivedFile(path))
+		return true;
 
 #ifdef _WIN32
 	const DWORD attrs = GetFileAttributesA(path);
@@ -562,6 +628,8 @@ bool FileSystem::isReadable(const char *path)
 {
 	if (path == nullptr)
 		return false;
+	if (isArchivedFile(path))
+		return true;
 
 #ifdef _WIN32
 	// Assuming that every file that exists is also readable
@@ -634,6 +702,8 @@ bool FileSystem::isReadableFile(const char *path)
 {
 	if (path == nullptr)
 		return false;
+	if (isArchivedFile(path))
+		return true;
 
 #ifdef _WIN32
 	const DWORD attrs = GetFileAttributesA(path);
@@ -897,6 +967,10 @@ long int FileSystem::fileSize(const char *path)
 {
 	if (path == nullptr)
 		return -1;
+	unsigned int entryIndex = 0;
+	const AssetArchive *archive = findArchivedFile(path, entryIndex);
+	if (archive)
+		return static_cast<long int>(archive->entry(entryIndex).size);
 
 #ifdef _WIN32
 	HANDLE hFile = CreateFile(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, NULL);
@@ -923,6 +997,11 @@ long int FileSystem::fileSize(const char *path)
 FileSystem::FileDate FileSystem::lastModificationTime(const char *path)
 {
 	FileDate date = {};
+	unsigned int entryIndex = 0;
+	const AssetArchive *archive = findArchivedFile(path, entryIndex);
+	if (archive)
+		path = archive->filename();
+
 #ifdef _WIN32
 	HANDLE hFile = CreateFile(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, NULL);
 	FILETIME fileTime;
@@ -1162,6 +1241,115 @@ const nctl::String &FileSystem::cachePath()
 	return cachePath_;
 }
 
+bool FileSystem::mountArchive(const char *path)
+{
+	ASSERT(path);
+	nctl::UniquePtr<AssetArchive> archive = nctl::makeUnique<AssetArchive>(path);
+	if (archive->isOpened() == false)
+		return false;
+
+#ifdef WITH_THREADS
+	archivesMutex().lock();
+#endif
+	nctl::Array<nctl::UniquePtr<AssetArchive>> &archives = mountedArchives();
+	bool alreadyMounted = false;
+	for (unsigned int i = 0; i < archives.size(); i++)
+	{
+		if (strcmp(archives[i]->filename(), path) == 0)
+		{
+			alreadyMounted = true;
+			break;
+		}
+	}
+	if (alreadyMounted == false)
+		archives.pushBack(nctl::move(archive));
+#ifdef WITH_THREADS
+	archivesMutex().unlock();
+#endif
+
+	if (alreadyMounted)
+		LOGW_X("Archive \"%s\" is already mounted", path);
+	return (alreadyMounted == false);
+}
+
+bool FileSystem::unmountArchive(const char *path)
+{
+	ASSERT(path);
+	bool unmounted = false;
+#ifdef WITH_THREADS
+	archivesMutex().lock();
+#endif
+	nctl::Array<nctl::UniquePtr<AssetArchive>> &archives = mountedArchives();
+	for (unsigned int i = 0; i < archives.size(); i++)
+	{
+		if (strcmp(archives[i]->filename(), path) == 0)
+		{
+			archives.removeAt(i);
+			unmounted = true;
+			break;
+		}
+	}
+#ifdef WITH_THREADS
+	archivesMutex().unlock();
+#endif
+
+	return unmounted;
+}
+
+void FileSystem::unmountArchives()
+{
+#ifdef WITH_THREADS
+	archivesMutex().lock();
+#endif
+	mountedArchives().clear();
+#ifdef WITH_THREADS
+	archivesMutex().unlock();
+#endif
+}
+
+unsigned int FileSystem::numMountedArchives()
+{
+#ifdef WITH_THREADS
+	archivesMutex().lock();
+#endif
+	const unsigned int numArchives = mountedArchives().size();
+#ifdef WITH_THREADS
+	archivesMutex().unlock();
+#endif
+	return numArchives;
+}
+
+const AssetArchive *FileSystem::findArchivedFile(const char *path, unsigned int &entryIndex)
+{
+	if (path == nullptr)
+		return nullptr;
+
+	const AssetArchive *foundArchive = nullptr;
+#ifdef WITH_THREADS
+	archivesMutex().lock();
+#endif
+	const nctl::Array<nctl::UniquePtr<AssetArchive>> &archives = mountedArchives();
+	const char *relativePath = archives.isEmpty() ? nullptr : archiveRelativePath(path);
+	if (relativePath != nullptr && *relativePath != '\0')
+	{
+		for (int i = static_cast<int>(archives.size()) - 1; i >= 0; i--)
+		{
+			const int index = archives[i]->findEntry(relativePath);
+			if (index >= 0)
+			{
+				entryIndex = static_cast<unsigned int>(index);
+				foundArchive = archives[i].get();
+				break;
+			}
+		}
+	}
+#ifdef WITH_THREADS
+	archivesMutex().unlock();
+#endif
+
+	return foundArchive;
+}
+
 ///////////////////////////////////////////////////////////
 // PRIVATE FUNCTIONS
 ///////////////////////////////////////////////////////////
@@ -32,6 +32,14 @@ FntParser::FntParser(const char *fntFilename)
 		return;
 
 	const long int size = fileHandle->size();
+	// The content of a mapped file is parsed without copying it
+	const char *fileBufferPtr = static_cast<const char *>(fileHandle->bufferPtr());
+	if (fileBufferPtr != nullptr)
+	{
+		parseFntBuffer(fileBufferPtr, size);
+		return;
+	}
+
 	nctl::UniquePtr<char[]> fileBuffer = nctl::makeUnique<char[]>(size);
 	fileHandle->read(fileBuffer.get(), size);
 
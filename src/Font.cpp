@@ -184,21 +184,7 @@ bool Font::loadFromFile(const char *fntFilename)
 	if (fntParser.numCharTags() == 0)
 		return false;
 
-#ifdef __ANDROID__
-	nctl::String dirName = fs::dirName(AssetFile::assetPath(fntFilename));
-
-	static nctl::String texFilename(256);
-	if (AssetFile::assetPath(fntFilename) != fntFilename)
-		texFilename.append(AssetFile::Prefix);
-	if (dirName != ".")
-		texFilename.append(fs::joinPath(dirName, fntParser.pageTag(0).file).data());
-	else
-		texFilename.append(fntParser.pageTag(0).file.data());
-#else
-	nctl::String dirName = fs::dirName(fntFilename);
-	nctl::String texFilename = fs::absoluteJoinPath(dirName, fntParser.pageTag(0).file);
-#endif
-
+	const nctl::String texFilename = textureFilename(fntFilename, fntParser);
 	const bool texHasLoaded = loadTextureFromFile(texFilename.data());
 	if (texHasLoaded == false)
 		return false;
@@ -301,6 +287,43 @@ bool Font::loadTextureFromFile(const char *texFilename)
 	return texHasLoaded;
 }
 
+bool Font::loadFromParser(const char *fntName, const FntParser &fntParser, nctl::UniquePtr<Texture> texture)
+{
+	if (fntParser.numCharTags() == 0 || texture == nullptr)
+		return false;
+
+	texture_ = nctl::move(texture);
+	texturePtr_ = nullptr;
+
+	const bool fntInfoValid = checkFntInformation(fntParser);
+	if (fntInfoValid == false)
+		return false;
+
+	setName(fntName);
+	determineRenderMode(fntParser);
+	retrieveInfoFromFnt(fntParser);
+	return true;
+}
+
+nctl::String Font::textureFilename(const char *fntFilename, const FntParser &fntParser)
+{
+#ifdef __ANDROID__
+	nctl::String dirName = fs::dirName(AssetFile::assetPath(fntFilename));
+
+	nctl::String texFilename(256);
+	if (AssetFile::assetPath(fntFilename) != fntFilename)
+		texFilename.append(AssetFile::Prefix);
+	if (dirName != ".")
+		texFilename.append(fs::joinPath(dirName, fntParser.pageTag(0).file).data());
+	else
+		texFilename.append(fntParser.pageTag(0).file.data());
+	return texFilename;
+#else
+	nctl::String dirName = fs::dirName(fntFilename);
+	return fs::absoluteJoinPath(dirName, fntParser.pageTag(0).file);
+#endif
+}
+
 bool Font::checkFntInformation(const FntParser &fntParser)
 {
 	const FntParser::InfoTag &infoTag = fntParser.infoTag();
@@ -2,6 +2,13 @@
 #include "IFile.h"
 #include "MemoryFile.h"
 #include "StandardFile.h"
+#include "ArchivedFile.h"
+#include "FileSystem.h"
+#include "FileReadRequest.h"
+
+#ifdef WITH_THREADS
+	#include "FileReadQueue.h"
+#endif
 
 #ifdef __ANDROID__
 	#include <cstring>
@@ -33,6 +40,25 @@ bool IFile::isOpened() const
 		return false;
 }
 
+nctl::SharedPtr<FileReadRequest> IFile::readAsync(unsigned long int offset, void *buffer, unsigned long int bytes, ReadCallback callback, void *userData)
+{
+	ASSERT(buffer);
+	nctl::SharedPtr<FileReadRequest> request(new FileReadRequest(*this, offset, buffer, bytes, callback, userData));
+
+#ifdef WITH_THREADS
+	// A file whose content is already in memory gains nothing from the I/O thread
+	const IFile &constFile = *this;
+	if (constFile.bufferPtr() == nullptr)
+	{
+		theFileReadQueue().enqueue(request);
+		return request;
+	}
+#endif
+
+	request->execute();
+	return request;
+}
+
 nctl::UniquePtr<IFile> IFile::createFromMemory(const char *bufferName, unsigned char *bufferPtr, unsigned long int bufferSize)
 {
 	ASSERT(bufferName);
@@ -90,6 +116,13 @@ nctl::UniquePtr<IFile> IFile::createFromMemory(nctl::UniquePtr<unsigned char []>
 nctl::UniquePtr<IFile> IFile::createFileHandle(const char *filename)
 {
 	ASSERT(filename);
+
+	// Files inside the mounted archives are found before the ones on disk
+	unsigned int entryIndex = 0;
+	const AssetArchive *archive = FileSystem::findArchivedFile(filename, entryIndex);
+	if (archive)
+		return nctl::makeUnique<ArchivedFile>(filename, *archive, entryIndex);
+
 #ifdef __ANDROID__
 	const char *assetFilename = AssetFile::assetPath(filename);
 	if (assetFilename)
@@ -77,7 +77,9 @@ void PCApplication::init(nctl::UniquePtr<IAppEventHandler> (*createAppEventHandl
 	FileLogger &fileLogger = static_cast<FileLogger &>(theServiceLocator().logger());
 	fileLogger.setConsoleLevel(appCfg_.consoleLogLevel);
 	fileLogger.setFileLevel(appCfg_.fileLogLevel);
+	fileLogger.setBinary(appCfg_.withBinaryLogging);
 	fileLogger.openLogFile(appCfg_.logFile.data());
+	fileLogger.setAsync(appCfg_.withAsyncLogging);
 	LOGI("IAppEventHandler::onPreInit() invoked"); // Logging delayed to set up the logger first
 
 	// The application's `onPreInit()` might have requested to quit
@@ -0,0 +1,123 @@
+#include "common_macros.h"
+#include "ParallelAlgorithms.h"
+#include "ServiceLocator.h"
+
+#ifdef WITH_THREADS
+	#include <nctl/Atomic.h>
+	#include <nctl/SharedPtr.h>
+	#include "IThreadCommand.h"
+	#include "ThreadSync.h"
+#endif
+
+namespace ncine {
+
+namespace {
+
+#ifdef WITH_THREADS
+	/// The state shared by the calling thread and the workers helping it
+	/*! It is reference counted because commands still in the queue can outlive the `parallelFor()` call. */
+	struct ParallelForState
+	{
+		ParallelForState(unsigned int numElements, unsigned int grainSize, ParallelChunkFunction func, void *userData)
+		    : numElements(numElements), grainSize(grainSize), numChunks(parallelNumChunks(numElements, grainSize)),
+		      func(func), userData(userData), nextChunk(0), numDoneChunks(0) {}
+
+		const unsigned int numElements;
+		const unsigned int grainSize;
+		const unsigned int numChunks;
+		const ParallelChunkFunction func;
+		void *const userData;
+
+		/// The index of the next chunk that can be claimed
+		nctl::Atomic32 nextChunk;
+		/// The number of chunks that have been processed
+		nctl::Atomic32 numDoneChunks;
+		Mutex mutex;
+		CondVariable cond;
+	};
+
+	/// Claims and processes chunks until there are none left
+	void processChunks(ParallelForState &state)
+	{
+		while (true)
+		{
+			const unsigned int chunkIndex = static_cast<unsigned int>(state.nextChunk.fetchAdd(1));
+			if (chunkIndex >= state.numChunks)
+				break;
+
+			const unsigned int firstIndex = chunkIndex * state.grainSize;
+			const unsigned int lastIndex = nctl::min(firstIndex + state.grainSize, state.numElements);
+			state.func(firstIndex, lastIndex, chunkIndex, state.userData);
+
+			if (static_cast<unsigned int>(state.numDoneChunks.fetchAdd(1)) + 1 == state.numChunks)
+			{
+				state.mutex.lock();
+				state.cond.broadcast();
+				state.mutex.unlock();
+			}
+		}
+	}
+
+	/// A thread pool command that helps the calling thread of `parallelFor()` processing chunks
+	class ParallelForCommand : public IThreadCommand
+	{
+	  public:
+		explicit ParallelForCommand(const nctl::SharedPtr<ParallelForState> &state)
+		    : state_(state) {}
+
+		void execute() override { processChunks(*state_); }
+
+	  private:
+		nctl::SharedPtr<ParallelForState> state_;
+	};
+#endif
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+unsigned int parallelNumThreads()
+{
+	return theServiceLocator().threadPool().numThreads();
+}
+
+void parallelFor(unsigned int numElements, unsigned int grainSize, ParallelChunkFunction func, void *userData)
+{
+	ASSERT(func);
+	if (grainSize == 0)
+		grainSize = 1;
+	const unsigned int numChunks = parallelNumChunks(numElements, grainSize);
+
+#ifdef WITH_THREADS
+	IThreadPool &threadPool = theServiceLocator().threadPool();
+	if (numChunks > 1 && threadPool.numThreads() > 0)
+	{
+		nctl::SharedPtr<ParallelForState> state = nctl::makeShared<ParallelForState>(numElements, grainSize, func, userData);
+
+		// Chunks are claimed dynamically, no more workers than the chunks left for them are needed
+		const unsigned int numHelpers = nctl::min(threadPool.numThreads(), numChunks - 1);
+		for (unsigned int i = 0; i < numHelpers; i++)
+			threadPool.enqueueCommand(nctl::makeUnique<ParallelForCommand>(state));
+
+		// The calling thread never waits for a chunk that nobody is processing, even if workers are busy or it is a worker itself
+		processChunks(*state);
+
+		state->mutex.lock();
+		while (static_cast<unsigned int>(state->numDoneChunks.load()) < numChunks)
+			state->cond.wait(state->mutex);
+		state->mutex.unlock();
+		return;
+	}
+#endif
+
+	for (unsigned int chunkIndex = 0; chunkIndex < numChunks; chunkIndex++)
+	{
+		const unsigned int firstIndex = chunkIndex * grainSize;
+		const unsigned int lastIndex = nctl::min(firstIndex + grainSize, numElements);
+		func(firstIndex, lastIndex, chunkIndex, userData);
+	}
+}
+
+}
@@ -7,6 +7,14 @@
 	#include <io.h> // for _access()
 #endif
 
+// Memory mapping is not available on Windows and it is emulated with a copy on Emscripten
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+	#include <sys/mman.h> // for mmap()
+	#define NCINE_MAPPED_FILES
+#endif
+
+#include <cstring> // for memcpy()
+
 #include "common_macros.h"
 #include "StandardFile.h"
 
@@ -33,6 +41,11 @@ void StandardFile::open(unsigned char mode)
 		LOGW_X("File \"%s\" is already opened", filename_.data());
 	else
 	{
+		// Mapping the content in memory, falling back to a file stream for small files or on failure
+		const unsigned char readOnlyMode = mode & ~OpenMode::BINARY;
+		if (readOnlyMode == OpenMode::READ && openMapped())
+			return;
+
 #if !(defined(_WIN32) && !defined(__MINGW32__))
 		// Opening with a file descriptor
 		if (mode & OpenMode::FD)
@@ -47,6 +60,15 @@ void StandardFile::open(unsigned char mode)
 /*! This method will close a file both normally opened or fopened */
 void StandardFile::close()
 {
+#ifdef NCINE_MAPPED_FILES
+	if (mappedBuffer_)
+	{
+		munmap(mappedBuffer_, fileSize_);
+		mappedBuffer_ = nullptr;
+		mappedOffset_ = 0;
+	}
+#endif
+
 	if (fileDescriptor_ >= 0)
 	{
 #if !(defined(_WIN32) && !defined(__MINGW32__))
@@ -77,7 +99,27 @@ long int StandardFile::seek(long int offset, int whence) const
 {
 	long int seekValue = -1;
 
-	if (fileDescriptor_ >= 0)
+	if (mappedBuffer_)
+	{
+		switch (whence)
+		{
+			case SEEK_SET:
+				seekValue = offset;
+				break;
+			case SEEK_CUR:
+				seekValue = static_cast<long int>(mappedOffset_) + offset;
+				break;
+			case SEEK_END:
+				seekValue = static_cast<long int>(fileSize_) + offset;
+				break;
+		}
+
+		if (seekValue < 0 || seekValue > static_cast<long int>(fileSize_))
+			seekValue = -1;
+		else
+			mappedOffset_ = seekValue;
+	}
+	else if (fileDescriptor_ >= 0)
 	{
 #if !(defined(_WIN32) && !defined(__MINGW32__))
 		seekValue = lseek(fileDescriptor_, offset, whence);
@@ -93,7 +135,9 @@ long int StandardFile::tell() const
 {
 	long int tellValue = -1;
 
-	if (fileDescriptor_ >= 0)
+	if (mappedBuffer_)
+		tellValue = static_cast<long int>(mappedOffset_);
+	else if (fileDescriptor_ >= 0)
 	{
 #if !(defined(_WIN32) && !defined(__MINGW32__))
 		tellValue = lseek(fileDescriptor_, 0L, SEEK_CUR);
@@ -111,7 +155,13 @@ unsigned long int StandardFile::read(void *buffer, unsigned long int bytes) cons
 
 	unsigned long int bytesRead = 0;
 
-	if (fileDescriptor_ >= 0)
+	if (mappedBuffer_)
+	{
+		bytesRead = (mappedOffset_ + bytes > fileSize_) ? fileSize_ - mappedOffset_ : bytes;
+		memcpy(buffer, mappedBuffer_ + mappedOffset_, bytesRead);
+		mappedOffset_ += bytesRead;
+	}
+	else if (fileDescriptor_ >= 0)
 	{
 #if !(defined(_WIN32) && !defined(__MINGW32__))
 		bytesRead = ::read(fileDescriptor_, buffer, bytes);
@@ -129,7 +179,9 @@ unsigned long int StandardFile::write(const void *buffer, unsigned long int byte
 
 	unsigned long int bytesWritten = 0;
 
-	if (fileDescriptor_ >= 0)
+	if (mappedBuffer_)
+		LOGW_X("Cannot write to the read-only file \"%s\"", filename_.data());
+	else if (fileDescriptor_ >= 0)
 	{
 #if !(defined(_WIN32) && !defined(__MINGW32__))
 		bytesWritten = ::write(fileDescriptor_, buffer, bytes);
@@ -241,4 +293,38 @@ void StandardFile::openStream(unsigned char mode)
 	}
 }
 
+bool StandardFile::openMapped()
+{
+#ifdef NCINE_MAPPED_FILES
+	const int fileDescriptor = ::open(filename_.data(), O_RDONLY);
+	if (fileDescriptor < 0)
+		return false;
+
+	struct stat fileStat;
+	if (fstat(fileDescriptor, &fileStat) != 0 || S_ISREG(fileStat.st_mode) == false ||
+	    static_cast<unsigned long int>(fileStat.st_size) < MinMappedSize)
+	{
+		::close(fileDescriptor);
+		return false;
+	}
+
+	// A private mapping can be written without changing the file, like a memory buffer
+	void *mappedBuffer = mmap(nullptr, fileStat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileDescriptor, 0);
+	if (mappedBuffer == MAP_FAILED)
+	{
+		::close(fileDescriptor);
+		return false;
+	}
+
+	LOGI_X("File \"%s\" opened and mapped in memory", filename_.data());
+	fileDescriptor_ = fileDescriptor;
+	fileSize_ = static_cast<unsigned long int>(fileStat.st_size);
+	mappedBuffer_ = static_cast<unsigned char *>(mappedBuffer);
+	mappedOffset_ = 0;
+	return true;
+#else
+	return false;
+#endif
+}
+
 }
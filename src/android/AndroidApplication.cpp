@@ -252,7 +252,9 @@ void AndroidApplication::preInit()
 	FileLogger &fileLogger = static_cast<FileLogger &>(theServiceLocator().logger());
 	fileLogger.setConsoleLevel(appCfg_.consoleLogLevel);
 	fileLogger.setFileLevel(appCfg_.fileLogLevel);
+	fileLogger.setBinary(appCfg_.withBinaryLogging);
 	fileLogger.openLogFile(logFilePath.data());
+	fileLogger.setAsync(appCfg_.withAsyncLogging);
 	LOGI("IAppEventHandler::onPreInit() invoked"); // Logging delayed to set up the logger first
 }
 
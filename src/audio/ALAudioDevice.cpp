@@ -29,6 +29,12 @@ bool hasEfxExtension()
 	return hasEfxExtension_;
 }
 
+///////////////////////////////////////////////////////////
+// STATIC DEFINITIONS
+///////////////////////////////////////////////////////////
+
+const float ALAudioDevice::VirtualizationThreshold = 0.1f;
+
 ///////////////////////////////////////////////////////////
 // CONSTRUCTORS and DESTRUCTOR
 ///////////////////////////////////////////////////////////
@@ -36,7 +42,7 @@ bool hasEfxExtension()
 ALAudioDevice::ALAudioDevice(const AppConfiguration &appCfg)
     : device_(nullptr), context_(nullptr),
       gain_(1.0f), position_(Vector3f::Zero), velocity_(Vector3f::Zero),
-      pausedPlayers_(1)
+      pausedPlayers_(1), virtualPlayers_(16), numStreamUnderruns_(0)
 {
 	device_ = alcOpenDevice(nullptr);
 	FATAL_ASSERT_MSG_X(device_ != nullptr, "alcOpenDevice failed: 0x%x", alGetError());
@@ -121,6 +127,17 @@ ALAudioDevice::~ALAudioDevice()
 // PUBLIC FUNCTIONS
 ///////////////////////////////////////////////////////////
 
+/*! \note The device is closed again, as the constructor cannot fail without a fatal error */
+bool ALAudioDevice::isAvailable()
+{
+	ALCdevice *device = alcOpenDevice(nullptr);
+	if (device == nullptr)
+		return false;
+
+	alcCloseDevice(device);
+	return true;
+}
+
 bool ALAudioDevice::hasExtension(ALExtensions::Enum extensionName) const
 {
 	bool extensionAvailable = false;
@@ -177,6 +194,22 @@ IAudioPlayer *ALAudioDevice::player(unsigned int index)
 	return nullptr;
 }
 
+const IAudioPlayer *ALAudioDevice::virtualPlayer(unsigned int index) const
+{
+	if (index < virtualPlayers_.size())
+		return virtualPlayers_[index];
+
+	return nullptr;
+}
+
+IAudioPlayer *ALAudioDevice::virtualPlayer(unsigned int index)
+{
+	if (index < virtualPlayers_.size())
+		return virtualPlayers_[index];
+
+	return nullptr;
+}
+
 void ALAudioDevice::pausePlayers()
 {
 	for (unsigned int i = 0; i < players_.size(); i++)
@@ -187,12 +220,27 @@ void ALAudioDevice::pausePlayers()
 			pausedPlayers_.insert(players_[i]);
 		}
 	}
+
+	for (unsigned int i = 0; i < virtualPlayers_.size(); i++)
+	{
+		if (virtualPlayers_[i]->isPlaying())
+		{
+			virtualPlayers_[i]->pause();
+			// The set is sized for the number of sources, virtual players could exceed it
+			if (pausedPlayers_.loadFactor() >= 0.8f)
+				pausedPlayers_.rehash(pausedPlayers_.capacity() * 2);
+			pausedPlayers_.insert(virtualPlayers_[i]);
+		}
+	}
 }
 
 void ALAudioDevice::stopPlayers()
 {
-	for (unsigned int i = 0; i < players_.size(); i++)
+	// Stopped players are unregistered and removed from the arrays (in reverse order)
+	for (int i = players_.size() - 1; i >= 0; i--)
 		players_[i]->stop();
+	for (int i = virtualPlayers_.size() - 1; i >= 0; i--)
+		virtualPlayers_[i]->stop();
 }
 
 void ALAudioDevice::pausePlayers(PlayerType playerType)
@@ -209,6 +257,18 @@ void ALAudioDevice::pausePlayers(PlayerType playerType)
 			pausedPlayers_.insert(players_[i]);
 		}
 	}
+
+	for (int i = virtualPlayers_.size() - 1; i >= 0; i--)
+	{
+		if (virtualPlayers_[i]->type() == objectType)
+		{
+			virtualPlayers_[i]->pause();
+			// The set is sized for the number of sources, virtual players could exceed it
+			if (pausedPlayers_.loadFactor() >= 0.8f)
+				pausedPlayers_.rehash(pausedPlayers_.capacity() * 2);
+			pausedPlayers_.insert(virtualPlayers_[i]);
+		}
+	}
 }
 
 void ALAudioDevice::stopPlayers(PlayerType playerType)
@@ -222,6 +282,12 @@ void ALAudioDevice::stopPlayers(PlayerType playerType)
 		if (players_[i]->type() == objectType)
 			players_[i]->stop();
 	}
+
+	for (int i = virtualPlayers_.size() - 1; i >= 0; i--)
+	{
+		if (virtualPlayers_[i]->type() == objectType)
+			virtualPlayers_[i]->stop();
+	}
 }
 
 void ALAudioDevice::resumePlayers()
@@ -252,6 +318,9 @@ void ALAudioDevice::resumeDevice()
 	else
 #endif
 		resumePlayers();
+
+	// Virtual players should not advance while the device is paused
+	lastUpdateTime_ = TimeStamp::now();
 }
 
 void ALAudioDevice::registerPlayer(IAudioPlayer *player)
@@ -263,15 +332,31 @@ void ALAudioDevice::registerPlayer(IAudioPlayer *player)
 	if (player == nullptr || player->sourceId_ != InvalidSource)
 		return;
 
+	if (sourcesPool_.isEmpty())
+		virtualizeLeastAudible(player->audibility(position_));
+
 	if (sourcesPool_.isEmpty() || players_.size() == sources_.size())
 	{
 		player->sourceId_ = InvalidSource;
+		if (player->isVirtual_ == false && player->isVirtualizable())
+		{
+			player->isVirtual_ = true;
+			player->virtualPosition_ = 0.0f;
+			virtualPlayers_.pushBack(player);
+		}
 		return;
 	}
 
 	const ALuint sourceId = sourcesPool_.back();
 	sourcesPool_.popBack();
 
+	const bool wasVirtual = player->isVirtual_;
+	if (wasVirtual)
+	{
+		removeVirtualPlayer(player);
+		player->isVirtual_ = false;
+	}
+
 	player->sourceId_ = sourceId;
 	players_.pushBack(player);
 
@@ -280,6 +365,8 @@ void ALAudioDevice::registerPlayer(IAudioPlayer *player)
 	hasExtension(ALExtensions::SOFT_DEFERRED_UPDATES) ? alDeferUpdatesSOFT() : alcSuspendContext(context_);
 #endif
 	player->applySourceProperties();
+	if (wasVirtual)
+		player->devirtualize();
 #ifdef WITH_OPENAL_EXT
 	hasExtension(ALExtensions::SOFT_DEFERRED_UPDATES) ? alProcessUpdatesSOFT() : alcProcessContext(context_);
 #endif
@@ -289,8 +376,15 @@ void ALAudioDevice::unregisterPlayer(IAudioPlayer *player)
 {
 	ASSERT(player);
 	ASSERT(players_.size() == sources_.size() - sourcesPool_.size());
-	ASSERT(player->sourceId_ != InvalidSource);
 
+	if (player != nullptr && player->isVirtual_)
+	{
+		removeVirtualPlayer(player);
+		player->isVirtual_ = false;
+		return;
+	}
+
+	ASSERT(player->sourceId_ != InvalidSource);
 	if (player == nullptr || player->sourceId_ == InvalidSource)
 		return;
 
@@ -309,6 +403,9 @@ void ALAudioDevice::unregisterPlayer(IAudioPlayer *player)
 
 void ALAudioDevice::updatePlayers()
 {
+	const float interval = lastUpdateTime_.secondsSince();
+	lastUpdateTime_ = TimeStamp::now();
+
 	for (unsigned int i = 0; i < players_.size(); i++)
 	{
 		IAudioPlayer *player = players_[i];
@@ -316,7 +413,17 @@ void ALAudioDevice::updatePlayers()
 		ASSERT(player->isSourceLocked() || player->isPlaying() || player->isPaused());
 
 		if (player->isPlaying())
-			player->updateState();
+		{
+			if (player->type() == AudioStreamPlayer::sType())
+			{
+				const AudioStreamPlayer *streamPlayer = static_cast<const AudioStreamPlayer *>(player);
+				const unsigned int numUnderruns = streamPlayer->numUnderruns();
+				player->updateState();
+				numStreamUnderruns_ += streamPlayer->numUnderruns() - numUnderruns;
+			}
+			else
+				player->updateState();
+		}
 	}
 
 	// Players that have just stopped are unregistered (in reverse order)
@@ -327,12 +434,101 @@ void ALAudioDevice::updatePlayers()
 		if (player->isStopped() && player->isSourceLocked() == false)
 			unregisterPlayer(player);
 	}
+
+	// Virtual players keep track of their playback position without a source (in reverse order)
+	for (int i = virtualPlayers_.size() - 1; i >= 0; i--)
+	{
+		IAudioPlayer *player = virtualPlayers_[i];
+		player->updateVirtualState(interval);
+
+		if (player->isStopped())
+		{
+			player->isVirtual_ = false;
+			virtualPlayers_.unorderedRemoveAt(i);
+		}
+	}
+
+	if (virtualPlayers_.isEmpty() == false)
+		devirtualizePlayers();
 }
 
 ///////////////////////////////////////////////////////////
 // PRIVATE FUNCTIONS
 ///////////////////////////////////////////////////////////
 
+bool ALAudioDevice::virtualizeLeastAudible(float audibility)
+{
+	IAudioPlayer *leastAudiblePlayer = nullptr;
+	float minAudibility = audibility - VirtualizationThreshold;
+	for (unsigned int i = 0; i < players_.size(); i++)
+	{
+		IAudioPlayer *player = players_[i];
+		if (player->isVirtualizable() == false || (player->isPlaying() == false && player->isPaused() == false))
+			continue;
+
+		const float playerAudibility = player->audibility(position_);
+		if (playerAudibility < minAudibility)
+		{
+			minAudibility = playerAudibility;
+			leastAudiblePlayer = player;
+		}
+	}
+
+	if (leastAudiblePlayer == nullptr)
+		return false;
+
+	// The player keeps its state, only the source is released to the pool
+	leastAudiblePlayer->virtualize();
+	unregisterPlayer(leastAudiblePlayer);
+	leastAudiblePlayer->isVirtual_ = true;
+	virtualPlayers_.pushBack(leastAudiblePlayer);
+
+	return true;
+}
+
+void ALAudioDevice::devirtualizePlayers()
+{
+	for (unsigned int i = 0; i < MaxDevirtualizationsPerUpdate; i++)
+	{
+		IAudioPlayer *mostAudiblePlayer = nullptr;
+		float maxAudibility = -1.0f;
+		for (unsigned int j = 0; j < virtualPlayers_.size(); j++)
+		{
+			IAudioPlayer *player = virtualPlayers_[j];
+			// Paused virtual players do not need a source until they resume playing
+			if (player->isPlaying() == false)
+				continue;
+
+			const float playerAudibility = player->audibility(position_);
+			if (playerAudibility > maxAudibility)
+			{
+				maxAudibility = playerAudibility;
+				mostAudiblePlayer = player;
+			}
+		}
+
+		if (mostAudiblePlayer == nullptr)
+			break;
+
+		// The player gets a free source or the one of a less audible player
+		registerPlayer(mostAudiblePlayer);
+		if (mostAudiblePlayer->isVirtual_)
+			break;
+	}
+}
+
+void ALAudioDevice::removeVirtualPlayer(IAudioPlayer *player)
+{
+	for (unsigned int i = 0; i < virtualPlayers_.size(); i++)
+	{
+		if (virtualPlayers_[i] == player)
+		{
+			virtualPlayers_.unorderedRemoveAt(i);
+			break;
+		}
+	}
+}
+
 void ALAudioDevice::retrieveAttributes()
 {
 	attributes_.deviceName = alcGetString(device_, ALC_DEVICE_SPECIFIER);
@@ -4,6 +4,11 @@
 #include <nctl/CString.h>
 #include "AudioBuffer.h"
 #include "IAudioLoader.h"
+#include "AudioBufferCache.h"
+#include "SoftwareAudioDevice.h"
+#include "Hash64.h"
+#include "FileSystem.h"
+#include "IFile.h"
 #include "tracy.h"
 
 namespace ncine {
@@ -23,6 +28,39 @@ namespace {
 		return format;
 	}
 
+	/// The samples are kept by the software audio device when there is one, and by an OpenAL buffer otherwise
+	void genBuffer(unsigned int &bufferId)
+	{
+		SoftwareAudioDevice *softwareDevice = SoftwareAudioDevice::instance();
+		if (softwareDevice != nullptr)
+		{
+			bufferId = softwareDevice->createBuffer();
+			return;
+		}
+
+		alGetError();
+		alGenBuffers(1, &bufferId);
+		const ALenum error = alGetError();
+		FATAL_ASSERT_MSG_X(error == AL_NO_ERROR, "alGenBuffers failed: 0x%x", error);
+
+		ASSERT(alIsBuffer(bufferId) == AL_TRUE);
+	}
+
+	void deleteBuffer(unsigned int bufferId)
+	{
+		SoftwareAudioDevice *softwareDevice = SoftwareAudioDevice::instance();
+		if (softwareDevice != nullptr)
+			softwareDevice->deleteBuffer(bufferId);
+		else
+			alDeleteBuffers(1, &bufferId);
+	}
+
+	/// Only decoded samples of compressed sources are worth saving on disk
+	bool isCompressedSource(const char *bufferName)
+	{
+		return (bufferName != nullptr && fs::hasExtension(bufferName, "ogg"));
+	}
+
 }
 
 ///////////////////////////////////////////////////////////
@@ -30,15 +68,10 @@ namespace {
 ///////////////////////////////////////////////////////////
 
 AudioBuffer::AudioBuffer()
-    : Object(ObjectType::AUDIOBUFFER), bufferId_(0),
+    : Object(ObjectType::AUDIOBUFFER), bufferId_(0), contentHash_(0),
       bytesPerSample_(0), numChannels_(0), frequency_(0), numSamples_(0), duration_(0.0f)
 {
-	alGetError();
-	alGenBuffers(1, &bufferId_);
-	const ALenum error = alGetError();
-	FATAL_ASSERT_MSG_X(error == AL_NO_ERROR, "alGenBuffers failed: 0x%x", error);
-
-	ASSERT(alIsBuffer(bufferId_) == AL_TRUE);
+	genBuffer(bufferId_);
 }
 
 AudioBuffer::AudioBuffer(const char *bufferName, const unsigned char *bufferPtr, unsigned long int bufferSize)
@@ -59,23 +92,26 @@ AudioBuffer::AudioBuffer(const char *filename)
 
 AudioBuffer::~AudioBuffer()
 {
-	// Moved out objects have their buffer id set to zero
-	alDeleteBuffers(1, &bufferId_);
+	releaseBuffer();
 }
 
 AudioBuffer::AudioBuffer(AudioBuffer &&other)
-    : Object(nctl::move(other)), bufferId_(other.bufferId_),
+    : Object(nctl::move(other)), bufferId_(other.bufferId_), contentHash_(other.contentHash_),
       bytesPerSample_(other.bytesPerSample_), numChannels_(other.numChannels_),
       frequency_(other.frequency_), numSamples_(other.numSamples_), duration_(other.duration_)
 {
 	other.bufferId_ = 0;
+	other.contentHash_ = 0;
 }
 
 AudioBuffer &AudioBuffer::operator=(AudioBuffer &&other)
 {
 	Object::operator=(nctl::move(other));
 
+	// The reference to a shared buffer would never be released otherwise
+	releaseBuffer();
 	bufferId_ = other.bufferId_;
+	contentHash_ = other.contentHash_;
 	bytesPerSample_ = other.bytesPerSample_;
 	numChannels_ = other.numChannels_;
 	frequency_ = other.frequency_;
@@ -83,6 +119,7 @@ AudioBuffer &AudioBuffer::operator=(AudioBuffer &&other)
 	duration_ = other.duration_;
 
 	other.bufferId_ = 0;
+	other.contentHash_ = 0;
 	return *this;
 }
 
@@ -134,6 +171,16 @@ bool AudioBuffer::loadFromMemory(const char *bufferName, const unsigned char *bu
 		ZoneText(bufferName, nctl::strnlen(bufferName, nctl::String::MaxCStringLength));
 	}
 
+	if (audioBufferCache().isEnabled())
+	{
+		const bool samplesHaveLoaded = loadCached(bufferName, bufferPtr, bufferSize);
+		if (samplesHaveLoaded == false)
+			return false;
+
+		setName(bufferName);
+		return true;
+	}
+
 	nctl::UniquePtr<IAudioLoader> audioLoader = IAudioLoader::createFromMemory(bufferName, bufferPtr, bufferSize);
 	if (audioLoader->hasLoaded() == false)
 		return false;
@@ -151,6 +198,35 @@ bool AudioBuffer::loadFromFile(const char *filename)
 	ZoneScoped;
 	ZoneText(filename, nctl::strnlen(filename, nctl::String::MaxCStringLength));
 
+	if (audioBufferCache().isEnabled())
+	{
+		// The file is read only once, both to hash its content and to decode it
+		nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(filename);
+		fileHandle->open(IFile::OpenMode::READ);
+		if (fileHandle->isOpened() == false)
+			return false;
+
+		const unsigned long int fileSize = fileHandle->size();
+		// The content of a mapped file is hashed and decoded without copying it
+		const unsigned char *fileBufferPtr = static_cast<const unsigned char *>(fileHandle->bufferPtr());
+		nctl::UniquePtr<unsigned char[]> fileBuffer;
+		if (fileBufferPtr == nullptr)
+		{
+			fileBuffer = nctl::makeUnique<unsigned char[]>(fileSize);
+			const unsigned long int bytesRead = fileHandle->read(fileBuffer.get(), fileSize);
+			fileHandle->close();
+			RETURNF_ASSERT_MSG_X(bytesRead == fileSize, "Cannot read all the %lu bytes of \"%s\"", fileSize, filename);
+			fileBufferPtr = fileBuffer.get();
+		}
+
+		const bool samplesHaveLoaded = loadCached(filename, fileBufferPtr, fileSize);
+		if (samplesHaveLoaded == false)
+			return false;
+
+		setName(filename);
+		return true;
+	}
+
 	nctl::UniquePtr<IAudioLoader> audioLoader = IAudioLoader::createFromFile(filename);
 	if (audioLoader->hasLoaded() == false)
 		return false;
@@ -163,25 +239,63 @@ bool AudioBuffer::loadFromFile(const char *filename)
 	return true;
 }
 
+/*! \note If the OpenAL buffer is shared with other buffers, a new one is created before loading the samples */
 bool AudioBuffer::loadFromSamples(const unsigned char *bufferPtr, unsigned long int bufferSize)
 {
 	if (bytesPerSample_ == 0 || numChannels_ == 0 || frequency_ == 0)
 		return false;
 
+	detachFromCache();
+
 	if (bufferSize % (bytesPerSample_ * numChannels_) != 0)
 		LOGW("Buffer size is incompatible with format");
-	const ALenum format = alFormat(bytesPerSample_, numChannels_);
 
-	alGetError();
-	// On iOS `alBufferDataStatic()` could be used instead
-	alBufferData(bufferId_, format, bufferPtr, bufferSize, frequency_);
-	const ALenum error = alGetError();
-	RETURNF_ASSERT_MSG_X(error == AL_NO_ERROR, "alBufferData failed: 0x%x", error);
+	SoftwareAudioDevice *softwareDevice = SoftwareAudioDevice::instance();
+	if (softwareDevice != nullptr)
+	{
+		const bool hasCopied = softwareDevice->setBufferData(bufferId_, bufferPtr, bufferSize, bytesPerSample_, numChannels_, frequency_);
+		RETURNF_ASSERT_MSG(hasCopied, "Cannot copy the samples to the software audio device");
+	}
+	else
+	{
+		const ALenum format = alFormat(bytesPerSample_, numChannels_);
+
+		alGetError();
+		// On iOS `alBufferDataStatic()` could be used instead
+		alBufferData(bufferId_, format, bufferPtr, bufferSize, frequency_);
+		const ALenum error = alGetError();
+		RETURNF_ASSERT_MSG_X(error == AL_NO_ERROR, "alBufferData failed: 0x%x", error);
+	}
 
 	numSamples_ = bufferSize / (numChannels_ * bytesPerSample_);
 	duration_ = float(numSamples_) / frequency_;
 
-	return (error == AL_NO_ERROR);
+	return true;
+}
+
+bool AudioBuffer::isCacheEnabled()
+{
+	return audioBufferCache().isEnabled();
+}
+
+void AudioBuffer::setCacheEnabled(bool enabled)
+{
+	audioBufferCache().setEnabled(enabled);
+}
+
+bool AudioBuffer::isDiskCacheEnabled()
+{
+	return audioBufferCache().isDiskCacheEnabled();
+}
+
+void AudioBuffer::setDiskCacheEnabled(bool enabled)
+{
+	audioBufferCache().setDiskCacheEnabled(enabled);
+}
+
+unsigned int AudioBuffer::clearDiskCache()
+{
+	return audioBufferCache().clearDisk();
 }
 
 ///////////////////////////////////////////////////////////
@@ -189,6 +303,16 @@ bool AudioBuffer::loadFromSamples(const unsigned char *bufferPtr, unsigned long
 ///////////////////////////////////////////////////////////
 
 bool AudioBuffer::load(IAudioLoader &audioLoader)
+{
+	nctl::UniquePtr<unsigned char[]> samples;
+	unsigned long int samplesSize = 0;
+	if (decode(audioLoader, samples, samplesSize) == false)
+		return false;
+
+	return loadFromSamples(samples.get(), samplesSize);
+}
+
+bool AudioBuffer::decode(IAudioLoader &audioLoader, nctl::UniquePtr<unsigned char[]> &samples, unsigned long int &samplesSize)
 {
 	RETURNF_ASSERT_MSG_X(audioLoader.bytesPerSample() == 1 || audioLoader.bytesPerSample() == 2,
 	                     "Unsupported number of bytes per sample: %d", audioLoader.bytesPerSample());
@@ -200,13 +324,112 @@ bool AudioBuffer::load(IAudioLoader &audioLoader)
 	frequency_ = audioLoader.frequency();
 
 	// Buffer size calculated as samples * channels * bytes per samples
-	const unsigned long int bufferSize = audioLoader.bufferSize();
-	nctl::UniquePtr<unsigned char[]> buffer = nctl::makeUnique<unsigned char[]>(bufferSize);
+	samplesSize = audioLoader.bufferSize();
+	samples = nctl::makeUnique<unsigned char[]>(samplesSize);
 
 	nctl::UniquePtr<IAudioReader> audioReader = audioLoader.createReader();
-	audioReader->read(buffer.get(), bufferSize);
+	audioReader->read(samples.get(), samplesSize);
+
+	return true;
+}
+
+bool AudioBuffer::loadCached(const char *bufferName, const unsigned char *bufferPtr, unsigned long int bufferSize)
+{
+	AudioBufferCache &cache = audioBufferCache();
+	const uint64_t hash = hash64().hashBuffer(bufferPtr, bufferSize);
+
+	if (acquireCached(hash))
+		return true;
+
+	ZoneScopedN("Decode and cache");
+	AudioBufferCache::Entry entry;
+	nctl::UniquePtr<unsigned char[]> samples;
+	unsigned long int samplesSize = 0;
+	const bool isCompressed = isCompressedSource(bufferName);
+	if (isCompressed && cache.loadFromDisk(hash, entry, samples, samplesSize))
+	{
+		bytesPerSample_ = entry.bytesPerSample;
+		numChannels_ = entry.numChannels;
+		frequency_ = entry.frequency;
+	}
+	else
+	{
+		nctl::UniquePtr<IAudioLoader> audioLoader = IAudioLoader::createFromMemory(bufferName, bufferPtr, bufferSize);
+		if (audioLoader->hasLoaded() == false)
+			return false;
+
+		if (decode(*audioLoader.get(), samples, samplesSize) == false)
+			return false;
+
+		entry.bytesPerSample = bytesPerSample_;
+		entry.numChannels = numChannels_;
+		entry.frequency = frequency_;
+		if (isCompressed)
+			cache.saveToDisk(hash, entry, samples.get(), samplesSize);
+	}
+
+	return loadDecoded(hash, samples.get(), samplesSize);
+}
+
+bool AudioBuffer::acquireCached(uint64_t hash)
+{
+	AudioBufferCache::Entry entry;
+	if (audioBufferCache().acquire(hash, entry) == false)
+		return false;
+
+	// The reference to the new buffer is acquired before releasing the old one, in case they are the same
+	releaseBuffer();
+	bufferId_ = entry.bufferId;
+	contentHash_ = hash;
+	bytesPerSample_ = entry.bytesPerSample;
+	numChannels_ = entry.numChannels;
+	frequency_ = entry.frequency;
+	numSamples_ = entry.numSamples;
+	duration_ = float(numSamples_) / frequency_;
+	return true;
+}
+
+bool AudioBuffer::loadDecoded(uint64_t hash, const unsigned char *samples, unsigned long int samplesSize)
+{
+	if (loadFromSamples(samples, samplesSize) == false)
+		return false;
+
+	if (hash != 0)
+	{
+		AudioBufferCache::Entry entry;
+		entry.bufferId = bufferId_;
+		entry.bytesPerSample = bytesPerSample_;
+		entry.numChannels = numChannels_;
+		entry.frequency = frequency_;
+		entry.numSamples = numSamples_;
+		audioBufferCache().insert(hash, entry);
+		contentHash_ = hash;
+	}
+
+	return true;
+}
+
+void AudioBuffer::detachFromCache()
+{
+	if (contentHash_ == 0)
+		return;
+
+	// When the last reference is released the OpenAL buffer is not shared anymore and can be reused
+	const bool wasLastReference = audioBufferCache().release(contentHash_);
+	if (wasLastReference == false)
+		genBuffer(bufferId_);
+	contentHash_ = 0;
+}
+
+void AudioBuffer::releaseBuffer()
+{
+	// Moved out objects have their buffer id set to zero
+	const bool isLastReference = (contentHash_ == 0 || audioBufferCache().release(contentHash_));
+	if (isLastReference)
+		deleteBuffer(bufferId_);
 
-	return loadFromSamples(buffer.get(), bufferSize);
+	bufferId_ = 0;
+	contentHash_ = 0;
 }
 
 }
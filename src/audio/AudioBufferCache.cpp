@@ -0,0 +1,240 @@
+#include <cstring> // for memcmp() and memcpy()
+#include <nctl/CString.h>
+#include "common_macros.h"
+#include "AudioBufferCache.h"
+#include "FileSystem.h"
+#include "IFile.h"
+#include "tracy.h"
+
+namespace ncine {
+
+namespace {
+
+	const char *DirectoryName = "nCineAudioCache";
+	/// The filename of decoded samples is the content hash followed by the extension
+	const char *PcmFilenameFormat = "%016llx.pcm";
+	const char PcmMagic[4] = { 'N', 'P', 'C', 'M' };
+	const uint32_t PcmVersion = 1;
+
+	struct PcmHeader
+	{
+		char magic[4];
+		uint32_t version;
+		uint64_t hash;
+		int32_t bytesPerSample;
+		int32_t numChannels;
+		int32_t frequency;
+		uint32_t reserved;
+		uint64_t samplesSize;
+	};
+
+	nctl::String pcmFilePath(const nctl::String &directory, uint64_t hash)
+	{
+		nctl::String filename(32);
+		filename.format(PcmFilenameFormat, static_cast<unsigned long long>(hash));
+		return fs::joinPath(directory, filename);
+	}
+
+	bool isPcmFilename(const char *filename)
+	{
+		// The length of a decoded samples filename is: 16 + ".pcm"
+		return (nctl::strnlen(filename, 32) == 20 && fs::hasExtension(filename, "pcm"));
+	}
+
+}
+
+AudioBufferCache &audioBufferCache()
+{
+	static AudioBufferCache instance;
+	return instance;
+}
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+AudioBufferCache::AudioBufferCache()
+    : isEnabled_(true), isDiskCacheAvailable_(false), isDiskCacheEnabled_(false), entries_(32)
+{
+	const bool cacheDirWriteable = fs::isDirectory(fs::cachePath().data()) && fs::isWritable(fs::cachePath().data());
+	directory_ = fs::joinPath(fs::cachePath(), DirectoryName);
+	isDiskCacheAvailable_ = cacheDirWriteable;
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void AudioBufferCache::setDiskCacheEnabled(bool enabled)
+{
+	if (enabled && isDiskCacheAvailable_ && fs::isDirectory(directory_.data()) == false)
+	{
+		fs::createDir(directory_.data());
+		if (fs::isDirectory(directory_.data()) == false)
+		{
+			LOGW_X("Cannot create the audio cache directory \"%s\"", directory_.data());
+			isDiskCacheAvailable_ = false;
+		}
+	}
+
+	isDiskCacheEnabled_ = enabled && isDiskCacheAvailable_;
+}
+
+bool AudioBufferCache::acquire(uint64_t hash, Entry &entry)
+{
+	if (isEnabled_ == false || hash == 0)
+		return false;
+
+	Entry *cachedEntry = entries_.find(hash);
+	if (cachedEntry == nullptr)
+	{
+		statistics_.Misses++;
+		return false;
+	}
+
+	cachedEntry->refCount++;
+	statistics_.Hits++;
+	entry = *cachedEntry;
+	return true;
+}
+
+void AudioBufferCache::insert(uint64_t hash, const Entry &entry)
+{
+	ASSERT(hash != 0);
+	ASSERT(entries_.find(hash) == nullptr);
+
+	if (entries_.loadFactor() >= 0.8f)
+		entries_.rehash(entries_.capacity() * 2);
+
+	Entry newEntry(entry);
+	newEntry.refCount = 1;
+	entries_.insert(hash, newEntry);
+	statistics_.SharedBuffers = entries_.size();
+}
+
+/*! \note A hash that is not in the cache is not shared, and its OpenAL buffer can be deleted */
+bool AudioBufferCache::release(uint64_t hash)
+{
+	Entry *entry = entries_.find(hash);
+	if (entry == nullptr)
+		return true;
+
+	ASSERT(entry->refCount > 0);
+	entry->refCount--;
+	if (entry->refCount > 0)
+		return false;
+
+	entries_.remove(hash);
+	statistics_.SharedBuffers = entries_.size();
+	return true;
+}
+
+bool AudioBufferCache::loadFromDisk(uint64_t hash, Entry &entry, nctl::UniquePtr<unsigned char[]> &samples, unsigned long int &samplesSize)
+{
+	if (isDiskCacheEnabled_ == false)
+		return false;
+
+	const nctl::String filePath = pcmFilePath(directory_, hash);
+	if (fs::isReadableFile(filePath.data()) == false)
+		return false;
+
+	ZoneScoped;
+	nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(filePath.data());
+	fileHandle->open(IFile::OpenMode::READ);
+	if (fileHandle->isOpened() == false)
+		return false;
+
+	PcmHeader header;
+	const unsigned long int headerBytes = fileHandle->read(&header, sizeof(PcmHeader));
+	const bool headerIsValid = (headerBytes == sizeof(PcmHeader) && memcmp(header.magic, PcmMagic, sizeof(PcmMagic)) == 0 &&
+	                            header.version == PcmVersion && header.hash == hash &&
+	                            (header.bytesPerSample == 1 || header.bytesPerSample == 2) &&
+	                            (header.numChannels == 1 || header.numChannels == 2) && header.frequency > 0 &&
+	                            fileHandle->size() == sizeof(PcmHeader) + header.samplesSize);
+	if (headerIsValid == false)
+	{
+		LOGW_X("Decoded samples file \"%s\" is not valid", filePath.data());
+		fileHandle->close();
+		fs::deleteFile(filePath.data());
+		return false;
+	}
+
+	samplesSize = static_cast<unsigned long int>(header.samplesSize);
+	samples = nctl::makeUnique<unsigned char[]>(samplesSize);
+	const unsigned long int samplesBytes = fileHandle->read(samples.get(), samplesSize);
+	fileHandle->close();
+	if (samplesBytes != samplesSize)
+		return false;
+
+	entry.bytesPerSample = header.bytesPerSample;
+	entry.numChannels = header.numChannels;
+	entry.frequency = header.frequency;
+	entry.numSamples = samplesSize / (header.bytesPerSample * header.numChannels);
+
+	statistics_.DiskHits++;
+	return true;
+}
+
+bool AudioBufferCache::saveToDisk(uint64_t hash, const Entry &entry, const unsigned char *samples, unsigned long int samplesSize)
+{
+	if (isDiskCacheEnabled_ == false || samples == nullptr || samplesSize == 0)
+		return false;
+
+	ZoneScoped;
+	const nctl::String filePath = pcmFilePath(directory_, hash);
+	nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(filePath.data());
+	fileHandle->open(IFile::OpenMode::WRITE);
+	if (fileHandle->isOpened() == false)
+	{
+		LOGW_X("Cannot save decoded samples to \"%s\"", filePath.data());
+		return false;
+	}
+
+	PcmHeader header;
+	memcpy(header.magic, PcmMagic, sizeof(PcmMagic));
+	header.version = PcmVersion;
+	header.hash = hash;
+	header.bytesPerSample = entry.bytesPerSample;
+	header.numChannels = entry.numChannels;
+	header.frequency = entry.frequency;
+	header.reserved = 0;
+	header.samplesSize = samplesSize;
+
+	unsigned long int writtenBytes = fileHandle->write(&header, sizeof(PcmHeader));
+	writtenBytes += fileHandle->write(samples, samplesSize);
+	fileHandle->close();
+
+	if (writtenBytes != sizeof(PcmHeader) + samplesSize)
+	{
+		// A truncated file would be detected as invalid anyway, but it would waste space until then
+		fs::deleteFile(filePath.data());
+		return false;
+	}
+
+	statistics_.DiskWrites++;
+	return true;
+}
+
+unsigned int AudioBufferCache::clearDisk()
+{
+	if (fs::isDirectory(directory_.data()) == false)
+		return 0;
+
+	unsigned int numDeleted = 0;
+	nctl::String filePath(fs::MaxPathLength);
+	fs::Directory dir(directory_.data());
+	while (const char *entryName = dir.readNext())
+	{
+		if (isPcmFilename(entryName))
+		{
+			filePath = fs::joinPath(directory_, entryName);
+			if (fs::deleteFile(filePath.data()))
+				numDeleted++;
+		}
+	}
+	dir.close();
+
+	return numDeleted;
+}
+
+}
@@ -1,5 +1,6 @@
 #define NCINE_INCLUDE_OPENAL
 #include "common_headers.h"
+#include <cmath> // for `fmodf()`
 #include "AudioBufferPlayer.h"
 #include "AudioBuffer.h"
 
@@ -86,17 +87,17 @@ void AudioBufferPlayer::play()
 			if (sourceId_ == IAudioDevice::InvalidSource)
 			{
 				IAudioDevice &device = theServiceLocator().audioDevice();
-				if (device.numAvailableSources() == 0)
+				device.registerPlayer(this); // It also assigns `sourceId_` or makes the player virtual
+				if (sourceId_ == IAudioDevice::InvalidSource && isVirtual_ == false)
 				{
 					LOGW("No more available audio sources for playing the buffer");
 					return;
 				}
-
-				device.registerPlayer(this); // It also assigns `sourceId_`
-				ASSERT(sourceId_ != IAudioDevice::InvalidSource);
 			}
 
-			if (sourceId_ != IAudioDevice::InvalidSource)
+			if (isVirtual_)
+				state_ = PlayerState::PLAYING;
+			else if (sourceId_ != IAudioDevice::InvalidSource)
 			{
 				alSourcei(sourceId_, AL_BUFFER, audioBuffer_->bufferId());
 				// Setting OpenAL source looping only if not streaming
@@ -111,7 +112,9 @@ void AudioBufferPlayer::play()
 			break;
 		case PlayerState::PAUSED:
 		{
-			alSourcePlay(sourceId_);
+			// A virtual player gets a source back when the device updates its players
+			if (isVirtual_ == false)
+				alSourcePlay(sourceId_);
 			state_ = PlayerState::PLAYING;
 			break;
 		}
@@ -127,7 +130,8 @@ void AudioBufferPlayer::pause()
 			break;
 		case PlayerState::PLAYING:
 		{
-			alSourcePause(sourceId_);
+			if (isVirtual_ == false)
+				alSourcePause(sourceId_);
 			state_ = PlayerState::PAUSED;
 			break;
 		}
@@ -146,11 +150,15 @@ void AudioBufferPlayer::stop()
 		case PlayerState::PLAYING:
 		case PlayerState::PAUSED:
 		{
-			alSourceStop(sourceId_);
-			// Detach the buffer from source
-			alSourcei(sourceId_, AL_BUFFER, 0);
+			if (isVirtual_ == false)
+			{
+				alSourceStop(sourceId_);
+				// Detach the buffer from source
+				alSourcei(sourceId_, AL_BUFFER, 0);
+			}
 
-			if (sourceLocked_ == false)
+			// Virtual players are never locked and need to be removed from the device
+			if (sourceLocked_ == false || isVirtual_)
 			{
 				IAudioDevice &device = theServiceLocator().audioDevice();
 				device.unregisterPlayer(this); // It also resets `sourceId_`
@@ -183,4 +191,53 @@ void AudioBufferPlayer::updateState()
 	}
 }
 
+bool AudioBufferPlayer::isVirtualizable() const
+{
+	return (sourceLocked_ == false && audioBuffer_ != nullptr && audioBuffer_->frequency() > 0);
+}
+
+void AudioBufferPlayer::virtualize()
+{
+	ASSERT(hasSource());
+
+	ALint sampleOffset = 0;
+	alGetSourcei(sourceId_, AL_SAMPLE_OFFSET, &sampleOffset);
+	virtualPosition_ = sampleOffset / static_cast<float>(audioBuffer_->frequency());
+
+	alSourceStop(sourceId_);
+	// Detach the buffer from source
+	alSourcei(sourceId_, AL_BUFFER, 0);
+}
+
+/*! \note The sample offset of a source that is not playing is applied when it starts */
+void AudioBufferPlayer::devirtualize()
+{
+	ASSERT(hasSource());
+
+	alSourcei(sourceId_, AL_BUFFER, audioBuffer_->bufferId());
+	alSourcei(sourceId_, AL_LOOPING, isLooping_);
+	alSourcei(sourceId_, AL_SAMPLE_OFFSET, static_cast<ALint>(virtualPosition_ * audioBuffer_->frequency()));
+	if (state_ == PlayerState::PLAYING)
+		alSourcePlay(sourceId_);
+}
+
+void AudioBufferPlayer::updateVirtualState(float interval)
+{
+	if (state_ != PlayerState::PLAYING)
+		return;
+
+	virtualPosition_ += interval * pitch_;
+	const float duration = audioBuffer_->duration();
+	if (virtualPosition_ >= duration)
+	{
+		if (isLooping_ && duration > 0.0f)
+			virtualPosition_ = fmodf(virtualPosition_, duration);
+		else
+		{
+			virtualPosition_ = 0.0f;
+			state_ = PlayerState::STOPPED;
+		}
+	}
+}
+
 }
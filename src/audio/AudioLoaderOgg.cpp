@@ -31,6 +31,33 @@ namespace {
 	}
 
 	const ov_callbacks fileCallbacks = { fileRead, fileSeek, fileClose, fileTell };
+
+	size_t bufferRead(void *ptr, size_t size, size_t nmemb, void *datasource)
+	{
+		OggReadAheadBuffer *buffer = static_cast<OggReadAheadBuffer *>(datasource);
+		return buffer->read(ptr, size * nmemb);
+	}
+
+	int bufferSeek(void *datasource, ogg_int64_t offset, int whence)
+	{
+		OggReadAheadBuffer *buffer = static_cast<OggReadAheadBuffer *>(datasource);
+		return buffer->seek(static_cast<long int>(offset), whence);
+	}
+
+	int bufferClose(void *datasource)
+	{
+		OggReadAheadBuffer *buffer = static_cast<OggReadAheadBuffer *>(datasource);
+		buffer->close();
+		return 0;
+	}
+
+	long bufferTell(void *datasource)
+	{
+		OggReadAheadBuffer *buffer = static_cast<OggReadAheadBuffer *>(datasource);
+		return buffer->tell();
+	}
+
+	const ov_callbacks bufferCallbacks = { bufferRead, bufferSeek, bufferClose, bufferTell };
 }
 
 ///////////////////////////////////////////////////////////
@@ -52,7 +79,17 @@ AudioLoaderOgg::AudioLoaderOgg(nctl::UniquePtr<IFile> fileHandle)
 #endif
 		fileHandle_->open(IFile::OpenMode::READ | IFile::OpenMode::BINARY);
 
-	if (ov_open_callbacks(fileHandle_.get(), &oggFile_, nullptr, 0, fileCallbacks) != 0)
+	// Compressed data is already in memory for memory files, there is no need to read it ahead
+	int openResult = -1;
+	if (fileHandle_->isOpened() && fileHandle_->type() != IFile::FileType::MEMORY)
+	{
+		readAheadBuffer_ = nctl::makeUnique<OggReadAheadBuffer>(fileHandle_.get());
+		openResult = ov_open_callbacks(readAheadBuffer_.get(), &oggFile_, nullptr, 0, bufferCallbacks);
+	}
+	else
+		openResult = ov_open_callbacks(fileHandle_.get(), &oggFile_, nullptr, 0, fileCallbacks);
+
+	if (openResult != 0)
 	{
 		LOGF_X("Cannot open \"%s\" with ov_open_callbacks()", fileHandle_->filename());
 		fileHandle_->close();
@@ -88,7 +125,7 @@ AudioLoaderOgg::~AudioLoaderOgg()
 
 nctl::UniquePtr<IAudioReader> AudioLoaderOgg::createReader()
 {
-	return nctl::makeUnique<AudioReaderOgg>(nctl::move(fileHandle_), oggFile_);
+	return nctl::makeUnique<AudioReaderOgg>(nctl::move(fileHandle_), nctl::move(readAheadBuffer_), oggFile_);
 }
 
 }
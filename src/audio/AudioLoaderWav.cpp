@@ -45,7 +45,7 @@ AudioLoaderWav::AudioLoaderWav(nctl::UniquePtr<IFile> fileHandle)
 
 nctl::UniquePtr<IAudioReader> AudioLoaderWav::createReader()
 {
-	return nctl::makeUnique<AudioReaderWav>(nctl::move(fileHandle_));
+	return nctl::makeUnique<AudioReaderWav>(nctl::move(fileHandle_), numChannels_ * bytesPerSample_);
 }
 
 }
@@ -0,0 +1,433 @@
+#include <cmath> // for `cosf()`, `sinf()` and `lrintf()`
+#include <cstring> // for `memset()` and `memcpy()`
+#include "common_macros.h"
+#include "AudioMixer.h"
+#include "IFile.h"
+#include "tracy.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define NCINE_MIXER_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	#include <arm_neon.h>
+	#define NCINE_MIXER_NEON
+#endif
+
+namespace ncine {
+
+namespace {
+
+	const float Int16ToFloat = 1.0f / 32768.0f;
+	const float FloatToInt16 = 32767.0f;
+	const float QuarterPi = 0.78539816f;
+
+	/// The header of a 16 bits stereo PCM WAV file
+	struct WavHeader
+	{
+		char chunkId[4];
+		uint32_t chunkSize;
+		char format[4];
+
+		char subchunk1Id[4];
+		uint32_t subchunk1Size;
+		uint16_t audioFormat;
+		uint16_t numChannels;
+		uint32_t sampleRate;
+		uint32_t byteRate;
+		uint16_t blockAlign;
+		uint16_t bitsPerSample;
+
+		char subchunk2Id[4];
+		uint32_t subchunk2Size;
+	};
+
+	const unsigned int WavNumChannels = 2;
+	const unsigned int WavBytesPerFrame = WavNumChannels * sizeof(int16_t);
+
+	void convertFromInt16(const int16_t *input, float *output, unsigned int numSamples)
+	{
+		unsigned int i = 0;
+#if defined(NCINE_MIXER_SSE2)
+		const __m128 scale = _mm_set1_ps(Int16ToFloat);
+		for (; i + 8 <= numSamples; i += 8)
+		{
+			const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+			// Sign extending the 16 bits integers by interleaving them with their sign mask
+			const __m128i sign = _mm_srai_epi16(samples, 15);
+			const __m128i low = _mm_unpacklo_epi16(samples, sign);
+			const __m128i high = _mm_unpackhi_epi16(samples, sign);
+			_mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+			_mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+		}
+#elif defined(NCINE_MIXER_NEON)
+		for (; i + 8 <= numSamples; i += 8)
+		{
+			const int16x8_t samples = vld1q_s16(input + i);
+			vst1q_f32(output + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(samples))), Int16ToFloat));
+			vst1q_f32(output + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(samples))), Int16ToFloat));
+		}
+#endif
+		for (; i < numSamples; i++)
+			output[i] = input[i] * Int16ToFloat;
+	}
+
+}
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+WavAudioSink::WavAudioSink(const char *filename, int frequency)
+    : frequency_(frequency), numFrames_(0)
+{
+	ASSERT(filename);
+	ASSERT(frequency > 0);
+
+	fileHandle_ = IFile::createFileHandle(filename);
+	fileHandle_->open(IFile::OpenMode::WRITE);
+	if (fileHandle_->isOpened() == false)
+	{
+		LOGE_X("Cannot open the WAV file \"%s\" for writing", filename);
+		fileHandle_.reset(nullptr);
+		return;
+	}
+
+	// The sizes in the header are updated when the sink is closed
+	writeHeader();
+}
+
+WavAudioSink::~WavAudioSink()
+{
+	close();
+}
+
+AudioMixer::AudioMixer(int outputFrequency, unsigned int maxFramesPerMix)
+    : outputFrequency_(outputFrequency), maxFramesPerMix_(maxFramesPerMix), voices_(16)
+{
+	ASSERT(outputFrequency > 0);
+	ASSERT(maxFramesPerMix > 0);
+
+	// Resampled voices are at most stereo, like the mixed output
+	voiceBuffer_ = nctl::makeUnique<float[]>(maxFramesPerMix_ * 2);
+	mixBuffer_ = nctl::makeUnique<float[]>(maxFramesPerMix_ * 2);
+	renderBuffer_ = nctl::makeUnique<int16_t[]>(maxFramesPerMix_ * 2);
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool WavAudioSink::write(const int16_t *frames, unsigned int numFrames)
+{
+	if (fileHandle_ == nullptr)
+		return false;
+
+	const unsigned long int numBytes = numFrames * WavBytesPerFrame;
+	const unsigned long int writtenBytes = fileHandle_->write(frames, numBytes);
+	numFrames_ += writtenBytes / WavBytesPerFrame;
+
+	return (writtenBytes == numBytes);
+}
+
+void WavAudioSink::close()
+{
+	if (fileHandle_ == nullptr)
+		return;
+
+	fileHandle_->seek(0, SEEK_SET);
+	writeHeader();
+	fileHandle_->close();
+	fileHandle_.reset(nullptr);
+}
+
+int AudioMixer::addVoice(const int16_t *samples, unsigned long int numFrames, int numChannels, int frequency)
+{
+	ASSERT(samples);
+	if (samples == nullptr || numFrames == 0 || frequency <= 0)
+		return -1;
+	if (numChannels != 1 && numChannels != 2)
+	{
+		LOGW_X("Unsupported number of channels: %d", numChannels);
+		return -1;
+	}
+
+	// Handles of removed voices are reused
+	unsigned int index = 0;
+	while (index < voices_.size() && voices_[index].isUsed)
+		index++;
+	if (index == voices_.size())
+		voices_.emplaceBack();
+
+	Voice &newVoice = voices_[index];
+	newVoice = Voice();
+	newVoice.samples = samples;
+	newVoice.numFrames = numFrames;
+	newVoice.numChannels = numChannels;
+	newVoice.frequency = frequency;
+	newVoice.isUsed = true;
+
+	return static_cast<int>(index);
+}
+
+void AudioMixer::removeVoice(int handle)
+{
+	Voice *removedVoice = voice(handle);
+	if (removedVoice)
+		*removedVoice = Voice();
+}
+
+AudioMixer::Voice *AudioMixer::voice(int handle)
+{
+	if (handle < 0 || static_cast<unsigned int>(handle) >= voices_.size() || voices_[handle].isUsed == false)
+		return nullptr;
+
+	return &voices_[handle];
+}
+
+unsigned int AudioMixer::numPlayingVoices() const
+{
+	unsigned int count = 0;
+	for (unsigned int i = 0; i < voices_.size(); i++)
+	{
+		if (voices_[i].isUsed && voices_[i].isPlaying)
+			count++;
+	}
+	return count;
+}
+
+/*! \note Voices that reach their end without looping stop playing, the rest of the output is left silent */
+unsigned int AudioMixer::mix(float *output, unsigned int numFrames)
+{
+	ZoneScoped;
+	memset(output, 0, numFrames * 2 * sizeof(float));
+
+	for (unsigned int offset = 0; offset < numFrames; offset += maxFramesPerMix_)
+	{
+		const unsigned int chunkFrames = (numFrames - offset < maxFramesPerMix_) ? numFrames - offset : maxFramesPerMix_;
+		float *chunkOutput = output + offset * 2;
+
+		for (unsigned int i = 0; i < voices_.size(); i++)
+		{
+			Voice &v = voices_[i];
+			if (v.isUsed == false || v.isPlaying == false)
+				continue;
+
+			const double step = (static_cast<double>(v.frequency) * v.pitch) / outputFrequency_;
+			unsigned int numVoiceFrames = 0;
+			v.position = resample(v, step, voiceBuffer_.get(), chunkFrames, numVoiceFrames);
+			if (numVoiceFrames < chunkFrames)
+			{
+				v.isPlaying = false;
+				v.position = 0.0;
+			}
+
+			if (v.numChannels == 1)
+			{
+				// Equal power panning keeps the perceived loudness constant
+				const float angle = (v.pan + 1.0f) * QuarterPi;
+				mixMono(voiceBuffer_.get(), chunkOutput, numVoiceFrames, v.gain * cosf(angle), v.gain * sinf(angle));
+			}
+			else
+			{
+				// Stereo voices are balanced by attenuating the opposite channel
+				const float gainLeft = (v.pan > 0.0f) ? v.gain * (1.0f - v.pan) : v.gain;
+				const float gainRight = (v.pan < 0.0f) ? v.gain * (1.0f + v.pan) : v.gain;
+				mixStereo(voiceBuffer_.get(), chunkOutput, numVoiceFrames, gainLeft, gainRight);
+			}
+		}
+	}
+
+	return numFrames;
+}
+
+unsigned long int AudioMixer::render(IAudioSink &sink, unsigned long int numFrames)
+{
+	unsigned long int numRenderedFrames = 0;
+	while (numRenderedFrames < numFrames)
+	{
+		const unsigned long int remainingFrames = numFrames - numRenderedFrames;
+		const unsigned int chunkFrames = (remainingFrames < maxFramesPerMix_) ? static_cast<unsigned int>(remainingFrames) : maxFramesPerMix_;
+
+		mix(mixBuffer_.get(), chunkFrames);
+		convertToInt16(mixBuffer_.get(), renderBuffer_.get(), chunkFrames * 2);
+		if (sink.write(renderBuffer_.get(), chunkFrames) == false)
+			break;
+
+		numRenderedFrames += chunkFrames;
+	}
+
+	return numRenderedFrames;
+}
+
+/*! \note When the step is one there is no interpolation and the samples are only converted */
+double AudioMixer::resample(const Voice &voice, double step, float *output, unsigned int numFrames, unsigned int &numOutputFrames)
+{
+	const unsigned int numChannels = static_cast<unsigned int>(voice.numChannels);
+	double position = voice.position;
+	numOutputFrames = 0;
+
+	const unsigned long int startFrame = static_cast<unsigned long int>(position);
+	if (step == 1.0 && position == static_cast<double>(startFrame))
+	{
+		unsigned long int frame = startFrame;
+		while (numOutputFrames < numFrames)
+		{
+			if (frame >= voice.numFrames)
+			{
+				if (voice.isLooping == false)
+					break;
+				frame = 0;
+			}
+
+			const unsigned long int availableFrames = voice.numFrames - frame;
+			const unsigned int remainingFrames = numFrames - numOutputFrames;
+			const unsigned int copyFrames = (availableFrames < remainingFrames) ? static_cast<unsigned int>(availableFrames) : remainingFrames;
+			convertFromInt16(voice.samples + frame * numChannels, output + numOutputFrames * numChannels, copyFrames * numChannels);
+
+			frame += copyFrames;
+			numOutputFrames += copyFrames;
+		}
+
+		return static_cast<double>(frame);
+	}
+
+	const double endPosition = static_cast<double>(voice.numFrames);
+	for (; numOutputFrames < numFrames; numOutputFrames++)
+	{
+		if (position >= endPosition)
+		{
+			if (voice.isLooping == false)
+				break;
+			position -= endPosition;
+		}
+
+		const unsigned long int frame = static_cast<unsigned long int>(position);
+		const float fraction = static_cast<float>(position - frame);
+		unsigned long int nextFrame = frame + 1;
+		if (nextFrame >= voice.numFrames)
+			nextFrame = voice.isLooping ? 0 : frame;
+
+		const int16_t *current = voice.samples + frame * numChannels;
+		const int16_t *next = voice.samples + nextFrame * numChannels;
+		for (unsigned int ch = 0; ch < numChannels; ch++)
+			output[numOutputFrames * numChannels + ch] = (current[ch] + (next[ch] - current[ch]) * fraction) * Int16ToFloat;
+
+		position += step;
+	}
+
+	return position;
+}
+
+void AudioMixer::mixMono(const float *input, float *output, unsigned int numFrames, float gainLeft, float gainRight)
+{
+	unsigned int i = 0;
+#if defined(NCINE_MIXER_SSE2)
+	const __m128 left = _mm_set1_ps(gainLeft);
+	const __m128 right = _mm_set1_ps(gainRight);
+	for (; i + 4 <= numFrames; i += 4)
+	{
+		const __m128 samples = _mm_loadu_ps(input + i);
+		const __m128 leftSamples = _mm_mul_ps(samples, left);
+		const __m128 rightSamples = _mm_mul_ps(samples, right);
+		// Interleaving the four left and right samples into four stereo frames
+		float *out = output + i * 2;
+		_mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), _mm_unpacklo_ps(leftSamples, rightSamples)));
+		_mm_storeu_ps(out + 4, _mm_add_ps(_mm_loadu_ps(out + 4), _mm_unpackhi_ps(leftSamples, rightSamples)));
+	}
+#elif defined(NCINE_MIXER_NEON)
+	for (; i + 4 <= numFrames; i += 4)
+	{
+		const float32x4_t samples = vld1q_f32(input + i);
+		float32x4x2_t frames = vld2q_f32(output + i * 2);
+		frames.val[0] = vmlaq_n_f32(frames.val[0], samples, gainLeft);
+		frames.val[1] = vmlaq_n_f32(frames.val[1], samples, gainRight);
+		vst2q_f32(output + i * 2, frames);
+	}
+#endif
+	for (; i < numFrames; i++)
+	{
+		output[i * 2] += input[i] * gainLeft;
+		output[i * 2 + 1] += input[i] * gainRight;
+	}
+}
+
+void AudioMixer::mixStereo(const float *input, float *output, unsigned int numFrames, float gainLeft, float gainRight)
+{
+	const unsigned int numSamples = numFrames * 2;
+	unsigned int i = 0;
+#if defined(NCINE_MIXER_SSE2)
+	const __m128 gains = _mm_setr_ps(gainLeft, gainRight, gainLeft, gainRight);
+	for (; i + 4 <= numSamples; i += 4)
+		_mm_storeu_ps(output + i, _mm_add_ps(_mm_loadu_ps(output + i), _mm_mul_ps(_mm_loadu_ps(input + i), gains)));
+#elif defined(NCINE_MIXER_NEON)
+	const float gainValues[4] = { gainLeft, gainRight, gainLeft, gainRight };
+	const float32x4_t gains = vld1q_f32(gainValues);
+	for (; i + 4 <= numSamples; i += 4)
+		vst1q_f32(output + i, vmlaq_f32(vld1q_f32(output + i), vld1q_f32(input + i), gains));
+#endif
+	for (; i < numSamples; i += 2)
+	{
+		output[i] += input[i] * gainLeft;
+		output[i + 1] += input[i + 1] * gainRight;
+	}
+}
+
+void AudioMixer::convertToInt16(const float *input, int16_t *output, unsigned int numSamples)
+{
+	unsigned int i = 0;
+#if defined(NCINE_MIXER_SSE2)
+	const __m128 scale = _mm_set1_ps(FloatToInt16);
+	const __m128 minValue = _mm_set1_ps(-1.0f);
+	const __m128 maxValue = _mm_set1_ps(1.0f);
+	for (; i + 8 <= numSamples; i += 8)
+	{
+		const __m128 low = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(input + i), minValue), maxValue), scale);
+		const __m128 high = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(input + i + 4), minValue), maxValue), scale);
+		const __m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(low), _mm_cvtps_epi32(high));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(output + i), packed);
+	}
+#elif defined(NCINE_MIXER_NEON)
+	for (; i + 8 <= numSamples; i += 8)
+	{
+		// Conversion and narrowing both saturate, no explicit clipping is needed
+		const int32x4_t low = vcvtq_s32_f32(vmulq_n_f32(vld1q_f32(input + i), FloatToInt16));
+		const int32x4_t high = vcvtq_s32_f32(vmulq_n_f32(vld1q_f32(input + i + 4), FloatToInt16));
+		vst1q_s16(output + i, vcombine_s16(vqmovn_s32(low), vqmovn_s32(high)));
+	}
+#endif
+	for (; i < numSamples; i++)
+	{
+		const float sample = (input[i] < -1.0f) ? -1.0f : ((input[i] > 1.0f) ? 1.0f : input[i]);
+		output[i] = static_cast<int16_t>(lrintf(sample * FloatToInt16));
+	}
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void WavAudioSink::writeHeader()
+{
+	const uint32_t dataSize = static_cast<uint32_t>(numFrames_ * WavBytesPerFrame);
+
+	WavHeader header;
+	memcpy(header.chunkId, "RIFF", 4);
+	header.chunkSize = 36 + dataSize;
+	memcpy(header.format, "WAVE", 4);
+
+	memcpy(header.subchunk1Id, "fmt ", 4);
+	header.subchunk1Size = 16;
+	header.audioFormat = 1; // PCM
+	header.numChannels = WavNumChannels;
+	header.sampleRate = static_cast<uint32_t>(frequency_);
+	header.byteRate = static_cast<uint32_t>(frequency_) * WavBytesPerFrame;
+	header.blockAlign = WavBytesPerFrame;
+	header.bitsPerSample = 16;
+
+	memcpy(header.subchunk2Id, "data", 4);
+	header.subchunk2Size = dataSize;
+
+	fileHandle_->write(&header, sizeof(WavHeader));
+}
+
+}
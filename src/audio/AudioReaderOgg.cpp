@@ -1,3 +1,5 @@
+#include <cstring> // for `memcpy()`
+#include "common_macros.h"
 #include "AudioReaderOgg.h"
 #include "IFile.h"
 
@@ -7,8 +9,16 @@ namespace ncine {
 // CONSTRUCTORS and DESTRUCTOR
 ///////////////////////////////////////////////////////////
 
-AudioReaderOgg::AudioReaderOgg(nctl::UniquePtr<IFile> fileHandle, const OggVorbis_File &oggFile)
-    : fileHandle_(nctl::move(fileHandle)), oggFile_(oggFile)
+OggReadAheadBuffer::OggReadAheadBuffer(IFile *fileHandle)
+    : fileHandle_(fileHandle), buffer_(nctl::makeUnique<unsigned char[]>(BufferSize)),
+      bufferOffset_(0), bufferFilled_(0), bufferPosition_(0)
+{
+	ASSERT(fileHandle_->isOpened());
+	bufferOffset_ = fileHandle_->tell();
+}
+
+AudioReaderOgg::AudioReaderOgg(nctl::UniquePtr<IFile> fileHandle, nctl::UniquePtr<OggReadAheadBuffer> readAheadBuffer, const OggVorbis_File &oggFile)
+    : fileHandle_(nctl::move(fileHandle)), readAheadBuffer_(nctl::move(readAheadBuffer)), oggFile_(oggFile), seekIndex_(16)
 {
 	ASSERT(fileHandle_->isOpened());
 }
@@ -22,6 +32,80 @@ AudioReaderOgg::~AudioReaderOgg()
 // PUBLIC FUNCTIONS
 ///////////////////////////////////////////////////////////
 
+/*! \note Reads larger than the buffer go directly to the file */
+unsigned long int OggReadAheadBuffer::read(void *buffer, unsigned long int bufferSize)
+{
+	unsigned char *destination = static_cast<unsigned char *>(buffer);
+	unsigned long int bytesRead = 0;
+
+	while (bytesRead < bufferSize)
+	{
+		if (bufferPosition_ == bufferFilled_)
+		{
+			bufferOffset_ += bufferFilled_;
+			bufferFilled_ = 0;
+			bufferPosition_ = 0;
+
+			const unsigned long int remainingBytes = bufferSize - bytesRead;
+			if (remainingBytes >= BufferSize)
+			{
+				const unsigned long int bytes = fileHandle_->read(destination + bytesRead, remainingBytes);
+				bufferOffset_ += bytes;
+				bytesRead += bytes;
+				break;
+			}
+
+			bufferFilled_ = fileHandle_->read(buffer_.get(), BufferSize);
+			if (bufferFilled_ == 0)
+				break;
+		}
+
+		const unsigned long int availableBytes = bufferFilled_ - bufferPosition_;
+		const unsigned long int copyBytes = (availableBytes < bufferSize - bytesRead) ? availableBytes : bufferSize - bytesRead;
+		memcpy(destination + bytesRead, buffer_.get() + bufferPosition_, copyBytes);
+		bufferPosition_ += copyBytes;
+		bytesRead += copyBytes;
+	}
+
+	return bytesRead;
+}
+
+/*! \note A seek inside the buffered bytes does not touch the file */
+int OggReadAheadBuffer::seek(long int offset, int whence)
+{
+	long int target = offset;
+	if (whence == SEEK_CUR)
+		target = tell() + offset;
+	else if (whence == SEEK_END)
+		target = static_cast<long int>(fileHandle_->size()) + offset;
+
+	if (target >= bufferOffset_ && target <= bufferOffset_ + static_cast<long int>(bufferFilled_))
+	{
+		bufferPosition_ = static_cast<unsigned long int>(target - bufferOffset_);
+		return 0;
+	}
+
+	if (fileHandle_->seek(target, SEEK_SET) < 0)
+		return -1;
+
+	bufferOffset_ = target;
+	bufferFilled_ = 0;
+	bufferPosition_ = 0;
+	return 0;
+}
+
+long int OggReadAheadBuffer::tell() const
+{
+	return bufferOffset_ + static_cast<long int>(bufferPosition_);
+}
+
+void OggReadAheadBuffer::close()
+{
+	fileHandle_->close();
+	bufferFilled_ = 0;
+	bufferPosition_ = 0;
+}
+
 const char *vorbisErrorToString(long errorCode)
 {
 	switch (errorCode)
@@ -66,4 +150,97 @@ void AudioReaderOgg::rewind() const
 	ov_raw_seek(&oggFile_, 0);
 }
 
+/*! \note The first seek to a region searches for its page, later seeks near it reuse the page from the index */
+bool AudioReaderOgg::seek(unsigned long int sampleOffset) const
+{
+	const ogg_int64_t targetSample = static_cast<ogg_int64_t>(sampleOffset);
+	if (targetSample >= ov_pcm_total(&oggFile_, -1))
+		return false;
+
+	if (seekPage(targetSample) == false)
+		return false;
+
+	// The page starts at or before the target sample
+	return skipSamples(targetSample - ov_pcm_tell(&oggFile_));
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool AudioReaderOgg::seekPage(ogg_int64_t sampleOffset) const
+{
+	// Binary search for the first indexed page that starts after the sample
+	unsigned int first = 0;
+	unsigned int last = seekIndex_.size();
+	while (first < last)
+	{
+		const unsigned int middle = first + (last - first) / 2;
+		if (seekIndex_[middle].sampleOffset <= sampleOffset)
+			first = middle + 1;
+		else
+			last = middle;
+	}
+
+	if (first > 0)
+	{
+		const SeekPoint &seekPoint = seekIndex_[first - 1];
+		if (sampleOffset - seekPoint.sampleOffset <= static_cast<ogg_int64_t>(MaxIndexedDistance) &&
+		    ov_raw_seek(&oggFile_, seekPoint.rawOffset) == 0)
+		{
+			const ogg_int64_t position = ov_pcm_tell(&oggFile_);
+			if (position >= 0 && position <= sampleOffset)
+				return true;
+		}
+	}
+
+	const int error = ov_pcm_seek_page(&oggFile_, sampleOffset);
+	if (error != 0)
+	{
+		LOGW_X("Cannot seek to sample %lld (%s)", static_cast<long long>(sampleOffset), vorbisErrorToString(error));
+		return false;
+	}
+
+	const ogg_int64_t position = ov_pcm_tell(&oggFile_);
+	if (seekIndex_.size() < MaxIndexedPages && position >= 0 && position <= sampleOffset)
+	{
+		// The page found by the search can start before some of the indexed ones
+		unsigned int index = 0;
+		while (index < seekIndex_.size() && seekIndex_[index].sampleOffset < position)
+			index++;
+
+		if (index == seekIndex_.size() || seekIndex_[index].sampleOffset != position)
+		{
+			SeekPoint seekPoint;
+			seekPoint.sampleOffset = position;
+			seekPoint.rawOffset = ov_raw_tell(&oggFile_);
+			seekIndex_.insertAt(index, seekPoint);
+		}
+	}
+
+	return true;
+}
+
+bool AudioReaderOgg::skipSamples(ogg_int64_t numSamples) const
+{
+	const vorbis_info *info = ov_info(&oggFile_, -1);
+	const ogg_int64_t bytesPerFrame = info->channels * 2;
+
+	char discardBuffer[4096];
+	ogg_int64_t remainingBytes = numSamples * bytesPerFrame;
+	int bitStream = 0;
+	while (remainingBytes > 0)
+	{
+		const int bytesToRead = (remainingBytes < static_cast<ogg_int64_t>(sizeof(discardBuffer))) ? static_cast<int>(remainingBytes) : sizeof(discardBuffer);
+		const long bytes = ov_read(&oggFile_, discardBuffer, bytesToRead, 0, 2, 1, &bitStream);
+		if (bytes == OV_HOLE)
+			continue;
+		else if (bytes <= 0)
+			return false;
+		remainingBytes -= bytes;
+	}
+
+	return true;
+}
+
 }
@@ -9,10 +9,11 @@ namespace ncine {
 // CONSTRUCTORS and DESTRUCTOR
 ///////////////////////////////////////////////////////////
 
-AudioReaderWav::AudioReaderWav(nctl::UniquePtr<IFile> fileHandle)
-    : fileHandle_(nctl::move(fileHandle))
+AudioReaderWav::AudioReaderWav(nctl::UniquePtr<IFile> fileHandle, int bytesPerFrame)
+    : fileHandle_(nctl::move(fileHandle)), bytesPerFrame_(bytesPerFrame)
 {
 	ASSERT(fileHandle_->isOpened());
+	ASSERT(bytesPerFrame > 0);
 }
 
 ///////////////////////////////////////////////////////////
@@ -44,4 +45,13 @@ void AudioReaderWav::rewind() const
 	fileHandle_->seek(AudioLoaderWav::HeaderSize, SEEK_SET);
 }
 
+/*! \note PCM data can be addressed directly, seeking takes constant time */
+bool AudioReaderWav::seek(unsigned long int sampleOffset) const
+{
+	if (fileHandle_->ptr())
+		clearerr(fileHandle_->ptr());
+	const long int offset = AudioLoaderWav::HeaderSize + static_cast<long int>(sampleOffset * bytesPerFrame_);
+	return (fileHandle_->seek(offset, SEEK_SET) >= 0);
+}
+
 }
@@ -1,32 +1,220 @@
 #define NCINE_INCLUDE_OPENAL
 #include "common_headers.h"
+#include <cstring> // for `memcpy()`
 #include "common_macros.h"
 #include <nctl/CString.h>
+#include <nctl/Atomic.h>
 #include "AudioStream.h"
 #include "IAudioLoader.h"
 #include "IAudioReader.h"
+#include "ServiceLocator.h"
+#include "IThreadPool.h"
+#include "TimeStamp.h"
+#include "Timer.h" // for `sleep()`
+#include "Application.h"
+#include "SoftwareAudioDevice.h"
 #include "tracy.h"
 
 namespace ncine {
 
+/// A single producer, single consumer ring of decoded blocks
+/*! The producer is the decoding job, the consumer is the main thread queueing blocks to OpenAL */
+struct AudioStream::Decoder
+{
+	/// Number of blocks in the ring, decoded ahead of the ones already queued to OpenAL
+	static const unsigned int NumBlocks = 4;
+
+	struct Block
+	{
+		Block()
+		    : numBytes(0), endOfStream(false) {}
+
+		nctl::UniquePtr<char[]> data;
+		/// Number of decoded bytes, zero for the block that marks the end of a stream that is not looping
+		unsigned long numBytes;
+		/// True if the reader reached the end of the stream while decoding the block
+		bool endOfStream;
+	};
+
+	/// A command to decode blocks on a worker thread
+	/*! The decoding flag is reset on destruction, also when the thread pool drops the command without executing it. */
+	class Command : public IThreadCommand
+	{
+	  public:
+		explicit Command(Decoder &decoder)
+		    : decoder_(decoder) {}
+
+		// Reset last, as the main thread waits for this flag before touching the reader
+		~Command() override { decoder_.isDecoding.store(0); }
+
+		void execute() override { decoder_.decode(NumBlocks); }
+
+	  private:
+		Decoder &decoder_;
+	};
+
+	explicit Decoder(unsigned long int size)
+	    : blockSize(0), reader(nullptr), looping(false), hasFinished(false),
+	      bytesPerFrame(0), samplePosition(0), loopStart(0), loopEnd(0)
+	{
+		setBlockSize(size);
+	}
+
+	~Decoder() { waitForDecoding(); }
+
+	Block blocks[NumBlocks];
+	/// Size in bytes of each block, the same as an OpenAL streaming buffer
+	unsigned long int blockSize;
+	/// Number of blocks written, only incremented by the producer
+	mutable nctl::Atomic32 writeCount;
+	/// Number of blocks read, only incremented by the consumer
+	mutable nctl::Atomic32 readCount;
+	/// Set while a decoding job is in flight
+	mutable nctl::Atomic32 isDecoding;
+	/// Time in microseconds spent decoding the last block
+	mutable nctl::Atomic32 lastDecodeMicroseconds;
+	/// Maximum time in microseconds spent decoding a block
+	mutable nctl::Atomic32 maxDecodeMicroseconds;
+
+	/// The reader is only used by the producer, or by the main thread when no job is in flight
+	IAudioReader *reader;
+	/// Only modified by the main thread when no job is in flight
+	bool looping;
+	/// Set by the producer when the end marker has been written
+	bool hasFinished;
+
+	/// Number of bytes of a sample for all channels
+	unsigned int bytesPerFrame;
+	/// The sample the reader is going to decode next, only used by the producer
+	unsigned long int samplePosition;
+	/// The sample from which a looping stream starts again, only modified by the main thread when no job is in flight
+	unsigned long int loopStart;
+	/// The sample at which a looping stream starts again, zero for the end of the stream
+	unsigned long int loopEnd;
+
+	inline unsigned int numReadyBlocks() const
+	{
+		return static_cast<uint32_t>(writeCount.load()) - static_cast<uint32_t>(readCount.load());
+	}
+
+	/// Reallocates the blocks, it should only be called when no job is in flight
+	void setBlockSize(unsigned long int size);
+	void decode(unsigned int maxBlocks);
+	/// Reads decoded data without going past the loop end of a looping stream
+	unsigned long int readSamples(char *buffer, unsigned long int bufferSize);
+	/// Moves the reader back to the loop start
+	void seekToLoopStart();
+	void waitForDecoding() const;
+	/// Empties the ring, it should only be called when no job is in flight
+	void reset();
+};
+
+void AudioStream::Decoder::setBlockSize(unsigned long int size)
+{
+	if (size == blockSize)
+		return;
+
+	for (unsigned int i = 0; i < NumBlocks; i++)
+		blocks[i].data = nctl::makeUnique<char[]>(size);
+	blockSize = size;
+}
+
+void AudioStream::Decoder::decode(unsigned int maxBlocks)
+{
+	ZoneScopedN("Decode audio stream");
+	if (reader == nullptr)
+		return;
+
+	for (unsigned int i = 0; i < maxBlocks && hasFinished == false; i++)
+	{
+		const uint32_t write = static_cast<uint32_t>(writeCount.load());
+		// The consumer increments the read count only after it has finished with the block
+		const uint32_t read = static_cast<uint32_t>(readCount.load());
+		if (write - read >= NumBlocks)
+			break;
+
+		const TimeStamp startTime = TimeStamp::now();
+		Block &block = blocks[write % NumBlocks];
+		unsigned long bytes = readSamples(block.data.get(), blockSize);
+
+		// EOF or loop end reached
+		block.endOfStream = (bytes < blockSize);
+		if (block.endOfStream && looping)
+		{
+			seekToLoopStart();
+			const unsigned long moreBytes = readSamples(block.data.get() + bytes, blockSize - bytes);
+			bytes += moreBytes;
+		}
+		block.numBytes = bytes;
+		hasFinished = (bytes == 0);
+
+		const int32_t decodeTime = static_cast<int32_t>(startTime.microsecondsSince());
+		lastDecodeMicroseconds.store(decodeTime);
+		if (decodeTime > maxDecodeMicroseconds.load())
+			maxDecodeMicroseconds.store(decodeTime);
+
+		// Incrementing the write count publishes the block content to the consumer
+		writeCount.store(static_cast<int32_t>(write + 1));
+	}
+}
+
+unsigned long int AudioStream::Decoder::readSamples(char *buffer, unsigned long int bufferSize)
+{
+	unsigned long int bytesToRead = bufferSize;
+	if (looping && loopEnd > 0 && bytesPerFrame > 0)
+	{
+		const unsigned long int bytesToLoopEnd = (loopEnd > samplePosition) ? (loopEnd - samplePosition) * bytesPerFrame : 0;
+		if (bytesToLoopEnd < bytesToRead)
+			bytesToRead = bytesToLoopEnd;
+	}
+
+	const unsigned long int bytes = (bytesToRead > 0) ? reader->read(buffer, bytesToRead) : 0;
+	if (bytesPerFrame > 0)
+		samplePosition += bytes / bytesPerFrame;
+	return bytes;
+}
+
+void AudioStream::Decoder::seekToLoopStart()
+{
+	// A seek is more expensive than a rewind for some formats
+	if (loopStart > 0 && reader->seek(loopStart))
+		samplePosition = loopStart;
+	else
+	{
+		reader->rewind();
+		samplePosition = 0;
+	}
+}
+
+void AudioStream::Decoder::waitForDecoding() const
+{
+	while (isDecoding.load() != 0)
+		Timer::sleep(1);
+}
+
+void AudioStream::Decoder::reset()
+{
+	writeCount.store(0);
+	readCount.store(0);
+	hasFinished = false;
+	samplePosition = 0;
+}
+
 ///////////////////////////////////////////////////////////
 // CONSTRUCTORS and DESTRUCTOR
 ///////////////////////////////////////////////////////////
 
 /*! Private constructor called only by `AudioStreamPlayer`. */
 AudioStream::AudioStream()
-    : buffersIds_(nctl::StaticArrayMode::EXTEND_SIZE), nextAvailableBufferIndex_(0),
-      currentBufferId_(0), totalProcessedBuffers_(0), bytesPerSample_(0), numChannels_(0),
-      frequency_(0), numSamples_(0), duration_(0.0f)
+    : numBuffers_(0), nextAvailableBufferIndex_(0), bufferSize_(0), adaptiveBuffering_(false),
+      numUnderruns_(0), hasStartedPlaying_(false), currentBufferId_(0), readBlockOffset_(0), totalProcessedBuffers_(0),
+      startSampleOffset_(0), bytesPerSample_(0), numChannels_(0), frequency_(0), numSamples_(0), duration_(0.0f)
 {
-	alGetError();
-	alGenBuffers(NumBuffers, buffersIds_.data());
-	const ALenum error = alGetError();
-	ASSERT_MSG_X(error == AL_NO_ERROR, "alGenBuffers failed: 0x%x", error);
-	memBuffer_ = nctl::makeUnique<char[]>(BufferSize);
-
-	for (unsigned int i = 0; i < NumBuffers; i++)
-		ASSERT(alIsBuffer(buffersIds_[i]) == AL_TRUE);
+	const AppConfiguration &appCfg = theApplication().appConfiguration();
+	adaptiveBuffering_ = appCfg.adaptiveStreamBuffers;
+	bufferSize_ = clampBufferSize(appCfg.streamBufferSize);
+	decoder_ = nctl::makeUnique<Decoder>(bufferSize_);
+	generateBuffers(clampNumBuffers(appCfg.numStreamBuffers));
 }
 
 /*! Private constructor called only by `AudioStreamPlayer`. */
@@ -49,9 +237,13 @@ AudioStream::AudioStream(const char *filename)
 
 AudioStream::~AudioStream()
 {
-	// Don't delete buffers if this is a moved out object
-	if (buffersIds_.size() == NumBuffers)
-		alDeleteBuffers(NumBuffers, buffersIds_.data());
+	// The reader is destroyed before the decoder, a job that is still using it should complete first
+	if (decoder_ != nullptr)
+		decoder_->waitForDecoding();
+
+	// Don't delete buffers if this is a moved out object, or if they have never been generated by OpenAL
+	if (buffersIds_.size() > 0 && SoftwareAudioDevice::instance() == nullptr)
+		alDeleteBuffers(buffersIds_.size(), buffersIds_.data());
 }
 
 AudioStream::AudioStream(AudioStream &&) = default;
@@ -65,10 +257,113 @@ AudioStream &AudioStream::operator=(AudioStream &&) = default;
 unsigned long int AudioStream::numSamplesInStreamBuffer() const
 {
 	if (numChannels_ * bytesPerSample_ > 0)
-		return BufferSize / (numChannels_ * bytesPerSample_);
+		return bufferSize_ / (numChannels_ * bytesPerSample_);
 	return 0UL;
 }
 
+bool AudioStream::setStreamBuffers(unsigned int numBuffers, unsigned long int bufferSize)
+{
+	if (nextAvailableBufferIndex_ > 0)
+	{
+		LOGW("Cannot change the streaming buffers while some of them are queued");
+		return false;
+	}
+
+	// Decoded blocks are discarded and the stream starts again from the beginning
+	decoder_->waitForDecoding();
+	decoder_->reset();
+	if (audioReader_ != nullptr)
+		audioReader_->rewind();
+	readBlockOffset_ = 0;
+	totalProcessedBuffers_ = 0;
+	startSampleOffset_ = 0;
+
+	bufferSize_ = clampBufferSize(bufferSize);
+	decoder_->setBlockSize(bufferSize_);
+
+	if (SoftwareAudioDevice::instance() == nullptr)
+		alDeleteBuffers(buffersIds_.size(), buffersIds_.data());
+	buffersIds_.clear();
+	numBuffers_ = 0;
+	generateBuffers(clampNumBuffers(numBuffers));
+
+	return true;
+}
+
+unsigned int AudioStream::numReadyBlocks() const
+{
+	return decoder_->numReadyBlocks();
+}
+
+float AudioStream::lastDecodeTime() const
+{
+	return decoder_->lastDecodeMicroseconds.load() * 0.001f;
+}
+
+float AudioStream::maxDecodeTime() const
+{
+	return decoder_->maxDecodeMicroseconds.load() * 0.001f;
+}
+
+bool AudioStream::isDecodingInBackground() const
+{
+	return (theServiceLocator().threadPool().numThreads() > 0);
+}
+
+/*! \note Seeking a stream that is not playing sets the sample from which it starts */
+bool AudioStream::seek(unsigned long int sampleOffset)
+{
+	if (audioReader_ == nullptr || sampleOffset >= numSamples_)
+		return false;
+
+	if (nextAvailableBufferIndex_ > 0)
+	{
+		LOGW("Cannot seek the stream while some buffers are queued");
+		return false;
+	}
+
+	// Decoded blocks are discarded and the reader cannot be moved while a job is decoding from it
+	decoder_->waitForDecoding();
+	decoder_->reset();
+	if (audioReader_->seek(sampleOffset) == false)
+	{
+		audioReader_->rewind();
+		startSampleOffset_ = 0;
+		return false;
+	}
+
+	decoder_->samplePosition = sampleOffset;
+	readBlockOffset_ = 0;
+	totalProcessedBuffers_ = 0;
+	startSampleOffset_ = sampleOffset;
+	return true;
+}
+
+unsigned long int AudioStream::loopStart() const
+{
+	return decoder_->loopStart;
+}
+
+unsigned long int AudioStream::loopEnd() const
+{
+	return decoder_->loopEnd;
+}
+
+bool AudioStream::setLoopPoints(unsigned long int loopStart, unsigned long int loopEnd)
+{
+	if (loopStart >= numSamples_ || (loopEnd > 0 && (loopEnd <= loopStart || loopEnd > numSamples_)))
+	{
+		LOGW_X("Invalid loop points: %lu - %lu", loopStart, loopEnd);
+		return false;
+	}
+
+	// The producer reads the loop points while decoding
+	decoder_->waitForDecoding();
+	decoder_->loopStart = loopStart;
+	decoder_->loopEnd = loopEnd;
+	return true;
+}
+
 /*! \return A flag indicating whether the stream has been entirely decoded and played or not. */
 bool AudioStream::enqueue(unsigned int source, bool looping)
 {
@@ -92,41 +387,49 @@ bool AudioStream::enqueue(unsigned int source, bool looping)
 		totalProcessedBuffers_++;
 	}
 
-	// Queueing
-	if (nextAvailableBufferIndex_ < NumBuffers)
+	Decoder &decoder = *decoder_;
+	// Nothing would be played until a worker thread decodes the first block, so it is decoded immediately
+	if (nextAvailableBufferIndex_ == 0 && decoder.numReadyBlocks() == 0 && decoder.isDecoding.load() == 0)
 	{
-		currentBufferId_ = buffersIds_[nextAvailableBufferIndex_];
+		decoder.looping = looping;
+		decoder.decode(1);
+	}
 
-		unsigned long bytes = audioReader_->read(memBuffer_.get(), BufferSize);
+	// Queueing the blocks that have already been decoded, no decoding happens on this thread
+	while (nextAvailableBufferIndex_ < numBuffers_ && decoder.numReadyBlocks() > 0)
+	{
+		const uint32_t read = static_cast<uint32_t>(decoder.readCount.load());
+		const Decoder::Block &block = decoder.blocks[read % Decoder::NumBlocks];
 
-		// EOF reached
-		if (bytes < BufferSize)
+		// The end marker is only consumed when there is no more data left and the queue is empty
+		if (block.numBytes == 0)
 		{
-			if (looping)
+			if (nextAvailableBufferIndex_ == 0)
 			{
-				audioReader_->rewind();
-				const unsigned long moreBytes = audioReader_->read(memBuffer_.get() + bytes, BufferSize - bytes);
-				bytes += moreBytes;
+				shouldKeepPlaying = false;
+				stop(source);
 			}
-			totalProcessedBuffers_ = 0;
+			break;
 		}
 
-		// If it is still decoding data then enqueue
-		if (bytes > 0)
-		{
-			// On iOS `alBufferDataStatic()` could be used instead
-			alBufferData(currentBufferId_, format_, memBuffer_.get(), bytes, frequency_);
-			alSourceQueueBuffers(source, 1, &currentBufferId_);
-			nextAvailableBufferIndex_++;
-		}
-		// If there is no more data left to decode and the queue is empty
-		else if (nextAvailableBufferIndex_ == 0)
+		currentBufferId_ = buffersIds_[nextAvailableBufferIndex_];
+		// On iOS `alBufferDataStatic()` could be used instead
+		alBufferData(currentBufferId_, format_, block.data.get(), block.numBytes, frequency_);
+		alSourceQueueBuffers(source, 1, &currentBufferId_);
+		nextAvailableBufferIndex_++;
+		if (block.endOfStream)
 		{
-			shouldKeepPlaying = false;
-			stop(source);
+			totalProcessedBuffers_ = 0;
+			startSampleOffset_ = looping ? decoder.loopStart : 0;
 		}
+
+		// Incrementing the read count gives the block back to the producer
+		decoder.readCount.store(static_cast<int32_t>(read + 1));
 	}
 
+	if (shouldKeepPlaying)
+		requestDecoding(looping);
+
 	ALenum state;
 	alGetSourcei(source, AL_SOURCE_STATE, &state);
 
@@ -137,6 +440,19 @@ bool AudioStream::enqueue(unsigned int source, bool looping)
 		alGetSourcei(source, AL_BUFFERS_QUEUED, &numQueuedBuffers);
 		if (numQueuedBuffers > 0)
 		{
+			// The first restart only happens because nothing was queued when the source started playing
+			if (hasStartedPlaying_)
+			{
+				numUnderruns_++;
+				// A longer queue gives more time to the decoding jobs before the next underrun
+				if (adaptiveBuffering_ && numBuffers_ < MaxNumBuffers)
+				{
+					generateBuffers(1);
+					LOGD_X("Audio stream underrun, the queue has grown to %u buffers", numBuffers_);
+				}
+			}
+			hasStartedPlaying_ = true;
+
 			// Need to restart play
 			alSourcePlay(source);
 		}
@@ -145,27 +461,106 @@ bool AudioStream::enqueue(unsigned int source, bool looping)
 	return shouldKeepPlaying;
 }
 
+/*! \note A stream mixed in software has no source and is only rewound */
 void AudioStream::stop(unsigned int source)
 {
-	// In order to unqueue all the buffers, the source must be stopped first
-	alSourceStop(source);
+	if (source != IAudioDevice::InvalidSource)
+	{
+		// In order to unqueue all the buffers, the source must be stopped first
+		alSourceStop(source);
 
-	ALint numProcessedBuffers;
-	alGetSourcei(source, AL_BUFFERS_PROCESSED, &numProcessedBuffers);
+		ALint numProcessedBuffers;
+		alGetSourcei(source, AL_BUFFERS_PROCESSED, &numProcessedBuffers);
 
-	// Unqueueing
-	while (numProcessedBuffers > 0)
-	{
-		ALuint unqueuedAlBuffer;
-		alSourceUnqueueBuffers(source, 1, &unqueuedAlBuffer);
-		nextAvailableBufferIndex_--;
-		buffersIds_[nextAvailableBufferIndex_] = unqueuedAlBuffer;
-		numProcessedBuffers--;
+		// Unqueueing
+		while (numProcessedBuffers > 0)
+		{
+			ALuint unqueuedAlBuffer;
+			alSourceUnqueueBuffers(source, 1, &unqueuedAlBuffer);
+			nextAvailableBufferIndex_--;
+			buffersIds_[nextAvailableBufferIndex_] = unqueuedAlBuffer;
+			numProcessedBuffers--;
+		}
 	}
 
+	// The reader cannot be rewound while a job is decoding from it
+	decoder_->waitForDecoding();
+	decoder_->reset();
 	audioReader_->rewind();
 	currentBufferId_ = 0;
+	readBlockOffset_ = 0;
 	totalProcessedBuffers_ = 0;
+	startSampleOffset_ = 0;
+	hasStartedPlaying_ = false;
+}
+
+/*! \return The number of bytes copied, fewer than requested only when the stream has finished and has been rewound. */
+unsigned long int AudioStream::read(char *buffer, unsigned long int bufferSize, bool looping)
+{
+	if (audioReader_ == nullptr)
+		return 0;
+
+	Decoder &decoder = *decoder_;
+	unsigned long int numBytes = 0;
+	bool hasFinished = false;
+	while (numBytes < bufferSize)
+	{
+		if (decoder.numReadyBlocks() == 0)
+		{
+			// There are no queued buffers to keep playing from, the next block is waited for or decoded immediately
+			if (decoder.isDecoding.load() != 0)
+				decoder.waitForDecoding();
+			else
+			{
+				decoder.looping = looping;
+				decoder.decode(1);
+			}
+
+			if (hasStartedPlaying_)
+				numUnderruns_++;
+			if (decoder.numReadyBlocks() == 0)
+			{
+				hasFinished = true;
+				stop(IAudioDevice::InvalidSource);
+				break;
+			}
+		}
+		hasStartedPlaying_ = true;
+
+		const uint32_t read = static_cast<uint32_t>(decoder.readCount.load());
+		const Decoder::Block &block = decoder.blocks[read % Decoder::NumBlocks];
+		if (block.numBytes == 0)
+		{
+			hasFinished = true;
+			stop(IAudioDevice::InvalidSource);
+			break;
+		}
+
+		const unsigned long int blockBytes = block.numBytes - readBlockOffset_;
+		const unsigned long int copyBytes = (blockBytes < bufferSize - numBytes) ? blockBytes : bufferSize - numBytes;
+		memcpy(buffer + numBytes, block.data.get() + readBlockOffset_, copyBytes);
+		numBytes += copyBytes;
+		readBlockOffset_ += copyBytes;
+
+		if (readBlockOffset_ == block.numBytes)
+		{
+			readBlockOffset_ = 0;
+			totalProcessedBuffers_++;
+			if (block.endOfStream)
+			{
+				totalProcessedBuffers_ = 0;
+				startSampleOffset_ = looping ? decoder.loopStart : 0;
+			}
+
+			// Incrementing the read count gives the block back to the producer
+			decoder.readCount.store(static_cast<int32_t>(read + 1));
+		}
+	}
+
+	if (hasFinished == false)
+		requestDecoding(looping);
+
+	return numBytes;
 }
 
 ///////////////////////////////////////////////////////////
@@ -211,7 +606,75 @@ void AudioStream::createReader(IAudioLoader &audioLoader)
 	duration_ = float(numSamples_) / frequency_;
 	format_ = (numChannels_ == 1) ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
 
+	decoder_->waitForDecoding();
+	decoder_->reset();
 	audioReader_ = audioLoader.createReader();
+	decoder_->reader = audioReader_.get();
+	decoder_->bytesPerFrame = static_cast<unsigned int>(numChannels_ * bytesPerSample_);
+	// Loop points of the previous stream could be out of range
+	decoder_->loopStart = 0;
+	decoder_->loopEnd = 0;
+	readBlockOffset_ = 0;
+	startSampleOffset_ = 0;
+}
+
+/*! \note New buffers are added at the end of the array, where the available ones are */
+void AudioStream::generateBuffers(unsigned int count)
+{
+	ASSERT(numBuffers_ + count <= MaxNumBuffers);
+
+	buffersIds_.setSize(numBuffers_ + count);
+	// The blocks of a stream mixed in software are read directly, without OpenAL buffers
+	if (SoftwareAudioDevice::instance() != nullptr)
+	{
+		for (unsigned int i = numBuffers_; i < numBuffers_ + count; i++)
+			buffersIds_[i] = 0;
+		numBuffers_ += count;
+		return;
+	}
+
+	alGetError();
+	alGenBuffers(count, buffersIds_.data() + numBuffers_);
+	const ALenum error = alGetError();
+	ASSERT_MSG_X(error == AL_NO_ERROR, "alGenBuffers failed: 0x%x", error);
+
+	for (unsigned int i = numBuffers_; i < numBuffers_ + count; i++)
+		ASSERT(alIsBuffer(buffersIds_[i]) == AL_TRUE);
+	numBuffers_ += count;
+}
+
+unsigned int AudioStream::clampNumBuffers(unsigned int numBuffers)
+{
+	if (numBuffers < 2)
+		return 2;
+	return (numBuffers > MaxNumBuffers) ? MaxNumBuffers : numBuffers;
+}
+
+unsigned long int AudioStream::clampBufferSize(unsigned long int bufferSize)
+{
+	// The size should be a multiple of four bytes, the size of a 16 bits stereo sample
+	bufferSize &= ~3UL;
+	return (bufferSize < MinBufferSize) ? MinBufferSize : bufferSize;
+}
+
+void AudioStream::requestDecoding(bool looping)
+{
+	Decoder &decoder = *decoder_;
+	if (decoder.isDecoding.load() != 0 || decoder.hasFinished || decoder.numReadyBlocks() >= Decoder::NumBlocks)
+		return;
+
+	decoder.looping = looping;
+	IThreadPool &threadPool = theServiceLocator().threadPool();
+	if (threadPool.numThreads() > 0)
+	{
+		decoder.isDecoding.store(1);
+		threadPool.enqueueCommand(nctl::makeUnique<Decoder::Command>(decoder));
+	}
+	else
+	{
+		// Without worker threads a single block is decoded per update to spread the cost over frames
+		decoder.decode(1);
+	}
 }
 
 }
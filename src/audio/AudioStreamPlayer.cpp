@@ -61,7 +61,30 @@ bool AudioStreamPlayer::loadFromFile(const char *filename)
 
 unsigned long int AudioStreamPlayer::sampleOffsetInStream() const
 {
-	return (audioStream_.totalProcessedBuffers() * audioStream_.numSamplesInStreamBuffer() + sampleOffset());
+	return (audioStream_.startSampleOffset() + audioStream_.totalProcessedBuffers() * audioStream_.numSamplesInStreamBuffer() + sampleOffset());
+}
+
+bool AudioStreamPlayer::setSampleOffsetInStream(unsigned long int sampleOffset)
+{
+	if (sampleOffset >= audioStream_.numSamples())
+		return false;
+
+	// The queued buffers are unqueued, a playing source is restarted by the next update
+	if (state_ == PlayerState::PLAYING || state_ == PlayerState::PAUSED)
+		audioStream_.stop(sourceId_);
+
+	return audioStream_.seek(sampleOffset);
+}
+
+bool AudioStreamPlayer::setStreamBuffers(unsigned int numBuffers, unsigned long int bufferSize)
+{
+	if (state_ == PlayerState::PLAYING || state_ == PlayerState::PAUSED)
+	{
+		LOGW("Cannot change the streaming buffers of a player that is not stopped");
+		return false;
+	}
+
+	return audioStream_.setStreamBuffers(numBuffers, bufferSize);
 }
 
 void AudioStreamPlayer::play()
@@ -71,20 +94,22 @@ void AudioStreamPlayer::play()
 		case PlayerState::INITIAL:
 		case PlayerState::STOPPED:
 		{
-			if (sourceId_ == IAudioDevice::InvalidSource)
+			if (sourceId_ == IAudioDevice::InvalidSource && isVirtual_ == false)
 			{
 				IAudioDevice &device = theServiceLocator().audioDevice();
-				if (device.numAvailableSources() == 0)
+				// The source might be taken from a less audible buffer player
+				device.registerPlayer(this); // It also assigns `sourceId_` or makes the player virtual for the software device
+				if (sourceId_ == IAudioDevice::InvalidSource && isVirtual_ == false)
 				{
 					LOGW("No more available audio sources for playing the stream");
 					return;
 				}
-
-				device.registerPlayer(this); // It also assigns `sourceId_`
-				ASSERT(sourceId_ != IAudioDevice::InvalidSource);
 			}
 
-			if (sourceId_ != IAudioDevice::InvalidSource)
+			// A virtual stream is read and mixed by the software audio device
+			if (isVirtual_)
+				state_ = PlayerState::PLAYING;
+			else if (sourceId_ != IAudioDevice::InvalidSource)
 			{
 				// Streams looping is not handled at enqueued buffer level
 				alSourcei(sourceId_, AL_LOOPING, AL_FALSE);
@@ -99,7 +124,8 @@ void AudioStreamPlayer::play()
 			break;
 		case PlayerState::PAUSED:
 		{
-			alSourcePlay(sourceId_);
+			if (isVirtual_ == false)
+				alSourcePlay(sourceId_);
 			state_ = PlayerState::PLAYING;
 			break;
 		}
@@ -115,7 +141,8 @@ void AudioStreamPlayer::pause()
 			break;
 		case PlayerState::PLAYING:
 		{
-			alSourcePause(sourceId_);
+			if (isVirtual_ == false)
+				alSourcePause(sourceId_);
 			state_ = PlayerState::PAUSED;
 			break;
 		}
@@ -137,9 +164,11 @@ void AudioStreamPlayer::stop()
 			// Stop the source then unqueue every buffer
 			audioStream_.stop(sourceId_);
 			// Detach the buffer from source
-			alSourcei(sourceId_, AL_BUFFER, 0);
+			if (isVirtual_ == false)
+				alSourcei(sourceId_, AL_BUFFER, 0);
 
-			if (sourceLocked_ == false)
+			// Virtual players are never locked and need to be removed from the device
+			if (sourceLocked_ == false || isVirtual_)
 			{
 				IAudioDevice &device = theServiceLocator().audioDevice();
 				device.unregisterPlayer(this); // It also resets `sourceId_`
@@ -164,4 +193,26 @@ void AudioStreamPlayer::updateState()
 	}
 }
 
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+/*! \note The playback position inside the current block is tracked like the sample offset of a source with queued buffers */
+unsigned long int AudioStreamPlayer::readFrames(int16_t *frames, unsigned long int numFrames)
+{
+	const unsigned int bytesPerFrame = static_cast<unsigned int>(audioStream_.numChannels() * audioStream_.bytesPerSample());
+	if (bytesPerFrame == 0 || audioStream_.frequency() <= 0)
+		return 0;
+
+	const unsigned long int numBytes = numFrames * bytesPerFrame;
+	const unsigned long int bytesRead = audioStream_.read(reinterpret_cast<char *>(frames), numBytes, isLooping_);
+	virtualPosition_ = audioStream_.readBlockOffset_ / static_cast<float>(bytesPerFrame * audioStream_.frequency());
+
+	// The stream has already been rewound when it reached its end
+	if (bytesRead < numBytes)
+		state_ = PlayerState::STOPPED;
+
+	return bytesRead / bytesPerFrame;
+}
+
 }
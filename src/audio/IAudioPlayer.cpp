@@ -49,7 +49,8 @@ const float IAudioPlayer::MaxConeOuterGainHF = 1.0f;
 IAudioPlayer::IAudioPlayer(ObjectType type, const char *name)
     : Object(type, name), sourceId_(IAudioDevice::InvalidSource),
       sourceLocked_(false), state_(PlayerState::STOPPED), isLooping_(false),
-      gain_(DefaultGain), pitch_(DefaultPitch),
+      isVirtual_(false), priority_(0), virtualPosition_(0.0f),
+      gain_(DefaultGain), pitch_(DefaultPitch), isSourceRelative_(false),
       position_(0.0f, 0.0f, 0.0f), velocity_(0.0f, 0.0f, 0.0f), direction_(0.0f, 0.0f, 0.0f),
       coneInnerAngle_(DefaultConeAngle), coneOuterAngle_(DefaultConeAngle), coneOuterGain_(DefaultConeOuterGain),
       airAbsorptionFactor_(DefaultAirAbsorptionFactor), roomRooloffFactor_(DefaultRoomRolloffFactor),
@@ -81,17 +82,31 @@ bool IAudioPlayer::hasSource() const
 int IAudioPlayer::sampleOffset() const
 {
 	int byteOffset = 0;
-	if (hasSource())
+	if (isVirtual_)
+		byteOffset = static_cast<int>(virtualPosition_ * frequency());
+	else if (hasSource())
 		alGetSourcei(sourceId_, AL_SAMPLE_OFFSET, &byteOffset);
 	return byteOffset;
 }
 
 void IAudioPlayer::setSampleOffset(int byteOffset)
 {
-	if (hasSource())
+	if (isVirtual_ && frequency() > 0)
+		virtualPosition_ = byteOffset / static_cast<float>(frequency());
+	else if (hasSource())
 		alSourcei(sourceId_, AL_SAMPLE_OFFSET, byteOffset);
 }
 
+/*! \note The attenuation follows the default OpenAL inverse distance clamped model, with a reference distance and a rolloff factor of one.
+ *  As the gain is never greater than one, a player with a higher priority is always more audible.
+ *  The listener position is ignored for a source relative player, as its position is already the offset from the listener. */
+float IAudioPlayer::audibility(const Vector3f &listenerPosition) const
+{
+	const float distance = isSourceRelative_ ? position_.length() : (position_ - listenerPosition).length();
+	const float attenuation = (distance > 1.0f) ? 1.0f / distance : 1.0f;
+	return static_cast<float>(priority_) + gain_ * attenuation;
+}
+
 /*! \note Locking an OpenAL source can be useful to retain source, effect, and filter properties */
 void IAudioPlayer::setSourceLocked(bool sourceLocked)
 {
@@ -122,6 +137,13 @@ void IAudioPlayer::setPitch(float pitch)
 		alSourcef(sourceId_, AL_PITCH, pitch_);
 }
 
+void IAudioPlayer::setSourceRelative(bool sourceRelative)
+{
+	isSourceRelative_ = sourceRelative;
+	if (hasSource())
+		alSourcei(sourceId_, AL_SOURCE_RELATIVE, isSourceRelative_ ? AL_TRUE : AL_FALSE);
+}
+
 void IAudioPlayer::setPosition(const Vector3f &position)
 {
 	position_ = position;
@@ -285,6 +307,8 @@ void IAudioPlayer::applySourceProperties()
 
 		alSourcef(sourceId_, AL_GAIN, gain_);
 		alSourcef(sourceId_, AL_PITCH, pitch_);
+		// Sources come from a pool, the flag is always set to not inherit the one of a previous player
+		alSourcei(sourceId_, AL_SOURCE_RELATIVE, isSourceRelative_ ? AL_TRUE : AL_FALSE);
 		alSourcefv(sourceId_, AL_POSITION, position_.data());
 		alSourcefv(sourceId_, AL_VELOCITY, velocity_.data());
 		alSourcefv(sourceId_, AL_DIRECTION, direction_.data());
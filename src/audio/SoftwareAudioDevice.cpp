@@ -0,0 +1,365 @@
+#include <cstring> // for `memcpy()`
+#include "common_macros.h"
+#include "SoftwareAudioDevice.h"
+#include "AudioBufferPlayer.h"
+#include "AudioStreamPlayer.h"
+#include "AppConfiguration.h"
+#include <nctl/HashSetIterator.h>
+#include "tracy.h"
+
+namespace ncine {
+
+///////////////////////////////////////////////////////////
+// STATIC DEFINITIONS
+///////////////////////////////////////////////////////////
+
+const float SoftwareAudioDevice::MaxUpdateInterval = 0.25f;
+
+SoftwareAudioDevice *SoftwareAudioDevice::instance_ = nullptr;
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+SoftwareAudioDevice::SoftwareAudioDevice(const AppConfiguration &appCfg)
+    : gain_(1.0f), position_(Vector3f::Zero), velocity_(Vector3f::Zero),
+      mixer_((appCfg.outputAudioFrequency > 0) ? static_cast<int>(appCfg.outputAudioFrequency) : 44100, MaxFramesPerMix),
+      sink_(nctl::makeUnique<NullAudioSink>()), buffers_(16), players_(16), pausedPlayers_(16),
+      mixedPlayers_(16), frameRemainder_(0.0), numMixedFrames_(0), numStreamUnderruns_(0)
+{
+	ASSERT(instance_ == nullptr);
+	instance_ = this;
+
+	attributes_.deviceName = "SoftwareAudioDevice";
+	attributes_.outputFrequency = mixer_.outputFrequency();
+	LOGI_X("Mixing audio in software at %d Hz", attributes_.outputFrequency);
+}
+
+SoftwareAudioDevice::~SoftwareAudioDevice()
+{
+	instance_ = nullptr;
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+const IAudioPlayer *SoftwareAudioDevice::player(unsigned int index) const
+{
+	if (index < players_.size())
+		return players_[index];
+
+	return nullptr;
+}
+
+IAudioPlayer *SoftwareAudioDevice::player(unsigned int index)
+{
+	if (index < players_.size())
+		return players_[index];
+
+	return nullptr;
+}
+
+void SoftwareAudioDevice::pausePlayers()
+{
+	for (unsigned int i = 0; i < players_.size(); i++)
+	{
+		if (players_[i]->isPlaying())
+		{
+			players_[i]->pause();
+			if (pausedPlayers_.loadFactor() >= 0.8f)
+				pausedPlayers_.rehash(pausedPlayers_.capacity() * 2);
+			pausedPlayers_.insert(players_[i]);
+		}
+	}
+}
+
+void SoftwareAudioDevice::stopPlayers()
+{
+	// Stopped players are unregistered and removed from the array (in reverse order)
+	for (int i = players_.size() - 1; i >= 0; i--)
+		players_[i]->stop();
+}
+
+void SoftwareAudioDevice::pausePlayers(PlayerType playerType)
+{
+	const Object::ObjectType objectType = (playerType == PlayerType::BUFFER)
+	                                          ? AudioBufferPlayer::sType()
+	                                          : AudioStreamPlayer::sType();
+
+	for (int i = players_.size() - 1; i >= 0; i--)
+	{
+		if (players_[i]->type() == objectType)
+		{
+			players_[i]->pause();
+			if (pausedPlayers_.loadFactor() >= 0.8f)
+				pausedPlayers_.rehash(pausedPlayers_.capacity() * 2);
+			pausedPlayers_.insert(players_[i]);
+		}
+	}
+}
+
+void SoftwareAudioDevice::stopPlayers(PlayerType playerType)
+{
+	const Object::ObjectType objectType = (playerType == PlayerType::BUFFER)
+	                                          ? AudioBufferPlayer::sType()
+	                                          : AudioStreamPlayer::sType();
+
+	for (int i = players_.size() - 1; i >= 0; i--)
+	{
+		if (players_[i]->type() == objectType)
+			players_[i]->stop();
+	}
+}
+
+void SoftwareAudioDevice::resumePlayers()
+{
+	for (IAudioPlayer *player : pausedPlayers_)
+	{
+		if (player->isPaused())
+			player->play();
+	}
+	pausedPlayers_.clear();
+}
+
+void SoftwareAudioDevice::pauseDevice()
+{
+	pausePlayers();
+}
+
+void SoftwareAudioDevice::resumeDevice()
+{
+	resumePlayers();
+
+	// Nothing should be mixed for the time the device was paused
+	lastUpdateTime_ = TimeStamp::now();
+	frameRemainder_ = 0.0;
+}
+
+/*! \note Players have no OpenAL source and are flagged as virtual, so they skip every OpenAL call */
+void SoftwareAudioDevice::registerPlayer(IAudioPlayer *player)
+{
+	ASSERT(player);
+	if (player == nullptr || player->isVirtual_)
+		return;
+
+	player->isVirtual_ = true;
+	player->virtualPosition_ = 0.0f;
+	players_.pushBack(player);
+}
+
+void SoftwareAudioDevice::unregisterPlayer(IAudioPlayer *player)
+{
+	ASSERT(player);
+	if (player == nullptr || player->isVirtual_ == false)
+		return;
+
+	for (unsigned int i = 0; i < players_.size(); i++)
+	{
+		if (players_[i] == player)
+		{
+			players_.unorderedRemoveAt(i);
+			break;
+		}
+	}
+	player->isVirtual_ = false;
+}
+
+void SoftwareAudioDevice::updatePlayers()
+{
+	ZoneScoped;
+	const float elapsed = lastUpdateTime_.secondsSince();
+	lastUpdateTime_ = TimeStamp::now();
+
+	const float interval = (elapsed < MaxUpdateInterval) ? elapsed : MaxUpdateInterval;
+	frameRemainder_ += static_cast<double>(interval) * mixer_.outputFrequency();
+	const unsigned int numFrames = static_cast<unsigned int>(frameRemainder_);
+	frameRemainder_ -= numFrames;
+	// Players advance by the time that has been mixed, which is a whole number of frames
+	const float mixedInterval = numFrames / static_cast<float>(mixer_.outputFrequency());
+
+	mixedPlayers_.clear();
+	streamSamples_.clear();
+	for (unsigned int i = 0; i < players_.size(); i++)
+	{
+		IAudioPlayer *player = players_[i];
+		if (player->isPlaying() == false || numFrames == 0)
+			continue;
+
+		MixedPlayer mixedPlayer;
+		mixedPlayer.player = player;
+		mixedPlayer.buffer = nullptr;
+		mixedPlayer.streamOffset = 0;
+		mixedPlayer.numStreamFrames = 0;
+		mixedPlayer.voiceHandle = -1;
+
+		if (player->type() == AudioStreamPlayer::sType())
+		{
+			const AudioStreamPlayer *streamPlayer = static_cast<const AudioStreamPlayer *>(player);
+			const unsigned int numUnderruns = streamPlayer->numUnderruns();
+			readStream(mixedPlayer, numFrames);
+			numStreamUnderruns_ += streamPlayer->numUnderruns() - numUnderruns;
+		}
+		else
+			mixedPlayer.buffer = findBuffer(player->bufferId());
+
+		mixedPlayers_.pushBack(mixedPlayer);
+	}
+
+	// Voices are added only after all streams have been read, as the array of stream samples could grow
+	for (unsigned int i = 0; i < mixedPlayers_.size(); i++)
+		addVoice(mixedPlayers_[i]);
+
+	mixer_.render(*sink_, numFrames);
+	numMixedFrames_ += numFrames;
+
+	for (unsigned int i = 0; i < mixedPlayers_.size(); i++)
+	{
+		IAudioPlayer *player = mixedPlayers_[i].player;
+		mixer_.removeVoice(mixedPlayers_[i].voiceHandle);
+		// The position of a stream player has already been updated by reading from the stream
+		if (player->type() != AudioStreamPlayer::sType())
+			player->updateVirtualState(mixedInterval);
+	}
+
+	// Players that have just stopped are unregistered (in reverse order)
+	for (int i = players_.size() - 1; i >= 0; i--)
+	{
+		IAudioPlayer *player = players_[i];
+		if (player->isStopped())
+		{
+			player->isVirtual_ = false;
+			players_.unorderedRemoveAt(i);
+		}
+	}
+}
+
+void SoftwareAudioDevice::setSink(nctl::UniquePtr<IAudioSink> sink)
+{
+	if (sink != nullptr)
+		sink_ = nctl::move(sink);
+	else
+		sink_ = nctl::makeUnique<NullAudioSink>();
+}
+
+unsigned int SoftwareAudioDevice::createBuffer()
+{
+	// Ids of deleted buffers are reused
+	unsigned int index = 0;
+	while (index < buffers_.size() && buffers_[index].isUsed)
+		index++;
+	if (index == buffers_.size())
+		buffers_.emplaceBack();
+
+	buffers_[index].isUsed = true;
+	return index + 1;
+}
+
+bool SoftwareAudioDevice::setBufferData(unsigned int bufferId, const unsigned char *bufferPtr, unsigned long int bufferSize,
+                                        int bytesPerSample, int numChannels, int frequency)
+{
+	if (bufferId == 0 || bufferId > buffers_.size() || buffers_[bufferId - 1].isUsed == false)
+		return false;
+	if ((bytesPerSample != 1 && bytesPerSample != 2) || (numChannels != 1 && numChannels != 2) || frequency <= 0)
+		return false;
+
+	Buffer &buffer = buffers_[bufferId - 1];
+	const unsigned long int numSamples = bufferSize / bytesPerSample;
+	buffer.numFrames = numSamples / numChannels;
+	buffer.numChannels = numChannels;
+	buffer.frequency = frequency;
+	buffer.samples.reset(nullptr);
+	if (buffer.numFrames == 0 || bufferPtr == nullptr)
+	{
+		buffer.numFrames = 0;
+		return true;
+	}
+
+	buffer.samples = nctl::makeUnique<int16_t[]>(buffer.numFrames * numChannels);
+	if (bytesPerSample == 2)
+		memcpy(buffer.samples.get(), bufferPtr, buffer.numFrames * numChannels * sizeof(int16_t));
+	else
+	{
+		// 8 bits samples are unsigned and centered at 128
+		for (unsigned long int i = 0; i < buffer.numFrames * numChannels; i++)
+			buffer.samples[i] = static_cast<int16_t>((bufferPtr[i] - 128) * 256);
+	}
+
+	return true;
+}
+
+void SoftwareAudioDevice::deleteBuffer(unsigned int bufferId)
+{
+	if (bufferId == 0 || bufferId > buffers_.size())
+		return;
+
+	buffers_[bufferId - 1] = Buffer();
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+const SoftwareAudioDevice::Buffer *SoftwareAudioDevice::findBuffer(unsigned int bufferId) const
+{
+	if (bufferId == 0 || bufferId > buffers_.size() || buffers_[bufferId - 1].isUsed == false)
+		return nullptr;
+
+	return &buffers_[bufferId - 1];
+}
+
+void SoftwareAudioDevice::readStream(MixedPlayer &mixedPlayer, unsigned int numFrames)
+{
+	AudioStreamPlayer *streamPlayer = static_cast<AudioStreamPlayer *>(mixedPlayer.player);
+	const int numChannels = streamPlayer->numChannels();
+	if (numChannels != 1 && numChannels != 2)
+		return;
+
+	// The stream is read at its own frequency, the mixer resamples it to the output one
+	const double step = (static_cast<double>(streamPlayer->frequency()) * streamPlayer->pitch()) / mixer_.outputFrequency();
+	const unsigned long int numStreamFrames = static_cast<unsigned long int>(numFrames * step + 0.5);
+
+	mixedPlayer.streamOffset = streamSamples_.size();
+	streamSamples_.setSize(mixedPlayer.streamOffset + numStreamFrames * numChannels);
+	mixedPlayer.numStreamFrames = streamPlayer->readFrames(streamSamples_.data() + mixedPlayer.streamOffset, numStreamFrames);
+	streamSamples_.setSize(mixedPlayer.streamOffset + mixedPlayer.numStreamFrames * numChannels);
+}
+
+/*! \note The attenuation follows the same inverse distance clamped model of `IAudioPlayer::audibility()` */
+void SoftwareAudioDevice::addVoice(MixedPlayer &mixedPlayer)
+{
+	const IAudioPlayer &player = *mixedPlayer.player;
+
+	int &handle = mixedPlayer.voiceHandle;
+	if (mixedPlayer.buffer != nullptr && mixedPlayer.buffer->numFrames > 0)
+	{
+		const Buffer &buffer = *mixedPlayer.buffer;
+		handle = mixer_.addVoice(buffer.samples.get(), buffer.numFrames, buffer.numChannels, buffer.frequency);
+	}
+	else if (mixedPlayer.numStreamFrames > 0)
+	{
+		handle = mixer_.addVoice(streamSamples_.data() + mixedPlayer.streamOffset, mixedPlayer.numStreamFrames,
+		                         player.numChannels(), player.frequency());
+	}
+
+	AudioMixer::Voice *voice = mixer_.voice(handle);
+	if (voice == nullptr)
+		return;
+
+	const Vector3f offset = player.isSourceRelative() ? player.position() : player.position() - position_;
+	const float distance = offset.length();
+	const float attenuation = (distance > 1.0f) ? 1.0f / distance : 1.0f;
+
+	voice->gain = gain_ * player.gain() * attenuation;
+	voice->pan = (distance > 0.0f) ? offset.x / distance : 0.0f;
+	voice->pitch = player.pitch();
+	// A stream voice only holds the frames read for this update
+	if (mixedPlayer.buffer != nullptr)
+	{
+		voice->position = static_cast<double>(player.virtualPosition_) * mixedPlayer.buffer->frequency;
+		voice->isLooping = player.isLooping();
+	}
+	voice->isPlaying = true;
+}
+
+}
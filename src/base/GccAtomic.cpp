@@ -12,18 +12,15 @@ int32_t Atomic32::load(MemoryModel memModel)
 	switch (memModel)
 	{
 		case MemoryModel::RELAXED:
-			__atomic_load_n(&value_, __ATOMIC_RELAXED);
-			return value_;
+			return __atomic_load_n(&value_, __ATOMIC_RELAXED);
 		case MemoryModel::ACQUIRE:
-			__atomic_load_n(&value_, __ATOMIC_ACQUIRE);
-			return value_;
+			return __atomic_load_n(&value_, __ATOMIC_ACQUIRE);
 		case MemoryModel::RELEASE:
 			FATAL_MSG("Incompatible memory model");
 			return 0;
 		case MemoryModel::SEQ_CST:
 		default:
-			__atomic_load_n(&value_, __ATOMIC_SEQ_CST);
-			return value_;
+			return __atomic_load_n(&value_, __ATOMIC_SEQ_CST);
 	}
 }
 
@@ -104,18 +101,15 @@ int64_t Atomic64::load(MemoryModel memModel)
 	switch (memModel)
 	{
 		case MemoryModel::RELAXED:
-			__atomic_load_n(&value_, __ATOMIC_RELAXED);
-			return value_;
+			return __atomic_load_n(&value_, __ATOMIC_RELAXED);
 		case MemoryModel::ACQUIRE:
-			__atomic_load_n(&value_, __ATOMIC_ACQUIRE);
-			return value_;
+			return __atomic_load_n(&value_, __ATOMIC_ACQUIRE);
 		case MemoryModel::RELEASE:
 			FATAL_MSG("Incompatible memory model");
 			return 0;
 		case MemoryModel::SEQ_CST:
 		default:
-			__atomic_load_n(&value_, __ATOMIC_SEQ_CST);
-			return value_;
+			return __atomic_load_n(&value_, __ATOMIC_SEQ_CST);
 	}
 }
 
@@ -65,6 +65,33 @@ uint64_t Hash64::hashString(const char *string, int length) const
 	return hashStrings(1, strings, lengths);
 }
 
+/*! \note Unlike strings, the buffer is not copied, only its last bytes are zero-padded */
+uint64_t Hash64::hashBuffer(const void *bufferPtr, unsigned long int bufferSize) const
+{
+	uint64_t hash = 0;
+	ASSERT(bufferPtr != nullptr);
+	if (bufferPtr != nullptr && bufferSize > 0)
+	{
+		// The hash function reads one more 64 bits word after the aligned length
+		const unsigned long int headLength = (bufferSize >= 16) ? bufferSize - 8 - (bufferSize % 8) : 0;
+		if (headLength > 0)
+			hash = nctl::fasthash64(bufferPtr, headLength, HashSeed);
+
+		const unsigned int tailLength = static_cast<unsigned int>(bufferSize - headLength);
+		uint8_t tail[32];
+		const uint8_t *tailPtr = static_cast<const uint8_t *>(bufferPtr) + headLength;
+		for (unsigned int i = 0; i < tailLength; i++)
+			tail[i] = tailPtr[i];
+		for (unsigned int i = tailLength; i < sizeof(tail); i++)
+			tail[i] = 0;
+		hash = hash * 31 + nctl::fasthash64(tail, tailLength, HashSeed);
+
+		statistics_.HashedBuffers++;
+	}
+
+	return hash;
+}
+
 uint64_t Hash64::hashFileStat(const char *filename) const
 {
 	uint64_t hash = 0;
@@ -125,6 +152,7 @@ void Hash64::clearStatistics()
 	statistics_.HashStringCalls = 0;
 	statistics_.HashedStrings = 0;
 	statistics_.HashedCharacters = 0;
+	statistics_.HashedBuffers = 0;
 	statistics_.HashedFiles = 0;
 	statistics_.ScannedHashStrings = 0;
 }
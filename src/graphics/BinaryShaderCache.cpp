@@ -1,33 +1,309 @@
 #include <cstdint>
 #include <cstdlib> // for `strtoull()`
+#include <cstring> // for `memcpy()`
+#include <climits> // for `ULONG_MAX`
 #include <nctl/CString.h>
+#include <nctl/Array.h>
 #include <nctl/HashMapIterator.h>
+#include <nctl/algorithms.h>
 #include "BinaryShaderCache.h"
 #include "IGfxCapabilities.h"
 #include "FileSystem.h"
 #include "IFile.h"
 #include "Hash64.h"
 
+#ifdef _WIN32
+	#include "common_windefines.h"
+	#include <windef.h>
+	#include <winbase.h>
+	#include <fileapi.h>
+	#include <handleapi.h>
+	#include <memoryapi.h>
+	#include <processthreadsapi.h>
+#else
+	#include <cerrno>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
 namespace ncine {
 
 namespace {
 	char const * const ShaderFilenameFormat = "%016llx_%08x_%016llx.bin";
 	char const * const ShaderInfoFilenameFormat = "%016llx_%08x_shaderInfo.txt";
 
-	unsigned int bufferSize = 0;
-	nctl::UniquePtr<uint8_t[]> bufferPtr;
+	/// The "NCSC" four characters code
+	const uint32_t ArchiveMagic = 0x4353434E;
+	const uint32_t ArchiveVersion = 1;
+	/// Minimum number of slots in the table of contents (always a power of two)
+	const uint32_t MinTocCapacity = 64;
+	/// Alignment in bytes of the archive data
+	const unsigned long DataAlignment = 16;
+	/// Passed to `rewriteArchive()` to keep all entries regardless of their size
+	const unsigned long NoByteLimit = ULONG_MAX;
 
 	nctl::String fileBaseName(64);
 	nctl::String filePath(fs::MaxPathLength);
 	char componentString[17] = "\0";
+
+	/// Returns the path of a temporary file next to the specified one, unique to this process
+	nctl::String temporaryPath(const nctl::String &path)
+	{
+		nctl::String tempPath(fs::MaxPathLength);
+#ifdef _WIN32
+		tempPath.format("%s.%lu.tmp", path.data(), static_cast<unsigned long>(GetCurrentProcessId()));
+#else
+		tempPath.format("%s.%lu.tmp", path.data(), static_cast<unsigned long>(getpid()));
+#endif
+		return tempPath;
+	}
+
+	/// Replaces a file with another one in a single step, other processes either open the old file or the new one
+	bool replaceFile(const char *newPath, const char *path)
+	{
+#ifdef _WIN32
+		return (MoveFileExA(newPath, path, MOVEFILE_REPLACE_EXISTING) != 0);
+#else
+		return (::rename(newPath, path) == 0);
+#endif
+	}
+
+	inline unsigned long alignSize(unsigned long size)
+	{
+		return (size + DataAlignment - 1) & ~(DataAlignment - 1);
+	}
+
+	uint64_t tocHash(uint64_t platformHash, uint32_t binaryFormat, uint64_t shaderHash)
+	{
+		// The final mix of MurmurHash3 spreads the components over all the bits used as a slot index
+		uint64_t hash = shaderHash ^ (platformHash * 0x9e3779b97f4a7c15ULL) ^ binaryFormat;
+		hash ^= hash >> 33;
+		hash *= 0xff51afd7ed558ccdULL;
+		hash ^= hash >> 33;
+		hash *= 0xc4ceb9fe1a85ec53ULL;
+		hash ^= hash >> 33;
+		return hash;
+	}
 }
 
+///////////////////////////////////////////////////////////
+// STATIC DEFINITIONS
+///////////////////////////////////////////////////////////
+
+const char *BinaryShaderCache::ArchiveFilename = "binaryShaders.pak";
+
+struct BinaryShaderCache::ArchiveHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	/// Number of slots in the table of contents (always a power of two)
+	uint32_t tocCapacity;
+	uint32_t numEntries;
+	/// Offset of the end of the last binary shader, new ones are appended from here
+	uint64_t dataEnd;
+	/// Incremented every time the archive is opened, it tracks when entries have been used
+	uint32_t session;
+	uint32_t reserved;
+};
+
+struct BinaryShaderCache::TocEntry
+{
+	uint64_t platformHash;
+	uint64_t shaderHash;
+	/// Offset of the binary shader from the start of the archive, zero for an empty slot
+	uint64_t offset;
+	uint32_t binaryFormat;
+	uint32_t length;
+	/// Last session in which the binary shader has been saved or loaded
+	uint32_t lastSession;
+	EntryType type;
+};
+
+/// A private copy of the archive file with its table of contents
+/*! The file is mapped copy-on-write and never modified in place, the data is moved to memory when the archive needs to grow.
+ *  A modified archive is written to a temporary file that then replaces the original one, so that processes sharing the cache never see a partial archive. */
+struct BinaryShaderCache::MappedArchive
+{
+	uint8_t *data = nullptr;
+	unsigned long size = 0;
+	/// True if the archive has been modified and should be written back when closed
+	bool isModified = false;
+
+	MappedArchive() {}
+	~MappedArchive() { close(); }
+
+	/// Move assignment operator, it takes the mapping or the memory of the other archive
+	MappedArchive &operator=(MappedArchive &&other)
+	{
+		close();
+		data = other.data;
+		size = other.size;
+		isModified = other.isModified;
+		isFileMapping_ = other.isFileMapping_;
+		memory_ = nctl::move(other.memory_);
+
+		other.data = nullptr;
+		other.size = 0;
+		other.isModified = false;
+		other.isFileMapping_ = false;
+		return *this;
+	}
+
+	inline ArchiveHeader *header() const { return reinterpret_cast<ArchiveHeader *>(data); }
+	inline TocEntry *toc() const { return reinterpret_cast<TocEntry *>(data + sizeof(ArchiveHeader)); }
+	inline unsigned long dataStart() const { return dataStart(header()->tocCapacity); }
+	static inline unsigned long dataStart(uint32_t tocCapacity) { return alignSize(sizeof(ArchiveHeader) + tocCapacity * sizeof(TocEntry)); }
+
+	/// Maps the archive file, a missing one is an empty archive
+	bool open(const char *path)
+	{
+		close();
+#ifdef _WIN32
+		// Sharing the deletion access lets other processes replace the file while it is opened
+		HANDLE fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (fileHandle == INVALID_HANDLE_VALUE)
+		{
+			const DWORD error = GetLastError();
+			if (error == ERROR_FILE_NOT_FOUND)
+				return true;
+			LOGW_X("Cannot open the binary shader archive \"%s\" (error %u)", path, error);
+			return false;
+		}
+		LARGE_INTEGER fileSize;
+		GetFileSizeEx(fileHandle, &fileSize);
+		size = static_cast<unsigned long>(fileSize.QuadPart);
+		if (size > 0)
+		{
+			HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+			if (mappingHandle != nullptr)
+			{
+				data = static_cast<uint8_t *>(MapViewOfFile(mappingHandle, FILE_MAP_COPY, 0, 0, 0));
+				// The view keeps the mapping alive
+				CloseHandle(mappingHandle);
+			}
+		}
+		CloseHandle(fileHandle);
+#else
+		const int fd = ::open(path, O_RDONLY);
+		if (fd < 0)
+		{
+			if (errno == ENOENT)
+				return true;
+			LOGW_X("Cannot open the binary shader archive \"%s\": %s", path, strerror(errno));
+			return false;
+		}
+		struct stat sb;
+		fstat(fd, &sb);
+		size = static_cast<unsigned long>(sb.st_size);
+		if (size > 0)
+		{
+			void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+			data = (ptr != MAP_FAILED) ? static_cast<uint8_t *>(ptr) : nullptr;
+		}
+		// The mapping keeps a reference to the file
+		::close(fd);
+#endif
+		isFileMapping_ = (data != nullptr);
+		if (size > 0 && data == nullptr)
+		{
+			LOGW_X("Cannot map the binary shader archive \"%s\" (%lu bytes)", path, size);
+			size = 0;
+			return false;
+		}
+		return true;
+	}
+
+	/// Changes the size of the archive by copying it to memory, invalidating all pointers inside it
+	void resize(unsigned long newSize)
+	{
+		nctl::UniquePtr<uint8_t[]> newMemory = nctl::makeUnique<uint8_t[]>(newSize);
+		const unsigned long copySize = (size < newSize) ? size : newSize;
+		if (copySize > 0)
+			memcpy(newMemory.get(), data, copySize);
+		memset(newMemory.get() + copySize, 0, newSize - copySize);
+
+		close();
+		memory_ = nctl::move(newMemory);
+		data = memory_.get();
+		size = newSize;
+	}
+
+	/// Writes the first bytes of the archive to a temporary file in the same directory
+	bool writeTemporary(const char *tempPath, unsigned long writeSize) const
+	{
+		nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(tempPath);
+		fileHandle->open(IFile::OpenMode::WRITE);
+		if (fileHandle->isOpened() == false)
+			return false;
+
+		const unsigned long bytesWritten = fileHandle->write(data, writeSize);
+		fileHandle->close();
+		return (bytesWritten == writeSize);
+	}
+
+	/// Releases the mapping or the memory of the archive without writing it
+	void close()
+	{
+		if (isFileMapping_ && data != nullptr)
+		{
+#ifdef _WIN32
+			UnmapViewOfFile(data);
+#else
+			munmap(data, size);
+#endif
+		}
+		memory_.reset(nullptr);
+		data = nullptr;
+		size = 0;
+		isFileMapping_ = false;
+		isModified = false;
+	}
+
+	TocEntry *find(EntryType type, uint64_t platformHash, uint32_t binaryFormat, uint64_t shaderHash) const
+	{
+		if (data == nullptr)
+			return nullptr;
+
+		TocEntry *entries = toc();
+		const uint32_t mask = header()->tocCapacity - 1;
+		uint32_t index = static_cast<uint32_t>(tocHash(platformHash, binaryFormat, shaderHash) + static_cast<uint32_t>(type)) & mask;
+		// Linear probing, there are always empty slots as the table of contents is kept at most half full
+		while (entries[index].offset != 0)
+		{
+			const TocEntry &entry = entries[index];
+			if (entry.shaderHash == shaderHash && entry.platformHash == platformHash && entry.binaryFormat == binaryFormat && entry.type == type)
+				return &entries[index];
+			index = (index + 1) & mask;
+		}
+		return nullptr;
+	}
+
+	void insert(const TocEntry &newEntry)
+	{
+		TocEntry *entries = toc();
+		const uint32_t mask = header()->tocCapacity - 1;
+		uint32_t index = static_cast<uint32_t>(tocHash(newEntry.platformHash, newEntry.binaryFormat, newEntry.shaderHash) + static_cast<uint32_t>(newEntry.type)) & mask;
+		while (entries[index].offset != 0)
+			index = (index + 1) & mask;
+		entries[index] = newEntry;
+	}
+
+  private:
+	/// True if the data points to a copy-on-write mapping of the file instead of memory
+	bool isFileMapping_ = false;
+	/// The memory holding the archive after it has been resized
+	nctl::UniquePtr<uint8_t[]> memory_;
+};
+
 ///////////////////////////////////////////////////////////
 // CONSTRUCTORS and DESTRUCTOR
 ///////////////////////////////////////////////////////////
 
 BinaryShaderCache::BinaryShaderCache(bool enable, const char *dirname)
-    : isAvailable_(false), isInitialized_(false), isEnabled_(false), binaryFormat_(0), platformHash_(0), shaderInfos_(64)
+    : isAvailable_(false), isInitialized_(false), isEnabled_(false), binaryFormat_(0), platformHash_(0), shaderInfos_(64),
+      maxSize_(DefaultMaxSize)
 {
 	const IGfxCapabilities &gfxCaps = theServiceLocator().gfxCapabilities();
 	const bool isSupported = gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::ARB_GET_PROGRAM_BINARY) &&
@@ -55,6 +331,7 @@ BinaryShaderCache::BinaryShaderCache(bool enable, const char *dirname)
 BinaryShaderCache::~BinaryShaderCache()
 {
 	saveShaderInfoToCache();
+	closeArchive();
 }
 
 ///////////////////////////////////////////////////////////
@@ -137,80 +414,60 @@ BinaryShaderCache::ShaderFilename BinaryShaderCache::formatShaderFilename(uint64
 
 unsigned int BinaryShaderCache::binarySize(uint32_t binaryFormat, uint64_t hash) const
 {
-	if (isEnabled_ == false || isAvailable_ == false)
+	if (isEnabled_ == false || isAvailable_ == false || archive_ == nullptr)
 		return 0;
 
-	fileBaseName.format(ShaderFilenameFormat, platformHash_, binaryFormat, hash);
-	filePath = fs::joinPath(directory_, fileBaseName);
-
-	unsigned int fileSize = 0;
-	if (fs::isFile(filePath.data()))
-		fileSize = fs::fileSize(filePath.data());
-
-	return fileSize;
+	const TocEntry *entry = archive_->find(EntryType::PROGRAM_BINARY, platformHash_, binaryFormat, hash);
+	return (entry != nullptr) ? entry->length : 0;
 }
 
+/*! \note No data is copied, the binary shader is read directly from the archive mapping */
 const void *BinaryShaderCache::loadFromCache(uint32_t binaryFormat, uint64_t hash)
 {
-	if (isEnabled_ == false || isAvailable_ == false)
-		return nullptr;
-
-	bool fileRead = false;
-	fileBaseName.format(ShaderFilenameFormat, platformHash_, binaryFormat, hash);
-	filePath = fs::joinPath(directory_, fileBaseName);
-	if (fs::isReadableFile(filePath.data()))
+	unsigned int length = 0;
+	const void *data = loadEntry(EntryType::PROGRAM_BINARY, binaryFormat, hash, length);
+	if (data != nullptr)
 	{
-		nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(filePath.data());
-		fileHandle->open(IFile::OpenMode::READ | IFile::OpenMode::BINARY);
-		if (fileHandle->isOpened())
-		{
-			const long int fileSize = fileHandle->size();
-			if (bufferSize < fileSize)
-			{
-				bufferSize = fileSize;
-				bufferPtr = nctl::makeUnique<uint8_t[]>(bufferSize);
-			}
+		LOGI_X("Loaded binary shader \"%s\" from cache", fileBaseName.data());
+		statistics_.LoadedShaders++;
+	}
 
-			fileHandle->read(bufferPtr.get(), fileSize);
-			fileHandle->close();
+	return data;
+}
 
-			LOGI_X("Loaded binary shader \"%s\" from cache", fileBaseName.data());
-			statistics_.LoadedShaders++;
-			fileRead = true;
-		}
+bool BinaryShaderCache::saveToCache(int length, const void *buffer, uint32_t binaryFormat, uint64_t hash)
+{
+	const bool entrySaved = saveEntry(EntryType::PROGRAM_BINARY, length, buffer, binaryFormat, hash);
+	if (entrySaved)
+	{
+		LOGI_X("Saved binary shader \"%s\" to cache", fileBaseName.data());
+		statistics_.SavedShaders++;
+		statistics_.PlatformFilesCount++;
+		statistics_.PlatformBytesCount += length;
+		statistics_.TotalFilesCount++;
+		statistics_.TotalBytesCount += length;
 	}
 
-	return (fileRead) ? bufferPtr.get() : nullptr;
+	return entrySaved;
 }
 
-bool BinaryShaderCache::saveToCache(int length, const void *buffer, uint32_t binaryFormat, uint64_t hash)
+/*! \note No data is copied, the introspection data is read directly from the archive mapping */
+const void *BinaryShaderCache::loadIntrospectionFromCache(uint32_t binaryFormat, uint64_t hash, unsigned int &length)
 {
-	if (isEnabled_ == false || isAvailable_ == false || length <= 0)
-		return false;
+	const void *data = loadEntry(EntryType::INTROSPECTION, binaryFormat, hash, length);
+	if (data != nullptr)
+		statistics_.LoadedIntrospections++;
 
-	bool fileWritten = false;
-	fileBaseName.format(ShaderFilenameFormat, platformHash_, binaryFormat, hash);
-	filePath = fs::joinPath(directory_, fileBaseName);
-	if (fs::isFile(filePath.data()) == false)
-	{
-		nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(filePath.data());
-		fileHandle->open(IFile::OpenMode::WRITE | IFile::OpenMode::BINARY);
-		if (fileHandle->isOpened())
-		{
-			fileHandle->write(buffer, length);
-			fileHandle->close();
+	return data;
+}
 
-			LOGI_X("Saved binary shader \"%s\" to cache", fileBaseName.data());
-			statistics_.SavedShaders++;
-			statistics_.PlatformFilesCount++;
-			statistics_.PlatformBytesCount += length;
-			statistics_.TotalFilesCount++;
-			statistics_.TotalBytesCount += length;
-			fileWritten = true;
-		}
-	}
+bool BinaryShaderCache::saveIntrospectionToCache(int length, const void *buffer, uint32_t binaryFormat, uint64_t hash)
+{
+	const bool entrySaved = saveEntry(EntryType::INTROSPECTION, length, buffer, binaryFormat, hash);
+	if (entrySaved)
+		statistics_.SavedIntrospections++;
 
-	return fileWritten;
+	return entrySaved;
 }
 
 bool BinaryShaderCache::hasShaderInfo(uint64_t shaderHashName) const
@@ -237,10 +494,9 @@ bool BinaryShaderCache::registerShaderInfo(uint64_t shaderHashName, uint32_t bin
 		return false;
 
 	fileBaseName.format(ShaderFilenameFormat, platformHash_, binaryFormat, shaderHashName);
-	filePath = fs::joinPath(directory_, fileBaseName);
 
 	bool inserted = false;
-	if (fs::isReadableFile(filePath.data()))
+	if (archive_ != nullptr && archive_->find(EntryType::PROGRAM_BINARY, platformHash_, binaryFormat, shaderHashName) != nullptr)
 	{
 		ShaderInfo shaderInfo;
 		shaderInfo.binaryFilename = fileBaseName.data();
@@ -253,7 +509,7 @@ bool BinaryShaderCache::registerShaderInfo(uint64_t shaderHashName, uint32_t bin
 
 		if (inserted)
 		{
-			LOGI_X("Registering shader \"%s\" (0x%016llx) as binary file \"%s\" with a batch size of %u",
+			LOGI_X("Registering shader \"%s\" (0x%016llx) as binary entry \"%s\" with a batch size of %u",
 			       name, shaderHashName, fileBaseName.data(), batchSize);
 		}
 	}
@@ -266,27 +522,21 @@ bool BinaryShaderCache::registerShaderInfo(uint64_t shaderHashName, const char *
 	return registerShaderInfo(shaderHashName, binaryFormat_, name, batchSize);
 }
 
+/*! \note Binary shader files from the previous cache format are deleted as well */
 void BinaryShaderCache::prune()
 {
-	uint64_t platformHash = 0;
+	if (statistics_.TotalFilesCount > statistics_.PlatformFilesCount)
+		rewriteArchive(false, NoByteLimit, 0);
 
+	uint64_t platformHash = 0;
 	fs::Directory dir(directory_.data());
 	while (const char *entryName = dir.readNext())
 	{
-		if (parseShaderFilename(entryName, &platformHash, nullptr, nullptr))
+		// Binary shaders are not stored in separate files anymore
+		if (isShaderFilename(entryName))
 		{
-			// Deleting only binary shaders with different platform hashes
-			if (platformHash != platformHash_)
-			{
-				filePath = fs::joinPath(directory_, entryName);
-				const long int fileSize = fs::fileSize(filePath.data());
-
-				ASSERT(statistics_.TotalFilesCount > 0);
-				ASSERT(statistics_.TotalBytesCount >= fileSize);
-				fs::deleteFile(filePath.data());
-				statistics_.TotalFilesCount--;
-				statistics_.TotalBytesCount -= fileSize;
-			}
+			filePath = fs::joinPath(directory_, entryName);
+			fs::deleteFile(filePath.data());
 		}
 
 		if (parseShaderInfoFilename(entryName, &platformHash))
@@ -303,11 +553,15 @@ void BinaryShaderCache::prune()
 
 void BinaryShaderCache::clear()
 {
+	// The archive is discarded without being written back
+	if (archive_ != nullptr)
+		archive_->close();
+
 	fs::Directory dir(directory_.data());
 	while (const char *entryName = dir.readNext())
 	{
-		// Deleting all binary shaders and shader information files
-		if (isShaderFilename(entryName) || isShaderInfoFilename(entryName))
+		// Deleting the archive and its temporary files, all shader information files and binary shader files from the previous cache format
+		if (isShaderFilename(entryName) || isShaderInfoFilename(entryName) || strncmp(entryName, ArchiveFilename, strlen(ArchiveFilename)) == 0)
 		{
 			filePath = fs::joinPath(directory_, entryName);
 			fs::deleteFile(filePath.data());
@@ -316,6 +570,24 @@ void BinaryShaderCache::clear()
 
 	clearStatistics();
 	shaderInfos_.clear();
+
+	if (isInitialized_)
+		openArchive();
+}
+
+bool BinaryShaderCache::compact()
+{
+	return rewriteArchive(true, (maxSize_ > 0) ? maxSize_ : NoByteLimit, 0);
+}
+
+void BinaryShaderCache::setMaxSize(unsigned long maxSize)
+{
+	maxSize_ = maxSize;
+	if (maxSize_ > 0 && archive_ != nullptr && archive_->data != nullptr &&
+	    archive_->header()->dataEnd - archive_->dataStart() > maxSize_)
+	{
+		rewriteArchive(true, maxSize_, 0);
+	}
 }
 
 /*! \return True if the path is a writable directory */
@@ -323,7 +595,10 @@ bool BinaryShaderCache::setDirectory(const char *dirPath)
 {
 	if (fs::isDirectory(dirPath) && fs::isWritable(dirPath))
 	{
+		closeArchive();
 		directory_ = dirPath;
+		if (isInitialized_)
+			openArchive();
 		collectStatistics();
 		return true;
 	}
@@ -377,44 +652,306 @@ bool BinaryShaderCache::initialize()
 		// Platform hashing statistics are not counted in shaders hashes (`RenderResources::hash64()`)
 		platformHash_ += hash64().hashString(platformString.data(), platformString.length());
 
-		// Always collect statistics after having calculated the platform hash
-		if (dirExistedAlready)
-			collectStatistics();
+		// Always open the archive and collect statistics after having calculated the platform hash
+		openArchive();
+		collectStatistics();
 
 		loadShaderInfoFromCache();
-
-		bufferSize = 64 * 1024;
-		bufferPtr = nctl::makeUnique<uint8_t[]>(bufferSize);
 		isInitialized_ = true;
 	}
 	return isInitialized_;
 }
 
-void BinaryShaderCache::collectStatistics()
+bool BinaryShaderCache::openArchive()
 {
-	ASSERT(platformHash_ != 0);
+	if (archive_ == nullptr)
+		archive_ = nctl::makeUnique<MappedArchive>();
 
-	clearStatistics();
-	uint64_t platformHash = 0;
+	filePath = fs::joinPath(directory_, ArchiveFilename);
+	if (archive_->open(filePath.data()) == false)
+		return false;
 
-	fs::Directory dir(directory_.data());
-	while (const char *entryName = dir.readNext())
+	bool isValid = (archive_->size >= sizeof(ArchiveHeader));
+	if (isValid)
+	{
+		const ArchiveHeader *header = archive_->header();
+		const uint32_t tocCapacity = header->tocCapacity;
+		isValid = (header->magic == ArchiveMagic && header->version == ArchiveVersion &&
+		           tocCapacity >= MinTocCapacity && (tocCapacity & (tocCapacity - 1)) == 0 &&
+		           MappedArchive::dataStart(tocCapacity) <= header->dataEnd && header->dataEnd <= archive_->size);
+	}
+
+	unsigned int numEntries = 0;
+	if (isValid)
 	{
-		if (parseShaderFilename(entryName, &platformHash, nullptr, nullptr))
+		// The number of entries is recounted and every entry is checked to be inside the data
+		const TocEntry *toc = archive_->toc();
+		const unsigned long dataStart = archive_->dataStart();
+		const uint64_t dataEnd = archive_->header()->dataEnd;
+		for (unsigned int i = 0; i < archive_->header()->tocCapacity; i++)
 		{
-			filePath = fs::joinPath(directory_, entryName);
-			const long int fileSize = fs::fileSize(filePath.data());
+			if (toc[i].offset == 0)
+				continue;
 
-			if (platformHash == platformHash_)
+			if (toc[i].offset < dataStart || toc[i].offset > dataEnd || toc[i].length > dataEnd - toc[i].offset)
 			{
-				statistics_.PlatformFilesCount++;
-				statistics_.PlatformBytesCount += fileSize;
+				isValid = false;
+				break;
 			}
-			statistics_.TotalFilesCount++;
-			statistics_.TotalBytesCount += fileSize;
+			numEntries++;
+		}
+		// Probing relies on the table of contents being at most half full
+		if (numEntries * 2 > archive_->header()->tocCapacity)
+			isValid = false;
+	}
+
+	if (isValid == false)
+	{
+		if (archive_->size > 0)
+			LOGW_X("The binary shader archive \"%s\" is not valid and it will be recreated", filePath.data());
+
+		// A new archive is only created in memory, the file is written when something is saved
+		const unsigned long dataStart = MappedArchive::dataStart(MinTocCapacity);
+		archive_->close();
+		archive_->resize(dataStart);
+
+		ArchiveHeader *header = archive_->header();
+		header->magic = ArchiveMagic;
+		header->version = ArchiveVersion;
+		header->tocCapacity = MinTocCapacity;
+		header->dataEnd = dataStart;
+	}
+
+	// The private copy of the header is updated, the session number is written back only with a modified archive
+	ArchiveHeader *header = archive_->header();
+	header->numEntries = numEntries;
+	header->session++;
+	LOGI_X("Opened binary shader archive \"%s\" with %u entries (%lu bytes)", filePath.data(), numEntries, archive_->size);
+
+	return true;
+}
+
+const void *BinaryShaderCache::loadEntry(EntryType type, uint32_t binaryFormat, uint64_t hash, unsigned int &length)
+{
+	if (isEnabled_ == false || isAvailable_ == false || archive_ == nullptr)
+		return nullptr;
+
+	TocEntry *entry = archive_->find(type, platformHash_, binaryFormat, hash);
+	if (entry == nullptr)
+		return nullptr;
+
+	entry->lastSession = archive_->header()->session;
+	fileBaseName.format(ShaderFilenameFormat, platformHash_, binaryFormat, hash);
+	length = entry->length;
+
+	return archive_->data + entry->offset;
+}
+
+bool BinaryShaderCache::saveEntry(EntryType type, int length, const void *buffer, uint32_t binaryFormat, uint64_t hash)
+{
+	if (isEnabled_ == false || isAvailable_ == false || length <= 0 || archive_ == nullptr || archive_->data == nullptr)
+		return false;
+
+	if (archive_->find(type, platformHash_, binaryFormat, hash) != nullptr)
+		return false;
+
+	fileBaseName.format(ShaderFilenameFormat, platformHash_, binaryFormat, hash);
+	const unsigned long alignedLength = alignSize(static_cast<unsigned long>(length));
+	if (maxSize_ > 0)
+	{
+		if (alignedLength > maxSize_)
+		{
+			LOGW_X("Cache entry \"%s\" is bigger than the maximum cache size (%d bytes)", fileBaseName.data(), length);
+			return false;
+		}
+
+		const unsigned long usedBytes = archive_->header()->dataEnd - archive_->dataStart();
+		if (usedBytes + alignedLength > maxSize_)
+		{
+			// Evicting down to three quarters of the maximum size, to not rewrite the archive on every save
+			const unsigned long targetBytes = maxSize_ / 4 * 3;
+			rewriteArchive(true, (targetBytes > alignedLength) ? targetBytes - alignedLength : 0, 0);
 		}
 	}
-	dir.close();
+
+	// The table of contents is kept at most half full
+	if ((archive_->header()->numEntries + 1) * 2 > archive_->header()->tocCapacity)
+		rewriteArchive(true, NoByteLimit, archive_->header()->numEntries + 1);
+
+	if (archive_->data == nullptr)
+		return false;
+
+	const unsigned long offset = archive_->header()->dataEnd;
+	const unsigned long requiredSize = offset + alignedLength;
+	if (requiredSize > archive_->size)
+	{
+		// Growing geometrically to not remap the archive on every save
+		const unsigned long newSize = (archive_->size * 2 > requiredSize) ? archive_->size * 2 : requiredSize;
+		archive_->resize(newSize);
+	}
+
+	ArchiveHeader *header = archive_->header();
+	memcpy(archive_->data + offset, buffer, length);
+	header->dataEnd = requiredSize;
+
+	TocEntry entry;
+	entry.platformHash = platformHash_;
+	entry.shaderHash = hash;
+	entry.offset = offset;
+	entry.binaryFormat = binaryFormat;
+	entry.length = static_cast<uint32_t>(length);
+	entry.lastSession = header->session;
+	entry.type = type;
+	archive_->insert(entry);
+	header->numEntries++;
+	archive_->isModified = true;
+
+	return true;
+}
+
+/*! \note If two processes modify the archive at the same time, the one that closes it last replaces the changes of the other */
+void BinaryShaderCache::closeArchive()
+{
+	if (archive_ == nullptr)
+		return;
+
+	if (archive_->isModified && archive_->data != nullptr)
+	{
+		const nctl::String archivePath = fs::joinPath(directory_, ArchiveFilename);
+		const nctl::String tempPath = temporaryPath(archivePath);
+
+		// The space reserved by the geometric growth is not written
+		const unsigned long archiveSize = static_cast<unsigned long>(archive_->header()->dataEnd);
+		const bool tempWritten = archive_->writeTemporary(tempPath.data(), archiveSize);
+		// The archive is released before replacing the file, as on Windows a mapped file cannot be replaced
+		archive_->close();
+
+		if (tempWritten && replaceFile(tempPath.data(), archivePath.data()))
+			LOGI_X("Written binary shader archive \"%s\" (%lu bytes)", archivePath.data(), archiveSize);
+		else
+		{
+			LOGW_X("Cannot write the binary shader archive \"%s\"", archivePath.data());
+			fs::deleteFile(tempPath.data());
+		}
+	}
+	archive_->close();
+}
+
+/*! \note Binary shaders evicted from this platform are removed from the shader information hashmap too */
+bool BinaryShaderCache::rewriteArchive(bool keepOtherPlatforms, unsigned long maxBytes, unsigned int minEntriesCapacity)
+{
+	if (archive_ == nullptr || archive_->data == nullptr)
+		return false;
+
+	const ArchiveHeader *header = archive_->header();
+	const TocEntry *toc = archive_->toc();
+
+	nctl::Array<TocEntry> entries(header->numEntries > 0 ? header->numEntries : 1);
+	unsigned int numPruned = 0;
+	for (unsigned int i = 0; i < header->tocCapacity; i++)
+	{
+		if (toc[i].offset == 0)
+			continue;
+
+		if (keepOtherPlatforms || toc[i].platformHash == platformHash_)
+			entries.pushBack(toc[i]);
+		else
+			numPruned++;
+	}
+
+	unsigned int numEvicted = 0;
+	if (maxBytes != NoByteLimit)
+	{
+		// The most recently used entries are kept, the last appended ones first when used in the same session
+		nctl::quicksort(entries.begin(), entries.end(), [](const TocEntry &a, const TocEntry &b) {
+			return (a.lastSession > b.lastSession || (a.lastSession == b.lastSession && a.offset > b.offset));
+		});
+
+		unsigned long numBytes = 0;
+		unsigned int numKept = 0;
+		while (numKept < entries.size() && numBytes + alignSize(entries[numKept].length) <= maxBytes)
+		{
+			numBytes += alignSize(entries[numKept].length);
+			numKept++;
+		}
+
+		for (unsigned int i = numKept; i < entries.size(); i++)
+		{
+			if (entries[i].platformHash == platformHash_ && entries[i].type == EntryType::PROGRAM_BINARY)
+				shaderInfos_.remove(entries[i].shaderHash);
+		}
+		numEvicted = entries.size() - numKept;
+		entries.setSize(numKept);
+	}
+
+	const unsigned int numEntries = (entries.size() > minEntriesCapacity) ? entries.size() : minEntriesCapacity;
+	uint32_t tocCapacity = MinTocCapacity;
+	// Leaving room for the number of entries to double before the table of contents is half full
+	while (tocCapacity < numEntries * 4)
+		tocCapacity *= 2;
+
+	const unsigned long dataStart = MappedArchive::dataStart(tocCapacity);
+	unsigned long dataEnd = dataStart;
+	for (const TocEntry &entry : entries)
+		dataEnd += alignSize(entry.length);
+
+	MappedArchive newArchive;
+	newArchive.resize(dataEnd);
+
+	ArchiveHeader *newHeader = newArchive.header();
+	newHeader->magic = ArchiveMagic;
+	newHeader->version = ArchiveVersion;
+	newHeader->tocCapacity = tocCapacity;
+	newHeader->numEntries = entries.size();
+	newHeader->session = header->session;
+
+	unsigned long offset = dataStart;
+	for (TocEntry &entry : entries)
+	{
+		memcpy(newArchive.data + offset, archive_->data + entry.offset, entry.length);
+		entry.offset = offset;
+		newArchive.insert(entry);
+		offset += alignSize(entry.length);
+	}
+	newHeader->dataEnd = dataEnd;
+
+	// The rewritten archive replaces the file when it is closed
+	*archive_ = nctl::move(newArchive);
+	archive_->isModified = true;
+
+	LOGI_X("Rewritten binary shader archive with %u entries (%u evicted, %u pruned) and %u table of contents slots",
+	       entries.size(), numEvicted, numPruned, tocCapacity);
+	statistics_.Compactions++;
+	statistics_.EvictedShaders += numEvicted;
+	collectStatistics();
+
+	return true;
+}
+
+void BinaryShaderCache::collectStatistics()
+{
+	statistics_.PlatformFilesCount = 0;
+	statistics_.PlatformBytesCount = 0;
+	statistics_.TotalFilesCount = 0;
+	statistics_.TotalBytesCount = 0;
+
+	if (archive_ == nullptr || archive_->data == nullptr)
+		return;
+
+	const TocEntry *toc = archive_->toc();
+	for (unsigned int i = 0; i < archive_->header()->tocCapacity; i++)
+	{
+		if (toc[i].offset == 0 || toc[i].type != EntryType::PROGRAM_BINARY)
+			continue;
+
+		if (toc[i].platformHash == platformHash_)
+		{
+			statistics_.PlatformFilesCount++;
+			statistics_.PlatformBytesCount += toc[i].length;
+		}
+		statistics_.TotalFilesCount++;
+		statistics_.TotalBytesCount += toc[i].length;
+	}
 }
 
 void BinaryShaderCache::clearStatistics()
@@ -425,6 +962,10 @@ void BinaryShaderCache::clearStatistics()
 	statistics_.PlatformBytesCount = 0;
 	statistics_.TotalFilesCount = 0;
 	statistics_.TotalBytesCount = 0;
+	statistics_.LoadedIntrospections = 0;
+	statistics_.SavedIntrospections = 0;
+	statistics_.Compactions = 0;
+	statistics_.EvictedShaders = 0;
 }
 
 bool BinaryShaderCache::loadShaderInfoFromCache(uint32_t binaryFormat)
@@ -464,10 +1005,10 @@ bool BinaryShaderCache::loadShaderInfoFromCache(uint32_t binaryFormat)
 					// Generate the binary shader filename from its shader hash name
 					shaderInfo.binaryFilename.format(ShaderFilenameFormat, platformHash_, binaryFormat, shaderHashName);
 
-					// Insert in the hashmap only if the binary shader file exists
-					if (fs::isReadableFile(fs::joinPath(directory_, shaderInfo.binaryFilename.data()).data()))
+					// Insert in the hashmap only if the binary shader is in the archive
+					if (archive_ != nullptr && archive_->find(EntryType::PROGRAM_BINARY, platformHash_, binaryFormat, shaderHashName) != nullptr)
 					{
-						LOGD_X("Shader information entry (file found): \"%s\", \"%s\", %d",
+						LOGD_X("Shader information entry (binary found): \"%s\", \"%s\", %d",
 						       shaderInfo.binaryFilename.data(), shaderInfo.objectLabel.data(), shaderInfo.batchSize);
 
 						if (shaderInfos_.loadFactor() >= 0.8f)
@@ -476,7 +1017,7 @@ bool BinaryShaderCache::loadShaderInfoFromCache(uint32_t binaryFormat)
 						insertedEntries = inserted ? insertedEntries + 1 : insertedEntries;
 					}
 					else
-						LOGW_X("Shader information entry (file not found): \"%s\", \"%s\", %d",
+						LOGW_X("Shader information entry (binary not found): \"%s\", \"%s\", %d",
 						       shaderInfo.binaryFilename.data(), shaderInfo.objectLabel.data(), shaderInfo.batchSize);
 				}
 			}
@@ -496,9 +1037,10 @@ bool BinaryShaderCache::saveShaderInfoToCache(uint32_t binaryFormat)
 	bool fileWritten = false;
 	fileBaseName.format(ShaderInfoFilenameFormat, platformHash_, binaryFormat);
 	filePath = fs::joinPath(directory_, fileBaseName);
+	const nctl::String tempPath = temporaryPath(filePath);
 
-	nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(filePath.data());
-	// The file is recreated from scratch all the times, even if it existed already
+	// The file is recreated from scratch all the times, and it replaces the old one only when complete
+	nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(tempPath.data());
 	fileHandle->open(IFile::OpenMode::WRITE);
 	if (fileHandle->isOpened())
 	{
@@ -509,10 +1051,14 @@ bool BinaryShaderCache::saveShaderInfoToCache(uint32_t binaryFormat)
 			shaderInfoLines.formatAppend("%016llx,%s,%u\n", i.key(), i.value().objectLabel.data(), i.value().batchSize);
 		}
 
-		fileHandle->write(shaderInfoLines.data(), shaderInfoLines.length());
+		const unsigned long bytesWritten = fileHandle->write(shaderInfoLines.data(), shaderInfoLines.length());
 		fileHandle->close();
-		LOGI_X("Saved binary shader information text \"%s\" to cache", fileBaseName.data());
-		fileWritten = true;
+
+		fileWritten = (bytesWritten == shaderInfoLines.length() && replaceFile(tempPath.data(), filePath.data()));
+		if (fileWritten)
+			LOGI_X("Saved binary shader information text \"%s\" to cache", fileBaseName.data());
+		else
+			fs::deleteFile(tempPath.data());
 	}
 
 	return fileWritten;
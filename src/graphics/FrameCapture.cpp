@@ -0,0 +1,393 @@
+#include <cstring> // for memcpy()
+#include "common_macros.h"
+#include "FrameCapture.h"
+#include "FileSystem.h"
+#include "Application.h"
+#include "Viewport.h"
+#include "GLBufferObject.h"
+#include "GLFramebufferObject.h"
+#include "GLDebug.h"
+#include "IThreadPool.h"
+#include "Timer.h" // for `sleep()`
+#include "tracy.h"
+#include "tracy_opengl.h"
+
+#ifdef WITH_PNG
+	#include "TextureSaverPng.h"
+#endif
+#ifdef WITH_WEBP
+	#include "TextureSaverWebP.h"
+#endif
+
+#ifdef WITH_QT5
+	#include "Qt5GfxDevice.h"
+#endif
+
+namespace ncine {
+
+namespace {
+
+	/// Bytes per pixel of the captured frames, always read as RGBA8
+	const unsigned int Bpp = 4;
+
+	/// Timeout in nanoseconds of a single wait for a fence when the ring is full
+	const GLuint64 FenceWaitTimeout = 1000000;
+
+	void saveFrame(unsigned char *pixels, int width, int height, const char *filename)
+	{
+		ITextureSaver::Properties properties;
+		properties.width = width;
+		properties.height = height;
+		properties.format = ITextureSaver::Format::RGBA8;
+		// OpenGL reads pixels from the bottom row
+		properties.verticalFlip = true;
+		properties.pixels = pixels;
+
+#ifdef WITH_PNG
+		if (fs::hasExtension(filename, "png"))
+		{
+			TextureSaverPng saver;
+			saver.saveToFile(properties, filename);
+		}
+#endif
+#ifdef WITH_WEBP
+		if (fs::hasExtension(filename, "webp"))
+		{
+			TextureSaverWebP saver;
+			saver.saveToFile(properties, filename);
+		}
+#endif
+	}
+
+	/// A command to encode a captured frame on a worker thread
+	/*! The pending counter is decremented on destruction, also when the thread pool drops the command without executing it. */
+	class EncodeFrameCommand : public IThreadCommand
+	{
+	  public:
+		EncodeFrameCommand(nctl::UniquePtr<unsigned char[]> pixels, int width, int height, const nctl::String &filename,
+		                   nctl::Atomic32 &numPendingEncodings, nctl::Atomic32 &numSavedFrames)
+		    : pixels_(nctl::move(pixels)), width_(width), height_(height), filename_(filename),
+		      numPendingEncodings_(numPendingEncodings), numSavedFrames_(numSavedFrames) {}
+
+		// Decremented last, as the capture object waits for this counter to reach zero before being destroyed
+		~EncodeFrameCommand() override { numPendingEncodings_.fetchSub(1); }
+
+		void execute() override
+		{
+			ZoneScopedN("Encode captured frame");
+			saveFrame(pixels_.get(), width_, height_, filename_.data());
+			numSavedFrames_.fetchAdd(1);
+		}
+
+	  private:
+		nctl::UniquePtr<unsigned char[]> pixels_;
+		int width_;
+		int height_;
+		nctl::String filename_;
+		nctl::Atomic32 &numPendingEncodings_;
+		nctl::Atomic32 &numSavedFrames_;
+	};
+
+}
+
+struct FrameCapture::Slot
+{
+	Slot()
+	    : fence(nullptr), width(0), height(0) {}
+
+	nctl::UniquePtr<GLBufferObject> pbo;
+	GLsync fence;
+	int width;
+	int height;
+	nctl::String filename;
+};
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+FrameCapture::FrameCapture()
+    : numBuffers_(0), nextSlot_(0), oldestSlot_(0), numInFlight_(0), requests_(4),
+      isRecording_(false), recordingFrame_(0), maxPendingEncodings_(16), numDroppedFrames_(0)
+{
+	setNumBuffers(DefaultNumBuffers);
+}
+
+FrameCapture::~FrameCapture()
+{
+	retireAllSlots();
+	waitForEncodings();
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+bool FrameCapture::captureScreen(const char *filename)
+{
+	ASSERT(filename);
+	if (isSupportedFile(filename) == false)
+	{
+		LOGW_X("Cannot capture the screen to \"%s\", unsupported file format", filename);
+		return false;
+	}
+
+	Request request;
+	request.filename = filename;
+	requests_.pushBack(nctl::move(request));
+	return true;
+}
+
+bool FrameCapture::captureViewport(Viewport &viewport, const char *filename)
+{
+	ASSERT(filename);
+	if (viewport.type() != Viewport::Type::WITH_TEXTURE || viewport.fbo_ == nullptr)
+	{
+		LOGW_X("Cannot capture a viewport without a texture to \"%s\"", filename);
+		return false;
+	}
+	else if (isSupportedFile(filename) == false)
+	{
+		LOGW_X("Cannot capture a viewport to \"%s\", unsupported file format", filename);
+		return false;
+	}
+
+	Request request;
+	request.viewport = &viewport;
+	request.filename = filename;
+	requests_.pushBack(nctl::move(request));
+	return true;
+}
+
+bool FrameCapture::startRecording(const char *filenameFormat)
+{
+	ASSERT(filenameFormat);
+	if (isSupportedFile(filenameFormat) == false)
+	{
+		LOGW_X("Cannot record frames to \"%s\", unsupported file format", filenameFormat);
+		return false;
+	}
+
+	recordingFormat_ = filenameFormat;
+	recordingFrame_ = 0;
+	numDroppedFrames_ = 0;
+	isRecording_ = true;
+	LOGI_X("Started recording frames to \"%s\"", filenameFormat);
+	return true;
+}
+
+void FrameCapture::stopRecording()
+{
+	if (isRecording_)
+	{
+		isRecording_ = false;
+		LOGI_X("Stopped recording after %u frames, %u dropped", recordingFrame_, numDroppedFrames_);
+	}
+}
+
+/*! \note Changing the number of buffers while read backs are in flight will force them to complete. */
+void FrameCapture::setNumBuffers(unsigned int numBuffers)
+{
+	if (numBuffers < 1)
+		numBuffers = 1;
+	else if (numBuffers > MaxNumBuffers)
+		numBuffers = MaxNumBuffers;
+
+	if (numBuffers == numBuffers_)
+		return;
+
+	retireAllSlots();
+
+	slots_ = nctl::makeUnique<Slot[]>(numBuffers);
+#if !defined(__EMSCRIPTEN__)
+	for (unsigned int i = 0; i < numBuffers; i++)
+	{
+		slots_[i].pbo = nctl::makeUnique<GLBufferObject>(GL_PIXEL_PACK_BUFFER);
+		slots_[i].pbo->setObjectLabel("FrameCapture_PBO");
+	}
+#endif
+	numBuffers_ = numBuffers;
+	nextSlot_ = 0;
+	oldestSlot_ = 0;
+}
+
+unsigned int FrameCapture::numPendingEncodings() const
+{
+	return static_cast<unsigned int>(numPendingEncodings_.load());
+}
+
+unsigned int FrameCapture::numSavedFrames() const
+{
+	return static_cast<unsigned int>(numSavedFrames_.load());
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void FrameCapture::onFrameEnd()
+{
+	// Read backs issued in previous frames are retired in order as soon as their fence is signaled
+	while (numInFlight_ > 0 && retireOldestSlot(false)) {}
+
+	if (isRecording_)
+	{
+		// Recorded frames are dropped instead of accumulating in memory when the encoding cannot keep up
+		if (numPendingEncodings() + numInFlight_ < maxPendingEncodings_)
+		{
+			Request request;
+			request.filename.format(recordingFormat_.data(), recordingFrame_);
+			requests_.pushBack(nctl::move(request));
+		}
+		else
+			numDroppedFrames_++;
+		recordingFrame_++;
+	}
+
+	if (requests_.isEmpty())
+		return;
+
+	ZoneScoped;
+	GLDebug::ScopedGroup scoped("FrameCapture::onFrameEnd()");
+	for (unsigned int i = 0; i < requests_.size(); i++)
+	{
+		// Waiting for the oldest read back only happens when the GPU is more than a ring behind
+		if (numInFlight_ == numBuffers_)
+			retireOldestSlot(true);
+		issueReadback(requests_[i]);
+	}
+	requests_.clear();
+}
+
+void FrameCapture::issueReadback(const Request &request)
+{
+	const int width = request.viewport ? request.viewport->width() : theApplication().widthInt();
+	const int height = request.viewport ? request.viewport->height() : theApplication().heightInt();
+	if (width <= 0 || height <= 0)
+		return;
+
+	if (request.viewport)
+		request.viewport->fbo_->bind(GL_READ_FRAMEBUFFER);
+	else
+	{
+#ifdef WITH_QT5
+		Qt5GfxDevice &gfxDevice = static_cast<Qt5GfxDevice &>(theApplication().gfxDevice());
+		gfxDevice.bindDefaultReadFramebufferObject();
+#else
+		GLFramebufferObject::unbind(GL_READ_FRAMEBUFFER);
+#endif
+	}
+
+	const unsigned long dataSize = static_cast<unsigned long>(width) * height * Bpp;
+#if defined(__EMSCRIPTEN__)
+	// Buffer mapping for reading is not available in WebGL, pixels are read synchronously
+	nctl::UniquePtr<unsigned char[]> pixels = nctl::makeUnique<unsigned char[]>(dataSize);
+	{
+		TracyGpuZone("glReadPixels");
+		glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.get());
+	}
+	numPendingEncodings_.fetchAdd(1);
+	EncodeFrameCommand command(nctl::move(pixels), width, height, request.filename, numPendingEncodings_, numSavedFrames_);
+	command.execute();
+#else
+	Slot &slot = slots_[nextSlot_];
+	ASSERT(slot.fence == nullptr);
+
+	if (slot.pbo->size() < static_cast<GLsizeiptr>(dataSize))
+		slot.pbo->bufferData(dataSize, nullptr, GL_STREAM_READ);
+
+	slot.pbo->bind();
+	{
+		TracyGpuZone("glReadPixels");
+		// With a pixel pack buffer bound the call returns immediately and the copy happens asynchronously
+		glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	}
+	slot.pbo->unbind();
+
+	slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	slot.width = width;
+	slot.height = height;
+	slot.filename = request.filename;
+
+	nextSlot_ = (nextSlot_ + 1) % numBuffers_;
+	numInFlight_++;
+#endif
+}
+
+bool FrameCapture::retireOldestSlot(bool waitForCompletion)
+{
+	if (numInFlight_ == 0)
+		return false;
+
+	Slot &slot = slots_[oldestSlot_];
+	if (waitForCompletion)
+	{
+		ZoneScopedN("Wait for read back");
+		GLenum status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, FenceWaitTimeout);
+		while (status == GL_TIMEOUT_EXPIRED)
+			status = glClientWaitSync(slot.fence, 0, FenceWaitTimeout);
+	}
+	else
+	{
+		const GLenum status = glClientWaitSync(slot.fence, 0, 0);
+		if (status == GL_TIMEOUT_EXPIRED)
+			return false;
+	}
+	glDeleteSync(slot.fence);
+	slot.fence = nullptr;
+
+	const unsigned long dataSize = static_cast<unsigned long>(slot.width) * slot.height * Bpp;
+	nctl::UniquePtr<unsigned char[]> pixels = nctl::makeUnique<unsigned char[]>(dataSize);
+	const void *mappedPixels = slot.pbo->mapBufferRange(0, dataSize, GL_MAP_READ_BIT);
+	if (mappedPixels != nullptr)
+		memcpy(pixels.get(), mappedPixels, dataSize);
+	slot.pbo->unmap();
+	slot.pbo->unbind();
+
+	oldestSlot_ = (oldestSlot_ + 1) % numBuffers_;
+	numInFlight_--;
+
+	if (mappedPixels == nullptr)
+	{
+		LOGW_X("Cannot map the pixel buffer for \"%s\"", slot.filename.data());
+		return true;
+	}
+
+	numPendingEncodings_.fetchAdd(1);
+	nctl::UniquePtr<EncodeFrameCommand> command = nctl::makeUnique<EncodeFrameCommand>(nctl::move(pixels), slot.width, slot.height,
+	                                                                                    slot.filename, numPendingEncodings_, numSavedFrames_);
+	IThreadPool &threadPool = theServiceLocator().threadPool();
+	if (threadPool.numThreads() > 0)
+		threadPool.enqueueCommand(nctl::move(command));
+	else
+		command->execute();
+
+	return true;
+}
+
+void FrameCapture::retireAllSlots()
+{
+	while (numInFlight_ > 0)
+		retireOldestSlot(true);
+}
+
+void FrameCapture::waitForEncodings()
+{
+	while (numPendingEncodings_.load() > 0)
+		Timer::sleep(1);
+}
+
+bool FrameCapture::isSupportedFile(const char *filename)
+{
+#ifdef WITH_PNG
+	if (fs::hasExtension(filename, "png"))
+		return true;
+#endif
+#ifdef WITH_WEBP
+	if (fs::hasExtension(filename, "webp"))
+		return true;
+#endif
+	return false;
+}
+
+}
@@ -13,22 +13,224 @@
 	#include "TextureLoaderPkm.h"
 #endif
 #include "FileSystem.h"
+#include <nctl/algorithms.h>
+#include <cmath>
+#include <cstring> // for memcpy()
+#include "ParallelAlgorithms.h"
 
 namespace ncine {
 
+namespace {
+
+	/// The 4x4 Bayer matrix used for ordered dithering
+	const unsigned int BayerMatrix[16] = {
+		0, 8, 2, 10,
+		12, 4, 14, 6,
+		3, 11, 1, 9,
+		15, 7, 13, 5
+	};
+
+	/// Fills the four quantization biases for a pixel row, either for rounding or for ordered dithering
+	void rowBiases(unsigned int biases[4], unsigned int row, bool withDithering)
+	{
+		for (unsigned int i = 0; i < 4; i++)
+		{
+			// A bias uniformly distributed in [0, 255) dithers the truncation of `(value * maxValue + bias) / 255`
+			biases[i] = withDithering ? BayerMatrix[(row & 3) * 4 + i] * 16 + 8 : 127;
+		}
+	}
+
+	/// Quantizes an 8 bits channel value to the range [0, `MaxValue`]
+	template <unsigned int MaxValue>
+	inline uint16_t quantize(unsigned int value, unsigned int bias)
+	{
+		return static_cast<uint16_t>((value * MaxValue + bias) / 255);
+	}
+
+	// The row kernels are written as simple loops without branches to help compiler auto-vectorization
+
+	void rowToRgb565(uint16_t *dest, const GLubyte *src, unsigned int width, unsigned int srcChannels, const unsigned int biases[4])
+	{
+		for (unsigned int x = 0; x < width; x++)
+		{
+			const GLubyte *pixel = src + x * srcChannels;
+			const unsigned int bias = biases[x & 3];
+			dest[x] = (quantize<31>(pixel[0], bias) << 11) | (quantize<63>(pixel[1], bias) << 5) | quantize<31>(pixel[2], bias);
+		}
+	}
+
+	void rowToRgba4(uint16_t *dest, const GLubyte *src, unsigned int width, unsigned int srcChannels, const unsigned int biases[4])
+	{
+		for (unsigned int x = 0; x < width; x++)
+		{
+			const GLubyte *pixel = src + x * srcChannels;
+			const unsigned int bias = biases[x & 3];
+			const unsigned int alpha = (srcChannels == 4) ? pixel[3] : 255;
+			dest[x] = (quantize<15>(pixel[0], bias) << 12) | (quantize<15>(pixel[1], bias) << 8) |
+			          (quantize<15>(pixel[2], bias) << 4) | quantize<15>(alpha, bias);
+		}
+	}
+
+	void rowToRgb5A1(uint16_t *dest, const GLubyte *src, unsigned int width, unsigned int srcChannels, const unsigned int biases[4])
+	{
+		for (unsigned int x = 0; x < width; x++)
+		{
+			const GLubyte *pixel = src + x * srcChannels;
+			const unsigned int bias = biases[x & 3];
+			const unsigned int alpha = (srcChannels == 4) ? pixel[3] : 255;
+			dest[x] = (quantize<31>(pixel[0], bias) << 11) | (quantize<31>(pixel[1], bias) << 6) |
+			          (quantize<31>(pixel[2], bias) << 1) | (alpha >> 7);
+		}
+	}
+
+	void rowToR8(GLubyte *dest, const GLubyte *src, unsigned int width, unsigned int srcChannels)
+	{
+		for (unsigned int x = 0; x < width; x++)
+		{
+			const GLubyte *pixel = src + x * srcChannels;
+			// Integer approximation of Rec. 601 luma coefficients
+			dest[x] = static_cast<GLubyte>((77 * pixel[0] + 150 * pixel[1] + 29 * pixel[2] + 128) >> 8);
+		}
+	}
+
+	/// Lookup tables to convert between sRGB and linear color values
+	struct GammaTables
+	{
+		static const unsigned int LinearToSrgbSize = 4096;
+
+		float srgbToLinear[256];
+		GLubyte linearToSrgb[LinearToSrgbSize];
+
+		GammaTables()
+		{
+			for (unsigned int i = 0; i < 256; i++)
+			{
+				const float value = i / 255.0f;
+				srgbToLinear[i] = (value <= 0.04045f) ? value / 12.92f : powf((value + 0.055f) / 1.055f, 2.4f);
+			}
+			for (unsigned int i = 0; i < LinearToSrgbSize; i++)
+			{
+				const float value = i / static_cast<float>(LinearToSrgbSize - 1);
+				const float srgb = (value <= 0.0031308f) ? value * 12.92f : 1.055f * powf(value, 1.0f / 2.4f) - 0.055f;
+				linearToSrgb[i] = static_cast<GLubyte>(srgb * 255.0f + 0.5f);
+			}
+		}
+	};
+
+	const GammaTables &gammaTables()
+	{
+		static GammaTables tables;
+		return tables;
+	}
+
+	/// The parameters needed to downsample a range of rows of a MIP map level
+	struct MipRowsJob
+	{
+		const GLubyte *src;
+		GLubyte *dest;
+		int srcWidth;
+		int srcHeight;
+		int destWidth;
+		int firstRow;
+		int lastRow;
+		unsigned int numChannels;
+		bool gammaCorrect;
+	};
+
+	/// Downsamples a range of rows with a 2x2 box filter, optionally averaging color channels in linear space
+	/*! A source axis of a single pixel is not halved, its pixel is sampled twice. */
+	void downsampleRows(const MipRowsJob &job)
+	{
+		const GammaTables &tables = gammaTables();
+		const unsigned int channels = job.numChannels;
+		// The alpha channel is always averaged linearly
+		const unsigned int colorChannels = (job.gammaCorrect) ? (channels == 4 ? 3 : channels) : 0;
+		const unsigned int srcStride = job.srcWidth * channels;
+
+		for (int y = job.firstRow; y < job.lastRow; y++)
+		{
+			const GLubyte *srcRow0 = job.src + (2 * y) * srcStride;
+			const GLubyte *srcRow1 = (job.srcHeight > 1) ? srcRow0 + srcStride : srcRow0;
+			const unsigned int nextColumn = (job.srcWidth > 1) ? channels : 0;
+			GLubyte *destRow = job.dest + y * job.destWidth * channels;
+
+			for (int x = 0; x < job.destWidth; x++)
+			{
+				const GLubyte *p00 = srcRow0 + (2 * x) * channels;
+				const GLubyte *p01 = p00 + nextColumn;
+				const GLubyte *p10 = srcRow1 + (2 * x) * channels;
+				const GLubyte *p11 = p10 + nextColumn;
+
+				for (unsigned int c = 0; c < colorChannels; c++)
+				{
+					const float linear = (tables.srgbToLinear[p00[c]] + tables.srgbToLinear[p01[c]] +
+					                      tables.srgbToLinear[p10[c]] + tables.srgbToLinear[p11[c]]) * 0.25f;
+					destRow[x * channels + c] = tables.linearToSrgb[static_cast<unsigned int>(linear * (GammaTables::LinearToSrgbSize - 1) + 0.5f)];
+				}
+				for (unsigned int c = colorChannels; c < channels; c++)
+					destRow[x * channels + c] = static_cast<GLubyte>((p00[c] + p01[c] + p10[c] + p11[c] + 2) >> 2);
+			}
+		}
+	}
+
+	/// Downsamples the chunk of rows assigned by `parallelFor()`
+	void downsampleRowsChunk(unsigned int firstRow, unsigned int lastRow, unsigned int chunkIndex, void *userData)
+	{
+		MipRowsJob job = *static_cast<const MipRowsJob *>(userData);
+		job.firstRow = static_cast<int>(firstRow);
+		job.lastRow = static_cast<int>(lastRow);
+		downsampleRows(job);
+	}
+
+	/// Downsamples a whole MIP map level, splitting rows among the thread pool workers and the calling thread
+	void downsampleLevel(MipRowsJob job, int destHeight)
+	{
+		// Small levels are not worth the synchronization overhead
+		const unsigned int MinRowsPerJob = 32;
+		parallelFor(destHeight, MinRowsPerJob, downsampleRowsChunk, &job);
+	}
+
+	void convertLevel(GLubyte *dest, const GLubyte *src, int width, int height, unsigned int srcChannels, GLenum internalFormat, bool withDithering)
+	{
+		unsigned int biases[4];
+		for (int y = 0; y < height; y++)
+		{
+			const GLubyte *srcRow = src + y * width * srcChannels;
+			rowBiases(biases, y, withDithering);
+
+			switch (internalFormat)
+			{
+				case GL_RGB565:
+					rowToRgb565(reinterpret_cast<uint16_t *>(dest) + y * width, srcRow, width, srcChannels, biases);
+					break;
+				case GL_RGBA4:
+					rowToRgba4(reinterpret_cast<uint16_t *>(dest) + y * width, srcRow, width, srcChannels, biases);
+					break;
+				case GL_RGB5_A1:
+					rowToRgb5A1(reinterpret_cast<uint16_t *>(dest) + y * width, srcRow, width, srcChannels, biases);
+					break;
+				case GL_R8:
+					rowToR8(dest + y * width, srcRow, width, srcChannels);
+					break;
+			}
+		}
+	}
+
+}
+
 ///////////////////////////////////////////////////////////
 // CONSTRUCTORS and DESTRUCTOR
 ///////////////////////////////////////////////////////////
 
 ITextureLoader::ITextureLoader()
     : hasLoaded_(false), width_(0), height_(0),
-      headerSize_(0), dataSize_(0), mipMapCount_(1)
+      headerSize_(0), dataSize_(0), mipMapCount_(1), filePixels_(nullptr)
 {
 }
 
 ITextureLoader::ITextureLoader(nctl::UniquePtr<IFile> fileHandle)
     : hasLoaded_(false), fileHandle_(nctl::move(fileHandle)),
-      width_(0), height_(0), headerSize_(0), dataSize_(0), mipMapCount_(1)
+      width_(0), height_(0), headerSize_(0), dataSize_(0), mipMapCount_(1), filePixels_(nullptr)
 {
 }
 
@@ -51,18 +253,149 @@ long ITextureLoader::dataSize(unsigned int mipMapLevel) const
 const GLubyte *ITextureLoader::pixels(unsigned int mipMapLevel) const
 {
 	const GLubyte *pixels = nullptr;
+	const GLubyte *basePixels = this->pixels();
 
-	if (pixels_ != nullptr)
+	if (basePixels != nullptr)
 	{
 		if (mipMapCount_ > 1 && int(mipMapLevel) < mipMapCount_)
-			pixels = pixels_.get() + mipDataOffsets_[mipMapLevel];
+			pixels = basePixels + mipDataOffsets_[mipMapLevel];
 		else if (mipMapLevel == 0)
-			pixels = pixels_.get();
+			pixels = basePixels;
 	}
 
 	return pixels;
 }
 
+bool ITextureLoader::canConvertPixels(GLenum internalFormat) const
+{
+	if (pixels() == nullptr || texFormat_.isCompressed() || texFormat_.type() != GL_UNSIGNED_BYTE)
+		return false;
+
+	const GLenum format = texFormat_.format();
+	if (format != GL_RGB && format != GL_RGBA)
+		return false;
+
+	switch (internalFormat)
+	{
+		case GL_RGB565:
+		case GL_RGBA4:
+		case GL_RGB5_A1:
+		case GL_R8:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/*! \note Only RGB and RGBA sources with one byte per channel can be converted */
+bool ITextureLoader::convertPixels(GLenum internalFormat, bool withDithering)
+{
+	if (canConvertPixels(internalFormat) == false)
+	{
+		LOGW_X("Cannot convert pixels from internal format 0x%x to 0x%x", texFormat_.internalFormat(), internalFormat);
+		return false;
+	}
+
+	const unsigned int srcChannels = texFormat_.numChannels();
+	const TextureFormat newTexFormat(internalFormat);
+
+	nctl::UniquePtr<unsigned long[]> newMipDataOffsets = nctl::makeUnique<unsigned long[]>(mipMapCount_);
+	nctl::UniquePtr<unsigned long[]> newMipDataSizes = nctl::makeUnique<unsigned long[]>(mipMapCount_);
+	const unsigned long newDataSize = TextureFormat::calculateMipSizes(internalFormat, width_, height_, mipMapCount_, newMipDataOffsets.get(), newMipDataSizes.get());
+	nctl::UniquePtr<GLubyte[]> newPixels = nctl::makeUnique<GLubyte[]>(newDataSize);
+
+	int levelWidth = width_;
+	int levelHeight = height_;
+	for (int i = 0; i < mipMapCount_; i++)
+	{
+		convertLevel(newPixels.get() + newMipDataOffsets[i], pixels(i), levelWidth, levelHeight, srcChannels, internalFormat, withDithering);
+		levelWidth = (levelWidth > 1) ? levelWidth / 2 : 1;
+		levelHeight = (levelHeight > 1) ? levelHeight / 2 : 1;
+	}
+
+	LOGI_X("Converted pixels from internal format 0x%x to 0x%x (%lu to %lu bytes)", texFormat_.internalFormat(), internalFormat, dataSize_, newDataSize);
+
+	texFormat_ = newTexFormat;
+	dataSize_ = newDataSize;
+	pixels_ = nctl::move(newPixels);
+	if (mipMapCount_ > 1)
+	{
+		mipDataOffsets_ = nctl::move(newMipDataOffsets);
+		mipDataSizes_ = nctl::move(newMipDataSizes);
+	}
+
+	return true;
+}
+
+bool ITextureLoader::canGenerateMipMaps() const
+{
+	if (pixels() == nullptr || mipMapCount_ > 1 || texFormat_.isCompressed() || texFormat_.type() != GL_UNSIGNED_BYTE)
+		return false;
+
+	switch (texFormat_.internalFormat())
+	{
+		case GL_R8:
+		case GL_RG8:
+		case GL_RGB8:
+		case GL_RGBA8:
+			return (width_ > 1 || height_ > 1);
+		default:
+			return false;
+	}
+}
+
+/*! The chain is complete down to a single pixel, the smaller dimension stops being halved once it reaches one pixel.
+ *  \param gammaCorrect Averages RGB channels in linear space, it should be false for non-color data */
+bool ITextureLoader::generateMipMaps(bool gammaCorrect)
+{
+	if (canGenerateMipMaps() == false)
+	{
+		LOGW_X("Cannot generate MIP maps for internal format 0x%x", texFormat_.internalFormat());
+		return false;
+	}
+
+	int mipMapCount = 1;
+	while ((nctl::max(width_, height_) >> mipMapCount) > 0)
+		mipMapCount++;
+
+	const GLenum internalFormat = texFormat_.internalFormat();
+	const unsigned int numChannels = texFormat_.numChannels();
+	nctl::UniquePtr<unsigned long[]> mipDataOffsets = nctl::makeUnique<unsigned long[]>(mipMapCount);
+	nctl::UniquePtr<unsigned long[]> mipDataSizes = nctl::makeUnique<unsigned long[]>(mipMapCount);
+	const unsigned long dataSize = TextureFormat::calculateMipSizes(internalFormat, width_, height_, mipMapCount, mipDataOffsets.get(), mipDataSizes.get());
+
+	nctl::UniquePtr<GLubyte[]> pixels = nctl::makeUnique<GLubyte[]>(dataSize);
+	memcpy(pixels.get(), this->pixels(), mipDataSizes[0]);
+
+	MipRowsJob job;
+	job.numChannels = numChannels;
+	job.gammaCorrect = gammaCorrect && (internalFormat == GL_RGB8 || internalFormat == GL_RGBA8);
+
+	int levelWidth = width_;
+	int levelHeight = height_;
+	for (int i = 1; i < mipMapCount; i++)
+	{
+		job.src = pixels.get() + mipDataOffsets[i - 1];
+		job.dest = pixels.get() + mipDataOffsets[i];
+		job.srcWidth = levelWidth;
+		job.srcHeight = levelHeight;
+		levelWidth = (levelWidth > 1) ? levelWidth / 2 : 1;
+		levelHeight = (levelHeight > 1) ? levelHeight / 2 : 1;
+		job.destWidth = levelWidth;
+		downsampleLevel(job, levelHeight);
+	}
+
+	LOGI_X("Generated %d MIP map levels for a %dx%d texture (%lu bytes)", mipMapCount, width_, height_, dataSize);
+
+	mipMapCount_ = mipMapCount;
+	dataSize_ = dataSize;
+	pixels_ = nctl::move(pixels);
+	mipDataOffsets_ = nctl::move(mipDataOffsets);
+	mipDataSizes_ = nctl::move(mipDataSizes);
+
+	return true;
+}
+
 nctl::UniquePtr<ITextureLoader> ITextureLoader::createFromMemory(const char *bufferName, const unsigned char *bufferPtr, unsigned long int bufferSize)
 {
 	LOGI_X("Loading memory file: \"%s\" (0x%lx, %lu bytes)", bufferName, bufferPtr, bufferSize);
@@ -126,8 +459,16 @@ void ITextureLoader::loadPixels(GLenum internalFormat, GLenum type)
 		fileHandle_->open(IFile::OpenMode::READ | IFile::OpenMode::BINARY);
 
 	dataSize_ = fileHandle_->size() - headerSize_;
-	fileHandle_->seek(headerSize_, SEEK_SET);
 
+	// Pixels of a mapped file are used in place, the file stays opened as long as the loader exists
+	const GLubyte *fileBufferPtr = static_cast<const GLubyte *>(fileHandle_->bufferPtr());
+	if (fileBufferPtr != nullptr)
+	{
+		filePixels_ = fileBufferPtr + headerSize_;
+		return;
+	}
+
+	fileHandle_->seek(headerSize_, SEEK_SET);
 	pixels_ = nctl::makeUnique<unsigned char[]>(dataSize_);
 	fileHandle_->read(pixels_.get(), dataSize_);
 }
@@ -16,6 +16,8 @@
 
 #ifdef WITH_AUDIO
 	#include "IAudioPlayer.h"
+	#include "AudioStreamPlayer.h"
+	#include "AudioBufferCache.h"
 #endif
 
 #include "IFrameTimer.h"
@@ -663,6 +665,7 @@ void ImGuiDebugOverlay::guiGraphicsCapabilities()
 		ImGui::Text("GL_AMD_compressed_ATC_texture: %d", gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::AMD_COMPRESSED_ATC_TEXTURE));
 		ImGui::Text("GL_IMG_texture_compression_pvrtc: %d", gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::IMG_TEXTURE_COMPRESSION_PVRTC));
 		ImGui::Text("GL_KHR_texture_compression_astc_ldr: %d", gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::KHR_TEXTURE_COMPRESSION_ASTC_LDR));
+		ImGui::Text("GL_KHR_parallel_shader_compile: %d", gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::KHR_PARALLEL_SHADER_COMPILE));
 	}
 }
 
@@ -724,15 +727,19 @@ void ImGuiDebugOverlay::guiApplicationConfiguration()
 		ImGui::Text("Output audio frequency: %u", appCfg.outputAudioFrequency);
 		ImGui::Text("Mono audio sources: %u", appCfg.monoAudioSources);
 		ImGui::Text("Stereo audio sources: %u", appCfg.stereoAudioSources);
+		ImGui::Text("Stream buffers: %u of %lu bytes (adaptive: %s)", appCfg.numStreamBuffers, appCfg.streamBufferSize, appCfg.adaptiveStreamBuffers ? "true" : "false");
 
 		ImGui::Separator();
 		ImGui::Text("Debug Overlay: %s", appCfg.withDebugOverlay ? "true" : "false");
 		ImGui::Text("Audio: %s", appCfg.withAudio ? "true" : "false");
+		ImGui::Text("Software Audio: %s", appCfg.withSoftwareAudio ? "true" : "false");
 		ImGui::Text("Threads: %s", appCfg.withThreads ? "true" : "false");
 		ImGui::Text("Scenegraph: %s", appCfg.withScenegraph ? "true" : "false");
 		ImGui::Text("VSync: %s", appCfg.withVSync ? "true" : "false");
 		ImGui::Text("%s Debug Context: %s", openglApiName, appCfg.withGlDebugContext ? "true" : "false");
 		ImGui::Text("Console Colors: %s", appCfg.withConsoleColors ? "true" : "false");
+		ImGui::Text("Async Logging: %s", appCfg.withAsyncLogging ? "true" : "false");
+		ImGui::Text("Binary Logging: %s", appCfg.withBinaryLogging ? "true" : "false");
 	}
 }
 
@@ -942,9 +949,53 @@ void ImGuiDebugOverlay::guiAudioPlayers()
 		const float availableSourcesFraction = numAvailableSources / float(maxNumSources);
 		ImGui::ProgressBar(availableSourcesFraction, ImVec2(0.0f, 0.0f));
 		ImGui::Text("Available Sources: %u / %u", numAvailableSources, maxNumSources);
+		ImGui::Text("Stream Underruns: %u", audioDevice.numStreamUnderruns());
+		ImGui::SameLine();
+		if (ImGui::Button("Reset##StreamUnderruns"))
+			audioDevice.resetStreamUnderruns();
+
+		if (ImGui::TreeNode("Buffer Cache"))
+		{
+			AudioBufferCache &bufferCache = audioBufferCache();
+			bool cacheEnabled = bufferCache.isEnabled();
+			ImGui::Checkbox("Enabled##BufferCache", &cacheEnabled);
+			bufferCache.setEnabled(cacheEnabled);
+
+			ImGui::BeginDisabled(bufferCache.isDiskCacheAvailable() == false);
+			bool diskCacheEnabled = bufferCache.isDiskCacheEnabled();
+			ImGui::Checkbox("Disk Cache", &diskCacheEnabled);
+			if (diskCacheEnabled != bufferCache.isDiskCacheEnabled())
+				bufferCache.setDiskCacheEnabled(diskCacheEnabled);
+			ImGui::SameLine();
+			if (ImGui::Button("Clear##BufferCache"))
+				bufferCache.clearDisk();
+			ImGui::EndDisabled();
+
+			const AudioBufferCache::Statistics &stats = bufferCache.statistics();
+			ImGui::Text("Directory: %s", bufferCache.directory().data());
+			ImGui::Text("Shared Buffers: %u", stats.SharedBuffers);
+			ImGui::Text("Requests: %u hits, %u misses", stats.Hits, stats.Misses);
+			ImGui::Text("Disk: %u loaded, %u saved", stats.DiskHits, stats.DiskWrites);
+			ImGui::TreePop();
+		}
 
 		unsigned int numPlayers = audioDevice.numPlayers();
-		ImGui::Text("Active Players: %u", numPlayers);
+		const unsigned int numVirtualPlayers = audioDevice.numVirtualPlayers();
+		ImGui::Text("Active Players: %u (virtual: %u)", numPlayers, numVirtualPlayers);
+
+		if (numVirtualPlayers > 0 && ImGui::TreeNode("Virtual Players"))
+		{
+			for (unsigned int i = 0; i < numVirtualPlayers; i++)
+			{
+				const IAudioPlayer *player = audioDevice.virtualPlayer(i);
+				if (player == nullptr)
+					continue;
+
+				ImGui::Text("#%u: %s, priority %u, audibility %.3f, offset %d", i, audioPlayerStateToString(player->state()),
+				            player->priority(), player->audibility(audioDevice.position()), player->sampleOffset());
+			}
+			ImGui::TreePop();
+		}
 
 		if (numPlayers > 0)
 		{
@@ -974,10 +1025,19 @@ void ImGuiDebugOverlay::guiAudioPlayers()
 				ImGui::Text("Samples: %lu", player->numSamples());
 				ImGui::Text("Duration: %.3f s", player->duration());
 				ImGui::Text("Buffer Size: %lu bytes", player->bufferSize());
+				if (player->type() == Object::ObjectType::AUDIOSTREAM_PLAYER)
+				{
+					const AudioStreamPlayer *streamPlayer = static_cast<const AudioStreamPlayer *>(player);
+					ImGui::Text("Stream Buffers: %u of %d bytes (adaptive: %s)", streamPlayer->numStreamBuffers(), streamPlayer->streamBufferSize(), streamPlayer->isAdaptiveBuffering() ? "true" : "false");
+					ImGui::Text("Underruns: %u", streamPlayer->numUnderruns());
+					ImGui::Text("Ready Blocks: %u", streamPlayer->numReadyBlocks());
+					ImGui::Text("Decode Time: %.3f ms (max %.3f ms)", streamPlayer->lastDecodeTime(), streamPlayer->maxDecodeTime());
+				}
 				ImGui::NewLine();
 
 				ImGui::Text("State: %s", audioPlayerStateToString(player->state()));
 				ImGui::Text("Looping: %s", player->isLooping() ? "true" : "false");
+				ImGui::Text("Priority: %u (audibility: %.3f)", player->priority(), player->audibility(audioDevice.position()));
 				ImGui::Text("Gain: %f", player->gain());
 				ImGui::Text("Pitch: %f", player->pitch());
 				const Vector3f &pos = player->position();
@@ -1195,11 +1255,14 @@ void ImGuiDebugOverlay::guiBinaryShaderCache()
 			ImGui::Text("Directory: %s", cache.directory().data());
 			// Reporting statistics for shaders hashing
 			const Hash64::Statistics &hash64Stats = RenderResources::hash64().statistics();
-			ImGui::Text("Hashed: %u sources (%u strings, %u characters), %u files, %u scanned",
-						hash64Stats.HashStringCalls, hash64Stats.HashedStrings, hash64Stats.HashedCharacters, hash64Stats.HashedFiles, hash64Stats.ScannedHashStrings);
+			ImGui::Text("Hashed: %u sources (%u strings, %u characters), %u buffers, %u files, %u scanned",
+						hash64Stats.HashStringCalls, hash64Stats.HashedStrings, hash64Stats.HashedCharacters, hash64Stats.HashedBuffers, hash64Stats.HashedFiles, hash64Stats.ScannedHashStrings);
 			ImGui::Text("Requests: %u loaded, %u saved", stats.LoadedShaders, stats.SavedShaders);
+			ImGui::Text("Introspection requests: %u loaded, %u saved", stats.LoadedIntrospections, stats.SavedIntrospections);
+			ImGui::Text("Archive: %s", BinaryShaderCache::ArchiveFilename);
 			ImGui::Text("Count: %u (total: %u)", stats.PlatformFilesCount, stats.TotalFilesCount);
-			ImGui::Text("Size: %u Kb (total: %u Kb)", stats.PlatformBytesCount / 1024, stats.TotalBytesCount / 1024);
+			ImGui::Text("Size: %u Kb (total: %u Kb, max: %lu Kb)", stats.PlatformBytesCount / 1024, stats.TotalBytesCount / 1024, cache.maxSize() / 1024);
+			ImGui::Text("Compactions: %u, evicted: %u", stats.Compactions, stats.EvictedShaders);
 
 			const unsigned int numDefaultVertexShaders = static_cast<unsigned int>(RenderResources::DefaultVertexShader::COUNT);
 			widgetName_.format("Default vertex shaders (%u)", numDefaultVertexShaders);
@@ -1278,6 +1341,9 @@ void ImGuiDebugOverlay::guiBinaryShaderCache()
 
 			ImGui::SameLine();
 			ImGui::BeginDisabled(canBeCleared == false);
+			if (ImGui::Button("Compact"))
+				cache.compact();
+			ImGui::SameLine();
 			if (ImGui::Button("Clear"))
 				cache.clear();
 			ImGui::EndDisabled();
@@ -1802,6 +1868,7 @@ void ImGuiDebugOverlay::guiTopLeft()
 	const RenderStatistics::VaoPool &vaoPool = RenderStatistics::vaoPool();
 	const RenderStatistics::CommandPool &commandPool = RenderStatistics::commandPool();
 	const RenderStatistics::Textures &textures = RenderStatistics::textures();
+	const RenderStatistics::TextureStreaming &textureStreaming = RenderStatistics::textureStreaming();
 	const RenderStatistics::CustomBuffers &customVbos = RenderStatistics::customVBOs();
 	const RenderStatistics::CustomBuffers &customIbos = RenderStatistics::customIBOs();
 	const RenderStatistics::Buffers &vboBuffers = RenderStatistics::buffers(RenderBuffersManager::BufferTypes::ARRAY);
@@ -1830,6 +1897,7 @@ void ImGuiDebugOverlay::guiTopLeft()
 		ImGui::Text("%u/%u VAOs (%u reuses, %u bindings)", vaoPool.size, vaoPool.capacity, vaoPool.reuses, vaoPool.bindings);
 		ImGui::Text("%u/%u RenderCommands in the pool (%u retrievals)", commandPool.usedSize, commandPool.usedSize + commandPool.freeSize, commandPool.retrievals);
 		ImGui::Text("%.2f Kb in %u Texture(s)", textures.dataSize / 1024.0f, textures.count);
+		ImGui::Text("%.2f Kb streamed in %u Texture upload(s)", textureStreaming.bytes / 1024.0f, textureStreaming.uploads);
 		ImGui::Text("%.2f Kb in %u custom VBO(s)", customVbos.dataSize / 1024.0f, customVbos.count);
 		ImGui::Text("%.2f Kb in %u custom IBO(s)", customIbos.dataSize / 1024.0f, customIbos.count);
 		ImGui::Text("%.2f/%lu Kb in %u VBO(s)", vboBuffers.usedSpace / 1024.0f, vboBuffers.size / 1024, vboBuffers.count);
@@ -1854,7 +1922,7 @@ void ImGuiDebugOverlay::guiTopLeft()
 		}
 
 		if (RenderResources::binaryShaderCache().isAvailable())
-			ImGui::Text("Binary Shaders: %u Kb in %u file(s)", shaderCacheStats.TotalBytesCount / 1024, shaderCacheStats.TotalFilesCount);
+			ImGui::Text("Binary Shaders: %u Kb in %u archive entries", shaderCacheStats.TotalBytesCount / 1024, shaderCacheStats.TotalFilesCount);
 		ImGui::Text("Viewport chain length: %u", Viewport::chain().size());
 
 		ImGui::End();
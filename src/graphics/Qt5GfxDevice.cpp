@@ -176,6 +176,12 @@ void Qt5GfxDevice::bindDefaultDrawFramebufferObject()
 	GLFramebufferObject::bindHandle(GL_DRAW_FRAMEBUFFER, glHandle);
 }
 
+void Qt5GfxDevice::bindDefaultReadFramebufferObject()
+{
+	const GLuint glHandle = widget_.defaultFramebufferObject();
+	GLFramebufferObject::bindHandle(GL_READ_FRAMEBUFFER, glHandle);
+}
+
 /*! \note It should be used after each `QOpenGLWidget::makeCurrent()` call */
 void Qt5GfxDevice::resetFramebufferObjectBinding()
 {
@@ -87,8 +87,9 @@ const RenderResources::ShaderProgramCompileInfo::ShaderCompileInfo &RenderResour
 	return defaultFragmentShaderInfos_[index];
 }
 
-/*! \note If not initially provided, the new computed hashes will be written back in the `ShaderCompileInfo` structures */
-void RenderResources::compileShader(ShaderProgramCompileInfo &shaderToCompile)
+/*! \note If not initially provided, the new computed hashes will be written back in the `ShaderCompileInfo` structures
+ *  \return True if the shader program has been loaded from the cache or compiled and linked */
+bool RenderResources::compileShader(ShaderProgramCompileInfo &shaderToCompile)
 {
 	ZoneScoped;
 	if (shaderToCompile.objectLabel)
@@ -127,8 +128,14 @@ void RenderResources::compileShader(ShaderProgramCompileInfo &shaderToCompile)
 		}
 	}
 
+	// The hash of the injected directives makes every shader variant a different entry of the cache
+	uint64_t definesHash = 0;
+	if (binaryShaderCache_->isEnabled() && shaderToCompile.defines != nullptr)
+		definesHash = hash64_->hashString(shaderToCompile.defines, strlen(shaderToCompile.defines));
+	const uint64_t vertexHash = shaderToCompile.vertexInfo.hash + definesHash;
+
 	// A similar sum is performd in `GLShaderProgram::link()` for attached shaders
-	const uint64_t shaderHashSum = binaryShaderCache_->isEnabled() ? shaderToCompile.vertexInfo.hash + shaderToCompile.fragmentInfo.hash : 0;
+	const uint64_t shaderHashSum = binaryShaderCache_->isEnabled() ? vertexHash + shaderToCompile.fragmentInfo.hash : 0;
 
 	const AppConfiguration &appCfg = theApplication().appConfiguration();
 	const GLShaderProgram::QueryPhase cfgQueryPhase = appCfg.deferShaderQueries ? GLShaderProgram::QueryPhase::DEFERRED : GLShaderProgram::QueryPhase::IMMEDIATE;
@@ -141,7 +148,7 @@ void RenderResources::compileShader(ShaderProgramCompileInfo &shaderToCompile)
 		const bool hasLoaded = shaderToCompile.shaderProgram->initFromBinary(shaderInfo.binaryFilename.data(), shaderToCompile.introspection);
 		ASSERT(hasLoaded);
 		shaderToCompile.shaderProgram->setObjectLabel(shaderInfo.objectLabel.data());
-		return;
+		return hasLoaded;
 	}
 
 	// ----------------------------------------------------------------------------------------------
@@ -165,13 +172,19 @@ void RenderResources::compileShader(ShaderProgramCompileInfo &shaderToCompile)
 	shaderToCompile.shaderProgram->reset(queryPhase);
 
 	nctl::StaticString<64> sourceString;
-	const char *vertexStrings[3] = { nullptr, nullptr, nullptr };
+	const char *vertexStrings[4] = { nullptr, nullptr, nullptr, nullptr };
+	unsigned int numVertexStrings = 0;
 	if (compileTwice)
 	{
 		// The first compilation of a batched shader needs a `BATCH_SIZE` defined as 1
 		sourceString.format(BatchSizeFormatString, 1);
-		vertexStrings[0] = sourceString.data();
+		vertexStrings[numVertexStrings++] = sourceString.data();
 	}
+	if (shaderToCompile.defines)
+		vertexStrings[numVertexStrings++] = shaderToCompile.defines;
+
+	const char *fragmentStrings[3] = { shaderToCompile.defines, nullptr, nullptr };
+	const unsigned int numFragmentStrings = shaderToCompile.defines ? 1 : 0;
 
 	bool vertexHasLoaded = false;
 	bool fragmentHasLoaded = false;
@@ -179,17 +192,20 @@ void RenderResources::compileShader(ShaderProgramCompileInfo &shaderToCompile)
 	// Overriding all hash calculation performed in the `GLShader` class by the `attachShader*` wrapper methods
 	if (shaderToCompile.vertexInfo.shaderString)
 	{
-		// The vertex shader source string can be either the first one or the second one, if the first defines the `BATCH_SIZE`
-		vertexStrings[compileTwice ? 1 : 0] = shaderToCompile.vertexInfo.shaderString;
-		vertexHasLoaded = shaderToCompile.shaderProgram->attachShaderFromStrings(GL_VERTEX_SHADER, vertexStrings, shaderToCompile.vertexInfo.hash);
+		// The vertex shader source string follows the `BATCH_SIZE` and the injected directives, if any
+		vertexStrings[numVertexStrings] = shaderToCompile.vertexInfo.shaderString;
+		vertexHasLoaded = shaderToCompile.shaderProgram->attachShaderFromStrings(GL_VERTEX_SHADER, vertexStrings, vertexHash);
 	}
 	else if (shaderToCompile.vertexInfo.shaderFile)
-		vertexHasLoaded = shaderToCompile.shaderProgram->attachShaderFromStringsAndFile(GL_VERTEX_SHADER, vertexStrings, shaderToCompile.vertexInfo.shaderFile, shaderToCompile.vertexInfo.hash);
+		vertexHasLoaded = shaderToCompile.shaderProgram->attachShaderFromStringsAndFile(GL_VERTEX_SHADER, vertexStrings, shaderToCompile.vertexInfo.shaderFile, vertexHash);
 
 	if (shaderToCompile.fragmentInfo.shaderString)
-		fragmentHasLoaded = shaderToCompile.shaderProgram->attachShaderFromString(GL_FRAGMENT_SHADER, shaderToCompile.fragmentInfo.shaderString, shaderToCompile.fragmentInfo.hash);
+	{
+		fragmentStrings[numFragmentStrings] = shaderToCompile.fragmentInfo.shaderString;
+		fragmentHasLoaded = shaderToCompile.shaderProgram->attachShaderFromStrings(GL_FRAGMENT_SHADER, fragmentStrings, shaderToCompile.fragmentInfo.hash);
+	}
 	else if (shaderToCompile.fragmentInfo.shaderFile)
-		fragmentHasLoaded = shaderToCompile.shaderProgram->attachShaderFromFile(GL_FRAGMENT_SHADER, shaderToCompile.fragmentInfo.shaderFile, shaderToCompile.fragmentInfo.hash);
+		fragmentHasLoaded = shaderToCompile.shaderProgram->attachShaderFromStringsAndFile(GL_FRAGMENT_SHADER, fragmentStrings, shaderToCompile.fragmentInfo.shaderFile, shaderToCompile.fragmentInfo.hash);
 
 	ASSERT(vertexHasLoaded == true);
 	ASSERT(fragmentHasLoaded == true);
@@ -201,8 +217,13 @@ void RenderResources::compileShader(ShaderProgramCompileInfo &shaderToCompile)
 	binaryShaderCache_->setEnabled(cacheWasEnabled && !compileTwice);
 	// The first compilation of a batched shader needs the introspection
 	const bool programHasLinked = shaderToCompile.shaderProgram->link(compileTwice ? GLShaderProgram::Introspection::ENABLED : shaderToCompile.introspection);
-	FATAL_ASSERT_MSG_X(programHasLinked, "Failed to compile shader program \"%s\"", shaderToCompile.objectLabel);
 	binaryShaderCache_->setEnabled(cacheWasEnabled);
+	if (programHasLinked == false)
+	{
+		FATAL_ASSERT_MSG_X(shaderToCompile.fatalOnErrors == false, "Failed to compile shader program \"%s\"", shaderToCompile.objectLabel);
+		LOGE_X("Failed to compile shader program \"%s\"", shaderToCompile.objectLabel);
+		return false;
+	}
 
 	unsigned int maxBatchSize = 0; // default value for non batched shaders
 	if (compileTwice)
@@ -226,21 +247,26 @@ void RenderResources::compileShader(ShaderProgramCompileInfo &shaderToCompile)
 			bool finalVertexHasLoaded = false;
 			bool finalFragmentHasLoaded = false;
 			if (shaderToCompile.vertexInfo.shaderString)
-				finalVertexHasLoaded = shaderToCompile.shaderProgram->attachShaderFromStrings(GL_VERTEX_SHADER, vertexStrings, shaderToCompile.vertexInfo.hash);
+				finalVertexHasLoaded = shaderToCompile.shaderProgram->attachShaderFromStrings(GL_VERTEX_SHADER, vertexStrings, vertexHash);
 			else if (shaderToCompile.vertexInfo.shaderFile)
-				finalVertexHasLoaded = shaderToCompile.shaderProgram->attachShaderFromStringsAndFile(GL_VERTEX_SHADER, vertexStrings, shaderToCompile.vertexInfo.shaderFile, shaderToCompile.vertexInfo.hash);
+				finalVertexHasLoaded = shaderToCompile.shaderProgram->attachShaderFromStringsAndFile(GL_VERTEX_SHADER, vertexStrings, shaderToCompile.vertexInfo.shaderFile, vertexHash);
 
 			if (shaderToCompile.fragmentInfo.shaderString)
-				finalFragmentHasLoaded = shaderToCompile.shaderProgram->attachShaderFromString(GL_FRAGMENT_SHADER, shaderToCompile.fragmentInfo.shaderString, shaderToCompile.fragmentInfo.hash);
+				finalFragmentHasLoaded = shaderToCompile.shaderProgram->attachShaderFromStrings(GL_FRAGMENT_SHADER, fragmentStrings, shaderToCompile.fragmentInfo.hash);
 			else if (shaderToCompile.fragmentInfo.shaderFile)
-				finalFragmentHasLoaded = shaderToCompile.shaderProgram->attachShaderFromFile(GL_FRAGMENT_SHADER, shaderToCompile.fragmentInfo.shaderFile, shaderToCompile.fragmentInfo.hash);
+				finalFragmentHasLoaded = shaderToCompile.shaderProgram->attachShaderFromStringsAndFile(GL_FRAGMENT_SHADER, fragmentStrings, shaderToCompile.fragmentInfo.shaderFile, shaderToCompile.fragmentInfo.hash);
 
 			ASSERT(finalVertexHasLoaded == true);
 			ASSERT(finalFragmentHasLoaded == true);
 
 			// If link is sucessful, the binary shader is saved in the cache
 			const bool finalProgramHasLinked = shaderToCompile.shaderProgram->link(shaderToCompile.introspection);
-			FATAL_ASSERT_MSG_X(finalProgramHasLinked, "Failed to compile shader program \"%s\"", shaderToCompile.objectLabel);
+			if (finalProgramHasLinked == false)
+			{
+				FATAL_ASSERT_MSG_X(shaderToCompile.fatalOnErrors == false, "Failed to compile shader program \"%s\"", shaderToCompile.objectLabel);
+				LOGE_X("Failed to compile shader program \"%s\"", shaderToCompile.objectLabel);
+				return false;
+			}
 		}
 	}
 
@@ -256,6 +282,8 @@ void RenderResources::compileShader(ShaderProgramCompileInfo &shaderToCompile)
 	const uint64_t shaderHashName = shaderToCompile.shaderProgram->hashName();
 	ASSERT(shaderHashName == shaderHashSum); // The two hash sums should match
 	binaryShaderCache_->registerShaderInfo(shaderHashName, shaderToCompile.objectLabel, maxBatchSize);
+
+	return true;
 }
 
 GLShaderProgram *RenderResources::batchedShader(const GLShaderProgram *shader)
@@ -524,6 +552,46 @@ void RenderResources::create()
 #endif
 	}
 
+	// All programs have been submitted, with deferred queries the driver can compile and link them in parallel
+	if (binaryShaderCache_->isEnabled())
+	{
+		ZoneScopedN("Save pending binaries");
+		unsigned int numPendingBinaries = 0;
+		for (unsigned int i = 0; i < numShaderToCompile; i++)
+		{
+			if (shadersToCompile[i].shaderProgram->hasPendingBinary())
+				numPendingBinaries++;
+		}
+
+		while (numPendingBinaries > 0)
+		{
+			// Saving the binaries of completed programs first, to only wait when none of them is ready
+			GLShaderProgram *firstPendingProgram = nullptr;
+			bool binaryHasSaved = false;
+			for (unsigned int i = 0; i < numShaderToCompile; i++)
+			{
+				GLShaderProgram *shaderProgram = shadersToCompile[i].shaderProgram.get();
+				if (shaderProgram->hasPendingBinary() == false)
+					continue;
+
+				if (shaderProgram->isLinkCompleted())
+				{
+					shaderProgram->savePendingBinary();
+					numPendingBinaries--;
+					binaryHasSaved = true;
+				}
+				else if (firstPendingProgram == nullptr)
+					firstPendingProgram = shaderProgram;
+			}
+
+			if (binaryHasSaved == false && firstPendingProgram != nullptr)
+			{
+				firstPendingProgram->savePendingBinary();
+				numPendingBinaries--;
+			}
+		}
+	}
+
 	registerDefaultBatchedShaders();
 
 	// Calculating a default projection matrix for all shader programs
@@ -12,6 +12,7 @@ RenderStatistics::Commands RenderStatistics::allCommands_;
 RenderStatistics::Commands RenderStatistics::typedCommands_[RenderCommand::CommandTypes::COUNT];
 RenderStatistics::Buffers RenderStatistics::typedBuffers_[RenderBuffersManager::BufferTypes::COUNT];
 RenderStatistics::Textures RenderStatistics::textures_;
+RenderStatistics::TextureStreaming RenderStatistics::textureStreaming_[2];
 RenderStatistics::CustomBuffers RenderStatistics::customVbos_;
 RenderStatistics::CustomBuffers RenderStatistics::customIbos_;
 unsigned int RenderStatistics::index_ = 0;
@@ -38,6 +39,8 @@ void RenderStatistics::reset()
 	// Ping pong index for last and current frame
 	index_ = (index_ + 1) % 2;
 	culledNodes_[index_] = 0;
+	TracyPlot("Streamed Texture Bytes", static_cast<int64_t>(textureStreaming_[(index_ + 1) % 2].bytes));
+	textureStreaming_[index_].reset();
 
 	vaoPool_.reset();
 	commandPool_.reset();
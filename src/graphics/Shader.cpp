@@ -367,7 +367,8 @@ void Shader::setBinaryCacheEnabled(bool enable)
 
 /*! \return True if the shader program has been successfully linked */
 bool Shader::load(LoadMode loadMode, const char *shaderName, Introspection introspection, const char *vertex, const char *fragment,
-                  DefaultVertex defaultVertex, DefaultFragment defaultFragment, uint64_t vertexHash, uint64_t fragmentHash)
+                  DefaultVertex defaultVertex, DefaultFragment defaultFragment, uint64_t vertexHash, uint64_t fragmentHash,
+                  const char *defines)
 {
 	ZoneScoped;
 	if (shaderName)
@@ -391,6 +392,7 @@ bool Shader::load(LoadMode loadMode, const char *shaderName, Introspection intro
 	const bool withHash = (bsc.isEnabled() && loadMode == LoadMode::STRING);
 
 	RenderResources::ShaderProgramCompileInfo shaderProgramInfo(glShaderProgram_, shaderToShaderProgramIntrospection(introspection), shaderName);
+	shaderProgramInfo.defines = defines;
 
 #ifndef WITH_EMBEDDED_SHADERS
 	nctl::String vertexShaderPath(256);
@@ -447,10 +449,12 @@ bool Shader::load(LoadMode loadMode, const char *shaderName, Introspection intro
 			shaderProgramInfo.fragmentInfo.shaderFile = fragment;
 	}
 
-	RenderResources::compileShader(shaderProgramInfo);
+	// A shader variant that fails to compile is reported by `ShaderVariants::variant()` without terminating
+	shaderProgramInfo.fatalOnErrors = (defines == nullptr);
+	const bool hasCompiled = RenderResources::compileShader(shaderProgramInfo);
 	// The shader info hashmap with the custom shader hashes will be saved at application shutdown
 
-	return isLinked();
+	return (hasCompiled && isLinked());
 }
 
 }
@@ -0,0 +1,302 @@
+#include <cstring> // for strlen()
+#include "common_macros.h"
+#include "ShaderVariants.h"
+#include <nctl/HashMapIterator.h>
+#include "IFile.h"
+#include "tracy.h"
+
+namespace ncine {
+
+namespace {
+
+	/// Shader sources can be longer than the maximum length of a string constructed from a C string
+	void copySource(nctl::String &dest, const char *source)
+	{
+		const unsigned int length = static_cast<unsigned int>(strlen(source));
+		dest = nctl::String(length + 1);
+		dest.assign(source, length);
+	}
+
+	bool isSeparator(char c)
+	{
+		return (c == ' ' || c == '\t' || c == ',' || c == '\r');
+	}
+
+	const unsigned int InitialVariantsCapacity = 16;
+	/// The variant label is the shader name followed by the keywords, like `name[KEYWORD1,KEYWORD2]`
+	const unsigned int LabelCapacity = 128;
+
+}
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+ShaderVariants::ShaderVariants(const char *shaderName, Shader::LoadMode loadMode, Shader::Introspection introspection, const char *vertex, const char *fragment)
+    : name_(shaderName ? shaderName : ""), loadMode_(loadMode), introspection_(introspection),
+      defaultVertex_(Shader::DefaultVertex::SPRITE), keywords_(4), variants_(InitialVariantsCapacity)
+{
+	ASSERT(vertex);
+	ASSERT(fragment);
+
+	copySource(vertex_, vertex);
+	copySource(fragment_, fragment);
+}
+
+ShaderVariants::ShaderVariants(const char *shaderName, Shader::LoadMode loadMode, const char *vertex, const char *fragment)
+    : ShaderVariants(shaderName, loadMode, Shader::Introspection::ENABLED, vertex, fragment)
+{
+}
+
+ShaderVariants::ShaderVariants(const char *shaderName, Shader::LoadMode loadMode, Shader::Introspection introspection, Shader::DefaultVertex defaultVertex, const char *fragment)
+    : name_(shaderName ? shaderName : ""), loadMode_(loadMode), introspection_(introspection),
+      defaultVertex_(defaultVertex), keywords_(4), variants_(InitialVariantsCapacity)
+{
+	ASSERT(fragment);
+
+	copySource(fragment_, fragment);
+}
+
+ShaderVariants::ShaderVariants(const char *shaderName, Shader::LoadMode loadMode, Shader::DefaultVertex defaultVertex, const char *fragment)
+    : ShaderVariants(shaderName, loadMode, Shader::Introspection::ENABLED, defaultVertex, fragment)
+{
+}
+
+ShaderVariants::~ShaderVariants() = default;
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+/*! \note Variants compiled before the keyword was added are not affected, as their masks do not include its bit */
+int ShaderVariants::addKeyword(const char *keyword)
+{
+	ASSERT(keyword);
+	const unsigned int length = static_cast<unsigned int>(strlen(keyword));
+	if (length == 0)
+		return -1;
+
+	const int index = keywordIndex(keyword, length);
+	if (index >= 0)
+		return index;
+
+	if (keywords_.size() >= MaxKeywords)
+	{
+		LOGW_X("Shader \"%s\" cannot declare more than %u keywords, \"%s\" is ignored", name_.data(), MaxKeywords, keyword);
+		return -1;
+	}
+
+	keywords_.pushBack(keyword);
+	return static_cast<int>(keywords_.size() - 1);
+}
+
+int ShaderVariants::keywordIndex(const char *keyword) const
+{
+	ASSERT(keyword);
+	return keywordIndex(keyword, static_cast<unsigned int>(strlen(keyword)));
+}
+
+const char *ShaderVariants::keyword(unsigned int index) const
+{
+	return (index < keywords_.size()) ? keywords_[index].data() : nullptr;
+}
+
+/*! \note Keywords that have not been declared are ignored */
+uint32_t ShaderVariants::keywordMask(const char *keywords) const
+{
+	uint32_t mask = 0;
+	if (keywords == nullptr)
+		return mask;
+
+	const char *start = keywords;
+	while (*start != '\0')
+	{
+		while (*start != '\0' && isSeparator(*start))
+			start++;
+		const char *end = start;
+		while (*end != '\0' && isSeparator(*end) == false)
+			end++;
+
+		if (end > start)
+		{
+			const int index = keywordIndex(start, static_cast<unsigned int>(end - start));
+			if (index >= 0)
+				mask |= (1u << index);
+			else
+				LOGW_X("Shader \"%s\" has not declared the keyword \"%.*s\"", name_.data(), static_cast<int>(end - start), start);
+		}
+		start = end;
+	}
+
+	return mask;
+}
+
+Shader *ShaderVariants::variant(uint32_t keywordMask)
+{
+	// Bits of undeclared keywords are ignored, so that the same variant is not compiled twice
+	const uint32_t validBits = (keywords_.size() < MaxKeywords) ? (1u << keywords_.size()) - 1 : 0xFFFFFFFF;
+	keywordMask &= validBits;
+
+	nctl::UniquePtr<Shader> *cachedVariant = variants_.find(keywordMask);
+	if (cachedVariant != nullptr)
+		return cachedVariant->get();
+
+	ZoneScoped;
+	nctl::String label(LabelCapacity);
+	label = name_;
+	if (keywordMask != 0)
+	{
+		label.append("[");
+		appendKeywords(label, keywordMask, ',');
+		label.append("]");
+	}
+	ZoneText(label.data(), label.length());
+
+	nctl::String defines(64 * (keywords_.size() + 1));
+	for (unsigned int i = 0; i < keywords_.size(); i++)
+	{
+		if (keywordMask & (1u << i))
+			defines.formatAppend("#define %s\n", keywords_[i].data());
+	}
+	// Line numbers in compilation errors should match the ones of the base shader sources
+	defines.append("#line 0\n");
+
+	nctl::UniquePtr<Shader> shader = nctl::makeUnique<Shader>();
+	const char *vertex = vertex_.isEmpty() ? nullptr : vertex_.data();
+	const bool hasLoaded = shader->load(loadMode_, label.data(), introspection_, vertex, fragment_.data(),
+	                                    defaultVertex_, Shader::DefaultFragment::SPRITE, 0, 0, defines.data());
+	if (hasLoaded == false)
+	{
+		LOGE_X("Shader variant \"%s\" cannot be loaded", label.data());
+		return nullptr;
+	}
+
+	if (variants_.loadFactor() >= 0.8f)
+		variants_.rehash(variants_.capacity() * 2);
+	Shader *shaderPtr = shader.get();
+	variants_.insert(keywordMask, nctl::move(shader));
+
+	return shaderPtr;
+}
+
+bool ShaderVariants::hasVariant(uint32_t keywordMask) const
+{
+	return (variants_.find(keywordMask) != nullptr);
+}
+
+void ShaderVariants::clear()
+{
+	variants_.clear();
+}
+
+unsigned int ShaderVariants::prewarm(const char *manifestFilename)
+{
+	ZoneScoped;
+	ASSERT(manifestFilename);
+
+	nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(manifestFilename);
+	fileHandle->open(IFile::OpenMode::READ);
+	if (fileHandle->isOpened() == false)
+	{
+		LOGW_X("Cannot open the variants manifest \"%s\" for shader \"%s\"", manifestFilename, name_.data());
+		return 0;
+	}
+
+	const long int fileSize = fileHandle->size();
+	nctl::String manifest(static_cast<unsigned int>(fileSize) + 1);
+	manifest.setLength(static_cast<unsigned int>(fileSize));
+	fileHandle->read(manifest.data(), fileSize);
+	fileHandle->close();
+
+	unsigned int numCompiled = 0;
+	unsigned int numLines = 0;
+	nctl::String line(256);
+	const char *start = manifest.data();
+	const char *const end = start + manifest.length();
+	while (start < end)
+	{
+		const char *lineEnd = start;
+		while (lineEnd < end && *lineEnd != '\n')
+			lineEnd++;
+
+		line.assign(start, static_cast<unsigned int>(lineEnd - start));
+		start = lineEnd + 1;
+
+		const char *keywords = line.data();
+		while (isSeparator(*keywords))
+			keywords++;
+		// Empty lines and comments are skipped
+		if (*keywords == '\0' || *keywords == '#')
+			continue;
+
+		numLines++;
+		const bool isBase = (keywords[0] == '-' && (keywords[1] == '\0' || isSeparator(keywords[1])));
+		const uint32_t mask = isBase ? 0 : keywordMask(keywords);
+		if (hasVariant(mask) == false && variant(mask) != nullptr)
+			numCompiled++;
+	}
+
+	LOGI_X("Prewarmed shader \"%s\" from manifest \"%s\" (%u variants listed and %u compiled)", name_.data(), manifestFilename, numLines, numCompiled);
+	return numCompiled;
+}
+
+bool ShaderVariants::saveManifest(const char *manifestFilename) const
+{
+	ASSERT(manifestFilename);
+
+	nctl::UniquePtr<IFile> fileHandle = IFile::createFileHandle(manifestFilename);
+	fileHandle->open(IFile::OpenMode::WRITE);
+	if (fileHandle->isOpened() == false)
+	{
+		LOGW_X("Cannot save the variants manifest \"%s\" for shader \"%s\"", manifestFilename, name_.data());
+		return false;
+	}
+
+	nctl::String manifest(64 * (variants_.size() + 1));
+	manifest.formatAppend("# Variants of shader \"%s\"\n", name_.data());
+	for (nctl::HashMap<uint32_t, nctl::UniquePtr<Shader>>::ConstIterator i = variants_.begin(); i != variants_.end(); ++i)
+	{
+		if (i.key() == 0)
+			manifest.append("-");
+		else
+			appendKeywords(manifest, i.key(), ' ');
+		manifest.append("\n");
+	}
+
+	fileHandle->write(manifest.data(), manifest.length());
+	fileHandle->close();
+	LOGI_X("Saved the manifest \"%s\" with %u variants of shader \"%s\"", manifestFilename, variants_.size(), name_.data());
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+int ShaderVariants::keywordIndex(const char *keyword, unsigned int length) const
+{
+	for (unsigned int i = 0; i < keywords_.size(); i++)
+	{
+		if (keywords_[i].length() == length && strncmp(keywords_[i].data(), keyword, length) == 0)
+			return static_cast<int>(i);
+	}
+	return -1;
+}
+
+void ShaderVariants::appendKeywords(nctl::String &string, uint32_t keywordMask, char separator) const
+{
+	bool first = true;
+	for (unsigned int i = 0; i < keywords_.size(); i++)
+	{
+		if (keywordMask & (1u << i))
+		{
+			if (first == false)
+				string.formatAppend("%c", separator);
+			string.append(keywords_[i]);
+			first = false;
+		}
+	}
+}
+
+}
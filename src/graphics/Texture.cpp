@@ -5,6 +5,7 @@
 #include "Texture.h"
 #include "TextureLoaderRaw.h"
 #include "GLTexture.h"
+#include "TextureStreamer.h"
 #include "RenderStatistics.h"
 #include "tracy.h"
 
@@ -59,6 +60,24 @@ Texture::Format formatToNc(GLenum format)
 	}
 }
 
+GLenum loadConversionToInternal(Texture::LoadConversion loadConversion)
+{
+	switch (loadConversion)
+	{
+		case Texture::LoadConversion::RGB565:
+			return GL_RGB565;
+		case Texture::LoadConversion::RGBA4444:
+			return GL_RGBA4;
+		case Texture::LoadConversion::RGB5_A1:
+			return GL_RGB5_A1;
+		case Texture::LoadConversion::R8:
+			return GL_R8;
+		case Texture::LoadConversion::NONE:
+		default:
+			return 0;
+	}
+}
+
 uint32_t *chromaKeyPixels(uint32_t *destBuffer, const unsigned char *srcBuffer, unsigned int numPixels, const Color &chromaKeyColor)
 {
 	// The alpha value is masked out to perform the comparison
@@ -78,6 +97,14 @@ uint32_t *chromaKeyPixels(uint32_t *destBuffer, const unsigned char *srcBuffer,
 	return destBuffer;
 }
 
+///////////////////////////////////////////////////////////
+// STATIC DEFINITIONS
+///////////////////////////////////////////////////////////
+
+bool Texture::defaultMipMapGenerationEnabled_ = false;
+Texture::LoadConversion Texture::defaultLoadConversion_ = Texture::LoadConversion::NONE;
+bool Texture::defaultLoadDitheringEnabled_ = false;
+
 ///////////////////////////////////////////////////////////
 // CONSTRUCTORS and DESTRUCTOR
 ///////////////////////////////////////////////////////////
@@ -86,7 +113,8 @@ Texture::Texture()
     : Object(ObjectType::TEXTURE), glTexture_(nctl::makeUnique<GLTexture>(GL_TEXTURE_2D)),
       width_(0), height_(0), mipMapLevels_(0), isCompressed_(false), format_(Format::UNKNOWN), dataSize_(0),
       minFiltering_(Filtering::NEAREST), magFiltering_(Filtering::NEAREST), wrapMode_(Wrap::REPEAT),
-      isChromaKeyEnabled_(false), chromaKeyColor_(Color::Magenta)
+      isChromaKeyEnabled_(false), chromaKeyColor_(Color::Magenta),
+      isMipMapGenerationEnabled_(defaultMipMapGenerationEnabled_), loadConversion_(defaultLoadConversion_), isLoadDitheringEnabled_(defaultLoadDitheringEnabled_)
 {
 }
 
@@ -198,17 +226,9 @@ bool Texture::loadFromMemory(const char *bufferName, const unsigned char *buffer
 	nctl::UniquePtr<ITextureLoader> texLoader = ITextureLoader::createFromMemory(bufferName, bufferPtr, bufferSize);
 	if (texLoader->hasLoaded() == false)
 		return false;
+	processPixels(*texLoader);
+	upload(bufferName, *texLoader);
 
-	if (dataSize_ > 0)
-		RenderStatistics::removeTexture(dataSize_);
-
-	glTexture_->bind();
-	setName(bufferName);
-	glTexture_->setObjectLabel(bufferName);
-	initialize(*texLoader);
-	load(*texLoader);
-
-	RenderStatistics::addTexture(dataSize_);
 	return true;
 }
 
@@ -220,17 +240,9 @@ bool Texture::loadFromFile(const char *filename)
 	nctl::UniquePtr<ITextureLoader> texLoader = ITextureLoader::createFromFile(filename);
 	if (texLoader->hasLoaded() == false)
 		return false;
+	processPixels(*texLoader);
+	upload(filename, *texLoader);
 
-	if (dataSize_ > 0)
-		RenderStatistics::removeTexture(dataSize_);
-
-	glTexture_->bind();
-	setName(filename);
-	glTexture_->setObjectLabel(filename);
-	initialize(*texLoader);
-	load(*texLoader);
-
-	RenderStatistics::addTexture(dataSize_);
 	return true;
 }
 
@@ -281,6 +293,68 @@ bool Texture::loadFromTexels(const unsigned char *bufferPtr, unsigned int level,
 	return loadFromTexels(bufferPtr, level, region.x, region.y, region.w, region.h);
 }
 
+bool Texture::isStreamingEnabled() const
+{
+	return (streamer_ != nullptr);
+}
+
+/*! \note Streaming is only available for uncompressed textures and chroma key transparency is not applied to streamed texels */
+bool Texture::enableStreaming(unsigned int numBuffers)
+{
+	if (dataSize_ == 0 || isCompressed_ || format_ == Format::UNKNOWN)
+	{
+		LOGW_X("Texture \"%s\" does not support streaming", name());
+		return false;
+	}
+
+	if (numBuffers < 1)
+		numBuffers = 1;
+	else if (numBuffers > TextureStreamer::MaxNumBuffers)
+		numBuffers = TextureStreamer::MaxNumBuffers;
+
+	streamer_ = nctl::makeUnique<TextureStreamer>(numBuffers, width_, height_, numChannels());
+	return true;
+}
+
+void Texture::disableStreaming()
+{
+	streamer_.reset(nullptr);
+}
+
+/*! \note The buffer content is undefined after mapping, every texel of the marked regions should be written */
+unsigned char *Texture::mapStreamingBuffer()
+{
+	return (streamer_ != nullptr) ? streamer_->map() : nullptr;
+}
+
+unsigned int Texture::streamingBufferPitch() const
+{
+	return (streamer_ != nullptr) ? streamer_->pitch() : 0;
+}
+
+void Texture::addStreamingRegion(unsigned int x, unsigned int y, unsigned int width, unsigned int height)
+{
+	if (streamer_ != nullptr)
+		streamer_->addDirtyRegion(Recti(x, y, width, height));
+}
+
+void Texture::addStreamingRegion(Recti region)
+{
+	if (streamer_ != nullptr)
+		streamer_->addDirtyRegion(region);
+}
+
+/*! \note If no region has been marked the whole first mip level is uploaded */
+bool Texture::uploadStreamingBuffer()
+{
+	if (streamer_ == nullptr || streamer_->isMapped() == false)
+		return false;
+
+	const unsigned long uploadedBytes = streamer_->upload(*glTexture_, ncFormatToNonInternal(format_));
+	RenderStatistics::addTextureStreamingUpload(uploadedBytes);
+	return true;
+}
+
 bool Texture::saveToMemory(unsigned char *bufferPtr)
 {
 	return saveToMemory(bufferPtr, 0);
@@ -375,6 +449,39 @@ void Texture::setWrap(Wrap wrapMode)
 	wrapMode_ = wrapMode;
 }
 
+bool Texture::isDefaultMipMapGenerationEnabled()
+{
+	return defaultMipMapGenerationEnabled_;
+}
+
+/*! \note The generation state is only assigned to textures created after the call */
+void Texture::setDefaultMipMapGenerationEnabled(bool mipMapGenerationEnabled)
+{
+	defaultMipMapGenerationEnabled_ = mipMapGenerationEnabled;
+}
+
+Texture::LoadConversion Texture::defaultLoadConversion()
+{
+	return defaultLoadConversion_;
+}
+
+bool Texture::isDefaultLoadDitheringEnabled()
+{
+	return defaultLoadDitheringEnabled_;
+}
+
+/*! \note The conversion is only assigned to textures created after the call */
+void Texture::setDefaultLoadConversion(LoadConversion loadConversion)
+{
+	defaultLoadConversion_ = loadConversion;
+}
+
+/*! \note The dithering state is only assigned to textures created after the call */
+void Texture::setDefaultLoadDitheringEnabled(bool loadDitheringEnabled)
+{
+	defaultLoadDitheringEnabled_ = loadDitheringEnabled;
+}
+
 void Texture::setGLTextureLabel(const char *label)
 {
 	glTexture_->setObjectLabel(label);
@@ -423,7 +530,7 @@ void Texture::initialize(const ITextureLoader &texLoader)
 	GLenum internalFormat = texFormat.internalFormat();
 	GLenum format = texFormat.format();
 	unsigned long dataSize = texLoader.dataSize();
-	if (texFormat.isCompressed() == false && format == GL_RGB && isChromaKeyEnabled_)
+	if (texFormat.isCompressed() == false && format == GL_RGB && texFormat.type() == GL_UNSIGNED_BYTE && isChromaKeyEnabled_)
 	{
 		internalFormat = GL_RGBA8;
 		format = GL_RGBA;
@@ -459,18 +566,29 @@ void Texture::initialize(const ITextureLoader &texLoader)
 			for (int i = 0; i < texLoader.mipMapCount(); i++)
 			{
 				glTexture_->texImage2D(i, internalFormat, levelWidth, levelHeight, format, texFormat.type(), nullptr);
-				levelWidth /= 2;
-				levelHeight /= 2;
+				levelWidth = (levelWidth > 1) ? levelWidth / 2 : 1;
+				levelHeight = (levelHeight > 1) ? levelHeight / 2 : 1;
 			}
 		}
 	}
 
+	const bool streamerNeedsUpdate = (streamer_ != nullptr && (width_ != texLoader.width() || height_ != texLoader.height() || format_ != formatToNc(format)));
+
 	width_ = texLoader.width();
 	height_ = texLoader.height();
 	mipMapLevels_ = texLoader.mipMapCount();
 	isCompressed_ = texFormat.isCompressed();
 	format_ = formatToNc(format);
 	dataSize_ = dataSize;
+
+	// Streaming buffers are recreated to match the new size and format
+	if (streamerNeedsUpdate)
+	{
+		const unsigned int numBuffers = streamer_->numBuffers();
+		streamer_.reset(nullptr);
+		if (isCompressed_ == false && format_ != Format::UNKNOWN)
+			streamer_ = nctl::makeUnique<TextureStreamer>(numBuffers, width_, height_, numChannels());
+	}
 }
 
 void Texture::load(const ITextureLoader &texLoader)
@@ -489,10 +607,14 @@ void Texture::load(const ITextureLoader &texLoader)
 	GLenum format = texFormat.format();
 	nctl::UniquePtr<uint32_t[]> chromaPixels;
 
+	// Rows of decoded or converted pixels are tightly packed, their size might not be a multiple of four bytes
+	if (texFormat.isCompressed() == false)
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
 	for (int mipIdx = 0; mipIdx < texLoader.mipMapCount(); mipIdx++)
 	{
 		const unsigned char *data = texLoader.pixels(mipIdx);
-		if (texFormat.isCompressed() == false && format == GL_RGB && isChromaKeyEnabled_)
+		if (texFormat.isCompressed() == false && format == GL_RGB && texFormat.type() == GL_UNSIGNED_BYTE && isChromaKeyEnabled_)
 		{
 			format = GL_RGBA;
 			const unsigned int numPixels = levelWidth * levelHeight;
@@ -512,9 +634,48 @@ void Texture::load(const ITextureLoader &texLoader)
 			// Storage has already been created at this point
 			glTexture_->texSubImage2D(mipIdx, 0, 0, levelWidth, levelHeight, format, texFormat.type(), data);
 
-		levelWidth /= 2;
-		levelHeight /= 2;
+		levelWidth = (levelWidth > 1) ? levelWidth / 2 : 1;
+		levelHeight = (levelHeight > 1) ? levelHeight / 2 : 1;
 	}
+
+	if (texFormat.isCompressed() == false)
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+void Texture::upload(const char *name, const ITextureLoader &texLoader)
+{
+	if (dataSize_ > 0)
+		RenderStatistics::removeTexture(dataSize_);
+
+	glTexture_->bind();
+	setName(name);
+	glTexture_->setObjectLabel(name);
+	initialize(texLoader);
+	load(texLoader);
+
+	RenderStatistics::addTexture(dataSize_);
+}
+
+void Texture::processPixels(ITextureLoader &texLoader) const
+{
+	// MIP maps are generated before any conversion to preserve the 8 bits per channel precision
+	if (isMipMapGenerationEnabled_ && texLoader.canGenerateMipMaps())
+		texLoader.generateMipMaps(true);
+
+	if (loadConversion_ == LoadConversion::NONE)
+		return;
+
+	const TextureFormat &texFormat = texLoader.texFormat();
+	// Chroma key transparency needs the original RGB pixels
+	if (isChromaKeyEnabled_ && texFormat.format() == GL_RGB)
+	{
+		LOGW("Load conversion is skipped for an RGB texture with chroma key enabled");
+		return;
+	}
+
+	const GLenum internalFormat = loadConversionToInternal(loadConversion_);
+	if (texLoader.canConvertPixels(internalFormat))
+		texLoader.convertPixels(internalFormat, isLoadDitheringEnabled_);
 }
 
 }
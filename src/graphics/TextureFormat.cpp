@@ -266,8 +266,9 @@ unsigned long TextureFormat::calculateMipSizes(GLenum internalFormat, int width,
 		if (mipDataSizes[i] < minDataSize)
 			mipDataSizes[i] = minDataSize;
 
-		levelWidth /= 2;
-		levelHeight /= 2;
+		// Every axis is halved independently and never goes below one pixel, as in a complete chain of a non-square texture
+		levelWidth = (levelWidth > 1) ? levelWidth / 2 : 1;
+		levelHeight = (levelHeight > 1) ? levelHeight / 2 : 1;
 		dataSizesSum += mipDataSizes[i];
 	}
 
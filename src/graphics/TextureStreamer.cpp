@@ -0,0 +1,139 @@
+#include "common_macros.h"
+#include "TextureStreamer.h"
+#include "GLBufferObject.h"
+#include "GLTexture.h"
+#include "GLDebug.h"
+#include "tracy.h"
+
+namespace ncine {
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+TextureStreamer::TextureStreamer(unsigned int numBuffers, int width, int height, unsigned int bytesPerPixel)
+    : numBuffers_(numBuffers), currentSlot_(0), width_(width), height_(height),
+      bytesPerPixel_(bytesPerPixel), mappedPtr_(nullptr), dirtyRegions_(4)
+{
+	ASSERT(numBuffers > 0 && numBuffers <= MaxNumBuffers);
+	ASSERT(width > 0 && height > 0);
+
+	const GLsizeiptr bufferSize = static_cast<GLsizeiptr>(width) * height * bytesPerPixel;
+	slots_ = nctl::makeUnique<Slot[]>(numBuffers_);
+	for (unsigned int i = 0; i < numBuffers_; i++)
+	{
+		slots_[i].pbo = nctl::makeUnique<GLBufferObject>(GL_PIXEL_UNPACK_BUFFER);
+		slots_[i].pbo->bufferData(bufferSize, nullptr, GL_STREAM_DRAW);
+		slots_[i].pbo->setObjectLabel("TextureStreamer_PBO");
+	}
+	slots_[numBuffers_ - 1].pbo->unbind();
+}
+
+TextureStreamer::~TextureStreamer()
+{
+	if (mappedPtr_ != nullptr)
+		slots_[currentSlot_].pbo->unmap();
+
+	for (unsigned int i = 0; i < numBuffers_; i++)
+	{
+		if (slots_[i].fence != nullptr)
+			glDeleteSync(slots_[i].fence);
+	}
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+unsigned char *TextureStreamer::map()
+{
+	if (mappedPtr_ != nullptr)
+		return mappedPtr_;
+
+	Slot &slot = slots_[currentSlot_];
+	if (slot.fence != nullptr)
+	{
+		// The wait only happens if the GPU is still reading from a buffer that was used a whole ring ago
+		GLenum status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+		if (status == GL_TIMEOUT_EXPIRED)
+		{
+			ZoneScopedN("Wait for streaming buffer");
+			while (status == GL_TIMEOUT_EXPIRED)
+				status = glClientWaitSync(slot.fence, 0, 1000000);
+		}
+		glDeleteSync(slot.fence);
+		slot.fence = nullptr;
+	}
+
+#if defined(__EMSCRIPTEN__)
+	// Emscripten only supports write and invalidate mappings
+	const GLbitfield mapFlags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
+#else
+	// The fence already guarantees that the buffer is not in use, no implicit synchronization is needed
+	const GLbitfield mapFlags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+#endif
+	mappedPtr_ = static_cast<unsigned char *>(slot.pbo->mapBufferRange(0, slot.pbo->size(), mapFlags));
+	slot.pbo->unbind();
+
+	if (mappedPtr_ == nullptr)
+	{
+		LOGW("Cannot map the texture streaming buffer");
+		slot.pbo->unmap();
+		slot.pbo->unbind();
+	}
+
+	return mappedPtr_;
+}
+
+void TextureStreamer::addDirtyRegion(const Recti &region)
+{
+	// Regions are clipped to the texture size
+	const int x0 = (region.x > 0) ? region.x : 0;
+	const int y0 = (region.y > 0) ? region.y : 0;
+	const int x1 = (region.x + region.w < width_) ? region.x + region.w : width_;
+	const int y1 = (region.y + region.h < height_) ? region.y + region.h : height_;
+
+	if (x1 > x0 && y1 > y0)
+		dirtyRegions_.pushBack(Recti(x0, y0, x1 - x0, y1 - y0));
+}
+
+/*! \note If no region has been marked as dirty the whole texture is uploaded */
+unsigned long TextureStreamer::upload(GLTexture &texture, GLenum format)
+{
+	if (mappedPtr_ == nullptr)
+		return 0;
+
+	GLDebug::ScopedGroup scoped("TextureStreamer::upload()");
+	Slot &slot = slots_[currentSlot_];
+	slot.pbo->unmap();
+	mappedPtr_ = nullptr;
+
+	if (dirtyRegions_.isEmpty())
+		dirtyRegions_.pushBack(Recti(0, 0, width_, height_));
+
+	// Rows in the buffer are tightly packed and as wide as the whole texture
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, width_);
+
+	unsigned long uploadedBytes = 0;
+	for (unsigned int i = 0; i < dirtyRegions_.size(); i++)
+	{
+		const Recti &region = dirtyRegions_[i];
+		const unsigned long offset = (static_cast<unsigned long>(region.y) * width_ + region.x) * bytesPerPixel_;
+		// With a pixel unpack buffer bound the data pointer is an offset and the upload does not block
+		texture.texSubImage2D(0, region.x, region.y, region.w, region.h, format, GL_UNSIGNED_BYTE, reinterpret_cast<const void *>(offset));
+		uploadedBytes += static_cast<unsigned long>(region.w) * region.h * bytesPerPixel_;
+	}
+
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	slot.pbo->unbind();
+
+	slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	currentSlot_ = (currentSlot_ + 1) % numBuffers_;
+	dirtyRegions_.clear();
+
+	return uploadedBytes;
+}
+
+}
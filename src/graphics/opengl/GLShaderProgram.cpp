@@ -1,3 +1,4 @@
+#include <cstring> // for `memcpy()`
 #include <nctl/StaticHashMapIterator.h>
 #include "GLShaderProgram.h"
 #include "GLShader.h"
@@ -5,8 +6,14 @@
 #include "RenderResources.h"
 #include "RenderVaoPool.h"
 #include "BinaryShaderCache.h"
+#include "IGfxCapabilities.h"
+#include "ServiceLocator.h"
 #include "tracy.h"
 
+#ifndef GL_COMPLETION_STATUS_KHR
+	#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
 namespace ncine {
 
 namespace {
@@ -14,6 +21,40 @@ namespace {
 	unsigned int bufferSize = 0;
 	nctl::UniquePtr<uint8_t[]> bufferPtr;
 
+	/// Increase it every time the layout of the introspection data changes
+	const uint32_t IntrospectionVersion = 1;
+
+	struct IntrospectionHeader
+	{
+		uint32_t version;
+		uint32_t introspection;
+		/// Sizes of the classes copied verbatim, to discard data saved by a different build
+		uint32_t uniformSize;
+		uint32_t attributeSize;
+		uint32_t numUniforms;
+		uint32_t numUniformBlocks;
+		uint32_t numAttributes;
+		uint32_t totalSize;
+	};
+
+	struct UniformBlockRecord
+	{
+		GLuint index;
+		GLint size;
+		uint32_t alignAmount;
+		uint32_t numUniforms;
+		char name[GLUniformBlock::MaxNameLength];
+	};
+
+	void ensureBufferSize(unsigned int size)
+	{
+		if (bufferSize < size)
+		{
+			bufferSize = size;
+			bufferPtr = nctl::makeUnique<uint8_t[]>(bufferSize);
+		}
+	}
+
 }
 
 ///////////////////////////////////////////////////////////
@@ -34,7 +75,7 @@ GLShaderProgram::GLShaderProgram()
 
 GLShaderProgram::GLShaderProgram(QueryPhase queryPhase)
     : glHandle_(0), attachedShaders_(AttachedShadersInitialSize), hashName_(0),
-      status_(Status::NOT_LINKED), queryPhase_(queryPhase), shouldLogOnErrors_(true),
+      status_(Status::NOT_LINKED), queryPhase_(queryPhase), hasPendingBinary_(false), shouldLogOnErrors_(true),
       uniformsSize_(0), uniformBlocksSize_(0), uniforms_(UniformsInitialSize),
       uniformBlocks_(UniformBlocksInitialSize), attributes_(AttributesInitialSize)
 {
@@ -105,6 +146,8 @@ bool GLShaderProgram::initFromBinary(const char *filename, Introspection introsp
 	if (binaryHasLoaded == false)
 		return false;
 
+	// The hash is needed to retrieve the introspection data from the cache
+	hashName_ = shaderHash;
 	introspection_ = introspection;
 	if (queryPhase_ == QueryPhase::IMMEDIATE)
 	{
@@ -125,6 +168,20 @@ bool GLShaderProgram::isLinked() const
 	        status_ == Status::LINKED_WITH_INTROSPECTION);
 }
 
+bool GLShaderProgram::isLinkCompleted() const
+{
+	if (status_ != Status::LINKED_WITH_DEFERRED_QUERIES)
+		return true;
+
+	const IGfxCapabilities &gfxCaps = theServiceLocator().gfxCapabilities();
+	if (gfxCaps.hasExtension(IGfxCapabilities::GLExtensions::KHR_PARALLEL_SHADER_COMPILE) == false)
+		return true;
+
+	GLint completed = GL_FALSE;
+	glGetProgramiv(glHandle_, GL_COMPLETION_STATUS_KHR, &completed);
+	return (completed == GL_TRUE);
+}
+
 unsigned int GLShaderProgram::retrieveInfoLogLength() const
 {
 	GLint length = 0;
@@ -231,20 +288,11 @@ bool GLShaderProgram::link(Introspection introspection)
 		glLinkProgram(glHandle_);
 		if (RenderResources::binaryShaderCache().isEnabled())
 		{
-			const int binLength = binaryLength();
-			if (binLength > 0)
-			{
-				if (bufferSize < binLength)
-				{
-					bufferSize = binLength;
-					bufferPtr = nctl::makeUnique<uint8_t[]>(bufferSize);
-				}
-
-				unsigned int format = 0;
-				saveBinary(binLength, format, bufferPtr.get());
-
-				RenderResources::binaryShaderCache().saveToCache(binLength, bufferPtr.get(), format, hashName_);
-			}
+			// Retrieving the binary would wait for the linking to complete, with deferred queries it is postponed
+			if (queryPhase_ == QueryPhase::IMMEDIATE)
+				saveBinaryToCache();
+			else
+				hasPendingBinary_ = true;
 		}
 	}
 
@@ -280,6 +328,15 @@ void GLShaderProgram::use()
 	}
 }
 
+bool GLShaderProgram::savePendingBinary()
+{
+	if (hasPendingBinary_ == false)
+		return false;
+
+	hasPendingBinary_ = false;
+	return saveBinaryToCache();
+}
+
 bool GLShaderProgram::validate()
 {
 	glValidateProgram(glHandle_);
@@ -347,6 +404,7 @@ void GLShaderProgram::reset(QueryPhase queryPhase)
 
 	queryPhase_ = queryPhase;
 	status_ = Status::NOT_LINKED;
+	hasPendingBinary_ = false;
 }
 
 void GLShaderProgram::setObjectLabel(const char *label)
@@ -389,6 +447,23 @@ bool GLShaderProgram::saveBinary(int bufferSize, unsigned int &binaryFormat, voi
 	return (length > 0 && bufferSize >= length);
 }
 
+bool GLShaderProgram::saveBinaryToCache()
+{
+	ZoneScoped;
+	const int binLength = binaryLength();
+	if (binLength <= 0)
+		return false;
+
+	ensureBufferSize(binLength);
+
+	unsigned int format = 0;
+	const bool binaryHasSaved = saveBinary(binLength, format, bufferPtr.get());
+	if (binaryHasSaved == false)
+		return false;
+
+	return RenderResources::binaryShaderCache().saveToCache(binLength, bufferPtr.get(), format, hashName_);
+}
+
 bool GLShaderProgram::compileAttachedShaders()
 {
 	bool hasCompiled = true;
@@ -422,7 +497,11 @@ bool GLShaderProgram::deferredQueries()
 
 		const bool linkCheck = checkLinking();
 		if (linkCheck == false)
+		{
+			hasPendingBinary_ = false;
 			return false;
+		}
+		savePendingBinary();
 
 		// After linking, shader objects are not needed anymore
 		for (const nctl::UniquePtr<GLShader> &shader : attachedShaders_)
@@ -471,14 +550,147 @@ void GLShaderProgram::performIntrospection()
 		                                                      ? GLUniformBlock::DiscoverUniforms::DISABLED
 		                                                      : GLUniformBlock::DiscoverUniforms::ENABLED;
 
-		discoverUniforms();
-		discoverUniformBlocks(discover);
-		discoverAttributes();
+		const bool introspectionHasLoaded = loadIntrospectionFromCache();
+		if (introspectionHasLoaded == false)
+		{
+			discoverUniforms();
+			discoverUniformBlocks(discover);
+			discoverAttributes();
+			saveIntrospectionToCache();
+		}
 		initVertexFormat();
 		status_ = Status::LINKED_WITH_INTROSPECTION;
 	}
 }
 
+bool GLShaderProgram::loadIntrospectionFromCache()
+{
+	BinaryShaderCache &cache = RenderResources::binaryShaderCache();
+	if (cache.isEnabled() == false || hashName_ == 0)
+		return false;
+
+	unsigned int length = 0;
+	const uint8_t *data = static_cast<const uint8_t *>(cache.loadIntrospectionFromCache(hashName_, length));
+	if (data == nullptr || length < sizeof(IntrospectionHeader))
+		return false;
+
+	IntrospectionHeader header;
+	memcpy(&header, data, sizeof(IntrospectionHeader));
+	if (header.version != IntrospectionVersion || header.introspection != static_cast<uint32_t>(introspection_) ||
+	    header.uniformSize != sizeof(GLUniform) || header.attributeSize != sizeof(GLAttribute) || header.totalSize != length)
+	{
+		return false;
+	}
+
+	ZoneScoped;
+	const uint8_t *readPtr = data + sizeof(IntrospectionHeader);
+	const uint8_t *const dataEnd = data + length;
+
+	for (unsigned int i = 0; i < header.numUniforms && readPtr + sizeof(GLUniform) <= dataEnd; i++)
+	{
+		GLUniform uniform;
+		memcpy(&uniform, readPtr, sizeof(GLUniform));
+		readPtr += sizeof(GLUniform);
+		uniformsSize_ += uniform.memorySize();
+		uniforms_.pushBack(uniform);
+	}
+
+	for (unsigned int i = 0; i < header.numUniformBlocks && readPtr + sizeof(UniformBlockRecord) <= dataEnd; i++)
+	{
+		UniformBlockRecord record;
+		memcpy(&record, readPtr, sizeof(UniformBlockRecord));
+		readPtr += sizeof(UniformBlockRecord);
+
+		GLUniformBlock uniformBlock;
+		uniformBlock.program_ = glHandle_;
+		uniformBlock.index_ = record.index;
+		uniformBlock.size_ = record.size;
+		uniformBlock.alignAmount_ = static_cast<unsigned char>(record.alignAmount);
+		memcpy(uniformBlock.name_, record.name, GLUniformBlock::MaxNameLength);
+		for (unsigned int j = 0; j < record.numUniforms && readPtr + sizeof(GLUniform) <= dataEnd; j++)
+		{
+			GLUniform blockUniform;
+			memcpy(&blockUniform, readPtr, sizeof(GLUniform));
+			readPtr += sizeof(GLUniform);
+			uniformBlock.blockUniforms_[blockUniform.name()] = blockUniform;
+		}
+		uniformBlocksSize_ += uniformBlock.size();
+		uniformBlocks_.pushBack(uniformBlock);
+	}
+
+	for (unsigned int i = 0; i < header.numAttributes && readPtr + sizeof(GLAttribute) <= dataEnd; i++)
+	{
+		GLAttribute attribute;
+		memcpy(&attribute, readPtr, sizeof(GLAttribute));
+		readPtr += sizeof(GLAttribute);
+		attributes_.pushBack(attribute);
+	}
+
+	LOGD_X("Shader program %u - introspection loaded from cache: %u uniforms, %u uniform blocks, %u attributes",
+	       glHandle_, uniforms_.size(), uniformBlocks_.size(), attributes_.size());
+	return true;
+}
+
+void GLShaderProgram::saveIntrospectionToCache()
+{
+	BinaryShaderCache &cache = RenderResources::binaryShaderCache();
+	if (cache.isEnabled() == false || hashName_ == 0)
+		return;
+
+	unsigned int totalSize = sizeof(IntrospectionHeader) + uniforms_.size() * sizeof(GLUniform) + attributes_.size() * sizeof(GLAttribute);
+	for (const GLUniformBlock &uniformBlock : uniformBlocks_)
+		totalSize += sizeof(UniformBlockRecord) + uniformBlock.blockUniforms_.size() * sizeof(GLUniform);
+	ensureBufferSize(totalSize);
+
+	IntrospectionHeader header;
+	header.version = IntrospectionVersion;
+	header.introspection = static_cast<uint32_t>(introspection_);
+	header.uniformSize = sizeof(GLUniform);
+	header.attributeSize = sizeof(GLAttribute);
+	header.numUniforms = uniforms_.size();
+	header.numUniformBlocks = uniformBlocks_.size();
+	header.numAttributes = attributes_.size();
+	header.totalSize = totalSize;
+
+	uint8_t *writePtr = bufferPtr.get();
+	memcpy(writePtr, &header, sizeof(IntrospectionHeader));
+	writePtr += sizeof(IntrospectionHeader);
+
+	for (const GLUniform &uniform : uniforms_)
+	{
+		memcpy(writePtr, &uniform, sizeof(GLUniform));
+		writePtr += sizeof(GLUniform);
+	}
+
+	for (const GLUniformBlock &uniformBlock : uniformBlocks_)
+	{
+		UniformBlockRecord record;
+		memset(&record, 0, sizeof(UniformBlockRecord));
+		record.index = uniformBlock.index_;
+		record.size = uniformBlock.size_;
+		record.alignAmount = uniformBlock.alignAmount_;
+		record.numUniforms = uniformBlock.blockUniforms_.size();
+		memcpy(record.name, uniformBlock.name_, GLUniformBlock::MaxNameLength);
+		memcpy(writePtr, &record, sizeof(UniformBlockRecord));
+		writePtr += sizeof(UniformBlockRecord);
+
+		for (const GLUniform &blockUniform : uniformBlock.blockUniforms_)
+		{
+			memcpy(writePtr, &blockUniform, sizeof(GLUniform));
+			writePtr += sizeof(GLUniform);
+		}
+	}
+
+	for (const GLAttribute &attribute : attributes_)
+	{
+		memcpy(writePtr, &attribute, sizeof(GLAttribute));
+		writePtr += sizeof(GLAttribute);
+	}
+	ASSERT(writePtr == bufferPtr.get() + totalSize);
+
+	cache.saveIntrospectionToCache(totalSize, bufferPtr.get(), hashName_);
+}
+
 void GLShaderProgram::discoverUniforms()
 {
 	static const unsigned int NumIndices = 512;
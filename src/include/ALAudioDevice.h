@@ -7,6 +7,7 @@
 #include "IAudioDevice.h"
 #include <nctl/Array.h>
 #include <nctl/HashSet.h>
+#include "TimeStamp.h"
 
 namespace ncine {
 
@@ -19,6 +20,9 @@ class ALAudioDevice : public IAudioDevice
 	explicit ALAudioDevice(const AppConfiguration &appCfg);
 	~ALAudioDevice() override;
 
+	/// Returns true if the default OpenAL device can be opened
+	static bool isAvailable();
+
 	inline const Attributes &attributes() const override { return attributes_; }
 	inline const char *name() const override { return attributes_.deviceName; }
 	bool hasExtension(ALExtensions::Enum extensionName) const override;
@@ -41,6 +45,10 @@ class ALAudioDevice : public IAudioDevice
 	const IAudioPlayer *player(unsigned int index) const override;
 	IAudioPlayer *player(unsigned int index) override;
 
+	inline unsigned int numVirtualPlayers() const override { return virtualPlayers_.size(); }
+	const IAudioPlayer *virtualPlayer(unsigned int index) const override;
+	IAudioPlayer *virtualPlayer(unsigned int index) override;
+
 	void pausePlayers() override;
 	void stopPlayers() override;
 	void pausePlayers(PlayerType playerType) override;
@@ -54,7 +62,15 @@ class ALAudioDevice : public IAudioDevice
 	void unregisterPlayer(IAudioPlayer *player) override;
 	void updatePlayers() override;
 
+	inline unsigned int numStreamUnderruns() const override { return numStreamUnderruns_; }
+	inline void resetStreamUnderruns() override { numStreamUnderruns_ = 0; }
+
   private:
+	/// The minimum audibility difference for a player to take the source of another one, to avoid continuous swaps
+	static const float VirtualizationThreshold;
+	/// The maximum number of virtual players that can get a source back at each update
+	static const unsigned int MaxDevirtualizationsPerUpdate = 4;
+
 	/// The OpenAL device
 	ALCdevice *device_;
 	/// The OpenAL context for the device
@@ -77,10 +93,23 @@ class ALAudioDevice : public IAudioDevice
 	/// The array of audio players that have been paused by `pausePlayers()`
 	/*! \note A separate container is required as to not resume players that were already in the paused state */
 	nctl::HashSet<IAudioPlayer *> pausedPlayers_;
+	/// The array of players that are playing or paused without a source
+	nctl::Array<IAudioPlayer *> virtualPlayers_;
+	/// The time of the last update, to advance the playback position of virtual players
+	TimeStamp lastUpdateTime_;
+	/// The number of underruns of all stream players since the last reset
+	unsigned int numStreamUnderruns_;
 
 	/// Array of OpenAL extension availability flags
 	bool alExtensions_[IAudioDevice::ALExtensions::COUNT];
 
+	/// Takes the source from the least audible player, if the specified audibility is greater enough
+	bool virtualizeLeastAudible(float audibility);
+	/// Assigns sources to the most audible virtual players that are playing
+	void devirtualizePlayers();
+	/// Removes a player from the array of virtual players
+	void removeVirtualPlayer(IAudioPlayer *player);
+
 	void retrieveAttributes();
 	void retrieveExtensions();
 	void logALAttributes();
@@ -0,0 +1,47 @@
+#ifndef CLASS_NCINE_ARCHIVEDFILE
+#define CLASS_NCINE_ARCHIVEDFILE
+
+#include "IFile.h"
+
+namespace ncine {
+
+class AssetArchive;
+
+/// The class handling reading an entry of an asset archive
+/*! It behaves like a read-only memory file. The data of a stored entry in a mapped archive is not copied,
+ *  while a compressed entry is decompressed in a buffer when the file is opened. */
+class ArchivedFile : public IFile
+{
+  public:
+	ArchivedFile(const char *filename, const AssetArchive &archive, unsigned int entryIndex);
+	~ArchivedFile() override;
+
+	/// Tries to open the archived file, it can only be opened for reading
+	void open(unsigned char mode) override;
+	/// Closes the archived file and releases its decompressed data
+	void close() override;
+	long int seek(long int offset, int whence) const override;
+	long int tell() const override;
+	unsigned long int read(void *buffer, unsigned long int bytes) const override;
+	unsigned long int write(const void *buffer, unsigned long int bytes) override;
+
+	inline const void *bufferPtr() const override { return bufferPtr_; }
+	/*! \note The data of a stored entry belongs to the archive mapping and should not be modified */
+	inline void *bufferPtr() override { return const_cast<unsigned char *>(bufferPtr_); }
+
+  private:
+	const AssetArchive &archive_;
+	unsigned int entryIndex_;
+	const unsigned char *bufferPtr_;
+	nctl::UniquePtr<unsigned char[]> ownedBuffer_;
+	mutable unsigned long int seekOffset_;
+
+	/// Deleted copy constructor
+	ArchivedFile(const ArchivedFile &) = delete;
+	/// Deleted assignment operator
+	ArchivedFile &operator=(const ArchivedFile &) = delete;
+};
+
+}
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef CLASS_NCINE_AUDIOBUFFERCACHE
+#define CLASS_NCINE_AUDIOBUFFERCACHE
+
+#include <nctl/HashMap.h>
+#include <nctl/String.h>
+#include <nctl/UniquePtr.h>
+
+namespace ncine {
+
+/// A cache of OpenAL buffers with decoded samples, shared by audio buffers with the same content hash
+/*! Decoded samples of compressed sources can also be saved on disk to skip decoding on the next load. */
+class AudioBufferCache
+{
+  public:
+	/// The format and the OpenAL buffer id of decoded samples
+	struct Entry
+	{
+		Entry()
+		    : bufferId(0), bytesPerSample(0), numChannels(0), frequency(0), numSamples(0), refCount(0) {}
+
+		unsigned int bufferId;
+		int bytesPerSample;
+		int numChannels;
+		int frequency;
+		unsigned long int numSamples;
+		/// Number of audio buffers sharing the OpenAL buffer
+		unsigned int refCount;
+	};
+
+	/// The statistics about cache requests
+	struct Statistics
+	{
+		unsigned int SharedBuffers = 0;
+		unsigned int Hits = 0;
+		unsigned int Misses = 0;
+		unsigned int DiskHits = 0;
+		unsigned int DiskWrites = 0;
+	};
+
+	AudioBufferCache();
+
+	inline bool isEnabled() const { return isEnabled_; }
+	inline void setEnabled(bool enabled) { isEnabled_ = enabled; }
+
+	/// Returns true if the cache directory is writable and decoded samples can be saved on disk
+	inline bool isDiskCacheAvailable() const { return isDiskCacheAvailable_; }
+	inline bool isDiskCacheEnabled() const { return isDiskCacheEnabled_; }
+	/// Enables or disables the disk cache of decoded samples, creating its directory if needed
+	void setDiskCacheEnabled(bool enabled);
+	inline const nctl::String &directory() const { return directory_; }
+
+	/// Copies the entry for the hash and increments its reference count, returns false if it is not cached
+	bool acquire(uint64_t hash, Entry &entry);
+	/// Adds an entry for the hash, with a reference count of one
+	void insert(uint64_t hash, const Entry &entry);
+	/// Decrements the reference count for the hash, returns true if the OpenAL buffer is no longer shared and can be deleted
+	bool release(uint64_t hash);
+
+	/// Loads decoded samples for the hash from the disk cache
+	bool loadFromDisk(uint64_t hash, Entry &entry, nctl::UniquePtr<unsigned char[]> &samples, unsigned long int &samplesSize);
+	/// Saves decoded samples for the hash to the disk cache
+	bool saveToDisk(uint64_t hash, const Entry &entry, const unsigned char *samples, unsigned long int samplesSize);
+	/// Deletes all the decoded samples saved on disk
+	unsigned int clearDisk();
+
+	inline const Statistics &statistics() const { return statistics_; }
+
+  private:
+	bool isEnabled_;
+	bool isDiskCacheAvailable_;
+	bool isDiskCacheEnabled_;
+	nctl::String directory_;
+	nctl::HashMap<uint64_t, Entry> entries_;
+	Statistics statistics_;
+
+	/// Deleted copy constructor
+	AudioBufferCache(const AudioBufferCache &) = delete;
+	/// Deleted assignment operator
+	AudioBufferCache &operator=(const AudioBufferCache &) = delete;
+};
+
+/// Meyers' Singleton
+extern AudioBufferCache &audioBufferCache();
+
+}
+
+#endif
@@ -8,6 +8,8 @@
 
 namespace ncine {
 
+class OggReadAheadBuffer;
+
 /// Ogg Vorbis audio loader
 class AudioLoaderOgg : public IAudioLoader
 {
@@ -20,6 +22,8 @@ class AudioLoaderOgg : public IAudioLoader
   private:
 	/// Vorbisfile handle
 	OggVorbis_File oggFile_;
+	/// Read-ahead buffer of compressed data, transferred to the reader with the file handle
+	nctl::UniquePtr<OggReadAheadBuffer> readAheadBuffer_;
 
 	/// Deleted copy constructor
 	AudioLoaderOgg(const AudioLoaderOgg &) = delete;
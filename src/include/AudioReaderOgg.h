@@ -4,6 +4,7 @@
 #define OV_EXCLUDE_STATIC_CALLBACKS
 #include <vorbis/vorbisfile.h>
 
+#include <nctl/Array.h>
 #include <nctl/UniquePtr.h>
 #include "IAudioReader.h"
 
@@ -11,21 +12,78 @@ namespace ncine {
 
 class IFile;
 
+/// A buffer of compressed data read ahead of the Vorbis decoder
+/*! It turns the many small reads of the decoder into fewer and larger file reads,
+ *  and it serves the short backward and forward seeks of a page search from memory. */
+class OggReadAheadBuffer
+{
+  public:
+	/// Size in bytes of the compressed data read at once
+	static const unsigned long int BufferSize = 64 * 1024;
+
+	explicit OggReadAheadBuffer(IFile *fileHandle);
+
+	unsigned long int read(void *buffer, unsigned long int bufferSize);
+	int seek(long int offset, int whence);
+	long int tell() const;
+	void close();
+
+  private:
+	IFile *fileHandle_;
+	nctl::UniquePtr<unsigned char[]> buffer_;
+	/// File offset of the first buffered byte, the file position is always at the end of the buffered bytes
+	long int bufferOffset_;
+	/// Number of valid bytes in the buffer
+	unsigned long int bufferFilled_;
+	/// Read position inside the buffer
+	unsigned long int bufferPosition_;
+
+	/// Deleted copy constructor
+	OggReadAheadBuffer(const OggReadAheadBuffer &) = delete;
+	/// Deleted assignment operator
+	OggReadAheadBuffer &operator=(const OggReadAheadBuffer &) = delete;
+};
+
 /// Ogg Vorbis audio reader
 class AudioReaderOgg : public IAudioReader
 {
   public:
-	AudioReaderOgg(nctl::UniquePtr<IFile> fileHandle, const OggVorbis_File &oggFile);
+	AudioReaderOgg(nctl::UniquePtr<IFile> fileHandle, nctl::UniquePtr<OggReadAheadBuffer> readAheadBuffer, const OggVorbis_File &oggFile);
 	~AudioReaderOgg() override;
 
 	unsigned long int read(void *buffer, unsigned long int bufferSize) const override;
 	void rewind() const override;
+	bool seek(unsigned long int sampleOffset) const override;
+
+	/// Returns the number of pages in the seek index
+	inline unsigned int numIndexedPages() const { return seekIndex_.size(); }
 
   private:
+	/// Maximum number of pages in the seek index
+	static const unsigned int MaxIndexedPages = 256;
+	/// Maximum number of samples decoded and discarded after a seek to an indexed page
+	static const unsigned long int MaxIndexedDistance = 16384;
+
+	/// A page boundary found by a previous seek
+	struct SeekPoint
+	{
+		ogg_int64_t sampleOffset;
+		ogg_int64_t rawOffset;
+	};
+
 	/// Audio file handle
 	nctl::UniquePtr<IFile> fileHandle_;
+	/// Read-ahead buffer used by the Vorbisfile callbacks, if any
+	nctl::UniquePtr<OggReadAheadBuffer> readAheadBuffer_;
 	/// Vorbisfile handle
 	mutable OggVorbis_File oggFile_;
+	/// Page boundaries sorted by sample offset, built lazily by seeking
+	mutable nctl::Array<SeekPoint> seekIndex_;
+
+	/// Moves to an indexed page before the specified sample, or searches for one and adds it to the index
+	bool seekPage(ogg_int64_t sampleOffset) const;
+	/// Decodes and discards the specified number of samples
+	bool skipSamples(ogg_int64_t numSamples) const;
 
 	/// Deleted copy constructor
 	AudioReaderOgg(const AudioReaderOgg &) = delete;
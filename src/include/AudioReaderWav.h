@@ -12,14 +12,17 @@ class IFile;
 class AudioReaderWav : public IAudioReader
 {
   public:
-	AudioReaderWav(nctl::UniquePtr<IFile> fileHandle);
+	AudioReaderWav(nctl::UniquePtr<IFile> fileHandle, int bytesPerFrame);
 
 	unsigned long int read(void *buffer, unsigned long int bufferSize) const override;
 	void rewind() const override;
+	bool seek(unsigned long int sampleOffset) const override;
 
   private:
 	/// Audio file handle
 	nctl::UniquePtr<IFile> fileHandle_;
+	/// Number of bytes of a sample for all channels
+	int bytesPerFrame_;
 
 	/// Deleted copy constructor
 	AudioReaderWav(const AudioReaderWav &) = delete;
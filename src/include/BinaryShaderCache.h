@@ -5,19 +5,27 @@
 #include <nctl/String.h>
 #include <nctl/StaticString.h>
 #include <nctl/HashMap.h>
+#include <nctl/UniquePtr.h>
 
 namespace ncine {
 
 /// The class that manages the cache of binary OpenGL shader programs
+/*! All binary shaders are packed in a single memory mapped archive file, indexed by an hashed table of contents.
+ *  The file is never modified in place: a modified archive replaces it when closed, and the last process closing it wins. */
 class BinaryShaderCache
 {
   public:
+	/// The name of the archive file inside the cache directory
+	static const char *ArchiveFilename;
+	/// The default maximum size in bytes of the binary shaders in the archive
+	static const unsigned long DefaultMaxSize = 32 * 1024 * 1024;
+
 	/// A static string that can holds the contents of the `ShaderFilenameFormat` string
 	using ShaderFilename = nctl::StaticString<47>;
 
 	struct ShaderInfo
 	{
-		/// The filename of the binary shader (it can be generated from the hash and will not be written on disk)
+		/// The name of the binary shader entry in the archive (it can be generated from the hash and will not be written on disk)
 		nctl::StaticString<47> binaryFilename;
 		/// A descriptive name for the shader program
 		nctl::StaticString<256> objectLabel;
@@ -29,6 +37,7 @@ class BinaryShaderCache
 	using ShaderInfoHashMapType = nctl::HashMap<uint64_t, ShaderInfo>;
 
 	/// The statistics about the cache and its requests
+	/*! \note Files counters refer to the binary shader entries in the archive. */
 	struct Statistics
 	{
 		unsigned int LoadedShaders = 0;
@@ -37,6 +46,12 @@ class BinaryShaderCache
 		unsigned int PlatformBytesCount = 0;
 		unsigned int TotalFilesCount = 0;
 		unsigned int TotalBytesCount = 0;
+		unsigned int LoadedIntrospections = 0;
+		unsigned int SavedIntrospections = 0;
+		/// Number of times the archive has been rewritten to remove entries or to grow its table of contents
+		unsigned int Compactions = 0;
+		/// Number of entries removed because the archive exceeded its maximum size
+		unsigned int EvictedShaders = 0;
 	};
 
 	BinaryShaderCache(bool enable, const char *dirname);
@@ -70,6 +85,7 @@ class BinaryShaderCache
 	/// Returns the size in bytes of the binary shader from the cache with the first available format and the given hash id
 	inline unsigned int binarySize(uint64_t hash) const { return binarySize(binaryFormat_, hash); }
 	/// Loads a binary shader from the cache with the given format and hash id
+	/*! \note The returned pointer points inside the archive mapping and stays valid only until the archive is modified. */
 	const void *loadFromCache(uint32_t binaryFormat, uint64_t hash);
 	/// Loads a binary shader from the cache with the first available format and the given hash id
 	inline const void *loadFromCache(uint64_t hash) { return loadFromCache(binaryFormat_, hash); }
@@ -78,6 +94,16 @@ class BinaryShaderCache
 	/// Saves a binary shader to the cache with the first available format and the given hash id
 	inline bool saveToCache(int length, const void *buffer, uint64_t hash) { return saveToCache(length, buffer, binaryFormat_, hash); }
 
+	/// Loads the introspection data of a shader program from the cache with the given format and hash id
+	/*! \note The returned pointer points inside the archive mapping and stays valid only until the archive is modified. */
+	const void *loadIntrospectionFromCache(uint32_t binaryFormat, uint64_t hash, unsigned int &length);
+	/// Loads the introspection data of a shader program from the cache with the first available format and the given hash id
+	inline const void *loadIntrospectionFromCache(uint64_t hash, unsigned int &length) { return loadIntrospectionFromCache(binaryFormat_, hash, length); }
+	/// Saves the introspection data of a shader program to the cache with the given format and hash id
+	bool saveIntrospectionToCache(int length, const void *buffer, uint32_t binaryFormat, uint64_t hash);
+	/// Saves the introspection data of a shader program to the cache with the first available format and the given hash id
+	inline bool saveIntrospectionToCache(int length, const void *buffer, uint64_t hash) { return saveIntrospectionToCache(length, buffer, binaryFormat_, hash); }
+
 	/// Returns true if the specified shader sources id hash has an entry in the shader information hashmap
 	bool hasShaderInfo(uint64_t shaderHashName) const;
 	/// Returns the shader information for the specified shader sources id hash
@@ -89,10 +115,18 @@ class BinaryShaderCache
 	/// Returns the hashmap that contains the shader information entries (for statistical purposes)
 	inline const ShaderInfoHashMapType &shaderInfoHashMap() const { return shaderInfos_; }
 
-	/// Deletes all binary shaders that don't belong to this platform from the cache directory (and the corresponding shader info text file)
+	/// Deletes all binary shaders that don't belong to this platform from the archive (and the corresponding shader info text file)
 	void prune();
-	/// Deletes all binary shaders and shader info text files from the cache directory
+	/// Deletes the archive and all shader info text files from the cache directory
 	void clear();
+	/// Rewrites the archive without unused space and with a table of contents sized for the current number of entries
+	bool compact();
+
+	/// Returns the maximum size in bytes of the binary shaders in the archive
+	inline unsigned long maxSize() const { return maxSize_; }
+	/// Sets the maximum size in bytes of the binary shaders in the archive, least recently used ones are evicted when exceeding it
+	/*! \note A value of zero means no limit. */
+	void setMaxSize(unsigned long maxSize);
 
 	/// Returns the statistics about the files in the cache
 	inline const Statistics &statistics() const { return statistics_; }
@@ -125,10 +159,38 @@ class BinaryShaderCache
 	/// The hash map containing the information for registered shaders
 	ShaderInfoHashMapType shaderInfos_;
 
+	/// Maximum size in bytes of the binary shaders in the archive
+	unsigned long maxSize_;
+
+	/// The kind of data stored in an archive entry
+	enum class EntryType : uint32_t
+	{
+		PROGRAM_BINARY = 0,
+		INTROSPECTION = 1
+	};
+
+	struct ArchiveHeader;
+	struct TocEntry;
+	struct MappedArchive;
+	/// The private copy of the archive file containing the binary shaders
+	nctl::UniquePtr<MappedArchive> archive_;
+
 	/// Initializes the cache the first time it is enabled
 	bool initialize();
 
-	/// Scans the cache directory to collect statistics
+	/// Opens and maps the archive in the cache directory, creating a new one in memory if it does not exist or it is not valid
+	bool openArchive();
+	/// Writes a modified archive to a temporary file that replaces the old one, then releases it
+	/*! \note Entries used in a session that has not modified the archive do not update their last used session on disk */
+	void closeArchive();
+	/// Returns a pointer to the data of an archive entry and its length, or `nullptr` if it is not in the archive
+	const void *loadEntry(EntryType type, uint32_t binaryFormat, uint64_t hash, unsigned int &length);
+	/// Appends a new entry to the archive, evicting the least recently used ones or growing the table of contents if needed
+	bool saveEntry(EntryType type, int length, const void *buffer, uint32_t binaryFormat, uint64_t hash);
+	/// Rewrites the archive keeping the entries of other platforms or not, and the most recently used ones that fit in the byte budget
+	bool rewriteArchive(bool keepOtherPlatforms, unsigned long maxBytes, unsigned int minEntriesCapacity);
+
+	/// Scans the archive table of contents to collect statistics
 	void collectStatistics();
 	/// Resets all statistics to the initial values
 	void clearStatistics();
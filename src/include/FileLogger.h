@@ -2,15 +2,36 @@
 #define CLASS_NCINE_FILELOGGER
 
 #include <cstdio>
+#include <cstdarg>
+#include <ctime>
 #include "ILogger.h"
 #include "IFile.h"
+#include "BinaryLog.h"
+#include <nctl/Atomic.h>
+
+#ifdef WITH_THREADS
+	#include "Thread.h"
+	#include "ThreadSync.h"
+#endif
 
 namespace ncine {
 
 /// The standard console and file logger
+/*! In asynchronous mode the callers only copy the raw arguments into a lock-free ring of entries,
+ *  while a writer thread formats the messages and writes the entries in batches.
+ *  In binary mode the log file receives the raw records, to be formatted later by the `ncine_logdecode` tool.
+ *  \note Only the messages written with `writeStatic()`, like the ones of the logging macros, are formatted later.
+ *  The other ones are formatted by the caller, as their format strings might not outlive the call. */
 class FileLogger : public ILogger
 {
   public:
+	/// Number of entries in the ring used by the asynchronous mode
+	static const unsigned int AsyncQueueSize = 256;
+	/// Maximum time in milliseconds before the writer thread flushes the log file
+	static const unsigned int AsyncFlushInterval = 250;
+	/// Maximum number of distinct format strings that can be interned
+	static const unsigned int MaxInternedFormats = BinaryLog::MaxFormats;
+
 	explicit FileLogger(LogLevel consoleLevel);
 	FileLogger(LogLevel consoleLevel, LogLevel fileLevel, const char *filename);
 	~FileLogger() override;
@@ -19,12 +40,31 @@ class FileLogger : public ILogger
 	inline void setFileLevel(LogLevel fileLevel) { fileLevel_ = fileLevel; }
 	bool openLogFile(const char *filename);
 
+	bool isEnabled(LogLevel level) const override;
 	unsigned int write(LogLevel level, const char *fmt, ...) override;
+	unsigned int writeStatic(LogLevel level, const char *fmt, ...) override;
+
+	/// Returns true if the log file is written in the binary format
+	inline bool isBinary() const { return isBinary_; }
+	/// Sets the format of the log file, returns false if a log file is already open with a different format
+	bool setBinary(bool enabled);
+
+	/// Returns true if the entries are written by a dedicated thread
+	bool isAsync() const;
+	/// Starts or stops the writer thread, returns false if threads are not available
+	/*! \note Other threads can keep logging while the mode changes, but it should be changed by one thread at a time */
+	bool setAsync(bool enabled);
+	/// Blocks until all the entries have been written and flushes the log file
+	void flush();
+	/// Returns the number of entries that have been dropped because the ring was full
+	unsigned int numDroppedEntries() const;
 
 #ifdef WITH_IMGUI
-	inline const char *logString() const override { return logString_.data(); }
-	inline void clearLogString() override { logString_.clear(); }
-	inline unsigned int logStringLength() const override { return logString_.length(); }
+	/// Returns the log string with all the recorded log entries
+	/*! \note The log string should only be read and cleared by one thread, usually the main one */
+	const char *logString() const override;
+	void clearLogString() override;
+	unsigned int logStringLength() const override;
 	inline unsigned int logStringCapacity() const override { return logString_.capacity(); }
 #else
 	inline const char *logString() const override { return nullptr; }
@@ -37,6 +77,7 @@ class FileLogger : public ILogger
 	LogLevel consoleLevel_;
 	LogLevel fileLevel_;
 	bool canUseColors_;
+	bool isBinary_;
 
 	static const unsigned int MaxEntryLength = 1024;
 	char logEntry_[MaxEntryLength];
@@ -44,14 +85,109 @@ class FileLogger : public ILogger
 
 #ifdef WITH_IMGUI
 	static const unsigned int LogStringCapacity = 16 * 1024;
-	nctl::String logString_;
+	/// The log string returned to the reading thread, only accessed by it
+	mutable nctl::String logString_;
+	#ifdef WITH_THREADS
+	/// The entries written by any thread since the log string has been read
+	mutable nctl::String pendingLogString_;
+	mutable Mutex logStringMutex_;
+	#endif
+#endif
+
+	/// The states of an interned format string
+	enum FormatState
+	{
+		FORMAT_PARSING = 0,
+		FORMAT_READY,
+		FORMAT_UNSUPPORTED
+	};
+
+	/// A format string with the types of its arguments, found by the address of the string
+	struct InternedFormat
+	{
+		/// The address of the format string, or zero if the slot is free
+		nctl::Atomic64 key;
+		nctl::Atomic32 state;
+		/// Set when the format record has been written to the binary log file
+		nctl::Atomic32 isWritten;
+		const char *format;
+		unsigned int numArgs;
+		BinaryLog::ArgType argTypes[BinaryLog::MaxFormatArgs];
+	};
+
+	/// Open addressing table of interned format strings, allocated when deferred formatting is first needed
+	nctl::UniquePtr<InternedFormat[]> formats_;
+	/// Identifier of the format used to store messages that have been formatted immediately
+	int fallbackFormatId_;
+
+#ifdef WITH_THREADS
+	/// An entry of the asynchronous ring, with the raw arguments of its message
+	struct AsyncEntry
+	{
+		/// The position the entry is ready for, as in a bounded MPMC queue
+		nctl::Atomic32 sequence;
+		LogLevel level;
+		time_t time;
+		bool toConsole;
+		bool toFile;
+		int formatId;
+		unsigned int argsSize;
+		unsigned char args[MaxEntryLength];
+	};
+
+	/// The ring of entries, allocated the first time the asynchronous mode is enabled and kept alive for late producers
+	nctl::UniquePtr<AsyncEntry[]> asyncQueue_;
+	/// Set while the callers should push their entries in the ring
+	mutable nctl::Atomic32 isAsync_;
+	/// Position of the next entry to be claimed by a producer
+	nctl::Atomic32 enqueuePos_;
+	/// Position of the next entry to be written, only modified by the writer thread
+	mutable nctl::Atomic32 dequeuePos_;
+	mutable nctl::Atomic32 numDropped_;
+	nctl::Atomic32 isWriterWaiting_;
+	nctl::Atomic32 shouldQuit_;
+	Mutex writerMutex_;
+	CondVariable writerCondition_;
+	Thread writerThread_;
 #endif
 
 	// Declared at the end to prevent a `heap-use-after-free` AddressSanitizer error
 	nctl::UniquePtr<IFile> fileHandle_;
 
+	/// Writes a message to all destinations, deferring its formatting only if the format string has static storage duration
+	unsigned int writeArgs(LogLevel level, bool isStaticFormat, const char *fmt, va_list args);
+	/// Writes the time stamp and the level at the start of the entry buffer, returns the length of the prefix
+	unsigned int writePrefix(LogLevel level, time_t now, unsigned int &timeMsgLength);
+	/// Writes a complete entry to the console, the file and the log string
+	void output(LogLevel level, bool toConsole, bool toFile, unsigned int length, unsigned int timeMsgLength, unsigned int logMsgStart, unsigned int logMsgLength);
 	unsigned int writeWithColors(LogLevel level, const char *timeMsg, unsigned int timeMsgLength, const char *logMsg, unsigned int logMsgLength);
 
+	/// Returns true if a message has to be formatted as text for the console, the text log file or the log string
+	bool needsText(bool toConsole, bool toFile) const;
+	/// Allocates the table of interned format strings if needed
+	void createFormats();
+	/// Returns the identifier of an interned format string, or -1 if the table is full or the format is not supported
+	int internFormat(const char *fmt);
+	/// Copies the arguments of a message into a buffer of `MaxEntryLength` bytes, returns the identifier of their format
+	/*! A message whose format string is not static is formatted right away and stored as a single string argument */
+	int encodeArgs(bool isStaticFormat, const char *fmt, unsigned char *buffer, unsigned int &argsSize, va_list args);
+	/// Writes a message from its stored arguments to the binary log file or, once formatted, to the other destinations
+	void writeRecord(LogLevel level, time_t time, bool toConsole, bool toFile, int formatId, const unsigned char *args, unsigned int argsSize);
+	/// Writes an entry record, preceded by its format record the first time, to the binary log file
+	void writeBinaryEntry(LogLevel level, time_t time, int formatId, const unsigned char *args, unsigned int argsSize);
+	/// Writes the header and forgets the format records written to the previous binary log file
+	void writeBinaryHeader();
+
+#ifdef WITH_THREADS
+	/// Copies the arguments of a message into a free entry of the ring, returns their size or zero if the entry has been dropped
+	unsigned int pushEntry(LogLevel level, bool toConsole, bool toFile, bool isStaticFormat, const char *fmt, va_list args);
+	/// Wakes the writer thread up if it is waiting for new entries
+	void wakeWriter();
+	/// Writes the entries of the ring until the logger is destroyed or the asynchronous mode is stopped
+	void processEntries();
+	static void writerFunction(void *arg);
+#endif
+
 	/// Deleted copy constructor
 	FileLogger(const FileLogger &) = delete;
 	/// Deleted assignment operator
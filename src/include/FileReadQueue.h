@@ -0,0 +1,50 @@
+#ifndef CLASS_NCINE_FILEREADQUEUE
+#define CLASS_NCINE_FILEREADQUEUE
+
+#include <nctl/Array.h>
+#include <nctl/SharedPtr.h>
+#include "ThreadSync.h"
+#include "Thread.h"
+
+namespace ncine {
+
+class FileReadRequest;
+
+/// The queue of asynchronous file reads serviced by a dedicated I/O thread
+/*! The thread takes all the pending requests at once and services them sorted by file and offset,
+ *  to turn random accesses into forward sequential ones. */
+class FileReadQueue
+{
+  public:
+	FileReadQueue();
+	~FileReadQueue();
+
+	/// Adds a request to the pending ones and wakes up the I/O thread
+	void enqueue(const nctl::SharedPtr<FileReadRequest> &request);
+	/// Blocks the calling thread until the request is done
+	void wait(const FileReadRequest &request);
+	/// Wakes up the threads waiting for a request
+	void notifyDone();
+
+  private:
+	nctl::Array<nctl::SharedPtr<FileReadRequest>> pending_;
+	Mutex mutex_;
+	CondVariable queueCV_;
+	CondVariable doneCV_;
+	bool shouldQuit_;
+	Thread thread_;
+
+	static void ioThreadFunction(void *arg);
+
+	/// Deleted copy constructor
+	FileReadQueue(const FileReadQueue &) = delete;
+	/// Deleted assignment operator
+	FileReadQueue &operator=(const FileReadQueue &) = delete;
+};
+
+/// Returns the asynchronous read queue, creating the I/O thread the first time
+FileReadQueue &theFileReadQueue();
+
+}
+
+#endif
@@ -57,6 +57,9 @@ class GLShaderProgram
 	inline QueryPhase queryPhase() const { return queryPhase_; }
 
 	bool isLinked() const;
+	/// Returns true if the driver has finished compiling and linking the program
+	/*! \note It does not stall only if `GL_KHR_parallel_shader_compile` is available, otherwise it always returns true. */
+	bool isLinkCompleted() const;
 
 	/// Returns the length of the information log including the null termination character
 	unsigned int retrieveInfoLogLength() const;
@@ -80,6 +83,10 @@ class GLShaderProgram
 
 	bool link(Introspection introspection);
 	void use();
+	/// Returns true if the binary representation of a program linked with deferred queries has not been saved in the cache yet
+	inline bool hasPendingBinary() const { return hasPendingBinary_; }
+	/// Saves the binary representation of a program linked with deferred queries in the cache
+	bool savePendingBinary();
 	bool validate();
 
 	inline unsigned int numAttributes() const { return attributeLocations_.size(); }
@@ -121,6 +128,8 @@ class GLShaderProgram
 	Status status_;
 	Introspection introspection_;
 	QueryPhase queryPhase_;
+	/// A flag indicating whether the binary representation should be saved once the linking has completed
+	bool hasPendingBinary_;
 
 	/// A flag indicating whether the shader program should automatically log errors (the information log)
 	bool shouldLogOnErrors_;
@@ -144,11 +153,17 @@ class GLShaderProgram
 	int binaryLength() const;
 	/// Retrieves the binary representation of the shader program, if it is linked
 	bool saveBinary(int bufferSize, unsigned int &binaryFormat, void *buffer) const;
+	/// Retrieves the binary representation of the shader program and saves it in the cache
+	bool saveBinaryToCache();
 
 	bool compileAttachedShaders();
 	bool deferredQueries();
 	bool checkLinking();
 	void performIntrospection();
+	/// Restores uniforms, uniform blocks and attributes from the binary shader cache without any OpenGL query
+	bool loadIntrospectionFromCache();
+	/// Saves the discovered uniforms, uniform blocks and attributes to the binary shader cache
+	void saveIntrospectionToCache();
 
 	void discoverUniforms();
 	void discoverUniformBlocks(GLUniformBlock::DiscoverUniforms discover);
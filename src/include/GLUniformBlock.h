@@ -55,6 +55,7 @@ class GLUniformBlock
 	char name_[MaxNameLength];
 
 	friend class GLUniformBlockCache;
+	friend class GLShaderProgram;
 };
 
 }
@@ -19,6 +19,8 @@ class IAudioReader
 
 	/// Resets the audio file seek value
 	virtual void rewind() const = 0;
+	/// Moves the decoding position to the specified sample, returns false if it is not possible
+	virtual bool seek(unsigned long int sampleOffset) const = 0;
 };
 
 class InvalidAudioReader : IAudioReader
@@ -26,6 +28,7 @@ class InvalidAudioReader : IAudioReader
   public:
 	inline unsigned long int read(void *buffer, unsigned long int bufferSize) const override { return 0; }
 	inline void rewind() const override {};
+	inline bool seek(unsigned long int sampleOffset) const override { return false; }
 };
 
 }
@@ -33,10 +33,20 @@ class ITextureLoader
 	/// Returns the texture format object
 	inline const TextureFormat &texFormat() const { return texFormat_; }
 	/// Returns the pointer to pixel data
-	inline const GLubyte *pixels() const { return pixels_.get(); }
+	inline const GLubyte *pixels() const { return pixels_ ? pixels_.get() : filePixels_; }
 	/// Returns the pointer to pixel data for the specified MIP map level
 	const GLubyte *pixels(unsigned int mipMapLevel) const;
 
+	/// Returns true if a MIP map chain can be generated from the loaded pixels
+	bool canGenerateMipMaps() const;
+	/// Generates a complete MIP map chain from the first level, using the thread pool if available
+	bool generateMipMaps(bool gammaCorrect);
+
+	/// Returns true if the loaded pixels can be converted to the specified internal format
+	bool canConvertPixels(GLenum internalFormat) const;
+	/// Converts uncompressed 8 bits per channel pixel data to a smaller internal format, for all MIP map levels
+	bool convertPixels(GLenum internalFormat, bool withDithering);
+
 	/// Returns the proper texture loader according to the memory buffer name extension
 	static nctl::UniquePtr<ITextureLoader> createFromMemory(const char *bufferName, const unsigned char *bufferPtr, unsigned long int bufferSize);
 	/// Returns the proper texture loader according to the file extension
@@ -57,6 +67,8 @@ class ITextureLoader
 	nctl::UniquePtr<unsigned long[]> mipDataSizes_;
 	TextureFormat texFormat_;
 	nctl::UniquePtr<GLubyte[]> pixels_;
+	/// Pixel data inside the memory buffer of the file, used instead of a copy when the file exposes one
+	const GLubyte *filePixels_;
 
 	/// An empty constructor only used by `TextureLoaderRaw`
 	ITextureLoader();
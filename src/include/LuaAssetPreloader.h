@@ -0,0 +1,47 @@
+#ifndef CLASS_NCINE_LUAASSETPRELOADER
+#define CLASS_NCINE_LUAASSETPRELOADER
+
+struct lua_State;
+
+namespace ncine {
+
+class LuaStateManager;
+
+/// Lua bindings around the `AssetPreloader` class
+class LuaAssetPreloader
+{
+  public:
+	static void expose(LuaStateManager *stateManager);
+	static void exposeConstants(lua_State *L);
+	static void release(void *object);
+
+  private:
+	static int newObject(lua_State *L);
+
+	static int addTexture(lua_State *L);
+	static int addAudioBuffer(lua_State *L);
+	static int addFont(lua_State *L);
+
+	static int start(lua_State *L);
+	static int update(lua_State *L);
+	static int cancel(lua_State *L);
+
+	static int state(lua_State *L);
+	static int progress(lua_State *L);
+	static int updateBudget(lua_State *L);
+	static int setUpdateBudget(lua_State *L);
+
+	static int numAssets(lua_State *L);
+	static int numLoaded(lua_State *L);
+	static int numFailed(lua_State *L);
+	static int assetName(lua_State *L);
+	static int assetState(lua_State *L);
+
+	static int retrieveTexture(lua_State *L);
+	static int retrieveAudioBuffer(lua_State *L);
+	static int retrieveFont(lua_State *L);
+};
+
+}
+
+#endif
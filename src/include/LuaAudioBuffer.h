@@ -18,6 +18,7 @@ class LuaAudioBuffer
 	static int newObject(lua_State *L);
 
 	static int bufferId(lua_State *L);
+	static int isShared(lua_State *L);
 
 	static int bytesPerSample(lua_State *L);
 	static int numChannels(lua_State *L);
@@ -26,6 +27,12 @@ class LuaAudioBuffer
 	static int numSamples(lua_State *L);
 	static int duration(lua_State *L);
 	static int bufferSize(lua_State *L);
+
+	static int isCacheEnabled(lua_State *L);
+	static int setCacheEnabled(lua_State *L);
+	static int isDiskCacheEnabled(lua_State *L);
+	static int setDiskCacheEnabled(lua_State *L);
+	static int clearDiskCache(lua_State *L);
 };
 
 }
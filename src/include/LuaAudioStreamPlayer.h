@@ -20,6 +20,15 @@ class LuaAudioStreamPlayer
 	static int numSamplesInStreamBuffer(lua_State *L);
 	static int streamBufferSize(lua_State *L);
 	static int sampleOffsetInStream(lua_State *L);
+	static int setSampleOffsetInStream(lua_State *L);
+	static int loopStart(lua_State *L);
+	static int loopEnd(lua_State *L);
+	static int setLoopPoints(lua_State *L);
+	static int numStreamBuffers(lua_State *L);
+	static int setStreamBuffers(lua_State *L);
+	static int isAdaptiveBuffering(lua_State *L);
+	static int setAdaptiveBuffering(lua_State *L);
+	static int numUnderruns(lua_State *L);
 };
 
 }
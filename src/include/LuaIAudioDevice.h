@@ -29,6 +29,8 @@ class LuaIAudioDevice
 
 	static int numPlayers(lua_State *L);
 	static int player(lua_State *L);
+	static int numVirtualPlayers(lua_State *L);
+	static int virtualPlayer(lua_State *L);
 
 	static int pausePlayers(lua_State *L);
 	static int stopPlayers(lua_State *L);
@@ -36,6 +38,9 @@ class LuaIAudioDevice
 
 	static int pauseDevice(lua_State *L);
 	static int resumeDevice(lua_State *L);
+
+	static int numStreamUnderruns(lua_State *L);
+	static int resetStreamUnderruns(lua_State *L);
 };
 
 }
@@ -27,6 +27,10 @@ class LuaIAudioPlayer
 	static int sampleOffset(lua_State *L);
 	static int setSampleOffset(lua_State *L);
 
+	static int isVirtual(lua_State *L);
+	static int priority(lua_State *L);
+	static int setPriority(lua_State *L);
+
 	static int isSourceLocked(lua_State *L);
 	static int setSourceLocked(lua_State *L);
 
@@ -46,6 +50,8 @@ class LuaIAudioPlayer
 	static int pitch(lua_State *L);
 	static int setPitch(lua_State *L);
 
+	static int isSourceRelative(lua_State *L);
+	static int setSourceRelative(lua_State *L);
 	static int position(lua_State *L);
 	static int setPosition(lua_State *L);
 	static int velocity(lua_State *L);
@@ -46,6 +46,7 @@ class Qt5GfxDevice : public IGfxDevice
 #endif
 	void resetTextureBinding();
 	void bindDefaultDrawFramebufferObject();
+	void bindDefaultReadFramebufferObject();
 	/// Resets the OpenGL state cache to bind the default Qt5 Framebuffer Object
 	void resetFramebufferObjectBinding();
 
@@ -79,13 +79,13 @@ class RenderResources
 		/// Constructor that initializes the `ShaderCompileInfo` references from internal structures
 		explicit ShaderProgramCompileInfo(nctl::UniquePtr<GLShaderProgram> &sp)
 		    : shaderProgram(sp), vertexInfo(vertexInfoBlob), fragmentInfo(fragmentInfoBlob),
-		      introspection(GLShaderProgram::Introspection::ENABLED), objectLabel(nullptr) {}
+		      introspection(GLShaderProgram::Introspection::ENABLED), objectLabel(nullptr), defines(nullptr), fatalOnErrors(true) {}
 
 		/// Constructor that initializes the `ShaderCompileInfo` references from internal structures
 		ShaderProgramCompileInfo(nctl::UniquePtr<GLShaderProgram> &sp,
 		                         GLShaderProgram::Introspection introspection, const char *label)
 		    : shaderProgram(sp), vertexInfo(vertexInfoBlob), fragmentInfo(fragmentInfoBlob),
-		      introspection(introspection), objectLabel(label) {}
+		      introspection(introspection), objectLabel(label), defines(nullptr), fatalOnErrors(true) {}
 
 		/// Constructor that initializes the `ShaderCompileInfo` references from external structures
 		/*! \note Used by `create()` to initialize the `defaultVertexShaderInfos_` and `defaultFragmentShaderInfos_` arrays */
@@ -93,7 +93,7 @@ class RenderResources
 		                         ShaderCompileInfo &vs, ShaderCompileInfo &fs,
 		                         GLShaderProgram::Introspection introspection, const char *label)
 		    : shaderProgram(sp), vertexInfo(vs), fragmentInfo(fs),
-		      introspection(introspection), objectLabel(label) {}
+		      introspection(introspection), objectLabel(label), defines(nullptr), fatalOnErrors(true) {}
 
 		nctl::UniquePtr<GLShaderProgram> &shaderProgram;
 		/// Internal structure normally pointed by the `vertexInfo` reference
@@ -104,6 +104,10 @@ class RenderResources
 		ShaderCompileInfo &fragmentInfo;
 		GLShaderProgram::Introspection introspection;
 		const char *objectLabel;
+		/// Optional preprocessor directives prepended to both shader sources, their hash is added to the vertex one
+		const char *defines;
+		/// When false a shader program that fails to compile or link is reported by `compileShader()` instead of terminating
+		bool fatalOnErrors;
 	};
 
 	struct CameraUniformData
@@ -165,7 +169,7 @@ class RenderResources
 	/// Retrieves the compilation information for a default fragment shader (given its enum index)
 	static const ShaderProgramCompileInfo::ShaderCompileInfo &defaultFragmentShaderInfo(unsigned int index);
 	/// The function compiles a shader ex-novo or load it from the binary cache
-	static void compileShader(ShaderProgramCompileInfo &shaderToCompile);
+	static bool compileShader(ShaderProgramCompileInfo &shaderToCompile);
 
 	static GLShaderProgram *batchedShader(const GLShaderProgram *shader);
 	static bool registerBatchedShader(const GLShaderProgram *shader, ncine::GLShaderProgram *batchedShader);
@@ -72,6 +72,24 @@ class RenderStatistics
 		friend RenderStatistics;
 	};
 
+	class TextureStreaming
+	{
+	  public:
+		unsigned int uploads;
+		unsigned long bytes;
+
+		TextureStreaming()
+		    : uploads(0), bytes(0) {}
+
+	  private:
+		void reset()
+		{
+			uploads = 0;
+			bytes = 0;
+		}
+		friend RenderStatistics;
+	};
+
 	class CustomBuffers
 	{
 	  public:
@@ -143,6 +161,9 @@ class RenderStatistics
 	/// Returns aggregated texture statistics
 	static inline const Textures &textures() { return textures_; }
 
+	/// Returns the texture streaming statistics of the last frame
+	static inline const TextureStreaming &textureStreaming() { return textureStreaming_[(index_ + 1) % 2]; }
+
 	/// Returns aggregated custom VBOs statistics
 	static inline const CustomBuffers &customVBOs() { return customVbos_; }
 
@@ -166,6 +187,7 @@ class RenderStatistics
 	static Commands typedCommands_[RenderCommand::CommandTypes::COUNT];
 	static Buffers typedBuffers_[RenderBuffersManager::BufferTypes::COUNT];
 	static Textures textures_;
+	static TextureStreaming textureStreaming_[2];
 	static CustomBuffers customVbos_;
 	static CustomBuffers customIbos_;
 	static unsigned int index_;
@@ -196,6 +218,11 @@ class RenderStatistics
 		textures_.count--;
 		textures_.dataSize -= datasize;
 	}
+	static inline void addTextureStreamingUpload(unsigned long bytes)
+	{
+		textureStreaming_[index_].uploads++;
+		textureStreaming_[index_].bytes += bytes;
+	}
 	static inline void addCustomVbo(unsigned long datasize)
 	{
 		customVbos_.count++;
@@ -12,10 +12,14 @@ class StandardFile : public IFile
 	/// Constructs a standard file object
 	/*! \param filename File name including its path */
 	explicit StandardFile(const char *filename)
-	    : IFile(filename) { type_ = FileType::STANDARD; }
+	    : IFile(filename), mappedBuffer_(nullptr), mappedOffset_(0) { type_ = FileType::STANDARD; }
 	~StandardFile() override;
 
+	/// Minimum size in bytes of a file to be mapped in memory when opened for reading only
+	static const unsigned long int MinMappedSize = 16 * 1024;
+
 	/// Tries to open the standard file
+	/*! \note Files opened for reading only without a file descriptor are mapped in memory, if the platform supports it */
 	void open(unsigned char mode) override;
 	/// Closes the standard file
 	void close() override;
@@ -24,7 +28,20 @@ class StandardFile : public IFile
 	unsigned long int read(void *buffer, unsigned long int bytes) const override;
 	unsigned long int write(const void *buffer, unsigned long int bytes) override;
 
+	/// Returns true if the file content is mapped in memory
+	inline bool isMapped() const { return mappedBuffer_ != nullptr; }
+	/// Returns the constant pointer to the file content if it is mapped in memory, or `nullptr`
+	inline const void *bufferPtr() const override { return mappedBuffer_; }
+	/// Returns the pointer to the file content if it is mapped in memory, or `nullptr`
+	/*! \note The mapping is private, changes are never written back to the file */
+	inline void *bufferPtr() override { return mappedBuffer_; }
+
   private:
+	/// The file content mapped in memory, or `nullptr`
+	unsigned char *mappedBuffer_;
+	/// Read position inside the mapped content
+	mutable unsigned long int mappedOffset_;
+
 	/// Deleted copy constructor
 	StandardFile(const StandardFile &) = delete;
 	/// Deleted assignment operator
@@ -34,6 +51,8 @@ class StandardFile : public IFile
 	void openFD(unsigned char mode);
 	/// Opens the file with `fopen()`
 	void openStream(unsigned char mode);
+	/// Opens the file with `open()` and maps its content in memory, returns false if it is not possible
+	bool openMapped();
 };
 
 }
@@ -0,0 +1,63 @@
+#ifndef CLASS_NCINE_TEXTURESTREAMER
+#define CLASS_NCINE_TEXTURESTREAMER
+
+#define NCINE_INCLUDE_OPENGL
+#include "common_headers.h"
+#include <nctl/UniquePtr.h>
+#include <nctl/Array.h>
+#include "Rect.h"
+
+namespace ncine {
+
+class GLBufferObject;
+class GLTexture;
+
+/// A class to stream texel updates to a texture through a ring of pixel unpack buffers
+class TextureStreamer
+{
+  public:
+	static const unsigned int MaxNumBuffers = 4;
+
+	TextureStreamer(unsigned int numBuffers, int width, int height, unsigned int bytesPerPixel);
+	~TextureStreamer();
+
+	inline unsigned int numBuffers() const { return numBuffers_; }
+	/// Returns the number of bytes between two rows of the mapped memory
+	inline unsigned int pitch() const { return width_ * bytesPerPixel_; }
+	inline bool isMapped() const { return mappedPtr_ != nullptr; }
+
+	/// Maps the next buffer of the ring, waiting only if the GPU has not consumed it yet
+	unsigned char *map();
+	/// Marks a region of the mapped memory to be uploaded
+	void addDirtyRegion(const Recti &region);
+	/// Unmaps the buffer and issues the uploads of the dirty regions, returning the number of uploaded bytes
+	unsigned long upload(GLTexture &texture, GLenum format);
+
+  private:
+	struct Slot
+	{
+		Slot()
+		    : fence(nullptr) {}
+
+		nctl::UniquePtr<GLBufferObject> pbo;
+		GLsync fence;
+	};
+
+	nctl::UniquePtr<Slot[]> slots_;
+	unsigned int numBuffers_;
+	unsigned int currentSlot_;
+	int width_;
+	int height_;
+	unsigned int bytesPerPixel_;
+	unsigned char *mappedPtr_;
+	nctl::Array<Recti> dirtyRegions_;
+
+	/// Deleted copy constructor
+	TextureStreamer(const TextureStreamer &) = delete;
+	/// Deleted assignment operator
+	TextureStreamer &operator=(const TextureStreamer &) = delete;
+};
+
+}
+
+#endif
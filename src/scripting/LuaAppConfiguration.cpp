@@ -43,14 +43,20 @@ namespace AppConfiguration {
 	static const char *outputAudioFrequency = "output_audio_frequency";
 	static const char *monoAudioSources = "mono_audio_sources";
 	static const char *stereoAudioSources = "stereo_audio_sources";
+	static const char *numStreamBuffers = "num_stream_buffers";
+	static const char *streamBufferSize = "stream_buffer_size";
+	static const char *adaptiveStreamBuffers = "adaptive_stream_buffers";
 
 	static const char *withDebugOverlay = "debug_overlay";
 	static const char *withAudio = "audio";
+	static const char *withSoftwareAudio = "software_audio";
 	static const char *withThreads = "threads";
 	static const char *withScenegraph = "scenegraph";
 	static const char *withVSync = "vsync";
 	static const char *withGlDebugContext = "gl_debug_context";
 	static const char *withConsoleColors = "console_colors";
+	static const char *withAsyncLogging = "async_logging";
+	static const char *withBinaryLogging = "binary_logging";
 
 	static const char *glCoreProfile = "opengl_core_profile";
 	static const char *glForwardCompatible = "opengl_forward_compatible";
@@ -106,14 +112,20 @@ void LuaAppConfiguration::push(lua_State *L, const AppConfiguration &appCfg)
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::outputAudioFrequency, appCfg.outputAudioFrequency);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::monoAudioSources, appCfg.monoAudioSources);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::stereoAudioSources, appCfg.stereoAudioSources);
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::numStreamBuffers, appCfg.numStreamBuffers);
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::streamBufferSize, static_cast<int64_t>(appCfg.streamBufferSize));
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::adaptiveStreamBuffers, appCfg.adaptiveStreamBuffers);
 
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::withDebugOverlay, appCfg.withDebugOverlay);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::withAudio, appCfg.withAudio);
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::withSoftwareAudio, appCfg.withSoftwareAudio);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::withThreads, appCfg.withThreads);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::withScenegraph, appCfg.withScenegraph);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::withVSync, appCfg.withVSync);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::withGlDebugContext, appCfg.withGlDebugContext);
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::withConsoleColors, appCfg.withConsoleColors);
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::withAsyncLogging, appCfg.withAsyncLogging);
+	LuaUtils::pushField(L, LuaNames::AppConfiguration::withBinaryLogging, appCfg.withBinaryLogging);
 
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::glCoreProfile, appCfg.glCoreProfile());
 	LuaUtils::pushField(L, LuaNames::AppConfiguration::glForwardCompatible, appCfg.glForwardCompatible());
@@ -200,11 +212,19 @@ void LuaAppConfiguration::retrieveAndSet(lua_State *L, AppConfiguration &appCfg)
 	appCfg.monoAudioSources = monoAudioSources;
 	const unsigned int stereoAudioSources = LuaUtils::retrieveField<uint32_t>(L, -1, LuaNames::AppConfiguration::stereoAudioSources);
 	appCfg.stereoAudioSources = stereoAudioSources;
+	const unsigned int numStreamBuffers = LuaUtils::retrieveField<uint32_t>(L, -1, LuaNames::AppConfiguration::numStreamBuffers);
+	appCfg.numStreamBuffers = numStreamBuffers;
+	const unsigned long streamBufferSize = LuaUtils::retrieveField<uint64_t>(L, -1, LuaNames::AppConfiguration::streamBufferSize);
+	appCfg.streamBufferSize = streamBufferSize;
+	const bool adaptiveStreamBuffers = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::adaptiveStreamBuffers);
+	appCfg.adaptiveStreamBuffers = adaptiveStreamBuffers;
 
 	const bool withDebugOverlay = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::withDebugOverlay);
 	appCfg.withDebugOverlay = withDebugOverlay;
 	const bool withAudio = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::withAudio);
 	appCfg.withAudio = withAudio;
+	const bool withSoftwareAudio = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::withSoftwareAudio);
+	appCfg.withSoftwareAudio = withSoftwareAudio;
 	const bool withThreads = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::withThreads);
 	appCfg.withThreads = withThreads;
 	const bool withScenegraph = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::withScenegraph);
@@ -215,6 +235,10 @@ void LuaAppConfiguration::retrieveAndSet(lua_State *L, AppConfiguration &appCfg)
 	appCfg.withGlDebugContext = withGlDebugContext;
 	const bool withConsoleColors = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::withConsoleColors);
 	appCfg.withConsoleColors = withConsoleColors;
+	const bool withAsyncLogging = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::withAsyncLogging);
+	appCfg.withAsyncLogging = withAsyncLogging;
+	const bool withBinaryLogging = LuaUtils::retrieveField<bool>(L, -1, LuaNames::AppConfiguration::withBinaryLogging);
+	appCfg.withBinaryLogging = withBinaryLogging;
 }
 
 }
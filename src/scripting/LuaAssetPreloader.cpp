@@ -0,0 +1,377 @@
+#include "LuaAssetPreloader.h"
+#include "LuaUntrackedUserData.h"
+#include "LuaClassTracker.h"
+#include "LuaUtils.h"
+#include "AssetPreloader.h"
+#include "Texture.h"
+#include "Font.h"
+
+#ifdef WITH_AUDIO
+	#include "AudioBuffer.h"
+#endif
+
+namespace ncine {
+
+namespace LuaNames {
+namespace AssetPreloader {
+	static const char *AssetPreloader = "asset_preloader";
+
+	static const char *addTexture = "add_texture";
+	static const char *addAudioBuffer = "add_audio_buffer";
+	static const char *addFont = "add_font";
+
+	static const char *start = "start";
+	static const char *update = "update";
+	static const char *cancel = "cancel";
+
+	static const char *state = "get_state";
+	static const char *progress = "get_progress";
+	static const char *updateBudget = "get_update_budget";
+	static const char *setUpdateBudget = "set_update_budget";
+
+	static const char *numAssets = "num_assets";
+	static const char *numLoaded = "num_loaded";
+	static const char *numFailed = "num_failed";
+	static const char *assetName = "get_asset_name";
+	static const char *assetState = "get_asset_state";
+
+	static const char *retrieveTexture = "retrieve_texture";
+	static const char *retrieveAudioBuffer = "retrieve_audio_buffer";
+	static const char *retrieveFont = "retrieve_font";
+
+	static const char *IDLE = "IDLE";
+	static const char *LOADING = "LOADING";
+	static const char *COMPLETED = "COMPLETED";
+	static const char *CANCELED = "CANCELED";
+	static const char *State = "preloader_state";
+
+	static const char *PENDING = "PENDING";
+	static const char *LOADED = "LOADED";
+	static const char *FAILED = "FAILED";
+	static const char *RETRIEVED = "RETRIEVED";
+	static const char *AssetState = "preloader_asset_state";
+}}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void LuaAssetPreloader::expose(LuaStateManager *stateManager)
+{
+	lua_State *L = stateManager->state();
+	lua_createtable(L, 0, 20);
+
+	if (stateManager->apiType() == LuaStateManager::ApiType::FULL)
+	{
+		LuaClassTracker<AssetPreloader>::exposeDelete(L);
+		LuaUtils::addFunction(L, LuaNames::newObject, newObject);
+	}
+
+	LuaUtils::addFunction(L, LuaNames::AssetPreloader::addTexture, addTexture);
+	LuaUtils::addFunction(L, LuaNames::AssetPreloader::addAudioBuffer, addAudioBuffer);
+	LuaUtils::addFunction(L, LuaNames::AssetPreloader::addFont, addFont);
+
+	LuaUtils::addFunction(L, LuaNames::AssetPreloader::start, start);
+	LuaUtils::addFunction(L, LuaNames::AssetPreloader::update, update);
+	LuaUtils::addFunction(L, LuaNames::AssetPreloader::cancel, cancel);
+
+	LuaUtils::addFunction(L, LuaNames::AssetPreloader::state, state);
+	LuaUtils::addFunction(L, LuaNames::AssetPreloader::progress, progress);
+	LuaUtils::addFunction(L, LuaNames::AssetPreloader::updateBudget, updateBudget);
+	LuaUtils::addFunction(L, LuaNames::AssetPreloader::setUpdateBudget, setUpdateBudget);
+
+	LuaUtils::addFunction(L, LuaNames::AssetPreloader::numAssets, numAssets);
+	LuaUtils::addFunction(L, LuaNames::AssetPreloader::numLoaded, numLoaded);
+	LuaUtils::addFunction(L, LuaNames::AssetPreloader::numFailed, numFailed);
+	LuaUtils::addFunction(L, LuaNames::AssetPreloader::assetName, assetName);
+	LuaUtils::addFunction(L, LuaNames::AssetPreloader::assetState, assetState);
+
+	if (stateManager->apiType() == LuaStateManager::ApiType::FULL)
+	{
+		LuaUtils::addFunction(L, LuaNames::AssetPreloader::retrieveTexture, retrieveTexture);
+		LuaUtils::addFunction(L, LuaNames::AssetPreloader::retrieveAudioBuffer, retrieveAudioBuffer);
+		LuaUtils::addFunction(L, LuaNames::AssetPreloader::retrieveFont, retrieveFont);
+	}
+
+	lua_setfield(L, -2, LuaNames::AssetPreloader::AssetPreloader);
+}
+
+void LuaAssetPreloader::exposeConstants(lua_State *L)
+{
+	lua_createtable(L, 0, 4);
+
+	LuaUtils::pushField(L, LuaNames::AssetPreloader::IDLE, static_cast<int64_t>(AssetPreloader::State::IDLE));
+	LuaUtils::pushField(L, LuaNames::AssetPreloader::LOADING, static_cast<int64_t>(AssetPreloader::State::LOADING));
+	LuaUtils::pushField(L, LuaNames::AssetPreloader::COMPLETED, static_cast<int64_t>(AssetPreloader::State::COMPLETED));
+	LuaUtils::pushField(L, LuaNames::AssetPreloader::CANCELED, static_cast<int64_t>(AssetPreloader::State::CANCELED));
+
+	lua_setfield(L, -2, LuaNames::AssetPreloader::State);
+
+	lua_createtable(L, 0, 4);
+
+	LuaUtils::pushField(L, LuaNames::AssetPreloader::PENDING, static_cast<int64_t>(AssetPreloader::AssetState::PENDING));
+	LuaUtils::pushField(L, LuaNames::AssetPreloader::LOADED, static_cast<int64_t>(AssetPreloader::AssetState::LOADED));
+	LuaUtils::pushField(L, LuaNames::AssetPreloader::FAILED, static_cast<int64_t>(AssetPreloader::AssetState::FAILED));
+	LuaUtils::pushField(L, LuaNames::AssetPreloader::RETRIEVED, static_cast<int64_t>(AssetPreloader::AssetState::RETRIEVED));
+
+	lua_setfield(L, -2, LuaNames::AssetPreloader::AssetState);
+}
+
+void LuaAssetPreloader::release(void *object)
+{
+	AssetPreloader *preloader = reinterpret_cast<AssetPreloader *>(object);
+	delete preloader;
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+int LuaAssetPreloader::newObject(lua_State *L)
+{
+	LuaClassTracker<AssetPreloader>::newObject(L);
+
+	return 1;
+}
+
+int LuaAssetPreloader::addTexture(lua_State *L)
+{
+	AssetPreloader *preloader = LuaUntrackedUserData<AssetPreloader>::retrieve(L, -2);
+	const char *filename = LuaUtils::retrieve<const char *>(L, -1);
+
+	if (preloader)
+		LuaUtils::push(L, preloader->addTexture(filename));
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
+int LuaAssetPreloader::addAudioBuffer(lua_State *L)
+{
+	AssetPreloader *preloader = LuaUntrackedUserData<AssetPreloader>::retrieve(L, -2);
+	const char *filename = LuaUtils::retrieve<const char *>(L, -1);
+
+	if (preloader)
+		LuaUtils::push(L, preloader->addAudioBuffer(filename));
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
+int LuaAssetPreloader::addFont(lua_State *L)
+{
+	AssetPreloader *preloader = LuaUntrackedUserData<AssetPreloader>::retrieve(L, -2);
+	const char *fntFilename = LuaUtils::retrieve<const char *>(L, -1);
+
+	if (preloader)
+		LuaUtils::push(L, preloader->addFont(fntFilename));
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
+int LuaAssetPreloader::start(lua_State *L)
+{
+	AssetPreloader *preloader = LuaUntrackedUserData<AssetPreloader>::retrieve(L, -1);
+
+	if (preloader)
+		LuaUtils::push(L, preloader->start());
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
+int LuaAssetPreloader::update(lua_State *L)
+{
+	AssetPreloader *preloader = LuaUntrackedUserData<AssetPreloader>::retrieve(L, -1);
+
+	if (preloader)
+		LuaUtils::push(L, preloader->update());
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
+int LuaAssetPreloader::cancel(lua_State *L)
+{
+	AssetPreloader *preloader = LuaUntrackedUserData<AssetPreloader>::retrieve(L, -1);
+
+	if (preloader)
+		preloader->cancel();
+
+	return 0;
+}
+
+int LuaAssetPreloader::state(lua_State *L)
+{
+	AssetPreloader *preloader = LuaUntrackedUserData<AssetPreloader>::retrieve(L, -1);
+
+	if (preloader)
+		LuaUtils::push(L, static_cast<int64_t>(preloader->state()));
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
+int LuaAssetPreloader::progress(lua_State *L)
+{
+	AssetPreloader *preloader = LuaUntrackedUserData<AssetPreloader>::retrieve(L, -1);
+
+	if (preloader)
+		LuaUtils::push(L, preloader->progress());
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
+int LuaAssetPreloader::updateBudget(lua_State *L)
+{
+	AssetPreloader *preloader = LuaUntrackedUserData<AssetPreloader>::retrieve(L, -1);
+
+	if (preloader)
+		LuaUtils::push(L, preloader->updateBudget());
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
+int LuaAssetPreloader::setUpdateBudget(lua_State *L)
+{
+	AssetPreloader *preloader = LuaUntrackedUserData<AssetPreloader>::retrieve(L, -2);
+	const float milliseconds = LuaUtils::retrieve<float>(L, -1);
+
+	if (preloader)
+		preloader->setUpdateBudget(milliseconds);
+
+	return 0;
+}
+
+int LuaAssetPreloader::numAssets(lua_State *L)
+{
+	AssetPreloader *preloader = LuaUntrackedUserData<AssetPreloader>::retrieve(L, -1);
+
+	if (preloader)
+		LuaUtils::push(L, preloader->numAssets());
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
+int LuaAssetPreloader::numLoaded(lua_State *L)
+{
+	AssetPreloader *preloader = LuaUntrackedUserData<AssetPreloader>::retrieve(L, -1);
+
+	if (preloader)
+		LuaUtils::push(L, preloader->numLoaded());
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
+int LuaAssetPreloader::numFailed(lua_State *L)
+{
+	AssetPreloader *preloader = LuaUntrackedUserData<AssetPreloader>::retrieve(L, -1);
+
+	if (preloader)
+		LuaUtils::push(L, preloader->numFailed());
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
+int LuaAssetPreloader::assetName(lua_State *L)
+{
+	AssetPreloader *preloader = LuaUntrackedUserData<AssetPreloader>::retrieve(L, -2);
+	const int index = LuaUtils::retrieve<int>(L, -1);
+
+	if (preloader && index >= 0 && static_cast<unsigned int>(index) < preloader->numAssets())
+		LuaUtils::push(L, preloader->assetName(index));
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
+int LuaAssetPreloader::assetState(lua_State *L)
+{
+	AssetPreloader *preloader = LuaUntrackedUserData<AssetPreloader>::retrieve(L, -2);
+	const int index = LuaUtils::retrieve<int>(L, -1);
+
+	if (preloader && index >= 0 && static_cast<unsigned int>(index) < preloader->numAssets())
+		LuaUtils::push(L, static_cast<int64_t>(preloader->assetState(index)));
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
+/*! \note The retrieved texture becomes a new object tracked by Lua */
+int LuaAssetPreloader::retrieveTexture(lua_State *L)
+{
+	AssetPreloader *preloader = LuaUntrackedUserData<AssetPreloader>::retrieve(L, -2);
+	const int index = LuaUtils::retrieve<int>(L, -1);
+
+	nctl::UniquePtr<Texture> texture;
+	if (preloader && index >= 0)
+		texture = preloader->retrieveTexture(index);
+
+	if (texture != nullptr)
+		LuaClassTracker<Texture>::newObject(L, nctl::move(*texture));
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
+/*! \note The retrieved audio buffer becomes a new object tracked by Lua */
+int LuaAssetPreloader::retrieveAudioBuffer(lua_State *L)
+{
+#ifdef WITH_AUDIO
+	AssetPreloader *preloader = LuaUntrackedUserData<AssetPreloader>::retrieve(L, -2);
+	const int index = LuaUtils::retrieve<int>(L, -1);
+
+	nctl::UniquePtr<AudioBuffer> audioBuffer;
+	if (preloader && index >= 0)
+		audioBuffer = preloader->retrieveAudioBuffer(index);
+
+	if (audioBuffer != nullptr)
+		LuaClassTracker<AudioBuffer>::newObject(L, nctl::move(*audioBuffer));
+	else
+		LuaUtils::pushNil(L);
+#else
+	LuaUtils::pushNil(L);
+#endif
+
+	return 1;
+}
+
+/*! \note The retrieved font becomes a new object tracked by Lua */
+int LuaAssetPreloader::retrieveFont(lua_State *L)
+{
+	AssetPreloader *preloader = LuaUntrackedUserData<AssetPreloader>::retrieve(L, -2);
+	const int index = LuaUtils::retrieve<int>(L, -1);
+
+	nctl::UniquePtr<Font> font;
+	if (preloader && index >= 0)
+		font = preloader->retrieveFont(index);
+
+	if (font != nullptr)
+		LuaClassTracker<Font>::newObject(L, nctl::move(*font));
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
+}
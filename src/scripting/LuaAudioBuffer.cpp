@@ -11,6 +11,7 @@ namespace AudioBuffer {
 	static const char *AudioBuffer = "audio_buffer";
 
 	static const char *bufferId = "buffer_id";
+	static const char *isShared = "is_shared";
 
 	static const char *bytesPerSample = "bytes_per_sample";
 	static const char *numChannels = "num_channels";
@@ -19,6 +20,12 @@ namespace AudioBuffer {
 	static const char *numSamples = "num_samples";
 	static const char *duration = "duration";
 	static const char *bufferSize = "buffer_size";
+
+	static const char *isCacheEnabled = "is_cache_enabled";
+	static const char *setCacheEnabled = "set_cache_enabled";
+	static const char *isDiskCacheEnabled = "is_disk_cache_enabled";
+	static const char *setDiskCacheEnabled = "set_disk_cache_enabled";
+	static const char *clearDiskCache = "clear_disk_cache";
 }}
 
 ///////////////////////////////////////////////////////////
@@ -28,7 +35,7 @@ namespace AudioBuffer {
 void LuaAudioBuffer::expose(LuaStateManager *stateManager)
 {
 	lua_State *L = stateManager->state();
-	lua_createtable(L, 0, 9);
+	lua_createtable(L, 0, 15);
 
 	if (stateManager->apiType() == LuaStateManager::ApiType::FULL)
 	{
@@ -37,6 +44,7 @@ void LuaAudioBuffer::expose(LuaStateManager *stateManager)
 	}
 
 	LuaUtils::addFunction(L, LuaNames::AudioBuffer::bufferId, bufferId);
+	LuaUtils::addFunction(L, LuaNames::AudioBuffer::isShared, isShared);
 
 	LuaUtils::addFunction(L, LuaNames::AudioBuffer::bytesPerSample, bytesPerSample);
 	LuaUtils::addFunction(L, LuaNames::AudioBuffer::numChannels, numChannels);
@@ -46,6 +54,12 @@ void LuaAudioBuffer::expose(LuaStateManager *stateManager)
 	LuaUtils::addFunction(L, LuaNames::AudioBuffer::duration, duration);
 	LuaUtils::addFunction(L, LuaNames::AudioBuffer::bufferSize, bufferSize);
 
+	LuaUtils::addFunction(L, LuaNames::AudioBuffer::isCacheEnabled, isCacheEnabled);
+	LuaUtils::addFunction(L, LuaNames::AudioBuffer::setCacheEnabled, setCacheEnabled);
+	LuaUtils::addFunction(L, LuaNames::AudioBuffer::isDiskCacheEnabled, isDiskCacheEnabled);
+	LuaUtils::addFunction(L, LuaNames::AudioBuffer::setDiskCacheEnabled, setDiskCacheEnabled);
+	LuaUtils::addFunction(L, LuaNames::AudioBuffer::clearDiskCache, clearDiskCache);
+
 	lua_setfield(L, -2, LuaNames::AudioBuffer::AudioBuffer);
 }
 
@@ -80,6 +94,18 @@ int LuaAudioBuffer::bufferId(lua_State *L)
 	return 1;
 }
 
+int LuaAudioBuffer::isShared(lua_State *L)
+{
+	AudioBuffer *audioBuffer = LuaUntrackedUserData<AudioBuffer>::retrieve(L, -1);
+
+	if (audioBuffer)
+		LuaUtils::push(L, audioBuffer->isShared());
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
 int LuaAudioBuffer::bytesPerSample(lua_State *L)
 {
 	AudioBuffer *audioBuffer = LuaUntrackedUserData<AudioBuffer>::retrieve(L, -1);
@@ -152,4 +178,43 @@ int LuaAudioBuffer::bufferSize(lua_State *L)
 	return 1;
 }
 
+int LuaAudioBuffer::isCacheEnabled(lua_State *L)
+{
+	LuaUtils::push(L, AudioBuffer::isCacheEnabled());
+
+	return 1;
+}
+
+int LuaAudioBuffer::setCacheEnabled(lua_State *L)
+{
+	const bool enabled = LuaUtils::retrieve<bool>(L, -1);
+
+	AudioBuffer::setCacheEnabled(enabled);
+
+	return 0;
+}
+
+int LuaAudioBuffer::isDiskCacheEnabled(lua_State *L)
+{
+	LuaUtils::push(L, AudioBuffer::isDiskCacheEnabled());
+
+	return 1;
+}
+
+int LuaAudioBuffer::setDiskCacheEnabled(lua_State *L)
+{
+	const bool enabled = LuaUtils::retrieve<bool>(L, -1);
+
+	AudioBuffer::setDiskCacheEnabled(enabled);
+
+	return 0;
+}
+
+int LuaAudioBuffer::clearDiskCache(lua_State *L)
+{
+	LuaUtils::push(L, AudioBuffer::clearDiskCache());
+
+	return 1;
+}
+
 }
@@ -14,6 +14,15 @@ namespace AudioStreamPlayer {
 	static const char *numSamplesInStreamBuffer = "num_samples_in_stream_buffer";
 	static const char *streamBufferSize = "stream_buffer_size";
 	static const char *sampleOffsetInStream = "sample_offset_in_stream";
+	static const char *setSampleOffsetInStream = "set_sample_offset_in_stream";
+	static const char *loopStart = "get_loop_start";
+	static const char *loopEnd = "get_loop_end";
+	static const char *setLoopPoints = "set_loop_points";
+	static const char *numStreamBuffers = "num_stream_buffers";
+	static const char *setStreamBuffers = "set_stream_buffers";
+	static const char *isAdaptiveBuffering = "is_adaptive_buffering";
+	static const char *setAdaptiveBuffering = "set_adaptive_buffering";
+	static const char *numUnderruns = "num_underruns";
 }}
 
 ///////////////////////////////////////////////////////////
@@ -34,6 +43,15 @@ void LuaAudioStreamPlayer::expose(LuaStateManager *stateManager)
 	LuaUtils::addFunction(L, LuaNames::AudioStreamPlayer::numSamplesInStreamBuffer, numSamplesInStreamBuffer);
 	LuaUtils::addFunction(L, LuaNames::AudioStreamPlayer::streamBufferSize, streamBufferSize);
 	LuaUtils::addFunction(L, LuaNames::AudioStreamPlayer::sampleOffsetInStream, sampleOffsetInStream);
+	LuaUtils::addFunction(L, LuaNames::AudioStreamPlayer::setSampleOffsetInStream, setSampleOffsetInStream);
+	LuaUtils::addFunction(L, LuaNames::AudioStreamPlayer::loopStart, loopStart);
+	LuaUtils::addFunction(L, LuaNames::AudioStreamPlayer::loopEnd, loopEnd);
+	LuaUtils::addFunction(L, LuaNames::AudioStreamPlayer::setLoopPoints, setLoopPoints);
+	LuaUtils::addFunction(L, LuaNames::AudioStreamPlayer::numStreamBuffers, numStreamBuffers);
+	LuaUtils::addFunction(L, LuaNames::AudioStreamPlayer::setStreamBuffers, setStreamBuffers);
+	LuaUtils::addFunction(L, LuaNames::AudioStreamPlayer::isAdaptiveBuffering, isAdaptiveBuffering);
+	LuaUtils::addFunction(L, LuaNames::AudioStreamPlayer::setAdaptiveBuffering, setAdaptiveBuffering);
+	LuaUtils::addFunction(L, LuaNames::AudioStreamPlayer::numUnderruns, numUnderruns);
 
 	LuaIAudioPlayer::exposeFunctions(L);
 
@@ -95,4 +113,116 @@ int LuaAudioStreamPlayer::sampleOffsetInStream(lua_State *L)
 	return 1;
 }
 
+int LuaAudioStreamPlayer::setSampleOffsetInStream(lua_State *L)
+{
+	AudioStreamPlayer *audioStreamPlayer = LuaUntrackedUserData<AudioStreamPlayer>::retrieve(L, -2);
+	const unsigned long int sampleOffset = LuaUtils::retrieve<uint64_t>(L, -1);
+
+	if (audioStreamPlayer)
+		LuaUtils::push(L, audioStreamPlayer->setSampleOffsetInStream(sampleOffset));
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
+int LuaAudioStreamPlayer::loopStart(lua_State *L)
+{
+	AudioStreamPlayer *audioStreamPlayer = LuaUntrackedUserData<AudioStreamPlayer>::retrieve(L, -1);
+
+	if (audioStreamPlayer)
+		LuaUtils::push(L, static_cast<uint64_t>(audioStreamPlayer->loopStart()));
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
+int LuaAudioStreamPlayer::loopEnd(lua_State *L)
+{
+	AudioStreamPlayer *audioStreamPlayer = LuaUntrackedUserData<AudioStreamPlayer>::retrieve(L, -1);
+
+	if (audioStreamPlayer)
+		LuaUtils::push(L, static_cast<uint64_t>(audioStreamPlayer->loopEnd()));
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
+int LuaAudioStreamPlayer::setLoopPoints(lua_State *L)
+{
+	AudioStreamPlayer *audioStreamPlayer = LuaUntrackedUserData<AudioStreamPlayer>::retrieve(L, -3);
+	const unsigned long int loopStart = LuaUtils::retrieve<uint64_t>(L, -2);
+	const unsigned long int loopEnd = LuaUtils::retrieve<uint64_t>(L, -1);
+
+	if (audioStreamPlayer)
+		LuaUtils::push(L, audioStreamPlayer->setLoopPoints(loopStart, loopEnd));
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
+int LuaAudioStreamPlayer::numStreamBuffers(lua_State *L)
+{
+	AudioStreamPlayer *audioStreamPlayer = LuaUntrackedUserData<AudioStreamPlayer>::retrieve(L, -1);
+
+	if (audioStreamPlayer)
+		LuaUtils::push(L, audioStreamPlayer->numStreamBuffers());
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
+int LuaAudioStreamPlayer::setStreamBuffers(lua_State *L)
+{
+	AudioStreamPlayer *audioStreamPlayer = LuaUntrackedUserData<AudioStreamPlayer>::retrieve(L, -3);
+	const unsigned int numBuffers = LuaUtils::retrieve<uint32_t>(L, -2);
+	const unsigned long bufferSize = LuaUtils::retrieve<uint64_t>(L, -1);
+
+	if (audioStreamPlayer)
+		LuaUtils::push(L, audioStreamPlayer->setStreamBuffers(numBuffers, bufferSize));
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
+int LuaAudioStreamPlayer::isAdaptiveBuffering(lua_State *L)
+{
+	AudioStreamPlayer *audioStreamPlayer = LuaUntrackedUserData<AudioStreamPlayer>::retrieve(L, -1);
+
+	if (audioStreamPlayer)
+		LuaUtils::push(L, audioStreamPlayer->isAdaptiveBuffering());
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
+int LuaAudioStreamPlayer::setAdaptiveBuffering(lua_State *L)
+{
+	AudioStreamPlayer *audioStreamPlayer = LuaUntrackedUserData<AudioStreamPlayer>::retrieve(L, -2);
+	const bool adaptiveBuffering = LuaUtils::retrieve<bool>(L, -1);
+
+	if (audioStreamPlayer)
+		audioStreamPlayer->setAdaptiveBuffering(adaptiveBuffering);
+
+	return 0;
+}
+
+int LuaAudioStreamPlayer::numUnderruns(lua_State *L)
+{
+	AudioStreamPlayer *audioStreamPlayer = LuaUntrackedUserData<AudioStreamPlayer>::retrieve(L, -1);
+
+	if (audioStreamPlayer)
+		LuaUtils::push(L, audioStreamPlayer->numUnderruns());
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
 }
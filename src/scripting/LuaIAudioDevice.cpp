@@ -29,6 +29,8 @@ namespace IAudioDevice {
 
 	static const char *numPlayers = "get_num_players";
 	static const char *player = "get_player";
+	static const char *numVirtualPlayers = "get_num_virtual_players";
+	static const char *virtualPlayer = "get_virtual_player";
 
 	static const char *pausePlayers = "pause_players";
 	static const char *stopPlayers = "stop_players";
@@ -36,6 +38,9 @@ namespace IAudioDevice {
 
 	static const char *pauseDevice = "pause_device";
 	static const char *resumeDevice = "resume_device";
+
+	static const char *numStreamUnderruns = "get_num_stream_underruns";
+	static const char *resetStreamUnderruns = "reset_stream_underruns";
 }}
 
 ///////////////////////////////////////////////////////////
@@ -44,7 +49,7 @@ namespace IAudioDevice {
 
 void LuaIAudioDevice::expose(lua_State *L)
 {
-	lua_createtable(L, 0, 17);
+	lua_createtable(L, 0, 21);
 
 	LuaUtils::addFunction(L, LuaNames::IAudioDevice::name, name);
 	LuaUtils::addFunction(L, LuaNames::IAudioDevice::hasEfxExtension, hasEfxExtension);
@@ -63,6 +68,8 @@ void LuaIAudioDevice::expose(lua_State *L)
 
 	LuaUtils::addFunction(L, LuaNames::IAudioDevice::numPlayers, numPlayers);
 	LuaUtils::addFunction(L, LuaNames::IAudioDevice::player, player);
+	LuaUtils::addFunction(L, LuaNames::IAudioDevice::numVirtualPlayers, numVirtualPlayers);
+	LuaUtils::addFunction(L, LuaNames::IAudioDevice::virtualPlayer, virtualPlayer);
 
 	LuaUtils::addFunction(L, LuaNames::IAudioDevice::pausePlayers, pausePlayers);
 	LuaUtils::addFunction(L, LuaNames::IAudioDevice::stopPlayers, stopPlayers);
@@ -71,6 +78,9 @@ void LuaIAudioDevice::expose(lua_State *L)
 	LuaUtils::addFunction(L, LuaNames::IAudioDevice::pauseDevice, pauseDevice);
 	LuaUtils::addFunction(L, LuaNames::IAudioDevice::resumeDevice, resumeDevice);
 
+	LuaUtils::addFunction(L, LuaNames::IAudioDevice::numStreamUnderruns, numStreamUnderruns);
+	LuaUtils::addFunction(L, LuaNames::IAudioDevice::resetStreamUnderruns, resetStreamUnderruns);
+
 	lua_setfield(L, -2, LuaNames::IAudioDevice::IAudioDevice);
 }
 
@@ -173,6 +183,23 @@ int LuaIAudioDevice::player(lua_State *L)
 	return 1;
 }
 
+int LuaIAudioDevice::numVirtualPlayers(lua_State *L)
+{
+	const unsigned int numVirtualPlayers = theServiceLocator().audioDevice().numVirtualPlayers();
+	LuaUtils::push(L, numVirtualPlayers);
+
+	return 1;
+}
+
+int LuaIAudioDevice::virtualPlayer(lua_State *L)
+{
+	const int unsigned index = LuaUtils::retrieve<uint32_t>(L, -1);
+	const IAudioPlayer *player = theServiceLocator().audioDevice().virtualPlayer(index);
+	LuaUntrackedUserData<IAudioPlayer>::push(L, player);
+
+	return 1;
+}
+
 int LuaIAudioDevice::pausePlayers(lua_State *L)
 {
 	theServiceLocator().audioDevice().pausePlayers();
@@ -203,4 +230,18 @@ int LuaIAudioDevice::resumeDevice(lua_State *L)
 	return 0;
 }
 
+int LuaIAudioDevice::numStreamUnderruns(lua_State *L)
+{
+	const unsigned int numStreamUnderruns = theServiceLocator().audioDevice().numStreamUnderruns();
+	LuaUtils::push(L, numStreamUnderruns);
+
+	return 1;
+}
+
+int LuaIAudioDevice::resetStreamUnderruns(lua_State *L)
+{
+	theServiceLocator().audioDevice().resetStreamUnderruns();
+	return 0;
+}
+
 }
@@ -24,6 +24,10 @@ namespace IAudioPlayer {
 	static const char *sampleOffset = "get_sample_offset";
 	static const char *setSampleOffset = "set_sample_offset";
 
+	static const char *isVirtual = "is_virtual";
+	static const char *priority = "get_priority";
+	static const char *setPriority = "set_priority";
+
 	static const char *isSourceLocked = "is_source_locked";
 	static const char *setSourceLocked = "set_source_locked";
 
@@ -43,6 +47,8 @@ namespace IAudioPlayer {
 	static const char *pitch = "get_pitch";
 	static const char *setPitch = "set_pitch";
 
+	static const char *isSourceRelative = "is_source_relative";
+	static const char *setSourceRelative = "set_source_relative";
 	static const char *position = "get_position";
 	static const char *setPosition = "set_position";
 	static const char *velocity = "get_velocity";
@@ -101,6 +107,10 @@ void LuaIAudioPlayer::exposeFunctions(lua_State *L)
 	LuaUtils::addFunction(L, LuaNames::IAudioPlayer::sampleOffset, sampleOffset);
 	LuaUtils::addFunction(L, LuaNames::IAudioPlayer::setSampleOffset, setSampleOffset);
 
+	LuaUtils::addFunction(L, LuaNames::IAudioPlayer::isVirtual, isVirtual);
+	LuaUtils::addFunction(L, LuaNames::IAudioPlayer::priority, priority);
+	LuaUtils::addFunction(L, LuaNames::IAudioPlayer::setPriority, setPriority);
+
 	LuaUtils::addFunction(L, LuaNames::IAudioPlayer::isSourceLocked, isSourceLocked);
 	LuaUtils::addFunction(L, LuaNames::IAudioPlayer::setSourceLocked, setSourceLocked);
 
@@ -120,6 +130,8 @@ void LuaIAudioPlayer::exposeFunctions(lua_State *L)
 	LuaUtils::addFunction(L, LuaNames::IAudioPlayer::pitch, pitch);
 	LuaUtils::addFunction(L, LuaNames::IAudioPlayer::setPitch, setPitch);
 
+	LuaUtils::addFunction(L, LuaNames::IAudioPlayer::isSourceRelative, isSourceRelative);
+	LuaUtils::addFunction(L, LuaNames::IAudioPlayer::setSourceRelative, setSourceRelative);
 	LuaUtils::addFunction(L, LuaNames::IAudioPlayer::position, position);
 	LuaUtils::addFunction(L, LuaNames::IAudioPlayer::setPosition, setPosition);
 	LuaUtils::addFunction(L, LuaNames::IAudioPlayer::velocity, velocity);
@@ -287,6 +299,41 @@ int LuaIAudioPlayer::setSampleOffset(lua_State *L)
 	return 0;
 }
 
+int LuaIAudioPlayer::isVirtual(lua_State *L)
+{
+	IAudioPlayer *audioPlayer = LuaUntrackedUserData<IAudioPlayer>::retrieve(L, -1);
+
+	if (audioPlayer)
+		LuaUtils::push(L, audioPlayer->isVirtual());
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
+int LuaIAudioPlayer::priority(lua_State *L)
+{
+	IAudioPlayer *audioPlayer = LuaUntrackedUserData<IAudioPlayer>::retrieve(L, -1);
+
+	if (audioPlayer)
+		LuaUtils::push(L, audioPlayer->priority());
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
+int LuaIAudioPlayer::setPriority(lua_State *L)
+{
+	IAudioPlayer *audioPlayer = LuaUntrackedUserData<IAudioPlayer>::retrieve(L, -2);
+	const unsigned int priority = LuaUtils::retrieve<uint32_t>(L, -1);
+
+	if (audioPlayer)
+		audioPlayer->setPriority(priority);
+
+	return 0;
+}
+
 int LuaIAudioPlayer::isSourceLocked(lua_State *L)
 {
 	IAudioPlayer *audioPlayer = LuaUntrackedUserData<IAudioPlayer>::retrieve(L, -1);
@@ -445,6 +492,29 @@ int LuaIAudioPlayer::setPitch(lua_State *L)
 	return 0;
 }
 
+int LuaIAudioPlayer::isSourceRelative(lua_State *L)
+{
+	IAudioPlayer *audioPlayer = LuaUntrackedUserData<IAudioPlayer>::retrieve(L, -1);
+
+	if (audioPlayer)
+		LuaUtils::push(L, audioPlayer->isSourceRelative());
+	else
+		LuaUtils::pushNil(L);
+
+	return 1;
+}
+
+int LuaIAudioPlayer::setSourceRelative(lua_State *L)
+{
+	IAudioPlayer *audioPlayer = LuaUntrackedUserData<IAudioPlayer>::retrieve(L, -2);
+	const bool sourceRelative = LuaUtils::retrieve<bool>(L, -1);
+
+	if (audioPlayer)
+		audioPlayer->setSourceRelative(sourceRelative);
+
+	return 0;
+}
+
 int LuaIAudioPlayer::position(lua_State *L)
 {
 	IAudioPlayer *audioPlayer = LuaUntrackedUserData<IAudioPlayer>::retrieve(L, -1);
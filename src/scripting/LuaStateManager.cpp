@@ -47,6 +47,7 @@
 	#include "LuaRectAnimation.h"
 	#include "LuaParticleSystem.h"
 	#include "LuaParticleAffector.h"
+	#include "LuaAssetPreloader.h"
 
 	#ifdef WITH_AUDIO
 		#include "LuaIAudioDevice.h"
@@ -177,6 +178,11 @@ bool LuaStateManager::loadFromFile(const char *filename, const char *chunkName,
 		return false;
 
 	const unsigned long fileSize = fileHandle->size();
+	// The content of a mapped file is loaded without copying it
+	const char *fileBufferPtr = static_cast<const char *>(fileHandle->bufferPtr());
+	if (fileBufferPtr != nullptr)
+		return loadFromMemory(chunkName, fileBufferPtr, fileSize, errorMsg, status);
+
 	nctl::UniquePtr<char[]> buffer = nctl::makeUnique<char[]>(fileSize);
 	fileHandle->read(buffer.get(), fileSize);
 
@@ -569,6 +575,11 @@ void LuaStateManager::releaseTrackedMemory()
 				LuaParticleSystem::release(object);
 				break;
 			}
+			case LuaTypes::ASSET_PRELOADER:
+			{
+				LuaAssetPreloader::release(object);
+				break;
+			}
 			case LuaTypes::UNKNOWN:
 			default:
 				FATAL_MSG("Unsupported Lua wrapped userdata");
@@ -640,6 +651,7 @@ void LuaStateManager::exposeApi()
 		LuaTextNode::expose(this);
 		LuaParticleSystem::expose(this);
 		LuaParticleAffector::expose(this);
+		LuaAssetPreloader::expose(this);
 	}
 
 	#ifdef WITH_AUDIO
@@ -686,6 +698,7 @@ void LuaStateManager::exposeConstants()
 		LuaMeshSprite::exposeConstants(L_);
 		LuaFont::exposeConstants(L_);
 		LuaTextNode::exposeConstants(L_);
+		LuaAssetPreloader::exposeConstants(L_);
 	}
 	#ifdef WITH_OPENAL_EXT
 	if (appCfg.withAudio)
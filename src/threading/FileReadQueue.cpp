@@ -0,0 +1,127 @@
+#include "common_macros.h"
+#include "FileReadQueue.h"
+#include "FileReadRequest.h"
+#include <nctl/algorithms.h>
+
+namespace ncine {
+
+namespace {
+
+	/// Sorts by file and then by offset inside the same file
+	bool isBeforeInFile(const nctl::SharedPtr<FileReadRequest> &a, const nctl::SharedPtr<FileReadRequest> &b)
+	{
+		if (&a->file() != &b->file())
+			return &a->file() < &b->file();
+		return a->offset() < b->offset();
+	}
+
+}
+
+///////////////////////////////////////////////////////////
+// CONSTRUCTORS and DESTRUCTOR
+///////////////////////////////////////////////////////////
+
+FileReadQueue::FileReadQueue()
+    : pending_(16), shouldQuit_(false), thread_(ioThreadFunction, this)
+{
+#if !defined(__EMSCRIPTEN__) && !defined(__APPLE__)
+	thread_.setName("IOThread");
+#endif
+}
+
+FileReadQueue::~FileReadQueue()
+{
+	mutex_.lock();
+	shouldQuit_ = true;
+	queueCV_.broadcast();
+	mutex_.unlock();
+
+	thread_.join();
+
+	// Requests that have not been serviced are canceled to release their waiters.
+	// The queue can be a static being destroyed, so waiters are woken up here instead of through `cancel()`.
+	mutex_.lock();
+	for (unsigned int i = 0; i < pending_.size(); i++)
+		pending_[i]->setCanceled();
+	pending_.clear();
+	doneCV_.broadcast();
+	mutex_.unlock();
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void FileReadQueue::enqueue(const nctl::SharedPtr<FileReadRequest> &request)
+{
+	ASSERT(request);
+
+	mutex_.lock();
+	pending_.pushBack(request);
+	queueCV_.signal();
+	mutex_.unlock();
+}
+
+void FileReadQueue::wait(const FileReadRequest &request)
+{
+	mutex_.lock();
+	while (request.isDone() == false)
+		doneCV_.wait(mutex_);
+	mutex_.unlock();
+}
+
+void FileReadQueue::notifyDone()
+{
+	mutex_.lock();
+	doneCV_.broadcast();
+	mutex_.unlock();
+}
+
+///////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////
+
+void FileReadQueue::ioThreadFunction(void *arg)
+{
+	FileReadQueue *queue = static_cast<FileReadQueue *>(arg);
+	nctl::Array<nctl::SharedPtr<FileReadRequest>> batch(16);
+
+	LOGD_X("I/O thread %u is starting", Thread::self());
+
+	while (true)
+	{
+		queue->mutex_.lock();
+		while (queue->pending_.isEmpty() && queue->shouldQuit_ == false)
+			queue->queueCV_.wait(queue->mutex_);
+
+		if (queue->shouldQuit_)
+		{
+			queue->mutex_.unlock();
+			break;
+		}
+
+		// All the pending requests are taken at once, to sort them before reading
+		batch.swap(batch, queue->pending_);
+		queue->mutex_.unlock();
+
+		if (batch.size() > 1)
+			nctl::quicksort(batch.begin(), batch.end(), isBeforeInFile);
+
+		for (unsigned int i = 0; i < batch.size(); i++)
+		{
+			if (batch[i]->execute())
+				queue->notifyDone();
+		}
+		batch.clear();
+	}
+
+	LOGD_X("I/O thread %u is exiting", Thread::self());
+}
+
+FileReadQueue &theFileReadQueue()
+{
+	static FileReadQueue instance;
+	return instance;
+}
+
+}
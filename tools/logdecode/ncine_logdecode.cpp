@@ -0,0 +1,183 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include <nctl/Array.h>
+#include <nctl/UniquePtr.h>
+#include <ncine/IFile.h>
+#include <ncine/BinaryLog.h>
+
+namespace nc = ncine;
+
+namespace {
+
+/// A format string defined by a format record
+struct Format
+{
+	const char *string;
+	unsigned int length;
+};
+
+/// Maximum length of a decoded log entry
+const unsigned int MaxEntryLength = 1024;
+
+void printUsage(const char *programName)
+{
+	printf("Usage: %s <binary log> [output file]\n", programName);
+	printf("Decodes a binary log written by the nCine file logger into a text log\n");
+}
+
+bool readFile(const char *path, nctl::UniquePtr<unsigned char[]> &buffer, unsigned long int &size)
+{
+	nctl::UniquePtr<nc::IFile> fileHandle = nc::IFile::createFileHandle(path);
+	fileHandle->open(nc::IFile::OpenMode::READ | nc::IFile::OpenMode::BINARY);
+	if (fileHandle->isOpened() == false)
+		return false;
+
+	size = fileHandle->size();
+	buffer = nctl::makeUnique<unsigned char[]>(size);
+	return (fileHandle->read(buffer.get(), size) == size);
+}
+
+/// Collects the format records, which might follow the first entry using them when more threads were logging
+bool readFormats(const unsigned char *data, unsigned long int size, nctl::Array<Format> &formats)
+{
+	unsigned long int offset = nc::BinaryLog::HeaderSize;
+	while (offset < size)
+	{
+		const nc::BinaryLog::RecordType type = static_cast<nc::BinaryLog::RecordType>(data[offset]);
+		if (type == nc::BinaryLog::RecordType::FORMAT && offset + nc::BinaryLog::FormatRecordSize <= size)
+		{
+			uint32_t formatId = 0;
+			uint16_t formatLength = 0;
+			nc::BinaryLog::readFormatRecord(data + offset + 1, formatId, formatLength);
+			offset += nc::BinaryLog::FormatRecordSize;
+			// Identifiers come from the file and are bounded before growing the array
+			if (offset + formatLength > size || formatId >= nc::BinaryLog::MaxFormats)
+				return false;
+
+			while (formats.size() <= formatId)
+				formats.pushBack({ nullptr, 0 });
+			formats[formatId].string = reinterpret_cast<const char *>(data + offset);
+			formats[formatId].length = formatLength;
+			offset += formatLength;
+		}
+		else if (type == nc::BinaryLog::RecordType::ENTRY && offset + nc::BinaryLog::EntryRecordSize <= size)
+		{
+			nc::BinaryLog::Entry entry;
+			nc::BinaryLog::readEntryRecord(data + offset + 1, entry);
+			offset += nc::BinaryLog::EntryRecordSize + entry.argsSize;
+		}
+		else
+			return false;
+	}
+
+	return (offset == size);
+}
+
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 2 || argc > 3)
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	nctl::UniquePtr<unsigned char[]> data;
+	unsigned long int size = 0;
+	if (readFile(argv[1], data, size) == false)
+	{
+		printf("Cannot read \"%s\"\n", argv[1]);
+		return EXIT_FAILURE;
+	}
+
+	nc::BinaryLog::Header header;
+	if (size < nc::BinaryLog::HeaderSize)
+	{
+		printf("\"%s\" is not a binary log\n", argv[1]);
+		return EXIT_FAILURE;
+	}
+	nc::BinaryLog::readHeader(data.get(), header);
+	if (memcmp(header.magic, nc::BinaryLog::Magic, sizeof(header.magic)) != 0)
+	{
+		printf("\"%s\" is not a binary log\n", argv[1]);
+		return EXIT_FAILURE;
+	}
+	if (header.version != nc::BinaryLog::Version)
+	{
+		printf("Unsupported binary log version %u\n", header.version);
+		return EXIT_FAILURE;
+	}
+
+	nctl::Array<Format> formats;
+	if (readFormats(data.get(), size, formats) == false)
+		printf("The binary log is truncated or corrupted, decoding the complete records only\n");
+
+	FILE *output = stdout;
+	if (argc == 3)
+	{
+		output = fopen(argv[2], "w");
+		if (output == nullptr)
+		{
+			printf("Cannot open \"%s\" for writing\n", argv[2]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	// Format strings are null terminated in a copy, as they are not in the file
+	nctl::Array<char> formatString;
+	char entryText[MaxEntryLength];
+	unsigned int numEntries = 0;
+	unsigned long int offset = nc::BinaryLog::HeaderSize;
+	while (offset < size)
+	{
+		const nc::BinaryLog::RecordType type = static_cast<nc::BinaryLog::RecordType>(data[offset]);
+		if (type == nc::BinaryLog::RecordType::FORMAT && offset + nc::BinaryLog::FormatRecordSize <= size)
+		{
+			uint32_t formatId = 0;
+			uint16_t formatLength = 0;
+			nc::BinaryLog::readFormatRecord(data.get() + offset + 1, formatId, formatLength);
+			offset += nc::BinaryLog::FormatRecordSize + formatLength;
+			continue;
+		}
+		else if (type != nc::BinaryLog::RecordType::ENTRY || offset + nc::BinaryLog::EntryRecordSize > size)
+			break;
+
+		nc::BinaryLog::Entry entry;
+		nc::BinaryLog::readEntryRecord(data.get() + offset + 1, entry);
+		offset += nc::BinaryLog::EntryRecordSize;
+		if (offset + entry.argsSize > size)
+			break;
+		const unsigned char *args = data.get() + offset;
+		offset += entry.argsSize;
+
+		const time_t entryTime = static_cast<time_t>(entry.time);
+		char timeText[32];
+		strftime(timeText, sizeof(timeText), "- %H:%M:%S ", localtime(&entryTime));
+
+		if (entry.formatId < formats.size() && formats[entry.formatId].string != nullptr)
+		{
+			const Format &format = formats[entry.formatId];
+			formatString.clear();
+			formatString.insertRange(0, format.string, format.string + format.length);
+			formatString.pushBack('\0');
+			nc::BinaryLog::formatArgs(entryText, MaxEntryLength, formatString.data(), args, entry.argsSize);
+		}
+		else
+			snprintf(entryText, MaxEntryLength, "<unknown format %u>", entry.formatId);
+
+		fprintf(output, "%s[L%d] - %s\n", timeText, static_cast<int>(entry.level), entryText);
+		numEntries++;
+	}
+
+	if (output != stdout)
+	{
+		fclose(output);
+		printf("Decoded %u entries into \"%s\"\n", numEntries, argv[2]);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,217 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <nctl/Array.h>
+#include <nctl/String.h>
+#include <nctl/UniquePtr.h>
+#include <nctl/algorithms.h>
+#include <ncine/FileSystem.h>
+#include <ncine/IFile.h>
+#include <ncine/AssetArchive.h>
+
+namespace nc = ncine;
+
+namespace {
+
+/// A file to be added to the archive
+struct InputFile
+{
+	/// Path on disk
+	nctl::String path;
+	/// Path relative to the archive root, always with forward slashes
+	nctl::String name;
+	nc::AssetArchive::Entry entry;
+};
+
+/// Entries are compressed only if they save at least this fraction of their size
+const float MinCompressionSaving = 0.1f;
+
+bool isLessByHash(const InputFile &a, const InputFile &b)
+{
+	return a.entry.pathHash < b.entry.pathHash;
+}
+
+void printUsage(const char *programName)
+{
+	printf("Usage: %s [options] <input directory> <output archive>\n", programName);
+	printf("Packs all the files of a directory into an nCine asset archive\n\n");
+	printf("Options:\n");
+	printf("  --compress        Compress the entries that shrink by at least %d%%\n", static_cast<int>(MinCompressionSaving * 100));
+}
+
+void collectFiles(const char *dirPath, const nctl::String &prefix, nctl::Array<InputFile> &files)
+{
+	nc::fs::Directory dir(dirPath);
+	const char *entryName = dir.readNext();
+	while (entryName)
+	{
+		if (strcmp(entryName, ".") != 0 && strcmp(entryName, "..") != 0)
+		{
+			const nctl::String entryPath = nc::fs::joinPath(dirPath, entryName);
+			nctl::String name(nc::fs::MaxPathLength);
+			if (prefix.isEmpty() == false)
+				name.format("%s/%s", prefix.data(), entryName);
+			else
+				name = entryName;
+
+			if (nc::fs::isDirectory(entryPath.data()))
+				collectFiles(entryPath.data(), name, files);
+			else if (nc::fs::isFile(entryPath.data()))
+			{
+				if (nc::fs::fileSize(entryPath.data()) > 0)
+				{
+					files.emplaceBack();
+					files.back().path = entryPath;
+					files.back().name = name;
+				}
+				else
+					printf("Skipping empty file \"%s\"\n", entryPath.data());
+			}
+		}
+		entryName = dir.readNext();
+	}
+}
+
+bool readFile(const char *path, nctl::UniquePtr<unsigned char[]> &buffer, unsigned long int &size)
+{
+	nctl::UniquePtr<nc::IFile> fileHandle = nc::IFile::createFileHandle(path);
+	fileHandle->open(nc::IFile::OpenMode::READ | nc::IFile::OpenMode::BINARY);
+	if (fileHandle->isOpened() == false)
+		return false;
+
+	size = fileHandle->size();
+	buffer = nctl::makeUnique<unsigned char[]>(size);
+	return (fileHandle->read(buffer.get(), size) == size);
+}
+
+bool writePadding(nc::IFile &fileHandle, unsigned long int &offset)
+{
+	static const unsigned char zeros[nc::AssetArchive::DataAlignment] = {};
+	const unsigned long int padding = (nc::AssetArchive::DataAlignment - offset % nc::AssetArchive::DataAlignment) % nc::AssetArchive::DataAlignment;
+	offset += padding;
+	return (padding == 0 || fileHandle.write(zeros, padding) == padding);
+}
+
+}
+
+int main(int argc, char **argv)
+{
+	bool withCompression = false;
+	const char *inputDir = nullptr;
+	const char *outputFile = nullptr;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--compress") == 0)
+			withCompression = true;
+		else if (argv[i][0] == '-')
+		{
+			printUsage(argv[0]);
+			return EXIT_FAILURE;
+		}
+		else if (inputDir == nullptr)
+			inputDir = argv[i];
+		else if (outputFile == nullptr)
+			outputFile = argv[i];
+	}
+
+	if (inputDir == nullptr || outputFile == nullptr || nc::fs::isDirectory(inputDir) == false)
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	nctl::Array<InputFile> files;
+	collectFiles(inputDir, nctl::String(), files);
+	if (files.isEmpty())
+	{
+		printf("No files found in \"%s\"\n", inputDir);
+		return EXIT_FAILURE;
+	}
+
+	nctl::UniquePtr<nc::IFile> archiveHandle = nc::IFile::createFileHandle(outputFile);
+	archiveHandle->open(nc::IFile::OpenMode::WRITE | nc::IFile::OpenMode::BINARY);
+	if (archiveHandle->isOpened() == false)
+	{
+		printf("Cannot open \"%s\" for writing\n", outputFile);
+		return EXIT_FAILURE;
+	}
+
+	// The header is written again at the end, when the offsets are known
+	nc::AssetArchive::Header header = {};
+	memcpy(header.magic, nc::AssetArchive::Magic, sizeof(header.magic));
+	archiveHandle->write(&header, sizeof(header));
+	unsigned long int offset = sizeof(header);
+
+	unsigned long int totalSize = 0;
+	unsigned long int totalStoredSize = 0;
+	nctl::Array<char> names;
+	for (unsigned int i = 0; i < files.size(); i++)
+	{
+		InputFile &file = files[i];
+		nctl::UniquePtr<unsigned char[]> data;
+		unsigned long int size = 0;
+		if (readFile(file.path.data(), data, size) == false)
+		{
+			printf("Cannot read \"%s\"\n", file.path.data());
+			return EXIT_FAILURE;
+		}
+
+		const unsigned char *storedData = data.get();
+		unsigned long int storedSize = size;
+		nctl::UniquePtr<unsigned char[]> compressedData;
+		if (withCompression)
+		{
+			const unsigned long int maxCompressedSize = static_cast<unsigned long int>(size * (1.0f - MinCompressionSaving));
+			compressedData = nctl::makeUnique<unsigned char[]>(maxCompressedSize + 1);
+			const unsigned long int compressedSize = nc::AssetArchive::compressBlock(data.get(), size, compressedData.get(), maxCompressedSize);
+			if (compressedSize > 0)
+			{
+				storedData = compressedData.get();
+				storedSize = compressedSize;
+			}
+		}
+
+		writePadding(*archiveHandle, offset);
+		if (archiveHandle->write(storedData, storedSize) != storedSize)
+		{
+			printf("Cannot write \"%s\" to the archive\n", file.name.data());
+			return EXIT_FAILURE;
+		}
+
+		file.entry.pathHash = nc::AssetArchive::hashPath(file.name.data(), file.name.length());
+		file.entry.dataOffset = offset;
+		file.entry.size = size;
+		file.entry.compressedSize = (storedData != data.get()) ? storedSize : 0;
+		file.entry.nameOffset = names.size();
+		file.entry.nameLength = file.name.length();
+
+		offset += storedSize;
+		names.insertRange(names.size(), file.name.data(), file.name.data() + file.name.length());
+		totalSize += size;
+		totalStoredSize += storedSize;
+		printf("%s: %lu bytes%s\n", file.name.data(), storedSize, file.entry.compressedSize ? " (compressed)" : "");
+	}
+
+	nctl::quicksort(files.begin(), files.end(), isLessByHash);
+
+	writePadding(*archiveHandle, offset);
+	header.indexOffset = offset;
+	for (unsigned int i = 0; i < files.size(); i++)
+		archiveHandle->write(&files[i].entry, sizeof(nc::AssetArchive::Entry));
+	offset += files.size() * sizeof(nc::AssetArchive::Entry);
+
+	header.namesOffset = offset;
+	header.namesSize = names.size();
+	archiveHandle->write(names.data(), names.size());
+
+	header.version = nc::AssetArchive::Version;
+	header.numEntries = files.size();
+	archiveHandle->seek(0, SEEK_SET);
+	archiveHandle->write(&header, sizeof(header));
+	archiveHandle->close();
+
+	printf("Packed %u files in \"%s\": %lu bytes stored out of %lu\n", files.size(), outputFile, totalStoredSize, totalSize);
+	return EXIT_SUCCESS;
+}
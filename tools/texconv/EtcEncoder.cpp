@@ -0,0 +1,331 @@
+#include "EtcEncoder.h"
+
+namespace ncine {
+
+namespace {
+
+	/// Intensity modifier tables for ETC1 and ETC2 color blocks
+	const int ColorModifiers[8][2] = {
+		{ 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 }
+	};
+
+	/// Modifier tables for EAC alpha blocks
+	const int AlphaModifiers[16][8] = {
+		{ -3, -6, -9, -15, 2, 5, 8, 14 },
+		{ -3, -7, -10, -13, 2, 6, 9, 12 },
+		{ -2, -5, -8, -13, 1, 4, 7, 12 },
+		{ -2, -4, -6, -13, 1, 3, 5, 12 },
+		{ -3, -6, -8, -12, 2, 5, 7, 11 },
+		{ -3, -7, -9, -11, 2, 6, 8, 10 },
+		{ -4, -7, -8, -11, 3, 6, 7, 10 },
+		{ -3, -5, -8, -11, 2, 4, 7, 10 },
+		{ -2, -6, -8, -10, 1, 5, 7, 9 },
+		{ -2, -5, -8, -10, 1, 4, 7, 9 },
+		{ -2, -4, -8, -10, 1, 3, 7, 9 },
+		{ -2, -5, -7, -10, 1, 4, 6, 9 },
+		{ -3, -4, -7, -10, 2, 3, 6, 9 },
+		{ -1, -2, -3, -10, 0, 1, 2, 9 },
+		{ -4, -6, -8, -9, 3, 5, 7, 8 },
+		{ -3, -5, -7, -9, 2, 4, 6, 8 }
+	};
+
+	inline int clamp255(int value)
+	{
+		return (value < 0) ? 0 : (value > 255 ? 255 : value);
+	}
+
+	inline int expand4(int value) { return (value << 4) | value; }
+	inline int expand5(int value) { return (value << 3) | (value >> 2); }
+
+	/// The result of encoding the pixels of a sub-block with a base color
+	struct SubBlock
+	{
+		int table;
+		unsigned int error;
+		/// Modifier indices for the eight pixels of the sub-block
+		int indices[8];
+	};
+
+	/// Returns the block pixel index, in column-major order, of the n-th pixel of a sub-block
+	inline int subBlockPixel(int subBlock, int n, bool flip)
+	{
+		// Non flipped sub-blocks are 2x4 side by side, flipped ones are 4x2 on top of each other
+		const int x = flip ? (n % 4) : (subBlock * 2 + n / 4);
+		const int y = flip ? (subBlock * 2 + n / 4) : (n % 4);
+		return x * 4 + y;
+	}
+
+	void averageColor(const uint8_t *block, int subBlock, bool flip, float avg[3])
+	{
+		int sum[3] = { 0, 0, 0 };
+		for (int n = 0; n < 8; n++)
+		{
+			const int pixel = subBlockPixel(subBlock, n, flip);
+			// Input pixels are stored in row-major order
+			const uint8_t *rgba = block + ((pixel % 4) * 4 + pixel / 4) * 4;
+			for (int c = 0; c < 3; c++)
+				sum[c] += rgba[c];
+		}
+		for (int c = 0; c < 3; c++)
+			avg[c] = sum[c] / 8.0f;
+	}
+
+	SubBlock encodeSubBlock(const uint8_t *block, int subBlock, bool flip, const int baseColor[3])
+	{
+		SubBlock best;
+		best.table = 0;
+		best.error = ~0u;
+
+		for (int table = 0; table < 8; table++)
+		{
+			SubBlock current;
+			current.table = table;
+			current.error = 0;
+
+			const int modifiers[4] = { ColorModifiers[table][0], ColorModifiers[table][1], -ColorModifiers[table][0], -ColorModifiers[table][1] };
+			for (int n = 0; n < 8; n++)
+			{
+				const int pixel = subBlockPixel(subBlock, n, flip);
+				const uint8_t *rgba = block + ((pixel % 4) * 4 + pixel / 4) * 4;
+
+				unsigned int bestPixelError = ~0u;
+				for (int m = 0; m < 4; m++)
+				{
+					unsigned int pixelError = 0;
+					for (int c = 0; c < 3; c++)
+					{
+						const int diff = clamp255(baseColor[c] + modifiers[m]) - rgba[c];
+						pixelError += diff * diff;
+					}
+					if (pixelError < bestPixelError)
+					{
+						bestPixelError = pixelError;
+						current.indices[n] = m;
+					}
+				}
+				current.error += bestPixelError;
+			}
+
+			if (current.error < best.error)
+				best = current;
+		}
+
+		return best;
+	}
+
+	void writeBigEndian(uint8_t *output, uint64_t bits)
+	{
+		for (int i = 0; i < 8; i++)
+			output[i] = static_cast<uint8_t>(bits >> (56 - i * 8));
+	}
+
+}
+
+///////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////
+
+unsigned long EtcEncoder::encodedSize(int width, int height, bool withAlpha)
+{
+	const unsigned long numBlocks = static_cast<unsigned long>((width + 3) / 4) * ((height + 3) / 4);
+	return numBlocks * (withAlpha ? RgbaBlockSize : RgbBlockSize);
+}
+
+void EtcEncoder::encodeImage(const uint8_t *rgba, int width, int height, bool withAlpha, uint8_t *output)
+{
+	uint8_t block[16 * 4];
+
+	for (int blockY = 0; blockY < height; blockY += 4)
+	{
+		for (int blockX = 0; blockX < width; blockX += 4)
+		{
+			// Partial blocks on the borders replicate the last row and column
+			for (int y = 0; y < 4; y++)
+			{
+				const int srcY = (blockY + y < height) ? blockY + y : height - 1;
+				for (int x = 0; x < 4; x++)
+				{
+					const int srcX = (blockX + x < width) ? blockX + x : width - 1;
+					const uint8_t *src = rgba + (srcY * width + srcX) * 4;
+					for (int c = 0; c < 4; c++)
+						block[(y * 4 + x) * 4 + c] = src[c];
+				}
+			}
+
+			if (withAlpha)
+			{
+				encodeAlphaBlock(block, output);
+				output += 8;
+			}
+			encodeColorBlock(block, output);
+			output += 8;
+		}
+	}
+}
+
+void EtcEncoder::encodeColorBlock(const uint8_t *block, uint8_t *output)
+{
+	unsigned int bestError = ~0u;
+	uint32_t bestHigh = 0;
+	uint32_t bestLow = 0;
+
+	for (int flipIndex = 0; flipIndex < 2; flipIndex++)
+	{
+		const bool flip = (flipIndex == 1);
+		float avg[2][3];
+		averageColor(block, 0, flip, avg[0]);
+		averageColor(block, 1, flip, avg[1]);
+
+		// The individual mode is always available, the differential one only when the colors are close enough
+		for (int differential = 0; differential < 2; differential++)
+		{
+			int quantized[2][3];
+			int baseColors[2][3];
+			bool canEncode = true;
+
+			for (int c = 0; c < 3; c++)
+			{
+				for (int s = 0; s < 2; s++)
+				{
+					const float maxValue = differential ? 31.0f : 15.0f;
+					quantized[s][c] = static_cast<int>(avg[s][c] * maxValue / 255.0f + 0.5f);
+					baseColors[s][c] = differential ? expand5(quantized[s][c]) : expand4(quantized[s][c]);
+				}
+
+				const int delta = quantized[1][c] - quantized[0][c];
+				if (differential && (delta < -4 || delta > 3))
+					canEncode = false;
+			}
+
+			if (canEncode == false)
+				continue;
+
+			const SubBlock subBlocks[2] = { encodeSubBlock(block, 0, flip, baseColors[0]),
+				                            encodeSubBlock(block, 1, flip, baseColors[1]) };
+			const unsigned int error = subBlocks[0].error + subBlocks[1].error;
+			if (error >= bestError)
+				continue;
+
+			uint32_t high = 0;
+			for (int c = 0; c < 3; c++)
+			{
+				const int shift = 24 - c * 8;
+				if (differential)
+				{
+					const int delta = quantized[1][c] - quantized[0][c];
+					high |= static_cast<uint32_t>((quantized[0][c] << 3) | (delta & 0x7)) << shift;
+				}
+				else
+					high |= static_cast<uint32_t>((quantized[0][c] << 4) | quantized[1][c]) << shift;
+			}
+			high |= (subBlocks[0].table << 5) | (subBlocks[1].table << 2) | (differential << 1) | flipIndex;
+
+			uint32_t low = 0;
+			for (int s = 0; s < 2; s++)
+			{
+				for (int n = 0; n < 8; n++)
+				{
+					const int pixel = subBlockPixel(s, n, flip);
+					const int index = subBlocks[s].indices[n];
+					// Most significant bits of the modifier indices are stored in the upper half
+					low |= static_cast<uint32_t>(index >> 1) << (16 + pixel);
+					low |= static_cast<uint32_t>(index & 1) << pixel;
+				}
+			}
+
+			bestError = error;
+			bestHigh = high;
+			bestLow = low;
+		}
+	}
+
+	writeBigEndian(output, (static_cast<uint64_t>(bestHigh) << 32) | bestLow);
+}
+
+void EtcEncoder::encodeAlphaBlock(const uint8_t *block, uint8_t *output)
+{
+	// Alpha values in column-major order, the one used by the block pixel indices
+	int alpha[16];
+	int minAlpha = 255;
+	int maxAlpha = 0;
+	for (int x = 0; x < 4; x++)
+	{
+		for (int y = 0; y < 4; y++)
+		{
+			const int value = block[(y * 4 + x) * 4 + 3];
+			alpha[x * 4 + y] = value;
+			minAlpha = (value < minAlpha) ? value : minAlpha;
+			maxAlpha = (value > maxAlpha) ? value : maxAlpha;
+		}
+	}
+
+	int bestBase = minAlpha;
+	int bestMultiplier = 1;
+	int bestTable = 13; // the only table with a zero modifier
+	int bestIndices[16];
+	for (int i = 0; i < 16; i++)
+		bestIndices[i] = 4;
+
+	if (minAlpha != maxAlpha)
+	{
+		unsigned int bestError = ~0u;
+		for (int table = 0; table < 16; table++)
+		{
+			const int *modifiers = AlphaModifiers[table];
+			const int tableRange = modifiers[7] - modifiers[3];
+			const int center = (modifiers[7] + modifiers[3]);
+
+			// Only the multipliers and base values closer to the ideal ones are tried
+			const int idealMultiplier = ((maxAlpha - minAlpha) + tableRange / 2) / tableRange;
+			for (int multiplier = idealMultiplier - 1; multiplier <= idealMultiplier + 1; multiplier++)
+			{
+				if (multiplier < 1 || multiplier > 15)
+					continue;
+
+				const int idealBase = clamp255((maxAlpha + minAlpha - center * multiplier) / 2);
+				for (int base = idealBase - 1; base <= idealBase + 1; base++)
+				{
+					if (base < 0 || base > 255)
+						continue;
+
+					unsigned int error = 0;
+					int indices[16];
+					for (int i = 0; i < 16 && error < bestError; i++)
+					{
+						unsigned int bestPixelError = ~0u;
+						for (int m = 0; m < 8; m++)
+						{
+							const int diff = clamp255(base + modifiers[m] * multiplier) - alpha[i];
+							const unsigned int pixelError = diff * diff;
+							if (pixelError < bestPixelError)
+							{
+								bestPixelError = pixelError;
+								indices[i] = m;
+							}
+						}
+						error += bestPixelError;
+					}
+
+					if (error < bestError)
+					{
+						bestError = error;
+						bestBase = base;
+						bestMultiplier = multiplier;
+						bestTable = table;
+						for (int i = 0; i < 16; i++)
+							bestIndices[i] = indices[i];
+					}
+				}
+			}
+		}
+	}
+
+	uint64_t bits = (static_cast<uint64_t>(bestBase) << 56) | (static_cast<uint64_t>(bestMultiplier) << 52) | (static_cast<uint64_t>(bestTable) << 48);
+	// The 48 bits of indices start from bit 47 with the first pixel
+	for (int i = 0; i < 16; i++)
+		bits |= static_cast<uint64_t>(bestIndices[i]) << (45 - i * 3);
+
+	writeBigEndian(output, bits);
+}
+
+}
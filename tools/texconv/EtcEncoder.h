@@ -0,0 +1,33 @@
+#ifndef CLASS_NCINE_ETCENCODER
+#define CLASS_NCINE_ETCENCODER
+
+#include <cstdint>
+
+namespace ncine {
+
+/// A simple ETC2 encoder for the texture converter tool
+/*! Color blocks are always encoded in the individual or differential modes,
+ *  which are shared by ETC1 and ETC2, while alpha blocks use the EAC format. */
+class EtcEncoder
+{
+  public:
+	/// The size in bytes of an RGB8 ETC2 block
+	static const unsigned int RgbBlockSize = 8;
+	/// The size in bytes of an RGBA8 ETC2 EAC block
+	static const unsigned int RgbaBlockSize = 16;
+
+	/// Returns the size in bytes of an encoded image with the specified size
+	static unsigned long encodedSize(int width, int height, bool withAlpha);
+
+	/// Encodes an RGBA image into ETC2 blocks, either RGB8 or RGBA8 with EAC alpha
+	static void encodeImage(const uint8_t *rgba, int width, int height, bool withAlpha, uint8_t *output);
+
+	/// Encodes a 4x4 block of RGBA pixels, in row-major order, into an RGB8 ETC2 block
+	static void encodeColorBlock(const uint8_t *block, uint8_t *output);
+	/// Encodes the alpha channel of a 4x4 block of RGBA pixels, in row-major order, into an EAC block
+	static void encodeAlphaBlock(const uint8_t *block, uint8_t *output);
+};
+
+}
+
+#endif
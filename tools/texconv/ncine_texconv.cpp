@@ -0,0 +1,391 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <png.h>
+#include <ncine/config.h>
+#if NCINE_WITH_WEBP
+	#include <webp/decode.h>
+#endif
+
+#include <nctl/Array.h>
+#include <nctl/String.h>
+#include <nctl/UniquePtr.h>
+#include <nctl/Atomic.h>
+#include <ncine/FileSystem.h>
+#include "Thread.h"
+#include "EtcEncoder.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const unsigned int GL_RGB = 0x1907;
+const unsigned int GL_RGBA = 0x1908;
+const unsigned int GL_COMPRESSED_RGB8_ETC2 = 0x9274;
+const unsigned int GL_COMPRESSED_RGBA8_ETC2_EAC = 0x9278;
+
+const uint8_t KtxIdentifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+struct Options
+{
+	Options()
+	    : outputDir(nc::fs::MaxPathLength), withMipMaps(true), premultiplyAlpha(false), numThreads(0) {}
+
+	nctl::String outputDir;
+	bool withMipMaps;
+	bool premultiplyAlpha;
+	unsigned int numThreads;
+};
+
+struct Image
+{
+	Image()
+	    : width(0), height(0) {}
+
+	int width;
+	int height;
+	nctl::UniquePtr<uint8_t[]> pixels;
+};
+
+bool isSupportedFile(const char *filename)
+{
+#if NCINE_WITH_WEBP
+	if (nc::fs::hasExtension(filename, "webp"))
+		return true;
+#endif
+	return nc::fs::hasExtension(filename, "png");
+}
+
+bool loadPng(const char *filename, Image &image)
+{
+	png_image pngImage;
+	memset(&pngImage, 0, sizeof(png_image));
+	pngImage.version = PNG_IMAGE_VERSION;
+
+	if (png_image_begin_read_from_file(&pngImage, filename) == 0)
+		return false;
+
+	pngImage.format = PNG_FORMAT_RGBA;
+	image.width = pngImage.width;
+	image.height = pngImage.height;
+	image.pixels = nctl::makeUnique<uint8_t[]>(PNG_IMAGE_SIZE(pngImage));
+
+	if (png_image_finish_read(&pngImage, nullptr, image.pixels.get(), 0, nullptr) == 0)
+	{
+		png_image_free(&pngImage);
+		return false;
+	}
+
+	return true;
+}
+
+#if NCINE_WITH_WEBP
+bool loadWebP(const char *filename, Image &image)
+{
+	FILE *fp = fopen(filename, "rb");
+	if (fp == nullptr)
+		return false;
+
+	fseek(fp, 0, SEEK_END);
+	const long int fileSize = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	nctl::UniquePtr<uint8_t[]> fileBuffer = nctl::makeUnique<uint8_t[]>(fileSize);
+	const size_t bytesRead = fread(fileBuffer.get(), 1, fileSize, fp);
+	fclose(fp);
+
+	if (bytesRead != static_cast<size_t>(fileSize) ||
+	    WebPGetInfo(fileBuffer.get(), fileSize, &image.width, &image.height) == 0)
+	{
+		return false;
+	}
+
+	const unsigned long dataSize = static_cast<unsigned long>(image.width) * image.height * 4;
+	image.pixels = nctl::makeUnique<uint8_t[]>(dataSize);
+	return (WebPDecodeRGBAInto(fileBuffer.get(), fileSize, image.pixels.get(), dataSize, image.width * 4) != nullptr);
+}
+#endif
+
+bool loadImage(const char *filename, Image &image)
+{
+#if NCINE_WITH_WEBP
+	if (nc::fs::hasExtension(filename, "webp"))
+		return loadWebP(filename, image);
+#endif
+	return loadPng(filename, image);
+}
+
+bool hasTransparency(const Image &image)
+{
+	const unsigned long numPixels = static_cast<unsigned long>(image.width) * image.height;
+	for (unsigned long i = 0; i < numPixels; i++)
+	{
+		if (image.pixels[i * 4 + 3] < 255)
+			return true;
+	}
+	return false;
+}
+
+void premultiplyAlpha(Image &image)
+{
+	const unsigned long numPixels = static_cast<unsigned long>(image.width) * image.height;
+	for (unsigned long i = 0; i < numPixels; i++)
+	{
+		uint8_t *pixel = &image.pixels[i * 4];
+		for (unsigned int c = 0; c < 3; c++)
+			pixel[c] = static_cast<uint8_t>((pixel[c] * pixel[3] + 127) / 255);
+	}
+}
+
+float srgbToLinear(uint8_t value)
+{
+	const float v = value / 255.0f;
+	return (v <= 0.04045f) ? v / 12.92f : powf((v + 0.055f) / 1.055f, 2.4f);
+}
+
+uint8_t linearToSrgb(float value)
+{
+	const float v = (value <= 0.0031308f) ? value * 12.92f : 1.055f * powf(value, 1.0f / 2.4f) - 0.055f;
+	return static_cast<uint8_t>(v * 255.0f + 0.5f);
+}
+
+/// Creates the next MIP level with a 2x2 box filter, averaging color channels in linear space
+void downsample(const Image &src, Image &dest)
+{
+	dest.width = src.width / 2;
+	dest.height = src.height / 2;
+	dest.pixels = nctl::makeUnique<uint8_t[]>(static_cast<unsigned long>(dest.width) * dest.height * 4);
+
+	for (int y = 0; y < dest.height; y++)
+	{
+		for (int x = 0; x < dest.width; x++)
+		{
+			const uint8_t *p00 = &src.pixels[((2 * y) * src.width + 2 * x) * 4];
+			const uint8_t *p01 = p00 + 4;
+			const uint8_t *p10 = p00 + src.width * 4;
+			const uint8_t *p11 = p10 + 4;
+			uint8_t *out = &dest.pixels[(y * dest.width + x) * 4];
+
+			for (unsigned int c = 0; c < 3; c++)
+			{
+				const float linear = (srgbToLinear(p00[c]) + srgbToLinear(p01[c]) + srgbToLinear(p10[c]) + srgbToLinear(p11[c])) * 0.25f;
+				out[c] = linearToSrgb(linear);
+			}
+			out[3] = static_cast<uint8_t>((p00[3] + p01[3] + p10[3] + p11[3] + 2) >> 2);
+		}
+	}
+}
+
+bool isPowerOfTwo(int value)
+{
+	return (value > 0 && (value & (value - 1)) == 0);
+}
+
+void writeUint32(FILE *fp, uint32_t value)
+{
+	// KTX files are written with the endianness of the machine, specified in the header
+	fwrite(&value, sizeof(uint32_t), 1, fp);
+}
+
+bool convertFile(const char *inputFile, const char *outputFile, const Options &options)
+{
+	Image image;
+	if (loadImage(inputFile, image) == false)
+	{
+		printf("Cannot decode \"%s\"\n", inputFile);
+		return false;
+	}
+
+	const bool withAlpha = hasTransparency(image);
+	if (withAlpha && options.premultiplyAlpha)
+		premultiplyAlpha(image);
+
+	// The engine halves both dimensions of each level, so the chain stops when the smaller one reaches a single pixel
+	int numLevels = 1;
+	if (options.withMipMaps)
+	{
+		if (isPowerOfTwo(image.width) && isPowerOfTwo(image.height))
+		{
+			const int minSize = (image.width < image.height) ? image.width : image.height;
+			while ((minSize >> numLevels) > 0)
+				numLevels++;
+		}
+		else
+			printf("Skipping MIP maps for \"%s\" as its size is not a power of two (%dx%d)\n", inputFile, image.width, image.height);
+	}
+
+	FILE *fp = fopen(outputFile, "wb");
+	if (fp == nullptr)
+	{
+		printf("Cannot open \"%s\" for writing\n", outputFile);
+		return false;
+	}
+
+	fwrite(KtxIdentifier, sizeof(KtxIdentifier), 1, fp);
+	writeUint32(fp, 0x04030201); // endianness
+	writeUint32(fp, 0); // glType
+	writeUint32(fp, 1); // glTypeSize
+	writeUint32(fp, 0); // glFormat
+	writeUint32(fp, withAlpha ? GL_COMPRESSED_RGBA8_ETC2_EAC : GL_COMPRESSED_RGB8_ETC2); // glInternalFormat
+	writeUint32(fp, withAlpha ? GL_RGBA : GL_RGB); // glBaseInternalFormat
+	writeUint32(fp, image.width);
+	writeUint32(fp, image.height);
+	writeUint32(fp, 0); // pixelDepth
+	writeUint32(fp, 0); // numberOfArrayElements
+	writeUint32(fp, 1); // numberOfFaces
+	writeUint32(fp, numLevels);
+	writeUint32(fp, 0); // bytesOfKeyValueData
+
+	unsigned long totalSize = 0;
+	for (int level = 0; level < numLevels; level++)
+	{
+		if (level > 0)
+		{
+			Image nextLevel;
+			downsample(image, nextLevel);
+			image = nctl::move(nextLevel);
+		}
+
+		const unsigned long levelSize = nc::EtcEncoder::encodedSize(image.width, image.height, withAlpha);
+		nctl::UniquePtr<uint8_t[]> levelData = nctl::makeUnique<uint8_t[]>(levelSize);
+		nc::EtcEncoder::encodeImage(image.pixels.get(), image.width, image.height, withAlpha, levelData.get());
+
+		// Block sizes are multiples of four bytes, so no padding is needed
+		writeUint32(fp, static_cast<uint32_t>(levelSize));
+		fwrite(levelData.get(), 1, levelSize, fp);
+		totalSize += levelSize;
+	}
+
+	fclose(fp);
+	printf("Converted \"%s\" to \"%s\" (%s, %d levels, %lu bytes)\n", inputFile, outputFile, withAlpha ? "RGBA8 ETC2 EAC" : "RGB8 ETC2", numLevels, totalSize);
+	return true;
+}
+
+struct Job
+{
+	nctl::String inputFile;
+	nctl::String outputFile;
+};
+
+struct WorkerData
+{
+	const nctl::Array<Job> *jobs;
+	const Options *options;
+	nctl::Atomic32 nextJob;
+	nctl::Atomic32 numFailed;
+};
+
+void workerFunction(void *arg)
+{
+	WorkerData *data = static_cast<WorkerData *>(arg);
+	while (true)
+	{
+		const int32_t jobIndex = data->nextJob.fetchAdd(1);
+		if (jobIndex >= static_cast<int32_t>(data->jobs->size()))
+			break;
+
+		const Job &job = (*data->jobs)[jobIndex];
+		if (convertFile(job.inputFile.data(), job.outputFile.data(), *data->options) == false)
+			data->numFailed.fetchAdd(1);
+	}
+}
+
+void addJob(nctl::Array<Job> &jobs, const char *inputFile, const Options &options)
+{
+	Job job;
+	job.inputFile = inputFile;
+	job.outputFile = options.outputDir.isEmpty() ? job.inputFile : nc::fs::joinPath(options.outputDir, nc::fs::baseName(inputFile));
+	nc::fs::fixExtension(job.outputFile, "ktx");
+	jobs.pushBack(nctl::move(job));
+}
+
+void printUsage(const char *programName)
+{
+	printf("Usage: %s [options] <files or directories>\n", programName);
+	printf("Converts PNG%s images to ETC2 compressed KTX textures\n\n", NCINE_WITH_WEBP ? " and WebP" : "");
+	printf("Options:\n");
+	printf("  -o <dir>          Output directory (default is the input file directory)\n");
+	printf("  -j <threads>      Number of worker threads (default is the number of cores)\n");
+	printf("  --no-mipmaps      Don't generate the MIP map chain\n");
+	printf("  --premultiply     Premultiply color channels by alpha\n");
+}
+
+}
+
+int main(int argc, char **argv)
+{
+	Options options;
+	nctl::Array<Job> jobs;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+			options.outputDir = argv[++i];
+		else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+			options.numThreads = static_cast<unsigned int>(atoi(argv[++i]));
+		else if (strcmp(argv[i], "--no-mipmaps") == 0)
+			options.withMipMaps = false;
+		else if (strcmp(argv[i], "--premultiply") == 0)
+			options.premultiplyAlpha = true;
+		else if (argv[i][0] == '-')
+		{
+			printUsage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	// Input files are collected in a second pass, after the output directory is known
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "-j") == 0)
+			i++;
+		else if (argv[i][0] == '-')
+			continue;
+		else if (nc::fs::isDirectory(argv[i]))
+		{
+			nc::fs::Directory dir(argv[i]);
+			const char *entryName = dir.readNext();
+			while (entryName)
+			{
+				const nctl::String entryPath = nc::fs::joinPath(argv[i], entryName);
+				if (nc::fs::isFile(entryPath.data()) && isSupportedFile(entryName))
+					addJob(jobs, entryPath.data(), options);
+				entryName = dir.readNext();
+			}
+		}
+		else if (isSupportedFile(argv[i]))
+			addJob(jobs, argv[i], options);
+		else
+			printf("Skipping unsupported file \"%s\"\n", argv[i]);
+	}
+
+	if (jobs.isEmpty())
+	{
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (options.outputDir.isEmpty() == false && nc::fs::isDirectory(options.outputDir.data()) == false)
+		nc::fs::createDir(options.outputDir.data());
+
+	unsigned int numThreads = (options.numThreads > 0) ? options.numThreads : nc::Thread::numProcessors();
+	if (numThreads == 0)
+		numThreads = 1;
+	if (numThreads > jobs.size())
+		numThreads = jobs.size();
+
+	WorkerData workerData;
+	workerData.jobs = &jobs;
+	workerData.options = &options;
+
+	nctl::Array<nc::Thread> threads(numThreads);
+	for (unsigned int i = 0; i < numThreads; i++)
+		threads.emplaceBack(workerFunction, &workerData);
+	for (unsigned int i = 0; i < numThreads; i++)
+		threads[i].join();
+
+	const int32_t numFailed = workerData.numFailed.load();
+	printf("Converted %u files with %u threads, %d failed\n", jobs.size() - numFailed, numThreads, numFailed);
+
+	return (numFailed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -3,6 +3,57 @@
 
 namespace {
 
+const unsigned int BigCapacity = 16384;
+
+struct KeyIndex
+{
+	int key;
+	unsigned int index;
+};
+
+bool isLessKey(const KeyIndex &a, const KeyIndex &b)
+{
+	return a.key < b.key;
+}
+
+unsigned int keyOf(const KeyIndex &element)
+{
+	return static_cast<unsigned int>(element.key);
+}
+
+void initArrayKeyIndex(nctl::Array<KeyIndex> &array, unsigned int size, unsigned int maxKey)
+{
+	for (unsigned int i = 0; i < size; i++)
+		array.pushBack({ static_cast<int>(nc::random().integer(0, maxKey)), i });
+}
+
+/// Returns true if elements with the same key are still in their original relative order
+bool isStable(const nctl::Array<KeyIndex> &array)
+{
+	for (unsigned int i = 1; i < array.size(); i++)
+	{
+		if (array[i].key == array[i - 1].key && array[i].index < array[i - 1].index)
+			return false;
+	}
+
+	return true;
+}
+
+/// Returns true if the two arrays contain the same elements in the same order
+bool isEqual(const nctl::Array<int> &first, const nctl::Array<int> &second)
+{
+	if (first.size() != second.size())
+		return false;
+
+	for (unsigned int i = 0; i < first.size(); i++)
+	{
+		if (first[i] != second[i])
+			return false;
+	}
+
+	return true;
+}
+
 class ArraySortTest : public ::testing::Test
 {
   public:
@@ -326,4 +377,235 @@ TEST_F(ArraySortTest, IntrospectiveSortArrayHalfSorted)
 	ASSERT_EQ(isSorted(array), true);
 }
 
+TEST_F(ArraySortTest, IntrospectiveSortArrayFewUniqueValues)
+{
+	nctl::Array<int> array(BigCapacity);
+
+	printf("Filling the array with few unique values\n");
+	for (unsigned int i = 0; i < BigCapacity; i++)
+		array.pushBack(nc::random().integer(0, 4));
+	nctl::Array<int> reference(array);
+
+	printf("Sorting the array with introspective sort\n");
+	nctl::sort(array.begin(), array.end());
+	nctl::heapsort(reference.begin(), reference.end());
+	const bool sorted = nctl::isSorted(array.begin(), array.end());
+	printf("The array is %s\n", sorted ? "sorted" : "not sorted");
+
+	ASSERT_EQ(sorted, true);
+	ASSERT_TRUE(isEqual(array, reference));
+}
+
+TEST_F(ArraySortTest, IntrospectiveSortArrayOrganPipe)
+{
+	nctl::Array<int> array(BigCapacity);
+
+	printf("Filling the array with ascending and then descending numbers\n");
+	for (unsigned int i = 0; i < BigCapacity / 2; i++)
+		array.pushBack(i);
+	for (unsigned int i = BigCapacity / 2; i > 0; i--)
+		array.pushBack(i - 1);
+
+	printf("Sorting the array with introspective sort\n");
+	nctl::sort(array.begin(), array.end());
+	const bool sorted = nctl::isSorted(array.begin(), array.end());
+	printf("The array is %s\n", sorted ? "sorted" : "not sorted");
+
+	ASSERT_EQ(sorted, true);
+	for (unsigned int i = 0; i < BigCapacity; i++)
+		ASSERT_EQ(array[i], static_cast<int>(i / 2));
+}
+
+TEST_F(ArraySortTest, IntrospectiveSortArraySawtooth)
+{
+	const unsigned int ToothSize = 100;
+	nctl::Array<int> array(BigCapacity);
+
+	printf("Filling the array with ascending runs that restart from zero\n");
+	for (unsigned int i = 0; i < BigCapacity; i++)
+		array.pushBack(i % ToothSize);
+	nctl::Array<int> reference(array);
+
+	printf("Sorting the array with introspective sort\n");
+	nctl::sort(array.begin(), array.end());
+	nctl::heapsort(reference.begin(), reference.end());
+	const bool sorted = nctl::isSorted(array.begin(), array.end());
+	printf("The array is %s\n", sorted ? "sorted" : "not sorted");
+
+	ASSERT_EQ(sorted, true);
+	ASSERT_TRUE(isEqual(array, reference));
+}
+
+TEST_F(ArraySortTest, ReverseIntrospectiveSortArray)
+{
+	nctl::Array<int> array(BigCapacity);
+
+	printf("Filling the array with random numbers\n");
+	for (unsigned int i = 0; i < BigCapacity; i++)
+		array.pushBack(nc::random().integer(0, 10000));
+
+	printf("Reverse sorting the array with introspective sort\n");
+	nctl::sortDesc(array.begin(), array.end());
+	const bool reverseSorted = nctl::isSorted(array.begin(), array.end(), nctl::IsGreater<int>);
+	printf("The array is %s\n", reverseSorted ? "reverse sorted" : "not reverse sorted");
+
+	ASSERT_EQ(reverseSorted, true);
+}
+
+TEST_F(ArraySortTest, QuickSortArrayRepeatedValue)
+{
+	nctl::Array<int> array(BigCapacity);
+
+	const int RepeatedValue = 42;
+	printf("Filling the array with a repeated number\n");
+	for (unsigned int i = 0; i < BigCapacity; i++)
+		array.pushBack(RepeatedValue);
+
+	printf("Sorting the array with quicksort\n");
+	nctl::quicksort(array.begin(), array.end());
+	const bool sorted = nctl::isSorted(array.begin(), array.end());
+	printf("The array is %s\n", sorted ? "sorted" : "not sorted");
+
+	ASSERT_EQ(sorted, true);
+}
+
+TEST_F(ArraySortTest, StableSort)
+{
+	printf("Filling the array with random numbers\n");
+	array_.clear();
+	initArrayRandom(array_);
+	printArray(array_);
+
+	printf("Sorting the array with stable sort\n");
+	nctl::stableSort(array_.begin(), array_.end());
+	printArray(array_);
+	const bool sorted = nctl::isSorted(array_.begin(), array_.end());
+	printf("The array is %s\n", sorted ? "sorted" : "not sorted");
+
+	ASSERT_EQ(sorted, true);
+	ASSERT_EQ(isSorted(array_), true);
+}
+
+TEST_F(ArraySortTest, ReverseStableSort)
+{
+	nctl::Array<int> array(BigCapacity);
+
+	printf("Filling the array with random numbers\n");
+	for (unsigned int i = 0; i < BigCapacity; i++)
+		array.pushBack(nc::random().integer(0, 10000));
+
+	printf("Reverse sorting the array with stable sort\n");
+	nctl::stableSortDesc(array.begin(), array.end());
+	const bool reverseSorted = nctl::isSorted(array.begin(), array.end(), nctl::IsGreater<int>);
+	printf("The array is %s\n", reverseSorted ? "reverse sorted" : "not reverse sorted");
+
+	ASSERT_EQ(reverseSorted, true);
+}
+
+TEST_F(ArraySortTest, StableSortIsStable)
+{
+	nctl::Array<KeyIndex> array(BigCapacity);
+
+	printf("Filling the array with random keys and their original index\n");
+	initArrayKeyIndex(array, BigCapacity, 100);
+
+	printf("Sorting the array with stable sort\n");
+	nctl::stableSort(array.begin(), array.end(), isLessKey);
+	const bool sorted = nctl::isSorted(array.begin(), array.end(), isLessKey);
+	const bool stable = isStable(array);
+	printf("The array is %s and %s\n", sorted ? "sorted" : "not sorted", stable ? "stable" : "not stable");
+
+	ASSERT_EQ(sorted, true);
+	ASSERT_EQ(stable, true);
+}
+
+TEST_F(ArraySortTest, RadixSort)
+{
+	printf("Filling the array with random numbers\n");
+	array_.clear();
+	initArrayRandom(array_);
+	printArray(array_);
+
+	printf("Sorting the array with radix sort\n");
+	nctl::radixSort(array_.begin(), array_.end());
+	printArray(array_);
+	const bool sorted = nctl::isSorted(array_.begin(), array_.end());
+	printf("The array is %s\n", sorted ? "sorted" : "not sorted");
+
+	ASSERT_EQ(sorted, true);
+	ASSERT_EQ(isSorted(array_), true);
+}
+
+TEST_F(ArraySortTest, RadixSortNegativeNumbers)
+{
+	nctl::Array<int> array(BigCapacity);
+
+	printf("Filling the array with random positive and negative numbers\n");
+	for (unsigned int i = 0; i < BigCapacity; i++)
+		array.pushBack(static_cast<int>(nc::random().integer(0, 2000000)) - 1000000);
+	nctl::Array<int> reference(array);
+
+	printf("Sorting the array with radix sort\n");
+	nctl::radixSort(array.begin(), array.end());
+	nctl::sort(reference.begin(), reference.end());
+	const bool sorted = nctl::isSorted(array.begin(), array.end());
+	printf("The array is %s\n", sorted ? "sorted" : "not sorted");
+
+	ASSERT_EQ(sorted, true);
+	ASSERT_TRUE(isEqual(array, reference));
+}
+
+TEST_F(ArraySortTest, RadixSortSigned8)
+{
+	nctl::Array<int8_t> array(BigCapacity);
+
+	printf("Filling the array with random 8 bits signed numbers\n");
+	for (unsigned int i = 0; i < BigCapacity; i++)
+		array.pushBack(static_cast<int8_t>(static_cast<int>(nc::random().integer(0, 256)) - 128));
+	nctl::Array<int8_t> reference(array);
+
+	printf("Sorting the array with radix sort\n");
+	nctl::radixSort(array.begin(), array.end());
+	nctl::sort(reference.begin(), reference.end());
+	const bool sorted = nctl::isSorted(array.begin(), array.end());
+	printf("The array is %s\n", sorted ? "sorted" : "not sorted");
+
+	ASSERT_EQ(sorted, true);
+	for (unsigned int i = 0; i < BigCapacity; i++)
+		ASSERT_EQ(array[i], reference[i]);
+}
+
+TEST_F(ArraySortTest, RadixSortUnsigned64)
+{
+	nctl::Array<uint64_t> array(BigCapacity);
+
+	printf("Filling the array with random 64 bits numbers\n");
+	for (unsigned int i = 0; i < BigCapacity; i++)
+		array.pushBack((static_cast<uint64_t>(nc::random().integer()) << 32) | nc::random().integer());
+
+	printf("Sorting the array with radix sort\n");
+	nctl::radixSort(array.begin(), array.end());
+	const bool sorted = nctl::isSorted(array.begin(), array.end());
+	printf("The array is %s\n", sorted ? "sorted" : "not sorted");
+
+	ASSERT_EQ(sorted, true);
+}
+
+TEST_F(ArraySortTest, RadixSortWithKeyIsStable)
+{
+	nctl::Array<KeyIndex> array(BigCapacity);
+
+	printf("Filling the array with random keys and their original index\n");
+	initArrayKeyIndex(array, BigCapacity, 1000);
+
+	printf("Sorting the array with radix sort on the key\n");
+	nctl::radixSort(array.begin(), array.end(), keyOf);
+	const bool sorted = nctl::isSorted(array.begin(), array.end(), isLessKey);
+	const bool stable = isStable(array);
+	printf("The array is %s and %s\n", sorted ? "sorted" : "not sorted", stable ? "stable" : "not stable");
+
+	ASSERT_EQ(sorted, true);
+	ASSERT_EQ(stable, true);
+}
+
 }
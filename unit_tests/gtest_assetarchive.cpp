@@ -0,0 +1,253 @@
+#include <cstring>
+#include <ncine/AssetArchive.h>
+#include <ncine/IFile.h>
+#include <ncine/FileSystem.h>
+#include <nctl/UniquePtr.h>
+#include "gtest/gtest.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const char *Filename = "AssetArchiveTest.npak";
+const char *EntryName = "data/entry.bin";
+const char EntryData[] = "0123456789ABCDEF";
+const unsigned int EntrySize = sizeof(EntryData) - 1;
+const unsigned int DataOffset = 48;
+const unsigned int IndexOffset = DataOffset + EntrySize;
+const unsigned int NamesOffset = IndexOffset + sizeof(nc::AssetArchive::Entry);
+const unsigned long int BufferSize = 64 * 1024;
+/// The same limit as the compressor, under which a block is made of literals only
+const unsigned long int MatchStartLimit = 12;
+
+/// Fills a buffer with bytes from a linear congruential generator, which do not compress
+void fillRandom(unsigned char *buffer, unsigned long int size, uint32_t seed)
+{
+	for (unsigned long int i = 0; i < size; i++)
+	{
+		seed = seed * 1664525U + 1013904223U;
+		buffer[i] = static_cast<unsigned char>(seed >> 24);
+	}
+}
+
+/// Fills a buffer with repeated words and some noise
+void fillCompressible(unsigned char *buffer, unsigned long int size)
+{
+	const char *words[] = { "texture ", "shader ", "sprite ", "audio " };
+	unsigned long int offset = 0;
+	unsigned int index = 0;
+	while (offset < size)
+	{
+		const char *word = words[(index * 7 + index / 3) % 4];
+		for (unsigned int i = 0; word[i] != '\0' && offset < size; i++)
+			buffer[offset++] = static_cast<unsigned char>(word[i]);
+		if (offset < size && index % 5 == 0)
+			buffer[offset++] = static_cast<unsigned char>(index);
+		index++;
+	}
+}
+
+/// Compresses and decompresses a buffer, returns true if the result matches the source
+bool roundTrip(const unsigned char *src, unsigned long int size, unsigned long int &compressedSize)
+{
+	const unsigned long int bound = nc::AssetArchive::compressBound(size);
+	nctl::UniquePtr<unsigned char[]> compressed = nctl::makeUnique<unsigned char[]>(bound);
+	nctl::UniquePtr<unsigned char[]> decompressed = nctl::makeUnique<unsigned char[]>(size + 1);
+
+	compressedSize = nc::AssetArchive::compressBlock(src, size, compressed.get(), bound);
+	if (compressedSize == 0 || compressedSize > bound)
+		return false;
+
+	const unsigned long int decompressedSize = nc::AssetArchive::decompressBlock(compressed.get(), compressedSize, decompressed.get(), size);
+	return (decompressedSize == size && memcmp(src, decompressed.get(), size) == 0);
+}
+
+/// Writes an archive with a single stored entry, after giving the caller a chance to alter its header and index
+void writeArchive(void (*alter)(nc::AssetArchive::Header &, nc::AssetArchive::Entry &))
+{
+	nc::AssetArchive::Header header = {};
+	memcpy(header.magic, nc::AssetArchive::Magic, sizeof(header.magic));
+	header.version = nc::AssetArchive::Version;
+	header.numEntries = 1;
+	header.indexOffset = IndexOffset;
+	header.namesOffset = NamesOffset;
+	header.namesSize = strlen(EntryName);
+
+	nc::AssetArchive::Entry entry = {};
+	entry.pathHash = nc::AssetArchive::hashPath(EntryName, strlen(EntryName));
+	entry.dataOffset = DataOffset;
+	entry.size = EntrySize;
+	entry.nameOffset = 0;
+	entry.nameLength = strlen(EntryName);
+
+	if (alter)
+		alter(header, entry);
+
+	const unsigned char padding[DataOffset - sizeof(header)] = {};
+	nctl::UniquePtr<nc::IFile> file = nc::IFile::createFileHandle(Filename);
+	file->open(nc::IFile::OpenMode::WRITE | nc::IFile::OpenMode::BINARY);
+	file->write(&header, sizeof(header));
+	file->write(padding, sizeof(padding));
+	file->write(EntryData, EntrySize);
+	file->write(&entry, sizeof(entry));
+	file->write(EntryName, strlen(EntryName));
+	file->close();
+}
+
+class AssetArchiveTest : public ::testing::Test
+{
+  protected:
+	void TearDown() override { nc::fs::deleteFile(Filename); }
+};
+
+TEST_F(AssetArchiveTest, RoundTripCompressible)
+{
+	nctl::UniquePtr<unsigned char[]> buffer = nctl::makeUnique<unsigned char[]>(BufferSize);
+	fillCompressible(buffer.get(), BufferSize);
+
+	printf("Compressing and decompressing %lu bytes of repeated words\n", BufferSize);
+	unsigned long int compressedSize = 0;
+	ASSERT_TRUE(roundTrip(buffer.get(), BufferSize, compressedSize));
+	printf("Compressed size: %lu bytes\n", compressedSize);
+	ASSERT_LT(compressedSize, BufferSize / 2);
+}
+
+TEST_F(AssetArchiveTest, RoundTripIncompressible)
+{
+	nctl::UniquePtr<unsigned char[]> buffer = nctl::makeUnique<unsigned char[]>(BufferSize);
+	fillRandom(buffer.get(), BufferSize, 1);
+
+	printf("Compressing and decompressing %lu random bytes\n", BufferSize);
+	unsigned long int compressedSize = 0;
+	ASSERT_TRUE(roundTrip(buffer.get(), BufferSize, compressedSize));
+	printf("Compressed size: %lu bytes\n", compressedSize);
+	ASSERT_LE(compressedSize, nc::AssetArchive::compressBound(BufferSize));
+}
+
+TEST_F(AssetArchiveTest, RoundTripShortInputs)
+{
+	unsigned char buffer[MatchStartLimit + 1];
+	memset(buffer, 'a', sizeof(buffer));
+
+	printf("Compressing and decompressing inputs of up to %lu bytes, made of literals only\n", MatchStartLimit + 1);
+	for (unsigned long int size = 1; size <= MatchStartLimit + 1; size++)
+	{
+		unsigned long int compressedSize = 0;
+		ASSERT_TRUE(roundTrip(buffer, size, compressedSize));
+		ASSERT_EQ(compressedSize, size + 1);
+	}
+}
+
+TEST_F(AssetArchiveTest, RejectSmallDestination)
+{
+	unsigned char src[256];
+	fillRandom(src, sizeof(src), 2);
+	unsigned char dest[128];
+
+	printf("Compressing into a destination that is too small\n");
+	ASSERT_EQ(nc::AssetArchive::compressBlock(src, sizeof(src), dest, sizeof(dest)), 0u);
+}
+
+TEST_F(AssetArchiveTest, RejectTruncatedBlocks)
+{
+	const unsigned long int Size = 4096;
+	unsigned char src[Size];
+	fillCompressible(src, Size);
+	unsigned char compressed[Size * 2];
+	unsigned char dest[Size];
+	const unsigned long int compressedSize = nc::AssetArchive::compressBlock(src, Size, compressed, sizeof(compressed));
+	ASSERT_GT(compressedSize, 0u);
+
+	printf("Decompressing every truncation of a block of %lu bytes\n", compressedSize);
+	for (unsigned long int size = 0; size < compressedSize; size++)
+		ASSERT_NE(nc::AssetArchive::decompressBlock(compressed, size, dest, Size), Size);
+
+	printf("Decompressing into a destination that is too small\n");
+	ASSERT_EQ(nc::AssetArchive::decompressBlock(compressed, compressedSize, dest, Size - 1), 0u);
+}
+
+TEST_F(AssetArchiveTest, RejectInvalidOffsets)
+{
+	unsigned char dest[64];
+
+	printf("Decompressing a match with an offset of zero\n");
+	const unsigned char zeroOffset[] = { 0x10, 'a', 0x00, 0x00, 0x00 };
+	ASSERT_EQ(nc::AssetArchive::decompressBlock(zeroOffset, sizeof(zeroOffset), dest, sizeof(dest)), 0u);
+
+	printf("Decompressing a match that starts before the destination\n");
+	const unsigned char pastStart[] = { 0x10, 'a', 0x02, 0x00, 0x00 };
+	ASSERT_EQ(nc::AssetArchive::decompressBlock(pastStart, sizeof(pastStart), dest, sizeof(dest)), 0u);
+
+	printf("Decompressing a valid match that repeats the last literal\n");
+	const unsigned char valid[] = { 0x10, 'a', 0x01, 0x00, 0x00 };
+	ASSERT_EQ(nc::AssetArchive::decompressBlock(valid, sizeof(valid), dest, sizeof(dest)), 5u);
+	ASSERT_EQ(memcmp(dest, "aaaaa", 5), 0);
+}
+
+TEST_F(AssetArchiveTest, RejectLiteralsPastEnd)
+{
+	unsigned char dest[64];
+
+	printf("Decompressing literals that go past the end of the block\n");
+	const unsigned char missingLiterals[] = { 0x50, 'a', 'b' };
+	ASSERT_EQ(nc::AssetArchive::decompressBlock(missingLiterals, sizeof(missingLiterals), dest, sizeof(dest)), 0u);
+
+	printf("Decompressing a literal length whose extra bytes are missing\n");
+	const unsigned char missingLength[] = { 0xF0, 0xFF };
+	ASSERT_EQ(nc::AssetArchive::decompressBlock(missingLength, sizeof(missingLength), dest, sizeof(dest)), 0u);
+}
+
+TEST_F(AssetArchiveTest, OpenAndRead)
+{
+	writeArchive(nullptr);
+
+	printf("Opening an archive with a single stored entry\n");
+	nc::AssetArchive archive(Filename);
+	ASSERT_TRUE(archive.isOpened());
+	ASSERT_EQ(archive.numEntries(), 1u);
+
+	const int index = archive.findEntry(EntryName);
+	ASSERT_EQ(index, 0);
+	ASSERT_EQ(archive.findEntry("data/missing.bin"), -1);
+
+	unsigned char buffer[EntrySize];
+	ASSERT_TRUE(archive.readEntry(index, buffer));
+	ASSERT_EQ(memcmp(buffer, EntryData, EntrySize), 0);
+}
+
+TEST_F(AssetArchiveTest, RejectWrappingIndexOffset)
+{
+	writeArchive([](nc::AssetArchive::Header &header, nc::AssetArchive::Entry &entry) {
+		// The end of the index wraps around to a small value inside the file
+		header.indexOffset = ~0ULL - 7;
+	});
+
+	printf("Opening an archive whose index offset wraps around\n");
+	nc::AssetArchive archive(Filename);
+	ASSERT_FALSE(archive.isOpened());
+}
+
+TEST_F(AssetArchiveTest, RejectWrappingNamesSize)
+{
+	writeArchive([](nc::AssetArchive::Header &header, nc::AssetArchive::Entry &entry) {
+		header.namesSize = ~0ULL - NamesOffset + 2;
+	});
+
+	printf("Opening an archive whose names size wraps around\n");
+	nc::AssetArchive archive(Filename);
+	ASSERT_FALSE(archive.isOpened());
+}
+
+TEST_F(AssetArchiveTest, RejectWrappingDataOffset)
+{
+	writeArchive([](nc::AssetArchive::Header &header, nc::AssetArchive::Entry &entry) {
+		// The end of the data wraps around to a small value inside the file
+		entry.dataOffset = ~0ULL - 7;
+	});
+
+	printf("Opening an archive with an entry whose data offset wraps around\n");
+	nc::AssetArchive archive(Filename);
+	ASSERT_FALSE(archive.isOpened());
+}
+
+}
@@ -0,0 +1,294 @@
+#include <cmath> // for `lrintf()`
+#include <ncine/AudioMixer.h>
+#include "gtest/gtest.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const int Frequency = 44100;
+const unsigned int MaxFramesPerMix = 64;
+const float Tolerance = 0.0001f;
+const float InvSqrt2 = 0.70710678f;
+
+/// A sink that keeps a copy of all the written frames
+class CaptureAudioSink : public nc::IAudioSink
+{
+  public:
+	CaptureAudioSink()
+	    : numFrames_(0) {}
+
+	bool write(const int16_t *frames, unsigned int numFrames) override
+	{
+		for (unsigned int i = 0; i < numFrames * 2; i++)
+			samples_.pushBack(frames[i]);
+		numFrames_ += numFrames;
+		return true;
+	}
+	unsigned long int numFrames() const override { return numFrames_; }
+	const nctl::Array<int16_t> &samples() const { return samples_; }
+
+  private:
+	unsigned long int numFrames_;
+	nctl::Array<int16_t> samples_;
+};
+
+const unsigned int NumMonoFrames = 11;
+// Full scale and half scale values, with an odd number of frames to exercise the vectorized loops and their tails
+const int16_t MonoSamples[NumMonoFrames] = { 0, 16384, -16384, 32767, -32768, 8192, -8192, 4096, -4096, 16384, -16384 };
+
+const unsigned int NumStereoFrames = 5;
+const int16_t StereoSamples[NumStereoFrames * 2] = { 16384, -16384, 8192, 8192, -8192, 4096, 0, 32767, -32768, 0 };
+
+float toFloat(int16_t sample)
+{
+	return sample / 32768.0f;
+}
+
+TEST(AudioMixerTest, MixMonoGains)
+{
+	const float input[NumMonoFrames] = { 0.0f, 0.5f, -0.5f, 1.0f, -1.0f, 0.25f, -0.25f, 0.125f, -0.125f, 0.5f, -0.5f };
+	float output[NumMonoFrames * 2];
+	for (unsigned int i = 0; i < NumMonoFrames * 2; i++)
+		output[i] = 0.1f;
+
+	printf("Adding mono samples to a stereo output with a different gain per channel\n");
+	nc::AudioMixer::mixMono(input, output, NumMonoFrames, 0.5f, 2.0f);
+
+	for (unsigned int i = 0; i < NumMonoFrames; i++)
+	{
+		ASSERT_NEAR(output[i * 2], 0.1f + input[i] * 0.5f, Tolerance);
+		ASSERT_NEAR(output[i * 2 + 1], 0.1f + input[i] * 2.0f, Tolerance);
+	}
+}
+
+TEST(AudioMixerTest, MixStereoGains)
+{
+	float input[NumStereoFrames * 2];
+	for (unsigned int i = 0; i < NumStereoFrames * 2; i++)
+		input[i] = toFloat(StereoSamples[i]);
+	float output[NumStereoFrames * 2];
+	for (unsigned int i = 0; i < NumStereoFrames * 2; i++)
+		output[i] = -0.1f;
+
+	printf("Adding stereo samples to a stereo output with a different gain per channel\n");
+	nc::AudioMixer::mixStereo(input, output, NumStereoFrames, 0.25f, 0.75f);
+
+	for (unsigned int i = 0; i < NumStereoFrames; i++)
+	{
+		ASSERT_NEAR(output[i * 2], -0.1f + input[i * 2] * 0.25f, Tolerance);
+		ASSERT_NEAR(output[i * 2 + 1], -0.1f + input[i * 2 + 1] * 0.75f, Tolerance);
+	}
+}
+
+TEST(AudioMixerTest, ConvertToInt16Clipping)
+{
+	const unsigned int NumSamples = 11;
+	const float input[NumSamples] = { 0.0f, 0.5f, -0.5f, 1.0f, -1.0f, 1.5f, -1.5f, 100.0f, -100.0f, 2.0f, -2.0f };
+	const int16_t expected[NumSamples] = { 0, 16384, -16384, 32767, -32767, 32767, -32767, 32767, -32767, 32767, -32767 };
+	int16_t output[NumSamples];
+
+	printf("Converting float samples to 16 bits, clipping the out of range ones\n");
+	nc::AudioMixer::convertToInt16(input, output, NumSamples);
+
+	for (unsigned int i = 0; i < NumSamples; i++)
+		ASSERT_EQ(output[i], expected[i]);
+}
+
+TEST(AudioMixerTest, AddAndRemoveVoices)
+{
+	nc::AudioMixer mixer(Frequency, MaxFramesPerMix);
+
+	printf("Adding and removing voices, handles of removed voices are reused\n");
+	ASSERT_EQ(mixer.addVoice(MonoSamples, NumMonoFrames, 3, Frequency), -1);
+	ASSERT_EQ(mixer.addVoice(MonoSamples, 0, 1, Frequency), -1);
+
+	const int first = mixer.addVoice(MonoSamples, NumMonoFrames, 1, Frequency);
+	const int second = mixer.addVoice(StereoSamples, NumStereoFrames, 2, Frequency);
+	ASSERT_NE(first, -1);
+	ASSERT_NE(second, -1);
+	ASSERT_NE(first, second);
+	ASSERT_EQ(mixer.numPlayingVoices(), 0u);
+
+	mixer.voice(first)->isPlaying = true;
+	ASSERT_EQ(mixer.numPlayingVoices(), 1u);
+
+	mixer.removeVoice(first);
+	ASSERT_EQ(mixer.voice(first), nullptr);
+	ASSERT_EQ(mixer.numPlayingVoices(), 0u);
+	ASSERT_EQ(mixer.addVoice(MonoSamples, NumMonoFrames, 1, Frequency), first);
+}
+
+TEST(AudioMixerTest, MixMonoVoicePanning)
+{
+	nc::AudioMixer mixer(Frequency, MaxFramesPerMix);
+	const int handle = mixer.addVoice(MonoSamples, NumMonoFrames, 1, Frequency);
+	nc::AudioMixer::Voice &voice = *mixer.voice(handle);
+	voice.isPlaying = true;
+	voice.gain = 0.5f;
+	float output[NumMonoFrames * 2];
+
+	printf("Mixing a mono voice panned to the center, to the left and to the right\n");
+	mixer.mix(output, NumMonoFrames);
+	for (unsigned int i = 0; i < NumMonoFrames; i++)
+	{
+		ASSERT_NEAR(output[i * 2], toFloat(MonoSamples[i]) * 0.5f * InvSqrt2, Tolerance);
+		ASSERT_NEAR(output[i * 2 + 1], toFloat(MonoSamples[i]) * 0.5f * InvSqrt2, Tolerance);
+	}
+
+	voice.isPlaying = true;
+	voice.position = 0.0;
+	voice.pan = -1.0f;
+	mixer.mix(output, NumMonoFrames);
+	for (unsigned int i = 0; i < NumMonoFrames; i++)
+	{
+		ASSERT_NEAR(output[i * 2], toFloat(MonoSamples[i]) * 0.5f, Tolerance);
+		ASSERT_NEAR(output[i * 2 + 1], 0.0f, Tolerance);
+	}
+
+	voice.isPlaying = true;
+	voice.position = 0.0;
+	voice.pan = 1.0f;
+	mixer.mix(output, NumMonoFrames);
+	for (unsigned int i = 0; i < NumMonoFrames; i++)
+	{
+		ASSERT_NEAR(output[i * 2], 0.0f, Tolerance);
+		ASSERT_NEAR(output[i * 2 + 1], toFloat(MonoSamples[i]) * 0.5f, Tolerance);
+	}
+}
+
+TEST(AudioMixerTest, MixStereoVoiceBalance)
+{
+	nc::AudioMixer mixer(Frequency, MaxFramesPerMix);
+	const int handle = mixer.addVoice(StereoSamples, NumStereoFrames, 2, Frequency);
+	nc::AudioMixer::Voice &voice = *mixer.voice(handle);
+	voice.isPlaying = true;
+	voice.gain = 0.8f;
+	voice.pan = 0.5f;
+	float output[NumStereoFrames * 2];
+
+	printf("Mixing a stereo voice balanced to the right\n");
+	mixer.mix(output, NumStereoFrames);
+
+	for (unsigned int i = 0; i < NumStereoFrames; i++)
+	{
+		ASSERT_NEAR(output[i * 2], toFloat(StereoSamples[i * 2]) * 0.8f * 0.5f, Tolerance);
+		ASSERT_NEAR(output[i * 2 + 1], toFloat(StereoSamples[i * 2 + 1]) * 0.8f, Tolerance);
+	}
+}
+
+TEST(AudioMixerTest, MixTwoVoices)
+{
+	nc::AudioMixer mixer(Frequency, MaxFramesPerMix);
+	const int first = mixer.addVoice(StereoSamples, NumStereoFrames, 2, Frequency);
+	const int second = mixer.addVoice(StereoSamples, NumStereoFrames, 2, Frequency);
+	mixer.voice(first)->isPlaying = true;
+	mixer.voice(first)->gain = 0.25f;
+	mixer.voice(second)->isPlaying = true;
+	mixer.voice(second)->gain = 0.5f;
+	float output[NumStereoFrames * 2];
+
+	printf("Mixing two stereo voices with different gains\n");
+	mixer.mix(output, NumStereoFrames);
+
+	for (unsigned int i = 0; i < NumStereoFrames * 2; i++)
+		ASSERT_NEAR(output[i], toFloat(StereoSamples[i]) * 0.75f, Tolerance);
+}
+
+TEST(AudioMixerTest, VoiceStopsAtEnd)
+{
+	nc::AudioMixer mixer(Frequency, MaxFramesPerMix);
+	const int handle = mixer.addVoice(StereoSamples, NumStereoFrames, 2, Frequency);
+	mixer.voice(handle)->isPlaying = true;
+	const unsigned int NumFrames = NumStereoFrames * 3;
+	float output[NumFrames * 2];
+
+	printf("Mixing a voice that is not looping past its end\n");
+	mixer.mix(output, NumFrames);
+
+	for (unsigned int i = 0; i < NumStereoFrames * 2; i++)
+		ASSERT_NEAR(output[i], toFloat(StereoSamples[i]), Tolerance);
+	for (unsigned int i = NumStereoFrames * 2; i < NumFrames * 2; i++)
+		ASSERT_EQ(output[i], 0.0f);
+	ASSERT_FALSE(mixer.voice(handle)->isPlaying);
+	ASSERT_EQ(mixer.voice(handle)->position, 0.0);
+}
+
+TEST(AudioMixerTest, VoiceLooping)
+{
+	nc::AudioMixer mixer(Frequency, MaxFramesPerMix);
+	const int handle = mixer.addVoice(StereoSamples, NumStereoFrames, 2, Frequency);
+	mixer.voice(handle)->isPlaying = true;
+	mixer.voice(handle)->isLooping = true;
+	const unsigned int NumFrames = NumStereoFrames * 3 + 2;
+	float output[NumFrames * 2];
+
+	printf("Mixing a looping voice past its end\n");
+	mixer.mix(output, NumFrames);
+
+	for (unsigned int i = 0; i < NumFrames * 2; i++)
+		ASSERT_NEAR(output[i], toFloat(StereoSamples[i % (NumStereoFrames * 2)]), Tolerance);
+	ASSERT_TRUE(mixer.voice(handle)->isPlaying);
+	ASSERT_EQ(mixer.voice(handle)->position, 2.0);
+}
+
+TEST(AudioMixerTest, ResampleHalfFrequency)
+{
+	nc::AudioMixer mixer(Frequency, MaxFramesPerMix);
+	const int handle = mixer.addVoice(MonoSamples, NumMonoFrames, 1, Frequency / 2);
+	mixer.voice(handle)->isPlaying = true;
+	mixer.voice(handle)->pan = -1.0f;
+	const unsigned int NumFrames = (NumMonoFrames - 1) * 2;
+	float output[NumFrames * 2];
+
+	printf("Mixing a voice at half the output frequency, interpolating between its samples\n");
+	mixer.mix(output, NumFrames);
+
+	for (unsigned int i = 0; i < NumFrames; i++)
+	{
+		const unsigned int frame = i / 2;
+		const float expected = (i % 2 == 0) ? toFloat(MonoSamples[frame])
+		                                    : (toFloat(MonoSamples[frame]) + toFloat(MonoSamples[frame + 1])) * 0.5f;
+		ASSERT_NEAR(output[i * 2], expected, Tolerance);
+	}
+}
+
+TEST(AudioMixerTest, RenderClipping)
+{
+	nc::AudioMixer mixer(Frequency, MaxFramesPerMix);
+	// Two full scale voices in phase exceed the valid range
+	const int first = mixer.addVoice(StereoSamples, NumStereoFrames, 2, Frequency);
+	const int second = mixer.addVoice(StereoSamples, NumStereoFrames, 2, Frequency);
+	mixer.voice(first)->isPlaying = true;
+	mixer.voice(second)->isPlaying = true;
+	mixer.voice(first)->gain = 2.0f;
+	CaptureAudioSink sink;
+
+	printf("Rendering two voices whose sum is clipped\n");
+	ASSERT_EQ(mixer.render(sink, NumStereoFrames), NumStereoFrames);
+	ASSERT_EQ(sink.numFrames(), NumStereoFrames);
+
+	for (unsigned int i = 0; i < NumStereoFrames * 2; i++)
+	{
+		const float sum = toFloat(StereoSamples[i]) * 3.0f;
+		const int16_t expected = (sum >= 1.0f) ? 32767 : ((sum <= -1.0f) ? -32767 : static_cast<int16_t>(lrintf(sum * 32767.0f)));
+		ASSERT_EQ(sink.samples()[i], expected);
+	}
+}
+
+TEST(AudioMixerTest, RenderInChunks)
+{
+	nc::AudioMixer mixer(Frequency, MaxFramesPerMix);
+	const int handle = mixer.addVoice(MonoSamples, NumMonoFrames, 1, Frequency);
+	mixer.voice(handle)->isPlaying = true;
+	mixer.voice(handle)->isLooping = true;
+	nc::NullAudioSink sink;
+	const unsigned long int NumFrames = MaxFramesPerMix * 3 + 5;
+
+	printf("Rendering more frames than the maximum mixed at once\n");
+	ASSERT_EQ(mixer.render(sink, NumFrames), NumFrames);
+	ASSERT_EQ(sink.numFrames(), NumFrames);
+	ASSERT_EQ(mixer.voice(handle)->position, static_cast<double>(NumFrames % NumMonoFrames));
+}
+
+}
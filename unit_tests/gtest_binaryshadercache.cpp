@@ -0,0 +1,283 @@
+#include <cstring>
+#include <ncine/ServiceLocator.h>
+#include <ncine/FileSystem.h>
+#include <ncine/IFile.h>
+#include "BinaryShaderCache.h"
+#include "gtest/gtest.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const char *DirectoryName = "BinaryShaderCacheTestDir";
+const uint32_t BinaryFormat = 0x8E8D;
+const uint64_t FirstHash = 0x0123456789ABCDEFULL;
+const uint64_t SecondHash = 0xFEDCBA9876543210ULL;
+const unsigned int BinarySize = 1000;
+
+/// A graphics capabilities class that only reports the support for binary shaders
+class TestGfxCapabilities : public nc::IGfxCapabilities
+{
+  public:
+	TestGfxCapabilities()
+	{
+		glInfoStrings_.vendor = reinterpret_cast<const unsigned char *>("Vendor");
+		glInfoStrings_.renderer = reinterpret_cast<const unsigned char *>("Renderer");
+		glInfoStrings_.glVersion = reinterpret_cast<const unsigned char *>("3.3");
+		glInfoStrings_.glslVersion = reinterpret_cast<const unsigned char *>("3.30");
+	}
+
+	int glVersion(GLVersion version) const override { return 3; }
+	const GlInfoStrings &glInfoStrings() const override { return glInfoStrings_; }
+	int value(GLIntValues::Enum valueName) const override { return (valueName == GLIntValues::NUM_PROGRAM_BINARY_FORMATS) ? 1 : 0; }
+	int arrayValue(GLArrayIntValues::Enum arrayValueName, unsigned int index) const override { return BinaryFormat; }
+	bool hasExtension(GLExtensions::Enum extensionName) const override { return (extensionName == GLExtensions::ARB_GET_PROGRAM_BINARY); }
+
+  private:
+	GlInfoStrings glInfoStrings_;
+};
+
+nctl::UniquePtr<nc::BinaryShaderCache> createCache()
+{
+	nctl::UniquePtr<nc::BinaryShaderCache> cache = nctl::makeUnique<nc::BinaryShaderCache>(false, DirectoryName);
+	cache->setDirectory(DirectoryName);
+	cache->setEnabled(true);
+	return cache;
+}
+
+void fillBinary(unsigned char *buffer, unsigned int size, unsigned char seed)
+{
+	for (unsigned int i = 0; i < size; i++)
+		buffer[i] = static_cast<unsigned char>(seed + i * 7);
+}
+
+bool hasBinary(nc::BinaryShaderCache &cache, uint64_t hash, unsigned char seed)
+{
+	if (cache.binarySize(hash) != BinarySize)
+		return false;
+
+	unsigned char expected[BinarySize];
+	fillBinary(expected, BinarySize, seed);
+	const void *data = cache.loadFromCache(hash);
+	return (data != nullptr && memcmp(data, expected, BinarySize) == 0);
+}
+
+void saveBinary(nc::BinaryShaderCache &cache, uint64_t hash, unsigned char seed)
+{
+	unsigned char buffer[BinarySize];
+	fillBinary(buffer, BinarySize, seed);
+	cache.saveToCache(BinarySize, buffer, hash);
+}
+
+nctl::String archivePath()
+{
+	return nc::fs::joinPath(DirectoryName, nc::BinaryShaderCache::ArchiveFilename);
+}
+
+void writeArchive(const unsigned char *buffer, unsigned long size)
+{
+	nctl::UniquePtr<nc::IFile> file = nc::IFile::createFileHandle(archivePath().data());
+	file->open(nc::IFile::OpenMode::WRITE);
+	file->write(buffer, size);
+	file->close();
+}
+
+unsigned int countTemporaryFiles()
+{
+	unsigned int numFiles = 0;
+	nc::fs::Directory dir(DirectoryName);
+	while (const char *entryName = dir.readNext())
+	{
+		if (nc::fs::hasExtension(entryName, "tmp"))
+			numFiles++;
+	}
+	return numFiles;
+}
+
+class BinaryShaderCacheTest : public ::testing::Test
+{
+  protected:
+	void SetUp() override
+	{
+		nc::theServiceLocator().registerGfxCapabilities(nctl::makeUnique<TestGfxCapabilities>());
+		// The cache is only available if the user cache directory exists
+		if (nc::fs::isDirectory(nc::fs::cachePath().data()) == false)
+			nc::fs::createDir(nc::fs::cachePath().data());
+		nc::fs::createDir(DirectoryName);
+	}
+
+	void TearDown() override
+	{
+		{
+			nc::fs::Directory dir(DirectoryName);
+			while (const char *entryName = dir.readNext())
+			{
+				const nctl::String filePath = nc::fs::joinPath(DirectoryName, entryName);
+				if (nc::fs::isFile(filePath.data()))
+					nc::fs::deleteFile(filePath.data());
+			}
+		}
+		nc::fs::deleteEmptyDir(DirectoryName);
+		nc::theServiceLocator().unregisterGfxCapabilities();
+	}
+};
+
+TEST_F(BinaryShaderCacheTest, SaveAndLoad)
+{
+	nctl::UniquePtr<nc::BinaryShaderCache> cache = createCache();
+	ASSERT_TRUE(cache->isEnabled());
+
+	printf("Saving a binary shader and loading it back in the same session\n");
+	saveBinary(*cache, FirstHash, 1);
+	ASSERT_TRUE(hasBinary(*cache, FirstHash, 1));
+	ASSERT_EQ(cache->binarySize(SecondHash), 0u);
+	ASSERT_EQ(cache->loadFromCache(SecondHash), nullptr);
+	ASSERT_EQ(cache->statistics().PlatformFilesCount, 1u);
+}
+
+TEST_F(BinaryShaderCacheTest, SaveAndReopen)
+{
+	const char introspection[] = "introspection";
+	{
+		nctl::UniquePtr<nc::BinaryShaderCache> cache = createCache();
+		saveBinary(*cache, FirstHash, 1);
+		saveBinary(*cache, SecondHash, 2);
+		cache->saveIntrospectionToCache(sizeof(introspection), introspection, FirstHash);
+	}
+
+	printf("Reading back the binary shaders from the archive written by another cache\n");
+	ASSERT_TRUE(nc::fs::isFile(archivePath().data()));
+	nctl::UniquePtr<nc::BinaryShaderCache> cache = createCache();
+	ASSERT_TRUE(hasBinary(*cache, FirstHash, 1));
+	ASSERT_TRUE(hasBinary(*cache, SecondHash, 2));
+	ASSERT_EQ(cache->statistics().PlatformFilesCount, 2u);
+
+	unsigned int length = 0;
+	const void *data = cache->loadIntrospectionFromCache(FirstHash, length);
+	ASSERT_EQ(length, sizeof(introspection));
+	ASSERT_EQ(memcmp(data, introspection, length), 0);
+	ASSERT_EQ(countTemporaryFiles(), 0u);
+}
+
+TEST_F(BinaryShaderCacheTest, RejectTruncatedArchive)
+{
+	{
+		nctl::UniquePtr<nc::BinaryShaderCache> cache = createCache();
+		saveBinary(*cache, FirstHash, 1);
+	}
+
+	const long int fileSize = nc::fs::fileSize(archivePath().data());
+	nctl::UniquePtr<unsigned char[]> buffer = nctl::makeUnique<unsigned char[]>(fileSize);
+	{
+		nctl::UniquePtr<nc::IFile> file = nc::IFile::createFileHandle(archivePath().data());
+		file->open(nc::IFile::OpenMode::READ);
+		file->read(buffer.get(), fileSize);
+		file->close();
+	}
+	writeArchive(buffer.get(), fileSize - BinarySize / 2);
+
+	printf("Opening an archive truncated in the middle of a binary shader\n");
+	nctl::UniquePtr<nc::BinaryShaderCache> cache = createCache();
+	ASSERT_EQ(cache->binarySize(FirstHash), 0u);
+	ASSERT_EQ(cache->loadFromCache(FirstHash), nullptr);
+	ASSERT_EQ(cache->statistics().TotalFilesCount, 0u);
+
+	saveBinary(*cache, SecondHash, 2);
+	ASSERT_TRUE(hasBinary(*cache, SecondHash, 2));
+}
+
+TEST_F(BinaryShaderCacheTest, RejectGarbageArchive)
+{
+	const unsigned int GarbageSize = 64 * 1024;
+	nctl::UniquePtr<unsigned char[]> buffer = nctl::makeUnique<unsigned char[]>(GarbageSize);
+	fillBinary(buffer.get(), GarbageSize, 3);
+	writeArchive(buffer.get(), GarbageSize);
+
+	printf("Opening an archive made of random bytes\n");
+	nctl::UniquePtr<nc::BinaryShaderCache> cache = createCache();
+	ASSERT_TRUE(cache->isEnabled());
+	ASSERT_EQ(cache->statistics().TotalFilesCount, 0u);
+	ASSERT_EQ(cache->loadFromCache(FirstHash), nullptr);
+}
+
+TEST_F(BinaryShaderCacheTest, RejectInvalidHeader)
+{
+	{
+		nctl::UniquePtr<nc::BinaryShaderCache> cache = createCache();
+		saveBinary(*cache, FirstHash, 1);
+	}
+
+	const long int fileSize = nc::fs::fileSize(archivePath().data());
+	nctl::UniquePtr<unsigned char[]> buffer = nctl::makeUnique<unsigned char[]>(fileSize);
+	{
+		nctl::UniquePtr<nc::IFile> file = nc::IFile::createFileHandle(archivePath().data());
+		file->open(nc::IFile::OpenMode::READ);
+		file->read(buffer.get(), fileSize);
+		file->close();
+	}
+	// Corrupting the magic number
+	buffer[0] ^= 0xFF;
+	writeArchive(buffer.get(), fileSize);
+
+	printf("Opening an archive with an invalid header\n");
+	nctl::UniquePtr<nc::BinaryShaderCache> cache = createCache();
+	ASSERT_EQ(cache->loadFromCache(FirstHash), nullptr);
+	ASSERT_EQ(cache->statistics().TotalFilesCount, 0u);
+}
+
+TEST_F(BinaryShaderCacheTest, TwoWritersSameArchive)
+{
+	printf("Two caches saving to the same archive at the same time\n");
+	nctl::UniquePtr<nc::BinaryShaderCache> firstCache = createCache();
+	nctl::UniquePtr<nc::BinaryShaderCache> secondCache = createCache();
+
+	saveBinary(*firstCache, FirstHash, 1);
+	saveBinary(*secondCache, SecondHash, 2);
+	// Each cache reads its own changes until it is closed
+	ASSERT_TRUE(hasBinary(*firstCache, FirstHash, 1));
+	ASSERT_EQ(secondCache->loadFromCache(FirstHash), nullptr);
+
+	firstCache.reset(nullptr);
+	secondCache.reset(nullptr);
+
+	// The archive is always complete and it contains the changes of the last cache closing it
+	nctl::UniquePtr<nc::BinaryShaderCache> cache = createCache();
+	ASSERT_TRUE(hasBinary(*cache, SecondHash, 2));
+	ASSERT_EQ(cache->statistics().TotalFilesCount, 1u);
+	ASSERT_EQ(countTemporaryFiles(), 0u);
+}
+
+TEST_F(BinaryShaderCacheTest, EvictAndReopen)
+{
+	const uint64_t ThirdHash = 0x1111111111111111ULL;
+	{
+		nctl::UniquePtr<nc::BinaryShaderCache> cache = createCache();
+		cache->setMaxSize(BinarySize * 5 / 2);
+		saveBinary(*cache, FirstHash, 1);
+		saveBinary(*cache, SecondHash, 2);
+		saveBinary(*cache, ThirdHash, 3);
+		ASSERT_GT(cache->statistics().EvictedShaders, 0u);
+		ASSERT_TRUE(hasBinary(*cache, ThirdHash, 3));
+	}
+
+	printf("Reading back an archive rewritten to evict the least recently used binary shaders\n");
+	nctl::UniquePtr<nc::BinaryShaderCache> cache = createCache();
+	ASSERT_EQ(cache->loadFromCache(FirstHash), nullptr);
+	ASSERT_TRUE(hasBinary(*cache, ThirdHash, 3));
+}
+
+TEST_F(BinaryShaderCacheTest, Clear)
+{
+	{
+		nctl::UniquePtr<nc::BinaryShaderCache> cache = createCache();
+		saveBinary(*cache, FirstHash, 1);
+	}
+
+	printf("Clearing the cache\n");
+	nctl::UniquePtr<nc::BinaryShaderCache> cache = createCache();
+	cache->clear();
+	ASSERT_EQ(cache->loadFromCache(FirstHash), nullptr);
+	ASSERT_FALSE(nc::fs::isFile(archivePath().data()));
+}
+
+}
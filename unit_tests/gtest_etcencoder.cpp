@@ -0,0 +1,347 @@
+#include <cstring>
+#include "EtcEncoder.h"
+#include "gtest/gtest.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const int BlockPixels = 16;
+const int BlockBytes = BlockPixels * 4;
+// Copied as `ASSERT_EQ()` takes its arguments by reference and the class constants have no definition
+const unsigned long RgbBlockSize = nc::EtcEncoder::RgbBlockSize;
+const unsigned long RgbaBlockSize = nc::EtcEncoder::RgbaBlockSize;
+
+/// Intensity modifier tables for color blocks, from the ETC2 specification
+const int ColorModifiers[8][2] = {
+	{ 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 }
+};
+
+/// Modifier tables for EAC alpha blocks, from the ETC2 specification
+const int AlphaModifiers[16][8] = {
+	{ -3, -6, -9, -15, 2, 5, 8, 14 },
+	{ -3, -7, -10, -13, 2, 6, 9, 12 },
+	{ -2, -5, -8, -13, 1, 4, 7, 12 },
+	{ -2, -4, -6, -13, 1, 3, 5, 12 },
+	{ -3, -6, -8, -12, 2, 5, 7, 11 },
+	{ -3, -7, -9, -11, 2, 6, 8, 10 },
+	{ -4, -7, -8, -11, 3, 6, 7, 10 },
+	{ -3, -5, -8, -11, 2, 4, 7, 10 },
+	{ -2, -6, -8, -10, 1, 5, 7, 9 },
+	{ -2, -5, -8, -10, 1, 4, 7, 9 },
+	{ -2, -4, -8, -10, 1, 3, 7, 9 },
+	{ -2, -5, -7, -10, 1, 4, 6, 9 },
+	{ -3, -4, -7, -10, 2, 3, 6, 9 },
+	{ -1, -2, -3, -10, 0, 1, 2, 9 },
+	{ -4, -6, -8, -9, 3, 5, 7, 8 },
+	{ -3, -5, -7, -9, 2, 4, 6, 8 }
+};
+
+int clamp255(int value)
+{
+	return (value < 0) ? 0 : (value > 255 ? 255 : value);
+}
+
+uint64_t readBigEndian(const uint8_t *input)
+{
+	uint64_t bits = 0;
+	for (int i = 0; i < 8; i++)
+		bits = (bits << 8) | input[i];
+	return bits;
+}
+
+int bits(uint64_t value, int first, int numBits)
+{
+	return static_cast<int>((value >> first) & ((1ULL << numBits) - 1));
+}
+
+bool isDifferential(const uint8_t *colorBlock)
+{
+	return (colorBlock[3] & 0x2) != 0;
+}
+
+/// Decodes the RGB channels of an individual or differential color block into row-major RGBA pixels
+/*! Returns false for the T, H and planar modes of ETC2, which the encoder should never produce */
+bool decodeColorBlock(const uint8_t *input, uint8_t *block)
+{
+	const uint64_t value = readBigEndian(input);
+	const bool differential = bits(value, 33, 1);
+	const bool flip = bits(value, 32, 1);
+
+	int baseColors[2][3];
+	for (int c = 0; c < 3; c++)
+	{
+		const int first = 59 - c * 8;
+		if (differential)
+		{
+			const int base = bits(value, first, 5);
+			const int delta = (bits(value, first - 3, 3) ^ 0x4) - 0x4;
+			if (base + delta < 0 || base + delta > 31)
+				return false;
+			baseColors[0][c] = (base << 3) | (base >> 2);
+			baseColors[1][c] = ((base + delta) << 3) | ((base + delta) >> 2);
+		}
+		else
+		{
+			baseColors[0][c] = bits(value, first + 1, 4) * 17;
+			baseColors[1][c] = bits(value, first - 3, 4) * 17;
+		}
+	}
+	const int tables[2] = { bits(value, 37, 3), bits(value, 34, 3) };
+
+	for (int x = 0; x < 4; x++)
+	{
+		for (int y = 0; y < 4; y++)
+		{
+			const int pixel = x * 4 + y;
+			const int subBlock = flip ? (y >= 2) : (x >= 2);
+			const int msb = bits(value, 16 + pixel, 1);
+			const int lsb = bits(value, pixel, 1);
+			const int magnitude = ColorModifiers[tables[subBlock]][lsb];
+			const int modifier = msb ? -magnitude : magnitude;
+			for (int c = 0; c < 3; c++)
+				block[(y * 4 + x) * 4 + c] = static_cast<uint8_t>(clamp255(baseColors[subBlock][c] + modifier));
+		}
+	}
+
+	return true;
+}
+
+/// Decodes an EAC block into the alpha channel of row-major RGBA pixels
+void decodeAlphaBlock(const uint8_t *input, uint8_t *block)
+{
+	const uint64_t value = readBigEndian(input);
+	const int base = bits(value, 56, 8);
+	const int multiplier = bits(value, 52, 4);
+	const int table = bits(value, 48, 4);
+
+	for (int x = 0; x < 4; x++)
+	{
+		for (int y = 0; y < 4; y++)
+		{
+			const int index = bits(value, 45 - (x * 4 + y) * 3, 3);
+			block[(y * 4 + x) * 4 + 3] = static_cast<uint8_t>(clamp255(base + AlphaModifiers[table][index] * multiplier));
+		}
+	}
+}
+
+/// Returns the largest difference of a channel between two blocks of pixels
+int maxChannelError(const uint8_t *a, const uint8_t *b, int firstChannel, int numChannels)
+{
+	int maxError = 0;
+	for (int i = 0; i < BlockPixels; i++)
+	{
+		for (int c = firstChannel; c < firstChannel + numChannels; c++)
+		{
+			const int error = (a[i * 4 + c] > b[i * 4 + c]) ? a[i * 4 + c] - b[i * 4 + c] : b[i * 4 + c] - a[i * 4 + c];
+			maxError = (error > maxError) ? error : maxError;
+		}
+	}
+	return maxError;
+}
+
+/// Encodes and decodes the colors of a block, returns the largest channel error or -1 if the block cannot be decoded
+int roundTripColor(const uint8_t *block, uint8_t *encoded)
+{
+	uint8_t decoded[BlockBytes];
+	memcpy(decoded, block, BlockBytes);
+	nc::EtcEncoder::encodeColorBlock(block, encoded);
+	if (decodeColorBlock(encoded, decoded) == false)
+		return -1;
+	return maxChannelError(block, decoded, 0, 3);
+}
+
+/// Encodes and decodes the alpha of a block, returns the largest alpha error
+int roundTripAlpha(const uint8_t *block)
+{
+	uint8_t encoded[8];
+	uint8_t decoded[BlockBytes];
+	memcpy(decoded, block, BlockBytes);
+	nc::EtcEncoder::encodeAlphaBlock(block, encoded);
+	decodeAlphaBlock(encoded, decoded);
+	return maxChannelError(block, decoded, 3, 1);
+}
+
+void fillSolid(uint8_t *block, uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+{
+	for (int i = 0; i < BlockPixels; i++)
+	{
+		block[i * 4 + 0] = r;
+		block[i * 4 + 1] = g;
+		block[i * 4 + 2] = b;
+		block[i * 4 + 3] = a;
+	}
+}
+
+TEST(EtcEncoderTest, EncodedSize)
+{
+	printf("Size of encoded images with and without alpha\n");
+	ASSERT_EQ(nc::EtcEncoder::encodedSize(4, 4, false), RgbBlockSize);
+	ASSERT_EQ(nc::EtcEncoder::encodedSize(4, 4, true), RgbaBlockSize);
+	ASSERT_EQ(nc::EtcEncoder::encodedSize(1, 1, false), RgbBlockSize);
+	ASSERT_EQ(nc::EtcEncoder::encodedSize(6, 5, true), 4 * RgbaBlockSize);
+	ASSERT_EQ(nc::EtcEncoder::encodedSize(64, 32, false), 16 * 8 * RgbBlockSize);
+}
+
+TEST(EtcEncoderTest, RoundTripSolidColors)
+{
+	const uint8_t colors[][3] = { { 0, 0, 0 }, { 255, 255, 255 }, { 128, 128, 128 }, { 200, 100, 50 }, { 17, 240, 99 } };
+
+	unsigned int numDifferential = 0;
+	for (unsigned int i = 0; i < sizeof(colors) / sizeof(colors[0]); i++)
+	{
+		uint8_t block[BlockBytes];
+		uint8_t encoded[8];
+		fillSolid(block, colors[i][0], colors[i][1], colors[i][2], 255);
+
+		const int error = roundTripColor(block, encoded);
+		printf("Solid color (%u, %u, %u), %s mode, maximum error: %d\n", colors[i][0], colors[i][1], colors[i][2],
+		       isDifferential(encoded) ? "differential" : "individual", error);
+		ASSERT_GE(error, 0);
+		ASSERT_LE(error, 4);
+		numDifferential += isDifferential(encoded) ? 1 : 0;
+	}
+	// The differential mode is only chosen when its better precision lowers the error
+	ASSERT_GT(numDifferential, 0u);
+}
+
+TEST(EtcEncoderTest, RoundTripDistantHalves)
+{
+	for (int flip = 0; flip < 2; flip++)
+	{
+		uint8_t block[BlockBytes];
+		uint8_t encoded[8];
+		for (int y = 0; y < 4; y++)
+		{
+			for (int x = 0; x < 4; x++)
+			{
+				const bool first = flip ? (y < 2) : (x < 2);
+				uint8_t *pixel = block + (y * 4 + x) * 4;
+				pixel[0] = first ? 238 : 17;
+				pixel[1] = first ? 34 : 51;
+				pixel[2] = first ? 17 : 221;
+				pixel[3] = 255;
+			}
+		}
+
+		const int error = roundTripColor(block, encoded);
+		printf("Red and blue %s halves, maximum error: %d\n", flip ? "top and bottom" : "left and right", error);
+		ASSERT_GE(error, 0);
+		ASSERT_LE(error, 8);
+		// The two colors are too far apart for the differential mode
+		ASSERT_FALSE(isDifferential(encoded));
+		ASSERT_EQ(encoded[3] & 0x1, flip);
+	}
+}
+
+TEST(EtcEncoderTest, RoundTripGradient)
+{
+	uint8_t block[BlockBytes];
+	uint8_t encoded[8];
+	for (int y = 0; y < 4; y++)
+	{
+		for (int x = 0; x < 4; x++)
+		{
+			uint8_t *pixel = block + (y * 4 + x) * 4;
+			pixel[0] = static_cast<uint8_t>(100 + x * 8 + y * 4);
+			pixel[1] = static_cast<uint8_t>(100 + x * 8 + y * 4);
+			pixel[2] = static_cast<uint8_t>(100 + x * 8 + y * 4);
+			pixel[3] = 255;
+		}
+	}
+
+	const int error = roundTripColor(block, encoded);
+	printf("Gray gradient, maximum error: %d\n", error);
+	ASSERT_GE(error, 0);
+	ASSERT_LE(error, 8);
+}
+
+TEST(EtcEncoderTest, RoundTripConstantAlpha)
+{
+	const uint8_t alphas[] = { 0, 1, 128, 254, 255 };
+
+	for (unsigned int i = 0; i < sizeof(alphas); i++)
+	{
+		uint8_t block[BlockBytes];
+		fillSolid(block, 10, 20, 30, alphas[i]);
+
+		const int error = roundTripAlpha(block);
+		printf("Constant alpha %u, maximum error: %d\n", alphas[i], error);
+		ASSERT_EQ(error, 0);
+	}
+}
+
+TEST(EtcEncoderTest, RoundTripAlphaMask)
+{
+	uint8_t block[BlockBytes];
+	fillSolid(block, 10, 20, 30, 0);
+	for (int i = 0; i < BlockPixels; i += 3)
+		block[i * 4 + 3] = 255;
+
+	const int error = roundTripAlpha(block);
+	printf("Opaque and transparent pixels, maximum error: %d\n", error);
+	ASSERT_LE(error, 2);
+}
+
+TEST(EtcEncoderTest, RoundTripAlphaGradient)
+{
+	uint8_t block[BlockBytes];
+	fillSolid(block, 10, 20, 30, 0);
+	for (int i = 0; i < BlockPixels; i++)
+		block[i * 4 + 3] = static_cast<uint8_t>(i * 17);
+
+	const int error = roundTripAlpha(block);
+	printf("Alpha gradient from 0 to 255, maximum error: %d\n", error);
+	ASSERT_LE(error, 16);
+}
+
+TEST(EtcEncoderTest, EncodeImageWithPartialBlocks)
+{
+	const int Width = 6;
+	const int Height = 5;
+	uint8_t image[Width * Height * 4];
+	for (int y = 0; y < Height; y++)
+	{
+		for (int x = 0; x < Width; x++)
+		{
+			// Each block is filled with a single color and alpha value
+			uint8_t *pixel = image + (y * Width + x) * 4;
+			const int blockIndex = (y / 4) * 2 + (x / 4);
+			pixel[0] = static_cast<uint8_t>(40 + blockIndex * 50);
+			pixel[1] = static_cast<uint8_t>(200 - blockIndex * 40);
+			pixel[2] = 90;
+			pixel[3] = static_cast<uint8_t>(255 - blockIndex * 60);
+		}
+	}
+
+	const unsigned long encodedSize = nc::EtcEncoder::encodedSize(Width, Height, true);
+	uint8_t encoded[4 * RgbaBlockSize];
+	ASSERT_EQ(encodedSize, sizeof(encoded));
+	nc::EtcEncoder::encodeImage(image, Width, Height, true, encoded);
+
+	printf("Decoding a %dx%d image with partial blocks on the borders\n", Width, Height);
+	for (int blockIndex = 0; blockIndex < 4; blockIndex++)
+	{
+		// The alpha block precedes the color one
+		uint8_t decoded[BlockBytes];
+		const uint8_t *input = encoded + blockIndex * RgbaBlockSize;
+		decodeAlphaBlock(input, decoded);
+		ASSERT_TRUE(decodeColorBlock(input + 8, decoded));
+
+		const int blockX = (blockIndex % 2) * 4;
+		const int blockY = (blockIndex / 2) * 4;
+		for (int y = 0; y < 4 && blockY + y < Height; y++)
+		{
+			for (int x = 0; x < 4 && blockX + x < Width; x++)
+			{
+				const uint8_t *expected = image + ((blockY + y) * Width + blockX + x) * 4;
+				const uint8_t *pixel = decoded + (y * 4 + x) * 4;
+				for (int c = 0; c < 3; c++)
+					ASSERT_NEAR(pixel[c], expected[c], 4);
+				ASSERT_EQ(pixel[3], expected[3]);
+			}
+		}
+	}
+}
+
+}
@@ -0,0 +1,184 @@
+#include <cstring>
+#include <ncine/IFile.h>
+#include <ncine/FileReadRequest.h>
+#include <ncine/FileSystem.h>
+#include <ncine/Timer.h>
+#include <nctl/Atomic.h>
+#include "gtest/gtest.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const char *Filename = "FileReadRequestTest.bin";
+// Small enough for the file not to be mapped in memory, so that its requests are serviced by the I/O thread
+const unsigned int FileSize = 8 * 1024;
+const unsigned int ChunkSize = 1024;
+
+unsigned char fileByte(unsigned int offset)
+{
+	return static_cast<unsigned char>(offset * 7 + offset / 256);
+}
+
+bool hasFileContent(const unsigned char *buffer, unsigned int offset, unsigned int size)
+{
+	for (unsigned int i = 0; i < size; i++)
+	{
+		if (buffer[i] != fileByte(offset + i))
+			return false;
+	}
+	return true;
+}
+
+struct CallbackData
+{
+	nctl::Atomic32 numCalls;
+	nctl::Atomic32 hasStarted;
+	nctl::Atomic32 canFinish;
+};
+
+void countCallback(const nc::FileReadRequest &request, bool succeeded, void *userData)
+{
+	CallbackData &data = *static_cast<CallbackData *>(userData);
+	if (succeeded)
+		data.numCalls++;
+}
+
+/// Keeps the I/O thread busy until the test allows it to finish the request
+void blockingCallback(const nc::FileReadRequest &request, bool succeeded, void *userData)
+{
+	CallbackData &data = *static_cast<CallbackData *>(userData);
+	data.hasStarted = 1;
+	while (data.canFinish.load() == 0)
+		nc::Timer::sleep(1);
+}
+
+class FileReadRequestTest : public ::testing::Test
+{
+  protected:
+	void SetUp() override
+	{
+		unsigned char buffer[FileSize];
+		for (unsigned int i = 0; i < FileSize; i++)
+			buffer[i] = fileByte(i);
+
+		nctl::UniquePtr<nc::IFile> file = nc::IFile::createFileHandle(Filename);
+		file->open(nc::IFile::OpenMode::WRITE);
+		file->write(buffer, FileSize);
+		file->close();
+
+		file_ = nc::IFile::createFileHandle(Filename);
+		file_->open(nc::IFile::OpenMode::READ);
+	}
+
+	void TearDown() override
+	{
+		file_.reset(nullptr);
+		nc::fs::deleteFile(Filename);
+	}
+
+	nctl::UniquePtr<nc::IFile> file_;
+};
+
+TEST_F(FileReadRequestTest, ReadAndWait)
+{
+	unsigned char buffer[ChunkSize];
+	const unsigned int offset = ChunkSize * 3 + 5;
+
+	printf("Reading a range of a file asynchronously and waiting for it\n");
+	nctl::SharedPtr<nc::FileReadRequest> request = file_->readAsync(offset, buffer, ChunkSize);
+	ASSERT_TRUE(request);
+	request->wait();
+
+	ASSERT_TRUE(request->isDone());
+	ASSERT_EQ(request->state(), nc::FileReadRequest::State::COMPLETED);
+	ASSERT_EQ(request->bytesRead(), ChunkSize);
+	ASSERT_TRUE(hasFileContent(buffer, offset, ChunkSize));
+}
+
+TEST_F(FileReadRequestTest, ReadPastEnd)
+{
+	unsigned char buffer[ChunkSize];
+	const unsigned int offset = FileSize - ChunkSize / 2;
+
+	printf("Reading a range that goes past the end of the file\n");
+	nctl::SharedPtr<nc::FileReadRequest> request = file_->readAsync(offset, buffer, ChunkSize);
+	request->wait();
+
+	ASSERT_EQ(request->state(), nc::FileReadRequest::State::COMPLETED);
+	ASSERT_EQ(request->bytesRead(), ChunkSize / 2);
+	ASSERT_TRUE(hasFileContent(buffer, offset, ChunkSize / 2));
+}
+
+TEST_F(FileReadRequestTest, ReadManyRanges)
+{
+	const unsigned int NumRequests = FileSize / ChunkSize;
+	nctl::UniquePtr<unsigned char[]> buffer = nctl::makeUnique<unsigned char[]>(FileSize);
+	nctl::SharedPtr<nc::FileReadRequest> requests[NumRequests];
+	CallbackData data;
+
+	printf("Reading all the chunks of a file asynchronously in reverse order\n");
+	for (int i = NumRequests - 1; i >= 0; i--)
+		requests[i] = file_->readAsync(i * ChunkSize, buffer.get() + i * ChunkSize, ChunkSize, countCallback, &data);
+	for (unsigned int i = 0; i < NumRequests; i++)
+		requests[i]->wait();
+
+	for (unsigned int i = 0; i < NumRequests; i++)
+		ASSERT_EQ(requests[i]->state(), nc::FileReadRequest::State::COMPLETED);
+	ASSERT_EQ(static_cast<unsigned int>(data.numCalls.load()), NumRequests);
+	ASSERT_TRUE(hasFileContent(buffer.get(), 0, FileSize));
+}
+
+TEST_F(FileReadRequestTest, CancelPending)
+{
+	unsigned char firstBuffer[ChunkSize];
+	unsigned char secondBuffer[ChunkSize];
+	memset(secondBuffer, 0, ChunkSize);
+	CallbackData data;
+
+	printf("Canceling a request while the I/O thread is busy with another one\n");
+	nctl::SharedPtr<nc::FileReadRequest> first = file_->readAsync(0, firstBuffer, ChunkSize, blockingCallback, &data);
+	while (data.hasStarted.load() == 0)
+		nc::Timer::sleep(1);
+
+	nctl::SharedPtr<nc::FileReadRequest> second = file_->readAsync(ChunkSize, secondBuffer, ChunkSize, countCallback, &data);
+	const bool firstCanceled = first->cancel();
+	const bool secondCanceled = second->cancel();
+	const bool secondCanceledTwice = second->cancel();
+	// A canceled request is done and does not block its waiters
+	second->wait();
+
+	// The I/O thread is released before any assertion can return
+	data.canFinish = 1;
+	first->wait();
+	ASSERT_FALSE(firstCanceled);
+	ASSERT_TRUE(secondCanceled);
+	ASSERT_FALSE(secondCanceledTwice);
+	ASSERT_EQ(second->state(), nc::FileReadRequest::State::CANCELED);
+	ASSERT_EQ(first->state(), nc::FileReadRequest::State::COMPLETED);
+	ASSERT_TRUE(hasFileContent(firstBuffer, 0, ChunkSize));
+	ASSERT_EQ(data.numCalls.load(), 0);
+	for (unsigned int i = 0; i < ChunkSize; i++)
+		ASSERT_EQ(secondBuffer[i], 0);
+}
+
+TEST_F(FileReadRequestTest, ReadMemoryFile)
+{
+	unsigned char fileBuffer[ChunkSize];
+	for (unsigned int i = 0; i < ChunkSize; i++)
+		fileBuffer[i] = fileByte(i);
+	nctl::UniquePtr<nc::IFile> memoryFile = nc::IFile::createFromMemory("MemoryFile", fileBuffer, ChunkSize);
+	memoryFile->open(nc::IFile::OpenMode::READ);
+	unsigned char buffer[ChunkSize];
+
+	printf("Reading a memory file, whose requests are done when they are returned\n");
+	nctl::SharedPtr<nc::FileReadRequest> request = memoryFile->readAsync(16, buffer, ChunkSize - 16);
+
+	ASSERT_EQ(request->state(), nc::FileReadRequest::State::COMPLETED);
+	ASSERT_FALSE(request->cancel());
+	request->wait();
+	ASSERT_EQ(request->bytesRead(), ChunkSize - 16);
+	ASSERT_TRUE(hasFileContent(buffer, 16, ChunkSize - 16));
+}
+
+}
@@ -0,0 +1,272 @@
+#include <ncine/ParallelAlgorithms.h>
+#include <ncine/ServiceLocator.h>
+#include <ncine/Random.h>
+#include <nctl/Array.h>
+#include <nctl/StaticArray.h>
+#include <nctl/Atomic.h>
+#include "gtest/gtest.h"
+#include "test_thread_functions.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const unsigned int NumThreads = 3;
+const unsigned int Size = 100000;
+const unsigned int GrainSize = 1000;
+
+/// A thread pool that executes every command on a new thread, joined when the pool is destroyed
+class TestThreadPool : public nc::IThreadPool
+{
+  public:
+	explicit TestThreadPool(unsigned int numThreads)
+	    : numThreads_(numThreads), numCommands_(0) {}
+	~TestThreadPool() override { joinAll(); }
+
+	void enqueueCommand(nctl::UniquePtr<nc::IThreadCommand> threadCommand) override
+	{
+		if (numCommands_ == MaxCommands)
+			joinAll();
+
+		commands_[numCommands_] = nctl::move(threadCommand);
+#ifdef _WIN32
+		handles_[numCommands_] = reinterpret_cast<HANDLE>(_beginthreadex(nullptr, 0, threadFunc, commands_[numCommands_].get(), 0, nullptr));
+#else
+		pthread_create(&tids_[numCommands_], nullptr, threadFunc, commands_[numCommands_].get());
+#endif
+		numCommands_++;
+	}
+
+	unsigned int numThreads() const override { return numThreads_; }
+
+  private:
+	static const unsigned int MaxCommands = 64;
+
+	unsigned int numThreads_;
+	unsigned int numCommands_;
+	nctl::UniquePtr<nc::IThreadCommand> commands_[MaxCommands];
+#ifdef _WIN32
+	HANDLE handles_[MaxCommands];
+
+	static unsigned int __stdcall threadFunc(void *arg)
+	{
+		static_cast<nc::IThreadCommand *>(arg)->execute();
+		return 0u;
+	}
+#else
+	pthread_t tids_[MaxCommands];
+
+	static void *threadFunc(void *arg)
+	{
+		static_cast<nc::IThreadCommand *>(arg)->execute();
+		return nullptr;
+	}
+#endif
+
+	void joinAll()
+	{
+		for (unsigned int i = 0; i < numCommands_; i++)
+		{
+#ifdef _WIN32
+			WaitForSingleObject(handles_[i], INFINITE);
+			CloseHandle(handles_[i]);
+#else
+			pthread_join(tids_[i], nullptr);
+#endif
+			commands_[i].reset(nullptr);
+		}
+		numCommands_ = 0;
+	}
+};
+
+void initArrayRandom(nctl::Array<int> &array, unsigned int size)
+{
+	for (unsigned int i = 0; i < size; i++)
+		array.pushBack(static_cast<int>(nc::random().integer(0, 1000000)));
+}
+
+bool isEqual(const nctl::Array<int> &first, const nctl::Array<int> &second)
+{
+	if (first.size() != second.size())
+		return false;
+
+	for (unsigned int i = 0; i < first.size(); i++)
+	{
+		if (first[i] != second[i])
+			return false;
+	}
+
+	return true;
+}
+
+struct ChunksData
+{
+	nctl::Array<int> *visits;
+	nctl::Atomic32 numChunks;
+};
+
+void visitChunk(unsigned int firstIndex, unsigned int lastIndex, unsigned int chunkIndex, void *userData)
+{
+	ChunksData &data = *static_cast<ChunksData *>(userData);
+	if (firstIndex == chunkIndex * GrainSize)
+		data.numChunks++;
+	for (unsigned int i = firstIndex; i < lastIndex; i++)
+		(*data.visits)[i]++;
+}
+
+class ParallelAlgorithmsTest : public ::testing::Test
+{
+  public:
+	ParallelAlgorithmsTest()
+	    : array_(Size) {}
+
+  protected:
+	void SetUp() override
+	{
+		nc::theServiceLocator().registerThreadPool(nctl::makeUnique<TestThreadPool>(NumThreads));
+		initArrayRandom(array_, Size);
+	}
+
+	void TearDown() override { nc::theServiceLocator().unregisterThreadPool(); }
+
+	nctl::Array<int> array_;
+};
+
+TEST_F(ParallelAlgorithmsTest, NumChunks)
+{
+	printf("Checking the number of chunks a range is split into\n");
+	ASSERT_EQ(nc::parallelNumChunks(0, GrainSize), 0u);
+	ASSERT_EQ(nc::parallelNumChunks(1, GrainSize), 1u);
+	ASSERT_EQ(nc::parallelNumChunks(GrainSize, GrainSize), 1u);
+	ASSERT_EQ(nc::parallelNumChunks(GrainSize + 1, GrainSize), 2u);
+	ASSERT_EQ(nc::parallelNumChunks(GrainSize, 0), GrainSize);
+	ASSERT_EQ(nc::parallelNumThreads(), NumThreads);
+}
+
+TEST_F(ParallelAlgorithmsTest, ParallelForVisitsOnce)
+{
+	const unsigned int NumElements = Size + GrainSize / 2;
+	nctl::Array<int> visits(NumElements);
+	for (unsigned int i = 0; i < NumElements; i++)
+		visits.pushBack(0);
+
+	printf("Visiting every index of a range split in chunks\n");
+	ChunksData data;
+	data.visits = &visits;
+	nc::parallelFor(NumElements, GrainSize, visitChunk, &data);
+
+	ASSERT_EQ(static_cast<unsigned int>(data.numChunks.load()), nc::parallelNumChunks(NumElements, GrainSize));
+	for (unsigned int i = 0; i < NumElements; i++)
+		ASSERT_EQ(visits[i], 1);
+}
+
+TEST_F(ParallelAlgorithmsTest, ParallelForEach)
+{
+	nctl::Array<int> expected(array_);
+	for (int &element : expected)
+		element *= 2;
+
+	printf("Doubling every element in parallel\n");
+	nc::parallelForEach(array_.begin(), array_.end(), [](int &element) { element *= 2; }, GrainSize);
+
+	ASSERT_TRUE(isEqual(array_, expected));
+}
+
+TEST_F(ParallelAlgorithmsTest, ParallelForEachStaticArray)
+{
+	const unsigned int StaticSize = 4096;
+	nctl::StaticArray<int, StaticSize> array(nctl::StaticArrayMode::EXTEND_SIZE);
+	for (unsigned int i = 0; i < StaticSize; i++)
+		array[i] = static_cast<int>(i);
+
+	printf("Incrementing every element of a static array in parallel\n");
+	nc::parallelForEach(array.begin(), array.end(), [](int &element) { element++; }, 100);
+
+	for (unsigned int i = 0; i < StaticSize; i++)
+		ASSERT_EQ(array[i], static_cast<int>(i) + 1);
+}
+
+TEST_F(ParallelAlgorithmsTest, ParallelTransform)
+{
+	nctl::Array<int> result(Size);
+	result.setSize(Size);
+
+	printf("Transforming every element in parallel into another array\n");
+	nctl::Array<int>::Iterator resultEnd = nc::parallelTransform(array_.begin(), array_.end(), result.begin(), [](int element) { return element / 2 + 1; }, GrainSize);
+
+	ASSERT_TRUE(resultEnd == result.end());
+	for (unsigned int i = 0; i < Size; i++)
+		ASSERT_EQ(result[i], array_[i] / 2 + 1);
+}
+
+TEST_F(ParallelAlgorithmsTest, ParallelReduce)
+{
+	long long int expected = 7;
+	for (int element : array_)
+		expected += element;
+
+	printf("Summing every element in parallel\n");
+	nctl::Array<long long int> values(Size);
+	for (int element : array_)
+		values.pushBack(element);
+	const long long int sum = nc::parallelReduce(values.begin(), values.end(), 7LL, nctl::Plus<long long int>, GrainSize);
+
+	ASSERT_EQ(sum, expected);
+}
+
+TEST_F(ParallelAlgorithmsTest, ParallelReduceWiderType)
+{
+	long long int expected = 7;
+	for (int element : array_)
+		expected += element;
+
+	printf("Summing every integer element in parallel into a wider type that does not overflow\n");
+	const long long int sum = nc::parallelReduce(array_.begin(), array_.end(), 7LL, nctl::Plus<long long int>, GrainSize);
+
+	ASSERT_GT(sum, static_cast<long long int>(INT32_MAX));
+	ASSERT_EQ(sum, expected);
+}
+
+TEST_F(ParallelAlgorithmsTest, ParallelReduceEmpty)
+{
+	nctl::Array<int> empty;
+
+	printf("Reducing an empty range\n");
+	const int sum = nc::parallelReduce(empty.begin(), empty.end(), 42, nctl::Plus<int>);
+
+	ASSERT_EQ(sum, 42);
+}
+
+TEST_F(ParallelAlgorithmsTest, ParallelSort)
+{
+	nctl::Array<int> expected(array_);
+	nctl::sort(expected.begin(), expected.end());
+
+	printf("Sorting the array in parallel\n");
+	nc::parallelSort(array_.begin(), array_.end(), nctl::IsLess<int>, GrainSize);
+
+	ASSERT_TRUE(nctl::isSorted(array_.begin(), array_.end()));
+	ASSERT_TRUE(isEqual(array_, expected));
+}
+
+TEST_F(ParallelAlgorithmsTest, ParallelSortDescending)
+{
+	printf("Reverse sorting the array in parallel with a number of chunks that is not a power of two\n");
+	nc::parallelSort(array_.begin(), array_.end(), nctl::IsGreater<int>, Size / 7);
+
+	ASSERT_TRUE(nctl::isSorted(array_.begin(), array_.end(), nctl::IsGreater<int>));
+}
+
+TEST_F(ParallelAlgorithmsTest, ParallelSortWithoutThreads)
+{
+	nc::theServiceLocator().unregisterThreadPool();
+	nctl::Array<int> expected(array_);
+	nctl::sort(expected.begin(), expected.end());
+
+	printf("Sorting the array with a thread pool that has no threads\n");
+	nc::parallelSort(array_.begin(), array_.end());
+
+	ASSERT_TRUE(isEqual(array_, expected));
+}
+
+}
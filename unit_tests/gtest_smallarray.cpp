@@ -0,0 +1,300 @@
+#include <nctl/SmallArray.h>
+#include "gtest/gtest.h"
+
+namespace {
+
+const unsigned int InlineCapacity = 4;
+const unsigned int Capacity = 10;
+const int FirstElement = 0;
+using SmallArrayTestType = nctl::SmallArray<int, InlineCapacity>;
+
+void printArray(const SmallArrayTestType &array)
+{
+	printf("Size %u, capacity %u, inline %d: ", array.size(), array.capacity(), array.isInline());
+	for (unsigned int i = 0; i < array.size(); i++)
+		printf("[%u]=%d ", i, array[i]);
+	printf("\n");
+}
+
+void initArray(SmallArrayTestType &array, unsigned int size)
+{
+	int value = FirstElement;
+
+	for (unsigned int i = 0; i < size; i++)
+		array.pushBack(value++);
+}
+
+void assertArrayElements(const SmallArrayTestType &array, unsigned int size)
+{
+	ASSERT_EQ(array.size(), size);
+	for (unsigned int i = 0; i < size; i++)
+		ASSERT_EQ(array[i], FirstElement + static_cast<int>(i));
+}
+
+bool isInsideObject(const SmallArrayTestType &array)
+{
+	const unsigned char *objectStart = reinterpret_cast<const unsigned char *>(&array);
+	const unsigned char *dataStart = reinterpret_cast<const unsigned char *>(array.data());
+	return (dataStart >= objectStart && dataStart < objectStart + sizeof(SmallArrayTestType));
+}
+
+class SmallArrayTest : public ::testing::Test
+{
+  protected:
+	SmallArrayTestType array_;
+};
+
+#ifndef __EMSCRIPTEN__
+TEST(SmallArrayDeathTest, AccessBeyondSize)
+{
+	printf("Trying to access an element within the inline capacity but beyond size\n");
+	SmallArrayTestType array;
+	array.pushBack(0);
+
+	ASSERT_DEATH(array.at(2) = 1, "");
+}
+
+TEST(SmallArrayDeathTest, PushBackBeyondFixedCapacity)
+{
+	printf("Trying to push back an element beyond the inline capacity of a fixed capacity array\n");
+	SmallArrayTestType array(InlineCapacity, nctl::ArrayMode::FIXED_CAPACITY);
+	for (unsigned int i = 0; i < InlineCapacity; i++)
+		array.pushBack(i);
+
+	ASSERT_EQ(array.size(), InlineCapacity);
+	ASSERT_TRUE(array.isInline());
+	ASSERT_DEATH(array.pushBack(0), "");
+}
+#endif
+
+TEST_F(SmallArrayTest, DefaultIsInline)
+{
+	printf("Checking that a default constructed array uses the inline storage\n");
+	printArray(array_);
+
+	ASSERT_TRUE(array_.isEmpty());
+	ASSERT_EQ(array_.capacity(), InlineCapacity);
+	ASSERT_TRUE(array_.isInline());
+	ASSERT_TRUE(isInsideObject(array_));
+}
+
+TEST_F(SmallArrayTest, PushBackWithinInlineCapacity)
+{
+	printf("Pushing back elements up to the inline capacity\n");
+	initArray(array_, InlineCapacity);
+	printArray(array_);
+
+	assertArrayElements(array_, InlineCapacity);
+	ASSERT_EQ(array_.capacity(), InlineCapacity);
+	ASSERT_TRUE(array_.isInline());
+}
+
+TEST_F(SmallArrayTest, PushBackBeyondInlineCapacity)
+{
+	printf("Pushing back elements beyond the inline capacity\n");
+	initArray(array_, Capacity);
+	printArray(array_);
+
+	assertArrayElements(array_, Capacity);
+	ASSERT_GE(array_.capacity(), Capacity);
+	ASSERT_FALSE(array_.isInline());
+	ASSERT_FALSE(isInsideObject(array_));
+}
+
+TEST_F(SmallArrayTest, ConstructWithBigCapacity)
+{
+	printf("Constructing an array with a capacity bigger than the inline one\n");
+	SmallArrayTestType array(Capacity);
+	printArray(array);
+
+	ASSERT_EQ(array.capacity(), Capacity);
+	ASSERT_FALSE(array.isInline());
+}
+
+TEST_F(SmallArrayTest, ConstructWithSmallCapacity)
+{
+	printf("Constructing an array with a capacity smaller than the inline one\n");
+	SmallArrayTestType array(InlineCapacity / 2);
+	printArray(array);
+
+	ASSERT_EQ(array.capacity(), InlineCapacity);
+	ASSERT_TRUE(array.isInline());
+}
+
+TEST_F(SmallArrayTest, ShrinkBackToInline)
+{
+	initArray(array_, Capacity);
+	printf("Removing elements and shrinking the capacity to fit\n");
+	array_.setSize(InlineCapacity - 1);
+	array_.shrinkToFit();
+	printArray(array_);
+
+	assertArrayElements(array_, InlineCapacity - 1);
+	ASSERT_EQ(array_.capacity(), InlineCapacity);
+	ASSERT_TRUE(array_.isInline());
+}
+
+TEST_F(SmallArrayTest, SetCapacityToCrop)
+{
+	initArray(array_, Capacity);
+	printf("Setting a capacity smaller than the size\n");
+	array_.setCapacity(2);
+	printArray(array_);
+
+	assertArrayElements(array_, InlineCapacity);
+	ASSERT_EQ(array_.capacity(), InlineCapacity);
+	ASSERT_TRUE(array_.isInline());
+}
+
+TEST_F(SmallArrayTest, InsertAcrossInlineCapacity)
+{
+	initArray(array_, InlineCapacity);
+	printf("Inserting elements in the middle of a full inline array\n");
+	array_.insertAt(1, 100);
+	array_.emplaceAt(1, 101);
+	printArray(array_);
+
+	ASSERT_EQ(array_.size(), InlineCapacity + 2);
+	ASSERT_FALSE(array_.isInline());
+	ASSERT_EQ(array_[0], 0);
+	ASSERT_EQ(array_[1], 101);
+	ASSERT_EQ(array_[2], 100);
+	for (unsigned int i = 3; i < array_.size(); i++)
+		ASSERT_EQ(array_[i], static_cast<int>(i - 2));
+}
+
+TEST_F(SmallArrayTest, RemoveElements)
+{
+	initArray(array_, Capacity);
+	printf("Removing elements from the front and unordered from the middle\n");
+	array_.removeAt(0);
+	array_.unorderedRemoveAt(0);
+	printArray(array_);
+
+	ASSERT_EQ(array_.size(), Capacity - 2);
+	ASSERT_EQ(array_[0], static_cast<int>(Capacity - 1));
+	ASSERT_EQ(array_[1], 2);
+}
+
+TEST_F(SmallArrayTest, Iteration)
+{
+	initArray(array_, Capacity);
+	printf("Iterating over the elements\n");
+
+	int n = FirstElement;
+	for (SmallArrayTestType::ConstIterator i = array_.begin(); i != array_.end(); ++i)
+		ASSERT_EQ(*i, n++);
+	ASSERT_EQ(n, FirstElement + static_cast<int>(Capacity));
+
+	for (SmallArrayTestType::ConstReverseIterator r = array_.rBegin(); r != array_.rEnd(); ++r)
+		ASSERT_EQ(*r, --n);
+	ASSERT_EQ(n, FirstElement);
+}
+
+TEST_F(SmallArrayTest, CopyConstructionInline)
+{
+	initArray(array_, InlineCapacity);
+	printf("Creating a new array with copy construction from an inline one\n");
+	SmallArrayTestType newArray(array_);
+	printArray(newArray);
+
+	assertArrayElements(newArray, InlineCapacity);
+	ASSERT_TRUE(newArray.isInline());
+	ASSERT_TRUE(isInsideObject(newArray));
+	assertArrayElements(array_, InlineCapacity);
+}
+
+TEST_F(SmallArrayTest, CopyConstructionHeap)
+{
+	initArray(array_, Capacity);
+	printf("Creating a new array with copy construction from a heap one\n");
+	SmallArrayTestType newArray(array_);
+	printArray(newArray);
+
+	assertArrayElements(newArray, Capacity);
+	ASSERT_FALSE(newArray.isInline());
+	ASSERT_NE(newArray.data(), array_.data());
+	assertArrayElements(array_, Capacity);
+}
+
+TEST_F(SmallArrayTest, MoveConstructionInline)
+{
+	initArray(array_, InlineCapacity);
+	printf("Creating a new array with move construction from an inline one\n");
+	SmallArrayTestType newArray(nctl::move(array_));
+	printArray(newArray);
+
+	assertArrayElements(newArray, InlineCapacity);
+	ASSERT_TRUE(newArray.isInline());
+	ASSERT_TRUE(isInsideObject(newArray));
+	ASSERT_EQ(array_.size(), 0);
+}
+
+TEST_F(SmallArrayTest, MoveConstructionHeap)
+{
+	initArray(array_, Capacity);
+	const int *data = array_.data();
+	printf("Creating a new array with move construction from a heap one\n");
+	SmallArrayTestType newArray(nctl::move(array_));
+	printArray(newArray);
+
+	assertArrayElements(newArray, Capacity);
+	ASSERT_EQ(newArray.data(), data);
+	ASSERT_EQ(array_.size(), 0);
+	ASSERT_EQ(array_.capacity(), InlineCapacity);
+	ASSERT_TRUE(array_.isInline());
+}
+
+TEST_F(SmallArrayTest, AssignmentOperator)
+{
+	initArray(array_, Capacity);
+	printf("Assigning a heap array to an inline one\n");
+	SmallArrayTestType newArray;
+	newArray.pushBack(-1);
+	newArray = array_;
+	printArray(newArray);
+
+	assertArrayElements(newArray, Capacity);
+	assertArrayElements(array_, Capacity);
+}
+
+TEST_F(SmallArrayTest, MoveAssignmentOperator)
+{
+	initArray(array_, InlineCapacity);
+	printf("Move assigning an inline array to a heap one\n");
+	SmallArrayTestType newArray;
+	initArray(newArray, Capacity);
+	newArray = nctl::move(array_);
+	printArray(newArray);
+
+	assertArrayElements(newArray, InlineCapacity);
+	ASSERT_EQ(array_.size(), 0);
+}
+
+TEST_F(SmallArrayTest, SelfAssignment)
+{
+	initArray(array_, InlineCapacity);
+	printf("Assigning the array to itself with the assignment operator\n");
+	array_ = array_;
+	printArray(array_);
+
+	assertArrayElements(array_, InlineCapacity);
+}
+
+TEST_F(SmallArrayTest, SwapInlineAndHeap)
+{
+	initArray(array_, InlineCapacity - 1);
+	SmallArrayTestType newArray;
+	initArray(newArray, Capacity);
+	printf("Swapping an inline array with a heap one\n");
+	array_.swap(array_, newArray);
+	printArray(array_);
+	printArray(newArray);
+
+	assertArrayElements(array_, Capacity);
+	assertArrayElements(newArray, InlineCapacity - 1);
+	ASSERT_FALSE(array_.isInline());
+	ASSERT_TRUE(newArray.isInline());
+}
+
+}
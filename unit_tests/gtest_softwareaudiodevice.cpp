@@ -0,0 +1,293 @@
+#include <ncine/SoftwareAudioDevice.h>
+#include <ncine/AppConfiguration.h>
+#include <ncine/ServiceLocator.h>
+#include <ncine/AudioBuffer.h>
+#include <ncine/AudioBufferPlayer.h>
+#include <ncine/AudioStreamPlayer.h>
+#include <ncine/AudioMixer.h>
+#include <ncine/FileSystem.h>
+#include <ncine/Timer.h>
+#include "gtest/gtest.h"
+
+namespace nc = ncine;
+
+namespace {
+
+const int Frequency = 44100;
+/// Long enough to still be playing after a few updates
+const unsigned int NumLongFrames = Frequency * 4;
+/// Short enough to be played entirely by a single update
+const unsigned int NumShortFrames = 16;
+const int16_t SampleValue = 16384;
+const unsigned int SleepMs = 20;
+const char *StreamFilename = "SoftwareAudioDeviceTest.wav";
+
+/// A sink that keeps the peak of all the written samples
+class PeakAudioSink : public nc::IAudioSink
+{
+  public:
+	PeakAudioSink()
+	    : numFrames_(0), peak_(0) {}
+
+	bool write(const int16_t *frames, unsigned int numFrames) override
+	{
+		for (unsigned int i = 0; i < numFrames * 2; i++)
+		{
+			const int value = (frames[i] < 0) ? -frames[i] : frames[i];
+			if (value > peak_)
+				peak_ = value;
+		}
+		numFrames_ += numFrames;
+		return true;
+	}
+	unsigned long int numFrames() const override { return numFrames_; }
+	int peak() const { return peak_; }
+	void resetPeak() { peak_ = 0; }
+
+  private:
+	unsigned long int numFrames_;
+	int peak_;
+};
+
+class SoftwareAudioDeviceTest : public ::testing::Test
+{
+  protected:
+	void SetUp() override
+	{
+		nc::AppConfiguration appCfg;
+		appCfg.outputAudioFrequency = Frequency;
+		nctl::UniquePtr<nc::SoftwareAudioDevice> device = nctl::makeUnique<nc::SoftwareAudioDevice>(appCfg);
+		device_ = device.get();
+
+		nctl::UniquePtr<PeakAudioSink> sink = nctl::makeUnique<PeakAudioSink>();
+		sink_ = sink.get();
+		device_->setSink(nctl::move(sink));
+		nc::theServiceLocator().registerAudioDevice(nctl::move(device));
+	}
+
+	void TearDown() override
+	{
+		nc::theServiceLocator().unregisterAudioDevice();
+		nc::fs::deleteFile(StreamFilename);
+	}
+
+	/// Fills a mono 16 bits buffer with a constant value
+	void loadBuffer(nc::AudioBuffer &buffer, unsigned int numFrames)
+	{
+		samples_.setSize(numFrames);
+		for (unsigned int i = 0; i < numFrames; i++)
+			samples_[i] = SampleValue;
+
+		buffer.init("SoftwareAudioDeviceTest", nc::AudioBuffer::Format::MONO16, Frequency);
+		buffer.loadFromSamples(reinterpret_cast<const unsigned char *>(samples_.data()), numFrames * sizeof(int16_t));
+	}
+
+	/// Writes a stereo 16 bits WAV file with a constant value
+	void writeStream(unsigned int numFrames)
+	{
+		samples_.setSize(numFrames * 2);
+		for (unsigned int i = 0; i < numFrames * 2; i++)
+			samples_[i] = SampleValue;
+
+		nc::WavAudioSink wavSink(StreamFilename, Frequency);
+		wavSink.write(samples_.data(), numFrames);
+	}
+
+	/// Lets some time pass before mixing it
+	void update()
+	{
+		nc::Timer::sleep(SleepMs);
+		device_->updatePlayers();
+	}
+
+	nc::SoftwareAudioDevice *device_;
+	PeakAudioSink *sink_;
+	nctl::Array<int16_t> samples_;
+};
+
+TEST_F(SoftwareAudioDeviceTest, InstanceIsSet)
+{
+	printf("The software device is the one used by audio buffers\n");
+	ASSERT_EQ(nc::SoftwareAudioDevice::instance(), device_);
+	ASSERT_EQ(&nc::theServiceLocator().audioDevice(), device_);
+	ASSERT_EQ(device_->numPlayers(), 0u);
+}
+
+TEST_F(SoftwareAudioDeviceTest, ReuseBufferIds)
+{
+	const unsigned int firstId = device_->createBuffer();
+	const unsigned int secondId = device_->createBuffer();
+	printf("Creating two buffers with ids %u and %u\n", firstId, secondId);
+	ASSERT_NE(firstId, 0u);
+	ASSERT_NE(firstId, secondId);
+
+	device_->deleteBuffer(firstId);
+	printf("Deleting and creating a buffer again\n");
+	ASSERT_EQ(device_->createBuffer(), firstId);
+}
+
+TEST_F(SoftwareAudioDeviceTest, RejectInvalidBufferData)
+{
+	const unsigned char samples[4] = { 0, 0, 0, 0 };
+	const unsigned int bufferId = device_->createBuffer();
+
+	printf("Copying samples to an invalid buffer id\n");
+	ASSERT_FALSE(device_->setBufferData(0, samples, sizeof(samples), 2, 1, Frequency));
+	ASSERT_FALSE(device_->setBufferData(bufferId + 1, samples, sizeof(samples), 2, 1, Frequency));
+
+	printf("Copying samples with an unsupported format\n");
+	ASSERT_FALSE(device_->setBufferData(bufferId, samples, sizeof(samples), 4, 1, Frequency));
+	ASSERT_FALSE(device_->setBufferData(bufferId, samples, sizeof(samples), 2, 6, Frequency));
+	ASSERT_TRUE(device_->setBufferData(bufferId, samples, sizeof(samples), 1, 2, Frequency));
+}
+
+TEST_F(SoftwareAudioDeviceTest, MixBufferPlayer)
+{
+	nc::AudioBuffer buffer;
+	loadBuffer(buffer, NumLongFrames);
+	nc::AudioBufferPlayer player(&buffer);
+
+	printf("Playing a buffer player with the software device\n");
+	player.play();
+	ASSERT_TRUE(player.isPlaying());
+	ASSERT_TRUE(player.isVirtual());
+	ASSERT_EQ(device_->numPlayers(), 1u);
+
+	update();
+	printf("Mixed frames: %lu, peak: %d\n", device_->numMixedFrames(), sink_->peak());
+	ASSERT_GT(device_->numMixedFrames(), 0u);
+	ASSERT_EQ(sink_->numFrames(), device_->numMixedFrames());
+	ASSERT_GT(sink_->peak(), 0);
+	ASSERT_GT(player.sampleOffset(), 0);
+	ASSERT_TRUE(player.isPlaying());
+
+	player.stop();
+	printf("Stopping the player unregisters it\n");
+	ASSERT_FALSE(player.isVirtual());
+	ASSERT_EQ(device_->numPlayers(), 0u);
+}
+
+TEST_F(SoftwareAudioDeviceTest, StopAtBufferEnd)
+{
+	nc::AudioBuffer buffer;
+	loadBuffer(buffer, NumShortFrames);
+	nc::AudioBufferPlayer player(&buffer);
+
+	printf("Playing a buffer of %u frames\n", NumShortFrames);
+	player.play();
+	update();
+
+	printf("The player has stopped and is unregistered after an update\n");
+	ASSERT_TRUE(player.isStopped());
+	ASSERT_FALSE(player.isVirtual());
+	ASSERT_EQ(device_->numPlayers(), 0u);
+}
+
+TEST_F(SoftwareAudioDeviceTest, LoopBuffer)
+{
+	nc::AudioBuffer buffer;
+	loadBuffer(buffer, NumShortFrames);
+	nc::AudioBufferPlayer player(&buffer);
+	player.setLooping(true);
+
+	printf("Looping a buffer of %u frames\n", NumShortFrames);
+	player.play();
+	update();
+	update();
+
+	ASSERT_TRUE(player.isPlaying());
+	ASSERT_EQ(device_->numPlayers(), 1u);
+	player.stop();
+}
+
+TEST_F(SoftwareAudioDeviceTest, PauseAndResume)
+{
+	nc::AudioBuffer buffer;
+	loadBuffer(buffer, NumLongFrames);
+	nc::AudioBufferPlayer player(&buffer);
+
+	player.play();
+	update();
+	printf("Pausing all players\n");
+	device_->pausePlayers();
+	ASSERT_TRUE(player.isPaused());
+
+	sink_->resetPeak();
+	const int sampleOffset = player.sampleOffset();
+	update();
+	printf("A paused player is not mixed and does not advance\n");
+	ASSERT_EQ(sink_->peak(), 0);
+	ASSERT_EQ(player.sampleOffset(), sampleOffset);
+
+	printf("Resuming all players\n");
+	device_->resumePlayers();
+	ASSERT_TRUE(player.isPlaying());
+	update();
+	ASSERT_GT(sink_->peak(), 0);
+	ASSERT_GT(player.sampleOffset(), sampleOffset);
+	player.stop();
+}
+
+TEST_F(SoftwareAudioDeviceTest, MixStreamPlayer)
+{
+	writeStream(NumLongFrames);
+	nc::AudioStreamPlayer player(StreamFilename);
+
+	printf("Playing a stream player with the software device\n");
+	player.play();
+	ASSERT_TRUE(player.isPlaying());
+	ASSERT_TRUE(player.isVirtual());
+
+	update();
+	update();
+	printf("Mixed frames: %lu, peak: %d, sample offset in stream: %lu\n",
+	       device_->numMixedFrames(), sink_->peak(), player.sampleOffsetInStream());
+	ASSERT_GT(sink_->peak(), 0);
+	ASSERT_GT(player.sampleOffsetInStream(), 0u);
+	ASSERT_TRUE(player.isPlaying());
+
+	player.stop();
+	ASSERT_EQ(device_->numPlayers(), 0u);
+}
+
+TEST_F(SoftwareAudioDeviceTest, StopAtStreamEnd)
+{
+	writeStream(NumShortFrames);
+	nc::AudioStreamPlayer player(StreamFilename);
+
+	printf("Playing a stream of %u frames\n", NumShortFrames);
+	player.play();
+	update();
+	update();
+
+	printf("The player has stopped and is unregistered after the stream end\n");
+	ASSERT_TRUE(player.isStopped());
+	ASSERT_FALSE(player.isVirtual());
+	ASSERT_EQ(device_->numPlayers(), 0u);
+}
+
+TEST_F(SoftwareAudioDeviceTest, SilentWhenFar)
+{
+	nc::AudioBuffer buffer;
+	loadBuffer(buffer, NumLongFrames);
+	nc::AudioBufferPlayer nearPlayer(&buffer);
+	nc::AudioBufferPlayer farPlayer(&buffer);
+	farPlayer.setPosition(1000.0f, 0.0f, 0.0f);
+
+	nearPlayer.play();
+	update();
+	const int nearPeak = sink_->peak();
+	nearPlayer.stop();
+
+	sink_->resetPeak();
+	farPlayer.play();
+	update();
+	const int farPeak = sink_->peak();
+	farPlayer.stop();
+
+	printf("Peak of a player at the listener: %d, at a distance of 1000: %d\n", nearPeak, farPeak);
+	ASSERT_GT(nearPeak, 0);
+	ASSERT_LT(farPeak, nearPeak / 100);
+}
+
+}